@@ -0,0 +1,184 @@
+# @file Latency_Benchmark.py
+#
+# @brief Python script used to measure the end-to-end latency of the controllers on the robot.
+#
+# Python script that drives the latency test mode of the firmware (LATENCY_TEST_ACTIVE in main.c, see Latency_Test.h)
+# over EUSCI_A0. For every configuration, the script changes the parameters with "set" commands, then repeats
+# the measurement: "latency inject" replaces the converted distances with synthetic ones (by default, an obstacle
+# in front of the robot), and "latency" is polled until the firmware has seen the first motor command of a
+# controller that has read them. A random wait between two measurements spreads the injection over the
+# control period, so the histogram also shows the wait for the next control tick.
+#
+# The latencies are grouped by configuration and by strategy (the strategy of the trial of the route race
+# selected when the motor command was seen), printed as histograms, and saved to a CSV file with --csv FILE.
+#
+# Usage: python Latency_Benchmark.py COM# [--runs N] [--inject L,C,R] [--config LABEL:NAME=VALUE,...] [--csv FILE]
+#
+# Example: python Latency_Benchmark.py COM5 --config lpf16:lpf_size=16 --config lpf4:lpf_size=4
+#
+# @note Python 3 and the pySerial library must be installed, and PMOD_Color_Display.py (for the frame decoder)
+#       must be in the same folder, so the Pygame library must also be installed.
+
+import argparse
+import csv
+import random
+import sys
+import time
+
+import serial
+
+from PMOD_Color_Display import Telemetry_Decoder, TELEMETRY_PACKET_TEXT
+
+# Time for a "set" command to be applied by the next control tick in s
+PARAMETERS_APPLY_TIME = 0.05
+
+# Time for the controller to see the real distances again after a measurement in s
+RELEASE_TIME = 0.2
+
+# Longest random wait before a measurement in s (two control periods)
+MAX_PHASE_DELAY = 0.02
+
+# Interval between two "latency" polls in s
+POLL_INTERVAL = 0.005
+
+
+class Command_Link:
+    """Sends command lines and waits for the Text packets of their replies."""
+
+    def __init__(self, ser):
+        self.ser = ser
+        self.decoder = Telemetry_Decoder()
+
+    def command(self, line, prefixes, timeout):
+        """Sends a command and returns the first reply that starts with one of the prefixes, or None."""
+        self.ser.write((line + "\n").encode("ascii"))
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            for (packet_type, payload) in self.decoder.feed(self.ser.read(max(1, self.ser.in_waiting))):
+                if packet_type != TELEMETRY_PACKET_TEXT:
+                    continue
+                text = payload.decode("ascii", "replace")
+                if text.startswith(prefixes) or text.startswith("err"):
+                    return text
+        return None
+
+
+def parse_distances(text):
+    """Returns the left, center, and right distances of a "L,C,R" argument."""
+    values = [int(value) for value in text.split(",")]
+    if len(values) != 3:
+        raise argparse.ArgumentTypeError("expected L,C,R in mm")
+    return values
+
+
+def parse_config(text):
+    """Returns the label and the (name, value) pairs of a "LABEL:NAME=VALUE,..." argument."""
+    label, _, settings = text.partition(":")
+    pairs = []
+    for setting in filter(None, settings.split(",")):
+        name, _, value = setting.partition("=")
+        pairs.append((name, int(value)))
+    return label, pairs
+
+
+def measure(link, distances, timeout):
+    """Returns the latency in us and the strategy of one measurement, or None on a timeout."""
+    time.sleep(random.uniform(0, MAX_PHASE_DELAY))
+    if link.command("latency inject %d %d %d" % tuple(distances), ("ok latency",), 0.5) != "ok latency inject":
+        return None
+
+    deadline = time.time() + timeout
+    result = None
+    while time.time() < deadline:
+        reply = link.command("latency", ("latency ",), 0.5)
+        if reply is not None and reply.startswith("latency cycles="):
+            fields = dict(field.split("=", 1) for field in reply.split()[1:])
+            result = (int(fields["us"]), fields["strategy"])
+            break
+        time.sleep(POLL_INTERVAL)
+
+    if result is None:
+        link.command("latency cancel", ("ok latency",), 0.5)
+    time.sleep(RELEASE_TIME)
+    return result
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def print_histogram(label, strategy, latencies, bin_us):
+    print("\n{} / {}: {} runs, min {} us, median {} us, p95 {} us, max {} us, mean {:.0f} us".format(
+        label, strategy, len(latencies), min(latencies), percentile(latencies, 0.5), percentile(latencies, 0.95),
+        max(latencies), sum(latencies) / float(len(latencies))))
+
+    bins = {}
+    for latency in latencies:
+        bins[latency // bin_us] = bins.get(latency // bin_us, 0) + 1
+    largest = max(bins.values())
+    for index in range(min(bins), max(bins) + 1):
+        count = bins.get(index, 0)
+        print("{:>7} - {:<7} us {:>5} {}".format(index * bin_us, (index + 1) * bin_us - 1, count, "#" * (count * 50 // largest)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Measure the latency from a distance change to the motor command on the robot.")
+    parser.add_argument("port", help="serial port of EUSCI_A0, for example COM5 or /dev/ttyACM0")
+    parser.add_argument("--runs", type=int, default=100, help="number of measurements of each configuration")
+    parser.add_argument("--inject", type=parse_distances, default=[800, 40, 800], help="injected distances L,C,R in mm")
+    parser.add_argument("--config", type=parse_config, action="append", default=[],
+                        help="LABEL:NAME=VALUE,... parameters set before the measurements of a configuration (repeatable)")
+    parser.add_argument("--timeout", type=float, default=0.5, help="longest wait for the motor command in s")
+    parser.add_argument("--bin", type=int, default=500, help="width of the histogram bins in us")
+    parser.add_argument("--csv", help="save every measurement to a CSV file")
+    args = parser.parse_args()
+
+    try:
+        ser = serial.Serial(args.port, 115200, timeout=0.01)
+    except serial.serialutil.SerialException:
+        print("ERROR! Could not find COM port {}".format(args.port))
+        return 1
+
+    link = Command_Link(ser)
+    configs = args.config or [("default", [])]
+    rows = []
+    timeouts = 0
+
+    for (label, pairs) in configs:
+        for (name, value) in pairs:
+            reply = link.command("set {} {}".format(name, value), ("ok {}=".format(name),), 0.5)
+            if reply is None or reply.startswith("err"):
+                print("ERROR! {}: set {} {} failed ({})".format(label, name, value, reply))
+                return 1
+        time.sleep(PARAMETERS_APPLY_TIME)
+
+        for run in range(args.runs):
+            result = measure(link, args.inject, args.timeout)
+            if result is None:
+                timeouts += 1
+                continue
+            rows.append((label, result[1], run, result[0]))
+        print("{}: {} measurements".format(label, sum(1 for row in rows if row[0] == label)))
+
+    groups = {}
+    for (label, strategy, run, latency) in rows:
+        groups.setdefault((label, strategy), []).append(latency)
+    for ((label, strategy), latencies) in sorted(groups.items()):
+        print_histogram(label, strategy, latencies, args.bin)
+
+    if timeouts:
+        print("\n{} measurements without a motor command (is LATENCY_TEST_ACTIVE defined and a controller running?)".format(timeouts))
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as csv_file:
+            writer = csv.writer(csv_file)
+            writer.writerow(("config", "strategy", "run", "latency_us"))
+            writer.writerows(rows)
+        print("Latencies saved to {}".format(args.csv))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
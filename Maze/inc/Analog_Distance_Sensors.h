@@ -12,6 +12,22 @@
  *  - GP2Y0A21YK0F VCC          <-->  MSP432 LaunchPad 5V
  *  - GP2Y0A21YK0F GND          <-->  MSP432 LaunchPad GND
  *
+ * In DMA mode, Timer_A2 paces ADC14 repeat-sequence conversions of MEM[2] to MEM[4] and
+ * the uDMA controller moves every completed sequence into one of two sample blocks.
+ * The CPU is only interrupted when a block has been filled, while the other block
+ * continues to be filled in the background.
+ *
+ * The resolution, the sample-and-hold time, and the rate of the conversion sequences are selected with
+ * Analog_Distance_Sensor_Configure, and other analog inputs (for example a battery voltage divider) can be
+ * added to the sequence with Analog_Distance_Sensor_Add_Channel. The added channels are converted just before
+ * the three sensors, in MEM[0] and MEM[1], so the sequence still ends with MEM[4] and the DMA transfers are unchanged.
+ * The results and the filtered values are in counts of the selected resolution, and Analog_Distance_Sensor_Calibrate
+ * scales them to the 14-bit range of the calibration table.
+ *
+ * The calibration formula is evaluated by the compiler for every 64th ADC value, and the driver interpolates
+ * linearly between two table entries at run time. The conversion only uses a multiply and shifts, and it
+ * differs from the formula by at most 1 mm over the whole 14-bit range.
+ *
  * @author Aaron Nanas
  *
  */
@@ -21,12 +37,130 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "DMA.h"
 
 #define Ax 1195159
 #define Bx -1058
 #define Cx 40
 #define ANALOG_DISTANCE_SENSOR_MAX 2552
 
+// Distance returned when the filtered value is less than ANALOG_DISTANCE_SENSOR_MAX (nothing in range)
+#define ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE 800
+
+// Spacing of the calibration table entries (2^6 = 64 ADC values) and number of entries for the 14-bit range
+#define ANALOG_DISTANCE_SENSOR_LUT_SHIFT 6
+#define ANALOG_DISTANCE_SENSOR_LUT_SIZE ((16384 >> ANALOG_DISTANCE_SENSOR_LUT_SHIFT) + 1)
+
+/**
+ * @brief Coefficients of the calibration formula Dx = (A / (filtered_distance + B) + C).
+ */
+typedef struct
+{
+    int32_t A;
+    int32_t B;
+    int32_t C;
+} Analog_Distance_Sensor_Calibration;
+
+// Number of distance sensor channels converted in one sequence (A17, A14, A16)
+#define ANALOG_DISTANCE_SENSOR_NUM_CHANNELS 3
+
+// Number of sequences collected in one DMA sample block
+// Note: Must not exceed 256 because a DMA cycle is limited to 1024 transfers
+#define ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE 8
+
+// Frequency of SMCLK, the clock of ADC14 and of the Timer_A2 conversion trigger
+#define ANALOG_DISTANCE_SENSOR_SMCLK_HZ 12000000
+
+// Largest number of channels added to the sequence with Analog_Distance_Sensor_Add_Channel (MEM[0] and MEM[1])
+#define ANALOG_DISTANCE_SENSOR_MAX_EXTRA_CHANNELS 2
+
+// Highest external analog input of ADC14 (A23)
+#define ANALOG_DISTANCE_SENSOR_MAX_INPUT 23
+
+/**
+ * @brief Resolutions of the conversions (ADC14RES field of the CTL1 register).
+ */
+typedef enum
+{
+    ANALOG_DISTANCE_SENSOR_8_BIT = 0,   // 9 ADC14CLK cycles per conversion
+    ANALOG_DISTANCE_SENSOR_10_BIT = 1,  // 11 ADC14CLK cycles per conversion
+    ANALOG_DISTANCE_SENSOR_12_BIT = 2,  // 14 ADC14CLK cycles per conversion
+    ANALOG_DISTANCE_SENSOR_14_BIT = 3   // 16 ADC14CLK cycles per conversion
+} Analog_Distance_Sensor_Resolution;
+
+/**
+ * @brief Sample-and-hold times in ADC14CLK cycles (ADC14SHT0x and ADC14SHT1x fields of the CTL0 register).
+ */
+typedef enum
+{
+    ANALOG_DISTANCE_SENSOR_SAMPLE_4_CYCLES = 0,
+    ANALOG_DISTANCE_SENSOR_SAMPLE_8_CYCLES = 1,
+    ANALOG_DISTANCE_SENSOR_SAMPLE_16_CYCLES = 2,
+    ANALOG_DISTANCE_SENSOR_SAMPLE_32_CYCLES = 3,
+    ANALOG_DISTANCE_SENSOR_SAMPLE_64_CYCLES = 4,
+    ANALOG_DISTANCE_SENSOR_SAMPLE_96_CYCLES = 5,
+    ANALOG_DISTANCE_SENSOR_SAMPLE_128_CYCLES = 6,
+    ANALOG_DISTANCE_SENSOR_SAMPLE_192_CYCLES = 7
+} Analog_Distance_Sensor_Sample_Time;
+
+/**
+ * @brief Configuration of the ADC14 conversion sequence.
+ */
+typedef struct
+{
+    Analog_Distance_Sensor_Resolution Resolution;
+    Analog_Distance_Sensor_Sample_Time Sample_Time;
+    uint32_t Sequence_Rate_Hz;      // Rate of the sequences in DMA mode, which is the sample rate of every channel
+} Analog_Distance_Sensor_Config;
+
+// Configuration used when Analog_Distance_Sensor_Configure is not called: 14-bit, 32 cycles, 2 kHz
+// Note: The Timer_A2 trigger then runs at 12 MHz / 2000 = 6 kHz, as one sequence contains three conversions
+#define ANALOG_DISTANCE_SENSOR_DEFAULT_CONFIG \
+    { ANALOG_DISTANCE_SENSOR_14_BIT, ANALOG_DISTANCE_SENSOR_SAMPLE_32_CYCLES, 2000 }
+
+// uDMA channel, trigger source, and interrupt used in DMA mode
+#define ANALOG_DISTANCE_SENSOR_DMA_CHANNEL 7
+#define ANALOG_DISTANCE_SENSOR_DMA_SOURCE 7
+#define ANALOG_DISTANCE_SENSOR_DMA_INTERRUPT 1
+
+/**
+ * @brief Select the resolution, the sample-and-hold time, and the sequence rate of the conversions.
+ *
+ * The configuration is applied by the next call of Analog_Distance_Sensor_Init and Analog_Distance_Sensor_DMA_Init.
+ * In Timer A1 mode, the sequences are started by Analog_Distance_Sensor_Start_Conversion, so the sequence rate is not used.
+ *
+ * @param config The configuration, copied by the driver.
+ *
+ * @return 0 if the configuration has been selected, or -1 if the conversions of a sequence (sample-and-hold time and
+ *         conversion time of every channel) do not fit in the sequence period (the previous configuration is then kept).
+ */
+int Analog_Distance_Sensor_Configure(const Analog_Distance_Sensor_Config *config);
+
+/**
+ * @brief Add an analog input to the conversion sequence, for example a battery voltage divider.
+ *
+ * The channel is converted with the same configuration as the sensors, before them in every sequence.
+ * The pin of the input must be configured for its analog function by the caller.
+ *
+ * @param input The analog input of ADC14 (0 to ANALOG_DISTANCE_SENSOR_MAX_INPUT for A0 to A23).
+ *
+ * @note This function must be called before Analog_Distance_Sensor_Init.
+ *
+ * @return The index of the channel for Analog_Distance_Sensor_Get_Channel, or -1 if the input is not valid,
+ *         ANALOG_DISTANCE_SENSOR_MAX_EXTRA_CHANNELS channels have already been added, or the sequence would not
+ *         fit in the sequence period.
+ */
+int Analog_Distance_Sensor_Add_Channel(uint8_t input);
+
+/**
+ * @brief Return the latest result of a channel added with Analog_Distance_Sensor_Add_Channel.
+ *
+ * @param index The index of the channel.
+ *
+ * @return The result in counts of the selected resolution, or 0 if the index is not valid.
+ */
+uint32_t Analog_Distance_Sensor_Get_Channel(uint8_t index);
+
 /**
  * @brief Initialize the Sharp GP2Y0A21YK0F Analog Distance Sensors and configure ADC14 settings.
  *
@@ -58,14 +192,109 @@ void Analog_Distance_Sensor_Start_Conversion(uint32_t *Ch_17, uint32_t *Ch_14, u
  * @brief Calibrate the distance sensor reading based on a filtered distance value.
  *
  * This function calibrates the distance sensor reading based on a filtered distance value.
- * It applies a calibration formula to adjust the sensor data, providing a calibrated result.
- * The following calibration formula is used:
+ * It interpolates the calibration table generated from the following calibration formula:
  *  Dx = (Ax / (filtered_distance + Bx) + Cx)
  *
- * @param filtered_distance The filtered distance value obtained from the sensor.
+ * @param filtered_distance The filtered distance value obtained from the sensor, in counts of the selected resolution.
  *
  * @return Calibrated distance value, or 800 if the filtered distance is less than ANALOG_DISTANCE_SENSOR_MAX.
  */
 int32_t Analog_Distance_Sensor_Calibrate(int filtered_distance);
 
+/**
+ * @brief Calibrate the filtered values of the three distance sensors.
+ *
+ * @param filtered  Array of ANALOG_DISTANCE_SENSOR_NUM_CHANNELS filtered values in the order A17, A14, A16.
+ * @param converted Array to store the calibrated distances in mm, in the same order.
+ *
+ * @return None
+ */
+void Analog_Distance_Sensor_Calibrate_All(const uint32_t *filtered, int32_t *converted);
+
+/**
+ * @brief Replace the calibration formula, for example with coefficients restored from flash.
+ *
+ * This function computes a calibration table in RAM from the coefficients, with the same spacing as the default
+ * table (Ax, Bx, Cx), and selects it for the following calls of Analog_Distance_Sensor_Calibrate.
+ *
+ * @param calibration The coefficients of the calibration formula.
+ *
+ * @note This function must not be called while the control loop calibrates samples.
+ *
+ * @return 0 if the table has been computed, or -1 if a denominator of the formula is not positive
+ *         (the default table is then kept).
+ */
+int Analog_Distance_Sensor_Set_Calibration(Analog_Distance_Sensor_Calibration calibration);
+
+/**
+ * @brief Return the coefficients of the calibration formula in use.
+ *
+ * @param None
+ *
+ * @return The coefficients set by Analog_Distance_Sensor_Set_Calibration, or Ax, Bx, and Cx by default.
+ */
+Analog_Distance_Sensor_Calibration Analog_Distance_Sensor_Get_Calibration();
+
+/**
+ * @brief Switch the Analog Distance Sensors to timer-triggered, DMA-driven sampling.
+ *
+ * This function reconfigures ADC14 for repeat-sequence conversions of the added channels and MEM[2] to MEM[4],
+ * where each conversion is triggered by the Timer_A2 CCR1 output (ADC14SHSx = 101b), at the sequence rate times
+ * the number of channels. At the end of every sequence, the uDMA controller copies the three conversion results
+ * of the sensors into the active sample block using a peripheral scatter-gather task list.
+ * When a block of ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE sequences is complete, the DMA_INT1 interrupt re-arms the
+ * controller with the other block and then executes the user-defined task with the completed block.
+ *
+ * Each sample in a block is stored as three consecutive words in the following order: A17 (right), A14 (center), A16 (left).
+ * The block remains valid until the next block is completed, so the task should process it before returning.
+ *
+ * Analog_Distance_Sensor_Init must be called before this function. Analog_Distance_Sensor_Start_Conversion
+ * must not be used while DMA mode is active.
+ *
+ * @param task A pointer to the user-defined function that processes a completed sample block.
+ *
+ * @return None
+ */
+void Analog_Distance_Sensor_DMA_Init(void(*task)(uint32_t *block, uint32_t sample_count));
+
+/**
+ * @brief Stop DMA-driven sampling.
+ *
+ * This function halts Timer_A2, disables ADC14 conversions, and disables the uDMA channel.
+ * Analog_Distance_Sensor_Init can be called afterwards to return to software-triggered conversions.
+ *
+ * @return None
+ */
+void Analog_Distance_Sensor_DMA_Stop(void);
+
+/**
+ * @brief Return the number of sample blocks that have been completed in DMA mode.
+ *
+ * @return Number of completed sample blocks since Analog_Distance_Sensor_DMA_Init was called.
+ */
+uint32_t Analog_Distance_Sensor_DMA_Block_Count(void);
+
+/**
+ * @brief Return the time covered by the sample blocks completed in DMA mode.
+ *
+ * Every block adds ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE sequences at the sequence rate in use when it was filled,
+ * so the time stays correct when Analog_Distance_Sensor_Set_Sequence_Rate changes the rate.
+ *
+ * @return Sampled time in ms since Analog_Distance_Sensor_DMA_Init was called.
+ */
+uint32_t Analog_Distance_Sensor_DMA_Time_ms(void);
+
+/**
+ * @brief Change the sequence rate of the conversions while DMA mode is active.
+ *
+ * Timer_A2 is halted, its trigger period is reprogrammed, and it restarts from 0, so the ADC14 sequence and the
+ * DMA transfers continue without a restart. If DMA mode is not active, the rate is used by the next call of
+ * Analog_Distance_Sensor_DMA_Init. The resolution and the sample-and-hold time are kept.
+ *
+ * @param sequence_rate_hz The new sample rate of every channel in Hz.
+ *
+ * @return 0 if the rate has been changed, or -1 if a conversion does not fit in the trigger period at this rate.
+ */
+int Analog_Distance_Sensor_Set_Sequence_Rate(uint32_t sequence_rate_hz);
+
 #endif /* INC_ANALOG_DISTANCE_SENSORS_H_ */
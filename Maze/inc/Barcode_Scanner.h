@@ -11,6 +11,14 @@
  * @note For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
  * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
  * 
+ * @note The receiver is interrupt-driven (EUSCI_A2 interrupt):
+ *          - When no command table is set, the received characters are stored in a ring buffer of
+ *            BARCODE_SCANNER_RX_BUFFER_SIZE characters, read by Barcode_Scanner_InChar and Barcode_Scanner_Read.
+ *          - When a command table is set with Barcode_Scanner_Set_Commands, the interrupt assembles the
+ *            characters into a line, and a complete line (ended by CR) is matched against the table with its
+ *            FNV-1a hash. The handler of the matching command is executed in the interrupt, so a scanned barcode
+ *            does not use the main loop. The handlers must be short (for example setting a flag).
+ *
  * @note For more information regarding the Barcode Scanner module, refer to Mouser's product page.
  * Link: https://www.mouser.com/new/sparkfun/sparkfun-2d-barcode-scanner-board/
  *
@@ -31,8 +39,11 @@
 #include <stdint.h>
 #include <string.h>
 #include "msp.h"
+#include "Memory_Config.h"
 
-#define BARCODE_SCANNER_BUFFER_SIZE 64
+// Parameters of the 32-bit FNV-1a hash used to match the received lines
+#define BARCODE_SCANNER_FNV_OFFSET_BASIS    0x811C9DC5
+#define BARCODE_SCANNER_FNV_PRIME           0x01000193
 
 /**
  * @brief Carriage return character
@@ -59,6 +70,19 @@
  */
 #define DEL  0x7F
 
+/**
+ * @brief Command matched against the lines received from the Barcode Scanner module.
+ *
+ * Name is the complete content of the barcode, and Handler is executed in the EUSCI_A2 interrupt when it is scanned.
+ * Hash is computed by Barcode_Scanner_Set_Commands and does not need to be initialized.
+ */
+typedef struct
+{
+    const char *Name;
+    void (*Handler)(void);
+    uint32_t Hash;
+} Barcode_Scanner_Command;
+
 /**
  * @brief The Barcode_Scanner_Init function initializes the EUSCI_A2 module to use UART mode.
  *
@@ -72,6 +96,7 @@
  * - Mode: UART
  * - UART Clock Source: SMCLK
  * - Baud Rate: 115200
+ * - Receive Interrupt: Enabled (EUSCI_A2 has an IRQ number of 18)
  *
  * For more information regarding the registers used, refer to the eUSCI_A UART Registers section (24.4)
  * of the MSP432Pxx Microcontrollers Technical Reference Manual
@@ -87,7 +112,7 @@ void Barcode_Scanner_Init();
  * @brief Receives a single character over UART using the EUSCI_A2 module.
  *
  * This function receives a single character over UART using the EUSCI_A2 module.
- * It waits until a character is available in the UART receive buffer and then reads
+ * It waits until a character is available in the receive ring buffer and then reads
  * the received data. A character consists of the following bits:
  *
  * - 1 Start Bit
@@ -96,6 +121,8 @@ void Barcode_Scanner_Init();
  *
  * @param None
  *
+ * @note The ring buffer is only filled when no command table is set.
+ *
  * @return The received unsigned 8-bit data from UART.
  */
 uint8_t Barcode_Scanner_InChar();
@@ -121,8 +148,9 @@ void Barcode_Scanner_OutChar(uint8_t data);
  * @brief The Barcode_Scanner_Read function reads a set of characters from the Barcode Scanner module.
  *
  * This function reads a set of characters from the Barcode Scanner module by reading the
- * the UART Receive Buffer (UCAxRXBUF) until a carriage return (CR) character is encountered.
- * The characters are stored in the provided buffer (buffer_pointer) up to the specified maximum length (buffer_size).
+ * the receive ring buffer until a carriage return (CR) character is encountered.
+ * The characters are stored in the provided buffer (buffer_pointer) up to the specified maximum length (buffer_size),
+ * including the terminating null character.
  * The function supports backspace (BS) character for deleting characters from the buffer.
  *
  * @param buffer_pointer Pointer to the buffer where the received characters will be stored.
@@ -145,4 +173,32 @@ int Barcode_Scanner_Read(char *buffer_pointer, uint16_t buffer_size);
  */
 uint8_t Check_Barcode_Scanner_Command(char Barcode_Scanner_Buffer[], char *command_string);
 
+/**
+ * @brief Computes the 32-bit FNV-1a hash of a string.
+ *
+ * @param string The null-terminated string.
+ *
+ * @return The hash of the string.
+ */
+uint32_t Barcode_Scanner_Hash(const char *string);
+
+/**
+ * @brief Sets the command table matched by the EUSCI_A2 interrupt, and computes the hash of every command.
+ *
+ * @param commands Pointer to the command table, or 0 to store the received characters in the ring buffer instead.
+ * @param count    The number of commands in the table.
+ *
+ * @return None
+ */
+void Barcode_Scanner_Set_Commands(Barcode_Scanner_Command *commands, uint8_t count);
+
+/**
+ * @brief Returns the number of received lines that did not match any command, or that were too long.
+ *
+ * @param None
+ *
+ * @return The number of unknown lines since Barcode_Scanner_Init.
+ */
+uint32_t Barcode_Scanner_Get_Unknown_Count();
+
 #endif /* INC_BARCODE_SCANNER_H_ */
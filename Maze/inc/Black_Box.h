@@ -0,0 +1,198 @@
+/**
+ * @file Black_Box.h
+ * @brief Header file for the Black_Box module.
+ *
+ * This file contains the function definitions for the Black_Box module.
+ * It records fixed-size records, the State packets of the Telemetry driver, in flash bank 1 while the robot
+ * is running, so that whole runs are kept after a reset or a power cycle and can be downloaded later.
+ *
+ * Layout:
+ *  - The recorder uses BLACK_BOX_NUM_SECTORS sectors of 4 KB, reserved by the BLACK_BOX region of the linker
+ *    command file (msp432p401r.cmd), as a ring of pages of BLACK_BOX_PAGE_SIZE bytes. The oldest pages are
+ *    overwritten when the ring is full.
+ *  - A page starts with a header of 4 words: a magic word, the run number and the page number in the run,
+ *    the number of records and the record size, and the CRC-32 of the words 1 to 2 and the records.
+ *    The magic word is programmed last, so a page interrupted by a reset is ignored.
+ *  - Every call of Black_Box_Start begins a new run. The number of the first run after a reset follows the last
+ *    run found in flash.
+ *
+ * Writing:
+ *  - Black_Box_Log copies a record to one of two page buffers in RAM, and hands the buffer to the background
+ *    task when it is full. The task programs BLACK_BOX_WORDS_PER_TASK words per call while the other buffer is filled.
+ *  - The next sector is erased ahead while no page is waiting, so a page rarely waits for an erase. A record is
+ *    dropped and counted if both buffers are full.
+ *
+ * @note Black_Box_Log may be called from the control tick, and Black_Box_Task must be called from a background task.
+ *
+ */
+
+#ifndef INC_BLACK_BOX_H_
+#define INC_BLACK_BOX_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Flash.h"
+#include "Memory_Config.h"
+
+// Address of the first sector of the recorder (sector 16 of flash bank 1), and number of sectors
+#define BLACK_BOX_START_ADDRESS         0x00030000
+#define BLACK_BOX_NUM_SECTORS           14
+
+// Number of pages of the ring, whose page size is set in Memory_Config.h
+#define BLACK_BOX_PAGES_PER_SECTOR      (FLASH_SECTOR_SIZE / BLACK_BOX_PAGE_SIZE)
+#define BLACK_BOX_NUM_PAGES             (BLACK_BOX_NUM_SECTORS * BLACK_BOX_PAGES_PER_SECTOR)
+
+// Size of the page header in bytes
+#define BLACK_BOX_PAGE_HEADER_SIZE      16
+
+// Size of a record in bytes (a State packet payload), and number of records in a page
+#ifndef BLACK_BOX_RECORD_SIZE
+#define BLACK_BOX_RECORD_SIZE           36
+#endif
+#define BLACK_BOX_RECORDS_PER_PAGE      ((BLACK_BOX_PAGE_SIZE - BLACK_BOX_PAGE_HEADER_SIZE) / BLACK_BOX_RECORD_SIZE)
+
+// Number of words programmed by one call of Black_Box_Task (about 50 us each)
+#ifndef BLACK_BOX_WORDS_PER_TASK
+#define BLACK_BOX_WORDS_PER_TASK        64
+#endif
+
+// Default number of calls of Black_Box_Sample_Due per record
+#ifndef BLACK_BOX_DEFAULT_DECIMATION
+#define BLACK_BOX_DEFAULT_DECIMATION    10
+#endif
+
+/**
+ * @brief Header of a recorded page, returned by Black_Box_Read_Page.
+ */
+typedef struct
+{
+    uint16_t Run;
+    uint16_t Page;
+    uint16_t Count;
+} Black_Box_Page_Info;
+
+/**
+ * @brief Find the last page in flash and select the first sector of the next run.
+ *
+ * The recording starts with Black_Box_Start.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Black_Box_Init(void);
+
+/**
+ * @brief Begin a new run. The records of the current run, if any, are written first.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Black_Box_Start(void);
+
+/**
+ * @brief Stop recording. The records of the last partial page are written by the background task.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Black_Box_Stop(void);
+
+/**
+ * @brief Indicate if the records are logged.
+ *
+ * @param None
+ *
+ * @return 1 between Black_Box_Start and Black_Box_Stop, 0 otherwise.
+ */
+uint8_t Black_Box_Is_Recording(void);
+
+/**
+ * @brief Indicate if the background task still has pages to write or an erase to complete.
+ *
+ * @param None
+ *
+ * @return 1 if the flash is being written, 0 otherwise.
+ */
+uint8_t Black_Box_Is_Busy(void);
+
+/**
+ * @brief Select the number of calls of Black_Box_Sample_Due per record.
+ *
+ * @param decimation The decimation (1 to log a record at every call).
+ *
+ * @return None
+ */
+void Black_Box_Set_Decimation(uint16_t decimation);
+
+/**
+ * @brief Count a sample period and indicate if a record is due, so a record is only built when it is logged.
+ *
+ * @param None
+ *
+ * @return 1 if the recording is active and a record is due, 0 otherwise.
+ */
+uint8_t Black_Box_Sample_Due(void);
+
+/**
+ * @brief Append a record to the current page buffer.
+ *
+ * @param record Pointer to BLACK_BOX_RECORD_SIZE bytes.
+ *
+ * @return None
+ */
+void Black_Box_Log(const void *record);
+
+/**
+ * @brief Program the full page buffers and erase the next sector ahead, executed in the background.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Black_Box_Task(void);
+
+/**
+ * @brief Return a recorded page, the oldest one first.
+ *
+ * The recording should be stopped and the task idle (Black_Box_Is_Busy), so that the page is not erased while it is read.
+ *
+ * @param position The position of the page in the ring, from 0 to BLACK_BOX_NUM_PAGES - 1.
+ * @param info     Pointer to store the header of the page.
+ * @param records  Pointer to store the address of the first record in flash.
+ *
+ * @return 0 if the page is valid, or -1 if it is erased, incomplete, or corrupted.
+ */
+int Black_Box_Read_Page(uint32_t position, Black_Box_Page_Info *info, const uint8_t **records);
+
+/**
+ * @brief Return the number of the current run, or of the last run if the recording is stopped.
+ *
+ * @param None
+ *
+ * @return The run number (0 if no run has been recorded).
+ */
+uint16_t Black_Box_Get_Run(void);
+
+/**
+ * @brief Return the number of records dropped because both page buffers were full.
+ *
+ * @param None
+ *
+ * @return The number of dropped records since Black_Box_Init.
+ */
+uint32_t Black_Box_Get_Dropped(void);
+
+/**
+ * @brief Return the number of pages that could not be programmed.
+ *
+ * @param None
+ *
+ * @return The number of failed pages since Black_Box_Init.
+ */
+uint32_t Black_Box_Get_Errors(void);
+
+#endif /* INC_BLACK_BOX_H_ */
@@ -0,0 +1,70 @@
+/**
+ * @file Black_Box_Dump.h
+ * @brief Header file for the Black_Box_Dump module.
+ *
+ * This file contains the function definitions for the Black_Box_Dump module.
+ * It executes the black box commands received by the Parameters module, and sends the records of the flash
+ * black box (see Black_Box.h) to the host in the background after a run.
+ *
+ * Commands:
+ *  - blackbox dump     Stop the recording and send every record as a Log packet, oldest first,
+ *                      then print "ok blackbox dump <count> <dropped>"
+ *  - blackbox start    Begin a new run, printed back as "ok blackbox run <number>"
+ *  - blackbox stop     Stop the recording
+ *  - blackbox status   Print the current run, the recording state, and the dropped records and failed pages
+ *
+ * @note The records are always sent as Log packets of the Telemetry module, so the dump requires a host that
+ *       decodes the frames, for example PMOD_Color_Display.py.
+ *
+ */
+
+#ifndef INC_BLACK_BOX_DUMP_H_
+#define INC_BLACK_BOX_DUMP_H_
+
+#include <stdint.h>
+#include "EUSCI_A0_UART.h"
+#include "Telemetry.h"
+#include "Black_Box.h"
+#include "Parameters.h"
+
+/**
+ * @brief This function selects the function that sends the replies, and cancels a dump.
+ *
+ * @param output The function that sends a reply line (without line ending), for example the output of the Parameters module.
+ *
+ * @return None
+ */
+void Black_Box_Dump_Init(void (*output)(const char *line));
+
+/**
+ * @brief This function executes the black box commands received by the Parameters module.
+ *
+ * @param arguments      The words of the command line.
+ * @param argument_count The number of words.
+ *
+ * @return 0 if the command has been executed, or -1 if it is not a black box command.
+ */
+int Black_Box_Dump_Command(char **arguments, uint8_t argument_count);
+
+/**
+ * @brief This function sends the next records of a black box dump, executed in the background.
+ *
+ * The dump waits for the last partial page to be written, then the records are only queued while the
+ * TX ring buffer has room for them, like the records of a trace dump.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Black_Box_Dump_Task(void);
+
+/**
+ * @brief This function returns 1 while the black box is dumped, so that the other packets can be held back.
+ *
+ * @param None
+ *
+ * @return 1 if a dump is running, or 0 otherwise.
+ */
+uint8_t Black_Box_Dump_Is_Active(void);
+
+#endif /* INC_BLACK_BOX_DUMP_H_ */
@@ -24,6 +24,15 @@
  * @note The Bumper Switches operate in an active low configuration.
  * When the switches are pressed, they connect to GND.
  *
+ * Collision events:
+ *  - The PORT4 interrupt timestamps every falling edge with the DWT cycle counter (CycleCounter_Init must be called).
+ *    An edge within BUMPER_DEBOUNCE_CYCLES of the previous edge of the same switch is a contact bounce and is ignored,
+ *    so a contact produces one event with the time of its first edge.
+ *  - A contact of a switch selected by Bumper_Set_Motor_Cutoff stops the motors inside the interrupt, before the
+ *    next control tick, and latches the cutoff until Bumper_Clear_Cutoff is called.
+ *  - The events are stored in a lock-free SPSC_Queue of BUMPER_EVENT_QUEUE_SIZE entries and read with
+ *    Bumper_Get_Event from a single consumer. An event is dropped and counted when the queue is full.
+ *
  * @author Aaron Nanas
  *
  */
@@ -33,24 +42,38 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "CortexM.h"
+#include "Motor.h"
+#include "SPSC_Queue.h"
+#include "Memory_Config.h"
+
+// Quiet time after an edge during which the next edges of the same switch are contact bounces (5 ms at 48 MHz)
+#define BUMPER_DEBOUNCE_CYCLES      240000
+
+// All six Bumper Switches, in the bit order of Bumper_Read
+#define BUMPER_ALL_SWITCHES         0x3F
+
+/**
+ * @brief Collision event recorded by the PORT4 interrupt.
+ *
+ * Switches holds the switches that made a new contact, and State holds the switches that were pressed,
+ * both in the bit order of Bumper_Read.
+ */
+typedef struct
+{
+    uint32_t Timestamp_Cycles;
+    uint8_t Switches;
+    uint8_t State;
+} Bumper_Event;
 
 /**
  * @brief User-defined task function for handling Bumper Switch interrupt events.
  *
  * This is a user-defined function that can be assigned to the Bumper_Task pointer during initialization.
- * When a falling edge event is detected on any of the Bumper Switch pins (P4.7, P4.6, P4.5, P4.3, P4.2, or P4.0),
- * this function will be called, and the bumper_switch_state parameter will indicate which specific bumper switch triggered the interrupt.
- *
- * @param bumper_switch_state An 8-bit unsigned integer representing the Bumper Switch that triggered the interrupt.
- *                   The bit positions correspond to the following switches:
- *                   - Bit 7 (MSB): P4.7 Bumper Switch
- *                   - Bit 6: P4.6 Bumper Switch
- *                   - Bit 5: P4.5 Bumper Switch
- *                   - Bit 4: Reserved (unused)
- *                   - Bit 3: P4.3 Bumper Switch
- *                   - Bit 2: P4.2 Bumper Switch
- *                   - Bit 1: Reserved (unused)
- *                   - Bit 0 (LSB): P4.0 Bumper Switch
+ * When a debounced falling edge event is detected on any of the Bumper Switch pins (P4.7, P4.6, P4.5, P4.3, P4.2, or P4.0),
+ * this function will be called, and the bumper_switch_state parameter will indicate which bumper switches are pressed.
+ *
+ * @param bumper_switch_state The 6-bit state of the Bumper Switches returned by Bumper_Read.
  *
  * @return None
  */
@@ -65,7 +88,8 @@ void (*Bumper_Task)(uint8_t bumper_switch_state);
  *
  * The specified task function should take a single uint8_t parameter.
  *
- * @param task A pointer to the user-defined function that will be called on a falling edge event.
+ * @param task A pointer to the user-defined function that will be called on a falling edge event, or 0 if the
+ *             events are only read from the queue.
  *
  * @return None
  */
@@ -86,4 +110,67 @@ void Bumper_Switches_Init(void(*task)(uint8_t));
  */
 uint8_t Bumper_Read(void);
 
+/**
+ * @brief Select the Bumper Switches that stop the motors inside the interrupt.
+ *
+ * @param switches The switches in the bit order of Bumper_Read (BUMPER_ALL_SWITCHES for every switch, 0 for none).
+ *
+ * @return None
+ */
+void Bumper_Set_Motor_Cutoff(uint8_t switches);
+
+/**
+ * @brief Return the switches that have stopped the motors since the last call of Bumper_Clear_Cutoff.
+ *
+ * The motors must not be driven again while the cutoff is latched.
+ *
+ * @param None
+ *
+ * @return The switches in the bit order of Bumper_Read, or 0 if the motors have not been stopped.
+ */
+uint8_t Bumper_Get_Cutoff(void);
+
+/**
+ * @brief Release the latched motor cutoff, once the collision has been handled.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Bumper_Clear_Cutoff(void);
+
+/**
+ * @brief Read the oldest collision event from the queue.
+ *
+ * This function must be called from a single context (for example the control task).
+ *
+ * @param event Pointer to store the event.
+ *
+ * @return 1 if an event has been read, or 0 if the queue is empty.
+ */
+int Bumper_Get_Event(Bumper_Event *event);
+
+/**
+ * @brief Return the number of events dropped because the queue was full.
+ *
+ * @param None
+ *
+ * @return The number of dropped events since Bumper_Switches_Init.
+ */
+uint32_t Bumper_Get_Dropped_Events(void);
+
+/**
+ * @brief Hand the PORT4 interrupts of other P4 pins to another driver, for example the OPT3001 INT output on P4.2.
+ *
+ * The flags of these pins are cleared and the handler is executed by the PORT4 interrupt, instead of being
+ * handled as Bumper Switch edges. The other driver configures its pins, and Bumper_Switches_Init should not be
+ * called if a pin is also a Bumper Switch pin.
+ *
+ * @param pins    The P4 bits handed to the handler.
+ * @param handler The function executed from the PORT4 interrupt with the flags that were set, or 0 for none.
+ *
+ * @return None
+ */
+void Bumper_Set_Port_Handler(uint8_t pins, void (*handler)(uint8_t port_flags));
+
 #endif /* BUMPER_SWITCHES_H_ */
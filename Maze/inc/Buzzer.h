@@ -5,6 +5,10 @@
  * This file contains the function definitions for the Buzzer driver.
  * It interfaces with a Piezo Buzzer using the P1.6 pin (GPIO).
  *
+ * Play_Note and Play_Note_Pattern toggle the pin in delay loops and block the CPU. A tune can instead be
+ * played in the background with Buzzer_Play_Tune: the CCR2 compare interrupt of Timer A3 toggles the pin
+ * at the frequency of the current note, and Buzzer_Task moves to the next note when its duration has elapsed.
+ *
  * @author Aaron Nanas
  *
  */
@@ -15,6 +19,40 @@
 #include <stdint.h>
 #include "msp.h"
 #include "Clock.h"
+#include "CortexM.h"
+#include "Timer_A3_Capture.h"
+
+// Period at which Buzzer_Task is called in ms
+#ifndef BUZZER_TASK_PERIOD_MS
+#define BUZZER_TASK_PERIOD_MS   10
+#endif
+
+// Frequency of the Timer A3 clock (SMCLK)
+#define BUZZER_TIMER_CLOCK_HZ   12000000
+
+// Frequencies of the notes in Hz (a frequency of 0 is a rest)
+// Note: The half period must fit in the 16-bit compare interval, so the lowest frequency is 92 Hz
+#define BUZZER_REST             0
+#define BUZZER_NOTE_C4          262
+#define BUZZER_NOTE_D4          294
+#define BUZZER_NOTE_E4          330
+#define BUZZER_NOTE_F4          349
+#define BUZZER_NOTE_G4          392
+#define BUZZER_NOTE_A4          440
+#define BUZZER_NOTE_B4          494
+#define BUZZER_NOTE_C5          523
+#define BUZZER_NOTE_E5          659
+#define BUZZER_NOTE_G5          784
+#define BUZZER_NOTE_C6          1047
+
+/**
+ * @brief A note of a tune played by Buzzer_Play_Tune.
+ */
+typedef struct
+{
+    uint16_t Frequency_Hz;
+    uint16_t Duration_ms;
+} Buzzer_Note;
 
 /**
  * @brief The Buzzer_Init function initializes the pin used by the Piezo Buzzer (P1.6).
@@ -45,6 +83,56 @@ void Buzzer_On();
  */
 void Buzzer_Off();
 
+/**
+ * @brief Toggle the P1.6 pin, called by the Timer A3 compare interrupt while a note is playing.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Buzzer_Toggle();
+
+/**
+ * @brief Start playing a tune in the background. A tune that is still playing is replaced.
+ *
+ * @param tune   Pointer to the notes, which must remain valid until the tune has been played.
+ * @param length The number of notes.
+ *
+ * @note Assumes Buzzer_Init() and Tachometer_Init() (which starts Timer A3) have been called
+ *
+ * @return None
+ */
+void Buzzer_Play_Tune(const Buzzer_Note *tune, uint8_t length);
+
+/**
+ * @brief Stop the tune that is playing, if any, and turn off the buzzer.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Buzzer_Stop();
+
+/**
+ * @brief Indicate if a tune is playing.
+ *
+ * @param None
+ *
+ * @return 1 if a tune is playing, 0 otherwise.
+ */
+uint8_t Buzzer_Is_Playing();
+
+/**
+ * @brief Move to the next note of the tune when the duration of the current note has elapsed.
+ *
+ * This function must be called every BUZZER_TASK_PERIOD_MS, the note durations are rounded up to this period.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Buzzer_Task();
+
 /**
  * @brief The Play_Note function produces a square wave signal based on the selected frequency.
  *
@@ -60,6 +148,8 @@ void Buzzer_Off();
  *  A4          440                 1165
  *  B4          493                 1040
  *
+ * @note This function blocks for two periods of the note, use Buzzer_Play_Tune to play in the background.
+ *
  * @return None
  */
 void Play_Note(int note_delay_value);
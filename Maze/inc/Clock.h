@@ -48,6 +48,32 @@ those of the authors and should not be interpreted as representing official
 policies, either expressed or implied, of the FreeBSD Project.
 */
 
+#ifndef INC_CLOCK_H_
+#define INC_CLOCK_H_
+
+#include <stdint.h>
+
+// Frequency of MCLK in the run profile selected by Clock_Init48MHz (HFXT)
+#define CLOCK_RUN_FREQUENCY_HZ      48000000
+
+// Divider of MCLK in the idle profile (1, 2, 4, 8, 16, 32, 64, or 128): 12 MHz
+#ifndef CLOCK_IDLE_MCLK_DIVIDER
+#define CLOCK_IDLE_MCLK_DIVIDER     4
+#endif
+
+/**
+ * @brief Frequency profiles of MCLK selected by Clock_Set_Profile.
+ *
+ * Both profiles run from HFXT, only the MCLK divider changes. SMCLK (12 MHz) and HSMCLK (24 MHz) keep
+ * their frequency, so the Timer_A, EUSCI, and ADC14 modules are not affected by a change of profile.
+ */
+typedef enum
+{
+    CLOCK_PROFILE_RUN,
+    CLOCK_PROFILE_IDLE,
+    CLOCK_NUM_PROFILES
+} Clock_Profile;
+
 /**
  * Configure the MSP432 clock to run at 48 MHz
  * @param none
@@ -63,7 +89,7 @@ void Clock_Init48MHz(void);
  * Return the current bus clock frequency
  * @param none
  * @return frequency of the system clock in Hz
- * @note  In this module, the return result will be 3000000 or 48000000
+ * @note  In this module, the return result will be 3000000, 48000000, or the frequency of the idle profile
  * @see Clock_Init48MHz()
  * @brief Returns current clock bus frequency in Hz
  */
@@ -75,7 +101,7 @@ uint32_t Clock_GetFreq(void);
  * It is implemented with a nested for-loop and is very approximate.
  * @param  n is the number of msec to wait
  * @return none
- * @note This function assumes a 48 MHz clock.
+ * @note The delay is scaled to the frequency returned by Clock_GetFreq().
  * This implementation is not very accurate.
  * To improve accuracy, you could tune this function
  * by adjusting the constant within the implementation
@@ -90,7 +116,7 @@ void Clock_Delay1ms(uint32_t n);
  * It is implemented with a nested for-loop and is very approximate.
  * @param  n is the number of usec to wait
  * @return none
- * @note This function assumes a 48 MHz clock.
+ * @note The delay is scaled to the frequency returned by Clock_GetFreq().
  * This implementation is not very accurate.
  * To improve accuracy, you could tune this function
  * by adjusting the constant within the implementation
@@ -100,4 +126,48 @@ void Clock_Delay1ms(uint32_t n);
  */
 void Clock_Delay1us(uint32_t n);
 
+/**
+ * @brief Switch MCLK to the frequency of a profile, and rescale the SysTick period so that its rate is kept.
+ *
+ * The flash wait states follow the frequency: they are raised before MCLK is sped up, and lowered after it
+ * is slowed down. The time spent in the previous profile is added to its total (see Clock_Get_Profile_Time_ms).
+ *
+ * @param profile CLOCK_PROFILE_RUN (48 MHz) or CLOCK_PROFILE_IDLE (48 MHz / CLOCK_IDLE_MCLK_DIVIDER).
+ *
+ * @note Clock_Init48MHz must have been called. The CycleCounter and Timer32 count MCLK, so a duration in cycles
+ *       is CLOCK_IDLE_MCLK_DIVIDER times longer in the idle profile: use Clock_GetFreq to convert it.
+ *
+ * @return None
+ */
+void Clock_Set_Profile(Clock_Profile profile);
+
+/**
+ * @brief Return the profile selected by Clock_Set_Profile.
+ *
+ * @param None
+ *
+ * @return CLOCK_PROFILE_RUN or CLOCK_PROFILE_IDLE.
+ */
+Clock_Profile Clock_Get_Profile(void);
+
+/**
+ * @brief Add the time elapsed in the current profile to its total.
+ *
+ * @note Must be called at least once every 89 s (2^32 cycles at 48 MHz), for example from a periodic task.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Clock_Update_Profile_Time(void);
+
+/**
+ * @brief Return the time spent in a profile since Clock_Init48MHz.
+ *
+ * @param profile CLOCK_PROFILE_RUN or CLOCK_PROFILE_IDLE.
+ *
+ * @return The time in ms, up to the last call of Clock_Update_Profile_Time or Clock_Set_Profile.
+ */
+uint32_t Clock_Get_Profile_Time_ms(Clock_Profile profile);
 
+#endif /* INC_CLOCK_H_ */
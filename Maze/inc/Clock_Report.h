@@ -0,0 +1,39 @@
+/**
+ * @file Clock_Report.h
+ * @brief Header file for the Clock_Report module.
+ *
+ * This file contains the function definitions for the Clock_Report module.
+ * It executes the clock command received by the Parameters module, which reports the clock profiles of the Clock driver.
+ *
+ * Commands:
+ *  - clock     Print "clock profile=<profile> mclk=<Hz> run_ms=<ms> idle_ms=<ms>", the time spent in each profile since boot
+ *
+ */
+
+#ifndef INC_CLOCK_REPORT_H_
+#define INC_CLOCK_REPORT_H_
+
+#include <stdint.h>
+#include "Clock.h"
+#include "Parameters.h"
+
+/**
+ * @brief This function selects the function that sends the replies.
+ *
+ * @param output The function that sends a reply line (without line ending), for example the output of the Parameters module.
+ *
+ * @return None
+ */
+void Clock_Report_Init(void (*output)(const char *line));
+
+/**
+ * @brief This function executes the clock command received by the Parameters module.
+ *
+ * @param arguments      The words of the command line.
+ * @param argument_count The number of words.
+ *
+ * @return 0 if the command has been executed, or -1 if it is not the clock command.
+ */
+int Clock_Report_Command(char **arguments, uint8_t argument_count);
+
+#endif /* INC_CLOCK_REPORT_H_ */
@@ -0,0 +1,141 @@
+/**
+ * @file Color_Classifier.h
+ * @brief Header file for the Color_Classifier driver.
+ *
+ * This file contains the function definitions for the Color_Classifier driver.
+ * It classifies the samples of the PMOD Color module by the nearest centroid of a configurable palette.
+ *
+ * Chromaticity:
+ *  - The red, green, and blue counts of a raw sample are divided by the clear count, so the classification
+ *    does not depend on the brightness of the surface or on the distance to the sensor.
+ *  - The chromaticity is a Q10 fixed-point value: COLOR_CLASSIFIER_CHROMA_ONE means that the channel
+ *    is equal to the clear count. It is computed with one divide and three multiplies.
+ *  - Since black, gray, and white surfaces have the same chromaticity, a sample with a clear count below
+ *    the minimum clear count of the palette is not classified.
+ *
+ * Confidence:
+ *  - The confidence compares the distance to the nearest centroid (d1) with the distance to the second nearest
+ *    centroid (d2): 255 * (d2 - d1) / d2. It is 255 for a sample on a centroid, and 0 for a sample halfway
+ *    between two centroids. With a single centroid, d2 is the maximum distance of the palette.
+ *
+ * Ambient light:
+ *  - The room light reflected by the surface adds counts to every channel, which shifts the chromaticity of
+ *    every surface towards the color of the room light. Color_Classifier_Set_Ambient estimates these counts
+ *    from the light intensity (for example measured by the OPT3001) and the counts per 1000 lux of each channel,
+ *    and they are removed from every sample before the chromaticity and the minimum clear count are computed.
+ *  - The counts per 1000 lux are measured once for the sensor, by recording the raw samples with the LED off
+ *    over the floor at a known light intensity, so the centroids do not need to be measured again in every room.
+ *
+ * The centroids of a palette are measured by placing the sensor over each surface and recording
+ * the values returned by Color_Classifier_Get_Chromaticity.
+ *
+ */
+
+#ifndef INC_COLOR_CLASSIFIER_H_
+#define INC_COLOR_CLASSIFIER_H_
+
+#include <stdint.h>
+#include "PMOD_Color.h"
+
+// Chromaticity of a channel equal to the clear count (Q10)
+#define COLOR_CLASSIFIER_CHROMA_ONE     1024
+
+// Largest chromaticity of a channel, so that the squared distances fit in 32 bits
+#define COLOR_CLASSIFIER_CHROMA_MAX     2047
+
+// Largest squared distance between two chromaticities (3 * 2047^2)
+#define COLOR_CLASSIFIER_DISTANCE_LIMIT 12570627
+
+// Identifier returned when the sample is too dark or too far from every centroid
+#define COLOR_CLASSIFIER_UNKNOWN        0xFF
+
+// Maximum number of centroids in a palette
+#define COLOR_CLASSIFIER_MAX_COLORS     8
+
+/**
+ * @brief Chromaticity of a color (Q10, see COLOR_CLASSIFIER_CHROMA_ONE).
+ */
+typedef struct
+{
+    uint16_t Red;
+    uint16_t Green;
+    uint16_t Blue;
+} Color_Classifier_Centroid;
+
+/**
+ * @brief Palette of centroids. The identifier of a color is its index in the palette.
+ *
+ * Max_Distance is the largest squared distance from the nearest centroid of a classified sample,
+ * and Min_Clear is the smallest clear count of a classified sample.
+ */
+typedef struct
+{
+    const Color_Classifier_Centroid *Centroids;
+    uint8_t Num_Colors;
+    uint32_t Max_Distance;
+    uint16_t Min_Clear;
+} Color_Classifier_Palette;
+
+/**
+ * @brief Counts added to the raw channels per 1000 lux of ambient light.
+ */
+typedef struct
+{
+    uint16_t Red;
+    uint16_t Green;
+    uint16_t Blue;
+    uint16_t Clear;
+} Color_Classifier_Ambient_Gain;
+
+/**
+ * @brief Result of a classification.
+ */
+typedef struct
+{
+    uint8_t ID;
+    uint8_t Confidence;
+} Color_Classifier_Result;
+
+/**
+ * @brief Select the ambient light removed from the raw samples.
+ *
+ * @note It must be called from the same context as Color_Classifier_Classify and Color_Classifier_Get_Chromaticity.
+ *
+ * @param gain      The counts per 1000 lux of each channel.
+ * @param centi_lux The light intensity in 0.01 lux (0 to not remove any ambient light).
+ *
+ * @return None
+ */
+void Color_Classifier_Set_Ambient(const Color_Classifier_Ambient_Gain *gain, uint32_t centi_lux);
+
+/**
+ * @brief Return the counts removed from the raw samples.
+ *
+ * @param None
+ *
+ * @return The counts of the ambient light for each channel.
+ */
+PMOD_Color_Data Color_Classifier_Get_Ambient(void);
+
+/**
+ * @brief Compute the chromaticity of a raw sample, after the ambient light has been removed.
+ *
+ * @param sample     The raw sample of the PMOD Color module.
+ * @param chromaticity Pointer to store the chromaticity.
+ *
+ * @return None
+ */
+void Color_Classifier_Get_Chromaticity(PMOD_Color_Data sample, Color_Classifier_Centroid *chromaticity);
+
+/**
+ * @brief Classify a raw sample by the nearest centroid of the palette.
+ *
+ * @param palette The palette of centroids (1 to COLOR_CLASSIFIER_MAX_COLORS colors).
+ * @param sample  The raw sample of the PMOD Color module.
+ *
+ * @return The index of the nearest centroid and the confidence (0 to 255), or COLOR_CLASSIFIER_UNKNOWN
+ *         with a confidence of 0 if the sample is too dark or too far from every centroid.
+ */
+Color_Classifier_Result Color_Classifier_Classify(const Color_Classifier_Palette *palette, PMOD_Color_Data sample);
+
+#endif /* INC_COLOR_CLASSIFIER_H_ */
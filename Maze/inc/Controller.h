@@ -0,0 +1,353 @@
+/**
+ * @file Controller.h
+ * @brief Header file for the Controller module.
+ *
+ * This file contains the function definitions for the maze controllers:
+ *  - Controller_1: Follows the right wall (Follow_Right_Wall) or the left wall (Follow_Left_Wall) to the dead end,
+ *                  or to the goal when the maze-goal barcode is scanned.
+ *  - Controller_2: Explores the maze with the Maze_Map flood fill and drives to the goal on the shortest known path.
+ *
+ * Follow_Right_Wall, Follow_Left_Wall, and Maze_Exploration_Step return 1 once the robot has reached the end
+ * of the maze, so they can be registered as strategies of the Route_Race module.
+ *
+ * The controllers only use the converted distances, the Motion, Speed_Controller, and Motor drivers, and the Maze_Map,
+ * Route, and Traction modules, so the same code runs on the robot and in the host simulator (Simulator directory).
+ * Each controller must be called once per control tick (100 Hz) after Motion_Update. The wall follower reads the
+ * open sides of the Junction classifier, so Junction_Update must be called before it in the same tick.
+ *
+ * Every parameter below can be overridden from the compiler command line (for example, -DFORWARD_SPEED=250)
+ * to try other values in the simulator.
+ *
+ */
+
+#ifndef INC_CONTROLLER_H_
+#define INC_CONTROLLER_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "Motor.h"
+#include "Motion.h"
+#include "Speed_Controller.h"
+#include "Maze_Map.h"
+#include "Route.h"
+#include "Junction.h"
+
+// Initialize constant distance values (in mm)
+#ifndef TOO_CLOSE_DISTANCE
+#define TOO_CLOSE_DISTANCE  200
+#endif
+#ifndef TOO_FAR_DISTANCE
+#define TOO_FAR_DISTANCE    400
+#endif
+#ifndef DESIRED_DISTANCE
+#define DESIRED_DISTANCE    200
+#endif
+
+// Initialize constant PWM duty cycle values for the motors
+#ifndef PWM_NOMINAL
+#define PWM_NOMINAL         2500
+#endif
+#ifndef PWM_SWING
+#define PWM_SWING           1000
+#endif
+#ifndef PWM_MIN
+#define PWM_MIN             (PWM_NOMINAL - PWM_SWING)
+#endif
+#ifndef PWM_MAX
+#define PWM_MAX             (PWM_NOMINAL + PWM_SWING)
+#endif
+
+// Duty cycle and angle of a 90 degree turn, and the longest time without progress (in SysTick interrupts)
+// after which a turn times out, for example when a wheel is stalled
+#ifndef TURN_DUTY_CYCLE
+#define TURN_DUTY_CYCLE     3500
+#endif
+#ifndef TURN_ANGLE
+#define TURN_ANGLE          90
+#endif
+#ifndef TURN_TIMEOUT_TICKS
+#define TURN_TIMEOUT_TICKS  50
+#endif
+
+// Closed-loop wheel speed used when driving straight along a wall (in mm/s)
+#ifndef FORWARD_SPEED
+#define FORWARD_SPEED       200
+#endif
+
+// Duty cycle of the wheels when the wall follower pivots towards an opening or away from a wall
+#ifndef PIVOT_DUTY_CYCLE
+#define PIVOT_DUTY_CYCLE    2000
+#endif
+
+// Distances along the heading from the center of the robot to the side sensors and to the center sensor (in mm),
+// used by the wall follower to locate the center of a cell from the walls that the sensors see
+#ifndef FOLLOW_SIDE_SENSOR_OFFSET
+#define FOLLOW_SIDE_SENSOR_OFFSET   50
+#endif
+#ifndef FOLLOW_CENTER_SENSOR_OFFSET
+#define FOLLOW_CENTER_SENSOR_OFFSET 80
+#endif
+
+// Number of control ticks during which the wall follower stands still after a turn away from the followed wall,
+// so the Junction classifier accepts the sides seen in the new heading before the next decision
+#ifndef FOLLOW_SETTLE_TICKS
+#define FOLLOW_SETTLE_TICKS (JUNCTION_MIN_DWELL_TICKS + 3)
+#endif
+
+// Wall-centering controller used by the wall follower when driving along a wall
+// Distance measured by a side sensor in the center of a corridor (in mm), used when only one wall is seen
+#ifndef WALL_CENTERING_SET_POINT
+#define WALL_CENTERING_SET_POINT        120
+#endif
+// Largest speed difference added to each wheel (in mm/s)
+#ifndef WALL_CENTERING_MAX_CORRECTION
+#define WALL_CENTERING_MAX_CORRECTION   80
+#endif
+// Scale of the gain table that leaves the gains unchanged (Kp_Scale and Kd_Scale)
+#define WALL_CENTERING_GAIN_SCALE       256
+// Default of Kd_Scale, 0 disables the derivative term
+// Note: With a 6% gain mismatch between the wheels, even 1/8 of the derivative gains of the table makes the wall
+// followers of the simulator hit walls on lab_branches, while the proportional term alone does not
+#ifndef WALL_CENTERING_KD_SCALE
+#define WALL_CENTERING_KD_SCALE         0
+#endif
+
+// Walls seen by the wall-centering controller
+#define WALL_CENTERING_LEFT_WALL        0x01
+#define WALL_CENTERING_RIGHT_WALL       0x02
+
+/**
+ * @brief Gains of the wall-centering controller for a speed of the robot.
+ *
+ * The gains are in Q8 (256 = 1). The proportional term is in mm/s per mm of error,
+ * and the derivative term in mm/s per mm of error change during a control tick.
+ */
+typedef struct
+{
+    int32_t Speed;
+    int32_t Kp;
+    int32_t Kd;
+} Wall_Centering_Gains;
+
+// Maze exploration parameters used by Controller_2
+// A side is a wall when the sensor measures less than MAZE_WALL_DISTANCE from the center of a cell
+#ifndef MAZE_CELL_SIZE
+#define MAZE_CELL_SIZE              250
+#endif
+#ifndef MAZE_WALL_DISTANCE
+#define MAZE_WALL_DISTANCE          180
+#endif
+#ifndef MAZE_COLLISION_DISTANCE
+#define MAZE_COLLISION_DISTANCE     80
+#endif
+#ifndef MAZE_DRIVE_DUTY_CYCLE
+#define MAZE_DRIVE_DUTY_CYCLE       3500
+#endif
+#ifndef MAZE_DRIVE_TIMEOUT_TICKS
+#define MAZE_DRIVE_TIMEOUT_TICKS    300
+#endif
+
+// Speed run parameters used to replay the winning route
+// Note: The maximum speed needs about 12000 of the 14000 duty cycle limit of the Speed_Controller
+#ifndef SPEED_RUN_MAX_SPEED
+#define SPEED_RUN_MAX_SPEED             450
+#endif
+#ifndef SPEED_RUN_ACCELERATION
+#define SPEED_RUN_ACCELERATION          800
+#endif
+#ifndef SPEED_RUN_CELL_TIMEOUT_TICKS
+#define SPEED_RUN_CELL_TIMEOUT_TICKS    100
+#endif
+#ifndef SPEED_RUN_TURN_DUTY_CYCLE
+#define SPEED_RUN_TURN_DUTY_CYCLE       5000
+#endif
+#ifndef SPEED_RUN_TURN_TIMEOUT_TICKS
+#define SPEED_RUN_TURN_TIMEOUT_TICKS    40
+#endif
+
+// Corners of the speed run are driven as arcs through the center of the corner cell
+// Note: The outer wheel of an arc turns at (2 * r + 140) / (2 * r) times the arc speed
+#ifndef SPEED_RUN_ARC_RADIUS
+#define SPEED_RUN_ARC_RADIUS            (MAZE_CELL_SIZE / 2)
+#endif
+#ifndef SPEED_RUN_ARC_SPEED
+#define SPEED_RUN_ARC_SPEED             250
+#endif
+
+// Maximum number of cells replanned by Controller_2 in one control tick
+// Note: Check Maze_Map_Get_Max_Update_Cycles against the SysTick period (480,000 cycles) when changing this value
+#ifndef MAZE_REPLAN_CELLS_PER_TICK
+#define MAZE_REPLAN_CELLS_PER_TICK  64
+#endif
+
+// Distances used by the controllers (in mm), updated before every control tick
+extern int32_t Converted_Distance_Left;
+extern int32_t Converted_Distance_Center;
+extern int32_t Converted_Distance_Right;
+
+// Centering error of the wall-centering controller (in mm), and distance used when only one wall is seen
+extern int32_t Error;
+extern int32_t Set_Point;
+
+// Runtime values of DESIRED_DISTANCE, FORWARD_SPEED, and PIVOT_DUTY_CYCLE used by the wall follower, and the scales
+// of the proportional and derivative gains of the wall-centering controller (WALL_CENTERING_GAIN_SCALE = table values)
+// Note: They can be changed while the robot is running, for example with the Parameters module
+extern int32_t Desired_Distance;
+extern int32_t Forward_Speed;
+extern int32_t Pivot_Duty_Cycle;
+extern int32_t Kp_Scale;
+extern int32_t Kd_Scale;
+
+// Duty cycle values of the motors
+extern uint16_t Duty_Cycle_Left;
+extern uint16_t Duty_Cycle_Right;
+
+// Cell and heading of the robot in the maze map used by Controller_2, and set to 1 when a goal cell is reached
+// (by Controller_2, or by the maze-goal barcode for the wall follower)
+extern uint8_t Maze_X;
+extern uint8_t Maze_Y;
+extern Maze_Direction Maze_Heading;
+extern uint8_t Maze_Goal_Reached;
+
+/**
+ * @brief This function resets the progress of the controllers and the distances.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Controller_Init();
+
+/**
+ * @brief This function queues a 90 degree turn to the right.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Turn_Right();
+
+/**
+ * @brief This function queues a 90 degree turn to the left.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Turn_Left();
+
+/**
+ * @brief This function drives along the corridor at a speed and keeps the robot in its center.
+ *
+ * It sets the speeds of the Speed_Controller with a proportional-derivative correction of the centering error,
+ * using both walls when they are seen, or the distance to a single wall otherwise.
+ *
+ * @param speed The speed of the robot in mm/s.
+ *
+ * @return None
+ */
+void Wall_Centering_Drive(int16_t speed);
+
+/**
+ * @brief This function restarts the wall follower in the center of the start cell.
+ *
+ * The wall follower takes its decisions in the center of the cells, which it locates from the odometry distance
+ * and the Junction events, and turns to the grid directions of the start heading. It also restarts the Junction classifier
+ * and clears Maze_Goal_Reached. It must be
+ * called when the robot is placed in the center of the start cell, for example at the start of each trial
+ * of a route race.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Follow_Wall_Restart();
+
+/**
+ * @brief This function follows the right wall for one control tick.
+ *
+ * The robot stops at the dead end, where the walls are seen on the three sides, or in the goal cell
+ * once Maze_Goal_Reached has been set by the maze-goal barcode, so the recorded route ends in the goal.
+ *
+ * @param None
+ *
+ * @return 1 if the robot has stopped at the dead end or in the goal cell, or 0 otherwise.
+ */
+uint8_t Follow_Right_Wall();
+
+/**
+ * @brief This function follows the left wall for one control tick.
+ *
+ * The robot stops at the dead end, where the walls are seen on the three sides, or in the goal cell
+ * once Maze_Goal_Reached has been set by the maze-goal barcode, so the recorded route ends in the goal.
+ *
+ * @param None
+ *
+ * @return 1 if the robot has stopped at the dead end or in the goal cell, or 0 otherwise.
+ */
+uint8_t Follow_Left_Wall();
+
+/**
+ * @brief This function clears the maze map and selects the four center cells as the goal.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Maze_Exploration_Init();
+
+/**
+ * @brief This function explores the maze and moves towards the goal on the shortest known path.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Controller_2();
+
+/**
+ * @brief This function moves the robot back to the start cell of the maze map for a new trial of Controller_2.
+ *
+ * The pose is reset to cell (0, 0) facing north and the walls explored by the previous trials are kept,
+ * so the trial drives the shortest known path and explores only the cells that are still unknown.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Maze_Exploration_Restart();
+
+/**
+ * @brief This function executes Controller_2 for one control tick.
+ *
+ * @param None
+ *
+ * @return 1 if a goal cell has been reached, or 0 otherwise.
+ */
+uint8_t Maze_Exploration_Step();
+
+/**
+ * @brief This function records a wall hit by the bumper while Controller_2 drives to the next cell.
+ *
+ * The drive is aborted and the wall is recorded ahead of the target cell, like a collision seen by the center
+ * distance sensor. The next call of Controller_2 then records the other walls and replans from this cell.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Maze_Bumper_Collision();
+
+/**
+ * @brief This function replaces the maze map explored by Controller_2 with a map received from another robot.
+ *
+ * The distances are recomputed from the received walls, so the next call of Controller_2 drives the shortest
+ * known path from the current cell. The goals and the pose of the robot are kept.
+ *
+ * @param map Pointer to the MAZE_MAP_STORAGE_SIZE bytes of a map written by Maze_Map_Export.
+ *
+ * @return None
+ */
+void Maze_Exploration_Import(const uint8_t *map);
+
+#endif /* INC_CONTROLLER_H_ */
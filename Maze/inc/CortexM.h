@@ -45,6 +45,8 @@ those of the authors and should not be interpreted as representing official
 policies, either expressed or implied, of the FreeBSD Project.
 */
 
+#include <stdint.h>
+
 /*!
  * @defgroup MSP432
  * @brief
@@ -79,7 +81,7 @@ void EnableInterrupts(void);  // Enable interrupts
  *
  * @brief  Saves a copy of PRIMASK and disables interrupts
  */
-void StartCritical(void);
+long StartCritical(void);
 
 
 /**
@@ -104,3 +106,38 @@ void EndCritical(long sr);    // restore I bit to previous value
  * @brief  Enters low power sleep mode waiting for interrupt
  */
 void WaitForInterrupt(void);
+
+
+/**
+ * Enables the cycle counter of the Data Watchpoint and Trace (DWT) unit
+ *
+ * @param  none
+ * @return none
+ *
+ * @brief  Sets TRCENA in DEMCR and CYCCNTENA in DWT_CTRL. The counter increments at the MCLK rate.
+ */
+void CycleCounter_Init(void);
+
+
+/**
+ * Reads the cycle counter of the Data Watchpoint and Trace (DWT) unit
+ *
+ * @param  none
+ * @return current value of DWT_CYCCNT (wraps every 89 seconds at 48 MHz)
+ *
+ * @brief  Returns the number of MCLK cycles since CycleCounter_Init was called
+ */
+uint32_t CycleCounter_Read(void);
+
+
+/**
+ * Waits until a number of MCLK cycles have elapsed since a cycle counter value
+ *
+ * @param  start_cycles value returned by CycleCounter_Read at the start of the wait
+ * @param  cycles       number of MCLK cycles from start_cycles (less than 2^31)
+ * @return none
+ *
+ * @brief  Returns immediately if the time has already elapsed, so the code executed
+ *         since start_cycles is deducted from the wait
+ */
+void CycleCounter_Wait(uint32_t start_cycles, uint32_t cycles);
@@ -0,0 +1,152 @@
+/**
+ * @file DMA.h
+ * @brief Header file for the DMA driver.
+ *
+ * This file contains the function definitions for the DMA driver.
+ * It owns the channel control table of the MSP432 uDMA controller and provides
+ * helper functions that allow other drivers to configure channels, map trigger
+ * sources, and route channel completion interrupts to DMA_INT1, DMA_INT2, or DMA_INT3.
+ *
+ * The MSP432P401R uDMA controller has eight channels. Each channel owns a primary
+ * and an alternate control structure in the control table:
+ *  - Source End Pointer        (Address of the last source item)
+ *  - Destination End Pointer   (Address of the last destination item)
+ *  - Control Word              (Increment, size, arbitration, count and cycle type)
+ *  - Spare                     (Unused by the controller, used by scatter-gather task lists)
+ *
+ * Channel trigger sources used by this project:
+ *  - Channel 6, Source 1       eUSCI_A3 TX (Nokia5110 LCD)
+ *  - Channel 7, Source 7       ADC14 (Analog Distance Sensors)
+ *
+ */
+
+#ifndef INC_DMA_H_
+#define INC_DMA_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+// Number of channels supported by the uDMA controller of the MSP432P401R
+#define DMA_NUM_CHANNELS            8
+
+// Control word fields of a channel control structure
+#define DMA_CTL_DST_INC_BYTE        0x00000000
+#define DMA_CTL_DST_INC_HALF_WORD   0x40000000
+#define DMA_CTL_DST_INC_WORD        0x80000000
+#define DMA_CTL_DST_INC_NONE        0xC0000000
+#define DMA_CTL_DST_SIZE_BYTE       0x00000000
+#define DMA_CTL_DST_SIZE_HALF_WORD  0x10000000
+#define DMA_CTL_DST_SIZE_WORD       0x20000000
+#define DMA_CTL_SRC_INC_BYTE        0x00000000
+#define DMA_CTL_SRC_INC_HALF_WORD   0x04000000
+#define DMA_CTL_SRC_INC_WORD        0x08000000
+#define DMA_CTL_SRC_INC_NONE        0x0C000000
+#define DMA_CTL_SRC_SIZE_BYTE       0x00000000
+#define DMA_CTL_SRC_SIZE_HALF_WORD  0x01000000
+#define DMA_CTL_SRC_SIZE_WORD       0x02000000
+#define DMA_CTL_ARBITRATE_1         0x00000000
+#define DMA_CTL_ARBITRATE_2         0x00004000
+#define DMA_CTL_ARBITRATE_4         0x00008000
+#define DMA_CTL_ARBITRATE_8         0x0000C000
+#define DMA_CTL_TRANSFER_COUNT(n)   ((((uint32_t)(n) - 1) & 0x3FF) << 4)
+#define DMA_CTL_CYCLE_STOP          0x00000000
+#define DMA_CTL_CYCLE_BASIC         0x00000001
+#define DMA_CTL_CYCLE_AUTO          0x00000002
+#define DMA_CTL_CYCLE_PING_PONG     0x00000003
+#define DMA_CTL_CYCLE_MEM_SG_PRI    0x00000004
+#define DMA_CTL_CYCLE_MEM_SG_ALT    0x00000005
+#define DMA_CTL_CYCLE_PER_SG_PRI    0x00000006
+#define DMA_CTL_CYCLE_PER_SG_ALT    0x00000007
+#define DMA_CTL_CYCLE_MASK          0x00000007
+
+/**
+ * @brief Channel control structure used by the uDMA controller.
+ *
+ * The layout of this structure is fixed by the uDMA controller. Arrays of this
+ * structure can also be used as task lists for the scatter-gather cycle types.
+ */
+typedef struct
+{
+    volatile void *Source_End_Pointer;
+    volatile void *Destination_End_Pointer;
+    volatile uint32_t Control;
+    volatile uint32_t Spare;
+} DMA_Control_Structure;
+
+/**
+ * @brief Enable the uDMA controller and assign its channel control table.
+ *
+ * This function sets the MASTEN bit of the CFG register and loads the CTLBASE register
+ * with the address of the control table. It can be called by every driver that uses
+ * the uDMA controller; calls after the first one have no effect.
+ *
+ * @return None
+ */
+void DMA_Init(void);
+
+/**
+ * @brief Return the primary control structure of a uDMA channel.
+ *
+ * @param channel The uDMA channel number (0 to 7).
+ *
+ * @return Pointer to the primary control structure of the channel.
+ */
+DMA_Control_Structure *DMA_Get_Primary_Control(uint8_t channel);
+
+/**
+ * @brief Return the alternate control structure of a uDMA channel.
+ *
+ * @param channel The uDMA channel number (0 to 7).
+ *
+ * @return Pointer to the alternate control structure of the channel.
+ */
+DMA_Control_Structure *DMA_Get_Alternate_Control(uint8_t channel);
+
+/**
+ * @brief Configure the trigger source and the default attributes of a uDMA channel.
+ *
+ * This function disables the channel, selects its trigger source in the CH_SRCCFG register,
+ * selects the primary control structure, and clears the high priority, burst-only,
+ * and request mask attributes of the channel.
+ *
+ * @param channel The uDMA channel number (0 to 7).
+ * @param source  The trigger source of the channel (0 to 7). Refer to the device datasheet.
+ *
+ * @return None
+ */
+void DMA_Assign_Channel(uint8_t channel, uint8_t source);
+
+/**
+ * @brief Enable a uDMA channel after its control structures have been written.
+ *
+ * @param channel The uDMA channel number (0 to 7).
+ *
+ * @return None
+ */
+void DMA_Enable_Channel(uint8_t channel);
+
+/**
+ * @brief Disable a uDMA channel.
+ *
+ * @param channel The uDMA channel number (0 to 7).
+ *
+ * @return None
+ */
+void DMA_Disable_Channel(uint8_t channel);
+
+/**
+ * @brief Route the completion interrupt of a uDMA channel to DMA_INT1, DMA_INT2, or DMA_INT3.
+ *
+ * This function stores the user-defined task, assigns the channel to the selected interrupt
+ * using the INTx_SRCCFG register, and enables the corresponding interrupt in the NVIC.
+ * The task is executed every time the channel completes its DMA cycle.
+ *
+ * @param interrupt The DMA interrupt to use (1, 2, or 3).
+ * @param channel   The uDMA channel number (0 to 7).
+ * @param task      A pointer to the user-defined function that will be called on completion, or 0 for none.
+ *
+ * @return None
+ */
+void DMA_Assign_Interrupt(uint8_t interrupt, uint8_t channel, void(*task)(void));
+
+#endif /* INC_DMA_H_ */
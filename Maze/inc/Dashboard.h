@@ -0,0 +1,90 @@
+/**
+ * @file Dashboard.h
+ * @brief Header file for the Dashboard module.
+ *
+ * This file contains the function definitions for the Dashboard module.
+ * It draws fixed-width unsigned decimal fields, such as the route timer, in the RAM buffer of the
+ * Nokia5110 LCD driver, so that the user interface can set them at every update for almost no cost:
+ *  - A field that is set to the value it already shows returns at once.
+ *  - The digits are converted with a multiplication by the reciprocal of 10 instead of a divide.
+ *  - The glyphs of the digits are copied from the font once by Dashboard_Init, and only the digits that
+ *    have changed are written to the RAM buffer, so the next flush only sends their columns.
+ *
+ * A value that does not fit in the width of its field is shown as '*' characters.
+ *
+ * @note A field must be invalidated with Dashboard_Field_Invalidate when its characters have been overwritten
+ *       by another function, for example by Nokia5110_ClearBuffer or Nokia5110_Buffer_OutString.
+ *
+ */
+
+#ifndef INC_DASHBOARD_H_
+#define INC_DASHBOARD_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "Nokia5110_LCD.h"
+
+// Largest width of a field in characters (a 32-bit value has 10 digits)
+#define DASHBOARD_MAX_DIGITS        10
+
+// Flags of a field
+#define DASHBOARD_FIELD_ZERO_PAD    0x01
+
+/**
+ * @brief Position, width, and drawn characters of a numeric field.
+ */
+typedef struct
+{
+    uint8_t X;
+    uint8_t Y;
+    uint8_t Width;
+    uint8_t Flags;
+    uint8_t Valid;
+    uint32_t Value;
+    uint8_t Drawn[DASHBOARD_MAX_DIGITS];
+} Dashboard_Field;
+
+/**
+ * @brief Copy the glyphs of the digits, the space, and the '*' character from the font of the Nokia5110 driver.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Dashboard_Init(void);
+
+/**
+ * @brief Place a field on the screen. Its characters are written by the first call of Dashboard_Field_Set.
+ *
+ * @param field Pointer to the field.
+ * @param x     X-position of the first character (0 to 11).
+ * @param y     Y-position of the field (0 to 5).
+ * @param width Number of characters (1 to DASHBOARD_MAX_DIGITS, and x + width at most 12).
+ * @param flags DASHBOARD_FIELD_ZERO_PAD to show the leading zeros, or 0 for right-justified digits.
+ *
+ * @return None
+ */
+void Dashboard_Field_Init(Dashboard_Field *field, uint8_t x, uint8_t y, uint8_t width, uint8_t flags);
+
+/**
+ * @brief Show a value in a field, writing only the characters that have changed to the RAM buffer.
+ *
+ * The value appears on the screen after the next call to Nokia5110_DisplayBuffer or Nokia5110_DisplayBuffer_DMA.
+ *
+ * @param field Pointer to the field.
+ * @param value The unsigned value to be shown.
+ *
+ * @return None
+ */
+void Dashboard_Field_Set(Dashboard_Field *field, uint32_t value);
+
+/**
+ * @brief Write every character of a field at the next call of Dashboard_Field_Set.
+ *
+ * @param field Pointer to the field.
+ *
+ * @return None
+ */
+void Dashboard_Field_Invalidate(Dashboard_Field *field);
+
+#endif /* INC_DASHBOARD_H_ */
@@ -0,0 +1,116 @@
+/**
+ * @file Distance_Fusion.h
+ * @brief Header file for the Distance_Fusion driver.
+ *
+ * This file contains the function definitions for the Distance_Fusion driver.
+ * It combines the Sharp GP2Y0A21YK0F Analog Distance Sensors, the OPT3101 time-of-flight sensor,
+ * and the odometry into one distance estimate per side with a confidence value, using a
+ * one-dimensional Kalman filter per side in fixed-point arithmetic.
+ *
+ * The two sensors fail differently:
+ *  - The Sharp sensors report ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE when they saturate (under about 100 mm)
+ *    or when nothing is in range, and their noise grows with the distance.
+ *  - The OPT3101 is accurate with a strong reflection but drops out at low amplitude.
+ *
+ * Filter:
+ *  - Predict: The center distance decreases by the distance driven along the heading since the last update.
+ *    The variance of every side grows by DISTANCE_FUSION_PROCESS_VARIANCE, plus terms proportional to the
+ *    distance driven and the heading change, since the side walls are not always parallel to the robot.
+ *  - Update: Each valid measurement is weighted by its variance. The Sharp variance is
+ *    (DISTANCE_FUSION_SHARP_SIGMA + d / DISTANCE_FUSION_SHARP_SIGMA_DIVIDER)^2, and the OPT3101 variance is
+ *    DISTANCE_FUSION_OPT3101_VARIANCE scaled by DISTANCE_FUSION_OPT3101_AMPLITUDE / amplitude.
+ *  - When no sensor is valid, the estimate follows the odometry and its confidence decreases.
+ *
+ * Fixed-point formats:
+ *  - Distances are stored in 1/16 mm, and variances in mm^2 limited to DISTANCE_FUSION_MAX_VARIANCE,
+ *    so the Kalman gain (Q16) is computed with 32-bit arithmetic only.
+ *  - The confidence is 256 * DISTANCE_FUSION_CONFIDENCE_VARIANCE / (DISTANCE_FUSION_CONFIDENCE_VARIANCE + variance),
+ *    limited to 255. A confidence of 128 means a standard deviation of about 20 mm.
+ *
+ */
+
+#ifndef INC_DISTANCE_FUSION_H_
+#define INC_DISTANCE_FUSION_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "Analog_Distance_Sensors.h"
+#include "OPT3101.h"
+#include "Odometry.h"
+
+// Largest distance of an estimate in mm
+#define DISTANCE_FUSION_MAX_DISTANCE            ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE
+
+// Variance limit in mm^2, also the variance of an estimate without any measurement
+#define DISTANCE_FUSION_MAX_VARIANCE            65535
+
+// Variance added at every update, per mm driven, and per degree of heading change (mm^2)
+#define DISTANCE_FUSION_PROCESS_VARIANCE        4
+#define DISTANCE_FUSION_DISTANCE_VARIANCE       1
+#define DISTANCE_FUSION_HEADING_VARIANCE        50
+
+// Standard deviation of a Sharp measurement: DISTANCE_FUSION_SHARP_SIGMA + d / DISTANCE_FUSION_SHARP_SIGMA_DIVIDER (mm)
+#define DISTANCE_FUSION_SHARP_SIGMA             5
+#define DISTANCE_FUSION_SHARP_SIGMA_DIVIDER     25
+
+// Variance of an OPT3101 measurement with an amplitude of DISTANCE_FUSION_OPT3101_AMPLITUDE (mm^2)
+#define DISTANCE_FUSION_OPT3101_VARIANCE        100
+#define DISTANCE_FUSION_OPT3101_AMPLITUDE       1000
+
+// Variance of an estimate with a confidence of 128 (mm^2)
+#define DISTANCE_FUSION_CONFIDENCE_VARIANCE     400
+
+/**
+ * @brief Sides of the robot. The values are also the OPT3101 channels.
+ */
+typedef enum
+{
+    DISTANCE_FUSION_LEFT = 0,
+    DISTANCE_FUSION_CENTER = 1,
+    DISTANCE_FUSION_RIGHT = 2,
+    DISTANCE_FUSION_NUM_SIDES = 3
+} Distance_Fusion_Side;
+
+/**
+ * @brief Fused distance of a side.
+ */
+typedef struct
+{
+    int32_t Distance_mm;
+    uint8_t Confidence;
+} Distance_Fusion_Estimate;
+
+/**
+ * @brief Reset every estimate to DISTANCE_FUSION_MAX_DISTANCE with a confidence of 0.
+ *
+ * The current pose of the Odometry driver is used as the reference of the next prediction.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Distance_Fusion_Init();
+
+/**
+ * @brief Predict the estimates from the odometry and update them with the new measurements.
+ *
+ * This function must be called once per control tick after Odometry_Update. The OPT3101 samples are
+ * read from the background acquisition, and only the samples received since the last call are used.
+ *
+ * @param sharp The converted Sharp distances in mm, in the order left, center, right.
+ *
+ * @return None
+ */
+void Distance_Fusion_Update(const int32_t sharp[DISTANCE_FUSION_NUM_SIDES]);
+
+/**
+ * @brief Return the fused estimate of a side.
+ *
+ * @param side     The side of the robot.
+ * @param estimate Pointer to store the estimate.
+ *
+ * @return None
+ */
+void Distance_Fusion_Get(Distance_Fusion_Side side, Distance_Fusion_Estimate *estimate);
+
+#endif /* INC_DISTANCE_FUSION_H_ */
@@ -0,0 +1,122 @@
+/**
+ * @file Distance_Source.h
+ * @brief Header file for the Distance_Source driver.
+ *
+ * This file contains the function definitions for the Distance_Source driver.
+ * It provides the left, center, and right distances used by the controllers from one of two sources,
+ * so the controllers do not depend on the sensor that is mounted on the robot:
+ *  - DISTANCE_SOURCE_SHARP: The Sharp GP2Y0A21YK0F Analog Distance Sensors. The converted values are
+ *    stored by Distance_Source_Update_Sharp after every filtered sample.
+ *  - DISTANCE_SOURCE_OPT3101: The OPT3101 time-of-flight sensor, measured in the background by the
+ *    OPT3101 acquisition (channel 0 = left, 1 = center, 2 = right).
+ *  - DISTANCE_SOURCE_FUSION: Both sensors and the odometry, combined by the Distance_Fusion driver.
+ *    The confidence of every distance is available from Distance_Source_Get_Confidence.
+ *
+ * Invalid OPT3101 measurements:
+ *  - OPT3101_DISTANCE_LOW_AMPLITUDE: Nothing reflects the light, which is reported as DISTANCE_SOURCE_NO_TARGET.
+ *  - OPT3101_DISTANCE_ERROR and OPT3101_DISTANCE_UNDERFLOW: The last valid distance of the channel is kept.
+ *
+ */
+
+#ifndef INC_DISTANCE_SOURCE_H_
+#define INC_DISTANCE_SOURCE_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Analog_Distance_Sensors.h"
+#include "OPT3101.h"
+#include "Distance_Fusion.h"
+#include "Snapshot.h"
+
+// Distance in mm reported when no object is detected
+#define DISTANCE_SOURCE_NO_TARGET       ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE
+
+// OPT3101 channels of the three directions
+#define DISTANCE_SOURCE_OPT3101_LEFT    0
+#define DISTANCE_SOURCE_OPT3101_CENTER  1
+#define DISTANCE_SOURCE_OPT3101_RIGHT   2
+
+/**
+ * @brief Sources of the distance values.
+ */
+typedef enum
+{
+    DISTANCE_SOURCE_SHARP,
+    DISTANCE_SOURCE_OPT3101,
+    DISTANCE_SOURCE_FUSION
+} Distance_Source_Type;
+
+/**
+ * @brief Select the distance source. Every distance is set to DISTANCE_SOURCE_NO_TARGET.
+ *
+ * @param type The source used by Distance_Source_Get.
+ *
+ * @note For DISTANCE_SOURCE_OPT3101 and DISTANCE_SOURCE_FUSION, OPT3101_Acquisition_Init must also be called.
+ *
+ * @return None
+ */
+void Distance_Source_Init(Distance_Source_Type type);
+
+/**
+ * @brief Return the selected distance source.
+ *
+ * @param None
+ *
+ * @return The source used by Distance_Source_Get.
+ */
+Distance_Source_Type Distance_Source_Get_Type();
+
+/**
+ * @brief Store the converted values of the Analog Distance Sensors.
+ *
+ * The values are published with the time of the conversion in a Snapshot read by Distance_Source_Get.
+ * This function must only be called from one interrupt handler with a higher priority than the SysTick
+ * interrupt (the writer of the snapshot). The values are ignored when the OPT3101 alone is the selected source.
+ *
+ * @param converted The distances in mm, in the channel order of the sensors (right, center, left).
+ *
+ * @return None
+ */
+void Distance_Source_Update_Sharp(const int32_t converted[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS]);
+
+/**
+ * @brief Return the latest distances of the selected source.
+ *
+ * For DISTANCE_SOURCE_FUSION, this function also updates the fused estimates, so it must be called
+ * once per control tick after Odometry_Update.
+ *
+ * @param left   Pointer to store the left distance in mm.
+ * @param center Pointer to store the center distance in mm.
+ * @param right  Pointer to store the right distance in mm.
+ *
+ * @return None
+ */
+void Distance_Source_Get(int32_t *left, int32_t *center, int32_t *right);
+
+/**
+ * @brief Return the confidence of the distances returned by the last call of Distance_Source_Get.
+ *
+ * For DISTANCE_SOURCE_FUSION, the confidence is the one of the Distance_Fusion estimates. For the other sources,
+ * it is 255 for a detected object and 0 for DISTANCE_SOURCE_NO_TARGET.
+ *
+ * @param left   Pointer to store the confidence of the left distance (0 to 255).
+ * @param center Pointer to store the confidence of the center distance (0 to 255).
+ * @param right  Pointer to store the confidence of the right distance (0 to 255).
+ *
+ * @return None
+ */
+void Distance_Source_Get_Confidence(uint8_t *left, uint8_t *center, uint8_t *right);
+
+/**
+ * @brief Return the time of the Sharp distances used by the latest call of Distance_Source_Get.
+ *
+ * The age of the distances is CycleCounter_Read() - timestamp_cycles (MCLK cycles, see Clock_GetFreq).
+ *
+ * @param timestamp_cycles Pointer to store the cycle count at which the filter interrupt converted them.
+ *
+ * @return The number of sets converted since Distance_Source_Init (0 if the distances are the initial values).
+ */
+uint32_t Distance_Source_Get_Sharp_Timestamp(uint32_t *timestamp_cycles);
+
+#endif /* INC_DISTANCE_SOURCE_H_ */
@@ -4,6 +4,13 @@
  *
  * This file contains the function definitions for the EUSCI_A0_UART driver.
  *
+ * Transmitted bytes are stored in a ring buffer that is drained by the EUSCI_A0 TX interrupt,
+ * so printf and the EUSCI_A0_UART_Out functions return as soon as the bytes have been queued.
+ * Received bytes are polled, or stored in a second ring buffer by the EUSCI_A0 RX interrupt
+ * once EUSCI_A0_UART_Enable_RX_Interrupt has been called.
+ * When the ring buffer is full, the overflow policy selects whether new bytes are dropped (and counted)
+ * or whether the caller waits for room.
+ *
  * For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
  * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
  *
@@ -20,6 +27,12 @@
 #include <stdio.h>
 #include "msp.h"
 #include "file.h"
+#include "CortexM.h"
+#include "Memory_Config.h"
+
+// Overflow policies of the TX ring buffer
+#define EUSCI_A0_UART_OVERFLOW_DROP         0
+#define EUSCI_A0_UART_OVERFLOW_BLOCK        1
 
 /**
  * @brief Carriage return character
@@ -59,6 +72,8 @@
  * - Mode: UART
  * - UART Clock Source: SMCLK
  * - Baud Rate: 115200
+ * - TX: Interrupt-driven using the TX ring buffer (EUSCI_A0 has an IRQ number of 16)
+ * - RX: Polled, or interrupt-driven using the RX ring buffer (see EUSCI_A0_UART_Enable_RX_Interrupt)
  *
  * For more information regarding the registers used, refer to the eUSCI_A UART Registers section (24.4)
  * of the MSP432Pxx Microcontrollers Technical Reference Manual
@@ -74,6 +89,7 @@ void EUSCI_A0_UART_Init();
  *
  * This function waits until a character is available in the UART receive buffer (EUSCI_A0)
  * from the serial terminal input and returns the received character as a char type.
+ * When the RX interrupt is enabled, it waits for the RX ring buffer instead.
  *
  * @param None
  *
@@ -84,8 +100,9 @@ char EUSCI_A0_UART_InChar();
 /**
  * @brief The EUSCI_A0_UART_OutChar function transmits a character via UART to the serial terminal.
  *
- * This function waits until the UART transmit buffer (EUSCI_A0) is ready to accept
- * a new character and then writes the specified character in the transmit buffer to the serial terminal.
+ * This function queues the specified character in the TX ring buffer. The EUSCI_A0 TX interrupt
+ * writes it to the transmit buffer when the previous characters have been sent.
+ * The overflow policy is applied if the ring buffer is full.
  *
  * @param letter The character to be transmitted to the serial terminal.
  *
@@ -240,7 +257,7 @@ int EUSCI_A0_UART_Read(int dev_fd, char *buf, unsigned count);
  * @brief The EUSCI_A0_UART_Write function writes data to the UART transmit buffer.
  *
  * This function writes data from the provided buffer (buf) to the UART transmit buffer (EUSCI_A0) for transmission.
- * It transmits each character one by one and handles newline character ('\n') by sending a carriage return ('\r') first.
+ * It queues each character in the TX ring buffer and handles newline character ('\n') by sending a carriage return ('\r') first.
  *
  * @param dev_fd Device file descriptor.
  * @param buf Pointer to the buffer containing the data to be transmitted.
@@ -298,4 +315,84 @@ int EUSCI_A0_UART_Rename(const char *old_name, const char *new_name);
  */
 void EUSCI_A0_UART_Init_Printf();
 
+/**
+ * @brief Queue a byte in the TX ring buffer.
+ *
+ * The byte is transmitted by the EUSCI_A0 TX interrupt. If the ring buffer is full, the byte is either dropped
+ * and counted (EUSCI_A0_UART_OVERFLOW_DROP) or the oldest queued byte is transmitted by polling to make room
+ * (EUSCI_A0_UART_OVERFLOW_BLOCK). The blocking policy also works when interrupts are disabled.
+ *
+ * This function can be called from the main loop and from interrupt service routines.
+ *
+ * @param data The byte to transmit.
+ *
+ * @return 0 if the byte has been queued, or -1 if it has been dropped.
+ */
+int EUSCI_A0_UART_Queue_Byte(uint8_t data);
+
+/**
+ * @brief Queue a block of raw bytes in the TX ring buffer without newline conversion.
+ *
+ * @param data   Pointer to the bytes to transmit.
+ * @param length The number of bytes to transmit.
+ *
+ * @return The number of bytes that have been queued.
+ */
+uint32_t EUSCI_A0_UART_Queue_Bytes(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Select the overflow policy of the TX ring buffer.
+ *
+ * @param policy EUSCI_A0_UART_OVERFLOW_DROP (default) or EUSCI_A0_UART_OVERFLOW_BLOCK.
+ *
+ * @return None
+ */
+void EUSCI_A0_UART_Set_Overflow_Policy(uint8_t policy);
+
+/**
+ * @brief Return the number of bytes dropped because the TX ring buffer was full.
+ *
+ * @return Number of dropped bytes since EUSCI_A0_UART_Init was called.
+ */
+uint32_t EUSCI_A0_UART_Get_Dropped_Bytes();
+
+/**
+ * @brief Return the number of free bytes in the TX ring buffer.
+ *
+ * @return Number of bytes that can be queued without overflowing.
+ */
+uint32_t EUSCI_A0_UART_TX_Free();
+
+/**
+ * @brief Wait until every queued byte has been written to the transmit buffer.
+ *
+ * @return None
+ */
+void EUSCI_A0_UART_Flush();
+
+/**
+ * @brief Store the received bytes in the RX ring buffer from the EUSCI_A0 interrupt.
+ *
+ * The RX ring buffer is emptied, and the bytes are then read with EUSCI_A0_UART_Read_Byte without blocking.
+ *
+ * @return None
+ */
+void EUSCI_A0_UART_Enable_RX_Interrupt();
+
+/**
+ * @brief Read the oldest byte of the RX ring buffer without waiting.
+ *
+ * @param data Pointer to store the byte.
+ *
+ * @return 1 if a byte has been read, or 0 if the RX ring buffer is empty.
+ */
+int EUSCI_A0_UART_Read_Byte(uint8_t *data);
+
+/**
+ * @brief Return the number of bytes lost because the RX ring buffer was full.
+ *
+ * @return Number of lost bytes since EUSCI_A0_UART_Enable_RX_Interrupt was called.
+ */
+uint32_t EUSCI_A0_UART_Get_RX_Overruns();
+
 #endif /* EUSCI_A0_UART_H_ */
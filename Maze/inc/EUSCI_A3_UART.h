@@ -7,6 +7,10 @@
  * @note Assumes that the necessary pin configurations for UART communication have been performed
  *       on the corresponding pins. P9.6 is used for UART RX while P9.7 is used for UART TX.
  *
+ * @note The EUSCI_A3_UART_Queue_Byte and EUSCI_A3_UART_Read_Byte functions use TX and RX ring buffers served
+ *       by the EUSCI_A3 interrupt (for the Robot_Link module). The same EUSCI_A3 module drives the Nokia5110 LCD
+ *       in SPI mode, so the LCD cannot be used while the UART is initialized.
+ *
  * @note For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
  * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
  *
@@ -20,6 +24,8 @@
 #include <stdint.h>
 #include "msp.h"
 #include "../inc/GPIO.h"
+#include "CortexM.h"
+#include "Memory_Config.h"
 
 #define BUFFER_LENGTH 256
 
@@ -127,4 +133,60 @@ void EUSCI_A3_UART_Ramp_Data(uint8_t TX_Buffer[], uint8_t RX_Buffer[]);
  */
 void EUSCI_A3_UART_Validate_Data(uint8_t TX_Buffer[], uint8_t RX_Buffer[]);
 
+/**
+ * @brief Queue a byte in the TX ring buffer.
+ *
+ * The byte is transmitted by the EUSCI_A3 TX interrupt. If the ring buffer is full, the byte is dropped.
+ * This function can be called from the main loop and from interrupt service routines.
+ *
+ * @note EUSCI_A3_UART_OutChar writes the Transmit Buffer directly, so it should not be used while bytes are queued.
+ *
+ * @param data The byte to transmit.
+ *
+ * @return 0 if the byte has been queued, or -1 if it has been dropped.
+ */
+int EUSCI_A3_UART_Queue_Byte(uint8_t data);
+
+/**
+ * @brief Queue a block of bytes in the TX ring buffer.
+ *
+ * @param data   Pointer to the bytes to transmit.
+ * @param length The number of bytes to transmit.
+ *
+ * @return The number of bytes that have been queued.
+ */
+uint32_t EUSCI_A3_UART_Queue_Bytes(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Return the number of free bytes in the TX ring buffer.
+ *
+ * @return Number of bytes that can be queued without overflowing.
+ */
+uint32_t EUSCI_A3_UART_TX_Free();
+
+/**
+ * @brief Store the received bytes in the RX ring buffer from the EUSCI_A3 interrupt.
+ *
+ * The RX ring buffer is emptied, and the bytes are then read with EUSCI_A3_UART_Read_Byte without blocking.
+ *
+ * @return None
+ */
+void EUSCI_A3_UART_Enable_RX_Interrupt();
+
+/**
+ * @brief Read the oldest byte of the RX ring buffer without waiting.
+ *
+ * @param data Pointer to store the byte.
+ *
+ * @return 1 if a byte has been read, or 0 if the RX ring buffer is empty.
+ */
+int EUSCI_A3_UART_Read_Byte(uint8_t *data);
+
+/**
+ * @brief Return the number of bytes lost because the RX ring buffer was full.
+ *
+ * @return Number of lost bytes since EUSCI_A3_UART_Enable_RX_Interrupt was called.
+ */
+uint32_t EUSCI_A3_UART_Get_RX_Overruns();
+
 #endif /* INC_EUSCI_A3_UART_H_ */
@@ -3,7 +3,25 @@
  * @brief Header file for the EUSCI_B1_I2C driver.
  *
  * This file contains the function definitions for the EUSCI_B1_I2C driver.
- * The EUSCI_B1_I2C driver uses busy-wait implementation.
+ * The EUSCI_B1_I2C driver provides a busy-wait implementation and an interrupt-driven
+ * transaction queue. Queued transactions are write-then-read descriptors that are executed
+ * by the EUSCI_B1 interrupt service routine, so several devices (PMOD Color, OPT3001, OPT3101)
+ * can share the bus while the CPU does other work.
+ *
+ * The driver also manages the shared bus:
+ *  - Clock: each device is clocked at its own SCL frequency (EUSCI_B1_I2C_Set_Device_Clock), which is
+ *    selected before every transfer to it. The devices without an entry use EUSCI_B1_I2C_DEFAULT_SCL_HZ.
+ *  - Arbitration: a queued transaction has a priority. The next transaction is taken from the
+ *    EUSCI_B1_I2C_PRIORITY_HIGH queue first, so a read for the control loop only waits for the
+ *    transfer on the bus, not for the reads of the other sensors queued before it.
+ *  - Stuck-bus recovery: a slave that holds SCL low is detected by the clock low timeout, and a transaction
+ *    that does not complete within EUSCI_B1_I2C_TRANSACTION_TIMEOUT_US is aborted by EUSCI_B1_I2C_Watchdog_Task.
+ *    The bus is then released by clocking SCL until the slave releases SDA, followed by a STOP condition.
+ *    The same recovery is done by EUSCI_B1_I2C_Init, for a slave left in the middle of a read by a reset.
+ *    A blocking transfer waits for its STOP condition for at most EUSCI_B1_I2C_STOP_TIMEOUT_US, after which the
+ *    bus is recovered the same way. A queued transaction never waits for it: it stays in the queue until the
+ *    UCSTPIFG interrupt starts it, or until EUSCI_B1_I2C_Watchdog_Task recovers the bus.
+ *  - Statistics: the transfers, NACKs, timeouts, queue wait, and transfer time are counted per device.
  *
  * @note This function assumes that the necessary pin configurations for I2C communication have been performed
  *       on the corresponding pins. The output from the pins will be observed using an oscilloscope.
@@ -22,6 +40,91 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "CortexM.h"
+#include "Memory_Config.h"
+
+// Status values of a queued transaction
+#define EUSCI_B1_I2C_STATUS_IDLE            0
+#define EUSCI_B1_I2C_STATUS_PENDING         1
+#define EUSCI_B1_I2C_STATUS_ACTIVE          2
+#define EUSCI_B1_I2C_STATUS_DONE            3
+#define EUSCI_B1_I2C_STATUS_NACK            4
+#define EUSCI_B1_I2C_STATUS_TIMEOUT         5
+
+// Priorities of a queued transaction
+// Note: The descriptors are usually static, so a descriptor that does not set its priority is a normal one
+#define EUSCI_B1_I2C_PRIORITY_NORMAL        0
+#define EUSCI_B1_I2C_PRIORITY_HIGH          1
+#define EUSCI_B1_I2C_NUM_PRIORITIES         2
+
+// Frequency of the eUSCI clock source (SMCLK) in Hz
+#define EUSCI_B1_I2C_CLOCK_HZ               12000000
+
+// SCL frequency of the devices without an entry in the device table in Hz
+#ifndef EUSCI_B1_I2C_DEFAULT_SCL_HZ
+#define EUSCI_B1_I2C_DEFAULT_SCL_HZ         400000
+#endif
+
+// Highest SCL frequency of the eUSCI_B module (Fast-mode Plus) in Hz
+#define EUSCI_B1_I2C_MAX_SCL_HZ             1000000
+
+// Longest time from the START condition of a queued transaction to its STOP condition in us
+// Note: The longest transaction of the sensors (the 10 bytes of the PMOD Color read) takes about 250 us at 400 kHz
+#ifndef EUSCI_B1_I2C_TRANSACTION_TIMEOUT_US
+#define EUSCI_B1_I2C_TRANSACTION_TIMEOUT_US 5000
+#endif
+
+// Longest wait of a blocking transfer in us for the module to generate a STOP condition (clear UCTXSTP)
+// Note: A STOP condition takes one byte time at most (about 90 us at 100 kHz) unless a slave stretches SCL
+#ifndef EUSCI_B1_I2C_STOP_TIMEOUT_US
+#define EUSCI_B1_I2C_STOP_TIMEOUT_US        1000
+#endif
+
+#if (EUSCI_B1_I2C_DEFAULT_SCL_HZ <= 0) || (EUSCI_B1_I2C_DEFAULT_SCL_HZ > EUSCI_B1_I2C_MAX_SCL_HZ)
+#error "EUSCI_B1_I2C_DEFAULT_SCL_HZ must be between 1 Hz and 1 MHz"
+#endif
+
+/**
+ * @brief Descriptor of a queued I2C transaction.
+ *
+ * A transaction writes TX_Length bytes to the slave device and then reads RX_Length bytes
+ * using a repeated START condition. Either length can be zero. The descriptor and its buffers
+ * must remain valid until the transaction has completed.
+ *
+ * Priority is set by the owner of the descriptor, the fields after Context are used by the driver.
+ */
+typedef struct EUSCI_B1_I2C_Transaction
+{
+    uint8_t Slave_Address;
+    const uint8_t *TX_Buffer;
+    uint16_t TX_Length;
+    uint8_t *RX_Buffer;
+    uint16_t RX_Length;
+    volatile uint8_t Status;
+    void (*Callback)(struct EUSCI_B1_I2C_Transaction *transaction);
+    void *Context;
+    uint8_t Priority;
+    int8_t Device;
+    uint32_t Submit_Cycles;
+} EUSCI_B1_I2C_Transaction;
+
+/**
+ * @brief Transfer statistics of a device on the bus.
+ *
+ * The times are in MCLK cycles (see CycleCounter_Read). Wait is the time in the queue before the START condition,
+ * and transfer is the time from the START condition to the STOP condition. Only queued transactions are timed.
+ */
+typedef struct
+{
+    uint8_t Slave_Address;
+    uint32_t SCL_Frequency_Hz;
+    uint32_t Transfers;
+    uint32_t Bytes;
+    uint32_t NACKs;
+    uint32_t Timeouts;
+    uint32_t Max_Wait_Cycles;
+    uint32_t Max_Transfer_Cycles;
+} EUSCI_B1_I2C_Device_Stats;
 
 /**
  * @brief Initializes the I2C module EUSCI_B1 for communication.
@@ -54,14 +157,17 @@
  *   -----       -----       -----       -----------
  *    15-9       Reserved     0x0        Reserved
  *    8          UCETXINT     0x0        Early UCTXIFG0 flag in slave mode
- *    7-6        UCCLTO       0x0        Disable clock low timeout
+ *    7-6        UCCLTO       0x1        Clock low timeout of about 28 ms
  *    5          UCSTPNACK    0x0        Send NACK before STOP condition in master receiver mode
  *    4          UCSWACK      0x0        Address acknowledge of slave is controlled by eUSCI module
  *    3-2        UCASTPx      0x0        No automatic STOP generation in slave mode when UCBCNTIFG is available
  *    1-0        UCGLITx      0x0        Deglitch time of 50 ns
  *
- * For setting the SCL frequency, the clock source used is 12 MHz.
- * To achieve a 400 kHz SCL frequency, the BRW value is set to 30.
+ * For setting the SCL frequency, the clock source used is 12 MHz. The BRW value is set to
+ * 30 (400 kHz, EUSCI_B1_I2C_DEFAULT_SCL_HZ), and changed before a transfer to a device with another frequency.
+ *
+ * Before the module is enabled, the bus is recovered if a slave holds SDA low.
+ * The device table is kept, so the device clocks can be set before or after this function.
  *
  * For more information regarding the registers used, refer to the EUSCI_B I2C Registers section
  * of the MSP432Pxx Microcontrollers Technical Reference Manual.
@@ -143,4 +249,117 @@ uint8_t EUSCI_B1_I2C_Receive_A_Byte(uint8_t slave_address);
  */
 void EUSCI_B1_I2C_Receive_Multiple_Bytes(uint8_t slave_address, uint8_t *data_buffer, uint16_t packet_length);
 
+/**
+ * @brief Queue a write-then-read transaction for the EUSCI_B1 interrupt service routine.
+ *
+ * This function appends a transaction to the queue and starts it immediately if the bus is idle.
+ * The transaction is executed entirely by the EUSCI_B1 interrupt: the TX_Buffer bytes are sent first,
+ * followed by a repeated START condition and the reception of RX_Length bytes into RX_Buffer.
+ * When the STOP condition has been generated, the Status field is set to EUSCI_B1_I2C_STATUS_DONE
+ * (or EUSCI_B1_I2C_STATUS_NACK if the slave did not acknowledge) and the optional callback is executed
+ * from the interrupt context.
+ *
+ * Transactions can be submitted from the main loop or from interrupt service routines. A transaction
+ * with the EUSCI_B1_I2C_PRIORITY_HIGH priority is started before the normal ones already queued, but it does not
+ * interrupt the transaction on the bus. A transaction that is not complete within EUSCI_B1_I2C_TRANSACTION_TIMEOUT_US
+ * ends with the EUSCI_B1_I2C_STATUS_TIMEOUT status.
+ *
+ * @param transaction Pointer to the transaction descriptor. The Status field is updated by the driver.
+ *
+ * @note The blocking functions of this driver wait until the queue is empty before accessing the bus,
+ *       so they must not be called from an interrupt with a higher priority than EUSCI_B1 (see Interrupt_Priority.h).
+ *
+ * @return 0 if the transaction has been queued, or -1 if the queue of its priority is full.
+ */
+int EUSCI_B1_I2C_Submit(EUSCI_B1_I2C_Transaction *transaction);
+
+/**
+ * @brief Fill in a transaction descriptor and queue it.
+ *
+ * @param transaction   Pointer to the transaction descriptor.
+ * @param slave_address The 7-bit address of the I2C slave device.
+ * @param tx_buffer     Bytes to send to the slave device (can be 0 if tx_length is 0).
+ * @param tx_length     The number of bytes to send.
+ * @param rx_buffer     Buffer for the received bytes (can be 0 if rx_length is 0).
+ * @param rx_length     The number of bytes to receive after the repeated START condition.
+ * @param callback      Function executed when the transaction has completed, or 0 for none.
+ *
+ * @note The Priority field of the descriptor is not changed.
+ *
+ * @return 0 if the transaction has been queued, or -1 if the queue of its priority is full.
+ */
+int EUSCI_B1_I2C_Write_Read_Async(EUSCI_B1_I2C_Transaction *transaction, uint8_t slave_address,
+                                  const uint8_t *tx_buffer, uint16_t tx_length,
+                                  uint8_t *rx_buffer, uint16_t rx_length,
+                                  void (*callback)(EUSCI_B1_I2C_Transaction *transaction));
+
+/**
+ * @brief Set the SCL frequency of a device.
+ *
+ * The frequency is used for the blocking and the queued transfers to the device from the next START condition.
+ * The BRW divider is rounded up, so the SCL frequency is never above the requested one.
+ *
+ * @param slave_address    The 7-bit address of the I2C slave device.
+ * @param scl_frequency_hz The highest SCL frequency supported by the device (and the pull-up resistors of the bus).
+ *
+ * @return 0 if the frequency has been set, or -1 if it is above EUSCI_B1_I2C_MAX_SCL_HZ or the device table is full.
+ */
+int EUSCI_B1_I2C_Set_Device_Clock(uint8_t slave_address, uint32_t scl_frequency_hz);
+
+/**
+ * @brief Get the number of devices in the device table.
+ *
+ * A device is added by EUSCI_B1_I2C_Set_Device_Clock, or by the first transfer to it.
+ *
+ * @return The number of devices.
+ */
+uint8_t EUSCI_B1_I2C_Get_Device_Count(void);
+
+/**
+ * @brief Get the transfer statistics of a device.
+ *
+ * @param index The index of the device in the table, from 0 to EUSCI_B1_I2C_Get_Device_Count() - 1.
+ * @param stats Pointer to store the statistics.
+ *
+ * @return 0 if the statistics have been stored, or -1 if the index is not valid.
+ */
+int EUSCI_B1_I2C_Get_Device_Stats(uint8_t index, EUSCI_B1_I2C_Device_Stats *stats);
+
+/**
+ * @brief Get the number of stuck-bus recoveries since reset.
+ *
+ * @return The number of recoveries, including the ones of EUSCI_B1_I2C_Init that found SDA held low.
+ */
+uint32_t EUSCI_B1_I2C_Get_Recovery_Count(void);
+
+/**
+ * @brief Abort the current queued transaction if it has not completed within EUSCI_B1_I2C_TRANSACTION_TIMEOUT_US.
+ *
+ * A queued transaction that has waited as long for the STOP condition of a blocking transfer is started
+ * after the same bus recovery.
+ *
+ * The abort is handed to the EUSCI_B1 interrupt, which recovers the bus, sets the Status field of the transaction
+ * to EUSCI_B1_I2C_STATUS_TIMEOUT, executes its callback, and starts the next transaction.
+ * This catches a slave that holds SDA low, which the clock low timeout does not detect.
+ *
+ * @note This function must be called periodically, for example every 10 ms by the scheduler.
+ *
+ * @return None
+ */
+void EUSCI_B1_I2C_Watchdog_Task(void);
+
+/**
+ * @brief Check if a queued transaction is being executed or waiting in the queue.
+ *
+ * @return 1 if the transaction engine is busy, or 0 if it is idle.
+ */
+uint8_t EUSCI_B1_I2C_Is_Busy(void);
+
+/**
+ * @brief Wait until all queued transactions have completed.
+ *
+ * @return None
+ */
+void EUSCI_B1_I2C_Wait_Idle(void);
+
 #endif /* INC_EUSCI_B1_I2C_H_ */
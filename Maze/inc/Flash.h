@@ -0,0 +1,95 @@
+/**
+ * @file Flash.h
+ * @brief Header file for the Flash driver.
+ *
+ * This file contains the function definitions for the Flash driver.
+ * It erases and programs the sectors of flash bank 1 using the flash controller (FLCTL), for the
+ * Flash_Store and Black_Box modules.
+ *
+ * A sector erase can be started without waiting for it (Flash_Erase_Start), and is then completed by
+ * Flash_Erase_Poll. A program operation or another erase started meanwhile first waits for the erase,
+ * since the flash controller only executes one operation at a time.
+ *
+ * @note The program is executed from flash bank 0, so it keeps running while bank 1 is programmed or erased.
+ *       A word is programmed in about 50 us, and a sector is erased in up to a few tens of ms.
+ *
+ */
+
+#ifndef INC_FLASH_H_
+#define INC_FLASH_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+// Start address of flash bank 1, and size of a sector
+#define FLASH_BANK1_ADDRESS     0x00020000
+#define FLASH_BANK1_SIZE        0x00020000
+#define FLASH_SECTOR_SIZE       0x1000
+
+// Value of an erased flash word
+#define FLASH_ERASED            0xFFFFFFFF
+
+#define FLASH_WORD(address)     (*(volatile uint32_t *)(address))
+
+/**
+ * @brief Start the erase of a sector of flash bank 1 and return without waiting for it.
+ *
+ * @param address The start address of the sector.
+ *
+ * @return 0 if the erase has started, or -1 if the address is not a sector of flash bank 1.
+ */
+int Flash_Erase_Start(uint32_t address);
+
+/**
+ * @brief Complete the erase started by Flash_Erase_Start if it is done, and verify the sector.
+ *
+ * @param None
+ *
+ * @return 1 if the erase is still in progress, 0 if it is complete (or if there is none), or -1 if it has failed.
+ */
+int Flash_Erase_Poll(void);
+
+/**
+ * @brief Erase a sector of flash bank 1 and wait for the erase.
+ *
+ * @param address The start address of the sector.
+ *
+ * @return 0 if every word of the sector has been erased, or -1 otherwise.
+ */
+int Flash_Erase_Sector(uint32_t address);
+
+/**
+ * @brief Program a word of flash bank 1, after the erase in progress if any.
+ *
+ * @param address The word-aligned address.
+ * @param data    The value of the word.
+ *
+ * @return 0 if the word has been programmed and verified, or -1 otherwise.
+ */
+int Flash_Program_Word(uint32_t address, uint32_t data);
+
+/**
+ * @brief Program a block of bytes from a word-aligned address, padding the last word with erased bytes.
+ *
+ * @param address The word-aligned address.
+ * @param data    Pointer to the bytes.
+ * @param length  The number of bytes.
+ *
+ * @return 0 if every word has been programmed and verified, or -1 otherwise.
+ */
+int Flash_Program(uint32_t address, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Update a CRC-32 (polynomial 0xEDB88320) with a block of bytes.
+ *
+ * The CRC starts at 0xFFFFFFFF and its final value is inverted.
+ *
+ * @param crc    The CRC of the previous bytes.
+ * @param data   Pointer to the bytes.
+ * @param length The number of bytes.
+ *
+ * @return The updated CRC.
+ */
+uint32_t Flash_CRC32(uint32_t crc, const uint8_t *data, uint32_t length);
+
+#endif /* INC_FLASH_H_ */
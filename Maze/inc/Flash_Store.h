@@ -0,0 +1,103 @@
+/**
+ * @file Flash_Store.h
+ * @brief Header file for the Flash_Store driver.
+ *
+ * This file contains the function definitions for the Flash_Store driver.
+ * It stores records identified by a key in the last sectors of flash bank 1, programmed with the Flash driver,
+ * so that calibration data and maze maps are kept when the robot is restarted.
+ *
+ * Layout:
+ *  - The store uses FLASH_STORE_NUM_SECTORS sectors of 4 KB, reserved by the FLASH_STORE region of the linker
+ *    command file (msp432p401r.cmd). Only one sector is active at a time.
+ *  - A sector starts with a magic word and a generation number. The active sector is the valid sector with the
+ *    highest generation.
+ *  - A record is a header word (key and length), the CRC-32 of the header and the data, and the data padded to
+ *    a word. A new version of a record is appended after the previous records, and a read returns the last
+ *    version with a valid CRC. A record interrupted by a reset fails the CRC check and is ignored.
+ *
+ * Wear:
+ *  - A write of the same data as the current version is skipped, so a periodic save only programs the flash
+ *    when the data has changed.
+ *  - When the active sector is full, the last version of every record is copied to the next sector, and its
+ *    header is written last with the next generation. The sectors are erased in turn, and the previous sector
+ *    remains valid until the copy is complete.
+ *
+ * @note A write blocks the caller for about 50 us per word, and a sector rotation for the erase time of a sector
+ *       (up to a few tens of ms), so Flash_Store_Write must only be called from a background task.
+ *
+ */
+
+#ifndef INC_FLASH_STORE_H_
+#define INC_FLASH_STORE_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "Flash.h"
+
+// Address of the first sector of the store (sector 30 of flash bank 1), and size of a sector
+#define FLASH_STORE_START_ADDRESS       0x0003E000
+#define FLASH_STORE_SECTOR_SIZE         FLASH_SECTOR_SIZE
+#define FLASH_STORE_NUM_SECTORS         2
+
+// Largest data length of a record in bytes
+#define FLASH_STORE_MAX_LENGTH          1024
+
+// Keys of the records used by the program
+#define FLASH_STORE_KEY_COLOR_CALIBRATION       0x0001
+#define FLASH_STORE_KEY_DISTANCE_CALIBRATION    0x0002
+#define FLASH_STORE_KEY_MAZE_MAP                0x0003
+#define FLASH_STORE_KEY_PARAMETERS              0x0004
+
+// Keys of the slots of the maze map library (packed maps, see Maze_Map_Pack.h), MAZE_LIBRARY_NUM_SLOTS from this one
+#define FLASH_STORE_KEY_MAZE_LIBRARY            0x0010
+
+/**
+ * @brief Find the active sector, or format the store if no sector is valid.
+ *
+ * @param None
+ *
+ * @return 0 if the store is ready, or -1 if a sector cannot be erased or programmed.
+ */
+int Flash_Store_Init(void);
+
+/**
+ * @brief Read the last version of a record.
+ *
+ * @param key    The key of the record (0x0000 to 0xFFFE).
+ * @param data   Pointer to store the data.
+ * @param length The number of bytes expected.
+ *
+ * @return The length of the record, or -1 if the record does not exist or its length is not the expected length.
+ */
+int Flash_Store_Read(uint16_t key, void *data, uint16_t length);
+
+/**
+ * @brief Write a new version of a record, unless the data is the same as the last version.
+ *
+ * @param key    The key of the record (0x0000 to 0xFFFE).
+ * @param data   Pointer to the data.
+ * @param length The number of bytes (1 to FLASH_STORE_MAX_LENGTH).
+ *
+ * @return 0 if the record has been written or is unchanged, or -1 if the store is not initialized, is full, or the flash cannot be programmed.
+ */
+int Flash_Store_Write(uint16_t key, const void *data, uint16_t length);
+
+/**
+ * @brief Return the number of bytes that can still be appended to the active sector.
+ *
+ * @param None
+ *
+ * @return The free space of the active sector in bytes.
+ */
+uint32_t Flash_Store_Get_Free(void);
+
+/**
+ * @brief Return the generation of the active sector, incremented at every sector rotation.
+ *
+ * @param None
+ *
+ * @return The generation of the active sector.
+ */
+uint32_t Flash_Store_Get_Generation(void);
+
+#endif /* INC_FLASH_STORE_H_ */
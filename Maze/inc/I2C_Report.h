@@ -0,0 +1,42 @@
+/**
+ * @file I2C_Report.h
+ * @brief Header file for the I2C_Report module.
+ *
+ * This file contains the function definitions for the I2C_Report module.
+ * It executes the i2c command received by the Parameters module, which reports the statistics of the EUSCI_B1 bus.
+ *
+ * Commands:
+ *  - i2c       Print the statistics of every device on the EUSCI_B1 bus as
+ *              "i2c 0x<address> khz=<SCL kHz> n=<transfers> nack=<n> to=<timeouts> wait=<us> xfer=<us>",
+ *              with the longest queue wait and transfer time, then "ok i2c recoveries=<n>"
+ *
+ */
+
+#ifndef INC_I2C_REPORT_H_
+#define INC_I2C_REPORT_H_
+
+#include <stdint.h>
+#include "Clock.h"
+#include "EUSCI_B1_I2C.h"
+#include "Parameters.h"
+
+/**
+ * @brief This function selects the function that sends the replies.
+ *
+ * @param output The function that sends a reply line (without line ending), for example the output of the Parameters module.
+ *
+ * @return None
+ */
+void I2C_Report_Init(void (*output)(const char *line));
+
+/**
+ * @brief This function executes the i2c command received by the Parameters module.
+ *
+ * @param arguments      The words of the command line.
+ * @param argument_count The number of words.
+ *
+ * @return 0 if the command has been executed, or -1 if it is not the i2c command.
+ */
+int I2C_Report_Command(char **arguments, uint8_t argument_count);
+
+#endif /* INC_I2C_REPORT_H_ */
@@ -0,0 +1,166 @@
+/**
+ * @file Interrupt_Priority.h
+ * @brief Priority levels of the interrupts of the firmware.
+ *
+ * Every driver that enables an interrupt in NVIC (or the SysTick exception) takes its priority level from here,
+ * so the preemption between the handlers can be read in one place. The MSP432 implements 3 priority bits,
+ * so the levels are 0 (highest) to 7 (lowest), stored in the upper 3 bits of the 8-bit priority field.
+ *
+ * Intended nesting order, from the highest priority:
+ *  - PORT4: the bumper switches stop the motors, so nothing else can delay the emergency stop.
+ *  - TA3_0 and TA3_N: the tachometer captures. The capture register keeps the time of the edge, but a second
+ *    edge before the handler has read it is lost, so only the emergency stop may preempt them.
+ *  - TA1_0 and DMA_INT1: the 2 kHz distance sampler. It writes the snapshots of Distance_Source, which are read
+ *    by the control tick, so it must preempt the SysTick.
+ *  - EUSCI_B1: the I2C transfers. The blocking I2C functions are called from the SysTick and from PORT6,
+ *    so the I2C interrupt must preempt both. A stuck-bus recovery (about 110 us) also runs in this handler.
+ *  - SysTick: the 100 Hz scheduler tick and control loop.
+ *  - UARTs: the bytes of the serial links are buffered, so they wait for everything else.
+ *
+ * The order is checked at compile time below. Profiler.h measures the worst-case entry latency of the
+ * tachometer, sampler, and SysTick handlers, and Profiler_Print flags the ones above their budget.
+ *
+ * Each value can be overridden on the command line of the compiler, for example -DINTERRUPT_PRIORITY_SYSTICK=5.
+ *
+ */
+
+#ifndef INC_INTERRUPT_PRIORITY_H_
+#define INC_INTERRUPT_PRIORITY_H_
+
+// Number of priority bits implemented by the NVIC of the MSP432
+#define INTERRUPT_PRIORITY_BITS             3
+
+// Lowest priority level
+#define INTERRUPT_PRIORITY_LOWEST           ((1 << INTERRUPT_PRIORITY_BITS) - 1)
+
+// Value of the 8-bit priority field (NVIC->IP[irq] or SCB->SHP[index]) of a priority level
+#define INTERRUPT_PRIORITY_FIELD(level)     ((uint8_t)((level) << (8 - INTERRUPT_PRIORITY_BITS)))
+
+// Bumper switches and OPT3001 interrupt pin (IRQ 38)
+#ifndef INTERRUPT_PRIORITY_PORT4
+#define INTERRUPT_PRIORITY_PORT4            0
+#endif
+
+// Tachometer captures: right encoder on CCR0 (IRQ 14), left encoder, timebase overflow, and CCR2 compare (IRQ 15)
+#ifndef INTERRUPT_PRIORITY_TA3_0
+#define INTERRUPT_PRIORITY_TA3_0            1
+#endif
+#ifndef INTERRUPT_PRIORITY_TA3_N
+#define INTERRUPT_PRIORITY_TA3_N            1
+#endif
+
+// 2 kHz distance sampler: Timer_A1 periodic interrupt (IRQ 10) or DMA blocks of the Analog Distance Sensors (IRQ 33)
+#ifndef INTERRUPT_PRIORITY_TA1_0
+#define INTERRUPT_PRIORITY_TA1_0            2
+#endif
+#ifndef INTERRUPT_PRIORITY_DMA_INT1
+#define INTERRUPT_PRIORITY_DMA_INT1         2
+#endif
+
+// I2C transfers of the PMOD Color, OPT3101, and OPT3001 sensors (IRQ 21)
+#ifndef INTERRUPT_PRIORITY_EUSCI_B1
+#define INTERRUPT_PRIORITY_EUSCI_B1         2
+#endif
+
+// Nokia5110 LCD page transfers (IRQ 32) and the unassigned DMA_INT3 (IRQ 31)
+#ifndef INTERRUPT_PRIORITY_DMA_INT2
+#define INTERRUPT_PRIORITY_DMA_INT2         3
+#endif
+#ifndef INTERRUPT_PRIORITY_DMA_INT3
+#define INTERRUPT_PRIORITY_DMA_INT3         3
+#endif
+
+// OPT3101 DATA_RDY (IRQ 40) and reflectance sensor decay (Timer32 INT1, IRQ 25)
+#ifndef INTERRUPT_PRIORITY_PORT6
+#define INTERRUPT_PRIORITY_PORT6            3
+#endif
+#ifndef INTERRUPT_PRIORITY_T32_INT1
+#define INTERRUPT_PRIORITY_T32_INT1         3
+#endif
+
+// General-purpose periodic interrupts of Timer_A0 (IRQ 8) and Timer_A2 (IRQ 12)
+#ifndef INTERRUPT_PRIORITY_TA0_0
+#define INTERRUPT_PRIORITY_TA0_0            3
+#endif
+#ifndef INTERRUPT_PRIORITY_TA2_0
+#define INTERRUPT_PRIORITY_TA2_0            3
+#endif
+
+// Scheduler tick and control loop (System Handler 15)
+#ifndef INTERRUPT_PRIORITY_SYSTICK
+#define INTERRUPT_PRIORITY_SYSTICK          4
+#endif
+
+// Serial links: EUSCI_A0 (IRQ 16), barcode scanner on EUSCI_A2 (IRQ 18), EUSCI_A3 (IRQ 19)
+#ifndef INTERRUPT_PRIORITY_EUSCI_A0
+#define INTERRUPT_PRIORITY_EUSCI_A0         5
+#endif
+#ifndef INTERRUPT_PRIORITY_EUSCI_A2
+#define INTERRUPT_PRIORITY_EUSCI_A2         5
+#endif
+#ifndef INTERRUPT_PRIORITY_EUSCI_A3
+#define INTERRUPT_PRIORITY_EUSCI_A3         5
+#endif
+
+// Timer_A2 capture on CCR1 (IRQ 13)
+#ifndef INTERRUPT_PRIORITY_TA2_N
+#define INTERRUPT_PRIORITY_TA2_N            5
+#endif
+
+// Worst-case entry latency allowed for the measured handlers in us, flagged by Profiler_Print
+// The edges of an encoder are about 600 us apart at full speed
+#ifndef INTERRUPT_LATENCY_BUDGET_TA3_US
+#define INTERRUPT_LATENCY_BUDGET_TA3_US     50
+#endif
+// Half of the 500 us period of the 2 kHz sampler
+#ifndef INTERRUPT_LATENCY_BUDGET_TA1_0_US
+#define INTERRUPT_LATENCY_BUDGET_TA1_0_US   250
+#endif
+// A tenth of the 10 ms control period
+#ifndef INTERRUPT_LATENCY_BUDGET_SYSTICK_US
+#define INTERRUPT_LATENCY_BUDGET_SYSTICK_US 1000
+#endif
+
+// The levels must fit in the priority bits (the order below keeps every level above PORT4)
+#if (INTERRUPT_PRIORITY_PORT4 < 0) || \
+    (INTERRUPT_PRIORITY_PORT4 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_TA3_0 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_TA3_N > INTERRUPT_PRIORITY_LOWEST) || \
+    (INTERRUPT_PRIORITY_TA1_0 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_DMA_INT1 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_EUSCI_B1 > INTERRUPT_PRIORITY_LOWEST) || \
+    (INTERRUPT_PRIORITY_DMA_INT2 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_DMA_INT3 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_PORT6 > INTERRUPT_PRIORITY_LOWEST) || \
+    (INTERRUPT_PRIORITY_T32_INT1 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_TA0_0 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_TA2_0 > INTERRUPT_PRIORITY_LOWEST) || \
+    (INTERRUPT_PRIORITY_SYSTICK > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_EUSCI_A0 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_EUSCI_A2 > INTERRUPT_PRIORITY_LOWEST) || \
+    (INTERRUPT_PRIORITY_EUSCI_A3 > INTERRUPT_PRIORITY_LOWEST) || (INTERRUPT_PRIORITY_TA2_N > INTERRUPT_PRIORITY_LOWEST)
+#error "Interrupt priority levels must be between 0 and 7"
+#endif
+
+// The emergency stop preempts the tachometer captures
+#if (INTERRUPT_PRIORITY_PORT4 >= INTERRUPT_PRIORITY_TA3_0) || (INTERRUPT_PRIORITY_PORT4 >= INTERRUPT_PRIORITY_TA3_N)
+#error "PORT4 (bumper switches) must have a higher priority than the tachometer captures"
+#endif
+
+// Both captures use the same timebase overflow count, so neither may preempt the other
+#if (INTERRUPT_PRIORITY_TA3_0 != INTERRUPT_PRIORITY_TA3_N)
+#error "TA3_0 and TA3_N (tachometer captures) must have the same priority"
+#endif
+
+// Only the emergency stop preempts the tachometer captures
+#if (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_TA1_0) || (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_DMA_INT1) || \
+    (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_EUSCI_B1) || (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_DMA_INT2) || \
+    (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_DMA_INT3) || (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_PORT6) || \
+    (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_T32_INT1) || (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_TA0_0) || \
+    (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_TA2_0) || (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_TA2_N) || \
+    (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_EUSCI_A0) || (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_EUSCI_A2) || \
+    (INTERRUPT_PRIORITY_TA3_N >= INTERRUPT_PRIORITY_EUSCI_A3)
+#error "Only PORT4 (bumper switches) may have a priority at or above the tachometer captures"
+#endif
+
+// The distance snapshots are written by the sampler and read by the control tick (see Distance_Source.h)
+#if (INTERRUPT_PRIORITY_TA1_0 >= INTERRUPT_PRIORITY_SYSTICK) || (INTERRUPT_PRIORITY_DMA_INT1 >= INTERRUPT_PRIORITY_SYSTICK)
+#error "The distance sampler (TA1_0 or DMA_INT1) must have a higher priority than the SysTick"
+#endif
+
+// The blocking I2C functions wait for the EUSCI_B1 interrupt in the SysTick and PORT6 handlers
+#if (INTERRUPT_PRIORITY_EUSCI_B1 >= INTERRUPT_PRIORITY_SYSTICK) || (INTERRUPT_PRIORITY_EUSCI_B1 >= INTERRUPT_PRIORITY_PORT6)
+#error "EUSCI_B1 (I2C) must have a higher priority than the SysTick and PORT6"
+#endif
+
+#endif /* INC_INTERRUPT_PRIORITY_H_ */
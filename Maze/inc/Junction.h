@@ -0,0 +1,134 @@
+/**
+ * @file Junction.h
+ * @brief Header file for the Junction module.
+ *
+ * This file contains the function definitions for the Junction module.
+ * It classifies the cell around the robot from the three converted distances, and reports every change
+ * of the classification as an event with the odometry distance at which it was first seen.
+ *
+ * Classification:
+ *  - A side is open when its distance is above the threshold. With hysteresis, a closed side opens only above
+ *    threshold + JUNCTION_HYSTERESIS, so a distance that is noisy just above the threshold does not toggle the side.
+ *    An open side closes at the threshold, where the wall follower stops pivoting towards it.
+ *  - A side changes once JUNCTION_MIN_DWELL_TICKS consecutive updates have disagreed with its state. Each side
+ *    has its own dwell time, so the sides change in the order in which the sensors have seen them.
+ *  - The open sides select the type: a wall on the three sides is a dead end, the front only is a corridor,
+ *    the left or the right side (with or without the front) is an opening, both sides without the front
+ *    is a T, and the three sides are a cross.
+ *  - Every change of the open sides is an event that carries the odometry distance of the first update that
+ *    disagreed, so the delay of the dwell time does not move the position of the junction.
+ *
+ * Junction_Update and the functions that read the classification must be called from the same context,
+ * the control tick. The events are kept in a ring of JUNCTION_EVENT_QUEUE_LENGTH entries, where a new event
+ * replaces the oldest one if it has not been read, so the reader always gets the latest junctions.
+ *
+ * The module does not access the hardware, so it is also compiled by the host simulator.
+ *
+ */
+
+#ifndef INC_JUNCTION_H_
+#define INC_JUNCTION_H_
+
+#include <stdint.h>
+#include "Odometry.h"
+#include "Memory_Config.h"
+
+// Width of the band above the threshold in which a closed side stays closed (in mm)
+#ifndef JUNCTION_HYSTERESIS
+#define JUNCTION_HYSTERESIS         20
+#endif
+
+// Number of consecutive updates (control ticks) that disagree with a side before it changes
+#ifndef JUNCTION_MIN_DWELL_TICKS
+#define JUNCTION_MIN_DWELL_TICKS    3
+#endif
+
+// Open sides returned by Junction_Get_Openings
+#define JUNCTION_OPEN_LEFT          0x01
+#define JUNCTION_OPEN_FRONT         0x02
+#define JUNCTION_OPEN_RIGHT         0x04
+
+/**
+ * @brief Types of cells seen by the distance sensors.
+ */
+typedef enum
+{
+    JUNCTION_UNKNOWN = 0,       // No update yet
+    JUNCTION_CORRIDOR = 1,      // Walls on the left and the right, open ahead
+    JUNCTION_DEAD_END = 2,      // Walls on the three sides
+    JUNCTION_LEFT_OPENING = 3,  // Open on the left, wall on the right
+    JUNCTION_RIGHT_OPENING = 4, // Open on the right, wall on the left
+    JUNCTION_T = 5,             // Open on the left and the right, wall ahead
+    JUNCTION_CROSS = 6          // Open on the three sides
+} Junction_Type;
+
+/**
+ * @brief Change of the classification.
+ */
+typedef struct
+{
+    Junction_Type Type;
+    uint8_t Openings;
+    int32_t Distance_um;
+} Junction_Event;
+
+/**
+ * @brief This function clears the classification and the events.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Junction_Init(void);
+
+/**
+ * @brief This function classifies the latest distances, once per control tick after Odometry_Update.
+ *
+ * The first update after Junction_Init sets the sides without hysteresis and dwell time.
+ *
+ * @param left         The converted distance of the left sensor in mm.
+ * @param center       The converted distance of the center sensor in mm.
+ * @param right        The converted distance of the right sensor in mm.
+ * @param threshold_mm The distance above which a side is open in mm.
+ *
+ * @return None
+ */
+void Junction_Update(int32_t left, int32_t center, int32_t right, int32_t threshold_mm);
+
+/**
+ * @brief This function returns the accepted type.
+ *
+ * @param None
+ *
+ * @return The type of the cell around the robot.
+ */
+Junction_Type Junction_Get_Type(void);
+
+/**
+ * @brief This function returns the open sides of the accepted type.
+ *
+ * @param None
+ *
+ * @return A combination of JUNCTION_OPEN_LEFT, JUNCTION_OPEN_FRONT, and JUNCTION_OPEN_RIGHT.
+ */
+uint8_t Junction_Get_Openings(void);
+
+/**
+ * @brief This function reads the oldest event that has not been read.
+ *
+ * @param event Pointer to store the event.
+ *
+ * @return 1 if an event has been read, or 0 if there is none.
+ */
+int Junction_Get_Event(Junction_Event *event);
+
+/**
+ * @brief This function returns the number of events replaced before they were read since Junction_Init.
+ *
+ * @param None
+ *
+ * @return The number of lost events.
+ */
+uint32_t Junction_Get_Lost_Events(void);
+
+#endif /* INC_JUNCTION_H_ */
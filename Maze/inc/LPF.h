@@ -1,12 +1,18 @@
 /**
  * @file      LPF.h
- * @brief     implements three FIR low-pass filters
+ * @brief     implements reentrant FIR low-pass filters
  * @details   Finite length LPF<br>
- 1) Size is the depth 2 to 512<br>
+ 1) Size is the depth 2 to 1024<br>
  2) y(n) = (sum(x(n)+x(n-1)+...+x(n-size-1))/size<br>
  3) To use a filter<br>
-   a) initialize it once<br>
-   b) call the filter at the sampling rate<br>
+   a) allocate a filter object and a MACQ buffer<br>
+   b) initialize it once<br>
+   c) call the filter at the sampling rate<br>
+ 4) One filter object can filter up to LPF_MAX_CHANNELS channels in one call<br>
+ 5) An optional median-of-5 stage (LPF_Median) can be placed in front of a filter
+    to reject single-sample spikes, so a shorter filter can be used for the same noise<br>
+ 6) The sum of squares of each channel is updated with the sum, so the noise
+    of the last Size samples is available at any time without a scan of the MACQ<br>
  * @version   TI-RSLK MAX v1.1
  * @author    Daniel Valvano and Jonathan Valvano
  * @copyright Copyright 2019 by Jonathan W. Valvano, valvano@mail.utexas.edu,
@@ -55,92 +61,141 @@ policies, either expressed or implied, of the FreeBSD Project.
 */
 
 
+#ifndef LPF_H_
+#define LPF_H_
+
+#include <stdint.h>
+
+#define LPF_MAX_CHANNELS 4     // maximum number of channels in one filter object
+#define LPF_MAX_SIZE     1024  // maximum depth of a filter
+#define LPF_NO_SHIFT     0xFF  // Shift value used when Size is not a power of two
+
 /**
- * Initialize first LPF<br>
- * Set all data to an initial value<br>
- * @param initial value to preload into MACQ
- * @param size depth of the filter, 2 to 512
- * @return none
- * @note  all three filters share the same size
- * @brief  Initialize first LPF
+ * Number of words needed for the MACQ of a filter
+ * @param size depth of the filter
+ * @param channels number of channels filtered together
+ * @brief  MACQ length in words
  */
-void LPF_Init(uint32_t initial, uint32_t size);
+#define LPF_BUFFER_LENGTH(size, channels) ((size)*(channels))
 
 /**
- * First LPF, calculate one filter output<br>
- * Called at sampling rate
- * @param newdata new ADC data
- * @return result filter output
- * @brief  FIR low pass filter
+ * FIR low pass filter object<br>
+ * The MACQ is supplied by the caller and holds Size samples of every channel,
+ * interleaved by channel, so each filter can have its own length and
+ * several filters can be used from different interrupts.
+ * @brief  Finite length LPF with up to LPF_MAX_CHANNELS channels
  */
-uint32_t LPF_Calc(uint32_t newdata);
+typedef struct {
+  uint32_t *Buffer;               // MACQ, LPF_BUFFER_LENGTH(Size, Channels) words
+  uint32_t Size;                  // depth of the filter, 2 to LPF_MAX_SIZE
+  uint32_t Channels;              // number of interleaved channels, 1 to LPF_MAX_CHANNELS
+  uint32_t Shift;                 // log2(Size) if Size is a power of two, otherwise LPF_NO_SHIFT
+  uint32_t Index;                 // index of the oldest sample in the MACQ
+  uint32_t Sum[LPF_MAX_CHANNELS]; // sum of the last Size samples of each channel
+  uint64_t SumSq[LPF_MAX_CHANNELS]; // sum of the squares of the last Size samples of each channel (samples below 2^16)
+} LPF_Filter;
+
+#define LPF_MEDIAN_SIZE  5     // depth of the median pre-filter
 
 /**
- * First LPF, calculate noise as standard deviation<br>
- * Called every time the buffer refills
- * @param none
- * @return standard deviation
- * @brief  calculate amount of random noise
+ * Median-of-5 pre-filter object<br>
+ * Keeps the last LPF_MEDIAN_SIZE samples of every channel. A spike shorter than
+ * three samples is removed, and a step is delayed by two samples.
+ * @brief  Running median with up to LPF_MAX_CHANNELS channels
  */
-int32_t Noise(void);
+typedef struct {
+  uint32_t History[LPF_MAX_CHANNELS][LPF_MEDIAN_SIZE]; // last samples of each channel
+  uint32_t Channels;              // number of channels, 1 to LPF_MAX_CHANNELS
+  uint32_t Index;                 // index of the oldest sample in the history
+} LPF_Median;
 
 /**
- * Initialize second LPF<br>
+ * Initialize a LPF<br>
  * Set all data to an initial value<br>
- * @param initial value to preload into MACQ
- * @param size depth of the filter, 2 to 512
+ * @param filter pointer to the filter object
+ * @param buffer MACQ of LPF_BUFFER_LENGTH(size, channels) words
+ * @param size depth of the filter, 2 to LPF_MAX_SIZE
+ * @param channels number of channels, 1 to LPF_MAX_CHANNELS
+ * @param initial array of channels values to preload into MACQ
  * @return none
- * @note  all three filters share the same size
- * @brief  Initialize second LPF
+ * @note  a power of two size replaces the divide by a shift
+ * @brief  Initialize a LPF
  */
-void LPF_Init2(uint32_t initial, uint32_t size);
+void LPF_Filter_Init(LPF_Filter *filter, uint32_t *buffer, uint32_t size, uint32_t channels, const uint32_t initial[]);
 
 /**
- * Second LPF, calculate one filter output<br>
+ * Single channel LPF, calculate one filter output<br>
  * Called at sampling rate
+ * @param filter pointer to a filter object with one channel
  * @param newdata new ADC data
  * @return result filter output
  * @brief  FIR low pass filter
  */
-uint32_t LPF_Calc2(uint32_t newdata);
+uint32_t LPF_Filter_Calc(LPF_Filter *filter, uint32_t newdata);
+
+/**
+ * Multiple channel LPF, calculate one filter output for every channel<br>
+ * Called at sampling rate, one pass over all channels
+ * @param filter pointer to the filter object
+ * @param newdata array of Channels new ADC data
+ * @param result array of Channels filter outputs
+ * @return none
+ * @brief  FIR low pass filter
+ */
+void LPF_Filter_Calc_All(LPF_Filter *filter, const uint32_t newdata[], uint32_t result[]);
 
 /**
- * Second LPF, calculate noise as standard deviation<br>
- * Called every time the buffer refills
- * @param none
+ * Calculate the variance of the last Size samples of one channel<br>
+ * Uses the running sum and sum of squares, so it can be called at any rate
+ * @param filter pointer to the filter object
+ * @param channel channel number, 0 to Channels-1
+ * @return sample variance, sum((x-mean)^2)/(Size-1)
+ * @note  a power of two size replaces the 64-bit divide by a shift
+ * @brief  variance of one channel
+ */
+uint32_t LPF_Filter_Variance(const LPF_Filter *filter, uint32_t channel);
+
+/**
+ * Calculate noise of one channel as standard deviation<br>
+ * Uses the running sum and sum of squares, so it can be called at any rate
+ * @param filter pointer to the filter object
+ * @param channel channel number, 0 to Channels-1
  * @return standard deviation
  * @brief  calculate amount of random noise
  */
-int32_t Noise2(void);
+int32_t LPF_Filter_Noise(const LPF_Filter *filter, uint32_t channel);
 
 /**
- * Initialize third LPF<br>
- * Set all data to an initial value<br>
- * @param initial value to preload into MACQ
- * @param size depth of the filter, 2 to 512
+ * Calculate noise of every channel as standard deviation<br>
+ * @param filter pointer to the filter object
+ * @param result array of Channels standard deviations
  * @return none
- * @note  all three filters share the same size
- * @brief  Initialize third LPF
+ * @brief  calculate amount of random noise
  */
-void LPF_Init3(uint32_t initial, uint32_t size);
+void LPF_Filter_Noise_All(const LPF_Filter *filter, uint32_t result[]);
 
 /**
- * Third LPF, calculate one filter output<br>
- * Called at sampling rate
- * @param newdata new ADC data
- * @return result filter output
- * @brief  FIR low pass filter
+ * Initialize a median pre-filter<br>
+ * Set all data to an initial value<br>
+ * @param median pointer to the median object
+ * @param channels number of channels, 1 to LPF_MAX_CHANNELS
+ * @param initial array of channels values to preload into the history
+ * @return none
+ * @brief  Initialize a median pre-filter
  */
-uint32_t LPF_Calc3(uint32_t newdata);
+void LPF_Median_Init(LPF_Median *median, uint32_t channels, const uint32_t initial[]);
 
 /**
- * Third LPF, calculate noise as standard deviation<br>
- * Called every time the buffer refills
- * @param none
- * @return standard deviation
- * @brief  calculate amount of random noise
+ * Multiple channel median-of-5, calculate one output for every channel<br>
+ * Called at sampling rate, before LPF_Filter_Calc_All<br>
+ * At most 6 comparisons per channel (no sort of the history)
+ * @param median pointer to the median object
+ * @param newdata array of Channels new ADC data
+ * @param result array of Channels median outputs (can be newdata)
+ * @return none
+ * @brief  Median pre-filter
  */
-int32_t Noise3(void);
+void LPF_Median_Calc_All(LPF_Median *median, const uint32_t newdata[], uint32_t result[]);
 
 /**
  * 3-wide non recursive Median filter <br>
@@ -152,9 +207,11 @@ int32_t Noise3(void);
 int32_t Median(int32_t newdata);
 
 /**
- * Newton's method square root
+ * Integer square root, one result bit per iteration (no divide)
  * @param s is an integer
- * @return is an integer
+ * @return is floor(sqrt(s))
  * @brief  square root
  */
 uint32_t isqrt(uint32_t s);
+
+#endif /* LPF_H_ */
@@ -0,0 +1,46 @@
+/**
+ * @file Latency_Report.h
+ * @brief Header file for the Latency_Report module.
+ *
+ * This file contains the function definitions for the Latency_Report module.
+ * It executes the latency commands received by the Parameters module, which start the measurements of the
+ * Latency_Test module and report their results, for example to the Latency_Benchmark.py script.
+ *
+ * Commands:
+ *  - latency inject <left> <center> <right>    Replace the distances (in mm) until the resulting motor command,
+ *                                              then print "ok latency inject"
+ *  - latency cancel                            Stop replacing the distances, then print "ok latency cancel"
+ *  - latency                                   Print "latency cycles=<cycles> us=<us> strategy=<name>" once the motor
+ *                                              command has been seen, or "latency state=<state>" before
+ *
+ */
+
+#ifndef INC_LATENCY_REPORT_H_
+#define INC_LATENCY_REPORT_H_
+
+#include <stdint.h>
+#include "Clock.h"
+#include "Latency_Test.h"
+#include "Route_Race.h"
+#include "Parameters.h"
+
+/**
+ * @brief This function selects the function that sends the replies.
+ *
+ * @param output The function that sends a reply line (without line ending), for example the output of the Parameters module.
+ *
+ * @return None
+ */
+void Latency_Report_Init(void (*output)(const char *line));
+
+/**
+ * @brief This function executes the latency commands received by the Parameters module.
+ *
+ * @param arguments      The words of the command line.
+ * @param argument_count The number of words.
+ *
+ * @return 0 if the command has been executed, or -1 if it is not a latency command.
+ */
+int Latency_Report_Command(char **arguments, uint8_t argument_count);
+
+#endif /* INC_LATENCY_REPORT_H_ */
@@ -0,0 +1,118 @@
+/**
+ * @file Latency_Test.h
+ * @brief Header file for the Latency_Test module.
+ *
+ * This file contains the function definitions for the Latency_Test module.
+ * It measures the end-to-end latency of the controllers on the robot, from a distance that changes at the
+ * output of the distance sensor chain to the first motor command of a controller that has read it.
+ *
+ * Sequence of a measurement:
+ *  - Latency_Test_Arm stores the synthetic distances, for example an obstacle in front of the robot.
+ *  - Latency_Test_Apply, executed by the filter interrupt just before Distance_Source_Update_Sharp, replaces
+ *    the converted distances with the synthetic ones and takes the cycle count of the first replaced set.
+ *  - Latency_Test_Motor_Command, executed by every function of the Motor driver after the registers have been written,
+ *    takes the cycle count of the first command issued once Distance_Source_Get has returned a replaced set.
+ *  - The latency is the difference of the two cycle counts, so it includes the wait for the next control tick,
+ *    the execution of the controller, and the write of the motor registers.
+ *
+ * The distances are replaced until the motor command has been seen or Latency_Test_Cancel is called.
+ * The cycle counts are in MCLK cycles (see CycleCounter_Read), so the caller converts them with Clock_GetFreq.
+ *
+ * @note The distances are injected in the path of the Analog Distance Sensors, so the measurement requires the
+ *       Sharp or the fusion distance source. The motor commands of the interrupt handlers (Motor_Stop_Inline)
+ *       are not seen.
+ *
+ */
+
+#ifndef INC_LATENCY_TEST_H_
+#define INC_LATENCY_TEST_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Analog_Distance_Sensors.h"
+#include "Distance_Source.h"
+
+/**
+ * @brief State of the measurement.
+ */
+typedef enum
+{
+    LATENCY_TEST_IDLE = 0,      // No measurement
+    LATENCY_TEST_ARMED = 1,     // The synthetic distances wait for the next set of converted distances
+    LATENCY_TEST_WAITING = 2,   // The synthetic distances are injected, waiting for the motor command
+    LATENCY_TEST_DONE = 3       // The latency has been measured
+} Latency_Test_State;
+
+/**
+ * @brief This function cancels the measurement.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Latency_Test_Init(void);
+
+/**
+ * @brief This function starts a measurement with synthetic distances.
+ *
+ * A measurement that is not complete is restarted.
+ *
+ * @param left   The left distance in mm.
+ * @param center The center distance in mm.
+ * @param right  The right distance in mm.
+ *
+ * @return None
+ */
+void Latency_Test_Arm(int32_t left, int32_t center, int32_t right);
+
+/**
+ * @brief This function stops the injection of the synthetic distances, and keeps a measured latency.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Latency_Test_Cancel(void);
+
+/**
+ * @brief This function replaces the converted distances while a measurement is running.
+ *
+ * Must be called from the interrupt handler that calls Distance_Source_Update_Sharp, just before it.
+ *
+ * @param converted The distances in mm, in the channel order of the sensors (right, center, left).
+ *
+ * @return None
+ */
+void Latency_Test_Apply(int32_t converted[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS]);
+
+/**
+ * @brief This function takes the time of a motor command, executed by the Motor driver.
+ *
+ * It only reads the state of the measurement when no measurement is waiting for a motor command.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Latency_Test_Motor_Command(void);
+
+/**
+ * @brief This function returns the state of the measurement.
+ *
+ * @param None
+ *
+ * @return The state of the measurement.
+ */
+Latency_Test_State Latency_Test_Get_State(void);
+
+/**
+ * @brief This function returns the measured latency.
+ *
+ * @param latency_cycles Pointer to store the latency in MCLK cycles.
+ *
+ * @return 0 if the latency has been measured, or -1 if the measurement is not complete.
+ */
+int Latency_Test_Get_Result(uint32_t *latency_cycles);
+
+#endif /* INC_LATENCY_TEST_H_ */
@@ -0,0 +1,336 @@
+/**
+ * @file Maze_Map.h
+ * @brief Header file for the Maze_Map driver.
+ *
+ * This file contains the function definitions for the Maze_Map driver.
+ * It stores the walls of the maze discovered by the robot in a bit-packed grid (4 bits per cell)
+ * and computes the flood-fill distance of every cell to the goal cells. The robot reaches the goal
+ * on the shortest known path by moving to the open neighbor with the smallest distance.
+ *
+ * Grid layout:
+ *  - Cell (0, 0) is the start cell in the bottom-left corner. X increases to the east and Y increases to the north.
+ *  - Each cell stores one wall bit per direction (Bit 0 = North, Bit 1 = East, Bit 2 = South, Bit 3 = West).
+ *    Two cells are stored per byte, the cell with an even index in the lower 4 bits.
+ *  - The walls on the border of the grid are always set.
+ *  - Walls that have not been observed yet are assumed to be open, so the distances are optimistic.
+ *
+ * Flood fill:
+ *  - A breadth-first search starts from the goal cells. Each cell is queued at most once and each dequeued cell
+ *    checks its four neighbors, so a full flood fill takes at most MAZE_MAP_NUM_CELLS steps.
+ *  - Maze_Map_Flood_Fill_Step processes a bounded number of cells per call, so the work can be spread
+ *    over several control ticks.
+ *
+ * Incremental replanning:
+ *  - Maze_Map_Update_Wall records a wall observation. If the wall changes the map while the distances are valid,
+ *    only the two cells on each side of the wall are queued for repair.
+ *  - Maze_Map_Replan_Step repairs the queued cells: a cell whose distance differs from 1 + the smallest distance
+ *    of its open neighbors is updated, and only then are its neighbors queued. Cells far from the new wall are
+ *    never touched. A cell is queued at most once at a time, so the repair queue cannot overflow.
+ *  - If a repair processes more than MAZE_MAP_REPAIR_LIMIT cells (for example when a wall cuts a region off
+ *    and its distances count up to MAZE_MAP_UNREACHABLE), the repair is replaced by a full flood fill.
+ *  - The number of MCLK cycles used by every call of Maze_Map_Replan_Step is measured with the DWT cycle counter,
+ *    and the worst case is available from Maze_Map_Get_Max_Update_Cycles.
+ *
+ */
+
+#ifndef INC_MAZE_MAP_H_
+#define INC_MAZE_MAP_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Memory_Config.h"
+
+// Number of cells of the grid, whose dimensions are set in Memory_Config.h
+#define MAZE_MAP_NUM_CELLS          (MAZE_MAP_WIDTH * MAZE_MAP_HEIGHT)
+
+// Maximum number of goal cells
+#define MAZE_MAP_MAX_GOALS          4
+
+// Distance of a cell that cannot reach a goal, or whose distance has not been computed yet
+#define MAZE_MAP_UNREACHABLE        0xFF
+
+// Maximum number of steps of Maze_Map_Flood_Fill_Step needed for a full flood fill
+#define MAZE_MAP_FLOOD_FILL_MAX_STEPS   MAZE_MAP_NUM_CELLS
+
+// Number of cells processed by a repair before it is replaced by a full flood fill
+#define MAZE_MAP_REPAIR_LIMIT       (2 * MAZE_MAP_NUM_CELLS)
+
+// Number of bytes written by Maze_Map_Export: the walls (four bits per cell) and the visited flags (one bit per cell)
+#define MAZE_MAP_STORAGE_SIZE       ((MAZE_MAP_NUM_CELLS / 2) + (MAZE_MAP_NUM_CELLS / 8))
+
+// Returns the index of the cell (x, y)
+#define MAZE_MAP_CELL_INDEX(x, y)   ((uint8_t)(((y) * MAZE_MAP_WIDTH) + (x)))
+
+/**
+ * @brief Absolute directions in the maze. The values are also the wall bit positions of a cell.
+ */
+typedef enum
+{
+    MAZE_NORTH = 0,
+    MAZE_EAST = 1,
+    MAZE_SOUTH = 2,
+    MAZE_WEST = 3
+} Maze_Direction;
+
+// Direction after turning right, left, or around from the given direction
+#define MAZE_DIRECTION_RIGHT(d)     ((Maze_Direction)(((d) + 1) & 0x3))
+#define MAZE_DIRECTION_LEFT(d)      ((Maze_Direction)(((d) + 3) & 0x3))
+#define MAZE_DIRECTION_BACK(d)      ((Maze_Direction)(((d) + 2) & 0x3))
+
+/**
+ * @brief Clear the map: only the border walls are set and no cell has been visited.
+ *
+ * The goal list is not changed.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Maze_Map_Init();
+
+/**
+ * @brief Remove every goal cell.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Maze_Map_Clear_Goals();
+
+/**
+ * @brief Add a goal cell. The flood fill measures the distance to the nearest goal cell.
+ *
+ * @param x The X coordinate of the cell.
+ * @param y The Y coordinate of the cell.
+ *
+ * @return 0 if the goal has been added, or -1 if the goal list is full or the cell is outside the grid.
+ */
+int Maze_Map_Add_Goal(uint8_t x, uint8_t y);
+
+/**
+ * @brief Indicate if a cell is a goal cell.
+ *
+ * @param x The X coordinate of the cell.
+ * @param y The Y coordinate of the cell.
+ *
+ * @return 1 if the cell is a goal cell, or 0 otherwise.
+ */
+uint8_t Maze_Map_Is_Goal(uint8_t x, uint8_t y);
+
+/**
+ * @brief Return the goal cells, for example to save them with the map.
+ *
+ * @param x Pointer to store the X coordinates of up to MAZE_MAP_MAX_GOALS cells.
+ * @param y Pointer to store the Y coordinates of up to MAZE_MAP_MAX_GOALS cells.
+ *
+ * @return The number of goal cells.
+ */
+uint8_t Maze_Map_Get_Goals(uint8_t *x, uint8_t *y);
+
+/**
+ * @brief Set or clear a wall of a cell and the matching wall of its neighbor.
+ *
+ * @param x         The X coordinate of the cell.
+ * @param y         The Y coordinate of the cell.
+ * @param direction The side of the cell.
+ * @param present   1 if a wall has been observed, or 0 if the side is open.
+ *
+ * @return 1 if the map has changed, or 0 otherwise.
+ *
+ * @note The border walls of the grid cannot be cleared.
+ */
+uint8_t Maze_Map_Set_Wall(uint8_t x, uint8_t y, Maze_Direction direction, uint8_t present);
+
+/**
+ * @brief Return the 4 wall bits of a cell.
+ *
+ * @param x The X coordinate of the cell.
+ * @param y The Y coordinate of the cell.
+ *
+ * @return The wall bits (Bit 0 = North, Bit 1 = East, Bit 2 = South, Bit 3 = West).
+ */
+uint8_t Maze_Map_Get_Walls(uint8_t x, uint8_t y);
+
+/**
+ * @brief Indicate if a side of a cell has a wall.
+ *
+ * @param x         The X coordinate of the cell.
+ * @param y         The Y coordinate of the cell.
+ * @param direction The side of the cell.
+ *
+ * @return 1 if the side has a wall, or 0 if it is open or unknown.
+ */
+uint8_t Maze_Map_Has_Wall(uint8_t x, uint8_t y, Maze_Direction direction);
+
+/**
+ * @brief Mark a cell as visited, which means that all of its walls have been observed.
+ *
+ * @param x The X coordinate of the cell.
+ * @param y The Y coordinate of the cell.
+ *
+ * @return None
+ */
+void Maze_Map_Set_Visited(uint8_t x, uint8_t y);
+
+/**
+ * @brief Indicate if a cell has been visited.
+ *
+ * @param x The X coordinate of the cell.
+ * @param y The Y coordinate of the cell.
+ *
+ * @return 1 if the cell has been visited, or 0 otherwise.
+ */
+uint8_t Maze_Map_Is_Visited(uint8_t x, uint8_t y);
+
+/**
+ * @brief Copy the walls and the visited flags of every cell, for example to save the map in flash.
+ *
+ * @param buffer Pointer to store MAZE_MAP_STORAGE_SIZE bytes.
+ *
+ * @return None
+ */
+void Maze_Map_Export(uint8_t *buffer);
+
+/**
+ * @brief Restore the walls and the visited flags written by Maze_Map_Export.
+ *
+ * The goals are kept, and the distances are invalid until the next flood fill (Maze_Map_Flood_Fill).
+ *
+ * @param buffer Pointer to the MAZE_MAP_STORAGE_SIZE bytes of a map.
+ *
+ * @return None
+ */
+void Maze_Map_Import(const uint8_t *buffer);
+
+/**
+ * @brief Return the neighbor of a cell in the given direction.
+ *
+ * @param x         Pointer to the X coordinate of the cell. Updated with the X coordinate of the neighbor.
+ * @param y         Pointer to the Y coordinate of the cell. Updated with the Y coordinate of the neighbor.
+ * @param direction The direction of the neighbor.
+ *
+ * @return 0 if the neighbor exists, or -1 if it is outside the grid (the coordinates are not changed).
+ */
+int Maze_Map_Neighbor(uint8_t *x, uint8_t *y, Maze_Direction direction);
+
+/**
+ * @brief Start a new flood fill from the goal cells.
+ *
+ * Every distance is set to MAZE_MAP_UNREACHABLE, except for the goal cells which are set to 0 and queued.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Maze_Map_Flood_Fill_Start();
+
+/**
+ * @brief Continue the flood fill for a bounded number of cells.
+ *
+ * @param max_cells The maximum number of queued cells to process.
+ *
+ * @return 1 if the flood fill is complete, or 0 if more calls are needed.
+ */
+uint8_t Maze_Map_Flood_Fill_Step(uint16_t max_cells);
+
+/**
+ * @brief Compute the full flood fill. Takes at most MAZE_MAP_FLOOD_FILL_MAX_STEPS steps.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Maze_Map_Flood_Fill();
+
+/**
+ * @brief Return the flood-fill distance of a cell to the nearest goal cell.
+ *
+ * @param x The X coordinate of the cell.
+ * @param y The Y coordinate of the cell.
+ *
+ * @return The distance in cells, or MAZE_MAP_UNREACHABLE.
+ */
+uint8_t Maze_Map_Get_Distance(uint8_t x, uint8_t y);
+
+/**
+ * @brief Select the open neighbor with the smallest distance.
+ *
+ * When several neighbors have the same distance, the preferred direction wins, which avoids
+ * unnecessary turns when the preferred direction is the current heading.
+ *
+ * @param x         The X coordinate of the cell.
+ * @param y         The Y coordinate of the cell.
+ * @param preferred The preferred direction.
+ * @param direction Pointer to store the selected direction.
+ *
+ * @return 0 if a direction has been selected, or -1 if no open neighbor is closer to a goal.
+ */
+int Maze_Map_Best_Direction(uint8_t x, uint8_t y, Maze_Direction preferred, Maze_Direction *direction);
+
+/**
+ * @brief Record a wall observation and queue the affected cells for incremental replanning.
+ *
+ * Unlike Maze_Map_Set_Wall, this function keeps the flood-fill distances consistent: the repair is
+ * completed by the next calls of Maze_Map_Replan_Step.
+ *
+ * @param x         The X coordinate of the cell.
+ * @param y         The Y coordinate of the cell.
+ * @param direction The side of the cell.
+ * @param present   1 if a wall has been observed, or 0 if the side is open.
+ *
+ * @return 1 if the map has changed, or 0 otherwise.
+ */
+uint8_t Maze_Map_Update_Wall(uint8_t x, uint8_t y, Maze_Direction direction, uint8_t present);
+
+/**
+ * @brief Continue the pending repair or full flood fill for a bounded number of cells.
+ *
+ * If the distances have never been computed, a full flood fill is started.
+ *
+ * @param max_cells The maximum number of queued cells to process.
+ *
+ * @return 1 if the distances are valid, or 0 if more calls are needed.
+ */
+uint8_t Maze_Map_Replan_Step(uint16_t max_cells);
+
+/**
+ * @brief Indicate if the flood-fill distances are consistent with the map.
+ *
+ * @param None
+ *
+ * @return 1 if no repair or flood fill is pending, or 0 otherwise.
+ */
+uint8_t Maze_Map_Is_Planned();
+
+/**
+ * @brief Return the number of cells processed by the last call of Maze_Map_Replan_Step.
+ *
+ * @param None
+ *
+ * @return The number of cells processed.
+ */
+uint16_t Maze_Map_Get_Last_Update_Cells();
+
+/**
+ * @brief Return the number of MCLK cycles used by the last call of Maze_Map_Replan_Step.
+ *
+ * @param None
+ *
+ * @return The number of cycles (CycleCounter_Init must have been called).
+ */
+uint32_t Maze_Map_Get_Last_Update_Cycles();
+
+/**
+ * @brief Return the largest number of MCLK cycles used by a call of Maze_Map_Replan_Step.
+ *
+ * Compare this value with the SysTick period (480,000 cycles at 100 Hz) to check that the
+ * budget passed to Maze_Map_Replan_Step fits in one control tick.
+ *
+ * @param None
+ *
+ * @return The worst-case number of cycles since Maze_Map_Init.
+ */
+uint32_t Maze_Map_Get_Max_Update_Cycles();
+
+#endif /* INC_MAZE_MAP_H_ */
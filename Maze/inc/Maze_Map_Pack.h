@@ -0,0 +1,118 @@
+/**
+ * @file Maze_Map_Pack.h
+ * @brief Header file for the Maze_Map_Pack module.
+ *
+ * This file contains the function definitions for the Maze_Map_Pack module.
+ * It converts a map in the format of Maze_Map_Export to a compact, checksummed packed map and back, so that a map
+ * can be sent over a serial link in a few lines, kept in a slot of the flash store, and loaded by the host simulator.
+ *
+ * Packed map format (multi-byte fields are little-endian):
+ *  - Bytes 0-1     Magic "MZ" (0x4D, 0x5A)
+ *  - Byte 2        Version (MAZE_MAP_PACK_VERSION)
+ *  - Byte 3        Width of the maze in cells (1 to MAZE_MAP_WIDTH)
+ *  - Byte 4        Height of the maze in cells (1 to MAZE_MAP_HEIGHT)
+ *  - Byte 5        Flags (MAZE_MAP_PACK_FLAG_*)
+ *  - Byte 6        Number of goal cells G (0 to MAZE_MAP_MAX_GOALS)
+ *  - Bytes 7-14    Name, ASCII padded with zeros
+ *  - G bytes       Goal cells, X in Bits 0-3 and Y in Bits 4-7
+ *  - Wall bits     One bit per interior wall (1 = wall), from Bit 0 of each byte: the north walls of the cells
+ *                  of rows 0 to height - 2, then the east walls of the cells of columns 0 to width - 2, both row by row
+ *                  from cell (0, 0). The border walls are implicit. The last byte is padded with zeros.
+ *  - Visited bits  One bit per cell in the order of the cell indices, only with MAZE_MAP_PACK_FLAG_VISITED
+ *  - 2 bytes       CRC-16/CCITT-FALSE of every previous byte, like the Telemetry frames
+ *
+ * Every interior wall is stored once instead of twice in the 4 wall bits of both cells, so a 16 x 16 map packs into
+ * 113 bytes with its visited flags, instead of the 160 bytes of Maze_Map_Export (about 10 ms at 115200 baud).
+ *
+ * A maze smaller than the grid of the map occupies the cells from (0, 0). When it is unpacked, the cells outside
+ * of it are closed, so the flood fill cannot reach them.
+ *
+ * The module does not access the hardware, so it is also compiled by the host simulator.
+ *
+ */
+
+#ifndef INC_MAZE_MAP_PACK_H_
+#define INC_MAZE_MAP_PACK_H_
+
+#include <stdint.h>
+#include "Maze_Map.h"
+
+// Magic bytes and version of the format
+#define MAZE_MAP_PACK_MAGIC_0       0x4D
+#define MAZE_MAP_PACK_MAGIC_1       0x5A
+#define MAZE_MAP_PACK_VERSION       1
+
+// Length of the name field in bytes
+#define MAZE_MAP_PACK_NAME_LENGTH   8
+
+// Length of the fields before the goal cells in bytes
+#define MAZE_MAP_PACK_HEADER_SIZE   (7 + MAZE_MAP_PACK_NAME_LENGTH)
+
+// Flags of a packed map
+// MAZE_MAP_PACK_FLAG_VISITED: the visited bits are included
+// MAZE_MAP_PACK_FLAG_COMPLETE: every wall is known (a preloaded competition maze, or a maze of the simulator),
+// so every cell is marked as visited when the map is unpacked without visited bits
+#define MAZE_MAP_PACK_FLAG_VISITED  0x01
+#define MAZE_MAP_PACK_FLAG_COMPLETE 0x02
+
+// Number of interior walls of a maze
+#define MAZE_MAP_PACK_WALL_BITS(width, height)  (((width) * ((height) - 1)) + (((width) - 1) * (height)))
+
+// Length of a packed map in bytes
+#define MAZE_MAP_PACK_SIZE(width, height, goals, flags) \
+    (MAZE_MAP_PACK_HEADER_SIZE + (goals) + ((MAZE_MAP_PACK_WALL_BITS(width, height) + 7) / 8) + \
+     (((flags) & MAZE_MAP_PACK_FLAG_VISITED) ? ((((width) * (height)) + 7) / 8) : 0) + 2)
+
+// Largest length of a packed map of the grid of the Maze_Map driver
+#define MAZE_MAP_PACK_MAX_SIZE      MAZE_MAP_PACK_SIZE(MAZE_MAP_WIDTH, MAZE_MAP_HEIGHT, MAZE_MAP_MAX_GOALS, MAZE_MAP_PACK_FLAG_VISITED)
+
+/**
+ * @brief Metadata of a packed map.
+ */
+typedef struct
+{
+    uint8_t Width;
+    uint8_t Height;
+    uint8_t Flags;
+    uint8_t Num_Goals;
+    uint8_t Goal_X[MAZE_MAP_MAX_GOALS];
+    uint8_t Goal_Y[MAZE_MAP_MAX_GOALS];
+    char Name[MAZE_MAP_PACK_NAME_LENGTH];       // Not terminated when every character is used
+} Maze_Map_Pack_Info;
+
+/**
+ * @brief Pack the walls, and the visited flags if MAZE_MAP_PACK_FLAG_VISITED is set, of a map.
+ *
+ * @param map         Pointer to the MAZE_MAP_STORAGE_SIZE bytes of a map written by Maze_Map_Export.
+ * @param info        Pointer to the metadata. Only the cells inside Width x Height are packed.
+ * @param buffer      Pointer to store the packed map.
+ * @param buffer_size The size of the buffer (MAZE_MAP_PACK_MAX_SIZE is always enough).
+ *
+ * @return The length of the packed map, or -1 if the metadata is invalid or the buffer is too small.
+ */
+int Maze_Map_Pack_Encode(const uint8_t *map, const Maze_Map_Pack_Info *info, uint8_t *buffer, uint16_t buffer_size);
+
+/**
+ * @brief Check a packed map and unpack it.
+ *
+ * @param buffer Pointer to the packed map.
+ * @param length The number of bytes available, which may be more than the length of the packed map.
+ * @param map    Pointer to store the MAZE_MAP_STORAGE_SIZE bytes of the map in the format of Maze_Map_Import,
+ *               or 0 to only check the packed map and read its metadata.
+ * @param info   Pointer to store the metadata, or 0.
+ *
+ * @return The length of the packed map, or -1 if it is incomplete, its CRC is wrong, or it does not fit in the grid.
+ */
+int Maze_Map_Pack_Decode(const uint8_t *buffer, uint16_t length, uint8_t *map, Maze_Map_Pack_Info *info);
+
+/**
+ * @brief Return the length of a packed map from its first MAZE_MAP_PACK_HEADER_SIZE bytes.
+ *
+ * @param buffer Pointer to the packed map.
+ * @param length The number of bytes available.
+ *
+ * @return The length of the packed map, or -1 if the header is incomplete or invalid.
+ */
+int Maze_Map_Pack_Get_Length(const uint8_t *buffer, uint16_t length);
+
+#endif /* INC_MAZE_MAP_PACK_H_ */
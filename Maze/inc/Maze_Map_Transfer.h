@@ -0,0 +1,94 @@
+/**
+ * @file Maze_Map_Transfer.h
+ * @brief Header file for the Maze_Map_Transfer module.
+ *
+ * This file contains the function definitions for the Maze_Map_Transfer module.
+ * It executes the map commands received by the Parameters module, which transfer the maze map with the host
+ * and keep packed maps in a library of flash store slots (used by the Maze_Map_Transfer.py script).
+ *
+ * A map is transferred as a packed map (see Maze_Map_Pack.h) in lines of MAZE_MAP_TRANSFER_BYTES_PER_LINE bytes
+ * in hex, so a 16 x 16 map takes 8 lines.
+ *
+ * Commands:
+ *  - map get [slot]            Send the current map, or the map of a slot, as "map <offset> <hex>" lines,
+ *                              then print "ok map get <length>"
+ *  - map put <offset> <hex>    Store received bytes at an offset of the receive buffer, starting from 0 and
+ *                              in order, then print "ok map put <received length>"
+ *  - map load [slot]           Replace the current map with the received map, or with the map of a slot, and the
+ *                              goal cells with its goal cells if it has any, then print "ok map load <width>x<height>"
+ *  - map save <slot> [name]    Save the current map to a slot
+ *  - map write <slot>          Save the received map to a slot
+ *  - map list                  Print "map slot <slot> <name> <width>x<height> goals=<count> flags=<flags>" for every
+ *                              used slot, then "ok map list"
+ *
+ * A loaded map is only handed to the controller by Maze_Map_Transfer_Take_Loaded_Map, at the next control tick.
+ *
+ * @note The slot commands are only accepted when the library is enabled by Maze_Map_Transfer_Init. They program
+ *       the flash, so they must not be used during a run.
+ *
+ */
+
+#ifndef INC_MAZE_MAP_TRANSFER_H_
+#define INC_MAZE_MAP_TRANSFER_H_
+
+#include <stdint.h>
+#include "EUSCI_A0_UART.h"
+#include "Telemetry.h"
+#include "Flash_Store.h"
+#include "Parameters.h"
+#include "Maze_Map.h"
+#include "Maze_Map_Pack.h"
+#include "Memory_Config.h"
+
+// Number of bytes of a packed map in one line of the map commands (32 hex digits)
+#define MAZE_MAP_TRANSFER_BYTES_PER_LINE    16
+
+// Number of lines sent by a map dump in one execution of Maze_Map_Transfer_Task without packets
+#define MAZE_MAP_TRANSFER_LINES_PER_TASK    8
+
+/**
+ * @brief This function selects how the replies are sent and enables the map library, and cancels a transfer.
+ *
+ * @param output  The function that sends a reply line (without line ending), for example the output of the Parameters module.
+ * @param packets 1 if the output sends Text packets of the Telemetry module, so a dump is paced by the TX ring buffer,
+ *                or 0 to send MAZE_MAP_TRANSFER_LINES_PER_TASK lines per execution of Maze_Map_Transfer_Task.
+ * @param library 1 to accept the slot commands (FLASH_STORE_KEY_MAZE_LIBRARY), or 0 if the flash store is not used.
+ *
+ * @return None
+ */
+void Maze_Map_Transfer_Init(void (*output)(const char *line), uint8_t packets, uint8_t library);
+
+/**
+ * @brief This function executes the map commands received by the Parameters module.
+ *
+ * @param arguments      The words of the command line.
+ * @param argument_count The number of words.
+ *
+ * @return 0 if the command has been executed, or -1 if it is not a map command.
+ */
+int Maze_Map_Transfer_Command(char **arguments, uint8_t argument_count);
+
+/**
+ * @brief This function sends the next lines of a map dump, executed in the background.
+ *
+ * The lines are only queued while the TX ring buffer has room for them, like the records of a trace dump.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Maze_Map_Transfer_Task(void);
+
+/**
+ * @brief This function hands over the map of the last "map load" command, executed by the control tick.
+ *
+ * The goal cells of the Maze_Map driver are replaced with the goal cells of the loaded map if it has any.
+ *
+ * @param None
+ *
+ * @return Pointer to the MAZE_MAP_STORAGE_SIZE bytes of the map in the format of Maze_Map_Import, valid until the
+ *         next "map load" command, or 0 if no map has been loaded since the previous call.
+ */
+const uint8_t *Maze_Map_Transfer_Take_Loaded_Map(void);
+
+#endif /* INC_MAZE_MAP_TRANSFER_H_ */
@@ -0,0 +1,182 @@
+/**
+ * @file Memory_Config.h
+ * @brief Sizes of the static buffers of the firmware.
+ *
+ * Every static buffer whose size is a design choice (ring buffers, queues, filter taps, trace depth,
+ * and map dimensions) is sized here, so that the RAM footprint of a build can be changed in one place.
+ * Each value can be overridden on the command line of the compiler, for example -DTRACE_BUFFER_SIZE=64.
+ *
+ * The buffers are allocated in .bss by their modules, and nothing calls malloc. The sizes of the
+ * SRAM_DATA region, the stack, and the heap below must match msp432p401r.cmd and the linker options
+ * of the CCS project (--stack_size and --heap_size).
+ *
+ * MEMORY_CONFIG_BUFFER_BYTES adds up the buffers sized here, and the build stops with an #error when
+ * they exceed MEMORY_CONFIG_BUFFER_BUDGET. The linker still checks the complete .data and .bss
+ * against SRAM_DATA. Memory_Report.py prints the RAM used by each module from the map file of the linker.
+ *
+ */
+
+#ifndef INC_MEMORY_CONFIG_H_
+#define INC_MEMORY_CONFIG_H_
+
+// Size of the SRAM_DATA region of msp432p401r.cmd in bytes
+#define MEMORY_CONFIG_SRAM_SIZE             0x00010000
+
+// Sizes of the stack and the heap in bytes, set by --stack_size and --heap_size
+#define MEMORY_CONFIG_STACK_SIZE            512
+#define MEMORY_CONFIG_HEAP_SIZE             1024
+
+// RAM reserved for the .data and .bss sections that are not counted by MEMORY_CONFIG_BUFFER_BYTES
+#ifndef MEMORY_CONFIG_RESERVED_SIZE
+#define MEMORY_CONFIG_RESERVED_SIZE         0x00002000
+#endif
+
+// EUSCI_A0 (USB serial) ring buffers in bytes
+// Note: Must be powers of two
+#ifndef EUSCI_A0_UART_TX_BUFFER_SIZE
+#define EUSCI_A0_UART_TX_BUFFER_SIZE        1024
+#endif
+#ifndef EUSCI_A0_UART_RX_BUFFER_SIZE
+#define EUSCI_A0_UART_RX_BUFFER_SIZE        128
+#endif
+
+// EUSCI_A3 (robot link) ring buffers in bytes
+// Note: Must be powers of two
+#ifndef EUSCI_A3_UART_TX_BUFFER_SIZE
+#define EUSCI_A3_UART_TX_BUFFER_SIZE        256
+#endif
+#ifndef EUSCI_A3_UART_RX_BUFFER_SIZE
+#define EUSCI_A3_UART_RX_BUFFER_SIZE        128
+#endif
+
+// Barcode scanner line buffer and receive ring buffer in bytes
+// Note: The receive ring buffer must be a power of two
+#ifndef BARCODE_SCANNER_BUFFER_SIZE
+#define BARCODE_SCANNER_BUFFER_SIZE         64
+#endif
+#ifndef BARCODE_SCANNER_RX_BUFFER_SIZE
+#define BARCODE_SCANNER_RX_BUFFER_SIZE      64
+#endif
+
+// Number of 16-byte records of the trace ring buffer
+// Note: Must be a power of two
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE                   256
+#endif
+
+// Size of a page of the black box recorder in bytes, two of which are buffered in RAM
+// Note: Must divide the 4 KB flash sector
+#ifndef BLACK_BOX_PAGE_SIZE
+#define BLACK_BOX_PAGE_SIZE                 1024
+#endif
+
+// Dimensions of the maze map grid in cells
+// Note: The number of cells must not exceed 256 so that a cell index fits in a byte
+#ifndef MAZE_MAP_WIDTH
+#define MAZE_MAP_WIDTH                      16
+#endif
+#ifndef MAZE_MAP_HEIGHT
+#define MAZE_MAP_HEIGHT                     16
+#endif
+
+// Largest number of steps of a recorded route, and of segments of a speed run plan
+#ifndef ROUTE_MAX_STEPS
+#define ROUTE_MAX_STEPS                     64
+#endif
+
+// Largest number of strategies raced by the Route_Race module
+#ifndef ROUTE_RACE_MAX_STRATEGIES
+#define ROUTE_RACE_MAX_STRATEGIES           4
+#endif
+
+// Largest depth of the distance sensor low-pass filter, which sizes its MACQ of 3 channels
+// Note: The lpf_size parameter can select any depth up to this one at runtime
+#ifndef DISTANCE_SENSOR_LPF_MAX_SIZE
+#define DISTANCE_SENSOR_LPF_MAX_SIZE        64
+#endif
+
+// Depths of the interrupt-driven queues in entries
+// Note: Must be powers of two
+#ifndef BUMPER_EVENT_QUEUE_SIZE
+#define BUMPER_EVENT_QUEUE_SIZE             8
+#endif
+#ifndef MOTION_QUEUE_LENGTH
+#define MOTION_QUEUE_LENGTH                 8
+#endif
+#ifndef EUSCI_B1_I2C_QUEUE_LENGTH
+#define EUSCI_B1_I2C_QUEUE_LENGTH           8
+#endif
+#ifndef OPT3101_RING_LENGTH
+#define OPT3101_RING_LENGTH                 8
+#endif
+#ifndef JUNCTION_EVENT_QUEUE_LENGTH
+#define JUNCTION_EVENT_QUEUE_LENGTH         8
+#endif
+
+// Largest number of scheduler tasks
+#ifndef SCHEDULER_MAX_TASKS
+#define SCHEDULER_MAX_TASKS                 16
+#endif
+
+// Number of packed maze maps kept in the flash store by the "map save" and "map write" commands
+// Note: Each slot is a record of MAZE_MAP_PACK_MAX_SIZE bytes (113 bytes for a 16 x 16 grid)
+#ifndef MAZE_LIBRARY_NUM_SLOTS
+#define MAZE_LIBRARY_NUM_SLOTS              4
+#endif
+
+// Largest number of devices with their own SCL frequency and statistics on the EUSCI_B1 bus
+#ifndef EUSCI_B1_I2C_MAX_DEVICES
+#define EUSCI_B1_I2C_MAX_DEVICES            4
+#endif
+
+// RAM used by the larger buffers sized above in bytes
+// Maze_Map: walls (4 bits per cell), visited and repair flags (1 bit each), distances and two queues (1 byte each)
+// Robot_Link: three exported maps of 4.5 bits per cell
+// Map transfer (main.c): an exported map and two packed maps, counted as three exported maps
+// Route: the routes of the current trial and of the fastest trial, and a plan of 12-byte segments
+#define MEMORY_CONFIG_MAZE_MAP_CELLS        (MAZE_MAP_WIDTH * MAZE_MAP_HEIGHT)
+#define MEMORY_CONFIG_BUFFER_BYTES          (EUSCI_A0_UART_TX_BUFFER_SIZE + EUSCI_A0_UART_RX_BUFFER_SIZE + \
+                                             EUSCI_A3_UART_TX_BUFFER_SIZE + EUSCI_A3_UART_RX_BUFFER_SIZE + \
+                                             BARCODE_SCANNER_BUFFER_SIZE + BARCODE_SCANNER_RX_BUFFER_SIZE + \
+                                             (TRACE_BUFFER_SIZE * 16) + \
+                                             (BLACK_BOX_PAGE_SIZE * 2) + \
+                                             ((MEMORY_CONFIG_MAZE_MAP_CELLS / 2) + (MEMORY_CONFIG_MAZE_MAP_CELLS / 4) + (MEMORY_CONFIG_MAZE_MAP_CELLS * 3)) + \
+                                             (((MEMORY_CONFIG_MAZE_MAP_CELLS / 2) + (MEMORY_CONFIG_MAZE_MAP_CELLS / 8)) * 3) + \
+                                             (((MEMORY_CONFIG_MAZE_MAP_CELLS / 2) + (MEMORY_CONFIG_MAZE_MAP_CELLS / 8)) * 3) + \
+                                             ((ROUTE_MAX_STEPS * 2) + (ROUTE_MAX_STEPS * 12)) + \
+                                             (DISTANCE_SENSOR_LPF_MAX_SIZE * 3 * 4))
+
+// RAM left for the buffers sized above in bytes
+#define MEMORY_CONFIG_BUFFER_BUDGET         (MEMORY_CONFIG_SRAM_SIZE - MEMORY_CONFIG_STACK_SIZE - MEMORY_CONFIG_HEAP_SIZE - MEMORY_CONFIG_RESERVED_SIZE)
+
+#if (MEMORY_CONFIG_BUFFER_BYTES > MEMORY_CONFIG_BUFFER_BUDGET)
+#error "The buffers of Memory_Config.h do not fit in SRAM_DATA with the stack, the heap, and MEMORY_CONFIG_RESERVED_SIZE"
+#endif
+
+#if (MEMORY_CONFIG_MAZE_MAP_CELLS > 256) || ((MEMORY_CONFIG_MAZE_MAP_CELLS % 8) != 0)
+#error "The maze map must have at most 256 cells, in a multiple of 8"
+#endif
+
+#if ((EUSCI_A0_UART_TX_BUFFER_SIZE & (EUSCI_A0_UART_TX_BUFFER_SIZE - 1)) != 0) || ((EUSCI_A0_UART_RX_BUFFER_SIZE & (EUSCI_A0_UART_RX_BUFFER_SIZE - 1)) != 0)
+#error "The EUSCI_A0 ring buffer sizes must be powers of two"
+#endif
+
+#if ((EUSCI_A3_UART_TX_BUFFER_SIZE & (EUSCI_A3_UART_TX_BUFFER_SIZE - 1)) != 0) || ((EUSCI_A3_UART_RX_BUFFER_SIZE & (EUSCI_A3_UART_RX_BUFFER_SIZE - 1)) != 0)
+#error "The EUSCI_A3 ring buffer sizes must be powers of two"
+#endif
+
+#if ((BARCODE_SCANNER_RX_BUFFER_SIZE & (BARCODE_SCANNER_RX_BUFFER_SIZE - 1)) != 0)
+#error "BARCODE_SCANNER_RX_BUFFER_SIZE must be a power of two"
+#endif
+
+#if ((4096 % BLACK_BOX_PAGE_SIZE) != 0)
+#error "BLACK_BOX_PAGE_SIZE must divide the 4 KB flash sector"
+#endif
+
+#if ((BUMPER_EVENT_QUEUE_SIZE & (BUMPER_EVENT_QUEUE_SIZE - 1)) != 0) || ((MOTION_QUEUE_LENGTH & (MOTION_QUEUE_LENGTH - 1)) != 0) || \
+    ((EUSCI_B1_I2C_QUEUE_LENGTH & (EUSCI_B1_I2C_QUEUE_LENGTH - 1)) != 0) || ((OPT3101_RING_LENGTH & (OPT3101_RING_LENGTH - 1)) != 0) || \
+    ((JUNCTION_EVENT_QUEUE_LENGTH & (JUNCTION_EVENT_QUEUE_LENGTH - 1)) != 0)
+#error "The queue lengths must be powers of two"
+#endif
+
+#endif /* INC_MEMORY_CONFIG_H_ */
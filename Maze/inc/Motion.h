@@ -0,0 +1,294 @@
+/**
+ * @file Motion.h
+ * @brief Header file for the Motion driver.
+ *
+ * This file contains the function definitions for the Motion driver.
+ * It executes a queue of motion primitives (turn N degrees, drive M mm, stop for N ticks)
+ * without blocking. Motion_Update must be called once per control tick (for example, from
+ * the SysTick interrupt). It starts the next command, checks the progress of the active command
+ * using the heading estimated by the Odometry driver (turns) or the tachometer step counts (drives),
+ * and stops the motors when the command is complete.
+ *
+ * A profiled drive follows a trapezoidal speed profile using the closed-loop Speed_Controller: the speed
+ * starts at MOTION_PROFILE_MIN_SPEED, increases at a constant acceleration up to the maximum speed, and
+ * decreases before the end of the drive so that the robot reaches the end speed on the target.
+ * An arc turns at a constant speed on a circle, using different speeds for the inner and outer wheels.
+ *
+ * A turn or a drive ramps its duty cycle up by MOTION_DUTY_CYCLE_RAMP per tick, and the setpoints of the
+ * profiled drives and the arcs are ramped by the Speed_Controller within its acceleration limits, so the
+ * wheels do not slip when a command starts. While the Traction module detects a slip, it scales the duty cycle
+ * of the turns and drives down, like the one of the Speed_Controller.
+ *
+ * When a profiled drive or an arc completes and the next queued command is also a profiled drive or an arc,
+ * the motors are not stopped: the next command starts from the speed reached by the previous one.
+ *
+ * Every command also has a timeout in control ticks, so a command still completes if the
+ * wheels are stalled or the tachometers are not connected. An in-place turn only completes on its heading
+ * while it makes progress: its timeout counts the ticks since the heading last advanced by one degree.
+ *
+ * Robot geometry of the TI-RSLK MAX chassis:
+ *  - Wheel diameter: 70 mm (about 0.611 mm per tachometer step)
+ *  - Wheel base: 140 mm
+ *  - Tachometer: 360 steps per wheel revolution, so each wheel moves 2 steps per degree of an in-place turn
+ *
+ */
+
+#ifndef INC_MOTION_H_
+#define INC_MOTION_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Motor.h"
+#include "Tachometer.h"
+#include "Odometry.h"
+#include "Speed_Controller.h"
+#include "Memory_Config.h"
+
+// Distance traveled by a wheel for each tachometer step in um
+#define MOTION_UM_PER_STEP              TACHOMETER_UM_PER_STEP
+
+// Timeout used when a command is queued with a timeout of 0 ticks (3 seconds at 100 Hz)
+#define MOTION_DEFAULT_TIMEOUT_TICKS    300
+
+// Wheel base of the robot in mm, used to calculate the wheel speeds of an arc
+#define MOTION_WHEEL_BASE_MM            140
+
+// Speed at the start and at the end of a profiled drive that does not continue at speed, in mm/s
+#define MOTION_PROFILE_MIN_SPEED        100
+
+// Increase of the duty cycle of an open-loop turn or drive at every control tick (out of 15000)
+// Note: A duty cycle of 3500 is reached after 3 ticks (30 ms) instead of being applied in one step
+#define MOTION_DUTY_CYCLE_RAMP          1200
+
+// Angle before the heading of an in-place turn in degrees, and distance before the end of a straight drive in mm,
+// over which the duty cycle decreases linearly to the duty cycle reached on the target,
+// so the robot does not coast past the target heading or distance
+#ifndef MOTION_TURN_SLOWDOWN_DEGREES
+#define MOTION_TURN_SLOWDOWN_DEGREES    20
+#endif
+#ifndef MOTION_DRIVE_SLOWDOWN_MM
+#define MOTION_DRIVE_SLOWDOWN_MM        40
+#endif
+#ifndef MOTION_SLOWDOWN_MIN_DUTY_CYCLE
+#define MOTION_SLOWDOWN_MIN_DUTY_CYCLE  1500
+#endif
+
+// Difference between the duty cycles of the wheels per degree of heading change of a straight drive
+// Note: It compensates the mismatch of the motors, so an open-loop drive keeps its initial heading
+#ifndef MOTION_DRIVE_HEADING_GAIN
+#define MOTION_DRIVE_HEADING_GAIN       200
+#endif
+
+// Difference between the speeds of the wheels (in mm/s) per degree of heading change of a profiled drive
+// Note: The Speed_Controller holds the speed of each wheel, not the heading, which drifts during a long straight
+#ifndef MOTION_PROFILED_HEADING_GAIN
+#define MOTION_PROFILED_HEADING_GAIN    10
+#endif
+
+/**
+ * @brief Types of motion primitives.
+ */
+typedef enum
+{
+    MOTION_COMMAND_STOP,
+    MOTION_COMMAND_TURN,
+    MOTION_COMMAND_DRIVE,
+    MOTION_COMMAND_PROFILED_DRIVE,
+    MOTION_COMMAND_ARC
+} Motion_Command_Type;
+
+/**
+ * @brief Motion primitive stored in the command queue.
+ *
+ * For a turn, Amount is the angle in degrees (positive turns left, negative turns right).
+ * For a drive, Amount is the distance in mm (positive drives forward, negative drives backward).
+ * For a profiled drive, Amount is the distance in mm, Duty_Cycle is unused, Max_Speed and End_Speed are in mm/s,
+ * and Acceleration is in mm/s^2.
+ * For an arc, Amount is the angle in degrees (positive turns left), Max_Speed is the speed of the center
+ * of the robot in mm/s, and Radius is the radius of the arc in mm.
+ * For a stop, Amount is unused and the command completes after Timeout_Ticks.
+ */
+typedef struct
+{
+    Motion_Command_Type Type;
+    int16_t Amount;
+    uint16_t Duty_Cycle;
+    uint16_t Timeout_Ticks;
+    uint16_t Max_Speed;
+    uint16_t End_Speed;
+    uint16_t Acceleration;
+    uint16_t Radius;
+} Motion_Command;
+
+/**
+ * @brief Result of the last command that has finished.
+ */
+typedef enum
+{
+    MOTION_RESULT_NONE,
+    MOTION_RESULT_DONE,
+    MOTION_RESULT_TIMEOUT,
+    MOTION_RESULT_ABORTED
+} Motion_Result;
+
+/**
+ * @brief Initialize the Motion driver and clear the command queue.
+ *
+ * The Motor, Tachometer, and Odometry drivers must be initialized before Motion_Update is called.
+ * Odometry_Update must be called before Motion_Update in every control tick.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Motion_Init();
+
+/**
+ * @brief Queue an in-place turn.
+ *
+ * @param degrees       The angle of the turn. Positive values turn left and negative values turn right.
+ * @param duty_cycle    The duty cycle used for both motors.
+ * @param timeout_ticks The longest time in control ticks without one degree of progress, or 0 to use MOTION_DEFAULT_TIMEOUT_TICKS.
+ *
+ * @return 0 if the command has been queued, or -1 if the queue is full.
+ */
+int Motion_Turn(int16_t degrees, uint16_t duty_cycle, uint16_t timeout_ticks);
+
+/**
+ * @brief Queue a straight drive.
+ *
+ * @param distance_mm   The distance to drive. Positive values drive forward and negative values drive backward.
+ * @param duty_cycle    The duty cycle of both motors, adjusted by up to a quarter to hold the initial heading.
+ * @param timeout_ticks The maximum duration of the drive in control ticks, or 0 to use MOTION_DEFAULT_TIMEOUT_TICKS.
+ *
+ * @return 0 if the command has been queued, or -1 if the queue is full.
+ */
+int Motion_Drive(int16_t distance_mm, uint16_t duty_cycle, uint16_t timeout_ticks);
+
+/**
+ * @brief Queue a straight drive that follows a trapezoidal speed profile.
+ *
+ * The wheel speeds are controlled by the Speed_Controller driver, which must be updated after
+ * Motion_Update in every control tick. The Speed_Controller is disabled when the drive finishes.
+ * The speeds of the wheels differ by up to a quarter of the profile speed to hold the initial heading.
+ *
+ * @param distance_mm   The distance to drive. Positive values drive forward and negative values drive backward.
+ * @param max_speed     The maximum speed in mm/s.
+ * @param end_speed     The speed at the end of the drive in mm/s, or 0 to slow down to MOTION_PROFILE_MIN_SPEED.
+ * @param acceleration  The acceleration and deceleration in mm/s^2.
+ * @param timeout_ticks The maximum duration of the drive in control ticks, or 0 to use MOTION_DEFAULT_TIMEOUT_TICKS.
+ *
+ * @return 0 if the command has been queued, or -1 if the queue is full.
+ */
+int Motion_Drive_Profiled(int16_t distance_mm, uint16_t max_speed, uint16_t end_speed, uint16_t acceleration, uint16_t timeout_ticks);
+
+/**
+ * @brief Queue a forward arc turn at a constant speed.
+ *
+ * The wheel speeds are controlled by the Speed_Controller driver. The arc completes when the
+ * Odometry driver has measured the angle.
+ *
+ * @param degrees       The angle of the arc. Positive values turn left and negative values turn right.
+ * @param radius_mm     The radius of the arc measured at the center of the robot in mm.
+ * @param speed         The speed of the center of the robot in mm/s.
+ * @param timeout_ticks The maximum duration of the arc in control ticks, or 0 to use MOTION_DEFAULT_TIMEOUT_TICKS.
+ *
+ * @return 0 if the command has been queued, or -1 if the queue is full.
+ */
+int Motion_Arc(int16_t degrees, uint16_t radius_mm, uint16_t speed, uint16_t timeout_ticks);
+
+/**
+ * @brief Queue a stop that keeps the motors disabled for a number of control ticks.
+ *
+ * @param ticks The duration of the stop in control ticks.
+ *
+ * @return 0 if the command has been queued, or -1 if the queue is full.
+ */
+int Motion_Stop(uint16_t ticks);
+
+/**
+ * @brief Stop the motors immediately and discard the active command and every queued command.
+ *
+ * This function can be called by a controller when a sensor reading makes the current motion obsolete,
+ * for example when a wall shows up in front of the robot during a drive.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Motion_Abort();
+
+/**
+ * @brief Measure the heading of the active command from a reference heading instead of its initial heading.
+ *
+ * An in-place turn or an arc then ends when the robot has turned its angle from the reference heading, and a drive
+ * steers to the reference heading. This function can be called by a controller that follows a planned path,
+ * so that the heading errors of the previous commands do not add up. It does nothing when no command is active.
+ *
+ * @param heading The reference heading (binary angle, see Odometry.h).
+ *
+ * @return None
+ */
+void Motion_Set_Reference_Heading(uint32_t heading);
+
+/**
+ * @brief Change the distance that remains to be driven by the active drive or profiled drive.
+ *
+ * A profiled drive plans its deceleration on the new distance. A distance of 0 or less ends the drive in the next tick.
+ * It does nothing when the active command is not a drive.
+ *
+ * @param distance_mm The remaining distance from the current position.
+ *
+ * @return None
+ */
+void Motion_Set_Remaining_Distance(int32_t distance_mm);
+
+/**
+ * @brief Advance the motion executor by one control tick.
+ *
+ * This function must be called at a fixed rate. It never blocks.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Motion_Update();
+
+/**
+ * @brief Indicate if a command is active or waiting in the queue.
+ *
+ * @param None
+ *
+ * @return 1 if the executor is busy, or 0 if it is idle.
+ */
+uint8_t Motion_Is_Busy();
+
+/**
+ * @brief Return the number of commands waiting in the queue, without the active command.
+ *
+ * @param None
+ *
+ * @return The number of queued commands that have not started.
+ */
+uint8_t Motion_Get_Queued_Count();
+
+/**
+ * @brief Return the type of the active command.
+ *
+ * @param None
+ *
+ * @return The type of the active command, or MOTION_COMMAND_STOP if the executor is idle.
+ */
+Motion_Command_Type Motion_Get_Active_Type();
+
+/**
+ * @brief Return the result of the last command that has finished.
+ *
+ * @param None
+ *
+ * @return The result of the last finished command.
+ */
+Motion_Result Motion_Get_Last_Result();
+
+#endif /* INC_MOTION_H_ */
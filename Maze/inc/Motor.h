@@ -97,4 +97,19 @@ void Motor_Right(uint16_t left_duty_cycle, uint16_t right_duty_cycle);
  */
 void Motor_Stop();
 
+/**
+ * @brief Drive each motor with a signed duty cycle.
+ *
+ * This function selects the direction of each motor from the sign of its duty cycle
+ * (positive moves the wheel forward, negative moves it backward) and updates both duty cycles.
+ * It is used by closed-loop controllers that need to command each wheel independently.
+ *
+ * @param left_duty_cycle The signed duty cycle for the left motor (-14999 to 14999).
+ *
+ * @param right_duty_cycle The signed duty cycle for the right motor (-14999 to 14999).
+ *
+ * @return None
+ */
+void Motor_Drive(int16_t left_duty_cycle, int16_t right_duty_cycle);
+
 #endif /* INC_MOTOR_H_ */
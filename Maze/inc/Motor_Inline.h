@@ -0,0 +1,102 @@
+/**
+ * @file Motor_Inline.h
+ * @brief Header-only variants of the Motor and Timer_A0_PWM operations for the interrupt handlers.
+ *
+ * The functions of this file write the registers directly and are expanded at the call site, so an
+ * interrupt handler that stops or drives the motors does not pay for a call into Motor.c and then into
+ * Timer_A0_PWM.c. Motor_Stop and Motor_Drive are implemented with them, so both paths behave the same.
+ *
+ * @note They are kept out of Motor.h because the controllers that include Motor.h are also compiled on the
+ *       host by the simulator, whose msp.h has no registers.
+ *
+ */
+
+#ifndef INC_MOTOR_INLINE_H_
+#define INC_MOTOR_INLINE_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "Motor.h"
+
+/**
+ * @brief Update both Timer A0 duty cycles without a function call, for the interrupt handlers.
+ *
+ * Like Timer_A0_Update_Duty_Cycle_1 and Timer_A0_Update_Duty_Cycle_2, a duty cycle that is not
+ * less than the period in CCR[0] is ignored. The period is read once for both channels.
+ *
+ * @param duty_cycle_1 The new duty cycle for the PWM signal, P2.6 (PM_TA0.3, CCR[3])
+ *
+ * @param duty_cycle_2 The new duty cycle for the PWM signal, P2.7 (PM_TA0.4, CCR[4])
+ *
+ * @return None
+ */
+static inline void Timer_A0_Update_Duty_Cycles_Inline(uint16_t duty_cycle_1, uint16_t duty_cycle_2)
+{
+    uint16_t period = TIMER_A0->CCR[0];
+
+    if (duty_cycle_1 < period)
+    {
+        TIMER_A0->CCR[3] = duty_cycle_1;
+    }
+
+    if (duty_cycle_2 < period)
+    {
+        TIMER_A0->CCR[4] = duty_cycle_2;
+    }
+}
+
+/**
+ * @brief Stop the motors without a function call, for the interrupt handlers.
+ *
+ * Same as Motor_Stop, which is implemented with this function.
+ *
+ * @return None
+ */
+static inline void Motor_Stop_Inline(void)
+{
+    // Disable the motors by clearing Bits 6 and 7 of the OUT register for P3
+    // and clearing Bits 4 and 5 of the OUT register for P5
+    P3->OUT &= ~0xC0;
+    P5->OUT &= ~0x30;
+
+    // Update the duty cycle for both motors to 0%
+    Timer_A0_Update_Duty_Cycles_Inline(0, 0);
+}
+
+/**
+ * @brief Drive each motor with a signed duty cycle without a function call, for the interrupt handlers.
+ *
+ * Same as Motor_Drive, which is implemented with this function.
+ * Both direction bits are written with a single read-modify-write of the OUT register for P5.
+ *
+ * @param left_duty_cycle The signed duty cycle for the left motor (-14999 to 14999).
+ *
+ * @param right_duty_cycle The signed duty cycle for the right motor (-14999 to 14999).
+ *
+ * @return None
+ */
+static inline void Motor_Drive_Inline(int16_t left_duty_cycle, int16_t right_duty_cycle)
+{
+    uint8_t direction = 0x00;
+
+    // Bit 4 of the OUT register for P5 selects the direction of the left motor, and Bit 5 the right motor
+    if (left_duty_cycle < 0)
+    {
+        direction |= 0x10;
+        left_duty_cycle = -left_duty_cycle;
+    }
+    if (right_duty_cycle < 0)
+    {
+        direction |= 0x20;
+        right_duty_cycle = -right_duty_cycle;
+    }
+    P5->OUT = (P5->OUT & ~0x30) | direction;
+
+    // Update the duty cycle for both motors
+    Timer_A0_Update_Duty_Cycles_Inline(right_duty_cycle, left_duty_cycle);
+
+    // Enable the motors by setting Bits 6 and 7 of the OUT register for P3
+    P3->OUT |= 0xC0;
+}
+
+#endif /* INC_MOTOR_INLINE_H_ */
@@ -38,6 +38,8 @@
 #include <stdint.h>
 #include "msp.h"
 #include "Clock.h"
+#include "CortexM.h"
+#include "DMA.h"
 
 /**
  * @brief The SCREENW constant defines the width of the screen in pixels as 84.
@@ -100,6 +102,23 @@
  */
 #define CONTRAST   0xBF //used to be 0xA5 - Zelgehai
 
+/**
+ * @brief Number of 8-pixel tall pages (banks) of the display in the default horizontal addressing mode (V = 0).
+ */
+#define NOKIA5110_NUM_PAGES         (MAX_Y / 8)
+
+/**
+ * @brief uDMA channel, trigger source (eUSCI_A3 TX), and interrupt used by Nokia5110_DisplayBuffer_DMA.
+ */
+#define NOKIA5110_DMA_CHANNEL       6
+#define NOKIA5110_DMA_SOURCE        1
+#define NOKIA5110_DMA_INTERRUPT     2
+
+/**
+ * @brief Width of a character in columns: 5 columns of the font and 1 blank column on each side.
+ */
+#define NOKIA5110_GLYPH_WIDTH       7
+
 /**
  * @brief The ASCII table contains the hexadecimal values that represent
  * pixels for a font that is 5 pixels wide and 8 pixels high
@@ -209,6 +228,9 @@ void Nokia5110_Config();
  * This function initializes the Nokia5110 LCD by performing the SPI initialization, reset, and configuration.
  * It calls the respective functions for SPI initialization, reset, and configuration.
  *
+ * @note The other functions only draw in the RAM buffer until the LCD is initialized, so EUSCI_A3 can be used
+ *       by another driver (for example the Robot_Link module) when this function is not called.
+ *
  * @param None
  *
  * @return None
@@ -447,10 +469,12 @@ void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t
 void Nokia5110_ClearBuffer();
 
 /**
- * @brief The Nokia5110_DisplayBuffer function fills the whole screen by drawing a 48x84 screen image from the RAM buffer.
+ * @brief The Nokia5110_DisplayBuffer function updates the screen with the bytes of the RAM buffer that have changed.
  *
- * This function fills the entire screen of the Nokia 5110 LCD by drawing a 48x84 screen image from the RAM buffer.
- * The LCD is assumed to be in the default horizontal addressing mode (V = 0).
+ * Every function that writes to the RAM buffer records the range of columns that have changed in each page.
+ * This function sends only those ranges to the Nokia 5110 LCD using blocking SPI transfers, so updating a
+ * single character costs about 7 data bytes and 2 command bytes instead of a full-screen redraw of 504 bytes.
+ * If a DMA flush is in progress, this function waits for it to complete first.
  *
  * @param None
  *
@@ -460,6 +484,123 @@ void Nokia5110_ClearBuffer();
  */
 void Nokia5110_DisplayBuffer();
 
+/**
+ * @brief The Nokia5110_DMA_Init function prepares the uDMA channel used by Nokia5110_DisplayBuffer_DMA.
+ *
+ * This function assigns uDMA channel 6 to the eUSCI_A3 TX trigger and routes its completion interrupt
+ * to DMA_INT2. It must be called after Nokia5110_Init and only if Nokia5110_DisplayBuffer_DMA is used.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Nokia5110_DMA_Init();
+
+/**
+ * @brief The Nokia5110_DisplayBuffer_DMA function starts sending the changed bytes of the RAM buffer using the uDMA controller.
+ *
+ * This function returns immediately. Each page that has changed is sent as one DMA transfer, and the DMA_INT2
+ * interrupt starts the transfer of the next changed page until the whole buffer has been flushed.
+ * The function has no effect if a DMA flush is already in progress. Bytes that are changed during a flush
+ * are sent by the next flush.
+ *
+ * @param None
+ *
+ * @return None
+ *
+ * @note The blocking Nokia5110_Command_Write, Nokia5110_Data_Write, and Nokia5110_Out* functions
+ *       must not be called while Nokia5110_Flush_Busy returns 1.
+ */
+void Nokia5110_DisplayBuffer_DMA();
+
+/**
+ * @brief The Nokia5110_Flush_Busy function indicates if a DMA flush of the RAM buffer is in progress.
+ *
+ * @param None
+ *
+ * @return 1 if a DMA flush is in progress, or 0 otherwise.
+ */
+uint8_t Nokia5110_Flush_Busy();
+
+/**
+ * @brief The Nokia5110_Invalidate function marks the whole RAM buffer as changed.
+ *
+ * The next call to Nokia5110_DisplayBuffer or Nokia5110_DisplayBuffer_DMA redraws the full screen.
+ * Use it after writing to the LCD directly with the blocking Nokia5110_Out* functions.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Nokia5110_Invalidate();
+
+/**
+ * @brief The Nokia5110_Buffer_SetCursor function moves the cursor of the RAM buffer text functions.
+ *
+ * @param newX New X-position of the cursor (0 to 11). Each character is 7 columns wide.
+ * @param newY New Y-position of the cursor (0 to 5).
+ *
+ * @return None
+ */
+void Nokia5110_Buffer_SetCursor(uint8_t newX, uint8_t newY);
+
+/**
+ * @brief The Nokia5110_Buffer_OutChar function prints a character to the RAM buffer.
+ *
+ * This function is the RAM buffer version of Nokia5110_OutChar. The character appears on the screen
+ * after the next call to Nokia5110_DisplayBuffer or Nokia5110_DisplayBuffer_DMA. Only the columns whose
+ * pixels actually change are marked as changed. The cursor wraps to the next row at the right edge.
+ *
+ * @param data The character to print.
+ *
+ * @return None
+ */
+void Nokia5110_Buffer_OutChar(char data);
+
+/**
+ * @brief The Nokia5110_Buffer_OutString function prints a string of characters to the RAM buffer.
+ *
+ * @param ptr Pointer to a NULL-terminated ASCII string.
+ *
+ * @return None
+ */
+void Nokia5110_Buffer_OutString(char *ptr);
+
+/**
+ * @brief The Nokia5110_Buffer_OutUDec function prints a 16-bit number in unsigned decimal format to the RAM buffer.
+ *
+ * The output has a fixed size of five right-justified digits, like Nokia5110_OutUDec.
+ *
+ * @param n The 16-bit unsigned number to be displayed.
+ *
+ * @return None
+ */
+void Nokia5110_Buffer_OutUDec(uint16_t n);
+
+/**
+ * @brief The Nokia5110_Get_Glyph function returns the columns of a character, including its blank padding.
+ *
+ * @param data  The character to be converted (0x20 to 0x7F).
+ * @param glyph Pointer to store the NOKIA5110_GLYPH_WIDTH columns of the character.
+ *
+ * @return None
+ */
+void Nokia5110_Get_Glyph(char data, uint8_t glyph[NOKIA5110_GLYPH_WIDTH]);
+
+/**
+ * @brief The Nokia5110_Buffer_Draw_Glyph function writes the columns of a character to the RAM buffer.
+ *
+ * Unlike Nokia5110_Buffer_OutChar, this function does not look up the font and does not move the cursor.
+ * Only the columns whose value is different are sent by the next flush.
+ *
+ * @param newX  X-position of the character (0 to 11). Each character is 7 columns wide.
+ * @param newY  Y-position of the character (0 to 5).
+ * @param glyph Pointer to the NOKIA5110_GLYPH_WIDTH columns returned by Nokia5110_Get_Glyph.
+ *
+ * @return None
+ */
+void Nokia5110_Buffer_Draw_Glyph(uint8_t newX, uint8_t newY, const uint8_t glyph[NOKIA5110_GLYPH_WIDTH]);
+
 /**
  * @brief The Nokia5110_ClrPxl function clears the internal screen buffer pixel at position (i, j), turning it off.
  *
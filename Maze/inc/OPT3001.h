@@ -22,6 +22,12 @@
  *
  * @note Do not use with bumper sensors to avoid any pin conflicts.
  *
+ * @note With OPT3001_Acquisition_Init, the sensor converts continuously and compares every result with a window
+ *       around the last lux value reported. The INT output latches low when a result leaves the window, and this
+ *       edge starts a chain of EUSCI_B1 transactions executed by the interrupts: read the result, center the window
+ *       on it, and read the configuration register to release INT. The lux value is therefore only read when it
+ *       has changed by more than OPT3001_WINDOW_PERCENT.
+ *
  * @note For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
  * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
  *
@@ -41,6 +47,25 @@
 
 #define OPT3001_ADDRESS 0x44
 
+// SCL frequency of the sensor on the EUSCI_B1 bus in Hz
+// Note: The OPT3001 also supports the 2.6 MHz high-speed mode, which needs a master code that the eUSCI does not send
+#ifndef OPT3001_I2C_SCL_HZ
+#define OPT3001_I2C_SCL_HZ      400000
+#endif
+
+// P4 bit of the INT output
+#define OPT3001_INT_PIN         0x04
+
+// Half-width of the window around the last reported value, in percent of the value
+#ifndef OPT3001_WINDOW_PERCENT
+#define OPT3001_WINDOW_PERCENT  20
+#endif
+
+// Smallest half-width of the window in 0.01 lux, so that the noise in the dark does not generate interrupts
+#ifndef OPT3001_WINDOW_MIN_CENTI_LUX
+#define OPT3001_WINDOW_MIN_CENTI_LUX    500
+#endif
+
 /**
  * @brief The struct is used to define the individual bit fields within RawData
  * when it is being interpreted as a struct value
@@ -98,4 +123,64 @@ void OPT3001_Init();
  */
 OPT3001_Result OPT3001_Read_Light(void);
 
+/**
+ * @brief Convert a result to lux.
+ *
+ * @param result The result read from the OPT3001.
+ *
+ * @return The light intensity in 0.01 lux (0.01 * (2^Exponent) * Result lux).
+ */
+uint32_t OPT3001_Get_Centi_Lux(OPT3001_Result result);
+
+/**
+ * @brief Start the continuous conversions with a window comparison, and report the lux changes from the interrupts.
+ *
+ * The first conversion is always outside the initial window, so the first value is reported after about 100 ms.
+ * OPT3001_Init must be called first, before the EUSCI_B1 transactions are queued by other drivers, and
+ * OPT3001_Handle_Interrupt must be executed by the PORT4 interrupt on a falling edge of P4.2.
+ *
+ * @param handler Function executed from the EUSCI_B1 interrupt with the new value in 0.01 lux.
+ *
+ * @return None
+ */
+void OPT3001_Acquisition_Init(void (*handler)(uint32_t centi_lux));
+
+/**
+ * @brief Start reading the result after a falling edge of the INT output, called from the PORT4 interrupt.
+ *
+ * @param port_flags The P4 interrupt flags that were set (OPT3001_INT_PIN).
+ *
+ * @return None
+ */
+void OPT3001_Handle_Interrupt(uint8_t port_flags);
+
+/**
+ * @brief Restart the read if INT is still low while no transaction is queued, for example after a full EUSCI_B1 queue.
+ *
+ * Only the P4.2 input is read, so this task does not access the bus while the light does not change.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void OPT3001_Acquisition_Task(void);
+
+/**
+ * @brief Return the last value reported.
+ *
+ * @param None
+ *
+ * @return The light intensity in 0.01 lux.
+ */
+uint32_t OPT3001_Get_Last_Centi_Lux(void);
+
+/**
+ * @brief Return the number of reads that could not be queued or were not acknowledged.
+ *
+ * @param None
+ *
+ * @return The number of errors since OPT3001_Acquisition_Init.
+ */
+uint32_t OPT3001_Get_Errors(void);
+
 #endif /* INC_OPT3001_H_ */
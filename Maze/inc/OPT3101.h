@@ -65,6 +65,39 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <msp.h>
 #include "../inc/Clock.h"
 #include "../inc/EUSCI_B1_I2C.h"
+#include "../inc/CortexM.h"
+#include "Memory_Config.h"
+
+// Codes stored instead of the distance when a measurement is not valid
+#define OPT3101_DISTANCE_UNDERFLOW      65533
+#define OPT3101_DISTANCE_LOW_AMPLITUDE  65534
+#define OPT3101_DISTANCE_ERROR          65535
+
+// Low time of the reset pulse, time before the first register read after the reset,
+// and longest time to load the settings from the EEPROM, in us
+#define OPT3101_RESET_TIME_US           1000
+#define OPT3101_BOOT_TIME_US            1000
+#define OPT3101_READY_TIMEOUT_US        50000
+
+// SCL frequency of the sensor on the EUSCI_B1 bus in Hz (the OPT3101 supports the 400 kHz fast mode)
+#ifndef OPT3101_I2C_SCL_HZ
+#define OPT3101_I2C_SCL_HZ              400000
+#endif
+
+// Number of OPT3101_Acquisition_Task calls without a DATA_RDY interrupt before a measurement is restarted
+#define OPT3101_ACQUISITION_TIMEOUT     10
+
+/**
+ * Sample stored by the background acquisition. Distance is in mm or one of the
+ * OPT3101_DISTANCE_ codes, and Timestamp is the DWT cycle count (MCLK) of the
+ * DATA_RDY rising edge.
+ */
+typedef struct
+{
+    uint32_t Timestamp;
+    uint16_t Distance;
+    uint16_t Amplitude;
+} OPT3101_Sample;
 
 /**
  * Resets the OPT3101 distance sensor using its reset line and then waits for
@@ -76,6 +109,38 @@ policies, either expressed or implied, of the FreeBSD Project.
 void OPT3101_Init(void);
 
 
+/**
+ * Drives the reset line of the OPT3101 low and returns, so that the other
+ * peripherals can be initialized during the reset pulse.
+ * CycleCounter_Init must have been called.
+ * @param  none
+ * @return none
+ * @brief  Start the reset of the OPT3101.
+ */
+void OPT3101_Reset_Start(void);
+
+
+/**
+ * Releases the reset line after the remaining part of OPT3101_RESET_TIME_US
+ * since OPT3101_Reset_Start, and configures the DATA_RDY input.
+ * @param  none
+ * @return none
+ * @brief  Release the reset of the OPT3101.
+ */
+void OPT3101_Reset_Release(void);
+
+
+/**
+ * Polls INIT_LOAD_DONE until the OPT3101 has loaded its initial settings
+ * from the on-board EEPROM memory. The first read is OPT3101_BOOT_TIME_US
+ * after OPT3101_Reset_Release.
+ * @param  timeout_us the longest time to wait in us
+ * @return 0 if the OPT3101 is ready, or -1 after timeout_us
+ * @brief  Wait until the OPT3101 is ready.
+ */
+int OPT3101_Wait_Ready(uint32_t timeout_us);
+
+
 /**
  * Writes some settings to the OPT3101 which are generally necessary to use
  * the other parts of this library.
@@ -230,3 +295,45 @@ uint32_t OPT3101_GetMeasurement(uint32_t distances[3], uint32_t amplitudes[3]);
  * @brief  get measurements from last measurement
  */
 void OPT3101_ArmInterrupts(uint32_t *pTxChan, uint32_t distances[3], uint32_t amplitudes[3]);
+
+/**
+ * Starts the background acquisition. The channels 0, 1 and 2 are measured in turn.
+ * On a DATA_RDY interrupt, the result registers are read with queued EUSCI_B1
+ * transactions and the next channel is started from the EUSCI_B1 interrupt, so the
+ * CPU never waits for the bus. Each sample is stored with its validity code in
+ * the ring buffer of its channel.<br>
+ * OPT3101_Init, OPT3101_Setup and OPT3101_CalibrateInternalCrosstalk must be called
+ * first. OPT3101_ArmInterrupts must not be used at the same time.
+ * @param  none
+ * @return none
+ * @brief  Start background channel-cycled measurements
+ */
+void OPT3101_Acquisition_Init(void);
+
+/**
+ * Restarts the acquisition when no DATA_RDY interrupt has been received for
+ * OPT3101_ACQUISITION_TIMEOUT calls, for example after an I2C error.
+ * Call it periodically (for example, from the SysTick interrupt).
+ * @param  none
+ * @return none
+ * @brief  Acquisition watchdog
+ */
+void OPT3101_Acquisition_Task(void);
+
+/**
+ * Returns the number of samples stored for a channel since the acquisition started.
+ * @param  channel is 0,1,2
+ * @return number of samples
+ * @brief  sample counter of a channel
+ */
+uint32_t OPT3101_Get_Sample_Count(uint32_t channel);
+
+/**
+ * Copies a sample from the ring buffer of a channel.
+ * @param  channel is 0,1,2
+ * @param  age is 0 for the latest sample, up to OPT3101_RING_LENGTH - 1
+ * @param  sample pointer to store the sample
+ * @return 0 if the sample exists, -1 otherwise
+ * @brief  read a stored sample
+ */
+int OPT3101_Get_Sample(uint32_t channel, uint32_t age, OPT3101_Sample *sample);
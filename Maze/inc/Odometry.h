@@ -0,0 +1,150 @@
+/**
+ * @file Odometry.h
+ * @brief Header file for the Odometry driver.
+ *
+ * This file contains the function definitions for the Odometry driver.
+ * It estimates the pose (x, y, heading) of the differential-drive robot from the tachometer
+ * step counts using fixed-point arithmetic only. Odometry_Update must be called at the control rate
+ * (for example, from the SysTick interrupt) and takes a few microseconds.
+ *
+ * Units:
+ *  - Position: um, relative to the pose given to Odometry_Reset. X points along the initial heading.
+ *  - Heading: binary angle, where 2^32 is one full turn (0x40000000 = 90 degrees, counterclockwise is positive).
+ *    Heading arithmetic wraps naturally, and the difference of two headings cast to int32_t is
+ *    the signed angle between them.
+ *
+ * Robot geometry of the TI-RSLK MAX chassis:
+ *  - 0.611 mm per tachometer step (70 mm wheel diameter, 360 steps per revolution)
+ *  - Wheel base: 140 mm, so a difference of one step between the wheels rotates the robot by 0.25 degrees
+ *
+ */
+
+#ifndef INC_ODOMETRY_H_
+#define INC_ODOMETRY_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Tachometer.h"
+
+// Distance traveled by a wheel for each tachometer step in um
+#define ODOMETRY_UM_PER_STEP            TACHOMETER_UM_PER_STEP
+
+// Distance between the two wheels in um
+#define ODOMETRY_WHEEL_BASE_UM          140000
+
+// Change of heading caused by a difference of one step between the wheels
+// (ODOMETRY_UM_PER_STEP / ODOMETRY_WHEEL_BASE_UM) * (2^32 / (2 * pi)), with pi = 3.141593
+#define ODOMETRY_HEADING_PER_STEP       ((uint32_t)(((((uint64_t)ODOMETRY_UM_PER_STEP << 32) / ODOMETRY_WHEEL_BASE_UM) * 1000000) / \
+                                                    (2ULL * 3141593)))
+
+// Binary angle of one degree (2^32 / 360)
+#define ODOMETRY_HEADING_ONE_DEGREE     11930465
+
+// Binary angles of the four cardinal headings
+#define ODOMETRY_HEADING_0              0x00000000
+#define ODOMETRY_HEADING_90             0x40000000
+#define ODOMETRY_HEADING_180            0x80000000
+#define ODOMETRY_HEADING_270            0xC0000000
+
+/**
+ * @brief Pose of the robot.
+ */
+typedef struct
+{
+    int32_t X_um;
+    int32_t Y_um;
+    uint32_t Heading;
+} Odometry_Pose;
+
+/**
+ * @brief Initialize the Odometry driver at the origin with a heading of 0.
+ *
+ * The Tachometer driver must be initialized before this function is called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Odometry_Init();
+
+/**
+ * @brief Set the current pose, for example after aligning the robot with a wall.
+ *
+ * @param pose Pointer to the new pose.
+ *
+ * @return None
+ */
+void Odometry_Reset(const Odometry_Pose *pose);
+
+/**
+ * @brief Update the pose using the steps counted since the previous update.
+ *
+ * The distance traveled is applied along the average of the previous and the new heading.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Odometry_Update();
+
+/**
+ * @brief Return a consistent copy of the current pose.
+ *
+ * @param pose Pointer to store the current pose.
+ *
+ * @return None
+ */
+void Odometry_Get_Pose(Odometry_Pose *pose);
+
+/**
+ * @brief Return the distance traveled by the center of the robot since Odometry_Init.
+ *
+ * It is not changed by Odometry_Reset, so the distance between two events can be measured across a reset of the pose.
+ * The distance wraps around after 2147 m.
+ *
+ * @param None
+ *
+ * @return The distance in um, the distance driven backwards is subtracted.
+ */
+int32_t Odometry_Get_Distance_um();
+
+/**
+ * @brief Return the current heading.
+ *
+ * @param None
+ *
+ * @return The current heading as a binary angle.
+ */
+uint32_t Odometry_Get_Heading();
+
+/**
+ * @brief Convert a binary angle to signed degrees.
+ *
+ * @param angle The binary angle.
+ *
+ * @return The angle in degrees (-180 to 179).
+ */
+int16_t Odometry_Angle_To_Degrees(uint32_t angle);
+
+/**
+ * @brief Calculate the sine of a binary angle.
+ *
+ * A 65-entry quarter-wave table is used with linear interpolation (error below 0.0002).
+ *
+ * @param angle The binary angle.
+ *
+ * @return The sine of the angle in Q15 format (-32767 to 32767).
+ */
+int16_t Odometry_Sin(uint32_t angle);
+
+/**
+ * @brief Calculate the cosine of a binary angle.
+ *
+ * @param angle The binary angle.
+ *
+ * @return The cosine of the angle in Q15 format (-32767 to 32767).
+ */
+int16_t Odometry_Cos(uint32_t angle);
+
+#endif /* INC_ODOMETRY_H_ */
@@ -34,6 +34,8 @@
 #include "msp.h"
 #include "EUSCI_B1_I2C.h"
 #include "Clock.h"
+#include "CortexM.h"
+#include "Snapshot.h"
 
 typedef struct
 {
@@ -48,6 +50,26 @@ typedef struct
     PMOD_Color_Data min, max;
 } PMOD_Calibration_Data;
 
+// Offsets and Q16 scale factors computed from the calibration data by PMOD_Color_Update_Normalization
+// A normalized channel is ((sample - min) * scale) >> 16, so a sample does not need any divide
+typedef struct
+{
+    PMOD_Color_Data min;
+    uint32_t scale_red;
+    uint32_t scale_green;
+    uint32_t scale_blue;
+    uint32_t scale_clear;
+} PMOD_Color_Normalization;
+
+// Latest result of the background acquisition pipeline, and the cycle count at which it was read
+typedef struct
+{
+    PMOD_Color_Data raw;
+    PMOD_Color_Data normalized;
+    uint32_t sample_count;
+    uint32_t timestamp_cycles;
+} PMOD_Color_Snapshot;
+
 // Default I2C address for the PMOD COLOR
 #define PMOD_COLOR_ADDRESS                      0x29
 
@@ -89,6 +111,23 @@ typedef struct
 #define PMOD_COLOR_ENABLE_POWER_ON              0x01
 #define PMOD_COLOR_ENABLE_RGBC                  0x02
 
+// STATUS register: RGBC channels have completed an integration cycle
+#define PMOD_COLOR_STATUS_AVALID                0x01
+
+// Integration time with the default ATIME value of 0xFF (2.4 ms)
+#define PMOD_COLOR_INTEGRATION_TIME_US          2400
+
+// Oscillator warm-up time after PON before the RGBC ADC can be enabled (TCS3472 datasheet)
+#define PMOD_COLOR_WARM_UP_TIME_US              2400
+
+// Longest wait for the first integration cycle: two integration times
+#define PMOD_COLOR_READY_TIMEOUT_US             (2 * PMOD_COLOR_INTEGRATION_TIME_US)
+
+// SCL frequency of the sensor on the EUSCI_B1 bus in Hz (the TCS3472 supports the 400 kHz fast mode)
+#ifndef PMOD_COLOR_I2C_SCL_HZ
+#define PMOD_COLOR_I2C_SCL_HZ                   400000
+#endif
+
 #define PMOD_COLOR_ENABLE_LED                   0x01
 #define PMOD_COLOR_DISABLE_LED                  0x00
 
@@ -96,8 +135,21 @@ void PMOD_Color_Write_Register(uint8_t register_address, uint8_t register_data);
 
 uint8_t PMOD_Color_Read_Register(uint8_t register_address);
 
+// Powers on the sensor and completes the initialization with PMOD_Color_Start and PMOD_Color_Wait_Ready
+// CycleCounter_Init must have been called before PMOD_Color_Init or PMOD_Color_Power_On
 void PMOD_Color_Init();
 
+// Initializes EUSCI_B1 and powers on the sensor, then returns during the oscillator warm-up
+// so that the other peripherals can be initialized meanwhile
+void PMOD_Color_Power_On();
+
+// Enables the RGBC ADC and the LED pin, after the remaining part of the warm-up since PMOD_Color_Power_On
+void PMOD_Color_Start();
+
+// Polls the AVALID bit of the STATUS register until the first integration cycle has completed
+// Returns 0 when a sample is valid, or -1 after timeout_us
+int PMOD_Color_Wait_Ready(uint32_t timeout_us);
+
 void PMOD_Color_LED_Init();
 
 void PMOD_Color_LED_Control(uint8_t led_enable);
@@ -112,8 +164,35 @@ PMOD_Color_Data PMOD_Color_Get_RGBC();
 
 PMOD_Calibration_Data PMOD_Color_Init_Calibration_Data(PMOD_Color_Data first_sample);
 
-void PMOD_Color_Calibrate(PMOD_Color_Data new_sample, PMOD_Calibration_Data *calibration_data);
+// Returns 1 if the minimum or the maximum of a channel has changed, or 0 otherwise
+uint8_t PMOD_Color_Calibrate(PMOD_Color_Data new_sample, PMOD_Calibration_Data *calibration_data);
 
+// Scales the sample to 0 - 0xFFFF between the minimum and the maximum of each channel (0 if they are equal)
+// Note: Computes the scale factors at every call, use PMOD_Color_Normalize for repeated samples
 PMOD_Color_Data PMOD_Color_Normalize_Calibration(PMOD_Color_Data sample, PMOD_Calibration_Data calibration_data);
 
+// Computes the scale factors once per calibration update (four divides)
+void PMOD_Color_Update_Normalization(PMOD_Calibration_Data calibration_data, PMOD_Color_Normalization *normalization);
+
+// Scales the sample with the precomputed scale factors (four multiplies)
+PMOD_Color_Data PMOD_Color_Normalize(PMOD_Color_Data sample, const PMOD_Color_Normalization *normalization);
+
+// Background acquisition pipeline
+// PMOD_Color_Acquisition_Task must be called periodically at an interval longer than the integration time.
+// Each call queues one EUSCI_B1 transaction that reads the STATUS and RGBC registers. When it completes,
+// the EUSCI_B1 interrupt calibrates and normalizes the sample and publishes it as the latest snapshot.
+// The scale factors are only recomputed when the calibration changes.
+void PMOD_Color_Acquisition_Init();
+
+void PMOD_Color_Acquisition_Task();
+
+void PMOD_Color_Get_Snapshot(PMOD_Color_Snapshot *snapshot);
+
+// Restores a calibration saved by a previous run (call after PMOD_Color_Acquisition_Init)
+// The first sample then extends the restored calibration instead of replacing it
+void PMOD_Color_Set_Calibration(PMOD_Calibration_Data calibration_data);
+
+// Returns a copy of the calibration of the acquisition pipeline, for example to save it in flash
+PMOD_Calibration_Data PMOD_Color_Get_Calibration();
+
 #endif /* INC_PMOD_COLOR_H_ */
@@ -0,0 +1,136 @@
+/**
+ * @file Parameters.h
+ * @brief Header file for the Parameters module.
+ *
+ * This file contains the function definitions for the Parameters module.
+ * It keeps a registry of named runtime parameters that can be read and changed over EUSCI_A0
+ * while the robot is running, so that the controllers can be tuned without reflashing.
+ *
+ * Protocol (one command per line, terminated by CR or LF, arguments separated by spaces):
+ *  - list                  Print every parameter as "name=value min max"
+ *  - get <name>            Print "name=value"
+ *  - set <name> <value>    Change a parameter, printed back as "ok name=value"
+ *  - save                  Save every parameter in the flash store, printed back as "ok save"
+ *  - Errors are printed as "err <reason>"
+ *  - The other commands are passed to the handler selected by Parameters_Set_Command_Handler, if any
+ *
+ * The received bytes are stored in the RX ring buffer by the EUSCI_A0 interrupt, and Parameters_Task parses
+ * the lines in the background. A new value is only copied to the parameter by Parameters_Apply, at the start
+ * of the next control tick, so a controller never sees a value change during its execution.
+ *
+ * @note The values are signed 32-bit integers. A parameter may have an apply function, called by Parameters_Apply
+ *       after its value has changed, for example to reconfigure a driver.
+ *
+ */
+
+#ifndef INC_PARAMETERS_H_
+#define INC_PARAMETERS_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "EUSCI_A0_UART.h"
+#include "Flash_Store.h"
+
+// Largest number of parameters in the registry
+#define PARAMETERS_MAX_COUNT            32
+
+// Longest command line in characters
+#define PARAMETERS_MAX_LINE_LENGTH      48
+
+// Longest reply line in characters, including the terminating null character
+#define PARAMETERS_MAX_REPLY_LENGTH     64
+
+// Largest number of words of a command line passed to the command handler
+#define PARAMETERS_MAX_ARGUMENTS        5
+
+/**
+ * @brief Entry of the parameter registry.
+ */
+typedef struct
+{
+    const char *Name;
+    int32_t *Value;
+    int32_t Min;
+    int32_t Max;
+    void (*Apply)(void);
+} Parameter;
+
+/**
+ * @brief Select the registry and enable the EUSCI_A0 RX interrupt.
+ *
+ * @param registry Pointer to the parameter entries (kept by the module).
+ * @param count    The number of entries (up to PARAMETERS_MAX_COUNT).
+ * @param output   The function that sends a reply line (without line ending).
+ *
+ * @return None
+ */
+void Parameters_Init(const Parameter *registry, uint8_t count, void (*output)(const char *line));
+
+/**
+ * @brief Select the function that executes the commands that are not parameter commands.
+ *
+ * The handler is called by Parameters_Task with the words of the command line (up to PARAMETERS_MAX_ARGUMENTS), and sends
+ * its own replies. The command is answered with "err command" if the handler returns -1.
+ *
+ * @param handler The function that executes a command and returns 0, or -1 if the command is unknown (0 if none).
+ *
+ * @return None
+ */
+void Parameters_Set_Command_Handler(int (*handler)(char **arguments, uint8_t argument_count));
+
+/**
+ * @brief Parse a signed decimal number, for example an argument of a command.
+ *
+ * @param text  The null-terminated string.
+ * @param value Pointer to store the number.
+ *
+ * @return 0 if the whole string is a number in the int32_t range, or -1 otherwise.
+ */
+int Parameters_Parse_Value(const char *text, int32_t *value);
+
+/**
+ * @brief Parse the command lines received since the previous call, executed in the background.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Parameters_Task(void);
+
+/**
+ * @brief Copy the values changed by the set commands to the parameters and call their apply functions.
+ *
+ * Must be called at the start of the control tick.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Parameters_Apply(void);
+
+/**
+ * @brief Save the values of every parameter in the flash store (FLASH_STORE_KEY_PARAMETERS).
+ *
+ * The record also contains a signature of the names, so that a registry with other parameters
+ * does not restore the values of a previous program.
+ *
+ * @param None
+ *
+ * @return 0 if the values have been saved, or -1 if the flash cannot be programmed.
+ */
+int Parameters_Save(void);
+
+/**
+ * @brief Restore the values saved by Parameters_Save, within the range of each parameter.
+ *
+ * Must be called after Parameters_Init and Flash_Store_Init. Like the set commands, the values
+ * are copied to the parameters and their apply functions are called by the next Parameters_Apply.
+ *
+ * @param None
+ *
+ * @return 0 if the values have been restored, or -1 if there is no record for this registry.
+ */
+int Parameters_Restore(void);
+
+#endif /* INC_PARAMETERS_H_ */
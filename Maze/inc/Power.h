@@ -0,0 +1,79 @@
+/**
+ * @file Power.h
+ * @brief Header file for the Power driver.
+ *
+ * This file contains the function definitions for the Power driver.
+ * It selects LPM0 as the sleep mode entered by WaitForInterrupt, and puts the modules that are not used
+ * by the program in their lowest power state.
+ *
+ * Sleep mode:
+ *  - In LPM0, the CPU clock (MCLK) is stopped and the other clocks and peripherals keep running, so every
+ *    interrupt wakes up the CPU within a few cycles. The core voltage (AM_LDO_VCORE1) required for 48 MHz is kept.
+ *  - LPM3 and LPM4 are not used: they stop SMCLK and HSMCLK, which clock the timers, the ADC, and the serial ports.
+ *  - Sleep-on-exit is disabled, since the background tasks run in the main loop after the interrupt that released them.
+ *
+ * Unused modules:
+ *  - A serial port is held in reset (UCSWRST), a timer is stopped, the ADC, the reference, and the comparators are
+ *    turned off. A stopped module does not request its clock, so the clock tree is only active for the used modules.
+ *  - ACLK can be disabled when no module is clocked by it (the program uses SMCLK and HSMCLK only).
+ *  - The module must not be initialized again after it has been disabled.
+ *
+ */
+
+#ifndef INC_POWER_H_
+#define INC_POWER_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+// Modules that can be disabled by Power_Disable_Modules
+#define POWER_MODULE_EUSCI_A0       0x00000001
+#define POWER_MODULE_EUSCI_A1       0x00000002
+#define POWER_MODULE_EUSCI_A2       0x00000004
+#define POWER_MODULE_EUSCI_A3       0x00000008
+#define POWER_MODULE_EUSCI_B0       0x00000010
+#define POWER_MODULE_EUSCI_B1       0x00000020
+#define POWER_MODULE_EUSCI_B2       0x00000040
+#define POWER_MODULE_EUSCI_B3       0x00000080
+#define POWER_MODULE_TIMER_A0       0x00000100
+#define POWER_MODULE_TIMER_A1       0x00000200
+#define POWER_MODULE_TIMER_A2       0x00000400
+#define POWER_MODULE_TIMER_A3       0x00000800
+#define POWER_MODULE_TIMER32_1      0x00001000
+#define POWER_MODULE_TIMER32_2      0x00002000
+#define POWER_MODULE_ADC14          0x00004000
+#define POWER_MODULE_REF_A          0x00008000
+#define POWER_MODULE_COMP_E0        0x00010000
+#define POWER_MODULE_COMP_E1        0x00020000
+#define POWER_MODULE_ACLK           0x00040000
+
+/**
+ * @brief Select LPM0 as the sleep mode of WaitForInterrupt.
+ *
+ * Clears the SLEEPDEEP and SLEEPONEXIT bits of the System Control Register.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Power_Init(void);
+
+/**
+ * @brief Put the selected modules in their lowest power state.
+ *
+ * @param modules A combination of POWER_MODULE_* flags.
+ *
+ * @return None
+ */
+void Power_Disable_Modules(uint32_t modules);
+
+/**
+ * @brief Return the modules disabled by Power_Disable_Modules.
+ *
+ * @param None
+ *
+ * @return A combination of POWER_MODULE_* flags.
+ */
+uint32_t Power_Get_Disabled_Modules(void);
+
+#endif /* INC_POWER_H_ */
@@ -16,6 +16,7 @@
 #include <stdint.h>
 #include "msp.h"
 #include "EUSCI_A0_UART.h"
+#include "Print_Format.h"
 
 /**
  * @brief Prints the binary representation of an 8-bit value.
@@ -0,0 +1,114 @@
+/**
+ * @file Print_Format.h
+ * @brief Header file for the Print_Format module.
+ *
+ * This file contains the function definitions for the Print_Format module.
+ * It is a small integer-only replacement for printf and snprintf that writes straight into the
+ * EUSCI_A0 TX ring buffer, so the C library formatter and the stdio device are not linked in.
+ *
+ * Supported conversions: %d, %i, %u, %x, %X, %c, %s, and %%, with the '-' and '0' flags, a width,
+ * and the 'l' and 'h' length modifiers (the arguments are 32-bit). Floating-point conversions are not supported.
+ *
+ * Like the stdio device of EUSCI_A0_UART_Write, every '\n' sent to the UART is preceded by '\r'.
+ * The bytes are dropped when the TX ring buffer is full.
+ *
+ * A format string that only joins literals and integers can be split at the call site with the PRINT_
+ * macros, so the format is not parsed at run time:
+ *
+ *     PRINT_LITERAL("Left: "); Print_SDec(left); PRINT_LITERAL(" mm\n");
+ *
+ */
+
+#ifndef INC_PRINT_FORMAT_H_
+#define INC_PRINT_FORMAT_H_
+
+#include <stdint.h>
+#include <stdarg.h>
+
+// Send a string literal, whose length is known at compile time
+#define PRINT_LITERAL(literal)          Print_Literal((literal), sizeof(literal) - 1)
+
+// Send a string literal followed by a signed or an unsigned decimal number
+#define PRINT_SDEC(literal, value)      do { PRINT_LITERAL(literal); Print_SDec(value); } while (0)
+#define PRINT_UDEC(literal, value)      do { PRINT_LITERAL(literal); Print_UDec(value); } while (0)
+
+/**
+ * @brief Send a formatted string to EUSCI_A0.
+ *
+ * @param format The format string, followed by the arguments of its conversions.
+ *
+ * @return The number of characters of the formatted string, not counting the added '\r'.
+ */
+int Print_Format(const char *format, ...);
+
+/**
+ * @brief Send a formatted string to EUSCI_A0 with a list of arguments.
+ *
+ * @param format    The format string.
+ * @param arguments The arguments of its conversions.
+ *
+ * @return The number of characters of the formatted string, not counting the added '\r'.
+ */
+int Print_Format_V(const char *format, va_list arguments);
+
+/**
+ * @brief Write a formatted string to a buffer, like snprintf.
+ *
+ * @param buffer Pointer to store the null-terminated string.
+ * @param size   The size of the buffer in bytes. The string is truncated to size - 1 characters.
+ * @param format The format string, followed by the arguments of its conversions.
+ *
+ * @return The number of characters of the formatted string, including the truncated ones.
+ */
+int Print_Format_To_Buffer(char *buffer, uint32_t size, const char *format, ...);
+
+/**
+ * @brief Write a formatted string to a buffer with a list of arguments, like vsnprintf.
+ *
+ * @param buffer    Pointer to store the null-terminated string.
+ * @param size      The size of the buffer in bytes. The string is truncated to size - 1 characters.
+ * @param format    The format string.
+ * @param arguments The arguments of its conversions.
+ *
+ * @return The number of characters of the formatted string, including the truncated ones.
+ */
+int Print_Format_To_Buffer_V(char *buffer, uint32_t size, const char *format, va_list arguments);
+
+/**
+ * @brief Send a block of characters to EUSCI_A0 without parsing it, used by PRINT_LITERAL.
+ *
+ * @param text   Pointer to the characters.
+ * @param length The number of characters.
+ *
+ * @return None
+ */
+void Print_Literal(const char *text, uint32_t length);
+
+/**
+ * @brief Send a null-terminated string to EUSCI_A0 without parsing it.
+ *
+ * @param text Pointer to the string.
+ *
+ * @return None
+ */
+void Print_String(const char *text);
+
+/**
+ * @brief Send an unsigned decimal number to EUSCI_A0.
+ *
+ * @param value The number.
+ *
+ * @return None
+ */
+void Print_UDec(uint32_t value);
+
+/**
+ * @brief Send a signed decimal number to EUSCI_A0.
+ *
+ * @param value The number.
+ *
+ * @return None
+ */
+void Print_SDec(int32_t value);
+
+#endif /* INC_PRINT_FORMAT_H_ */
@@ -0,0 +1,159 @@
+/**
+ * @file Profiler.h
+ * @brief Header file for the Profiler driver.
+ *
+ * This file contains the function definitions for the Profiler driver.
+ * It measures the number of MCLK cycles used by the interrupt handlers and the scheduled tasks with the
+ * DWT cycle counter, and records the invocation count and the minimum, average, and maximum cycles of each one.
+ *
+ * Usage:
+ *  - Define PROFILER_ACTIVE below to enable the measurements. When it is not defined, PROFILER_START and
+ *    PROFILER_STOP expand to nothing, so the instrumented handlers are not changed.
+ *  - PROFILER_START(id) and PROFILER_STOP(id) surround the body of a handler, in the same block.
+ *  - CycleCounter_Init must be called before the first measurement.
+ *
+ * Entry latency:
+ *  - PROFILER_LATENCY(id, cycles) records the time from the event to the first instruction of its handler,
+ *    read from the hardware counter that raised it: the SysTick count since the reload, the Timer_A count
+ *    since the CCR0 period (TA1_0), or since the edge latched in the capture register (TA3_0 and TA3_N).
+ *  - PROFILER_TIMER_LATENCY(id, ticks) converts a count of a Timer_A clocked by SMCLK to MCLK cycles.
+ *  - The maximum includes the handlers with the same or a higher priority and the critical sections that
+ *    ran between the event and the handler, so it shows the blocking allowed by Interrupt_Priority.h.
+ *    Profiler_Print flags the handlers above their INTERRUPT_LATENCY_BUDGET.
+ *
+ * Notes:
+ *  - The measured cycles include the interrupts with a higher priority that preempt the handler.
+ *  - A measurement costs two reads of DWT_CYCCNT and a few additions (about 20 cycles).
+ *
+ */
+
+#ifndef INC_PROFILER_H_
+#define INC_PROFILER_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Clock.h"
+
+// Comment out to remove the measurements from every instrumented handler
+#define PROFILER_ACTIVE     1
+
+// Clock of the Timer_A counts passed to PROFILER_TIMER_LATENCY (SMCLK, divided by 1)
+#define PROFILER_TIMER_CLOCK_HZ     12000000
+
+/**
+ * @brief Identifiers of the measured handlers and tasks.
+ */
+typedef enum
+{
+    PROFILER_SYSTICK,
+    PROFILER_CONTROL_TASK,
+    PROFILER_USER_INTERFACE_TASK,
+    PROFILER_TA1_0,
+    PROFILER_TA3_0,
+    PROFILER_TA3_N,
+    PROFILER_PORT4,
+    PROFILER_PORT6,
+    PROFILER_DMA_INT1,
+    PROFILER_DMA_INT2,
+    PROFILER_EUSCI_B1,
+    PROFILER_T32_INT1,
+    PROFILER_NUM_IDS
+} Profiler_ID;
+
+/**
+ * @brief Statistics of a measured handler.
+ */
+typedef struct
+{
+    uint32_t Count;
+    uint32_t Min_Cycles;
+    uint32_t Max_Cycles;
+    uint64_t Total_Cycles;
+    uint32_t Max_Latency_Cycles;
+} Profiler_Stats;
+
+#ifdef PROFILER_ACTIVE
+#define PROFILER_START(id)  uint32_t profiler_start_cycles_##id = CycleCounter_Read()
+#define PROFILER_STOP(id)   Profiler_Record((id), CycleCounter_Read() - profiler_start_cycles_##id)
+#define PROFILER_LATENCY(id, cycles)        Profiler_Record_Latency((id), (cycles))
+#define PROFILER_TIMER_LATENCY(id, ticks)   Profiler_Record_Latency((id), (uint32_t)(ticks) * (Clock_GetFreq() / PROFILER_TIMER_CLOCK_HZ))
+#else
+#define PROFILER_START(id)
+#define PROFILER_STOP(id)
+#define PROFILER_LATENCY(id, cycles)
+#define PROFILER_TIMER_LATENCY(id, ticks)
+#endif
+
+/**
+ * @brief Clear the statistics of every handler.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Reset();
+
+/**
+ * @brief Add a measurement to the statistics of a handler. Called by PROFILER_STOP.
+ *
+ * @param id     The identifier of the handler.
+ * @param cycles The number of MCLK cycles used by the handler.
+ *
+ * @return None
+ */
+void Profiler_Record(Profiler_ID id, uint32_t cycles);
+
+/**
+ * @brief Add an entry latency to the statistics of a handler. Called by PROFILER_LATENCY.
+ *
+ * @param id     The identifier of the handler.
+ * @param cycles The number of MCLK cycles from the event to the entry of the handler.
+ *
+ * @return None
+ */
+void Profiler_Record_Latency(Profiler_ID id, uint32_t cycles);
+
+/**
+ * @brief Copy the statistics of a handler.
+ *
+ * @param id    The identifier of the handler.
+ * @param stats Pointer to store the statistics (consistent even if the handler runs during the copy).
+ *
+ * @return None
+ */
+void Profiler_Get_Stats(Profiler_ID id, Profiler_Stats *stats);
+
+/**
+ * @brief Return the average number of cycles of a handler.
+ *
+ * @param stats Pointer to the statistics.
+ *
+ * @return The average number of cycles, or 0 if the handler has not been executed.
+ */
+uint32_t Profiler_Get_Average(const Profiler_Stats *stats);
+
+/**
+ * @brief Print the statistics of every handler with Print_Format (EUSCI_A0_UART).
+ *
+ * The maximum entry latency is printed in us, followed by "over" when it is above the budget of the handler.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Print();
+
+/**
+ * @brief Draw the maximum cycles of up to 6 handlers in the Nokia5110 RAM buffer.
+ *
+ * Each row shows the short name of a handler and its maximum number of cycles. The buffer must then be
+ * sent to the LCD with Nokia5110_DisplayBuffer or Nokia5110_DisplayBuffer_DMA.
+ *
+ * @param first_id The identifier shown on the first row.
+ *
+ * @return None
+ */
+void Profiler_Display(Profiler_ID first_id);
+
+#endif /* INC_PROFILER_H_ */
@@ -0,0 +1,70 @@
+/**
+ * @file Race_Report.h
+ * @brief Header file for the Race_Report module.
+ *
+ * This file contains the function definitions for the Race_Report module.
+ * It reports the route times and the trial statistics of the Route_Race module to the host, and executes
+ * the race command received by the Parameters module.
+ *
+ * Commands:
+ *  - race      Print "race state=<state> trial=<trial>/<trials>", then the times of every strategy
+ *              as "race <name> trials=<n> min=<s> mean=<s> max=<s>"
+ *
+ */
+
+#ifndef INC_RACE_REPORT_H_
+#define INC_RACE_REPORT_H_
+
+#include <stdint.h>
+#include "Route_Race.h"
+#include "Parameters.h"
+
+/**
+ * @brief This function selects the function that sends the reports.
+ *
+ * @param output The function that sends a line to the host (without line ending). The reports of finished routes
+ *               are also sent when the Parameters module is not used.
+ *
+ * @return None
+ */
+void Race_Report_Init(void (*output)(const char *line));
+
+/**
+ * @brief This function reports the time of a finished route as "route <name> <s> s".
+ *
+ * @param name    The name of the route: the name of a strategy, or speed.
+ * @param time_ms The route time in ms.
+ *
+ * @return None
+ */
+void Race_Report_Route_Time(const char *name, uint32_t time_ms);
+
+/**
+ * @brief This function reports a route that has not reached its end as "route <name> failed".
+ *
+ * @param name The name of the route: the name of a strategy, or speed.
+ *
+ * @return None
+ */
+void Race_Report_Route_Failed(const char *name);
+
+/**
+ * @brief This function reports the minimum, mean, and maximum time of the trials of a strategy.
+ *
+ * @param index The index of the strategy in the Route_Race registry.
+ *
+ * @return None
+ */
+void Race_Report_Stats(int index);
+
+/**
+ * @brief This function executes the race command received by the Parameters module.
+ *
+ * @param arguments      The words of the command line.
+ * @param argument_count The number of words.
+ *
+ * @return 0 if the command has been executed, or -1 if it is not the race command.
+ */
+int Race_Report_Command(char **arguments, uint8_t argument_count);
+
+#endif /* INC_RACE_REPORT_H_ */
@@ -0,0 +1,95 @@
+/**
+ * @file Rate_Monitor.h
+ * @brief Header file for the Rate_Monitor module.
+ *
+ * This file contains the function definitions for the Rate_Monitor module.
+ * It applies the sample rate and the control period of the levels selected by the Rate_Policy module,
+ * measures the effective rates and the CPU load, and executes the rate command received by the Parameters module.
+ *
+ * Commands:
+ *  - rate      Print "rate level=<level> sample=<Hz>/<Hz> ctl=<Hz>/<Hz> load=<%>", the effective and the selected
+ *              sample rate and control rate, and the CPU load, measured over the last second
+ *
+ * The sampler of the distance sensors is reached through the functions of Rate_Monitor_Config, so the module
+ * does not depend on the sampling mode (DMA or Timer A1 interrupt).
+ *
+ */
+
+#ifndef INC_RATE_MONITOR_H_
+#define INC_RATE_MONITOR_H_
+
+#include <stdint.h>
+#include "CortexM.h"
+#include "Scheduler.h"
+#include "Rate_Policy.h"
+#include "Trace.h"
+#include "Parameters.h"
+
+/**
+ * @brief Functions and timing used by the Rate_Monitor module.
+ */
+typedef struct
+{
+    void (*Output)(const char *line);                   // Sends a reply line of the rate command
+    void (*Set_Sample_Rate)(uint32_t sample_rate_hz);   // Changes the sample rate of the distance sensors
+    uint32_t (*Get_Sample_Count)(void);                 // Returns the number of samples taken since boot
+    uint32_t Ticks_Per_Second;                          // Number of scheduler ticks per second
+} Rate_Monitor_Config;
+
+/**
+ * @brief This function selects the sampler and the control task, and forgets the applied level.
+ *
+ * It must be called before the first control tick calls Rate_Monitor_Apply_Level.
+ *
+ * @param config          Pointer to the configuration (kept by the module).
+ * @param control_task_id The scheduler ID of the control task, whose period is changed with the level.
+ *
+ * @return None
+ */
+void Rate_Monitor_Init(const Rate_Monitor_Config *config, int control_task_id);
+
+/**
+ * @brief This function applies the sample rate and the control period of a level of the rate policy, if it has changed.
+ *
+ * It is executed by the control task, and by the user interface before a run starts, with the interrupts disabled.
+ *
+ * @param level The level selected by Rate_Policy_Update or Rate_Policy_Wake.
+ *
+ * @return None
+ */
+void Rate_Monitor_Apply_Level(Rate_Policy_Level level);
+
+/**
+ * @brief This function applies the rates of the current level again, even if they have already been applied.
+ *
+ * For example after the sampler has been started, which resets its rate. Must be called with the interrupts disabled.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Rate_Monitor_Reapply(void);
+
+/**
+ * @brief This function measures the effective sample and control rates and the CPU load, executed by the scheduler every second.
+ *
+ * The rates count the samples and the executions of the control task over the ticks since the last execution.
+ * The load is the part of the MCLK cycles in which the main loop did not sleep, so it is also valid across a clock profile change.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Rate_Monitor_Task(void);
+
+/**
+ * @brief This function executes the rate command received by the Parameters module.
+ *
+ * @param arguments      The words of the command line.
+ * @param argument_count The number of words.
+ *
+ * @return 0 if the command has been executed, or -1 if it is not the rate command.
+ */
+int Rate_Monitor_Command(char **arguments, uint8_t argument_count);
+
+#endif /* INC_RATE_MONITOR_H_ */
@@ -0,0 +1,159 @@
+/**
+ * @file Rate_Policy.h
+ * @brief Header file for the Rate_Policy module.
+ *
+ * This file contains the function definitions for the Rate_Policy module.
+ * It selects the sample rate of the Analog Distance Sensors and the period of the control loop from the state
+ * of the robot, so the conversions, the filter interrupts, and the control ticks are spent where they matter.
+ *
+ * Levels, from the lowest rates:
+ *  - RATE_POLICY_IDLE: parked between two runs, no route active and both wheels below RATE_POLICY_PARKED_SPEED.
+ *    The control loop still runs often enough to see the bumpers and a robot pushed by hand.
+ *  - RATE_POLICY_EXPLORE: a trial of the route race, or any other motion below RATE_POLICY_SPRINT_SPEED.
+ *  - RATE_POLICY_SPRINT: the speed run, or a wheel at RATE_POLICY_SPRINT_SPEED or faster.
+ *
+ * A higher level is selected at once. A lower level is only selected once it has been requested by
+ * RATE_POLICY_HOLD_TICKS consecutive calls of Rate_Policy_Update, and the sprint speed has a hysteresis of
+ * RATE_POLICY_SPEED_HYSTERESIS, so a short stop in a run does not change the rates.
+ *
+ * The control loop is tuned for SPEED_CONTROLLER_RATE_HZ, so its fastest rate is every tick: the sprint level
+ * gets the full sample rate, and only the idle level decimates the control loop. At that level, the per-tick
+ * speed estimates are only used to see that the robot moves. The caller applies the rates of a new level,
+ * and calls Rate_Policy_Wake before it starts a run, so the first ticks of the run are not at the idle rates.
+ *
+ * The module does not access the hardware: the caller passes the state of the robot and applies the rates.
+ *
+ */
+
+#ifndef INC_RATE_POLICY_H_
+#define INC_RATE_POLICY_H_
+
+#include <stdint.h>
+
+// Sample rate of every Analog Distance Sensor channel at each level in Hz (see Analog_Distance_Sensor_Set_Sequence_Rate)
+#ifndef RATE_POLICY_IDLE_SAMPLE_RATE_HZ
+#define RATE_POLICY_IDLE_SAMPLE_RATE_HZ         500
+#endif
+#ifndef RATE_POLICY_EXPLORE_SAMPLE_RATE_HZ
+#define RATE_POLICY_EXPLORE_SAMPLE_RATE_HZ      1000
+#endif
+#ifndef RATE_POLICY_SPRINT_SAMPLE_RATE_HZ
+#define RATE_POLICY_SPRINT_SAMPLE_RATE_HZ       2000
+#endif
+
+// Period of the control loop at each level in ticks
+#ifndef RATE_POLICY_IDLE_CONTROL_PERIOD_TICKS
+#define RATE_POLICY_IDLE_CONTROL_PERIOD_TICKS   10
+#endif
+#ifndef RATE_POLICY_EXPLORE_CONTROL_PERIOD_TICKS
+#define RATE_POLICY_EXPLORE_CONTROL_PERIOD_TICKS 1
+#endif
+#ifndef RATE_POLICY_SPRINT_CONTROL_PERIOD_TICKS
+#define RATE_POLICY_SPRINT_CONTROL_PERIOD_TICKS 1
+#endif
+
+// Wheel speed below which the robot is parked, and from which it sprints, in mm/s
+#ifndef RATE_POLICY_PARKED_SPEED
+#define RATE_POLICY_PARKED_SPEED                20
+#endif
+#ifndef RATE_POLICY_SPRINT_SPEED
+#define RATE_POLICY_SPRINT_SPEED                400
+#endif
+
+// Decrease of the speed below RATE_POLICY_SPRINT_SPEED before the sprint level is released in mm/s
+#ifndef RATE_POLICY_SPEED_HYSTERESIS
+#define RATE_POLICY_SPEED_HYSTERESIS            100
+#endif
+
+// Number of consecutive calls that request a lower level before it is selected
+#ifndef RATE_POLICY_HOLD_TICKS
+#define RATE_POLICY_HOLD_TICKS                  50
+#endif
+
+#if (RATE_POLICY_SPEED_HYSTERESIS >= RATE_POLICY_SPRINT_SPEED) || (RATE_POLICY_PARKED_SPEED >= (RATE_POLICY_SPRINT_SPEED - RATE_POLICY_SPEED_HYSTERESIS))
+#error "RATE_POLICY_PARKED_SPEED must be below RATE_POLICY_SPRINT_SPEED - RATE_POLICY_SPEED_HYSTERESIS"
+#endif
+
+#if (RATE_POLICY_IDLE_CONTROL_PERIOD_TICKS == 0) || (RATE_POLICY_EXPLORE_CONTROL_PERIOD_TICKS == 0) || (RATE_POLICY_SPRINT_CONTROL_PERIOD_TICKS == 0)
+#error "The control periods of the rate policy must be at least one tick"
+#endif
+
+/**
+ * @brief Levels of the rate policy, from the lowest rates.
+ */
+typedef enum
+{
+    RATE_POLICY_IDLE,
+    RATE_POLICY_EXPLORE,
+    RATE_POLICY_SPRINT,
+    RATE_POLICY_NUM_LEVELS
+} Rate_Policy_Level;
+
+/**
+ * @brief Rates of a level.
+ */
+typedef struct
+{
+    uint32_t Sample_Rate_Hz;
+    uint16_t Control_Period_Ticks;
+} Rate_Policy_Rates;
+
+/**
+ * @brief This function selects the explore level and clears the level changes.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Rate_Policy_Init(void);
+
+/**
+ * @brief This function selects the level from the state of the robot, once per execution of the control loop.
+ *
+ * @param route_active 1 while a trial of the route race or a replay drives the robot, or 0 otherwise.
+ * @param speed_run    1 during the speed run, or 0 otherwise.
+ * @param left_speed   The speed of the left wheel in mm/s.
+ * @param right_speed  The speed of the right wheel in mm/s.
+ *
+ * @return The selected level. The caller applies its rates when it differs from the previous one.
+ */
+Rate_Policy_Level Rate_Policy_Update(uint8_t route_active, uint8_t speed_run, int16_t left_speed, int16_t right_speed);
+
+/**
+ * @brief This function raises the idle level to the explore level, before a run is started.
+ *
+ * @param None
+ *
+ * @return The selected level.
+ */
+Rate_Policy_Level Rate_Policy_Wake(void);
+
+/**
+ * @brief This function returns the selected level.
+ *
+ * @param None
+ *
+ * @return The level selected by the last call of Rate_Policy_Update or Rate_Policy_Wake.
+ */
+Rate_Policy_Level Rate_Policy_Get_Level(void);
+
+/**
+ * @brief This function returns the rates of a level.
+ *
+ * @param level The level.
+ * @param rates Pointer to store the rates.
+ *
+ * @return 0 if the rates have been stored, or -1 if the level is invalid.
+ */
+int Rate_Policy_Get_Rates(Rate_Policy_Level level, Rate_Policy_Rates *rates);
+
+/**
+ * @brief This function returns the number of level changes since Rate_Policy_Init.
+ *
+ * @param None
+ *
+ * @return The number of changes.
+ */
+uint32_t Rate_Policy_Get_Change_Count(void);
+
+#endif /* INC_RATE_POLICY_H_ */
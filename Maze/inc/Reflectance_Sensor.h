@@ -27,6 +27,15 @@
  *          5. Measure the time for the voltage to decay by waiting for the GPIO lines to go low
  *          6. Turn off the IR LEDs
  *
+ * @note Reflectance_Sensor_Read waits for the charge and the decay with Clock_Delay1us, which blocks the CPU for the whole
+ *       sample time. Reflectance_Sensor_Acquisition_Init instead runs the same sequence from the Timer32_1 interrupt:
+ *          - Charge:  The IR LEDs are turned on, the sensor output pins are driven high, and Timer32_1 interrupts
+ *                     after REFLECTANCE_SENSOR_CHARGE_TIME_US.
+ *          - Decay:   The sensor output pins are configured as input GPIO, and Timer32_1 interrupts after the sample time.
+ *          - Sample:  The sensor output pins are read, the IR LEDs are turned off, and the line pattern is published.
+ *                     Timer32_1 interrupts at the start of the next period.
+ *       The CPU runs the other tasks or sleeps between the three interrupts, and each interrupt only takes a few cycles.
+ *
  * @note For more information regarding the 8-Channel QTRX Sensor Array module,
  * refer to the product page: https://www.pololu.com/product/3672
  *
@@ -41,6 +50,12 @@
 #include "msp.h"
 #include "Clock.h"
 
+// Time for the sensor output to rise before the decay is measured
+#define REFLECTANCE_SENSOR_CHARGE_TIME_US       10
+
+// Timer32_1 is clocked by MCLK (48 MHz) with a prescale value of 1
+#define REFLECTANCE_SENSOR_T32_CYCLES_PER_US    48
+
 /**
  * @brief Initializes the 8-Channel QTRX Sensor Array module.
  *
@@ -96,4 +111,52 @@ void Reflectance_Sensor_Start();
  */
 uint8_t Reflectance_Sensor_End();
 
+/**
+ * @brief Starts the timer-driven acquisition of the reflectance sensors using Timer32_1.
+ *
+ * The first sample is started immediately, and a new sample is started every period. The latest
+ * line pattern is read with Reflectance_Sensor_Get, and the optional task is executed by the Timer32_1
+ * interrupt with every new line pattern (for example to detect the tape of a cell boundary).
+ *
+ * @param sample_time_us The decay time in microseconds before the sensors are read (same as the "time" of Reflectance_Sensor_Read).
+ * @param period_us      The time between the start of two samples in microseconds. It must be longer than
+ *                       REFLECTANCE_SENSOR_CHARGE_TIME_US + sample_time_us.
+ * @param task           A pointer to the user-defined function executed in the interrupt with every new line pattern, or 0.
+ *
+ * @note Assumes that Reflectance_Sensor_Init() has been called to initialize the sensor module.
+ *       Reflectance_Sensor_Read, Reflectance_Sensor_Start, and Reflectance_Sensor_End must not be used during the acquisition.
+ *
+ * @return 0 if the acquisition has been started, or -1 if the period is too short.
+ */
+int Reflectance_Sensor_Acquisition_Init(uint32_t sample_time_us, uint32_t period_us, void (*task)(uint8_t reflectance_value));
+
+/**
+ * @brief Stops the timer-driven acquisition and turns off the IR LEDs.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Reflectance_Sensor_Acquisition_Stop(void);
+
+/**
+ * @brief Returns the latest line pattern published by the timer-driven acquisition.
+ *
+ * @param None
+ *
+ * @return uint8_t The 8-bit reflectance sensor data. "1" indicates black, while "0" indicates white.
+ */
+uint8_t Reflectance_Sensor_Get(void);
+
+/**
+ * @brief Returns the number of line patterns published since Reflectance_Sensor_Acquisition_Init.
+ *
+ * A change of the count indicates a new line pattern.
+ *
+ * @param None
+ *
+ * @return The number of samples (wraps around).
+ */
+uint32_t Reflectance_Sensor_Get_Sample_Count(void);
+
 #endif /* REFLECTANCE_SENSOR_H_ */
@@ -0,0 +1,162 @@
+/**
+ * @file Robot_Link.h
+ * @brief Header file for the Robot_Link module.
+ *
+ * This file contains the function definitions for the Robot_Link module.
+ * It exchanges the maze map and the pose of Controller_2 with a second robot over the EUSCI_A3 UART
+ * (P9.6 RX, P9.7 TX, crossed between the two robots, 9600 baud), so that a robot that receives the map
+ * of an explored maze can drive the shortest path without exploring it again.
+ *
+ * The frames have the format of the Telemetry packets (see Telemetry.h): packet type, sequence number,
+ * payload, and CRC-16, encoded with COBS and followed by a 0x00 delimiter. A frame with a wrong CRC is
+ * dropped and counted, and the receiver resynchronizes at the next delimiter.
+ *
+ * Packet types:
+ *  - Request (0x11), no payload: asks the other robot to send its pose and its map.
+ *  - Pose (0x12), 4 bytes: cell X, cell Y, heading (Maze_Direction), and flags (ROBOT_LINK_POSE_GOAL_REACHED).
+ *  - Map (0x13), 2 + ROBOT_LINK_MAP_CHUNK_SIZE bytes: map number, chunk index, and a chunk of the
+ *    MAZE_MAP_STORAGE_SIZE bytes written by Maze_Map_Export. A map is complete when every chunk of the
+ *    same map number has been received, so a partial map is never returned.
+ *
+ * The frames are queued in the EUSCI_A3 TX ring buffer only when a whole frame fits, one after the other
+ * by Robot_Link_Task, and the received bytes are read from the EUSCI_A3 RX ring buffer.
+ *
+ * @note Every function must be called from the same background task, the EUSCI_A3 interrupt only moves the bytes.
+ *
+ */
+
+#ifndef INC_ROBOT_LINK_H_
+#define INC_ROBOT_LINK_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "EUSCI_A3_UART.h"
+#include "Telemetry.h"
+#include "Maze_Map.h"
+
+// Maximum payload length in bytes
+#define ROBOT_LINK_MAX_PAYLOAD_LENGTH   48
+
+// Length of a frame before encoding: type, sequence number, payload, and CRC
+#define ROBOT_LINK_MAX_FRAME_LENGTH     (ROBOT_LINK_MAX_PAYLOAD_LENGTH + 4)
+
+// Worst-case length of an encoded frame including the 0x00 delimiter
+#define ROBOT_LINK_MAX_ENCODED_LENGTH   (ROBOT_LINK_MAX_FRAME_LENGTH + (ROBOT_LINK_MAX_FRAME_LENGTH / 254) + 2)
+
+// Packet types
+#define ROBOT_LINK_PACKET_REQUEST       0x11
+#define ROBOT_LINK_PACKET_POSE          0x12
+#define ROBOT_LINK_PACKET_MAP           0x13
+
+// Length of the Pose packet payload
+#define ROBOT_LINK_POSE_PAYLOAD_LENGTH  4
+
+// Number of map bytes in a Map packet, and number of Map packets of a map
+#define ROBOT_LINK_MAP_CHUNK_SIZE       40
+#define ROBOT_LINK_MAP_NUM_CHUNKS       ((MAZE_MAP_STORAGE_SIZE + ROBOT_LINK_MAP_CHUNK_SIZE - 1) / ROBOT_LINK_MAP_CHUNK_SIZE)
+
+// Flags of the Pose packet
+#define ROBOT_LINK_POSE_GOAL_REACHED    0x01
+
+/**
+ * @brief Cell and heading of a robot in the maze map, sent in a Pose packet.
+ */
+typedef struct
+{
+    uint8_t X;
+    uint8_t Y;
+    uint8_t Heading;
+    uint8_t Flags;
+} Robot_Link_Pose;
+
+/**
+ * @brief Initialize EUSCI_A3 in UART mode, receive in the RX ring buffer, and clear the link state.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Robot_Link_Init(void);
+
+/**
+ * @brief Ask the other robot to send its pose and its map.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Robot_Link_Send_Request(void);
+
+/**
+ * @brief Send a pose, before the map chunks that are still queued.
+ *
+ * @param pose Pointer to the pose.
+ *
+ * @return None
+ */
+void Robot_Link_Send_Pose(const Robot_Link_Pose *pose);
+
+/**
+ * @brief Send a map with a new map number. A map that is still being sent is replaced.
+ *
+ * @param map Pointer to the MAZE_MAP_STORAGE_SIZE bytes written by Maze_Map_Export.
+ *
+ * @return None
+ */
+void Robot_Link_Send_Map(const uint8_t *map);
+
+/**
+ * @brief Indicate if a request, a pose, or map chunks have not been queued yet.
+ *
+ * @param None
+ *
+ * @return 1 if a frame is waiting, 0 otherwise.
+ */
+uint8_t Robot_Link_Is_Sending(void);
+
+/**
+ * @brief Decode the received frames and queue the next frames when they fit in the TX ring buffer.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Robot_Link_Task(void);
+
+/**
+ * @brief Indicate if the other robot has sent a Request packet since the last call.
+ *
+ * @param None
+ *
+ * @return 1 if a request has been received, 0 otherwise.
+ */
+uint8_t Robot_Link_Get_Request(void);
+
+/**
+ * @brief Return the pose received since the last call, if any.
+ *
+ * @param pose Pointer to store the pose.
+ *
+ * @return 1 if a new pose has been stored, 0 otherwise.
+ */
+uint8_t Robot_Link_Get_Pose(Robot_Link_Pose *pose);
+
+/**
+ * @brief Return the map completed since the last call, if any.
+ *
+ * @param map Pointer to store MAZE_MAP_STORAGE_SIZE bytes, in the format of Maze_Map_Export.
+ *
+ * @return 1 if a new map has been stored, 0 otherwise.
+ */
+uint8_t Robot_Link_Get_Map(uint8_t *map);
+
+/**
+ * @brief Return the number of received frames dropped because they were too long, corrupted, or unknown.
+ *
+ * @param None
+ *
+ * @return The number of dropped frames since Robot_Link_Init.
+ */
+uint32_t Robot_Link_Get_Errors(void);
+
+#endif /* INC_ROBOT_LINK_H_ */
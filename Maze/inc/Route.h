@@ -0,0 +1,284 @@
+/**
+ * @file Route.h
+ * @brief Header file for the Route driver.
+ *
+ * This file contains the function definitions for the Route driver.
+ * It records the route driven by the robot as a compact list of motion primitives
+ * (straight N cells, turn left or right N x 90 degrees) and replays a recorded route with
+ * the Motion driver, without running the reactive wall-following logic again.
+ *
+ * Recording:
+ *  - The route is reconstructed from the pose estimated by the Odometry driver, so it does not depend on the
+ *    controller that drives the robot. The heading is compared with the current grid direction: a change of more
+ *    than ROUTE_TURN_THRESHOLD_DEGREES is recorded as a 90 degree turn.
+ *  - The distance traveled along the grid direction between two turns is rounded to the nearest number of cells.
+ *  - Turns that cancel each other (left then right without a straight in between) are removed, and consecutive
+ *    turns are merged, so small heading corrections of the wall follower do not appear in the route.
+ *
+ * Path smoothing:
+ *  - Before a replay, Route_Smooth converts the steps into a plan of segments. Consecutive straight steps are
+ *    merged into a single segment, so the robot keeps its speed across cell boundaries.
+ *  - A 90 degree turn between two straights (a corner) is replaced by an arc of radius Arc_Radius_mm. The arc
+ *    starts Arc_Radius_mm before the corner and ends Arc_Radius_mm after it, so the straights are shortened.
+ *    Other turns (180 degrees, or a turn at the start or the end of the route) are executed in place.
+ *  - Every segment has a speed limit (Max_Speed for a straight, Arc_Speed for an arc) and an end speed,
+ *    which is the speed limit of the next segment. A straight only slows down to the speed of the next arc,
+ *    and it slows down to a stop only before an in-place turn or the end of the route.
+ *
+ * Replay:
+ *  - The plan is followed on the grid of the start pose: the replay tracks the planned pose at the start of every
+ *    segment that the Motion driver starts. A turn or an arc ends on the planned heading instead of turning its angle
+ *    from the heading it starts with, and a straight steers back to its planned line and ends at its planned end,
+ *    so the errors of the open-loop arcs do not add up from corner to corner.
+ *  - When a side wall starts or ends during a straight, the Junction event gives the position of a cell border,
+ *    which moves the plan along the straight like the wall follower locates the center of a cell.
+ *    The replay reads the Junction events, so no other controller may read them while a plan is replayed.
+ *
+ * Step encoding (1 byte per step):
+ *  - Bits 7-6: Step type (Route_Step_Type)
+ *  - Bits 5-0: Number of cells for a straight, or number of 90 degree turns
+ *
+ */
+
+#ifndef INC_ROUTE_H_
+#define INC_ROUTE_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Odometry.h"
+#include "Motion.h"
+#include "Junction.h"
+#include "Memory_Config.h"
+
+// Maximum count of a single step, a longer straight is stored as several steps
+#define ROUTE_MAX_STEP_COUNT            0x3F
+
+// Maximum length of a straight segment in mm, a longer straight is split into several segments with no stop
+#define ROUTE_MAX_SEGMENT_LENGTH        30000
+
+// Heading change that is recorded as a turn
+// Note: Larger than 45 degrees so that the recorder does not toggle around the diagonal
+#define ROUTE_TURN_THRESHOLD_DEGREES    60
+
+// Distance over which the replay of a straight steers back to the line of the plan, and the largest steering angle
+#ifndef ROUTE_REPLAY_LOOKAHEAD_MM
+#define ROUTE_REPLAY_LOOKAHEAD_MM       150
+#endif
+#ifndef ROUTE_REPLAY_MAX_STEER_DEGREES
+#define ROUTE_REPLAY_MAX_STEER_DEGREES  15
+#endif
+
+// Encodes a step, and returns the type or the count of an encoded step
+#define ROUTE_STEP(type, count)         ((uint8_t)(((type) << 6) | ((count) & ROUTE_MAX_STEP_COUNT)))
+#define ROUTE_STEP_TYPE(step)           ((Route_Step_Type)((step) >> 6))
+#define ROUTE_STEP_COUNT(step)          ((step) & ROUTE_MAX_STEP_COUNT)
+
+/**
+ * @brief Types of route steps.
+ */
+typedef enum
+{
+    ROUTE_STEP_STRAIGHT = 0,
+    ROUTE_STEP_TURN_LEFT = 1,
+    ROUTE_STEP_TURN_RIGHT = 2
+} Route_Step_Type;
+
+/**
+ * @brief Recorded route.
+ *
+ * Overflow is set to 1 if the route did not fit in ROUTE_MAX_STEPS steps. The route is then incomplete.
+ */
+typedef struct
+{
+    uint8_t Steps[ROUTE_MAX_STEPS];
+    uint8_t Length;
+    uint8_t Overflow;
+} Route_Path;
+
+/**
+ * @brief Types of plan segments.
+ */
+typedef enum
+{
+    ROUTE_SEGMENT_STRAIGHT,
+    ROUTE_SEGMENT_ARC,
+    ROUTE_SEGMENT_TURN
+} Route_Segment_Type;
+
+/**
+ * @brief Segment of a smoothed plan.
+ *
+ * For a straight, Amount is the length in mm. For an arc or an in-place turn, Amount is the angle in degrees
+ * (positive turns left). Speed_Limit and End_Speed are in mm/s and are 0 for an in-place turn.
+ */
+typedef struct
+{
+    Route_Segment_Type Type;
+    int16_t Amount;
+    uint16_t Speed_Limit;
+    uint16_t End_Speed;
+} Route_Segment;
+
+/**
+ * @brief Smoothed plan built from a recorded route.
+ *
+ * Each step of a route produces at most one segment, except for a straight longer than ROUTE_MAX_SEGMENT_LENGTH.
+ */
+typedef struct
+{
+    Route_Segment Segments[ROUTE_MAX_STEPS];
+    uint8_t Length;
+    uint8_t Overflow;
+} Route_Plan;
+
+/**
+ * @brief Parameters used to smooth and replay a route.
+ *
+ * Arc_Radius_mm must not be larger than half of Cell_Size_mm. A radius of 0 disables the arcs.
+ * Side_Sensor_Offset_mm is the distance along the heading from the center of the robot to the side sensors.
+ */
+typedef struct
+{
+    uint16_t Cell_Size_mm;
+    uint16_t Max_Speed;
+    uint16_t Acceleration;
+    uint16_t Cell_Timeout_Ticks;
+    uint16_t Turn_Duty_Cycle;
+    uint16_t Turn_Timeout_Ticks;
+    uint16_t Arc_Radius_mm;
+    uint16_t Arc_Speed;
+    uint16_t Side_Sensor_Offset_mm;
+} Route_Replay_Config;
+
+/**
+ * @brief Clear a route.
+ *
+ * @param path Pointer to the route.
+ *
+ * @return None
+ */
+void Route_Clear(Route_Path *path);
+
+/**
+ * @brief Append a step to a route, merging it with the last step when possible.
+ *
+ * @param path  Pointer to the route.
+ * @param type  The type of the step.
+ * @param count The number of cells or 90 degree turns. A count of 0 is ignored.
+ *
+ * @return 0 if the step has been stored, or -1 if the route is full.
+ */
+int Route_Append(Route_Path *path, Route_Step_Type type, uint8_t count);
+
+/**
+ * @brief Start recording the route driven by the robot from its current pose.
+ *
+ * The current heading is used as the first grid direction.
+ *
+ * @param path         Pointer to the route, which is cleared.
+ * @param cell_size_mm The size of a maze cell in mm.
+ *
+ * @return None
+ */
+void Route_Record_Start(Route_Path *path, uint16_t cell_size_mm);
+
+/**
+ * @brief Update the recorded route from the current pose.
+ *
+ * This function must be called once per control tick after Odometry_Update. It does nothing
+ * when no route is being recorded.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Route_Record_Update();
+
+/**
+ * @brief Stop recording and store the last straight of the route.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Route_Record_Stop();
+
+/**
+ * @brief Indicate if a route is being recorded.
+ *
+ * @param None
+ *
+ * @return 1 if a route is being recorded, or 0 otherwise.
+ */
+uint8_t Route_Is_Recording();
+
+/**
+ * @brief Convert a recorded route into a smoothed plan of segments.
+ *
+ * @param path   Pointer to the route.
+ * @param config Pointer to the replay parameters.
+ * @param plan   Pointer to store the plan.
+ *
+ * @return 0 if the plan is complete, or -1 if it did not fit in the plan.
+ */
+int Route_Smooth(const Route_Path *path, const Route_Replay_Config *config, Route_Plan *plan);
+
+/**
+ * @brief Start replaying a smoothed plan using the Motion driver.
+ *
+ * Straights are driven with a trapezoidal speed profile, arcs at their speed limit, and the other
+ * turns in place. The plan starts from the current pose, which must be the one at the start of the recorded route.
+ * The plan and the configuration must remain valid until the replay is complete.
+ *
+ * @param plan   Pointer to the plan.
+ * @param config Pointer to the replay parameters.
+ *
+ * @return None
+ */
+void Route_Replay_Start(const Route_Plan *plan, const Route_Replay_Config *config);
+
+/**
+ * @brief Correct the active segment and queue the next segments of the plan in the Motion driver.
+ *
+ * This function must be called once per control tick after Odometry_Update and before Motion_Update.
+ * It does nothing when no route is being replayed.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Route_Replay_Update();
+
+/**
+ * @brief Stop the replay and the motors.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Route_Replay_Abort();
+
+/**
+ * @brief Indicate if a plan is being replayed.
+ *
+ * @param None
+ *
+ * @return 1 until the last segment of the plan has been executed, or 0 otherwise.
+ */
+uint8_t Route_Replay_Is_Active();
+
+/**
+ * @brief Indicate if the last replay has reached the end of its plan.
+ *
+ * A replay stops as soon as a segment times out, for example when a wall blocks the robot, because the rest of
+ * the plan would not start where it was recorded. It then ends before the end of the recorded route.
+ *
+ * @param None
+ *
+ * @return 1 if every segment of the plan has been completed, or 0 if the replay is still active, has stopped
+ *         at a segment that timed out, or has been aborted.
+ */
+uint8_t Route_Replay_Is_Complete();
+
+#endif /* INC_ROUTE_H_ */
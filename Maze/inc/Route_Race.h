@@ -0,0 +1,208 @@
+/**
+ * @file Route_Race.h
+ * @brief Header file for the Route_Race module.
+ *
+ * This file contains the function definitions for the Route_Race module.
+ * It keeps a registry of maze strategies, runs them back to back in a number of rounds,
+ * and keeps the minimum, mean, and maximum time of the trials of each strategy.
+ *
+ * A strategy is a pair of functions:
+ *  - Start: prepares the controller for a trial, executed by Route_Race_Start_Trial (optional)
+ *  - Step:  drives the robot for one control tick, and returns 1 once the robot has reached the end of the maze
+ *
+ * Sequence of a race of R rounds with N registered strategies:
+ *  - Route_Race_Start selects the first trial. Every round runs each strategy once in the registration order,
+ *    so a slow change of the robot (such as the battery voltage) does not favor one strategy.
+ *  - Route_Race_Start_Trial starts the selected trial once the robot is on the start cell.
+ *  - Route_Race_Update, executed at every control tick, calls the Step function of the running trial.
+ *  - Route_Race_Record stores the time of a finished trial and selects the next one, until the N x R trials are done.
+ *
+ * The times are measured by the caller, so the module does not access the hardware and is also compiled
+ * by the host simulator. Route_Race_Update is executed by the control tick and the other functions by the
+ * user interface: the trial state is only changed from RUNNING to FINISHED by Route_Race_Update.
+ *
+ */
+
+#ifndef INC_ROUTE_RACE_H_
+#define INC_ROUTE_RACE_H_
+
+#include <stdint.h>
+#include "Memory_Config.h"
+
+/**
+ * @brief State of the race.
+ */
+typedef enum
+{
+    ROUTE_RACE_IDLE = 0,        // No race has been started
+    ROUTE_RACE_READY = 1,       // The selected trial waits for Route_Race_Start_Trial
+    ROUTE_RACE_RUNNING = 2,     // The selected trial is driven by Route_Race_Update
+    ROUTE_RACE_FINISHED = 3,    // The selected trial has reached the end and waits for Route_Race_Record
+    ROUTE_RACE_DONE = 4         // Every trial has been recorded
+} Route_Race_State;
+
+/**
+ * @brief Strategy registered with Route_Race_Register.
+ */
+typedef struct
+{
+    const char *Name;
+    void (*Start)(void);
+    uint8_t (*Step)(void);
+} Route_Race_Strategy;
+
+/**
+ * @brief Times of the recorded trials of a strategy in ms.
+ */
+typedef struct
+{
+    uint32_t Trials;
+    uint32_t Min_ms;
+    uint32_t Max_ms;
+    uint32_t Total_ms;
+} Route_Race_Stats;
+
+/**
+ * @brief This function clears the registry and the times.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Route_Race_Init(void);
+
+/**
+ * @brief This function adds a strategy to the registry.
+ *
+ * @param name  The name of the strategy, up to 5 characters are shown on the Nokia5110 LCD.
+ * @param start Pointer to the function executed at the start of each trial, or 0 if none.
+ * @param step  Pointer to the function executed at every control tick of a trial.
+ *
+ * @return The index of the strategy, or -1 if ROUTE_RACE_MAX_STRATEGIES strategies are already registered.
+ */
+int Route_Race_Register(const char *name, void (*start)(void), uint8_t (*step)(void));
+
+/**
+ * @brief This function clears the times and selects the first trial of a race.
+ *
+ * @param rounds The number of trials of each strategy.
+ *
+ * @return None
+ */
+void Route_Race_Start(uint32_t rounds);
+
+/**
+ * @brief This function starts the selected trial.
+ *
+ * It does nothing unless the state is ROUTE_RACE_READY.
+ *
+ * @param None
+ *
+ * @return The index of the started strategy, or -1 if no trial has been started.
+ */
+int Route_Race_Start_Trial(void);
+
+/**
+ * @brief This function drives the running trial for one control tick.
+ *
+ * The state changes to ROUTE_RACE_FINISHED when the Step function of the strategy returns 1.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Route_Race_Update(void);
+
+/**
+ * @brief This function stores the time of the finished trial and selects the next trial.
+ *
+ * It does nothing unless the state is ROUTE_RACE_FINISHED.
+ *
+ * @param time_ms The time of the trial in ms.
+ *
+ * @return The index of the recorded strategy, or -1 if no trial has been recorded.
+ */
+int Route_Race_Record(uint32_t time_ms);
+
+/**
+ * @brief This function returns the state of the race.
+ *
+ * @param None
+ *
+ * @return The state of the race.
+ */
+Route_Race_State Route_Race_Get_State(void);
+
+/**
+ * @brief This function returns the strategy of the selected trial.
+ *
+ * @param None
+ *
+ * @return The index of the strategy, or -1 if no trial is selected.
+ */
+int Route_Race_Get_Current(void);
+
+/**
+ * @brief This function returns the number of the selected trial.
+ *
+ * @param None
+ *
+ * @return The number of trials recorded so far in the race.
+ */
+uint32_t Route_Race_Get_Trial(void);
+
+/**
+ * @brief This function returns the number of trials of the race.
+ *
+ * @param None
+ *
+ * @return The number of rounds times the number of strategies.
+ */
+uint32_t Route_Race_Get_Num_Trials(void);
+
+/**
+ * @brief This function returns the number of registered strategies.
+ *
+ * @param None
+ *
+ * @return The number of strategies.
+ */
+uint8_t Route_Race_Get_Num_Strategies(void);
+
+/**
+ * @brief This function returns the name of a strategy.
+ *
+ * @param index The index of the strategy.
+ *
+ * @return The name, or "?" if the index is not registered.
+ */
+const char *Route_Race_Get_Name(int index);
+
+/**
+ * @brief This function returns the times of the recorded trials of a strategy.
+ *
+ * @param index The index of the strategy.
+ *
+ * @return Pointer to the times, or 0 if the index is not registered.
+ */
+const Route_Race_Stats *Route_Race_Get_Stats(int index);
+
+/**
+ * @brief This function returns the mean time of the recorded trials of a strategy.
+ *
+ * @param index The index of the strategy.
+ *
+ * @return The mean time in ms, or 0 if the strategy has no recorded trial.
+ */
+uint32_t Route_Race_Get_Mean_ms(int index);
+
+/**
+ * @brief This function returns the strategy with the lowest mean time.
+ *
+ * @param None
+ *
+ * @return The index of the strategy, or -1 if no trial has been recorded. A tie selects the first registered strategy.
+ */
+int Route_Race_Get_Fastest(void);
+
+#endif /* INC_ROUTE_RACE_H_ */
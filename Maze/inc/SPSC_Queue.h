@@ -0,0 +1,104 @@
+/**
+ * @file SPSC_Queue.h
+ * @brief Header file for the SPSC_Queue module.
+ *
+ * This file contains the function definitions for the SPSC_Queue module.
+ * It is a lock-free ring buffer of fixed-size elements between one producer and one consumer,
+ * for example an interrupt handler that produces sensor samples or events and a slower task that reads them.
+ *
+ * Rules:
+ *  - Only the producer calls SPSC_Queue_Push, and only the consumer calls SPSC_Queue_Pop and SPSC_Queue_Pop_Latest.
+ *  - The capacity must be a power of two. The head and the tail are free-running counters, masked when
+ *    the buffer is indexed, so all the entries can be used and a full queue is told apart from an empty one.
+ *  - The producer writes the element before it publishes the new head, and the consumer reads the element
+ *    before it releases the entry with the new tail. A data memory barrier keeps this order, so neither side
+ *    disables the interrupts.
+ *  - A push to a full queue drops the new element and counts it.
+ *
+ */
+
+#ifndef INC_SPSC_QUEUE_H_
+#define INC_SPSC_QUEUE_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+// Number of bytes of a queue buffer
+#define SPSC_QUEUE_BUFFER_SIZE(element_size, capacity)  ((element_size) * (capacity))
+
+/**
+ * @brief State of a queue, initialized by SPSC_Queue_Init.
+ */
+typedef struct
+{
+    uint8_t *Buffer;
+    uint32_t Element_Size;
+    uint32_t Mask;
+    volatile uint32_t Head;
+    volatile uint32_t Tail;
+    volatile uint32_t Dropped;
+} SPSC_Queue;
+
+/**
+ * @brief Initialize an empty queue.
+ *
+ * @param queue        Pointer to the queue.
+ * @param buffer       Pointer to SPSC_QUEUE_BUFFER_SIZE(element_size, capacity) bytes of storage.
+ * @param element_size The size of an element in bytes.
+ * @param capacity     The number of elements (a power of two).
+ *
+ * @return 0 if the queue is ready, or -1 if the capacity is not a power of two.
+ */
+int SPSC_Queue_Init(SPSC_Queue *queue, void *buffer, uint32_t element_size, uint32_t capacity);
+
+/**
+ * @brief Append an element, called by the producer.
+ *
+ * @param queue   Pointer to the queue.
+ * @param element Pointer to the element to copy.
+ *
+ * @return 0 if the element has been queued, or -1 if the queue is full and the element has been dropped.
+ */
+int SPSC_Queue_Push(SPSC_Queue *queue, const void *element);
+
+/**
+ * @brief Remove the oldest element, called by the consumer.
+ *
+ * @param queue   Pointer to the queue.
+ * @param element Pointer to store the element.
+ *
+ * @return 1 if an element has been read, or 0 if the queue is empty.
+ */
+int SPSC_Queue_Pop(SPSC_Queue *queue, void *element);
+
+/**
+ * @brief Remove every queued element and keep the newest one, called by the consumer.
+ *
+ * This is used when only the latest sample matters, for example a set of distances.
+ *
+ * @param queue   Pointer to the queue.
+ * @param element Pointer to store the newest element. It is not changed if the queue is empty.
+ *
+ * @return The number of elements removed.
+ */
+uint32_t SPSC_Queue_Pop_Latest(SPSC_Queue *queue, void *element);
+
+/**
+ * @brief Return the number of queued elements.
+ *
+ * @param queue Pointer to the queue.
+ *
+ * @return The number of elements that can be read by the consumer.
+ */
+uint32_t SPSC_Queue_Count(const SPSC_Queue *queue);
+
+/**
+ * @brief Return the number of elements dropped because the queue was full.
+ *
+ * @param queue Pointer to the queue.
+ *
+ * @return The number of dropped elements since SPSC_Queue_Init.
+ */
+uint32_t SPSC_Queue_Get_Dropped(const SPSC_Queue *queue);
+
+#endif /* INC_SPSC_QUEUE_H_ */
@@ -0,0 +1,189 @@
+/**
+ * @file Scheduler.h
+ * @brief Header file for the Scheduler driver.
+ *
+ * This file contains the function definitions for the Scheduler driver.
+ * It runs periodic tasks from a common tick (the SysTick interrupt), so every subsystem
+ * declares its period, priority, and deadline in one place instead of using its own timer or delay loop.
+ *
+ * Task contexts:
+ *  - SCHEDULER_CONTEXT_TICK: The task runs inside Scheduler_Tick, so it preempts every background task.
+ *    Use it for the control loop and the short acquisition tasks that must run at a fixed rate.
+ *  - SCHEDULER_CONTEXT_BACKGROUND: The task is released by Scheduler_Tick and runs to completion in
+ *    Scheduler_Run (cooperative). Use it for the display, the logging, and the other slow tasks.
+ *
+ * Event tasks:
+ *  - A background task added with a period of SCHEDULER_EVENT_TASK is never released by the tick.
+ *    It is released by Scheduler_Post, usually from the interrupt handler that produced the data,
+ *    so the handler stays short and the work runs in the main loop after the CPU has been woken up.
+ *
+ * Priorities:
+ *  - A lower value is a higher priority. Tick tasks run in priority order at every tick, and the ready
+ *    background task with the highest priority runs first. Tasks with the same priority run in the order
+ *    in which they have been added.
+ *
+ * Timing statistics (measured with the DWT cycle counter, CycleCounter_Init must be called):
+ *  - Response time: MCLK cycles from the release of the task to the end of its execution.
+ *    A response time longer than the deadline is counted as a deadline miss.
+ *  - Overrun: The task is released again before the previous release has completed. The release is dropped.
+ *  - The CPU sleeps with WaitForInterrupt when no background task is ready, and the sleep time is counted
+ *    as idle cycles.
+ *
+ */
+
+#ifndef INC_SCHEDULER_H_
+#define INC_SCHEDULER_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Memory_Config.h"
+
+// Deadline of a task that only needs to complete before its next release
+#define SCHEDULER_NO_DEADLINE       0
+
+// Period of a background task that is only released by Scheduler_Post
+#define SCHEDULER_EVENT_TASK        0
+
+/**
+ * @brief Execution contexts of the tasks.
+ */
+typedef enum
+{
+    SCHEDULER_CONTEXT_TICK,
+    SCHEDULER_CONTEXT_BACKGROUND
+} Scheduler_Context;
+
+/**
+ * @brief Timing statistics of a task.
+ */
+typedef struct
+{
+    uint32_t Run_Count;
+    uint32_t Overrun_Count;
+    uint32_t Deadline_Miss_Count;
+    uint32_t Last_Response_Cycles;
+    uint32_t Max_Response_Cycles;
+} Scheduler_Task_Stats;
+
+/**
+ * @brief Remove every task and clear the statistics.
+ *
+ * @param tick_cycles The number of MCLK cycles between two calls of Scheduler_Tick.
+ *
+ * @return None
+ */
+void Scheduler_Init(uint32_t tick_cycles);
+
+/**
+ * @brief Add a periodic task or an event task. The first release of a periodic task is at the next tick.
+ *
+ * @param task            The function executed at every release.
+ * @param context         The context in which the task is executed.
+ * @param period_ticks    The period of the task in ticks (at least 1),
+ *                        or SCHEDULER_EVENT_TASK for a background task released by Scheduler_Post.
+ * @param priority        The priority of the task (0 is the highest priority).
+ * @param deadline_cycles The maximum response time in MCLK cycles, or SCHEDULER_NO_DEADLINE for the period
+ *                        (one tick for an event task).
+ *
+ * @note Tasks must be added before the first call of Scheduler_Tick.
+ *
+ * @return The identifier of the task, or -1 if the task list is full or a tick task has a period of 0.
+ */
+int Scheduler_Add_Task(void (*task)(void), Scheduler_Context context, uint16_t period_ticks, uint8_t priority, uint32_t deadline_cycles);
+
+/**
+ * @brief Change the number of MCLK cycles of a tick after the frequency of MCLK has changed (see Clock_Set_Profile).
+ *
+ * The deadlines of the tasks are scaled by the same ratio, so that they keep their duration.
+ *
+ * @param tick_cycles The new number of MCLK cycles between two calls of Scheduler_Tick.
+ *
+ * @return None
+ */
+void Scheduler_Set_Tick_Cycles(uint32_t tick_cycles);
+
+/**
+ * @brief Change the period of a periodic task, for example to run the control loop less often while the robot is parked.
+ *
+ * The deadline of the task is kept. The task may change its own period, also from a tick task.
+ *
+ * @param id           The identifier returned by Scheduler_Add_Task.
+ * @param period_ticks The new number of ticks between two releases (not SCHEDULER_EVENT_TASK).
+ *
+ * @return 0 if the period has been changed, or -1 if the identifier is invalid or the task is an event task.
+ */
+int Scheduler_Set_Period(int id, uint16_t period_ticks);
+
+/**
+ * @brief Release the periodic tasks and execute the tick tasks.
+ *
+ * This function must be called from the periodic interrupt that provides the tick (the SysTick_Handler).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Scheduler_Tick(void);
+
+/**
+ * @brief Release an event task.
+ *
+ * This function can be called from an interrupt handler. If the task has not been executed since
+ * the previous post, the post is counted as an overrun and dropped.
+ *
+ * @param id The identifier returned by Scheduler_Add_Task.
+ *
+ * @return 0 if the task has been released, or -1 if the task does not exist or is not a background task.
+ */
+int Scheduler_Post(int id);
+
+/**
+ * @brief Execute the ready background task with the highest priority.
+ *
+ * @param None
+ *
+ * @return 1 if a task has been executed, or 0 if no background task was ready.
+ */
+uint8_t Scheduler_Run_Next(void);
+
+/**
+ * @brief Execute the background tasks forever and sleep when none is ready.
+ *
+ * This function is the main loop of the program and never returns.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Scheduler_Run(void);
+
+/**
+ * @brief Return the number of ticks since Scheduler_Init.
+ *
+ * @param None
+ *
+ * @return The tick counter.
+ */
+uint32_t Scheduler_Get_Ticks(void);
+
+/**
+ * @brief Return the number of MCLK cycles spent sleeping in Scheduler_Run.
+ *
+ * @param None
+ *
+ * @return The idle cycles since Scheduler_Init (wraps around).
+ */
+uint32_t Scheduler_Get_Idle_Cycles(void);
+
+/**
+ * @brief Copy the timing statistics of a task.
+ *
+ * @param id    The identifier returned by Scheduler_Add_Task.
+ * @param stats Pointer to store the statistics.
+ *
+ * @return 0 if the task exists, or -1 otherwise.
+ */
+int Scheduler_Get_Stats(int id, Scheduler_Task_Stats *stats);
+
+#endif /* INC_SCHEDULER_H_ */
@@ -0,0 +1,77 @@
+/**
+ * @file Snapshot.h
+ * @brief Header file for the Snapshot module.
+ *
+ * This file contains the function definitions for the Snapshot module.
+ * A snapshot holds the latest value of a structure written by one interrupt handler, for example a set of
+ * sensor samples, and its timestamp. A reader always gets a coherent copy without disabling the interrupts.
+ *
+ * It is a sequence lock over two buffers:
+ *  - The sequence counts the writes. The latest value is in buffer (sequence & 1), so a write fills the
+ *    other buffer and then increments the sequence.
+ *  - A reader copies the buffer of the sequence it has read, then reads the sequence again. The copy is
+ *    coherent unless a second write has started meanwhile, which reuses the same buffer, and the reader then retries.
+ *
+ * Rules:
+ *  - Only one writer, which is not interrupted by a reader (for example an interrupt handler with a higher
+ *    priority than the SysTick interrupt and the background tasks).
+ *  - A read costs two sequence loads and the copy of the structure. It only retries when the writer runs twice
+ *    during the copy, so the structure must be much faster to copy than the sample period.
+ *
+ */
+
+#ifndef INC_SNAPSHOT_H_
+#define INC_SNAPSHOT_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+// Number of bytes of a snapshot buffer for a structure of the given size
+#define SNAPSHOT_BUFFER_SIZE(size)  (2 * (size))
+
+/**
+ * @brief State of a snapshot, initialized by Snapshot_Init.
+ */
+typedef struct
+{
+    volatile uint32_t Sequence;
+    uint32_t Size;
+    uint8_t *Buffer;
+    uint32_t Timestamp[2];
+} Snapshot;
+
+/**
+ * @brief Initialize a snapshot with an initial value and a sequence of 0.
+ *
+ * @param snapshot Pointer to the snapshot.
+ * @param buffer   Pointer to SNAPSHOT_BUFFER_SIZE(size) bytes of storage.
+ * @param size     The size of the structure in bytes.
+ * @param initial  Pointer to the value returned until the first write.
+ *
+ * @return None
+ */
+void Snapshot_Init(Snapshot *snapshot, void *buffer, uint32_t size, const void *initial);
+
+/**
+ * @brief Publish a new value, called by the writer.
+ *
+ * @param snapshot  Pointer to the snapshot.
+ * @param data      Pointer to the new value.
+ * @param timestamp The time of the value, for example a count of CycleCounter_Read.
+ *
+ * @return None
+ */
+void Snapshot_Write(Snapshot *snapshot, const void *data, uint32_t timestamp);
+
+/**
+ * @brief Copy the latest value and its timestamp.
+ *
+ * @param snapshot  Pointer to the snapshot.
+ * @param data      Pointer to store the value.
+ * @param timestamp Pointer to store the timestamp (may be 0 if not needed).
+ *
+ * @return The sequence of the value: 0 for the initial value, then the number of writes.
+ */
+uint32_t Snapshot_Read(const Snapshot *snapshot, void *data, uint32_t *timestamp);
+
+#endif /* INC_SNAPSHOT_H_ */
@@ -0,0 +1,169 @@
+/**
+ * @file Speed_Controller.h
+ * @brief Header file for the Speed_Controller driver.
+ *
+ * This file contains the function definitions for the Speed_Controller driver.
+ * It runs one proportional-integral (PI) velocity controller per wheel using the tachometer
+ * measurements captured by Timer A3, and updates the Timer A0 PWM duty cycles through Motor_Drive.
+ * Speed_Controller_Update must be called at SPEED_CONTROLLER_RATE_HZ.
+ *
+ * Speed estimation:
+ *  - When a wheel has moved at least SPEED_CONTROLLER_MIN_PERIOD_STEPS steps during the last update,
+ *    the speed is the average of the last TACHOMETER_AVERAGE_LENGTH periods kept by the Tachometer driver.
+ *  - Otherwise, the speed is calculated from the number of steps counted during the last
+ *    SPEED_CONTROLLER_WINDOW_LENGTH updates.
+ *
+ * Control law (duty cycle units, 15000 = 100%):
+ *  - duty = (KFF * setpoint + KP * error + integral) / 256, scaled down by the Traction module while a wheel slips
+ *  - integral = integral + KI * error, limited so that the output cannot wind up past the maximum duty cycle,
+ *    and held while the Traction module scales the duty cycle down
+ *
+ */
+
+#ifndef INC_SPEED_CONTROLLER_H_
+#define INC_SPEED_CONTROLLER_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Motor.h"
+#include "Tachometer.h"
+
+// Rate at which Speed_Controller_Update is called (SysTick)
+#define SPEED_CONTROLLER_RATE_HZ            100
+
+// Distance traveled by a wheel for each tachometer step in um
+#define SPEED_CONTROLLER_UM_PER_STEP        TACHOMETER_UM_PER_STEP
+
+// Minimum number of steps during an update for which the averaged tachometer period is used
+#define SPEED_CONTROLLER_MIN_PERIOD_STEPS   3
+
+// Number of updates used to calculate the speed from the step count (power of two)
+#define SPEED_CONTROLLER_WINDOW_LENGTH      4
+
+// Feedforward, proportional, and integral gains in units of 1/256 duty cycle per mm/s
+#define SPEED_CONTROLLER_KFF                6912
+#define SPEED_CONTROLLER_KP                 2048
+#define SPEED_CONTROLLER_KI                 256
+
+// Maximum duty cycle commanded by the controller (out of 15000)
+#define SPEED_CONTROLLER_MAX_DUTY_CYCLE     14000
+
+// Default limits of the change of the setpoints in mm/s^2 (0 for no limit), set by Speed_Controller_Init
+// Note: 2000 mm/s^2 is 20 mm/s per update, below the traction limit of the TI-RSLK MAX wheels
+#ifndef SPEED_CONTROLLER_MAX_ACCELERATION
+#define SPEED_CONTROLLER_MAX_ACCELERATION   2000
+#endif
+#ifndef SPEED_CONTROLLER_MAX_DECELERATION
+#define SPEED_CONTROLLER_MAX_DECELERATION   2000
+#endif
+
+/**
+ * @brief Initialize the Speed_Controller driver.
+ *
+ * The controller starts disabled. The Motor and Tachometer drivers must be initialized before
+ * Speed_Controller_Update is called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Speed_Controller_Init();
+
+/**
+ * @brief Set the speed setpoints and enable closed-loop control of the motors.
+ *
+ * While the controller is enabled, Speed_Controller_Update overwrites the motor duty cycles.
+ * A setpoint of 0 mm/s disables the corresponding motor output and clears its integral term.
+ *
+ * The average speed of the wheels ramps to the new value within the acceleration and deceleration
+ * limits (see Speed_Controller_Set_Limits), and the difference between the wheels (the curvature)
+ * is applied at once. When the controller is enabled, the ramp starts from the measured speed.
+ *
+ * @param left_speed  The left wheel speed setpoint in mm/s (positive moves forward).
+ * @param right_speed The right wheel speed setpoint in mm/s (positive moves forward).
+ *
+ * @return None
+ */
+void Speed_Controller_Set_Speed(int16_t left_speed, int16_t right_speed);
+
+/**
+ * @brief Set the limits of the change of the setpoints.
+ *
+ * The limits apply to the average speed of the wheels. The acceleration limit applies when its
+ * magnitude increases, and the deceleration limit when it decreases (including the part of a
+ * reversal down to 0 mm/s).
+ *
+ * @param acceleration The maximum acceleration in mm/s^2, or 0 for no limit.
+ * @param deceleration The maximum deceleration in mm/s^2, or 0 for no limit.
+ *
+ * @note The profiled drives of the Motion driver plan their deceleration with the lower of their
+ *       acceleration and these limits, so they still reach their target distance.
+ *
+ * @return None
+ */
+void Speed_Controller_Set_Limits(uint16_t acceleration, uint16_t deceleration);
+
+/**
+ * @brief Return the limits of the change of the setpoints.
+ *
+ * @param acceleration Pointer to store the maximum acceleration in mm/s^2 (0 for no limit).
+ * @param deceleration Pointer to store the maximum deceleration in mm/s^2 (0 for no limit).
+ *
+ * @return None
+ */
+void Speed_Controller_Get_Limits(uint16_t *acceleration, uint16_t *deceleration);
+
+/**
+ * @brief Disable closed-loop control and clear the integral terms.
+ *
+ * The motors keep the last duty cycle until another driver updates them.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Speed_Controller_Disable();
+
+/**
+ * @brief Indicate if closed-loop control is enabled.
+ *
+ * @param None
+ *
+ * @return 1 if the controller is enabled, or 0 otherwise.
+ */
+uint8_t Speed_Controller_Is_Enabled();
+
+/**
+ * @brief Estimate the speed of both wheels and update the motor duty cycles.
+ *
+ * The speed estimate is updated even when the controller is disabled, so Speed_Controller_Get_Speed
+ * can be used with open-loop motor commands.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Speed_Controller_Update();
+
+/**
+ * @brief Return the last measured wheel speeds.
+ *
+ * @param left_speed  Pointer to store the left wheel speed in mm/s.
+ * @param right_speed Pointer to store the right wheel speed in mm/s.
+ *
+ * @return None
+ */
+void Speed_Controller_Get_Speed(int16_t *left_speed, int16_t *right_speed);
+
+/**
+ * @brief Return the setpoints of the last update, ramped towards the targets within the acceleration limits.
+ *
+ * @param left_speed  Pointer to store the left wheel setpoint in mm/s (0 while the controller is disabled).
+ * @param right_speed Pointer to store the right wheel setpoint in mm/s (0 while the controller is disabled).
+ *
+ * @return None
+ */
+void Speed_Controller_Get_Setpoint(int16_t *left_speed, int16_t *right_speed);
+
+#endif /* INC_SPEED_CONTROLLER_H_ */
@@ -0,0 +1,82 @@
+/**
+ * @file Stopwatch.h
+ * @brief Header file for the Stopwatch module.
+ *
+ * This file contains the function definitions for the Stopwatch module.
+ * A stopwatch measures a route with the free-running timebase of Timer A3 (see Timer_A3_Get_Time_us),
+ * so its result does not depend on how often the task that reads it is executed:
+ *  - Stopwatch_Start clears the stopwatch and starts it.
+ *  - Stopwatch_Lap returns the time since the previous lap (or the start), for example at every goal of a route.
+ *  - Stopwatch_Stop freezes the elapsed time. Only the first call after a start has an effect, so it can be
+ *    called at every update until the route is restarted.
+ *
+ * The times are kept in us and returned in ms. A stopwatch measures up to 71 minutes.
+ *
+ * @note Timer_A3_Capture_Init (called by Tachometer_Init) must have been called.
+ *
+ */
+
+#ifndef INC_STOPWATCH_H_
+#define INC_STOPWATCH_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "Timer_A3_Capture.h"
+
+/**
+ * @brief State of a stopwatch.
+ */
+typedef struct
+{
+    uint32_t Start_us;
+    uint32_t Lap_us;
+    volatile uint32_t Elapsed_us;
+    volatile uint8_t Running;
+} Stopwatch;
+
+/**
+ * @brief Clear a stopwatch and start it.
+ *
+ * @param stopwatch Pointer to the stopwatch.
+ *
+ * @return None
+ */
+void Stopwatch_Start(Stopwatch *stopwatch);
+
+/**
+ * @brief Return the time since the previous lap of a running stopwatch, or since its start, and start the next lap.
+ *
+ * @param stopwatch Pointer to the stopwatch.
+ *
+ * @return The time of the lap in ms, or 0 if the stopwatch is stopped.
+ */
+uint32_t Stopwatch_Lap(Stopwatch *stopwatch);
+
+/**
+ * @brief Stop a stopwatch and keep its elapsed time. A stopwatch that is already stopped is not changed.
+ *
+ * @param stopwatch Pointer to the stopwatch.
+ *
+ * @return The elapsed time in ms.
+ */
+uint32_t Stopwatch_Stop(Stopwatch *stopwatch);
+
+/**
+ * @brief Return the time elapsed since the start of a stopwatch, or until its stop.
+ *
+ * @param stopwatch Pointer to the stopwatch.
+ *
+ * @return The elapsed time in ms.
+ */
+uint32_t Stopwatch_Read_ms(const Stopwatch *stopwatch);
+
+/**
+ * @brief Return 1 if a stopwatch is running, or 0 if it has been stopped.
+ *
+ * @param stopwatch Pointer to the stopwatch.
+ *
+ * @return 1 or 0.
+ */
+uint8_t Stopwatch_Is_Running(const Stopwatch *stopwatch);
+
+#endif /* INC_STOPWATCH_H_ */
@@ -14,6 +14,7 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "Interrupt_Priority.h"
 
 // The toggle rate for SysTick_Interrupt in ms
 #define SYSTICK_INT_TOGGLE_RATE_MS 1000
@@ -26,7 +27,7 @@
 #define SYSTICK_INT_NUM_CLK_CYCLES 480000
 
 // The priority level of the SysTick interrupt
-#define SYSTICK_INT_PRIORITY 2
+#define SYSTICK_INT_PRIORITY INTERRUPT_PRIORITY_SYSTICK
 
 
 /**
@@ -13,6 +13,11 @@
  *  - P10.5 (Left Encoder A)
  *  - P5.2 (Left Encoder B)
  *
+ * The capture interrupts keep the last TACHOMETER_AVERAGE_LENGTH periods of each wheel in a ring with a
+ * running sum, so the averaged speed is returned in constant time. The ring is cleared when the direction
+ * changes, and when no edge has been captured for TACHOMETER_STALL_TIMEOUT_MS, in which case the wheel
+ * is reported as stopped.
+ *
  * @author Aaron Nanas
  */
 
@@ -24,6 +29,32 @@
 #include "msp.h"
 #include "../inc/Clock.h"
 #include "../inc/Timer_A3_Capture.h"
+#include "../inc/CortexM.h"
+#include "../inc/Snapshot.h"
+
+// Number of periods averaged by Tachometer_Get_Speed and Tachometer_Get_RPM (power of two, at most 16)
+#ifndef TACHOMETER_AVERAGE_LENGTH
+#define TACHOMETER_AVERAGE_LENGTH       8
+#endif
+
+// Time without an edge after which a wheel is considered stopped in ms
+#ifndef TACHOMETER_STALL_TIMEOUT_MS
+#define TACHOMETER_STALL_TIMEOUT_MS     100
+#endif
+
+// Call Tachometer_Right_Int and Tachometer_Left_Int directly from the Timer A3 capture interrupt handlers
+// (see TIMER_A3_CAPTURE_STATIC_HANDLERS), or through the Timer_A3_Capture_Task pointers when set to 0
+#ifndef TACHOMETER_STATIC_HANDLERS
+#define TACHOMETER_STATIC_HANDLERS      1
+#endif
+
+// Frequency of the Timer A3 clock used to measure the period (SMCLK, not divided in the idle clock profile)
+#define TACHOMETER_CLOCK_HZ             12000000
+
+// Number of steps per wheel revolution, and distance traveled by a wheel for each step in um (70 mm * pi / 360)
+// Note: Speed_Controller, Odometry, and Motion derive their distances from TACHOMETER_UM_PER_STEP
+#define TACHOMETER_STEPS_PER_REVOLUTION 360
+#define TACHOMETER_UM_PER_STEP          611
 
 /**
  * @brief Indicates the direction of the motor rotation relative to the front of the robot
@@ -72,6 +103,46 @@ void Tachometer_Get(uint16_t *left_tach,
                     enum Tachometer_Direction *right_dir,
                     int32_t *right_steps);
 
+/**
+ * @brief Get the time of the latest edge of each wheel.
+ *
+ * The capture interrupts publish the measurements of a wheel with the cycle count of its edge, so the age of
+ * the values returned by Tachometer_Get is CycleCounter_Read() - timestamp (MCLK cycles, see Clock_GetFreq).
+ *
+ * @param left_timestamp_cycles:  Pointer to store the cycle count of the latest edge of the left wheel (0 before the first edge)
+ * @param right_timestamp_cycles: Pointer to store the cycle count of the latest edge of the right wheel (0 before the first edge)
+ *
+ * @return None
+ */
+void Tachometer_Get_Timestamps(uint32_t *left_timestamp_cycles, uint32_t *right_timestamp_cycles);
+
+/**
+ * @brief Get the speed of each wheel averaged over the last TACHOMETER_AVERAGE_LENGTH periods.
+ *
+ * The speed is positive when the wheel moves forward, and 0 when the direction has just changed or
+ * when no edge has been captured for TACHOMETER_STALL_TIMEOUT_MS.
+ *
+ * @param left_speed:  Pointer to store the speed of the left wheel in mm/s
+ * @param right_speed: Pointer to store the speed of the right wheel in mm/s
+ *
+ * @note Assumes Tachometer_Init() has been called
+ *
+ * @return None
+ */
+void Tachometer_Get_Speed(int16_t *left_speed, int16_t *right_speed);
+
+/**
+ * @brief Get the rotation speed of each wheel averaged over the last TACHOMETER_AVERAGE_LENGTH periods.
+ *
+ * @param left_centi_rpm:  Pointer to store the rotation speed of the left wheel in units of 0.01 RPM
+ * @param right_centi_rpm: Pointer to store the rotation speed of the right wheel in units of 0.01 RPM
+ *
+ * @note The sign and the stall detection are the same as Tachometer_Get_Speed
+ *
+ * @return None
+ */
+void Tachometer_Get_RPM(int32_t *left_centi_rpm, int32_t *right_centi_rpm);
+
 /**
  * @brief Calculate the average of an unsigned integer buffer.
  *
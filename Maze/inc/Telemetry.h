@@ -0,0 +1,197 @@
+/**
+ * @file Telemetry.h
+ * @brief Header file for the Telemetry driver.
+ *
+ * This file contains the function definitions for the Telemetry driver.
+ * It sends binary, framed, and checksummed packets over EUSCI_A0 using the TX ring buffer
+ * of the EUSCI_A0_UART driver.
+ *
+ * Frame format (before encoding):
+ *  - Byte 0                    Packet type
+ *  - Byte 1                    Sequence number (incremented for every packet sent)
+ *  - Bytes 2 to N+1            Payload (little-endian fields)
+ *  - Bytes N+2 to N+3          CRC-16/CCITT-FALSE of bytes 0 to N+1 (little-endian)
+ *
+ * The frame is encoded using Consistent Overhead Byte Stuffing (COBS) so that it does not
+ * contain any zero bytes and is followed by a single 0x00 delimiter. A receiver can therefore
+ * resynchronize at the next zero byte after an error or a dropped byte.
+ *
+ * The State packet (type 0x01) has a payload of 36 bytes:
+ *  - uint32_t  Timestamp in ms
+ *  - uint16_t  Filtered distance sensor values, left, center, right (ADC counts)
+ *  - int16_t   Converted distance values, left, center, right (mm)
+ *  - int32_t   Wheel steps, left, right
+ *  - uint16_t  Normalized color values, red, green, blue, clear
+ *  - uint8_t   Controller state
+ *  - uint8_t   Flags
+ *  - uint16_t  Number of UART bytes dropped (lower 16 bits)
+ *
+ * The Text packet (type 0x02) has a payload of up to TELEMETRY_MAX_PAYLOAD_LENGTH ASCII characters
+ * without line ending, for example a reply of the Parameters module.
+ *
+ * The Trace packet (type 0x03) has a payload of up to TELEMETRY_TRACE_MAX_RECORDS records of the
+ * Trace module, 16 bytes each in the order of Trace_Entry (see Trace.h).
+ *
+ * The Log packet (type 0x04) has a payload of 40 bytes, a State payload recorded by the Black_Box module:
+ *  - uint16_t  Run number
+ *  - uint16_t  Record number in the run
+ *  - 36 bytes  State packet payload
+ *
+ * The PMOD_Color_Display.py script decodes the frames.
+ *
+ */
+
+#ifndef INC_TELEMETRY_H_
+#define INC_TELEMETRY_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "EUSCI_A0_UART.h"
+#include "Trace.h"
+
+// Maximum payload length in bytes
+#define TELEMETRY_MAX_PAYLOAD_LENGTH    64
+
+// Length of a frame before encoding: type, sequence number, payload, and CRC
+#define TELEMETRY_MAX_FRAME_LENGTH      (TELEMETRY_MAX_PAYLOAD_LENGTH + 4)
+
+// Worst-case length of an encoded frame including the 0x00 delimiter
+#define TELEMETRY_MAX_ENCODED_LENGTH    (TELEMETRY_MAX_FRAME_LENGTH + (TELEMETRY_MAX_FRAME_LENGTH / 254) + 2)
+
+// Packet types
+#define TELEMETRY_PACKET_STATE          0x01
+#define TELEMETRY_PACKET_TEXT           0x02
+#define TELEMETRY_PACKET_TRACE          0x03
+#define TELEMETRY_PACKET_LOG            0x04
+
+// Length of the State packet payload
+#define TELEMETRY_STATE_PAYLOAD_LENGTH  36
+
+// Length of the Log packet payload
+#define TELEMETRY_LOG_PAYLOAD_LENGTH    (TELEMETRY_STATE_PAYLOAD_LENGTH + 4)
+
+// Largest number of trace records in a Trace packet
+#define TELEMETRY_TRACE_MAX_RECORDS     (TELEMETRY_MAX_PAYLOAD_LENGTH / TRACE_RECORD_SIZE)
+
+/**
+ * @brief Robot state sent in a State packet.
+ */
+typedef struct
+{
+    uint32_t Timestamp_ms;
+    uint16_t Filtered_Distance_Left;
+    uint16_t Filtered_Distance_Center;
+    uint16_t Filtered_Distance_Right;
+    int16_t Converted_Distance_Left;
+    int16_t Converted_Distance_Center;
+    int16_t Converted_Distance_Right;
+    int32_t Left_Steps;
+    int32_t Right_Steps;
+    uint16_t Color_Red;
+    uint16_t Color_Green;
+    uint16_t Color_Blue;
+    uint16_t Color_Clear;
+    uint8_t Controller_State;
+    uint8_t Flags;
+} Telemetry_State;
+
+/**
+ * @brief Encode a buffer using Consistent Overhead Byte Stuffing (COBS).
+ *
+ * The output does not contain any zero bytes. The zero delimiter is not appended.
+ *
+ * @param input  Pointer to the bytes to encode.
+ * @param length The number of bytes to encode (up to 254 bytes per code block are supported).
+ * @param output Pointer to the output buffer. It must hold at least length + (length / 254) + 1 bytes.
+ *
+ * @return The number of bytes written to the output buffer.
+ */
+uint32_t Telemetry_COBS_Encode(const uint8_t *input, uint32_t length, uint8_t *output);
+
+/**
+ * @brief Decode a buffer encoded with Telemetry_COBS_Encode, without the zero delimiter.
+ *
+ * @param input   Pointer to the encoded bytes.
+ * @param length  The number of encoded bytes.
+ * @param output  Pointer to the output buffer.
+ * @param maximum The size of the output buffer.
+ *
+ * @return The number of decoded bytes, or -1 if the input contains a zero byte, ends inside a
+ *         code block, or does not fit in the output buffer.
+ */
+int32_t Telemetry_COBS_Decode(const uint8_t *input, uint32_t length, uint8_t *output, uint32_t maximum);
+
+/**
+ * @brief Calculate the CRC-16/CCITT-FALSE checksum of a buffer.
+ *
+ * Polynomial 0x1021, initial value 0xFFFF, no reflection, no final XOR.
+ *
+ * @param data   Pointer to the bytes to check.
+ * @param length The number of bytes.
+ *
+ * @return The 16-bit checksum.
+ */
+uint16_t Telemetry_CRC16(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Frame, encode, and queue a packet in the EUSCI_A0 TX ring buffer.
+ *
+ * The whole frame is dropped if there is not enough room in the TX ring buffer, so a packet is never
+ * truncated by this function.
+ *
+ * @param type    The packet type.
+ * @param payload Pointer to the payload bytes.
+ * @param length  The payload length (up to TELEMETRY_MAX_PAYLOAD_LENGTH bytes).
+ *
+ * @return 0 if the frame has been queued, or -1 if it has been dropped.
+ */
+int Telemetry_Send_Packet(uint8_t type, const uint8_t *payload, uint8_t length);
+
+/**
+ * @brief Serialize the robot state in the format of the State packet payload.
+ *
+ * @param state   Pointer to the robot state.
+ * @param payload Pointer to TELEMETRY_STATE_PAYLOAD_LENGTH bytes.
+ *
+ * @return None
+ */
+void Telemetry_Serialize_State(const Telemetry_State *state, uint8_t *payload);
+
+/**
+ * @brief Serialize and send a State packet.
+ *
+ * @param state Pointer to the robot state.
+ *
+ * @return 0 if the frame has been queued, or -1 if it has been dropped.
+ */
+int Telemetry_Send_State(const Telemetry_State *state);
+
+/**
+ * @brief Serialize and send a Trace packet.
+ *
+ * @param entries Pointer to the trace records.
+ * @param count   The number of records (up to TELEMETRY_TRACE_MAX_RECORDS).
+ *
+ * @return 0 if the frame has been queued, or -1 if it has been dropped.
+ */
+int Telemetry_Send_Trace(const Trace_Entry *entries, uint8_t count);
+
+/**
+ * @brief Send a Log packet with a recorded State payload.
+ *
+ * @param run     The run number.
+ * @param record  The record number in the run.
+ * @param payload Pointer to the TELEMETRY_STATE_PAYLOAD_LENGTH bytes of the recorded State payload.
+ *
+ * @return 0 if the frame has been queued, or -1 if it has been dropped.
+ */
+int Telemetry_Send_Log(uint16_t run, uint16_t record, const uint8_t *payload);
+
+/**
+ * @brief Return the number of frames dropped because the TX ring buffer was full.
+ *
+ * @return Number of dropped frames.
+ */
+uint32_t Telemetry_Get_Dropped_Frames(void);
+
+#endif /* INC_TELEMETRY_H_ */
@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "Profiler.h"
 
 // Periodic interrupt rate of 1 kHz for the Periodic Interrupts and I2C lab
 //#define TIMER_A1_INT_CCR0_VALUE 12000
@@ -54,4 +55,39 @@ void Timer_A1_Interrupt_Init(void(*task)(void), uint16_t period);
  */
 void Timer_A1_Stop(void);
 
+/**
+ * @brief Change the period of the running Timer A1 interrupts.
+ *
+ * The timer is halted, CCR0 is reprogrammed, and the count restarts from 0, so the next interrupt
+ * comes one new period later. The task and the interrupt settings are kept.
+ *
+ * @param period The new period for generating interrupts, in timer ticks.
+ *
+ * @return None
+ */
+void Timer_A1_Set_Period(uint16_t period);
+
+/**
+ * @brief Define TA1_0_IRQHandler with a direct call to the periodic task, bound at compile time.
+ *
+ * The handler of this driver calls the task through the Timer_A1_Task pointer, so the compiler can neither
+ * inline the task nor know which registers it uses. Placing TIMER_A1_STATIC_HANDLER(task) at file scope in
+ * the translation unit that defines the task replaces that handler (which is weak) with one that calls the
+ * task directly, so the task and the functions it calls from the same file can be inlined.
+ *
+ * Timer_A1_Interrupt_Init must still be called to start the timer. Its task argument is then unused.
+ *
+ * @param task The user-defined task function, void task(void).
+ */
+#define TIMER_A1_STATIC_HANDLER(task)           \
+void TA1_0_IRQHandler(void)                     \
+{                                               \
+    PROFILER_START(PROFILER_TA1_0);             \
+    PROFILER_TIMER_LATENCY(PROFILER_TA1_0,      \
+                           TIMER_A1->R);        \
+    TIMER_A1->CCTL[0] &= ~0x0001;               \
+    task();                                     \
+    PROFILER_STOP(PROFILER_TA1_0);              \
+}
+
 #endif /* INC_TIMER_A1_INTERRUPT_H_ */
@@ -8,6 +8,11 @@
  *
  * Timer A3 is used as a base driver for the Tachometer driver.
  *
+ * The timer runs in continuous mode, so CCR2 is also available as a compare channel that requests
+ * an interrupt at a fixed interval (see Timer_A3_Compare_Start), used by the Buzzer driver.
+ * Its overflows are counted to extend the 16-bit count into a free-running timebase (see Timer_A3_Get_Time_us),
+ * which runs from SMCLK and is not affected by the frequency profiles of MCLK.
+ *
  * @author Aaron Nanas
  */
 
@@ -16,6 +21,7 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "Profiler.h"
 
 // Declare pointer to the user-defined function
 void (*Timer_A3_Capture_Task_0)(uint16_t time);
@@ -43,4 +49,107 @@ void (*Timer_A3_Capture_Task_1)(uint16_t time);
  */
 void Timer_A3_Capture_Init(void(*task0)(uint16_t time), void(*task1)(uint16_t time));
 
+/**
+ * @brief Request an interrupt every interval timer ticks with the CCR2 compare channel.
+ *
+ * The TA3_N interrupt adds the interval to CCR2 and calls the user-defined function, so the capture
+ * channels keep running. A call while the channel is running restarts it with the new interval.
+ *
+ * @param task:     Pointer to a user-function that is called at every interval
+ * @param interval: Time between two calls in units of 83.3 ns (at least 600, or 50 us)
+ *
+ * @note Assumes Timer_A3_Capture_Init() has been called
+ *
+ * @return None
+ */
+void Timer_A3_Compare_Start(void(*task)(void), uint16_t interval);
+
+/**
+ * @brief Disable the interrupt of the CCR2 compare channel.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Timer_A3_Compare_Stop(void);
+
+/**
+ * @brief Return the time elapsed since Timer_A3_Capture_Init, from the count of Timer A3 and its overflows.
+ *
+ * @param None
+ *
+ * @note Can be called from any context. The overflow interrupt has the priority of TA3_N.
+ *
+ * @return The time in us (wraps around after 71 minutes).
+ */
+uint32_t Timer_A3_Get_Time_us(void);
+
+/**
+ * @brief Clear the overflow flag (TAIFG) and count the overflow of the timebase.
+ *
+ * Called by the TA3_N interrupt handler when TAIFG is set, both the one of this driver and the one of
+ * TIMER_A3_CAPTURE_STATIC_HANDLERS.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Timer_A3_Overflow_Handler(void);
+
+/**
+ * @brief Serve the CCR2 compare channel: schedule the next compare and call its task if its interrupt is pending.
+ *
+ * Called by the TA3_N interrupt handler, both the one of this driver and the one of TIMER_A3_CAPTURE_STATIC_HANDLERS.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Timer_A3_Compare_Handler(void);
+
+/**
+ * @brief Define TA3_0_IRQHandler and TA3_N_IRQHandler with direct calls to the capture tasks, bound at compile time.
+ *
+ * The handlers of this driver call the capture tasks through the Timer_A3_Capture_Task pointers. Placing
+ * TIMER_A3_CAPTURE_STATIC_HANDLERS(task0, task1) at file scope in the translation unit that defines the tasks
+ * replaces those handlers (which are weak) with ones that call the tasks directly, so that they can be inlined.
+ * The overflow of the timebase and the CCR2 compare channel are still served through Timer_A3_Overflow_Handler
+ * and Timer_A3_Compare_Handler, which are only called when their interrupt is pending.
+ *
+ * Timer_A3_Capture_Init must still be called to start the timer. Its task arguments are then unused.
+ *
+ * @param task0 The capture task of CCR0 (P10.4), void task0(uint16_t time).
+ * @param task1 The capture task of CCR1 (P10.5), void task1(uint16_t time).
+ */
+#define TIMER_A3_CAPTURE_STATIC_HANDLERS(task0, task1)  \
+void TA3_0_IRQHandler(void)                             \
+{                                                       \
+    PROFILER_START(PROFILER_TA3_0);                     \
+    PROFILER_TIMER_LATENCY(PROFILER_TA3_0,              \
+        (uint16_t)(TIMER_A3->R - TIMER_A3->CCR[0]));    \
+    TIMER_A3->CCTL[0] &= ~0x0001;                       \
+    task0(TIMER_A3->CCR[0]);                            \
+    PROFILER_STOP(PROFILER_TA3_0);                      \
+}                                                       \
+void TA3_N_IRQHandler(void)                             \
+{                                                       \
+    PROFILER_START(PROFILER_TA3_N);                     \
+    if (TIMER_A3->CCTL[1] & 0x0001)                     \
+    {                                                   \
+        PROFILER_TIMER_LATENCY(PROFILER_TA3_N,          \
+            (uint16_t)(TIMER_A3->R - TIMER_A3->CCR[1]));\
+        TIMER_A3->CCTL[1] &= ~0x0001;                   \
+        task1(TIMER_A3->CCR[1]);                        \
+    }                                                   \
+    if (TIMER_A3->CTL & 0x0001)                         \
+    {                                                   \
+        Timer_A3_Overflow_Handler();                    \
+    }                                                   \
+    if ((TIMER_A3->CCTL[2] & 0x0011) == 0x0011)         \
+    {                                                   \
+        Timer_A3_Compare_Handler();                     \
+    }                                                   \
+    PROFILER_STOP(PROFILER_TA3_N);                      \
+}
+
 #endif /* INC_TIMER_A3_CAPTURE_H_ */
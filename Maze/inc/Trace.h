@@ -0,0 +1,152 @@
+/**
+ * @file Trace.h
+ * @brief Header file for the Trace module.
+ *
+ * This file contains the function definitions for the Trace module.
+ * It records a binary trace of events in a ring buffer in SRAM while the robot is running, so that
+ * the sequence of a run can be analyzed after the run without printing anything during it.
+ *
+ * Every record has a fixed size of 16 bytes:
+ *  - uint32_t  Timestamp (CycleCounter_Read, in MCLK cycles at the frequency of the last TRACE_EVENT_START or TRACE_EVENT_CLOCK)
+ *  - uint16_t  Event ID (TRACE_EVENT_*)
+ *  - uint16_t  Sequence number (lower 16 bits of the number of records since Trace_Start)
+ *  - uint32_t  First payload word
+ *  - uint32_t  Second payload word
+ *
+ * Rules:
+ *  - Trace_Record can be called from the interrupt handlers and the tasks. The record is written with
+ *    the interrupts disabled for a few stores, so the records are in the order of their timestamps.
+ *  - The ring keeps the last TRACE_BUFFER_SIZE records and overwrites the oldest ones.
+ *  - Nothing is recorded before Trace_Start or after Trace_Stop, so the trace can be frozen and read
+ *    while the robot is still running.
+ *  - The timestamp wraps around every 89 s at 48 MHz, so two consecutive records must be less than 89 s apart
+ *    to be ordered by the decoder.
+ *  - The MCLK frequency changes with the clock profile, so the decoder converts the cycles with the frequency
+ *    recorded by the last TRACE_EVENT_START or TRACE_EVENT_CLOCK, or 48 MHz before the first one.
+ *
+ * The main program dumps the trace when it receives the "trace dump" command, as Trace packets of
+ * the Telemetry driver (type 0x03), and the PMOD_Color_Display.py script decodes them.
+ *
+ */
+
+#ifndef INC_TRACE_H_
+#define INC_TRACE_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "Clock.h"
+#include "Memory_Config.h"
+
+// Size of a record in bytes
+#define TRACE_RECORD_SIZE               16
+
+// Event IDs and their payload words
+#define TRACE_EVENT_START               0x0001  // Trace started: buffer size, MCLK frequency in Hz
+#define TRACE_EVENT_ROUTE               0x0010  // Trial of Route_Race changed: state, strategy | (trial << 8)
+#define TRACE_EVENT_MAZE_CELL           0x0011  // Controller_2 in the center of a cell: x | (y << 8) | (heading << 16), goal reached
+#define TRACE_EVENT_JUNCTION            0x0012  // Junction type changed: type | (open sides << 8), odometry distance in um
+#define TRACE_EVENT_MOTION_START        0x0020  // Motion command started: type, amount
+#define TRACE_EVENT_MOTION_FINISH       0x0021  // Motion command finished: result, elapsed ticks
+#define TRACE_EVENT_BUMPER              0x0030  // Bumper contact: new contacts, state of the switches
+#define TRACE_EVENT_SLIP                0x0031  // Wheel slip segment started (1) or ended (0): started | (wheels << 8), odometry distance in um
+#define TRACE_EVENT_DEADLINE_MISS       0x0040  // Scheduler task missed its deadline: task index, response cycles
+#define TRACE_EVENT_PARAMETER           0x0050  // Parameter changed: registry index, value
+#define TRACE_EVENT_RATE                0x0060  // Rate policy level applied: level, sample rate in Hz
+#define TRACE_EVENT_CLOCK               0x0061  // Clock profile applied: profile, MCLK frequency in Hz
+
+// First event ID free for temporary events during a debugging session
+#define TRACE_EVENT_USER                0x8000
+
+/**
+ * @brief Record of the trace.
+ */
+typedef struct
+{
+    uint32_t Timestamp_Cycles;
+    uint16_t Event;
+    uint16_t Sequence;
+    uint32_t Arg0;
+    uint32_t Arg1;
+} Trace_Entry;
+
+/**
+ * @brief Clear the trace and start recording, then record a TRACE_EVENT_START event.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Start(void);
+
+/**
+ * @brief Stop recording and keep the records, for example before they are dumped.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Stop(void);
+
+/**
+ * @brief Continue recording after Trace_Stop without clearing the records.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Resume(void);
+
+/**
+ * @brief Indicate if the events are recorded.
+ *
+ * @param None
+ *
+ * @return 1 between Trace_Start or Trace_Resume and Trace_Stop, 0 otherwise.
+ */
+uint8_t Trace_Is_Active(void);
+
+/**
+ * @brief Record an event with two payload words, from an interrupt handler or a task.
+ *
+ * It does nothing if the trace is not active.
+ *
+ * @param event The event ID (TRACE_EVENT_*).
+ * @param arg0  The first payload word.
+ * @param arg1  The second payload word.
+ *
+ * @return None
+ */
+void Trace_Record(uint16_t event, uint32_t arg0, uint32_t arg1);
+
+/**
+ * @brief Return the number of records kept in the ring buffer.
+ *
+ * @param None
+ *
+ * @return The number of records that can be read, up to TRACE_BUFFER_SIZE.
+ */
+uint32_t Trace_Get_Count(void);
+
+/**
+ * @brief Return the number of records overwritten since Trace_Start.
+ *
+ * @param None
+ *
+ * @return The number of lost records.
+ */
+uint32_t Trace_Get_Lost(void);
+
+/**
+ * @brief Copy a record, the oldest one first.
+ *
+ * The trace should be stopped, otherwise a new event may overwrite the record while it is copied.
+ *
+ * @param position The position of the record, from 0 to Trace_Get_Count() - 1.
+ * @param entry    Pointer to store the record.
+ *
+ * @return 0 if the record has been copied, or -1 if the position is out of range.
+ */
+int Trace_Read(uint32_t position, Trace_Entry *entry);
+
+#endif /* INC_TRACE_H_ */
@@ -0,0 +1,71 @@
+/**
+ * @file Trace_Dump.h
+ * @brief Header file for the Trace_Dump module.
+ *
+ * This file contains the function definitions for the Trace_Dump module.
+ * It executes the trace commands received by the Parameters module, and sends the records of the trace
+ * (see Trace.h) to the host in the background after a run.
+ *
+ * Commands:
+ *  - trace dump    Stop the trace and send its records, then print "ok trace <count> <lost>" and resume the trace
+ *  - trace start   Clear the trace and start a new one, for example just before a run
+ *
+ * The records are sent as Trace packets when the replies are Text packets of the Telemetry module,
+ * and otherwise as "trace <cycles> <sequence> <event> <arg0> <arg1>" lines.
+ *
+ */
+
+#ifndef INC_TRACE_DUMP_H_
+#define INC_TRACE_DUMP_H_
+
+#include <stdint.h>
+#include "EUSCI_A0_UART.h"
+#include "Telemetry.h"
+#include "Trace.h"
+#include "Parameters.h"
+
+// Number of records sent as lines in one execution of Trace_Dump_Task
+#define TRACE_DUMP_LINES_PER_TASK   8
+
+/**
+ * @brief This function selects how the replies and the records are sent, and cancels a dump.
+ *
+ * @param output  The function that sends a reply line (without line ending), for example the output of the Parameters module.
+ * @param packets 1 to send the records as Trace packets, or 0 to send them as lines with the output function.
+ *
+ * @return None
+ */
+void Trace_Dump_Init(void (*output)(const char *line), uint8_t packets);
+
+/**
+ * @brief This function executes the trace commands received by the Parameters module.
+ *
+ * @param arguments      The words of the command line.
+ * @param argument_count The number of words.
+ *
+ * @return 0 if the command has been executed, or -1 if it is not a trace command.
+ */
+int Trace_Dump_Command(char **arguments, uint8_t argument_count);
+
+/**
+ * @brief This function sends the next records of a trace dump, executed in the background.
+ *
+ * The records are only queued while the TX ring buffer has room for them. Otherwise the dump continues
+ * in the next execution, so a dump does not drop any record.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Dump_Task(void);
+
+/**
+ * @brief This function returns 1 while the trace is dumped, so that the other packets can be held back.
+ *
+ * @param None
+ *
+ * @return 1 if a dump is running, or 0 otherwise.
+ */
+uint8_t Trace_Dump_Is_Active(void);
+
+#endif /* INC_TRACE_DUMP_H_ */
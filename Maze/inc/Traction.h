@@ -0,0 +1,143 @@
+/**
+ * @file Traction.h
+ * @brief Header file for the Traction module.
+ *
+ * This file contains the function definitions for the Traction module.
+ * It detects the wheel slip from the tachometer speeds, reduces the duty cycles of the motors while a wheel slips,
+ * and counts the slip segments, in which the odometry distance and the step counts of the Motion drives are suspect.
+ *
+ * Detection, for each wheel at every control tick:
+ *  - Acceleration envelope: the speed magnitude increases by more than TRACTION_MAX_ACCELERATION allows in one tick.
+ *    A wheel with grip cannot spin up faster than the chassis, so this also catches the open-loop drives.
+ *  - Commanded profile: while the Speed_Controller drives the wheel, its speed stays more than TRACTION_SLIP_MARGIN
+ *    above the ramped setpoint for TRACTION_DETECT_TICKS consecutive ticks.
+ *  - A wheel slower than commanded is stalled or blocked, not slipping, so it is not detected here.
+ *
+ * Reaction:
+ *  - Every tick with a slip multiplies the duty cycle scale by TRACTION_DUTY_SCALE / 256, down to
+ *    TRACTION_MIN_DUTY_SCALE / 256. Traction_Limit_Duty_Cycle applies the scale to the duty cycles of the
+ *    Speed_Controller and of the open-loop turns and drives of the Motion driver.
+ *  - The scale is held for TRACTION_HOLD_TICKS after the last slip, then returns to 1 by TRACTION_DUTY_RECOVERY / 256
+ *    per tick. The Speed_Controller holds its integral terms while the scale is below 1, so it does not wind up.
+ *
+ * Odometry segments:
+ *  - A segment starts at the odometry distance of the first tick with a slip, and ends once the scale is released.
+ *    It is recorded in the trace (TRACE_EVENT_SLIP) at its start and its end.
+ *  - Traction_Get_Segment_Count counts the segments that have started. A mapper that saves the count at the start
+ *    of a drive knows at its end if the step counts of the drive are suspect.
+ *
+ * Traction_Update must be called once per control tick, after Speed_Controller_Update. The module does not access
+ * the hardware, so it is also compiled by the host simulator.
+ *
+ */
+
+#ifndef INC_TRACTION_H_
+#define INC_TRACTION_H_
+
+#include <stdint.h>
+
+// Largest acceleration of a wheel with grip in mm/s^2
+// Note: The Speed_Controller ramps at 2000 mm/s^2, but the speed estimate jumps by up to 80 mm/s in one tick when it
+//       changes from the step window to the averaged tachometer periods, so the envelope stays above 8000 mm/s^2
+#ifndef TRACTION_MAX_ACCELERATION
+#define TRACTION_MAX_ACCELERATION   15000
+#endif
+
+// Speed above the setpoint of the Speed_Controller from which a wheel slips in mm/s
+#ifndef TRACTION_SLIP_MARGIN
+#define TRACTION_SLIP_MARGIN        150
+#endif
+
+// Number of consecutive ticks above the setpoint before a slip is detected
+#ifndef TRACTION_DETECT_TICKS
+#define TRACTION_DETECT_TICKS       2
+#endif
+
+// Duty cycle scale applied at every tick with a slip, and its lower limit (in 1/256)
+#ifndef TRACTION_DUTY_SCALE
+#define TRACTION_DUTY_SCALE         192
+#endif
+#ifndef TRACTION_MIN_DUTY_SCALE
+#define TRACTION_MIN_DUTY_SCALE     96
+#endif
+
+// Number of ticks without a slip before the scale is released, and its increase per tick after that (in 1/256)
+#ifndef TRACTION_HOLD_TICKS
+#define TRACTION_HOLD_TICKS         10
+#endif
+#ifndef TRACTION_DUTY_RECOVERY
+#define TRACTION_DUTY_RECOVERY      16
+#endif
+
+// Wheels of Traction_Segment.Wheels
+#define TRACTION_WHEEL_LEFT         0x01
+#define TRACTION_WHEEL_RIGHT        0x02
+
+/**
+ * @brief Slip segment of the odometry.
+ */
+typedef struct
+{
+    int32_t Start_Distance_um;
+    int32_t End_Distance_um;
+    uint8_t Wheels;
+    uint8_t Active;
+} Traction_Segment;
+
+/**
+ * @brief This function releases the duty cycle scale and clears the segments.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Traction_Init(void);
+
+/**
+ * @brief This function checks the wheel speeds for a slip and updates the duty cycle scale, once per control tick.
+ *
+ * It reads the speeds and the setpoints of the Speed_Controller, and the distance of the Odometry driver.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Traction_Update(void);
+
+/**
+ * @brief This function scales a duty cycle down while a slip is handled.
+ *
+ * @param duty_cycle The duty cycle of a motor (out of 15000).
+ *
+ * @return The duty cycle to apply.
+ */
+uint16_t Traction_Limit_Duty_Cycle(uint16_t duty_cycle);
+
+/**
+ * @brief This function indicates if the duty cycles are scaled down.
+ *
+ * @param None
+ *
+ * @return 1 if the scale is below 1, or 0 otherwise.
+ */
+uint8_t Traction_Is_Limiting(void);
+
+/**
+ * @brief This function returns the number of slip segments started since Traction_Init.
+ *
+ * @param None
+ *
+ * @return The number of segments, including the active one.
+ */
+uint32_t Traction_Get_Segment_Count(void);
+
+/**
+ * @brief This function returns the last slip segment.
+ *
+ * @param segment Pointer to store the segment. End_Distance_um is the distance of the last slip while it is active.
+ *
+ * @return 1 if a segment has started since Traction_Init, or 0 otherwise.
+ */
+int Traction_Get_Last_Segment(Traction_Segment *segment);
+
+#endif /* INC_TRACTION_H_ */
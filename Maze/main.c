@@ -20,375 +20,1870 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include "msp.h"
 #include "inc/Clock.h"
 #include "inc/CortexM.h"
 #include "inc/GPIO.h"
 #include "inc/EUSCI_A0_UART.h"
+#include "inc/Print_Format.h"
 #include "inc/Motor.h"
+#include "inc/Motor_Inline.h"
 #include "inc/SysTick_Interrupt.h"
 #include "inc/Timer_A1_Interrupt.h"
 #include "inc/LPF.h"
 #include "inc/Analog_Distance_Sensors.h"
 #include "inc/Nokia5110_LCD.h" //New
+#include "inc/Dashboard.h"
 #include "inc/PMOD_Color.h" //NEW
+#include "inc/Color_Classifier.h"
+#include "inc/Tachometer.h"
+#include "inc/Telemetry.h"
+#include "inc/Odometry.h"
+#include "inc/Motion.h"
+#include "inc/Speed_Controller.h"
+#include "inc/Maze_Map.h"
+#include "inc/Maze_Map_Pack.h"
+#include "inc/Maze_Map_Transfer.h"
+#include "inc/Route.h"
+#include "inc/Route_Race.h"
+#include "inc/Controller.h"
+#include "inc/OPT3101.h"
+#include "inc/Distance_Source.h"
+#include "inc/Scheduler.h"
+#include "inc/Profiler.h"
+#include "inc/Power.h"
+#include "inc/Reflectance_Sensor.h"
+#include "inc/Bumper_Switches.h"
+#include "inc/Barcode_Scanner.h"
+#include "inc/Flash_Store.h"
+#include "inc/Parameters.h"
+#include "inc/Trace.h"
+#include "inc/Trace_Dump.h"
+#include "inc/Black_Box.h"
+#include "inc/Black_Box_Dump.h"
+#include "inc/Robot_Link.h"
+#include "inc/OPT3001.h"
+#include "inc/Buzzer.h"
+#include "inc/Stopwatch.h"
+#include "inc/Latency_Test.h"
+#include "inc/Traction.h"
+#include "inc/Rate_Policy.h"
+#include "inc/Rate_Monitor.h"
+#include "inc/Clock_Report.h"
+#include "inc/I2C_Report.h"
+#include "inc/Race_Report.h"
+#include "inc/Latency_Report.h"
+#include "inc/Memory_Config.h"
 
 #define CONTROLLER_1    1
+//#define CONTROLLER_2    1
+
+// Sample the Analog Distance Sensors using Timer_A2-triggered ADC14 conversions and DMA
+// Comment out to sample them from the Timer A1 periodic interrupt instead
+#define ANALOG_DISTANCE_SENSOR_DMA_MODE    1
+
+// Call Timer_A1_Periodic_Task directly from TA1_0_IRQHandler (see TIMER_A1_STATIC_HANDLER), so that it can be inlined
+// with the sampling of the Analog Distance Sensors instead of being called through the Timer_A1_Task pointer
+// Comment out to select the task at run time with Timer_A1_Interrupt_Init
+#define TIMER_A1_STATIC_TASK_ACTIVE    1
+
+// Use the OPT3101 time-of-flight sensor, measured in the background, as the distance source of the controllers
+// Comment out to use the Analog Distance Sensors instead
+//#define OPT3101_ACTIVE  1
+
+// Fuse the OPT3101, the Analog Distance Sensors, and the odometry into one distance per side (requires OPT3101_ACTIVE)
+// Comment out to use the OPT3101 alone
+#define DISTANCE_FUSION_ACTIVE  1
 
 //#define DEBUG_ACTIVE    1
 
-// Initialize constant distance values (in mm)
-#define TOO_CLOSE_DISTANCE  200
-#define TOO_FAR_DISTANCE    400
-#define DESIRED_DISTANCE    200
+// Stop the motors from the PORT4 interrupt when a Bumper Switch makes contact, and record the collision in the maze map
+// Comment out to ignore the Bumper Switches
+#define BUMPER_ACTIVE   1
+
+// Restart the route timer or stop the robot when a maze-start or maze-goal barcode is scanned (EUSCI_A2 interrupt)
+// Comment out when the Barcode Scanner is not fitted
+//#define BARCODE_SCANNER_ACTIVE  1
+
+// Sample the QTRX reflectance sensor array from the Timer32_1 interrupt (for the tape of the cell boundaries)
+// Comment out when the sensor array is not fitted
+//#define REFLECTANCE_SENSOR_ACTIVE   1
+
+// Decay time of the reflectance sensors and time between two samples in us: 1 kHz line pattern
+#define REFLECTANCE_SENSOR_SAMPLE_TIME_US   1000
+#define REFLECTANCE_SENSOR_PERIOD_US        2000
+
+// Restore the color calibration, the distance sensor calibration, and the explored maze map from flash at boot,
+// and save them periodically in the background
+// Comment out to calibrate and explore from scratch at every boot
+#define FLASH_STORE_ACTIVE  1
+
+// Stream binary State packets (decoded by PMOD_Color_Display.py) instead of the text color values
+#define TELEMETRY_ACTIVE    1
+
+// Number of distance sensor sample blocks (4 ms each) between two State packets: 250 Hz
+#define TELEMETRY_DECIMATION    1
+
+// Read and change the tuning parameters with text commands received on EUSCI_A0 (see Parameters.h)
+// The replies are sent as Text packets when TELEMETRY_ACTIVE is defined
+// Comment out to ignore the received bytes
+#define PARAMETERS_ACTIVE   1
+
+// Record the events of the run in a binary trace in SRAM (see Trace.h), dumped after the run with the "trace dump" command
+// of the Trace_Dump module
+// The commands require PARAMETERS_ACTIVE, and the records are sent as Trace packets when TELEMETRY_ACTIVE is defined
+// Comment out to not record the events
+#define TRACE_ACTIVE    1
+
+// Record the State packets of every run in flash (see Black_Box.h), downloaded with the "blackbox dump" command
+// A run starts at every reset and every restart of the route timer. The commands require PARAMETERS_ACTIVE
+// Comment out to not program the flash during the runs
+#define BLACK_BOX_ACTIVE    1
+
+// Exchange the maze map and the pose of Controller_2 with a second robot over EUSCI_A3 (see Robot_Link.h)
+// The robot that reaches the goal sends its map, and a robot that receives a map drives the shortest path to the same goal
+// Note: EUSCI_A3 and P9.6 then run the link instead of the Nokia5110 LCD (requires CONTROLLER_2)
+// Comment out to use the Nokia5110 LCD
+//#define MAP_SHARING_ACTIVE  1
 
-// Initialize constant PWM duty cycle values for the motors
-#define PWM_NOMINAL         2500
-#define PWM_SWING           1000
-#define PWM_MIN             (PWM_NOMINAL - PWM_SWING)
-#define PWM_MAX             (PWM_NOMINAL + PWM_SWING)
+// Measure the ambient light with the OPT3001 in continuous conversions, and remove it from the PMOD Color samples
+// before they are classified. A lux change beyond OPT3001_WINDOW_PERCENT is signaled on INT (P4.2)
+// Note: P4.2 and P4.5 (OPT3001 power) are also BUMP_1 and BUMP_3, so BUMPER_ACTIVE must be commented out
+// Comment out when the OPT3001 is not fitted
+//#define AMBIENT_LIGHT_ACTIVE    1
+
+// Play the audible cues (route start, red tape, goal) on the Piezo Buzzer from the Timer A3 CCR2 compare interrupt,
+// while a tick task walks through the notes of the tune
+// Comment out to keep the buzzer silent
+#define BUZZER_ACTIVE   1
+
+// Slow MCLK down to 48 MHz / CLOCK_IDLE_MCLK_DIVIDER while the user interface waits between two runs (see Clock_Set_Profile),
+// and report the time spent in each profile with the "clock" command. SMCLK and the timers keep their frequency
+// Note: The Timer32 periods of the reflectance sensors are in MCLK cycles, so REFLECTANCE_SENSOR_ACTIVE must be commented out
+// Comment out to keep MCLK at 48 MHz
+#define CLOCK_SCALING_ACTIVE    1
+
+// Detect the wheel slip from the tachometer speeds, scale the duty cycles down while a wheel slips, and keep Controller_2
+// from marking the cells reached after a slip as visited (see Traction.h)
+// Comment out to drive without the slip detection
+#define TRACTION_CONTROL_ACTIVE     1
+
+// Scale the sample rate of the Analog Distance Sensors and the period of the control loop with the state of the robot
+// (see Rate_Policy.h): the full sample rate in the speed run, lower rates while exploring, and the lowest ones parked
+// between two runs. The "rate" command reports the effective rates and the CPU load
+// Comment out to always sample at DISTANCE_SENSOR_SAMPLE_RATE_HZ and run the control loop at every tick
+#define RATE_POLICY_ACTIVE      1
+
+// Test mode: inject synthetic distances with the "latency inject" command, and measure the time until the resulting
+// motor command (see Latency_Test.h), for example with the Latency_Benchmark.py script. Requires PARAMETERS_ACTIVE
+// Comment out to not replace the distances of the Analog Distance Sensors
+//#define LATENCY_TEST_ACTIVE     1
 
 // Declare global variables used to store filtered distance values from the Analog Distance Sensor
 uint32_t Filtered_Distance_Left;
 uint32_t Filtered_Distance_Center;
 uint32_t Filtered_Distance_Right;
 
-// Declare global variables used to store converted distance values from the Analog Distance Sensor
-int32_t Converted_Distance_Left;
-int32_t Converted_Distance_Center;
-int32_t Converted_Distance_Right;
+// Reject the spikes of the Analog Distance Sensors with a median-of-5 stage in front of the low-pass filter
+// Comment out to use the low-pass filter alone
+#define DISTANCE_SENSOR_MEDIAN_ACTIVE   1
+
+// Depth of the low-pass filter used for the Analog Distance Sensors
+// Note: A power of two allows the filter to use a shift instead of a divide
+// Note: The median stage removes the spikes, so a shorter window (8 ms instead of 32 ms at 2 kHz) reduces the lag
+#ifdef DISTANCE_SENSOR_MEDIAN_ACTIVE
+#define DISTANCE_SENSOR_LPF_SIZE    16
+#else
+#define DISTANCE_SENSOR_LPF_SIZE    64
+#endif
+
+#if (DISTANCE_SENSOR_LPF_SIZE > DISTANCE_SENSOR_LPF_MAX_SIZE)
+#error "DISTANCE_SENSOR_LPF_SIZE must not exceed DISTANCE_SENSOR_LPF_MAX_SIZE of Memory_Config.h"
+#endif
+
+// Resolution and sample-and-hold time of the ADC14 conversions of the Analog Distance Sensors, and sample rate of every sensor
+// in DMA mode (see Analog_Distance_Sensor_Configure)
+// Note: A lower resolution or a shorter sample-and-hold time shortens the conversions, and leaves more noise to the filters
+// Note: RATE_POLICY_ACTIVE changes the sample rate at run time, so the telemetry timestamps use the sampled time of the blocks
+#define DISTANCE_SENSOR_ADC_RESOLUTION      ANALOG_DISTANCE_SENSOR_14_BIT
+#define DISTANCE_SENSOR_ADC_SAMPLE_TIME     ANALOG_DISTANCE_SENSOR_SAMPLE_32_CYCLES
+#define DISTANCE_SENSOR_SAMPLE_RATE_HZ      2000
+
+const Analog_Distance_Sensor_Config Distance_Sensor_ADC_Config =
+{
+    DISTANCE_SENSOR_ADC_RESOLUTION,
+    DISTANCE_SENSOR_ADC_SAMPLE_TIME,
+    DISTANCE_SENSOR_SAMPLE_RATE_HZ
+};
+
+// Low-pass filter object and its MACQ for the three Analog Distance Sensors
+// Channel order: A17 (right), A14 (center), A16 (left)
+LPF_Filter Distance_Sensor_LPF;
+uint32_t Distance_Sensor_LPF_Buffer[LPF_BUFFER_LENGTH(DISTANCE_SENSOR_LPF_MAX_SIZE, ANALOG_DISTANCE_SENSOR_NUM_CHANNELS)];
+int32_t Distance_Sensor_LPF_Size = DISTANCE_SENSOR_LPF_SIZE;
+
+#ifdef DISTANCE_SENSOR_MEDIAN_ACTIVE
+// Median-of-5 pre-filter of the three Analog Distance Sensors (same channel order)
+LPF_Median Distance_Sensor_Median;
+#endif
+
+// Standard deviation of the raw values in the filter window of each channel, in ADC counts
+// Note: Updated with every filter output, so the control loop can check it at every tick
+uint32_t Distance_Sensor_Noise[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+
+uint32_t redvalue =0;
+uint32_t greenvalue =0;
+uint32_t bluevalue = 0;
+
+// Colors of the floor and of the red tape, identified by their index in the palette
+#define COLOR_FLOOR     0
+#define COLOR_RED       1
+
+// Smallest confidence of a red tape detection (0 to 255)
+#define COLOR_RED_MIN_CONFIDENCE    128
+
+// Approximate chromaticities (Q10) of the floor and of the red tape with the PMOD Color LED on
+// Note: Measure them on the actual surfaces with Color_Classifier_Get_Chromaticity
+const Color_Classifier_Centroid Color_Centroids[] =
+{
+    { 369, 338, 287 },
+    { 563, 225, 225 }
+};
+const Color_Classifier_Palette Color_Palette =
+{
+    Color_Centroids,
+    sizeof(Color_Centroids) / sizeof(Color_Centroids[0]),
+    20000,
+    50
+};
+
+// Counts added to the raw samples per 1000 lux of room light, used with AMBIENT_LIGHT_ACTIVE
+// Note: Measure them once with the PMOD Color LED off, over the floor, at a known light intensity
+const Color_Classifier_Ambient_Gain Color_Ambient_Gain = { 14, 16, 12, 42 };
+
+// Latest color identified by the user interface, and 1 while the red tape is detected
+Color_Classifier_Result color_result;
+uint8_t Color_Red_Detected = 0;
+
+// Tunes of the audible cues, used with BUZZER_ACTIVE
+const Buzzer_Note Start_Tune[] =
+{
+    { BUZZER_NOTE_C5, 100 },
+    { BUZZER_NOTE_E5, 100 },
+    { BUZZER_NOTE_G5, 200 }
+};
+const Buzzer_Note Red_Tune[] =
+{
+    { BUZZER_NOTE_A4, 80 }
+};
+const Buzzer_Note Goal_Tune[] =
+{
+    { BUZZER_NOTE_G5, 120 },
+    { BUZZER_REST, 40 },
+    { BUZZER_NOTE_G5, 120 },
+    { BUZZER_REST, 40 },
+    { BUZZER_NOTE_C6, 400 }
+};
+
+// Set when the goal tune has been played
+uint8_t Goal_Tune_Played = 0;
+
+// Number of trials of every strategy of the route race
+#define ROUTE_RACE_ROUNDS   2
+
+// Routes recorded during the current trial and during the fastest trial of the race (0xFFFFFFFF ms if none),
+// and the smoothed plan of the speed run that replays the fastest trial
+// SpeedRun: 0 = racing, 1 = replaying, 2 = done, 3 = failed before the end of the route
+Route_Path Race_Trial_Path;
+Route_Path Race_Best_Path;
+uint32_t Race_Best_Time = 0xFFFFFFFF;
+Route_Plan Speed_Run_Plan;
+uint32_t SpeedRun = 0;
+// Time of the speed run in ms
+uint32_t SpeedRunTime = 0;
+const Route_Replay_Config Speed_Run_Config =
+{
+    MAZE_CELL_SIZE,
+    SPEED_RUN_MAX_SPEED,
+    SPEED_RUN_ACCELERATION,
+    SPEED_RUN_CELL_TIMEOUT_TICKS,
+    SPEED_RUN_TURN_DUTY_CYCLE,
+    SPEED_RUN_TURN_TIMEOUT_TICKS,
+    SPEED_RUN_ARC_RADIUS,
+    SPEED_RUN_ARC_SPEED,
+    FOLLOW_SIDE_SENSOR_OFFSET
+};
+
+// Periods of the scheduled tasks in SysTick interrupts (10 ms each)
+#define SCHEDULER_TICKS_PER_SECOND          100
+#define CONTROL_TASK_PERIOD_TICKS           1
+#define USER_INTERFACE_TASK_PERIOD_TICKS    5
+#define DEBUG_TASK_PERIOD_TICKS             50
+#define PROFILER_TASK_PERIOD_TICKS          500
+#define FLASH_STORE_TASK_PERIOD_TICKS       1000
+#define PARAMETERS_TASK_PERIOD_TICKS        5
+#define TRACE_DUMP_TASK_PERIOD_TICKS        1
+#define BLACK_BOX_TASK_PERIOD_TICKS         1
+#define MAP_SHARING_TASK_PERIOD_TICKS       1
+#define AMBIENT_LIGHT_TASK_PERIOD_TICKS     10
+#define BUZZER_TASK_PERIOD_TICKS            1
+#define I2C_WATCHDOG_TASK_PERIOD_TICKS      1
+#define RATE_MONITOR_TASK_PERIOD_TICKS      100
+#define MAP_TRANSFER_TASK_PERIOD_TICKS      1
+
+// Priorities of the scheduled tasks (0 is the highest priority)
+// Note: The PMOD Color read is queued first, then the control loop runs on the latest samples
+#define PMOD_COLOR_TASK_PRIORITY            0
+#define CONTROL_TASK_PRIORITY               1
+#define OPT3101_TASK_PRIORITY               2
+#define USER_INTERFACE_TASK_PRIORITY        0
+#define DEBUG_TASK_PRIORITY                 1
+#define PROFILER_TASK_PRIORITY              2
+#define TELEMETRY_TASK_PRIORITY             1
+#define FLASH_STORE_TASK_PRIORITY           2
+#define PARAMETERS_TASK_PRIORITY            1
+#define TRACE_DUMP_TASK_PRIORITY            2
+#define BLACK_BOX_TASK_PRIORITY             2
+#define MAP_SHARING_TASK_PRIORITY           1
+#define AMBIENT_LIGHT_TASK_PRIORITY         1
+#define BUZZER_TASK_PRIORITY                3
+#define I2C_WATCHDOG_TASK_PRIORITY          3
+#define RATE_MONITOR_TASK_PRIORITY          2
+#define MAP_TRANSFER_TASK_PRIORITY          2
+
+// The control loop must complete within half of the SysTick period, which leaves the other half
+// for the DMA, EUSCI_B1, and Timer interrupts and the background tasks
+#define CONTROL_TASK_DEADLINE_CYCLES        (SYSTICK_INT_NUM_CLK_CYCLES / 2)
+
+// Identifiers of the scheduled tasks, used to read their timing statistics with Scheduler_Get_Stats
+int Control_Task_ID;
+int User_Interface_Task_ID;
+int Telemetry_Task_ID = -1;
+
+// Time of the distance sensor block that released the telemetry task in ms
+volatile uint32_t Telemetry_Timestamp_ms = 0;
+
+// Number of samples of the Analog Distance Sensors taken by the Timer A1 periodic interrupt
+volatile uint32_t Timer_A1_Sample_Count = 0;
+
+// EUSCI_A2 receives the Barcode Scanner lines
+// The dumps of the host commands are sent as binary packets with the telemetry, and as text lines otherwise
+#ifdef TELEMETRY_ACTIVE
+#define HOST_DUMP_PACKETS       1
+#else
+#define HOST_DUMP_PACKETS       0
+#endif
+
+// The map library of the map commands is kept in slots of the flash store
+#ifdef FLASH_STORE_ACTIVE
+#define MAZE_LIBRARY_ACTIVE     1
+#else
+#define MAZE_LIBRARY_ACTIVE     0
+#endif
+
+#ifdef BARCODE_SCANNER_ACTIVE
+#define POWER_UNUSED_EUSCI_A2   0
+#else
+#define POWER_UNUSED_EUSCI_A2   POWER_MODULE_EUSCI_A2
+#endif
+
+// Timer32_1 schedules the reflectance sensor samples
+#ifdef REFLECTANCE_SENSOR_ACTIVE
+#define POWER_UNUSED_TIMER32_1  0
+#else
+#define POWER_UNUSED_TIMER32_1  POWER_MODULE_TIMER32_1
+#endif
+
+// Modules that are not used by the program, held in their lowest power state after the initialization
+// Note: EUSCI_A0 (Print_Format), EUSCI_A3 (Nokia5110), EUSCI_B1 (PMOD Color and OPT3101), Timer_A0-A3, and ADC14
+// are used, and MCLK, HSMCLK, and SMCLK are sourced from HFXT by Clock_Init48MHz, so ACLK (sourced from REFOCLK) is not needed
+#define POWER_UNUSED_MODULES    (POWER_MODULE_EUSCI_A1 | POWER_UNUSED_EUSCI_A2 | POWER_MODULE_EUSCI_B0 | \
+                                 POWER_MODULE_EUSCI_B2 | POWER_MODULE_EUSCI_B3 | POWER_UNUSED_TIMER32_1 | \
+                                 POWER_MODULE_TIMER32_2 | POWER_MODULE_REF_A | POWER_MODULE_COMP_E0 | \
+                                 POWER_MODULE_COMP_E1 | POWER_MODULE_ACLK)
+
+// MCLK cycles per us at the current MCLK frequency, and the boot time measured from the start of the cycle counter
+#define BOOT_CYCLES_PER_US  (Clock_GetFreq() / 1000000)
+uint32_t Boot_Start_Cycles = 0;
+uint32_t Boot_Time_us = 0;
+
+// Stopwatch of the current route, stopped by the control task at the tick that ends the route,
+// and the seconds since its start shown on the LCD
+Stopwatch Route_Stopwatch;
+uint32_t counter = 0;
+
+// Numeric fields of the Nokia5110 LCD redrawn at every user interface update: route timer and speed run time
+Dashboard_Field Route_Timer_Field;
+Dashboard_Field Speed_Run_Field;
+
+// Strategy whose times are shown on the Nokia5110 LCD once the race is done (-1 if none)
+// Note: The pages of the strategies are shown in turn for RACE_PAGE_TICKS
+#define RACE_PAGE_TICKS     (2 * SCHEDULER_TICKS_PER_SECOND)
+int Race_Page = -1;
+
+// Action executed by the user interface when its wait has elapsed (0 if none)
+// Note: The user interface returns immediately while it waits, so the other background tasks keep running
+void (*User_Interface_Resume_Action)(void) = 0;
+uint32_t User_Interface_Resume_Tick = 0;
+
+#ifdef PARAMETERS_ACTIVE
+// Runtime acceleration and deceleration limits of the Speed_Controller (mm/s^2)
+int32_t Speed_Controller_Acceleration = SPEED_CONTROLLER_MAX_ACCELERATION;
+int32_t Speed_Controller_Deceleration = SPEED_CONTROLLER_MAX_DECELERATION;
+
+/**
+ * @brief This function applies the acceleration limits, executed by Parameters_Apply in the control tick.
+ *
+ * @return None
+ */
+void Apply_Speed_Controller_Limits(void)
+{
+    Speed_Controller_Set_Limits(Speed_Controller_Acceleration, Speed_Controller_Deceleration);
+}
+
+/**
+ * @brief This function restarts the low-pass filter of the Analog Distance Sensors with a new depth.
+ *
+ * The filter restarts from the latest filtered values, so the distances do not jump.
+ * It is executed by Parameters_Apply in the control tick.
+ *
+ * @return None
+ */
+void Apply_Distance_Sensor_LPF_Size(void)
+{
+    uint32_t Filtered[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+    uint32_t sr;
+
+    // The distance sensor samples are filtered by a higher-priority interrupt
+    sr = StartCritical();
+    Filtered[0] = Filtered_Distance_Right;
+    Filtered[1] = Filtered_Distance_Center;
+    Filtered[2] = Filtered_Distance_Left;
+    LPF_Filter_Init(&Distance_Sensor_LPF, Distance_Sensor_LPF_Buffer, Distance_Sensor_LPF_Size, ANALOG_DISTANCE_SENSOR_NUM_CHANNELS, Filtered);
+    EndCritical(sr);
+}
+
+#ifdef BLACK_BOX_ACTIVE
+// Number of control ticks per record of the black box
+int32_t Black_Box_Decimation = BLACK_BOX_DEFAULT_DECIMATION;
+
+/**
+ * @brief This function applies the decimation of the black box, executed by Parameters_Apply in the control tick.
+ *
+ * @return None
+ */
+void Apply_Black_Box_Decimation(void)
+{
+    Black_Box_Set_Decimation(Black_Box_Decimation);
+}
+#endif
+
+// Parameters that can be read and changed over EUSCI_A0
+// Note: Append new parameters at the end, a saved record is ignored when the names change
+const Parameter Tuning_Parameters[] =
+{
+    { "desired_distance", &Desired_Distance, 50, 800, 0 },
+    { "set_point", &Set_Point, 50, 800, 0 },
+    { "forward_speed", &Forward_Speed, 0, SPEED_RUN_MAX_SPEED, 0 },
+    { "pivot_duty", &Pivot_Duty_Cycle, 0, PWM_MAX, 0 },
+    { "kp_scale", &Kp_Scale, 0, 4 * WALL_CENTERING_GAIN_SCALE, 0 },
+    { "kd_scale", &Kd_Scale, 0, 4 * WALL_CENTERING_GAIN_SCALE, 0 },
+    { "max_accel", &Speed_Controller_Acceleration, 0, 10000, &Apply_Speed_Controller_Limits },
+    { "max_decel", &Speed_Controller_Deceleration, 0, 10000, &Apply_Speed_Controller_Limits },
+    { "lpf_size", &Distance_Sensor_LPF_Size, 1, DISTANCE_SENSOR_LPF_MAX_SIZE, &Apply_Distance_Sensor_LPF_Size },
+#ifdef BLACK_BOX_ACTIVE
+    { "bb_decimation", &Black_Box_Decimation, 1, 100, &Apply_Black_Box_Decimation }
+#endif
+};
+
+/**
+ * @brief This function sends a reply of the Parameters module.
+ *
+ * @param line The reply, without line ending.
+ *
+ * @return None
+ */
+void Parameters_Output_Line(const char *line)
+{
+#ifdef TELEMETRY_ACTIVE
+    // Text output would corrupt the binary telemetry packets
+    Telemetry_Send_Packet(TELEMETRY_PACKET_TEXT, (const uint8_t *)line, strlen(line));
+#else
+    Print_Format("%s\n", line);
+#endif
+}
+#endif
+
+/**
+ * @brief This function sends a line of text to the host.
+ *
+ * The line is a reply of the Parameters module, so it is sent as a Text packet when TELEMETRY_ACTIVE is defined.
+ *
+ * @param line The line, without line ending.
+ *
+ * @return None
+ */
+void Output_Host_Line(const char *line)
+{
+#ifdef PARAMETERS_ACTIVE
+    Parameters_Output_Line(line);
+#elif !defined TELEMETRY_ACTIVE
+    Print_Format("%s\n", line);
+#endif
+}
+
+#ifdef RATE_POLICY_ACTIVE
+/**
+ * @brief This function changes the sample rate of the distance sensors, selected by the Rate_Monitor module.
+ *
+ * @param sample_rate_hz The sample rate in Hz.
+ *
+ * @return None
+ */
+void Set_Distance_Sample_Rate(uint32_t sample_rate_hz)
+{
+#ifdef ANALOG_DISTANCE_SENSOR_DMA_MODE
+    Analog_Distance_Sensor_Set_Sequence_Rate(sample_rate_hz);
+#else
+    // Timer A1 counts SMCLK cycles
+    Timer_A1_Set_Period(ANALOG_DISTANCE_SENSOR_SMCLK_HZ / sample_rate_hz);
+#endif
+}
+
+/**
+ * @brief This function returns the number of samples of the distance sensors taken since boot, counted by the Rate_Monitor module.
+ *
+ * @param None
+ *
+ * @return The number of samples.
+ */
+uint32_t Get_Distance_Sample_Count(void)
+{
+#ifdef ANALOG_DISTANCE_SENSOR_DMA_MODE
+    return Analog_Distance_Sensor_DMA_Block_Count() * ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE;
+#else
+    return Timer_A1_Sample_Count;
+#endif
+}
+
+// Sampler and timing of the Rate_Monitor module
+const Rate_Monitor_Config Rate_Monitor_Configuration = {&Output_Host_Line, &Set_Distance_Sample_Rate, &Get_Distance_Sample_Count,
+                                                        SCHEDULER_TICKS_PER_SECOND};
+#endif
+
+#ifdef PARAMETERS_ACTIVE
+/**
+ * @brief This function executes the commands that are not parameter commands, selected with Parameters_Set_Command_Handler.
+ *
+ * @param arguments      The words of the command line.
+ * @param argument_count The number of words.
+ *
+ * @return 0 if the command has been executed, or -1 if it is unknown.
+ */
+int Host_Command(char **arguments, uint8_t argument_count)
+{
+#ifdef TRACE_ACTIVE
+    if (Trace_Dump_Command(arguments, argument_count) == 0)
+    {
+        return 0;
+    }
+#endif
+#ifdef BLACK_BOX_ACTIVE
+    if (Black_Box_Dump_Command(arguments, argument_count) == 0)
+    {
+        return 0;
+    }
+#endif
+#ifdef CLOCK_SCALING_ACTIVE
+    if (Clock_Report_Command(arguments, argument_count) == 0)
+    {
+        return 0;
+    }
+#endif
+    if (Race_Report_Command(arguments, argument_count) == 0)
+    {
+        return 0;
+    }
+    if (I2C_Report_Command(arguments, argument_count) == 0)
+    {
+        return 0;
+    }
+#ifdef RATE_POLICY_ACTIVE
+    if (Rate_Monitor_Command(arguments, argument_count) == 0)
+    {
+        return 0;
+    }
+#endif
+#ifdef LATENCY_TEST_ACTIVE
+    if (Latency_Report_Command(arguments, argument_count) == 0)
+    {
+        return 0;
+    }
+#endif
+    if (Maze_Map_Transfer_Command(arguments, argument_count) == 0)
+    {
+        return 0;
+    }
+
+    return -1;
+}
+#endif
+
+// Latest PMOD Color snapshot read by the user interface
+PMOD_Color_Snapshot color_snapshot;
+uint32_t last_color_sample = 0;
+
+/**
+ * @brief This function enables ADC14 and samples the three Analog Distance Sensors.
+ *
+ * This function enables the ADC14 module and samples data from three Analog Distance Sensors (A17, A14, and A16).
+ * It applies a low-pass filter to the raw sensor values and then calibrates them to obtain converted distance values.
+ * The converted distance values are used for distance control and may be optionally printed if debug mode is active.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Sample_Analog_Distance_Sensor()
+{
+    // Declare local arrays for the raw and filtered values of the
+    // Sharp GP2Y0A21YK0F Analog Distance Sensors (A17, A14, A16)
+    uint32_t Raw[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+    uint32_t Filtered[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+    int32_t Converted[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+
+    // Start conversion of Analog Distance Sensor raw values
+    Analog_Distance_Sensor_Start_Conversion(&Raw[0], &Raw[1], &Raw[2]);
+
+    // Reject the spikes, then apply low-pass filter to raw values
+#ifdef DISTANCE_SENSOR_MEDIAN_ACTIVE
+    LPF_Median_Calc_All(&Distance_Sensor_Median, Raw, Raw);
+#endif
+    LPF_Filter_Calc_All(&Distance_Sensor_LPF, Raw, Filtered);
+    Filtered_Distance_Right = Filtered[0];
+    Filtered_Distance_Center = Filtered[1];
+    Filtered_Distance_Left = Filtered[2];
+    LPF_Filter_Noise_All(&Distance_Sensor_LPF, Distance_Sensor_Noise);
+
+    // Convert the filtered distance values of the three channels using the calibration table
+    // Note: The controllers read them from the distance source in the SysTick interrupt
+    Analog_Distance_Sensor_Calibrate_All(Filtered, Converted);
+#ifdef LATENCY_TEST_ACTIVE
+    Latency_Test_Apply(Converted);
+#endif
+    Distance_Source_Update_Sharp(Converted);
+}
+
+/**
+ * @brief This function gathers the current robot state sent in the State packets.
+ *
+ * @param state        Pointer to store the robot state.
+ * @param timestamp_ms The time of the state in ms.
+ *
+ * @return None
+ */
+void Get_Robot_State(Telemetry_State *state, uint32_t timestamp_ms)
+{
+    PMOD_Color_Snapshot color_snapshot;
+    uint16_t left_tach;
+    uint16_t right_tach;
+    enum Tachometer_Direction left_dir;
+    enum Tachometer_Direction right_dir;
+
+    Tachometer_Get(&left_tach, &left_dir, &state->Left_Steps, &right_tach, &right_dir, &state->Right_Steps);
+    PMOD_Color_Get_Snapshot(&color_snapshot);
+
+    state->Timestamp_ms = timestamp_ms;
+    state->Filtered_Distance_Left = Filtered_Distance_Left;
+    state->Filtered_Distance_Center = Filtered_Distance_Center;
+    state->Filtered_Distance_Right = Filtered_Distance_Right;
+    state->Converted_Distance_Left = Converted_Distance_Left;
+    state->Converted_Distance_Center = Converted_Distance_Center;
+    state->Converted_Distance_Right = Converted_Distance_Right;
+    state->Color_Red = color_snapshot.normalized.red;
+    state->Color_Green = color_snapshot.normalized.green;
+    state->Color_Blue = color_snapshot.normalized.blue;
+    state->Color_Clear = color_snapshot.normalized.clear;
+    // Bits 7-4: state of the route race, bits 3-0: strategy of the selected trial (0xF if none)
+    state->Controller_State = (Route_Race_Get_State() << 4) | (Route_Race_Get_Current() & 0x0F);
+    state->Flags = 0;
+}
+
+/**
+ * @brief This function sends the current robot state as a binary telemetry packet.
+ *
+ * @param timestamp_ms The time of the latest distance sensor sample in ms.
+ *
+ * @return None
+ */
+void Send_Telemetry(uint32_t timestamp_ms)
+{
+    Telemetry_State state;
+
+#if defined TRACE_ACTIVE && defined PARAMETERS_ACTIVE
+    // A trace dump uses the whole bandwidth of EUSCI_A0
+    if (Trace_Dump_Is_Active())
+    {
+        return;
+    }
+#endif
+#if defined BLACK_BOX_ACTIVE && defined PARAMETERS_ACTIVE
+    if (Black_Box_Dump_Is_Active())
+    {
+        return;
+    }
+#endif
+
+    Get_Robot_State(&state, timestamp_ms);
+    Telemetry_Send_State(&state);
+}
+
+/**
+ * @brief This function sends a State packet, executed by the scheduler when a distance sensor block has been filtered.
+ *
+ * @return None
+ */
+void Telemetry_Task(void)
+{
+    Send_Telemetry(Telemetry_Timestamp_ms);
+}
+
+/**
+ * @brief User-defined function executed by DMA_INT1 when a block of distance sensor samples is complete.
+ *
+ * Every sample of the block is passed through the low-pass filters so that the filters see the same 2 kHz
+ * sample stream as in the Timer A1 interrupt mode. The calibration formula is only applied once per block
+ * to the latest filtered values.
+ *
+ * @param block        Pointer to the completed block. Each sample holds the A17, A14, and A16 results.
+ * @param sample_count The number of samples in the block.
+ *
+ * @return None
+ */
+void Analog_Distance_Sensor_Block_Task(uint32_t *block, uint32_t sample_count)
+{
+    uint32_t sample_index;
+    uint32_t Filtered[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+#ifdef DISTANCE_SENSOR_MEDIAN_ACTIVE
+    uint32_t Median[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+#endif
+    int32_t Converted[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+
+    // Reject the spikes, then apply low-pass filter to every raw sample in the block
+    for (sample_index = 0; sample_index < sample_count; sample_index++)
+    {
+#ifdef DISTANCE_SENSOR_MEDIAN_ACTIVE
+        LPF_Median_Calc_All(&Distance_Sensor_Median, block, Median);
+        LPF_Filter_Calc_All(&Distance_Sensor_LPF, Median, Filtered);
+#else
+        LPF_Filter_Calc_All(&Distance_Sensor_LPF, block, Filtered);
+#endif
+        block = block + ANALOG_DISTANCE_SENSOR_NUM_CHANNELS;
+    }
+
+    Filtered_Distance_Right = Filtered[0];
+    Filtered_Distance_Center = Filtered[1];
+    Filtered_Distance_Left = Filtered[2];
+    LPF_Filter_Noise_All(&Distance_Sensor_LPF, Distance_Sensor_Noise);
+
+    // Convert the filtered distance values of the three channels using the calibration table
+    // Note: The controllers read them from the distance source in the SysTick interrupt
+    Analog_Distance_Sensor_Calibrate_All(Filtered, Converted);
+#ifdef LATENCY_TEST_ACTIVE
+    Latency_Test_Apply(Converted);
+#endif
+    Distance_Source_Update_Sharp(Converted);
+
+#ifdef TELEMETRY_ACTIVE
+    // Release the telemetry task instead of sending the packet from the DMA interrupt
+    // Note: The main loop wakes up from LPM0 at the end of this interrupt and sends the packet
+    if ((Analog_Distance_Sensor_DMA_Block_Count() % TELEMETRY_DECIMATION) == 0)
+    {
+        Telemetry_Timestamp_ms = Analog_Distance_Sensor_DMA_Time_ms();
+        Scheduler_Post(Telemetry_Task_ID);
+    }
+#endif
+}
+
+void Handle_Red(){
+        PRINT_LITERAL("detected color Red!");
+        Nokia5110_Buffer_SetCursor(0,4);
+        Nokia5110_Buffer_OutString("RedDetected");
+        Nokia5110_DisplayBuffer_DMA();
+        Motor_Stop();
+        Clock_Delay1ms(5000);
+    }
+#ifdef AMBIENT_LIGHT_ACTIVE
+#ifdef BUMPER_ACTIVE
+#error "AMBIENT_LIGHT_ACTIVE and BUMPER_ACTIVE use the same P4 pins."
+#endif
+
+// Light intensity reported by the OPT3001 in 0.01 lux, applied to the color classifier by Ambient_Light_Task
+volatile uint32_t Ambient_Light_Centi_Lux = 0;
+int Ambient_Light_Task_ID = -1;
+
+/**
+ * @brief This function is executed by the EUSCI_B1 interrupt when the OPT3001 lux value has left its window.
+ *
+ * @param centi_lux The new light intensity in 0.01 lux.
+ *
+ * @return None
+ */
+void Ambient_Light_Changed(uint32_t centi_lux)
+{
+    Ambient_Light_Centi_Lux = centi_lux;
+    Scheduler_Post(Ambient_Light_Task_ID);
+}
+
+/**
+ * @brief This function updates the ambient light removed by the color classifier, released by Ambient_Light_Changed.
+ *
+ * Note: It runs in the background like the classification of the user interface, so a sample is never
+ * classified with a partially updated ambient light.
+ *
+ * @return None
+ */
+void Ambient_Light_Task(void)
+{
+    Color_Classifier_Set_Ambient(&Color_Ambient_Gain, Ambient_Light_Centi_Lux);
+}
+#endif
+
+#ifdef MAP_SHARING_ACTIVE
+#ifndef CONTROLLER_2
+#error "MAP_SHARING_ACTIVE requires CONTROLLER_2."
+#endif
+
+// Set when the map has been sent after reaching the goal
+uint8_t Map_Sharing_Sent = 0;
+
+// Map received from the other robot, and the goal cell it has reached, applied by the next control tick
+uint8_t Map_Sharing_Map[MAZE_MAP_STORAGE_SIZE];
+Robot_Link_Pose Map_Sharing_Peer_Pose;
+uint8_t Map_Sharing_Peer_Goal = 0;
+volatile uint8_t Map_Sharing_Pending = 0;
+
+/**
+ * @brief This function exchanges the maze map with the other robot, executed by the scheduler every 10 ms in the background.
+ *
+ * The pose and the map are sent once when the goal is reached, and whenever the other robot requests them.
+ * A received map is handed to the control tick, so Controller_2 never sees a partially replaced map.
+ *
+ * @return None
+ */
+void Map_Sharing_Task(void)
+{
+    Robot_Link_Pose pose;
+    uint8_t map[MAZE_MAP_STORAGE_SIZE];
+
+    Robot_Link_Task();
+
+    if ((Robot_Link_Get_Request() != 0) || ((Maze_Goal_Reached != 0) && (Map_Sharing_Sent == 0)))
+    {
+        pose.X = Maze_X;
+        pose.Y = Maze_Y;
+        pose.Heading = (uint8_t)Maze_Heading;
+        pose.Flags = Maze_Goal_Reached ? ROBOT_LINK_POSE_GOAL_REACHED : 0;
+        Robot_Link_Send_Pose(&pose);
+
+        Maze_Map_Export(map);
+        Robot_Link_Send_Map(map);
+        Map_Sharing_Sent = Maze_Goal_Reached;
+    }
+
+    // The pose is sent before the map, so it is already received when the map is complete
+    if (Robot_Link_Get_Pose(&pose))
+    {
+        Map_Sharing_Peer_Pose = pose;
+        Map_Sharing_Peer_Goal = (pose.Flags & ROBOT_LINK_POSE_GOAL_REACHED) ? 1 : 0;
+    }
+
+    if ((Map_Sharing_Pending == 0) && Robot_Link_Get_Map(Map_Sharing_Map))
+    {
+        Map_Sharing_Pending = 1;
+    }
+}
+#endif
+
+/**
+ * @brief This function is the control loop, executed by the scheduler at every SysTick interrupt (100 Hz).
+ *
+ * The Control_Task updates the pose and the distances and then calls a specific controller function based on the
+ * selected active configuration. Only one of the options can be defined at a time: CONTROLLER_1, CONTROLLER_2, or CONTROLLER_3.
+ */
+void Control_Task(void)
+{
+#ifdef BUMPER_ACTIVE
+    Bumper_Event bumper_event;
+#endif
+#ifdef BLACK_BOX_ACTIVE
+    Telemetry_State robot_state;
+    uint8_t black_box_record[TELEMETRY_STATE_PAYLOAD_LENGTH];
+#endif
+#ifdef RATE_POLICY_ACTIVE
+    int16_t left_speed;
+    int16_t right_speed;
+#endif
+#ifdef PARAMETERS_ACTIVE
+    const uint8_t *loaded_map;
+#endif
+
+    PROFILER_START(PROFILER_CONTROL_TASK);
+
+#ifdef PARAMETERS_ACTIVE
+    // Use the parameters changed over EUSCI_A0 from this tick on
+    Parameters_Apply();
+#endif
+
+    // Update the pose estimate and the recorded route, then advance the active motion primitive before the controller runs
+    Odometry_Update();
+    Route_Record_Update();
+    Route_Replay_Update();
+    Motion_Update();
+
+    // Read the distances of the selected source (Analog Distance Sensors, OPT3101, or their fusion)
+    Distance_Source_Get(&Converted_Distance_Left, &Converted_Distance_Center, &Converted_Distance_Right);
+
+    // Classify the cell around the robot with hysteresis and a dwell time, for the wall follower and the junction events
+    Junction_Update(Converted_Distance_Left, Converted_Distance_Center, Converted_Distance_Right, Desired_Distance);
+
+#ifdef BUMPER_ACTIVE
+    // Handle the collisions queued by the PORT4 interrupt, which has already stopped the motors,
+    // before the controller drives them again
+    while (Bumper_Get_Event(&bumper_event))
+    {
+        // The robot has left the recorded route, so the speed run fails
+        if (Route_Replay_Is_Active())
+        {
+            Route_Replay_Abort();
+        }
+#ifdef CONTROLLER_2
+        Maze_Bumper_Collision();
+#endif
+    }
+    Bumper_Clear_Cutoff();
+#endif
+
+#ifdef MAP_SHARING_ACTIVE
+    // Drive to the goal cell reached by the other robot on the walls it has explored
+    if (Map_Sharing_Pending)
+    {
+        if (Map_Sharing_Peer_Goal)
+        {
+            Maze_Map_Clear_Goals();
+            Maze_Map_Add_Goal(Map_Sharing_Peer_Pose.X, Map_Sharing_Peer_Pose.Y);
+        }
+        Maze_Exploration_Import(Map_Sharing_Map);
+        Map_Sharing_Pending = 0;
+    }
+#endif
+
+#ifdef PARAMETERS_ACTIVE
+    // Replace the map with the one loaded by the map command, and the goal cells if it has any
+    loaded_map = Maze_Map_Transfer_Take_Loaded_Map();
+    if (loaded_map != 0)
+    {
+        Maze_Exploration_Import(loaded_map);
+    }
+#endif
+
+#if defined CONTROLLER_1
+
+    // The debug mode only prints the distances, with the motors stopped
+#ifndef DEBUG_ACTIVE
+    Route_Race_Update();
+#endif
+
+#elif defined CONTROLLER_2
+    #if defined CONTROLLER_1 || CONTROLLER_3
+        #error "Only CONTROLLER_1, CONTROLLER_2, or CONTROLLER_3 can be active at the same time."
+    #endif
+
+    Route_Race_Update();
+
+#elif defined CONTROLLER_3
+    #if defined CONTROLLER_1 || CONTROLLER_2
+#error "Only CONTROLLER_1, CONTROLLER_2, or CONTROLLER_3 can be active at the same time."
+    #endif
+
+    // Your function for Task 2 goes here (Controller_3)
+    //Controller_3();
+
+#else
+    #error "Define either one of the options: CONTROLLER_1, CONTROLLER_2, or CONTROLLER_3."
+#endif
+
+    // Update the wheel speed estimates and apply the setpoints of the controller
+    Speed_Controller_Update();
+
+#ifdef TRACTION_CONTROL_ACTIVE
+    // Compare the new wheel speeds with the setpoints and the acceleration envelope, for the duty cycles of the next tick
+    Traction_Update();
+#endif
+
+#ifdef RATE_POLICY_ACTIVE
+    // Select the sample rate and the control period of the next ticks from the route and the new wheel speeds
+    Speed_Controller_Get_Speed(&left_speed, &right_speed);
+    Rate_Monitor_Apply_Level(Rate_Policy_Update((Route_Race_Get_State() == ROUTE_RACE_RUNNING) || Route_Replay_Is_Active() || Motion_Is_Busy(),
+                                        (SpeedRun == 1), left_speed, right_speed));
+#endif
+
+#ifdef BLACK_BOX_ACTIVE
+    // Record the state seen by the controller in this tick
+    if (Black_Box_Sample_Due())
+    {
+        Get_Robot_State(&robot_state, Scheduler_Get_Ticks() * (1000 / SCHEDULER_TICKS_PER_SECOND));
+        Telemetry_Serialize_State(&robot_state, black_box_record);
+        Black_Box_Log(black_box_record);
+    }
+#endif
+
+    // Stop the route timer in the tick that ends the route, the user interface reads its time later
+    if ((Route_Race_Get_State() == ROUTE_RACE_FINISHED) || ((SpeedRun == 1) && (Route_Replay_Is_Active() == 0)))
+    {
+        Stopwatch_Stop(&Route_Stopwatch);
+    }
+
+    PROFILER_STOP(PROFILER_CONTROL_TASK);
+}
+
+/**
+ * @brief This function is the handler for the SysTick periodic interrupt with a rate of 100 Hz.
+ *
+ * The SysTick interrupt is the tick of the scheduler: it executes the tick tasks (PMOD Color read, control loop)
+ * and releases the background tasks executed by the main loop.
+ */
+void SysTick_Handler(void)
+{
+    PROFILER_START(PROFILER_SYSTICK);
+
+    // The current value counts down from LOAD since the reload that requested the interrupt
+    PROFILER_LATENCY(PROFILER_SYSTICK, SysTick->LOAD - SysTick->VAL);
+
+    Scheduler_Tick();
+
+    PROFILER_STOP(PROFILER_SYSTICK);
+}
+
+/**
+ * @brief User-defined function executed by Timer A1 using a periodic interrupt at a rate of 2 kHz.
+ *
+ * The Timer_A1_Periodic_Task function generates a periodic interrupt with a rate of 2 kHz. It samples the
+ * distance values measured by three Sharp GP2Y0A21YK0F analog distance sensors.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Timer_A1_Periodic_Task(void)
+{
+    Sample_Analog_Distance_Sensor();
+    Timer_A1_Sample_Count = Timer_A1_Sample_Count + 1;
+}
+
+#ifdef TIMER_A1_STATIC_TASK_ACTIVE
+TIMER_A1_STATIC_HANDLER(Timer_A1_Periodic_Task)
+#endif
+
+
+#ifdef CLOCK_SCALING_ACTIVE
+#ifdef REFLECTANCE_SENSOR_ACTIVE
+#error "CLOCK_SCALING_ACTIVE changes the MCLK frequency of the Timer32 used by REFLECTANCE_SENSOR_ACTIVE."
+#endif
+
+// Shortest wait of the user interface that selects the idle profile
+#define CLOCK_IDLE_MIN_WAIT_TICKS   SCHEDULER_TICKS_PER_SECOND
+
+/**
+ * @brief This function selects a clock profile, and gives the scheduler the number of MCLK cycles of a tick at the new frequency.
+ *
+ * @param profile CLOCK_PROFILE_RUN or CLOCK_PROFILE_IDLE.
+ *
+ * @return None
+ */
+void Set_Clock_Profile(Clock_Profile profile)
+{
+    Clock_Set_Profile(profile);
+    Scheduler_Set_Tick_Cycles(Clock_GetFreq() / SCHEDULER_TICKS_PER_SECOND);
+    Trace_Record(TRACE_EVENT_CLOCK, profile, Clock_GetFreq());
+}
+#endif
+
+/**
+ * @brief This function makes the user interface wait without blocking the scheduler.
+ *
+ * @param ticks  The number of SysTick interrupts to wait.
+ * @param action The function executed by the user interface when the wait has elapsed.
+ *
+ * @return None
+ */
+void User_Interface_Wait(uint32_t ticks, void (*action)(void))
+{
+    User_Interface_Resume_Tick = Scheduler_Get_Ticks() + ticks;
+    User_Interface_Resume_Action = action;
+
+#ifdef CLOCK_SCALING_ACTIVE
+    // The robot waits on the start for the next run
+    if (ticks >= CLOCK_IDLE_MIN_WAIT_TICKS)
+    {
+        Set_Clock_Profile(CLOCK_PROFILE_IDLE);
+    }
+#endif
+}
+
+/**
+ * @brief This function writes a line of text on a row of the Nokia5110 LCD buffer, padded with spaces to the width of the screen.
+ *
+ * @param row  The row of the line, from 0 to 5.
+ * @param text The text of the line, truncated to 12 characters.
+ *
+ * @return None
+ */
+void Output_LCD_Line(uint8_t row, const char *text)
+{
+    char line[(SCREENW / NOKIA5110_GLYPH_WIDTH) + 1];
+
+    Print_Format_To_Buffer(line, sizeof(line), "%-12s", text);
+    Nokia5110_Buffer_SetCursor(0, row);
+    Nokia5110_Buffer_OutString(line);
+}
 
-uint32_t redvalue =0;
-uint32_t greenvalue =0;
-uint32_t bluevalue = 0;
-uint32_t RouteOne =0;
-uint32_t RouteTwo = 0;
-uint32_t RouteOneTime = 0;
-uint32_t RouteTwoTime =0;
+/**
+ * @brief This function restarts the route timer.
+ *
+ * @return None
+ */
+void Restart_Route_Timer(void)
+{
+    Stopwatch_Start(&Route_Stopwatch);
+    counter = 0;
+
+#ifdef BUZZER_ACTIVE
+    Buzzer_Play_Tune(Start_Tune, sizeof(Start_Tune) / sizeof(Start_Tune[0]));
+#endif
 
-// Declare global variable used to store the amount of error
-int32_t Error;
+#ifdef BLACK_BOX_ACTIVE
+    // Record every timed route as a separate run
+    Black_Box_Start();
+#endif
+}
 
-// Proportional Controller Gain
-int32_t Kp = 4;
+/**
+ * @brief This function starts the next trial of the route race once the robot has been placed on the start.
+ *
+ * @return None
+ */
+void Start_Race_Trial(void)
+{
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+    int index;
 
-// Initialize set point to 250 mm
-int32_t Set_Point = 250;
+    Restart_Route_Timer();
+    Route_Record_Start(&Race_Trial_Path, MAZE_CELL_SIZE);
+    index = Route_Race_Start_Trial();
+    Trace_Record(TRACE_EVENT_ROUTE, Route_Race_Get_State(), (index & 0xFF) | (Route_Race_Get_Trial() << 8));
 
-// Declare global variables used to update PWM duty cycle values for the motors
-uint16_t Duty_Cycle_Left;
-uint16_t Duty_Cycle_Right;
+    // Strategy and number of the trial
+    Print_Format_To_Buffer(line, sizeof(line), "%-5s %u/%u", Route_Race_Get_Name(index), Route_Race_Get_Trial() + 1, Route_Race_Get_Num_Trials());
+    Output_LCD_Line(0, line);
+}
 
 /**
- * @brief This function enables ADC14 and samples the three Analog Distance Sensors.
+ * @brief This function replays the fastest trial of the race once the robot has been placed back on the start.
  *
- * This function enables the ADC14 module and samples data from three Analog Distance Sensors (A17, A14, and A16).
- * It applies a low-pass filter to the raw sensor values and then calibrates them to obtain converted distance values.
- * The converted distance values are used for distance control and may be optionally printed if debug mode is active.
+ * @return None
+ */
+void Start_Speed_Run(void)
+{
+    Route_Smooth(&Race_Best_Path, &Speed_Run_Config, &Speed_Run_Plan);
+    Route_Replay_Start(&Speed_Run_Plan, &Speed_Run_Config);
+    Restart_Route_Timer();
+    SpeedRun = 1;
+}
+
+/**
+ * @brief This function records the time of the trial that has reached the end of the maze.
  *
- * @param None
+ * The route of the fastest trial is kept for the speed run. The next trial starts after 10 seconds,
+ * for the robot to be placed back on the start, and the speed run starts 10 seconds after the last trial.
  *
  * @return None
  */
-void Sample_Analog_Distance_Sensor()
+void Finish_Race_Trial(void)
 {
-    // Declare local variables for the Sharp GP2Y0A21YK0F Analog Distance Sensors
-    // before passing their addresses
-    uint32_t Raw_A17;
-    uint32_t Raw_A14;
-    uint32_t Raw_A16;
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+    uint32_t time_ms;
+    int index;
 
-    // Start conversion of Analog Distance Sensor raw values
-    Analog_Distance_Sensor_Start_Conversion(&Raw_A17, &Raw_A14, &Raw_A16);
+    Route_Record_Stop();
+    time_ms = Stopwatch_Stop(&Route_Stopwatch);
+    if(time_ms < Race_Best_Time){
+        Race_Best_Path = Race_Trial_Path;
+        Race_Best_Time = time_ms;
+    }
 
-    // Apply low-pass filter to raw values
-    Filtered_Distance_Right = LPF_Calc(Raw_A17);
-    Filtered_Distance_Center = LPF_Calc2(Raw_A14);
-    Filtered_Distance_Left = LPF_Calc3(Raw_A16);
+    index = Route_Race_Record(time_ms);
+    Trace_Record(TRACE_EVENT_ROUTE, Route_Race_Get_State(), (index & 0xFF) | (Route_Race_Get_Trial() << 8));
+    Race_Report_Route_Time(Route_Race_Get_Name(index), time_ms);
+    Race_Report_Stats(index);
 
-    // Convert filtered distance values using the calibration formula
-    Converted_Distance_Left = Analog_Distance_Sensor_Calibrate(Filtered_Distance_Left);
-    Converted_Distance_Center = Analog_Distance_Sensor_Calibrate(Filtered_Distance_Center);
-    Converted_Distance_Right = Analog_Distance_Sensor_Calibrate(Filtered_Distance_Right);
-}
-void Handle_Red(){
-        printf("detected color Red!");
-        Nokia5110_SetCursor(0,4);
-        Nokia5110_OutString("RedDetected");
-        Motor_Stop();
-        Clock_Delay1ms(5000);
+    // Time of the trial and mean time of its strategy
+    Print_Format_To_Buffer(line, sizeof(line), "%-5s %u.%03u", Route_Race_Get_Name(index), time_ms / 1000, time_ms % 1000);
+    Output_LCD_Line(1, line);
+    Print_Format_To_Buffer(line, sizeof(line), "avg %u.%03u", Route_Race_Get_Mean_ms(index) / 1000, Route_Race_Get_Mean_ms(index) % 1000);
+    Output_LCD_Line(2, line);
+    Nokia5110_DisplayBuffer();
+
+    if(Route_Race_Get_State() == ROUTE_RACE_READY){
+        User_Interface_Wait(10 * SCHEDULER_TICKS_PER_SECOND, &Start_Race_Trial);// wait 10 seconds before the next trial
+    }else{
+        User_Interface_Wait(10 * SCHEDULER_TICKS_PER_SECOND, &Start_Speed_Run);
     }
+}
+
 /**
- * @brief This function updates the PWM duty cycle values for the motors based on the measured distance values.
+ * @brief This function draws the times of a strategy on the first four rows of the Nokia5110 LCD.
  *
- * This function calculates the error between the measured distances of the left and right sensors
- * and adjusts the motor duty cycles to maintain a desired distance. It also ensures that the
- * duty cycles remain within the defined range. It is used to drive along walls in a track.
+ * @param index The index of the strategy in the Route_Race registry.
  *
- * @param None
+ * @return None
+ */
+void Draw_Race_Page(int index)
+{
+    const Route_Race_Stats *stats = Route_Race_Get_Stats(index);
+    uint32_t mean_ms = Route_Race_Get_Mean_ms(index);
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+
+    Print_Format_To_Buffer(line, sizeof(line), "%-5s x%u", Route_Race_Get_Name(index), stats->Trials);
+    Output_LCD_Line(0, line);
+    Print_Format_To_Buffer(line, sizeof(line), "min %u.%03u", stats->Min_ms / 1000, stats->Min_ms % 1000);
+    Output_LCD_Line(1, line);
+    Print_Format_To_Buffer(line, sizeof(line), "avg %u.%03u", mean_ms / 1000, mean_ms % 1000);
+    Output_LCD_Line(2, line);
+    Print_Format_To_Buffer(line, sizeof(line), "max %u.%03u", stats->Max_ms / 1000, stats->Max_ms % 1000);
+    Output_LCD_Line(3, line);
+}
+
+
+#ifdef BARCODE_SCANNER_ACTIVE
+/**
+ * @brief This function restarts the route timer, executed by the EUSCI_A2 interrupt when the maze-start barcode is scanned.
  *
  * @return None
  */
-void Turn_Right() {
-    Motor_Right(3500, 3500);  // Set both motors to high speed
-    Clock_Delay1ms(500);  // Delay for 1000 milliseconds (1 second)
-    Motor_Stop();  // Stop the motors after .5 second
+void Barcode_Maze_Start(void)
+{
+    Restart_Route_Timer();
 }
-void Turn_Left() {
-    Motor_Left(3500, 3500);  // Set both motors to high speed
-    Clock_Delay1ms(500);  // Delay for 1000 milliseconds (1 second)
-    Motor_Stop();  // Stop the motors after .5 second
+
+/**
+ * @brief This function stops the exploration, executed by the EUSCI_A2 interrupt when the maze-goal barcode is scanned.
+ *
+ * @return None
+ */
+void Barcode_Maze_Goal(void)
+{
+    Motor_Stop_Inline();
+    Maze_Goal_Reached = 1;
 }
 
+// Barcodes matched by the EUSCI_A2 interrupt
+Barcode_Scanner_Command Barcode_Commands[] =
+{
+    { "MAZE_START", &Barcode_Maze_Start, 0 },
+    { "MAZE_GOAL", &Barcode_Maze_Goal, 0 }
+};
+#endif
 
-void Controller_1()
+/**
+ * @brief This function updates the user interface.
+ *
+ * It reads the latest PMOD Color sample, displays the route timer on the Nokia5110 LCD, and advances
+ * the trials of the route race and the speed run.
+ *
+ * @return None
+ */
+void User_Interface_Update(void)
 {
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+    void (*action)(void);
+    int page;
+#ifdef RATE_POLICY_ACTIVE
+    long sr;
+#endif
 
-    //First Algorithm [ Right Wall Follower ]
+    // Wait until the pending action is due
+    if(User_Interface_Resume_Action != 0){
+        if((int32_t)(Scheduler_Get_Ticks() - User_Interface_Resume_Tick) < 0){
+            return;
+        }
+        action = User_Interface_Resume_Action;
+        User_Interface_Resume_Action = 0;
+#ifdef CLOCK_SCALING_ACTIVE
+        Set_Clock_Profile(CLOCK_PROFILE_RUN);
+#endif
+#ifdef RATE_POLICY_ACTIVE
+        // Leave the idle rates before the run starts, the control task selects the rates of the run from its next tick
+        sr = StartCritical();
+        Rate_Monitor_Apply_Level(Rate_Policy_Wake());
+        EndCritical(sr);
+#endif
+        (*action)();
+    }
 
+    //PMOD COLOR: latest calibrated sample from the background acquisition
+    PMOD_Color_Get_Snapshot(&color_snapshot);
+    if(color_snapshot.sample_count != last_color_sample){
+        last_color_sample = color_snapshot.sample_count;
+#ifndef TELEMETRY_ACTIVE
+        Print_Format("r=%04x g=%04x b=%04x\r\n", color_snapshot.normalized.red, color_snapshot.normalized.green, color_snapshot.normalized.blue);
+#endif
+        redvalue = color_snapshot.normalized.red / 256;
+        greenvalue = color_snapshot.normalized.green / 256;
+        bluevalue = color_snapshot.normalized.blue / 256;
+        color_result = Color_Classifier_Classify(&Color_Palette, color_snapshot.raw);
+    }
+    if((color_result.ID == COLOR_RED) && (color_result.Confidence >= COLOR_RED_MIN_CONFIDENCE)){
+        //Handle_Red();
+#ifdef BUZZER_ACTIVE
+        // Beep once when the robot reaches the red tape
+        if(Color_Red_Detected == 0){
+            Buzzer_Play_Tune(Red_Tune, sizeof(Red_Tune) / sizeof(Red_Tune[0]));
+        }
+#endif
+        Color_Red_Detected = 1;
+    }else{
+        Color_Red_Detected = 0;
+    }
 
-#ifndef DEBUG_ACTIVE
-    if(RouteOne == 0){
-        if((Converted_Distance_Center < DESIRED_DISTANCE) && (Converted_Distance_Right <= DESIRED_DISTANCE ) && ( Converted_Distance_Left <= DESIRED_DISTANCE)){
-            Motor_Stop();
-            RouteOne = 1;
-        }else if((Converted_Distance_Center > DESIRED_DISTANCE) && (Converted_Distance_Right < DESIRED_DISTANCE)){
-            Motor_Forward(3500, 3500);
-        }else if(Converted_Distance_Right > DESIRED_DISTANCE){
-            Motor_Right(2000,2000);
-        }else if((Converted_Distance_Center <= DESIRED_DISTANCE) && (Converted_Distance_Right < DESIRED_DISTANCE)){
-            Turn_Left();
+#ifdef BUZZER_ACTIVE
+    if((Maze_Goal_Reached != 0) && (Goal_Tune_Played == 0)){
+        Buzzer_Play_Tune(Goal_Tune, sizeof(Goal_Tune) / sizeof(Goal_Tune[0]));
+    }
+    Goal_Tune_Played = Maze_Goal_Reached;
+#endif
+
+    //LCD Screen: seconds measured by the Timer A3 timebase, independent of the execution time of this task
+    counter = Stopwatch_Read_ms(&Route_Stopwatch) / 1000;
+
+    if((Route_Race_Get_State() == ROUTE_RACE_DONE) && (Route_Race_Get_Num_Strategies() > 0)){  //When the race is done print this on the last lines:
+        // Show the times of every strategy in turn
+        page = (Scheduler_Get_Ticks() / RACE_PAGE_TICKS) % Route_Race_Get_Num_Strategies();
+        if(page != Race_Page){
+            Draw_Race_Page(page);
+            Race_Page = page;
+        }
+        Print_Format_To_Buffer(line, sizeof(line), "%s Wins!", Route_Race_Get_Name(Route_Race_Get_Fastest()));
+        Output_LCD_Line(5, line);
+        // The route timer field has been overwritten by the result
+        Dashboard_Field_Invalidate(&Route_Timer_Field);
+        Nokia5110_Buffer_SetCursor(0, 4);
+        if(SpeedRun == 2){
+            Nokia5110_Buffer_OutString("Speed=");
+            Dashboard_Field_Set(&Speed_Run_Field, SpeedRunTime / 1000);
+        }else if(SpeedRun == 3){
+            Nokia5110_Buffer_OutString("Speed fail ");
+            Dashboard_Field_Invalidate(&Speed_Run_Field);
         }else{
-            Motor_Stop();
+            Nokia5110_Buffer_OutString("-----------");
+            Dashboard_Field_Invalidate(&Speed_Run_Field);
         }
-    }else if(RouteOne == 2){
-        //Left Wall following;
-        if((Converted_Distance_Center < DESIRED_DISTANCE) && (Converted_Distance_Left <= DESIRED_DISTANCE ) && ( Converted_Distance_Right <= DESIRED_DISTANCE)){
-                    Motor_Stop();
-                    RouteOne = 3;
-                    RouteTwo = 1;
-                }else if((Converted_Distance_Center > DESIRED_DISTANCE) && (Converted_Distance_Left < DESIRED_DISTANCE)){
-                    Motor_Forward(3500, 3500);
-                }else if(Converted_Distance_Left > DESIRED_DISTANCE){
-                    Motor_Left(2000,2000);
-                }else if((Converted_Distance_Center <= DESIRED_DISTANCE) && (Converted_Distance_Left < DESIRED_DISTANCE)){
-                    Turn_Right();
-                }else{
-                    Motor_Stop();
-                }
     }else{
-        Motor_Stop();
-        printf("Done With ALl Routes");
+    // Only the digits that have changed since the last update are drawn
+    Dashboard_Field_Set(&Route_Timer_Field, counter);
     }
-#endif
-}
 
+    // Send the bytes that have changed in the background
+    Nokia5110_DisplayBuffer_DMA();
+
+    if(Route_Race_Get_State() == ROUTE_RACE_FINISHED){
+        Finish_Race_Trial();
+    }else if((SpeedRun == 1) && (Route_Replay_Is_Active() == 0)){
+        // Only a replay that has reached the end of the recorded route, in its goal cell, has a time
+        SpeedRunTime = Stopwatch_Stop(&Route_Stopwatch);
+        if(Route_Replay_Is_Complete()){
+            Race_Report_Route_Time("speed", SpeedRunTime);
+            SpeedRun = 2;
+        }else{
+            Race_Report_Route_Failed("speed");
+            SpeedRun = 3;
+        }
+    }
+}
 
 /**
- * @brief This function is the handler for the SysTick periodic interrupt with a rate of 100 Hz.
+ * @brief This function is the user interface task, executed by the scheduler every 50 ms in the background.
  *
- * The SysTick_Handler generates a periodic interrupt that calls a specific controller function based on the selected
- * active configuration. Only one of the options can be defined at a time: CONTROLLER_1, CONTROLLER_2, or CONTROLLER_3.
+ * @return None
  */
-void SysTick_Handler(void)
+void User_Interface_Task(void)
 {
-#if defined CONTROLLER_1
+    PROFILER_START(PROFILER_USER_INTERFACE_TASK);
 
-    Controller_1();
+    User_Interface_Update();
 
-#elif defined CONTROLLER_2
-    #if defined CONTROLLER_1 || CONTROLLER_3
-        #error "Only CONTROLLER_1, CONTROLLER_2, or CONTROLLER_3 can be active at the same time."
-    #endif
+#ifdef CLOCK_SCALING_ACTIVE
+    Clock_Update_Profile_Time();
+#endif
 
-    // Your function for Task 1 goes here (Controller_2)
-    //Controller_2();
+    PROFILER_STOP(PROFILER_USER_INTERFACE_TASK);
+}
 
-#elif defined CONTROLLER_3
-    #if defined CONTROLLER_1 || CONTROLLER_2
-#error "Only CONTROLLER_1, CONTROLLER_2, or CONTROLLER_3 can be active at the same time."
-    #endif
+#ifdef FLASH_STORE_ACTIVE
+/**
+ * @brief This function restores the records saved by a previous run, or keeps the defaults if a record is missing.
+ *
+ * @return None
+ */
+void Flash_Store_Restore(void)
+{
+    Analog_Distance_Sensor_Calibration distance_calibration;
+    PMOD_Calibration_Data color_calibration;
+#ifdef CONTROLLER_2
+    uint8_t map[MAZE_MAP_STORAGE_SIZE];
+#endif
 
-    // Your function for Task 2 goes here (Controller_3)
-    //Controller_3();
+    if (Flash_Store_Init() != 0)
+    {
+        Print_Format("Flash store cannot be formatted.\n");
+        return;
+    }
 
-#else
-    #error "Define either one of the options: CONTROLLER_1, CONTROLLER_2, or CONTROLLER_3."
+    // The Ax, Bx, and Cx coefficients are only replaced by an override written with Flash_Store_Write
+    if (Flash_Store_Read(FLASH_STORE_KEY_DISTANCE_CALIBRATION, &distance_calibration, sizeof(distance_calibration)) > 0)
+    {
+        Analog_Distance_Sensor_Set_Calibration(distance_calibration);
+    }
+
+    // The first samples extend the restored minimum and maximum instead of starting a new calibration
+    if (Flash_Store_Read(FLASH_STORE_KEY_COLOR_CALIBRATION, &color_calibration, sizeof(color_calibration)) > 0)
+    {
+        PMOD_Color_Set_Calibration(color_calibration);
+    }
+
+#ifdef CONTROLLER_2
+    // Resume from the walls found by the previous exploration
+    if (Flash_Store_Read(FLASH_STORE_KEY_MAZE_MAP, map, sizeof(map)) > 0)
+    {
+        Maze_Map_Import(map);
+        Maze_Map_Flood_Fill();
+    }
+#endif
+
+#ifdef PARAMETERS_ACTIVE
+    // The tuning parameters saved with the save command are applied by the first control tick
+    Parameters_Restore();
 #endif
 }
 
 /**
- * @brief User-defined function executed by Timer A1 using a periodic interrupt at a rate of 2 kHz.
+ * @brief This function saves the color calibration and the maze map, executed by the scheduler every 10 s in the background.
  *
- * The Timer_A1_Periodic_Task function generates a periodic interrupt with a rate of 2 kHz. It samples the
- * distance values measured by three Sharp GP2Y0A21YK0F analog distance sensors.
+ * A record is only programmed when its data has changed since the last save.
  *
- * @param None
+ * @return None
+ */
+void Flash_Store_Task(void)
+{
+    PMOD_Calibration_Data color_calibration;
+#ifdef CONTROLLER_2
+    uint8_t map[MAZE_MAP_STORAGE_SIZE];
+#endif
+
+    // The calibration is not valid until the first sample
+    if (color_snapshot.sample_count > 0)
+    {
+        color_calibration = PMOD_Color_Get_Calibration();
+        Flash_Store_Write(FLASH_STORE_KEY_COLOR_CALIBRATION, &color_calibration, sizeof(color_calibration));
+    }
+
+#ifdef CONTROLLER_2
+    Maze_Map_Export(map);
+    Flash_Store_Write(FLASH_STORE_KEY_MAZE_MAP, map, sizeof(map));
+#endif
+}
+#endif
+
+#ifdef DEBUG_ACTIVE
+/**
+ * @brief This function prints the converted distances, executed by the scheduler every 500 ms in the background.
  *
  * @return None
  */
-void Timer_A1_Periodic_Task(void)
+void Debug_Task(void)
 {
-    Sample_Analog_Distance_Sensor();
+    // Note: The format is split at compile time, so only the three numbers are converted at run time
+    PRINT_SDEC("Left: ", Converted_Distance_Left);
+    PRINT_SDEC(" mm | Center: ", Converted_Distance_Center);
+    PRINT_SDEC(" mm | Right: ", Converted_Distance_Right);
+    PRINT_LITERAL(" mm\n");
 }
+#endif
 
+#if defined PROFILER_ACTIVE && !defined TELEMETRY_ACTIVE
+/**
+ * @brief This function prints the cycles used by every interrupt handler and task, executed by the scheduler every 5 s.
+ *
+ * @return None
+ */
+void Profiler_Task(void)
+{
+    Profiler_Print();
+}
+#endif
 
 int main(void)
 {
-    // Declare local variables for the Sharp GP2Y0A21YK0F Analog Distance Sensors
-    // before passing their addresses
-    uint32_t Raw_A17;
-    uint32_t Raw_A14;
-    uint32_t Raw_A16;
-    uint32_t counter =0; //New
-    uint32_t mscounter =0; // NEW
+    // Declare local array for the Sharp GP2Y0A21YK0F Analog Distance Sensors (A17, A14, A16)
+    uint32_t Raw[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+#ifdef RATE_POLICY_ACTIVE
+    long sr;
+#endif
 
     // Initialize the 48 MHz Clock
     Clock_Init48MHz();
 
+    // Sleep in LPM0 when the main loop waits for an interrupt
+    Power_Init();
+
+    // Start the DWT cycle counter used to measure the boot time and the execution time of the maze replanning,
+    // the tasks, and the interrupt handlers
+    CycleCounter_Init();
+    Profiler_Reset();
+    Boot_Start_Cycles = CycleCounter_Read();
+
     // Ensure that interrupts are disabled during initialization
     DisableInterrupts();
 
-    // Initialize EUSCI_A0_UART to use the printf function
-    EUSCI_A0_UART_Init_Printf();
+    // Initialize EUSCI_A0_UART for the Print_Format output
+    // Note: The C library printf and its stdio device are not used, so they are not linked in
+    EUSCI_A0_UART_Init();
+
+    // Power on the PMOD Color module and reset the OPT3101 first, so that their power-up time
+    // overlaps the initialization of the other peripherals instead of being a fixed delay
+    PMOD_Color_Power_On();
+#ifdef OPT3101_ACTIVE
+    OPT3101_Reset_Start();
+#endif
 
     // Initialize the DC motors
     Motor_Init();
 
-    // Initialize the PMOD Color module
-    PMOD_Color_Init(); //NEW
+#ifdef BUMPER_ACTIVE
+    // Queue the debounced Bumper Switch contacts, and stop the motors on any contact
+    Bumper_Switches_Init(0);
+    Bumper_Set_Motor_Cutoff(BUMPER_ALL_SWITCHES);
+#endif
+
+    // Initialize the tachometers used to count the wheel steps
+    Tachometer_Init();
+
+#ifdef BUZZER_ACTIVE
+    // Initialize the Piezo Buzzer, whose notes are timed by the Timer A3 compare channel
+    Buzzer_Init();
+#endif
+
+    // Start the pose estimate at the origin
+    Odometry_Init();
+
+    // Initialize the motion primitive executor used for turns
+    Motion_Init();
+
+    // Initialize the closed-loop wheel speed controller (disabled until a speed is set)
+    Speed_Controller_Init();
+
+    // Release the duty cycle limit of the slip detection
+    Traction_Init();
 
-    // Indicate that the PMDO Color module has been initialized and powered on
-    printf("PMOD COLOR has been initialized and powered on.\n");
+#ifdef RATE_POLICY_ACTIVE
+    // Start at the rates of a trial, the first trial starts at the end of the initialization
+    Rate_Policy_Init();
+#endif
+
+    // Reset the progress of the controllers and initialize the motor duty cycle values
+    Controller_Init();
 
+    // Clear the junction classification, the first control tick classifies the start cell
+    Junction_Init();
+
+#ifdef CONTROLLER_2
+    // Clear the maze map explored by Controller_2
+    Maze_Exploration_Init();
+#endif
 
-    // Initialize motor duty cycle values
-    Duty_Cycle_Left  = PWM_NOMINAL;
-    Duty_Cycle_Right = PWM_NOMINAL;
+    // Select the resolution, the sample-and-hold time, and the sample rate of the Analog Distance Sensors
+    if (Analog_Distance_Sensor_Configure(&Distance_Sensor_ADC_Config) != 0)
+    {
+        Print_Format("ADC14 configuration rejected, using the default configuration.\n");
+    }
 
     // Initialize the Analog Distance Sensor using the ADC14 module
     Analog_Distance_Sensor_Init();
 
     // Start conversion of Analog Distance Sensor raw values
-    Analog_Distance_Sensor_Start_Conversion(&Raw_A17, &Raw_A14, &Raw_A16);
+    Analog_Distance_Sensor_Start_Conversion(&Raw[0], &Raw[1], &Raw[2]);
 
-    // Initialize low-pass filters for the Analog Distance Sensor
-    LPF_Init(Raw_A17, 64);
-    LPF_Init2(Raw_A14, 64);
-    LPF_Init3(Raw_A16, 64);
+    // Initialize the low-pass filter for the Analog Distance Sensor
+    LPF_Filter_Init(&Distance_Sensor_LPF, Distance_Sensor_LPF_Buffer, DISTANCE_SENSOR_LPF_SIZE, ANALOG_DISTANCE_SENSOR_NUM_CHANNELS, Raw);
+#ifdef DISTANCE_SENSOR_MEDIAN_ACTIVE
+    LPF_Median_Init(&Distance_Sensor_Median, ANALOG_DISTANCE_SENSOR_NUM_CHANNELS, Raw);
+#endif
 
+#ifdef MAP_SHARING_ACTIVE
+    // Receive the map of the other robot in the EUSCI_A3 RX ring buffer, and ask for it in case the other robot
+    // has already reached the goal
+    // Note: The Nokia5110 functions then only draw in the RAM buffer
+    Robot_Link_Init();
+    Robot_Link_Send_Request();
+#else
     // Initialize the Nokia5110 LCD
     Nokia5110_Init();   //NEW
 
+    // Flush the Nokia5110 RAM buffer using the uDMA controller
+    Nokia5110_DMA_Init();
+#endif
+
+    // Enable the RGBC ADC of the PMOD Color module once its oscillator has warmed up
+    // Note: The first integration cycle runs during the OPT3101 initialization
+    PMOD_Color_Start();
+
+#ifdef OPT3101_ACTIVE
+    // Initialize the OPT3101 on the same EUSCI_B1 bus as soon as it has loaded its EEPROM, and calibrate its internal crosstalk
+    OPT3101_Reset_Release();
+    if (OPT3101_Wait_Ready(OPT3101_READY_TIMEOUT_US) != 0)
+    {
+        Print_Format("OPT3101 is not ready.\n");
+    }
+    OPT3101_Setup();
+    OPT3101_CalibrateInternalCrosstalk();
+#ifdef DISTANCE_FUSION_ACTIVE
+    Distance_Source_Init(DISTANCE_SOURCE_FUSION);
+#else
+    Distance_Source_Init(DISTANCE_SOURCE_OPT3101);
+#endif
+#else
+    Distance_Source_Init(DISTANCE_SOURCE_SHARP);
+#endif
+
+#ifdef LATENCY_TEST_ACTIVE
+#if !defined PARAMETERS_ACTIVE || (defined OPT3101_ACTIVE && !defined DISTANCE_FUSION_ACTIVE)
+#error "LATENCY_TEST_ACTIVE requires PARAMETERS_ACTIVE and the Analog Distance Sensors (Sharp or fusion distance source)."
+#endif
+    // No distance is replaced until the first latency inject command
+    Latency_Test_Init();
+#endif
+
+    // Indicate that the PMOD Color module has completed its first integration cycle
+    if (PMOD_Color_Wait_Ready(PMOD_COLOR_READY_TIMEOUT_US) == 0)
+    {
+        Print_Format("PMOD COLOR has been initialized and powered on.\n");
+    }
+    else
+    {
+        Print_Format("PMOD COLOR is not ready.\n");
+    }
+
+    // Register the periodic tasks before the first tick
+    // Note: The 10 ms period of the PMOD Color read is longer than the 2.4 ms integration time, so every read returns a new sample
+    Scheduler_Init(SYSTICK_INT_NUM_CLK_CYCLES);
+    Scheduler_Add_Task(&PMOD_Color_Acquisition_Task, SCHEDULER_CONTEXT_TICK, CONTROL_TASK_PERIOD_TICKS, PMOD_COLOR_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+    Control_Task_ID = Scheduler_Add_Task(&Control_Task, SCHEDULER_CONTEXT_TICK, CONTROL_TASK_PERIOD_TICKS, CONTROL_TASK_PRIORITY, CONTROL_TASK_DEADLINE_CYCLES);
+#ifdef OPT3101_ACTIVE
+    // Restart the OPT3101 measurements if a DATA_RDY interrupt has been missed
+    Scheduler_Add_Task(&OPT3101_Acquisition_Task, SCHEDULER_CONTEXT_TICK, CONTROL_TASK_PERIOD_TICKS, OPT3101_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#ifdef BUZZER_ACTIVE
+    // Note: Runs after the control loop, so the note changes do not delay it
+    Scheduler_Add_Task(&Buzzer_Task, SCHEDULER_CONTEXT_TICK, BUZZER_TASK_PERIOD_TICKS, BUZZER_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+    // Abort the EUSCI_B1 transaction of a sensor that holds the bus, so the reads of the other sensors continue
+    Scheduler_Add_Task(&EUSCI_B1_I2C_Watchdog_Task, SCHEDULER_CONTEXT_TICK, I2C_WATCHDOG_TASK_PERIOD_TICKS, I2C_WATCHDOG_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+    User_Interface_Task_ID = Scheduler_Add_Task(&User_Interface_Task, SCHEDULER_CONTEXT_BACKGROUND, USER_INTERFACE_TASK_PERIOD_TICKS, USER_INTERFACE_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#if defined PROFILER_ACTIVE && !defined TELEMETRY_ACTIVE
+    // Note: The text output would corrupt the binary telemetry packets
+    Scheduler_Add_Task(&Profiler_Task, SCHEDULER_CONTEXT_BACKGROUND, PROFILER_TASK_PERIOD_TICKS, PROFILER_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#ifdef DEBUG_ACTIVE
+    Scheduler_Add_Task(&Debug_Task, SCHEDULER_CONTEXT_BACKGROUND, DEBUG_TASK_PERIOD_TICKS, DEBUG_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#ifdef FLASH_STORE_ACTIVE
+    // Note: A sector rotation erases a sector, so the save has the lowest priority
+    Scheduler_Add_Task(&Flash_Store_Task, SCHEDULER_CONTEXT_BACKGROUND, FLASH_STORE_TASK_PERIOD_TICKS, FLASH_STORE_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#ifdef PARAMETERS_ACTIVE
+    Scheduler_Add_Task(&Parameters_Task, SCHEDULER_CONTEXT_BACKGROUND, PARAMETERS_TASK_PERIOD_TICKS, PARAMETERS_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#if defined RATE_POLICY_ACTIVE && defined PARAMETERS_ACTIVE
+    Scheduler_Add_Task(&Rate_Monitor_Task, SCHEDULER_CONTEXT_BACKGROUND, RATE_MONITOR_TASK_PERIOD_TICKS, RATE_MONITOR_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#ifdef PARAMETERS_ACTIVE
+    Scheduler_Add_Task(&Maze_Map_Transfer_Task, SCHEDULER_CONTEXT_BACKGROUND, MAP_TRANSFER_TASK_PERIOD_TICKS, MAP_TRANSFER_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#if defined TRACE_ACTIVE && defined PARAMETERS_ACTIVE
+    Scheduler_Add_Task(&Trace_Dump_Task, SCHEDULER_CONTEXT_BACKGROUND, TRACE_DUMP_TASK_PERIOD_TICKS, TRACE_DUMP_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#ifdef BLACK_BOX_ACTIVE
+    // Note: A call programs at most BLACK_BOX_WORDS_PER_TASK words, an erase is completed by a later call
+    Scheduler_Add_Task(&Black_Box_Task, SCHEDULER_CONTEXT_BACKGROUND, BLACK_BOX_TASK_PERIOD_TICKS, BLACK_BOX_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#if defined BLACK_BOX_ACTIVE && defined PARAMETERS_ACTIVE
+    Scheduler_Add_Task(&Black_Box_Dump_Task, SCHEDULER_CONTEXT_BACKGROUND, BLACK_BOX_TASK_PERIOD_TICKS, BLACK_BOX_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#ifdef AMBIENT_LIGHT_ACTIVE
+    Ambient_Light_Task_ID = Scheduler_Add_Task(&Ambient_Light_Task, SCHEDULER_CONTEXT_BACKGROUND, SCHEDULER_EVENT_TASK, AMBIENT_LIGHT_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+    // Restart the OPT3001 read if an INT edge has been missed
+    Scheduler_Add_Task(&OPT3001_Acquisition_Task, SCHEDULER_CONTEXT_BACKGROUND, AMBIENT_LIGHT_TASK_PERIOD_TICKS, AMBIENT_LIGHT_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#ifdef MAP_SHARING_ACTIVE
+    Scheduler_Add_Task(&Map_Sharing_Task, SCHEDULER_CONTEXT_BACKGROUND, MAP_SHARING_TASK_PERIOD_TICKS, MAP_SHARING_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+#ifdef TELEMETRY_ACTIVE
+    // Released by the DMA interrupt of the Analog Distance Sensors
+    Telemetry_Task_ID = Scheduler_Add_Task(&Telemetry_Task, SCHEDULER_CONTEXT_BACKGROUND, SCHEDULER_EVENT_TASK, TELEMETRY_TASK_PRIORITY, SCHEDULER_NO_DEADLINE);
+#endif
+
+#ifdef RATE_POLICY_ACTIVE
+    // Change the sampler and the control task period from the first control tick
+    Rate_Monitor_Init(&Rate_Monitor_Configuration, Control_Task_ID);
+#endif
+
     // Initialize SysTick periodic interrupt with a rate of 100 Hz
     SysTick_Interrupt_Init(SYSTICK_INT_NUM_CLK_CYCLES, SYSTICK_INT_PRIORITY);
 
+#ifdef ANALOG_DISTANCE_SENSOR_DMA_MODE
+    // Sample the Analog Distance Sensors at DISTANCE_SENSOR_SAMPLE_RATE_HZ using Timer_A2-triggered conversions and DMA
+    Analog_Distance_Sensor_DMA_Init(&Analog_Distance_Sensor_Block_Task);
+#else
     // Initialize Timer A1 with interrupts enabled and an interrupt rate of 2 kHz
     Timer_A1_Interrupt_Init(&Timer_A1_Periodic_Task, TIMER_A1_INT_CCR0_VALUE);
+#endif
 
-    // Enable the interrupts used by Timer A1 and other modules
-    EnableInterrupts();
+#ifdef RATE_POLICY_ACTIVE
+    // Apply the rates of the selected level to the started sampler, also if a control tick has already selected them
+    sr = StartCritical();
+    Rate_Monitor_Reapply();
+    EndCritical(sr);
+#endif
 
     // Display the PMOD Color Device ID
-    printf("PMOD Color Device ID: 0x%02X\n", PMOD_Color_Get_Device_ID());
-    // Declare structs for both raw and normalized PMOD Color data
-    PMOD_Color_Data pmod_color_data;
-    PMOD_Calibration_Data calibration_data;
+    // Note: Blocking EUSCI_B1 transfers are only used before the background acquisition starts
+    Print_Format("PMOD Color Device ID: 0x%02X\n", PMOD_Color_Get_Device_ID());
 
-    pmod_color_data = PMOD_Color_Get_RGBC();
-    calibration_data = PMOD_Color_Init_Calibration_Data(pmod_color_data);
-    Clock_Delay1us(2400);
+#ifdef AMBIENT_LIGHT_ACTIVE
+    // Configure the OPT3001 on the same EUSCI_B1 bus before the background transactions start, and handle
+    // its INT edges in the PORT4 interrupt
+    OPT3001_Init();
+    Bumper_Set_Port_Handler(OPT3001_INT_PIN, &OPT3001_Handle_Interrupt);
+    OPT3001_Acquisition_Init(&Ambient_Light_Changed);
+#endif
 
-    // Clear the Nokia5110 buffer and the LCD - NEW
-    Nokia5110_ClearBuffer();
-    Nokia5110_Clear();
+    // Start the background acquisition of the PMOD Color module
+    // Note: The SysTick interrupt queues a read every 10 ms and the snapshot is updated by the EUSCI_B1 interrupt
+    PMOD_Color_Acquisition_Init();
+
+#if defined TRACE_ACTIVE && defined PARAMETERS_ACTIVE
+    // Reply to the host commands like the Parameters module
+    Trace_Dump_Init(&Parameters_Output_Line, HOST_DUMP_PACKETS);
+#endif
+#if defined BLACK_BOX_ACTIVE && defined PARAMETERS_ACTIVE
+    Black_Box_Dump_Init(&Parameters_Output_Line);
+#endif
+#ifdef PARAMETERS_ACTIVE
+    Maze_Map_Transfer_Init(&Parameters_Output_Line, HOST_DUMP_PACKETS, MAZE_LIBRARY_ACTIVE);
+#endif
+#if defined CLOCK_SCALING_ACTIVE && defined PARAMETERS_ACTIVE
+    Clock_Report_Init(&Parameters_Output_Line);
+#endif
+#ifdef PARAMETERS_ACTIVE
+    I2C_Report_Init(&Parameters_Output_Line);
+#endif
+#if defined LATENCY_TEST_ACTIVE && defined PARAMETERS_ACTIVE
+    Latency_Report_Init(&Parameters_Output_Line);
+#endif
+    // Report the route times and the race statistics also without the Parameters module
+    Race_Report_Init(&Output_Host_Line);
 
-    Nokia5110_SetCursor(0, 4);
-    Nokia5110_OutString("Counter:");
+#ifdef PARAMETERS_ACTIVE
+    // Receive the parameter commands in the EUSCI_A0 RX ring buffer
+    Parameters_Init(Tuning_Parameters, sizeof(Tuning_Parameters) / sizeof(Tuning_Parameters[0]), &Parameters_Output_Line);
+    Parameters_Set_Command_Handler(&Host_Command);
+#endif
 
-    Nokia5110_SetCursor(0, 5);
-    Nokia5110_OutUDec(counter);
+#ifdef BLACK_BOX_ACTIVE
+    // Continue after the last run found in flash, and record this run
+    Black_Box_Init();
+    Black_Box_Start();
+#endif
 
+#ifdef TRACE_ACTIVE
+    // Record the events from the start of the program, a "trace start" command restarts the trace before a run
+    Trace_Start();
+#endif
 
-    while(1)
-    {
-        //PMOD COLOR:
-        pmod_color_data = PMOD_Color_Get_RGBC();
-        PMOD_Color_Calibrate(pmod_color_data, &calibration_data);
-        pmod_color_data = PMOD_Color_Normalize_Calibration(pmod_color_data, calibration_data);
-        printf("r=%04x g=%04x b=%04x\r\n", pmod_color_data.red, pmod_color_data.green, pmod_color_data.blue);
-        redvalue = pmod_color_data.red / 256;
-        greenvalue = pmod_color_data.green / 256;
-        bluevalue = pmod_color_data.blue / 256;
-        printf("red: %d Green: %d Blue %d", redvalue, greenvalue, bluevalue);
-        Clock_Delay1ms(50);
-        if((redvalue >= 130) && (greenvalue <= 80) && (bluevalue >= 80)){
-            //Handle_Red();
-        }
+#ifdef FLASH_STORE_ACTIVE
+    // Restore the calibration data and the maze map saved by the previous run
+    Flash_Store_Restore();
+#endif
 
-        //Clock_Delay1ms(50); //50 ms delay
+#ifdef OPT3101_ACTIVE
+    // Start the channel-cycled OPT3101 measurements, read by the PORT6 and EUSCI_B1 interrupts
+    OPT3101_Acquisition_Init();
+#endif
 
-        mscounter = mscounter + 50;
-        //LCD Screen:
-        if((mscounter % 1000) == 0){
-            counter = counter +1;
-        }
+#ifdef BARCODE_SCANNER_ACTIVE
+    // Match the scanned barcodes in the EUSCI_A2 interrupt
+    Barcode_Scanner_Init();
+    Barcode_Scanner_Set_Commands(Barcode_Commands, sizeof(Barcode_Commands) / sizeof(Barcode_Commands[0]));
+#endif
 
-        if(RouteTwo == 2){  //When Route is done print this on last lines:
-            if(RouteOneTime < RouteTwoTime){
-                Nokia5110_SetCursor(0, 5);
-                Nokia5110_OutString("Route1 Wins!");
-                Clock_Delay1ms(50);
-                Nokia5110_SetCursor(0, 4);
-                Nokia5110_OutString("-----------");
-            }else if(RouteTwoTime < RouteOneTime){
-                Nokia5110_SetCursor(0, 5);
-                Nokia5110_OutString("Route2 Wins!");
-                Clock_Delay1ms(50);
-                Nokia5110_SetCursor(0, 4);
-                Nokia5110_OutString("-----------");
-            }else{
-                Nokia5110_SetCursor(0, 5);
-                Nokia5110_OutString("Tie");
-                Clock_Delay1ms(50);
-                Nokia5110_SetCursor(0, 4);
-                Nokia5110_OutString("-----------");
-            }
-        }else{
-        Nokia5110_SetCursor(0, 5);
-        Nokia5110_OutUDec(counter);
-        }
+#ifdef REFLECTANCE_SENSOR_ACTIVE
+    // Charge, release, and read the reflectance sensors from the Timer32_1 interrupt instead of blocking in Reflectance_Sensor_Read
+    // Note: The latest line pattern is read with Reflectance_Sensor_Get
+    Reflectance_Sensor_Init();
+    Reflectance_Sensor_Acquisition_Init(REFLECTANCE_SENSOR_SAMPLE_TIME_US, REFLECTANCE_SENSOR_PERIOD_US, 0);
+#endif
 
-        if(RouteOne == 1){
-            RouteOneTime = counter;
-            Nokia5110_SetCursor(0,0);
-            Nokia5110_OutString("RouteOne =");
-            Clock_Delay1ms(50);
-            Nokia5110_SetCursor(0,1);
-            Nokia5110_OutUDec(RouteOneTime);
-            Clock_Delay1ms(10000);// wait 10 seconds before next algorithm
-            counter = 0;
-            RouteOne = 2;
-        }else if(RouteTwo == 1){
-            RouteTwoTime = counter;
-            Nokia5110_SetCursor(0,2);
-            Nokia5110_OutString("RouteTwo =");
-            Clock_Delay1ms(50);
-            Nokia5110_SetCursor(0,3);
-            Nokia5110_OutUDec(RouteTwoTime);
-            Clock_Delay1ms(500);
-            counter =0;
-            RouteOne = 3;
-            RouteTwo = 2;
-        }
-        //Clock_Delay1ms(1000);
+    // Put the modules that are not used in their lowest power state
+    Power_Disable_Modules(POWER_UNUSED_MODULES);
 
-#ifdef DEBUG_ACTIVE
-        if((mscounter % 500) == 0){
-        printf("Left: %d mm | Center: %d mm | Right: %d mm\n", Converted_Distance_Left, Converted_Distance_Center, Converted_Distance_Right);
-        }
-        //Clock_Delay1us(500);
+    // Report the time from the start of the cycle counter until the robot is ready
+    // Note: Printed before the interrupts start the binary telemetry
+    Boot_Time_us = (CycleCounter_Read() - Boot_Start_Cycles) / BOOT_CYCLES_PER_US;
+    Print_Format("Boot time: %u us\n", Boot_Time_us);
+
+    // Enable the interrupts used by Timer A1, DMA, and other modules
+    EnableInterrupts();
+
+    // Clear the Nokia5110 buffer and the LCD - NEW
+    Nokia5110_ClearBuffer();
+    Nokia5110_Clear();
+
+    // Text is drawn in the RAM buffer and only the changed bytes are sent to the LCD
+    Nokia5110_Buffer_SetCursor(0, 4);
+    Nokia5110_Buffer_OutString("Counter:");
+
+    // The glyphs of the digits are copied from the font once, then the fields only redraw the digits that change
+    Dashboard_Init();
+    Dashboard_Field_Init(&Route_Timer_Field, 0, 5, 5, 0);
+    Dashboard_Field_Init(&Speed_Run_Field, 6, 4, 5, 0);
+    Dashboard_Field_Set(&Route_Timer_Field, counter);
+    Nokia5110_DisplayBuffer_DMA();
+
+    // Race the strategies of the selected controller, each one ROUTE_RACE_ROUNDS times
+    Route_Race_Init();
+#if defined CONTROLLER_1
+    Route_Race_Register("Right", &Follow_Wall_Restart, &Follow_Right_Wall);
+    Route_Race_Register("Left", &Follow_Wall_Restart, &Follow_Left_Wall);
+#elif defined CONTROLLER_2
+    Route_Race_Register("Flood", &Maze_Exploration_Restart, &Maze_Exploration_Step);
 #endif
-    }
+    Route_Race_Start(ROUTE_RACE_ROUNDS);
+
+    // Start the first trial from the start pose
+    Start_Race_Trial();
+
+    // Execute the background tasks and sleep in LPM0 until an interrupt releases the next one
+    Scheduler_Run();
 }
@@ -40,7 +40,11 @@
 
 MEMORY
 {
-    MAIN       (RX) : origin = 0x00000000, length = 0x00040000
+    MAIN       (RX) : origin = 0x00000000, length = 0x00030000
+    /* Sectors 16 to 29 of flash bank 1, reserved for the pages of the Black_Box recorder */
+    BLACK_BOX   (R) : origin = 0x00030000, length = 0x0000E000
+    /* Last two 4 KB sectors of flash bank 1, reserved for the records of the Flash_Store driver */
+    FLASH_STORE (R) : origin = 0x0003E000, length = 0x00002000
     INFO       (RX) : origin = 0x00200000, length = 0x00004000
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
@@ -70,6 +74,10 @@ MEMORY
 /*                                                                           */
 /* --heap_size=1024                                                          */
 /* --stack_size=512                                                          */
+/*                                                                           */
+/* The sizes of SRAM_DATA, the stack, and the heap are also set in           */
+/* inc/Memory_Config.h, which checks the static buffers against them at      */
+/* compile time. Memory_Report.py compares them with the map file.           */
 /* --library=rtsv7M4_T_le_eabi.lib                                           */
 
 /* Section allocation in memory */
@@ -18,8 +18,135 @@
 
 #include "../inc/Analog_Distance_Sensors.h"
 
+// Calibrated distance of the ADC value i * 64, computed by the compiler from the calibration formula
+// Note: The entries below ANALOG_DISTANCE_SENSOR_MAX are never interpolated, so they are set to the out-of-range distance
+#define ANALOG_DISTANCE_SENSOR_LUT_ENTRY(i) \
+    ((((i) << ANALOG_DISTANCE_SENSOR_LUT_SHIFT) < (ANALOG_DISTANCE_SENSOR_MAX - (1 << ANALOG_DISTANCE_SENSOR_LUT_SHIFT))) ? \
+     ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE : ((Ax / (((i) << ANALOG_DISTANCE_SENSOR_LUT_SHIFT) + Bx)) + Cx))
+
+#define ANALOG_DISTANCE_SENSOR_LUT_ROW(i) \
+    ANALOG_DISTANCE_SENSOR_LUT_ENTRY((i) + 0), ANALOG_DISTANCE_SENSOR_LUT_ENTRY((i) + 1), \
+    ANALOG_DISTANCE_SENSOR_LUT_ENTRY((i) + 2), ANALOG_DISTANCE_SENSOR_LUT_ENTRY((i) + 3), \
+    ANALOG_DISTANCE_SENSOR_LUT_ENTRY((i) + 4), ANALOG_DISTANCE_SENSOR_LUT_ENTRY((i) + 5), \
+    ANALOG_DISTANCE_SENSOR_LUT_ENTRY((i) + 6), ANALOG_DISTANCE_SENSOR_LUT_ENTRY((i) + 7)
+
+static const uint16_t Analog_Distance_Sensor_LUT[ANALOG_DISTANCE_SENSOR_LUT_SIZE] =
+{
+    ANALOG_DISTANCE_SENSOR_LUT_ROW(0),   ANALOG_DISTANCE_SENSOR_LUT_ROW(8),   ANALOG_DISTANCE_SENSOR_LUT_ROW(16),  ANALOG_DISTANCE_SENSOR_LUT_ROW(24),
+    ANALOG_DISTANCE_SENSOR_LUT_ROW(32),  ANALOG_DISTANCE_SENSOR_LUT_ROW(40),  ANALOG_DISTANCE_SENSOR_LUT_ROW(48),  ANALOG_DISTANCE_SENSOR_LUT_ROW(56),
+    ANALOG_DISTANCE_SENSOR_LUT_ROW(64),  ANALOG_DISTANCE_SENSOR_LUT_ROW(72),  ANALOG_DISTANCE_SENSOR_LUT_ROW(80),  ANALOG_DISTANCE_SENSOR_LUT_ROW(88),
+    ANALOG_DISTANCE_SENSOR_LUT_ROW(96),  ANALOG_DISTANCE_SENSOR_LUT_ROW(104), ANALOG_DISTANCE_SENSOR_LUT_ROW(112), ANALOG_DISTANCE_SENSOR_LUT_ROW(120),
+    ANALOG_DISTANCE_SENSOR_LUT_ROW(128), ANALOG_DISTANCE_SENSOR_LUT_ROW(136), ANALOG_DISTANCE_SENSOR_LUT_ROW(144), ANALOG_DISTANCE_SENSOR_LUT_ROW(152),
+    ANALOG_DISTANCE_SENSOR_LUT_ROW(160), ANALOG_DISTANCE_SENSOR_LUT_ROW(168), ANALOG_DISTANCE_SENSOR_LUT_ROW(176), ANALOG_DISTANCE_SENSOR_LUT_ROW(184),
+    ANALOG_DISTANCE_SENSOR_LUT_ROW(192), ANALOG_DISTANCE_SENSOR_LUT_ROW(200), ANALOG_DISTANCE_SENSOR_LUT_ROW(208), ANALOG_DISTANCE_SENSOR_LUT_ROW(216),
+    ANALOG_DISTANCE_SENSOR_LUT_ROW(224), ANALOG_DISTANCE_SENSOR_LUT_ROW(232), ANALOG_DISTANCE_SENSOR_LUT_ROW(240), ANALOG_DISTANCE_SENSOR_LUT_ROW(248),
+    ANALOG_DISTANCE_SENSOR_LUT_ENTRY(256)
+};
+
+// Calibration table computed at run time by Analog_Distance_Sensor_Set_Calibration, and the table in use
+static uint16_t Analog_Distance_Sensor_RAM_LUT[ANALOG_DISTANCE_SENSOR_LUT_SIZE];
+static const uint16_t *Analog_Distance_Sensor_Active_LUT = Analog_Distance_Sensor_LUT;
+static Analog_Distance_Sensor_Calibration Analog_Distance_Sensor_Coefficients = { Ax, Bx, Cx };
+
+// Configuration selected by Analog_Distance_Sensor_Configure, and left shift of the results to the 14-bit range
+static Analog_Distance_Sensor_Config Analog_Distance_Sensor_Settings = ANALOG_DISTANCE_SENSOR_DEFAULT_CONFIG;
+static uint32_t Analog_Distance_Sensor_Result_Shift = 0;
+
+// Analog inputs added to the sequence, converted in MEM[2 - Analog_Distance_Sensor_Extra_Count] to MEM[1]
+static uint8_t Analog_Distance_Sensor_Extra_Inputs[ANALOG_DISTANCE_SENSOR_MAX_EXTRA_CHANNELS];
+static uint8_t Analog_Distance_Sensor_Extra_Count = 0;
+
+// Number of ADC14CLK cycles of a conversion for each resolution, and of each sample-and-hold time
+static const uint8_t Analog_Distance_Sensor_Conversion_Cycles[4] = { 9, 11, 14, 16 };
+static const uint8_t Analog_Distance_Sensor_Sample_Cycles[8] = { 4, 8, 16, 32, 64, 96, 128, 192 };
+
+// Two sample blocks: one is filled by the uDMA controller while the other one is processed
+static uint32_t Analog_Distance_Sensor_Block[2][ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE * ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+
+// Peripheral scatter-gather task lists, one per sample block
+// Each task copies ADC14->MEM[2] to ADC14->MEM[4] into one sample of the block
+static DMA_Control_Structure Analog_Distance_Sensor_Task_List[2][ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE];
+
+// Index of the sample block that is currently being filled
+static volatile uint32_t Analog_Distance_Sensor_Active_Block;
+
+// Number of sample blocks completed in DMA mode
+static volatile uint32_t Analog_Distance_Sensor_Block_Counter;
+
+// Duration of one sample block at the sequence rate in us, and the sampled time: whole ms and the us left over
+static uint32_t Analog_Distance_Sensor_Block_Period_us;
+static volatile uint32_t Analog_Distance_Sensor_Sampled_ms;
+static uint32_t Analog_Distance_Sensor_Sampled_us;
+
+// Pointer to the user-defined function that processes a completed sample block
+static void (*Analog_Distance_Sensor_Block_Task)(uint32_t *block, uint32_t sample_count);
+
+// Returns the Timer_A2 period of one conversion trigger in SMCLK cycles, or 0 if a conversion does not fit in it
+static uint32_t Analog_Distance_Sensor_Trigger_Period(const Analog_Distance_Sensor_Config *config, uint32_t channel_count)
+{
+    uint32_t period;
+
+    if ((config->Resolution > ANALOG_DISTANCE_SENSOR_14_BIT) || (config->Sample_Time > ANALOG_DISTANCE_SENSOR_SAMPLE_192_CYCLES) ||
+        (config->Sequence_Rate_Hz == 0) || (config->Sequence_Rate_Hz > ANALOG_DISTANCE_SENSOR_SMCLK_HZ))
+    {
+        return 0;
+    }
+
+    // ADC14CLK is SMCLK, so the sample-and-hold time and the conversion time are also in SMCLK cycles
+    period = ANALOG_DISTANCE_SENSOR_SMCLK_HZ / (config->Sequence_Rate_Hz * channel_count);
+    if ((period > 0x10000) ||
+        (period <= (uint32_t)(Analog_Distance_Sensor_Sample_Cycles[config->Sample_Time] + Analog_Distance_Sensor_Conversion_Cycles[config->Resolution])))
+    {
+        return 0;
+    }
+
+    return period;
+}
+
+int Analog_Distance_Sensor_Configure(const Analog_Distance_Sensor_Config *config)
+{
+    if (Analog_Distance_Sensor_Trigger_Period(config, ANALOG_DISTANCE_SENSOR_NUM_CHANNELS + Analog_Distance_Sensor_Extra_Count) == 0)
+    {
+        return -1;
+    }
+
+    Analog_Distance_Sensor_Settings = *config;
+
+    // Every resolution step below 14 bits removes two bits of the result
+    Analog_Distance_Sensor_Result_Shift = 2 * (ANALOG_DISTANCE_SENSOR_14_BIT - config->Resolution);
+
+    return 0;
+}
+
+int Analog_Distance_Sensor_Add_Channel(uint8_t input)
+{
+    if ((input > ANALOG_DISTANCE_SENSOR_MAX_INPUT) || (Analog_Distance_Sensor_Extra_Count >= ANALOG_DISTANCE_SENSOR_MAX_EXTRA_CHANNELS) ||
+        (Analog_Distance_Sensor_Trigger_Period(&Analog_Distance_Sensor_Settings, ANALOG_DISTANCE_SENSOR_NUM_CHANNELS + Analog_Distance_Sensor_Extra_Count + 1) == 0))
+    {
+        return -1;
+    }
+
+    Analog_Distance_Sensor_Extra_Inputs[Analog_Distance_Sensor_Extra_Count] = input;
+    Analog_Distance_Sensor_Extra_Count++;
+
+    return Analog_Distance_Sensor_Extra_Count - 1;
+}
+
+uint32_t Analog_Distance_Sensor_Get_Channel(uint8_t index)
+{
+    if (index >= Analog_Distance_Sensor_Extra_Count)
+    {
+        return 0;
+    }
+
+    return ADC14->MEM[2 - Analog_Distance_Sensor_Extra_Count + index];
+}
+
 void Analog_Distance_Sensor_Init()
 {
+    uint32_t sample_time;
+    uint32_t index;
+
     // Clear ADC14ENC (Bit 1) to 0 to disable conversion
     ADC14->CTL0 &= ~0x00000002;
 
@@ -38,27 +165,34 @@ void Analog_Distance_Sensor_Init()
     //     21-19        ADC14SSELx          100b        ADC14CLK clock source: SMCLK
     //     18-17        ADC14CONSEQx        01b         Conversion sequence mode: Sequence-of-channels
     //      16          ADC14BUSY           0b          ADC14 busy status. Read-only.
-    //     15-12        ADC14SHT1x          0011b       Sample-and-hold time of 32 ADC14CLK clock cycles
-    //     11-8         ADC14SHT0x          0011b       Sample-and-hold time of 32 ADC14CLK clock cycles
+    //     15-12        ADC14SHT1x          xxxxb       Sample-and-hold time selected by Analog_Distance_Sensor_Configure
+    //     11-8         ADC14SHT0x          xxxxb       Sample-and-hold time selected by Analog_Distance_Sensor_Configure
     //      7           ADC14MSC            1b          Further sample-and-conversions are performed automatically
     //     6-5          Reserved            00b         Reserved
-    //      4           ADC14ON             0b          ADC14 off
+    //      4           ADC14ON             1b          ADC14 on
     //     3-2          Reserved            00b         Reserved
     //      1           ADC14ENC            0b          Disable conversion
     //      0           ADC14SC             0b          No sample-and-conversion start
-    ADC14->CTL0 = 0x04223390;
+    sample_time = Analog_Distance_Sensor_Settings.Sample_Time;
+    ADC14->CTL0 = 0x04220090 | (sample_time << 12) | (sample_time << 8);
 
     //     CTL1 Register Configuration
     //
     //     Bit(s)         Field             Value       Description
     //     -----        ----------          ------      -------------
-    //     20-16        ADC14STARTADDx      00010b      Select start address of ADC14MEM2
+    //     20-16        ADC14STARTADDx      000xxb      Select start address of the first added channel, or ADC14MEM2
     //     15-6         Reserved            000b        Reserved
-    //     5-4          ADC14RES            11b         14-bit resolution (16 clock cycle conversion time)
+    //     5-4          ADC14RES            xxb         Resolution selected by Analog_Distance_Sensor_Configure
     //      3           ADC14DF             0b          Data read-back format: Unsigned binary
     //      2           ADC14REFBURST       0b          Reference buffer on continuously
     //     1-0          ADC14PWRMD          00b         Regular power mode
-    ADC14->CTL1 = 0x00020030;
+    ADC14->CTL1 = ((uint32_t)(2 - Analog_Distance_Sensor_Extra_Count) << 16) | ((uint32_t)Analog_Distance_Sensor_Settings.Resolution << 4);
+
+    // The added channels are single-ended with V(R+) = AVCC and V(R-) = AVSS, and are not the end of the sequence
+    for (index = 0; index < Analog_Distance_Sensor_Extra_Count; index++)
+    {
+        ADC14->MCTL[2 - Analog_Distance_Sensor_Extra_Count + index] = Analog_Distance_Sensor_Extra_Inputs[index];
+    }
 
     //     MCTL2 Register Configuration
     //
@@ -143,12 +277,283 @@ void Analog_Distance_Sensor_Start_Conversion(uint32_t *Ch_17, uint32_t *Ch_14, u
 
 int32_t Analog_Distance_Sensor_Calibrate(int filtered_distance)
 {
+    uint32_t index;
+    int32_t fraction;
+    int32_t lower;
+
+    // Scale the value to the 14-bit range of the calibration table
+    filtered_distance = filtered_distance << Analog_Distance_Sensor_Result_Shift;
+
     // If the filtered distance (after LPF) is less than the max, return 800 mm
     if (filtered_distance < ANALOG_DISTANCE_SENSOR_MAX)
     {
-        return 800;
+        return ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE;
+    }
+
+    index = (uint32_t)filtered_distance >> ANALOG_DISTANCE_SENSOR_LUT_SHIFT;
+    if (index >= (ANALOG_DISTANCE_SENSOR_LUT_SIZE - 1))
+    {
+        return Analog_Distance_Sensor_Active_LUT[ANALOG_DISTANCE_SENSOR_LUT_SIZE - 1];
+    }
+
+    // Otherwise, interpolate between the two nearest entries of the calibration table
+    fraction = filtered_distance & ((1 << ANALOG_DISTANCE_SENSOR_LUT_SHIFT) - 1);
+    lower = Analog_Distance_Sensor_Active_LUT[index];
+
+    return lower + (((Analog_Distance_Sensor_Active_LUT[index + 1] - lower) * fraction) >> ANALOG_DISTANCE_SENSOR_LUT_SHIFT);
+}
+
+void Analog_Distance_Sensor_Calibrate_All(const uint32_t *filtered, int32_t *converted)
+{
+    uint32_t channel;
+
+    for (channel = 0; channel < ANALOG_DISTANCE_SENSOR_NUM_CHANNELS; channel++)
+    {
+        converted[channel] = Analog_Distance_Sensor_Calibrate(filtered[channel]);
+    }
+}
+
+int Analog_Distance_Sensor_Set_Calibration(Analog_Distance_Sensor_Calibration calibration)
+{
+    int32_t value;
+    uint32_t index;
+
+    // The first entry that is not out of range has the smallest denominator
+    index = (ANALOG_DISTANCE_SENSOR_MAX - (1 << ANALOG_DISTANCE_SENSOR_LUT_SHIFT) + ((1 << ANALOG_DISTANCE_SENSOR_LUT_SHIFT) - 1)) >> ANALOG_DISTANCE_SENSOR_LUT_SHIFT;
+    if (((int32_t)(index << ANALOG_DISTANCE_SENSOR_LUT_SHIFT) + calibration.B) <= 0)
+    {
+        return -1;
+    }
+
+    // Same entries as ANALOG_DISTANCE_SENSOR_LUT_ENTRY, clamped to the range of the table
+    for (index = 0; index < ANALOG_DISTANCE_SENSOR_LUT_SIZE; index++)
+    {
+        if ((index << ANALOG_DISTANCE_SENSOR_LUT_SHIFT) < (ANALOG_DISTANCE_SENSOR_MAX - (1 << ANALOG_DISTANCE_SENSOR_LUT_SHIFT)))
+        {
+            value = ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE;
+        }
+        else
+        {
+            value = (calibration.A / ((int32_t)(index << ANALOG_DISTANCE_SENSOR_LUT_SHIFT) + calibration.B)) + calibration.C;
+        }
+
+        if (value < 0)
+        {
+            value = 0;
+        }
+        else if (value > 0xFFFF)
+        {
+            value = 0xFFFF;
+        }
+        Analog_Distance_Sensor_RAM_LUT[index] = value;
+    }
+
+    Analog_Distance_Sensor_Coefficients = calibration;
+    Analog_Distance_Sensor_Active_LUT = Analog_Distance_Sensor_RAM_LUT;
+
+    return 0;
+}
+
+Analog_Distance_Sensor_Calibration Analog_Distance_Sensor_Get_Calibration()
+{
+    return Analog_Distance_Sensor_Coefficients;
+}
+
+static void Analog_Distance_Sensor_DMA_Arm(uint32_t block_index)
+{
+    DMA_Control_Structure *primary = DMA_Get_Primary_Control(ANALOG_DISTANCE_SENSOR_DMA_CHANNEL);
+    DMA_Control_Structure *alternate = DMA_Get_Alternate_Control(ANALOG_DISTANCE_SENSOR_DMA_CHANNEL);
+
+    // The primary structure copies one task (4 words) from the task list into the alternate structure
+    // on every request (end of sequence), and the alternate structure then performs the task
+    primary->Source_End_Pointer = &Analog_Distance_Sensor_Task_List[block_index][ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE - 1].Spare;
+    primary->Destination_End_Pointer = &alternate->Spare;
+    primary->Control = DMA_CTL_DST_INC_WORD | DMA_CTL_DST_SIZE_WORD | DMA_CTL_SRC_INC_WORD | DMA_CTL_SRC_SIZE_WORD |
+                       DMA_CTL_ARBITRATE_4 | DMA_CTL_TRANSFER_COUNT(4 * ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE) |
+                       DMA_CTL_CYCLE_PER_SG_PRI;
+
+    Analog_Distance_Sensor_Active_Block = block_index;
+
+    DMA_Enable_Channel(ANALOG_DISTANCE_SENSOR_DMA_CHANNEL);
+}
+
+static void Analog_Distance_Sensor_DMA_Complete(void)
+{
+    uint32_t completed_block = Analog_Distance_Sensor_Active_Block;
+
+    // Re-arm the controller with the other block first so that no sequence is missed
+    // while the completed block is being processed
+    Analog_Distance_Sensor_DMA_Arm(completed_block ^ 1);
+
+    Analog_Distance_Sensor_Block_Counter = Analog_Distance_Sensor_Block_Counter + 1;
+
+    // The sequence rate can change between two blocks, so the time is accumulated instead of derived from the count
+    Analog_Distance_Sensor_Sampled_us = Analog_Distance_Sensor_Sampled_us + Analog_Distance_Sensor_Block_Period_us;
+    Analog_Distance_Sensor_Sampled_ms = Analog_Distance_Sensor_Sampled_ms + (Analog_Distance_Sensor_Sampled_us / 1000);
+    Analog_Distance_Sensor_Sampled_us = Analog_Distance_Sensor_Sampled_us % 1000;
+
+    // Execute the user-defined task with the completed block
+    (*Analog_Distance_Sensor_Block_Task)(Analog_Distance_Sensor_Block[completed_block], ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE);
+}
+
+void Analog_Distance_Sensor_DMA_Init(void(*task)(uint32_t *block, uint32_t sample_count))
+{
+    uint32_t block_index;
+    uint32_t sample_index;
+    uint32_t sample_time = Analog_Distance_Sensor_Settings.Sample_Time;
+    uint32_t trigger_period = Analog_Distance_Sensor_Trigger_Period(&Analog_Distance_Sensor_Settings,
+                                                                     ANALOG_DISTANCE_SENSOR_NUM_CHANNELS + Analog_Distance_Sensor_Extra_Count);
+
+    // Store the user-defined task function for use during interrupt handling
+    Analog_Distance_Sensor_Block_Task = task;
+
+    // Halt Timer A2 by clearing the MC bits in the CTL register
+    TIMER_A2->CTL &= ~0x0030;
+
+    // Clear ADC14ENC (Bit 1) to 0 to disable conversion
+    ADC14->CTL0 &= ~0x00000002;
+
+    // Wait for ADC14BUSY (Bit 16) to be 0
+    while(ADC14->CTL0 & 0x00010000);
+
+    // Build the task lists. Every task copies the three conversion results of one sequence.
+    // The last task of each list uses the basic cycle type, which ends the DMA cycle
+    // and generates the completion interrupt.
+    for (block_index = 0; block_index < 2; block_index++)
+    {
+        for (sample_index = 0; sample_index < ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE; sample_index++)
+        {
+            DMA_Control_Structure *dma_task = &Analog_Distance_Sensor_Task_List[block_index][sample_index];
+
+            dma_task->Source_End_Pointer = &ADC14->MEM[4];
+            dma_task->Destination_End_Pointer = &Analog_Distance_Sensor_Block[block_index][(sample_index * ANALOG_DISTANCE_SENSOR_NUM_CHANNELS) + 2];
+            dma_task->Control = DMA_CTL_DST_INC_WORD | DMA_CTL_DST_SIZE_WORD | DMA_CTL_SRC_INC_WORD | DMA_CTL_SRC_SIZE_WORD |
+                                DMA_CTL_ARBITRATE_4 | DMA_CTL_TRANSFER_COUNT(ANALOG_DISTANCE_SENSOR_NUM_CHANNELS);
+
+            if (sample_index == (ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE - 1))
+            {
+                dma_task->Control |= DMA_CTL_CYCLE_BASIC;
+            }
+            else
+            {
+                dma_task->Control |= DMA_CTL_CYCLE_PER_SG_ALT;
+            }
+
+            dma_task->Spare = 0;
+        }
+    }
+
+    // Configure channel 7 to be triggered by ADC14 and route its completion interrupt to DMA_INT1
+    DMA_Init();
+    DMA_Assign_Channel(ANALOG_DISTANCE_SENSOR_DMA_CHANNEL, ANALOG_DISTANCE_SENSOR_DMA_SOURCE);
+    DMA_Assign_Interrupt(ANALOG_DISTANCE_SENSOR_DMA_INTERRUPT, ANALOG_DISTANCE_SENSOR_DMA_CHANNEL, &Analog_Distance_Sensor_DMA_Complete);
+
+    Analog_Distance_Sensor_Block_Counter = 0;
+    Analog_Distance_Sensor_Block_Period_us = (ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE * 1000000) / Analog_Distance_Sensor_Settings.Sequence_Rate_Hz;
+    Analog_Distance_Sensor_Sampled_ms = 0;
+    Analog_Distance_Sensor_Sampled_us = 0;
+    Analog_Distance_Sensor_DMA_Arm(0);
+
+    //     CTL0 Register Configuration
+    //
+    //     Bit(s)         Field             Value       Description
+    //     -----        ----------          ------      -------------
+    //     31-30        ADC14PDIV           00b         Predivide selected ADC14CLK: Predivide by 1
+    //     29-27        ADC14SHSx           101b        Sample-and-hold source select: TA2_C1
+    //      26          ADC14SHP            1b          SAMPCON signal is sourced from the sampling timer
+    //      25          ADC14ISSH           0b          Sample-input signal is not inverted
+    //     24-22        ADC14DIVx           000b        Divide ADC14CLK frequency by 1
+    //     21-19        ADC14SSELx          100b        ADC14CLK clock source: SMCLK
+    //     18-17        ADC14CONSEQx        11b         Conversion sequence mode: Repeat-sequence-of-channels
+    //      16          ADC14BUSY           0b          ADC14 busy status. Read-only.
+    //     15-12        ADC14SHT1x          xxxxb       Sample-and-hold time selected by Analog_Distance_Sensor_Configure
+    //     11-8         ADC14SHT0x          xxxxb       Sample-and-hold time selected by Analog_Distance_Sensor_Configure
+    //      7           ADC14MSC            0b          Every conversion requires a rising edge of the trigger
+    //     6-5          Reserved            00b         Reserved
+    //      4           ADC14ON             1b          ADC14 on
+    //     3-2          Reserved            00b         Reserved
+    //      1           ADC14ENC            0b          Disable conversion
+    //      0           ADC14SC             0b          No sample-and-conversion start
+    ADC14->CTL0 = 0x2C260010 | (sample_time << 12) | (sample_time << 8);
+
+    // Disable all interrupts. The DMA request is generated at the end of each sequence
+    // when ADC14IFG4 is set, so the CPU is not involved in the transfers.
+    ADC14->IER0 = 0;
+    ADC14->IER1 = 0;
+
+    // Set ADC14ENC (Bit 1) to 1 to enable conversion
+    // Conversions start on the next rising edge of TA2_C1
+    ADC14->CTL0 |= 0x00000002;
+
+    // Choose SMCLK as timer clock source (TASSEL = 10b) with a prescale value of 1 (ID = 0)
+    TIMER_A2->CTL = 0x0200;
+    TIMER_A2->EX0 = 0x0000;
+
+    // Store the conversion trigger period in the CCR0 register, so every channel is converted at the sequence rate
+    // Note: Timer starts counting from 0
+    TIMER_A2->CCR[0] = (trigger_period - 1);
+
+    // Use the reset/set output mode (OUTMOD = 111b) on CCR1 with a 50% duty cycle
+    // The rising edge of TA2_C1 at the end of each period triggers one conversion
+    TIMER_A2->CCTL[1] = 0x00E0;
+    TIMER_A2->CCR[1] = (trigger_period >> 1);
+
+    // Set the TACLR bit and enable Timer A2 in up mode using the
+    // MC bits in the CTL register
+    TIMER_A2->CTL |= 0x0014;
+}
+
+void Analog_Distance_Sensor_DMA_Stop(void)
+{
+    // Halt Timer A2 by clearing the MC bits in the CTL register
+    TIMER_A2->CTL &= ~0x0030;
+
+    // Clear ADC14ENC (Bit 1) to 0 to disable conversion
+    ADC14->CTL0 &= ~0x00000002;
+
+    DMA_Disable_Channel(ANALOG_DISTANCE_SENSOR_DMA_CHANNEL);
+}
+
+uint32_t Analog_Distance_Sensor_DMA_Block_Count(void)
+{
+    return Analog_Distance_Sensor_Block_Counter;
+}
+
+uint32_t Analog_Distance_Sensor_DMA_Time_ms(void)
+{
+    return Analog_Distance_Sensor_Sampled_ms;
+}
+
+int Analog_Distance_Sensor_Set_Sequence_Rate(uint32_t sequence_rate_hz)
+{
+    Analog_Distance_Sensor_Config config = Analog_Distance_Sensor_Settings;
+    uint32_t trigger_period;
+
+    config.Sequence_Rate_Hz = sequence_rate_hz;
+    trigger_period = Analog_Distance_Sensor_Trigger_Period(&config, ANALOG_DISTANCE_SENSOR_NUM_CHANNELS + Analog_Distance_Sensor_Extra_Count);
+    if (trigger_period == 0)
+    {
+        return -1;
+    }
+
+    Analog_Distance_Sensor_Settings.Sequence_Rate_Hz = sequence_rate_hz;
+
+    // Timer_A2 only runs in DMA mode (MC bits not 00b), otherwise the rate is used by the next Analog_Distance_Sensor_DMA_Init
+    if ((TIMER_A2->CTL & 0x0030) == 0)
+    {
+        return 0;
     }
 
-    // Otherwise, calculate the calibrated distance using the calibration formula
-    return (Ax / (filtered_distance + Bx) + Cx);
+    // Halt Timer A2, so that the new period does not produce a short or a missing trigger
+    TIMER_A2->CTL &= ~0x0030;
+
+    // The block being filled is timed at the new rate, the conversions of a sequence stay evenly spaced
+    Analog_Distance_Sensor_Block_Period_us = (ANALOG_DISTANCE_SENSOR_DMA_BLOCK_SIZE * 1000000) / sequence_rate_hz;
+    TIMER_A2->CCR[0] = (trigger_period - 1);
+    TIMER_A2->CCR[1] = (trigger_period >> 1);
+
+    // Set the TACLR bit and restart Timer A2 in up mode using the MC bits in the CTL register
+    TIMER_A2->CTL |= 0x0014;
+
+    return 0;
 }
@@ -26,6 +26,20 @@
  */
 
 #include "../inc/Barcode_Scanner.h"
+#include "../inc/Interrupt_Priority.h"
+
+// Receive ring buffer used when no command table is set
+static uint8_t Barcode_Scanner_RX_Buffer[BARCODE_SCANNER_RX_BUFFER_SIZE];
+static volatile uint32_t Barcode_Scanner_RX_Head = 0;
+static volatile uint32_t Barcode_Scanner_RX_Tail = 0;
+
+// Command table and the line assembled by the EUSCI_A2 interrupt
+static Barcode_Scanner_Command *Barcode_Scanner_Commands = 0;
+static uint8_t Barcode_Scanner_Num_Commands = 0;
+static char Barcode_Scanner_Line[BARCODE_SCANNER_BUFFER_SIZE];
+static uint8_t Barcode_Scanner_Line_Length = 0;
+static uint8_t Barcode_Scanner_Line_Overflow = 0;
+static volatile uint32_t Barcode_Scanner_Unknown_Count = 0;
 
 void Barcode_Scanner_Init()
 {
@@ -78,30 +92,42 @@ void Barcode_Scanner_Init()
     // corresponding bits in the IE register:
     // - Transmit Complete Interrupt (UCTXCPTIE, Bit 3)
     // - Start Bit Interrupt (UCSTTIE, Bit 2)
-    EUSCI_A2->IE &= ~0x0C;
+    // - Transmit Interrupt (UCTXIE, Bit 1): The transmitter is polled
+    EUSCI_A2->IE &= ~0x0E;
+
+    // Empty the receive ring buffer and the line
+    Barcode_Scanner_RX_Head = 0;
+    Barcode_Scanner_RX_Tail = 0;
+    Barcode_Scanner_Line_Length = 0;
+    Barcode_Scanner_Line_Overflow = 0;
+    Barcode_Scanner_Unknown_Count = 0;
 
-    // Enable the following interrupts by setting the
-    // corresponding bits in the IE register
-    // - Transmit Interrupt (UCTXIE, Bit 1)
-    // - Receive Interrupt (UCRXIE, Bit 0)
-    EUSCI_A2->IE |= 0x03;
+    // Set the interrupt priority level (EUSCI_A2 has an IRQ number of 18)
+    NVIC->IP[18] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_EUSCI_A2);
+
+    // Enable Interrupt 18 in NVIC by setting Bit 18 of the ISER[0] register
+    NVIC->ISER[0] = 0x00040000;
 
     // Release the EUSCI_A2 module from the reset state by clearing the
     // UCSWRST bit (Bit 0) in the CTLW0 register
     EUSCI_A2->CTLW0 &= ~0x01;
+
+    // Enable the Receive Interrupt (UCRXIE, Bit 0) in the IE register
+    // Note: The IE register is cleared when UCSWRST is set, so it is written after the release
+    EUSCI_A2->IE |= 0x01;
 }
 
 uint8_t Barcode_Scanner_InChar()
 {
-    // Check the Receive Interrupt flag (UCRXIFG, Bit 0)
-    // in the IFG register and wait if the flag is not set
-    // If the UCRXIFG is set, then the Receive Buffer (UCAxRXBUF) has
-    // received a complete character
-    while((EUSCI_A2->IFG & 0x01) == 0);
+    uint8_t data;
 
-    // Return the data from the Receive Buffer (UCAxRXBUF)
-    // Reading the UCAxRXBUF will reset the UCRXIFG flag
-    return EUSCI_A2->RXBUF;
+    // Wait until the EUSCI_A2 interrupt has stored a character in the ring buffer
+    while(Barcode_Scanner_RX_Tail == Barcode_Scanner_RX_Head);
+
+    data = Barcode_Scanner_RX_Buffer[Barcode_Scanner_RX_Tail & (BARCODE_SCANNER_RX_BUFFER_SIZE - 1)];
+    Barcode_Scanner_RX_Tail = Barcode_Scanner_RX_Tail + 1;
+
+    return data;
 }
 
 void Barcode_Scanner_OutChar(uint8_t data)
@@ -142,7 +168,8 @@ int Barcode_Scanner_Read(char *buffer_pointer, uint16_t buffer_size)
         }
 
         // Otherwise, if there are more characters to be read, store them in the buffer
-        else if (length < buffer_size)
+        // Note: One character is kept for the terminating null character
+        else if ((length + 1) < buffer_size)
         {
             *buffer_pointer = character;
             buffer_pointer++;
@@ -168,3 +195,122 @@ uint8_t Check_Barcode_Scanner_Command(char Barcode_Scanner_Buffer[], char *comma
         return 0x00;
     }
 }
+
+uint32_t Barcode_Scanner_Hash(const char *string)
+{
+    uint32_t hash = BARCODE_SCANNER_FNV_OFFSET_BASIS;
+
+    while (*string != 0)
+    {
+        hash = (hash ^ (uint8_t)(*string)) * BARCODE_SCANNER_FNV_PRIME;
+        string++;
+    }
+
+    return hash;
+}
+
+void Barcode_Scanner_Set_Commands(Barcode_Scanner_Command *commands, uint8_t count)
+{
+    uint8_t index;
+
+    // Hash the command names once, so that the interrupt only compares one word per command
+    for (index = 0; index < count; index++)
+    {
+        commands[index].Hash = Barcode_Scanner_Hash(commands[index].Name);
+    }
+
+    // Disable the Receive Interrupt (UCRXIE, Bit 0) while the table is replaced
+    EUSCI_A2->IE &= ~0x01;
+    Barcode_Scanner_Commands = commands;
+    Barcode_Scanner_Num_Commands = (commands != 0) ? count : 0;
+    Barcode_Scanner_Line_Length = 0;
+    Barcode_Scanner_Line_Overflow = 0;
+    EUSCI_A2->IE |= 0x01;
+}
+
+uint32_t Barcode_Scanner_Get_Unknown_Count()
+{
+    return Barcode_Scanner_Unknown_Count;
+}
+
+// Executes the handler of the command that matches the received line
+static void Barcode_Scanner_Dispatch_Line()
+{
+    uint32_t hash;
+    uint8_t index;
+
+    Barcode_Scanner_Line[Barcode_Scanner_Line_Length] = 0;
+    hash = Barcode_Scanner_Hash(Barcode_Scanner_Line);
+
+    for (index = 0; index < Barcode_Scanner_Num_Commands; index++)
+    {
+        // Compare the names only when the hashes are equal to reject a hash collision
+        if ((Barcode_Scanner_Commands[index].Hash == hash) && (strcmp(Barcode_Scanner_Commands[index].Name, Barcode_Scanner_Line) == 0))
+        {
+            (*Barcode_Scanner_Commands[index].Handler)();
+            return;
+        }
+    }
+
+    Barcode_Scanner_Unknown_Count = Barcode_Scanner_Unknown_Count + 1;
+}
+
+void EUSCI_A2_IRQHandler(void)
+{
+    uint8_t data;
+
+    // Check the Receive Interrupt flag (UCRXIFG, Bit 0)
+    // If the UCRXIFG is set, then the Receive Buffer (UCAxRXBUF) has received a complete character
+    if ((EUSCI_A2->IFG & 0x01) == 0)
+    {
+        return;
+    }
+
+    // Reading the UCAxRXBUF will reset the UCRXIFG flag
+    data = EUSCI_A2->RXBUF;
+
+    if (Barcode_Scanner_Commands == 0)
+    {
+        // Store the character in the ring buffer, or drop it if the ring buffer is full
+        if ((Barcode_Scanner_RX_Head - Barcode_Scanner_RX_Tail) < BARCODE_SCANNER_RX_BUFFER_SIZE)
+        {
+            Barcode_Scanner_RX_Buffer[Barcode_Scanner_RX_Head & (BARCODE_SCANNER_RX_BUFFER_SIZE - 1)] = data;
+            Barcode_Scanner_RX_Head = Barcode_Scanner_RX_Head + 1;
+        }
+        return;
+    }
+
+    if (data == CR)
+    {
+        // A line that did not fit in the buffer cannot match a command
+        if (Barcode_Scanner_Line_Overflow)
+        {
+            Barcode_Scanner_Unknown_Count = Barcode_Scanner_Unknown_Count + 1;
+        }
+        else if (Barcode_Scanner_Line_Length > 0)
+        {
+            Barcode_Scanner_Dispatch_Line();
+        }
+        Barcode_Scanner_Line_Length = 0;
+        Barcode_Scanner_Line_Overflow = 0;
+    }
+    else if (data == BS)
+    {
+        if (Barcode_Scanner_Line_Length > 0)
+        {
+            Barcode_Scanner_Line_Length--;
+        }
+    }
+    else if (data != LF)
+    {
+        if ((Barcode_Scanner_Line_Length + 1) < BARCODE_SCANNER_BUFFER_SIZE)
+        {
+            Barcode_Scanner_Line[Barcode_Scanner_Line_Length] = data;
+            Barcode_Scanner_Line_Length++;
+        }
+        else
+        {
+            Barcode_Scanner_Line_Overflow = 1;
+        }
+    }
+}
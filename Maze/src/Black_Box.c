@@ -0,0 +1,404 @@
+/**
+ * @file Black_Box.c
+ * @brief Source code for the Black_Box module.
+ *
+ * This file contains the function definitions for the Black_Box module.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Black_Box.h"
+
+// Magic word of a complete page ("BBX1")
+#define BLACK_BOX_MAGIC                 0x42425831
+
+// Value of the newest slot when no page has been found
+#define BLACK_BOX_NO_SLOT               0xFFFFFFFF
+
+#define BLACK_BOX_SLOT_ADDRESS(slot)    (BLACK_BOX_START_ADDRESS + ((slot) * BLACK_BOX_PAGE_SIZE))
+#define BLACK_BOX_SECTOR_ADDRESS(sector) (BLACK_BOX_START_ADDRESS + ((sector) * FLASH_SECTOR_SIZE))
+#define BLACK_BOX_PADDED(length)        (((length) + 3) & ~3)
+
+// Page buffers: the buffer being filled by Black_Box_Log, and one bit per buffer waiting to be programmed
+static uint32_t Black_Box_Buffer[2][BLACK_BOX_PAGE_SIZE / 4];
+static volatile uint8_t Black_Box_Fill_Buffer;
+static volatile uint16_t Black_Box_Fill_Count;
+static volatile uint8_t Black_Box_Pending_Mask;
+static volatile uint8_t Black_Box_Flush_Pending;
+static volatile uint32_t Black_Box_Dropped;
+
+// Current run, number of its next page, and decimation of the records
+static volatile uint8_t Black_Box_Recording;
+static uint16_t Black_Box_Run;
+static uint16_t Black_Box_Page;
+static uint16_t Black_Box_Decimation = BLACK_BOX_DEFAULT_DECIMATION;
+static uint16_t Black_Box_Decimation_Count;
+
+// Writer: buffer to program next, slot of the page and offset of its next word, and newest complete slot
+static uint8_t Black_Box_Write_Buffer;
+static uint32_t Black_Box_Slot;
+static uint32_t Black_Box_Word;
+static uint32_t Black_Box_Newest;
+static uint32_t Black_Box_Errors;
+
+// Set for a sector erased since the writer has last used it, and sector being erased (+1, or 0 if none)
+static uint8_t Black_Box_Erased[BLACK_BOX_NUM_SECTORS];
+static uint8_t Black_Box_Erasing;
+
+// Returns the CRC of a page from its header and its records
+static uint32_t Black_Box_Page_CRC(const uint32_t *page, uint16_t count)
+{
+    uint32_t crc;
+
+    crc = Flash_CRC32(0xFFFFFFFF, (const uint8_t *)&page[1], 8);
+    crc = Flash_CRC32(crc, (const uint8_t *)page + BLACK_BOX_PAGE_HEADER_SIZE, count * BLACK_BOX_RECORD_SIZE);
+
+    return ~crc;
+}
+
+// Returns 1 if a slot holds a complete page
+static uint8_t Black_Box_Is_Valid(uint32_t slot)
+{
+    const uint32_t *page = (const uint32_t *)BLACK_BOX_SLOT_ADDRESS(slot);
+    uint16_t count = page[2] & 0xFFFF;
+
+    return (page[0] == BLACK_BOX_MAGIC) && ((page[2] >> 16) == BLACK_BOX_RECORD_SIZE) &&
+           (count <= BLACK_BOX_RECORDS_PER_PAGE) && (page[3] == Black_Box_Page_CRC(page, count));
+}
+
+// Hands the buffer being filled to the writer, returns 0 if the other buffer is still waiting to be programmed
+// Note: Called with the interrupts disabled or from the control tick
+static uint8_t Black_Box_Seal(void)
+{
+    uint8_t buffer = Black_Box_Fill_Buffer;
+
+    if (Black_Box_Pending_Mask & (1 << (buffer ^ 1)))
+    {
+        return 0;
+    }
+
+    Black_Box_Buffer[buffer][1] = Black_Box_Run | ((uint32_t)Black_Box_Page << 16);
+    Black_Box_Buffer[buffer][2] = Black_Box_Fill_Count | ((uint32_t)BLACK_BOX_RECORD_SIZE << 16);
+    Black_Box_Pending_Mask |= (1 << buffer);
+
+    Black_Box_Fill_Buffer = buffer ^ 1;
+    Black_Box_Fill_Count = 0;
+    Black_Box_Page = Black_Box_Page + 1;
+
+    return 1;
+}
+
+// Releases the programmed buffer and moves the writer to the next slot
+static void Black_Box_Next_Slot(void)
+{
+    long sr;
+
+    sr = StartCritical();
+    Black_Box_Pending_Mask &= ~(1 << Black_Box_Write_Buffer);
+    EndCritical(sr);
+
+    Black_Box_Write_Buffer ^= 1;
+    Black_Box_Word = 0;
+    Black_Box_Slot = (Black_Box_Slot + 1) % BLACK_BOX_NUM_PAGES;
+
+    // The sector that has been left must be erased again before the next pass
+    if ((Black_Box_Slot % BLACK_BOX_PAGES_PER_SECTOR) == 0)
+    {
+        Black_Box_Erased[((Black_Box_Slot + BLACK_BOX_NUM_PAGES - 1) % BLACK_BOX_NUM_PAGES) / BLACK_BOX_PAGES_PER_SECTOR] = 0;
+    }
+}
+
+// Programs a part of the page buffer, returns 1 when the page is complete, 0 if it is not, or -1 if it has failed
+static int Black_Box_Program_Page(void)
+{
+    uint32_t *page = Black_Box_Buffer[Black_Box_Write_Buffer];
+    uint32_t address = BLACK_BOX_SLOT_ADDRESS(Black_Box_Slot);
+    uint32_t end = BLACK_BOX_PAGE_HEADER_SIZE + BLACK_BOX_PADDED((page[2] & 0xFFFF) * BLACK_BOX_RECORD_SIZE);
+    uint32_t words = 0;
+
+    // The CRC is computed in the background instead of the control tick
+    if (Black_Box_Word == 0)
+    {
+        page[0] = BLACK_BOX_MAGIC;
+        page[3] = Black_Box_Page_CRC(page, page[2] & 0xFFFF);
+        Black_Box_Word = BLACK_BOX_PAGE_HEADER_SIZE;
+    }
+
+    while ((Black_Box_Word < end) && (words < BLACK_BOX_WORDS_PER_TASK))
+    {
+        if (Flash_Program_Word(address + Black_Box_Word, page[Black_Box_Word / 4]) != 0)
+        {
+            return -1;
+        }
+        Black_Box_Word = Black_Box_Word + 4;
+        words++;
+    }
+
+    if (Black_Box_Word < end)
+    {
+        return 0;
+    }
+
+    // The magic word is programmed last, so that an interrupted page is not valid
+    if ((Flash_Program_Word(address + 4, page[1]) != 0) || (Flash_Program_Word(address + 8, page[2]) != 0) ||
+        (Flash_Program_Word(address + 12, page[3]) != 0) || (Flash_Program_Word(address, page[0]) != 0))
+    {
+        return -1;
+    }
+
+    return 1;
+}
+
+void Black_Box_Init(void)
+{
+    const uint32_t *page;
+    uint32_t newest_key = 0;
+    uint32_t key;
+    uint32_t slot;
+
+    Black_Box_Newest = BLACK_BOX_NO_SLOT;
+
+    // The newest page has the highest run and page numbers (the comparison handles the wrap-around of the run numbers)
+    for (slot = 0; slot < BLACK_BOX_NUM_PAGES; slot++)
+    {
+        if (Black_Box_Is_Valid(slot) == 0)
+        {
+            continue;
+        }
+
+        page = (const uint32_t *)BLACK_BOX_SLOT_ADDRESS(slot);
+        key = (page[1] << 16) | (page[1] >> 16);
+        if ((Black_Box_Newest == BLACK_BOX_NO_SLOT) || ((int32_t)(key - newest_key) > 0))
+        {
+            Black_Box_Newest = slot;
+            newest_key = key;
+        }
+    }
+
+    // The rest of the sector of the newest page may not be erased, so the next run starts in the next sector
+    if (Black_Box_Newest == BLACK_BOX_NO_SLOT)
+    {
+        Black_Box_Run = 0;
+        Black_Box_Slot = 0;
+    }
+    else
+    {
+        Black_Box_Run = newest_key >> 16;
+        Black_Box_Slot = (((Black_Box_Newest / BLACK_BOX_PAGES_PER_SECTOR) + 1) % BLACK_BOX_NUM_SECTORS) * BLACK_BOX_PAGES_PER_SECTOR;
+    }
+
+    memset(Black_Box_Erased, 0, sizeof(Black_Box_Erased));
+    Black_Box_Erasing = 0;
+    Black_Box_Recording = 0;
+    Black_Box_Fill_Buffer = 0;
+    Black_Box_Fill_Count = 0;
+    Black_Box_Pending_Mask = 0;
+    Black_Box_Flush_Pending = 0;
+    Black_Box_Write_Buffer = 0;
+    Black_Box_Word = 0;
+    Black_Box_Dropped = 0;
+    Black_Box_Errors = 0;
+}
+
+void Black_Box_Start(void)
+{
+    long sr;
+
+    sr = StartCritical();
+
+    // Close the current run, its last records are dropped if both buffers are still waiting
+    if ((Black_Box_Fill_Count > 0) && (Black_Box_Seal() == 0))
+    {
+        Black_Box_Dropped = Black_Box_Dropped + Black_Box_Fill_Count;
+        Black_Box_Fill_Count = 0;
+    }
+    Black_Box_Flush_Pending = 0;
+
+    Black_Box_Run = Black_Box_Run + 1;
+    Black_Box_Page = 0;
+    Black_Box_Decimation_Count = 0;
+    Black_Box_Recording = 1;
+
+    EndCritical(sr);
+}
+
+void Black_Box_Stop(void)
+{
+    long sr;
+
+    sr = StartCritical();
+    if (Black_Box_Recording)
+    {
+        Black_Box_Recording = 0;
+        Black_Box_Flush_Pending = (Black_Box_Fill_Count > 0);
+    }
+    EndCritical(sr);
+}
+
+uint8_t Black_Box_Is_Recording(void)
+{
+    return Black_Box_Recording;
+}
+
+uint8_t Black_Box_Is_Busy(void)
+{
+    return (Black_Box_Pending_Mask != 0) || Black_Box_Flush_Pending || (Black_Box_Erasing != 0);
+}
+
+void Black_Box_Set_Decimation(uint16_t decimation)
+{
+    Black_Box_Decimation = (decimation > 0) ? decimation : 1;
+}
+
+uint8_t Black_Box_Sample_Due(void)
+{
+    if (Black_Box_Recording == 0)
+    {
+        return 0;
+    }
+
+    Black_Box_Decimation_Count = Black_Box_Decimation_Count + 1;
+    if (Black_Box_Decimation_Count < Black_Box_Decimation)
+    {
+        return 0;
+    }
+    Black_Box_Decimation_Count = 0;
+
+    return 1;
+}
+
+void Black_Box_Log(const void *record)
+{
+    if (Black_Box_Recording == 0)
+    {
+        return;
+    }
+
+    // A full buffer waits for the writer to release the other one
+    if ((Black_Box_Fill_Count == BLACK_BOX_RECORDS_PER_PAGE) && (Black_Box_Seal() == 0))
+    {
+        Black_Box_Dropped = Black_Box_Dropped + 1;
+        return;
+    }
+
+    memcpy((uint8_t *)Black_Box_Buffer[Black_Box_Fill_Buffer] + BLACK_BOX_PAGE_HEADER_SIZE + (Black_Box_Fill_Count * BLACK_BOX_RECORD_SIZE),
+           record, BLACK_BOX_RECORD_SIZE);
+    Black_Box_Fill_Count = Black_Box_Fill_Count + 1;
+
+    if (Black_Box_Fill_Count == BLACK_BOX_RECORDS_PER_PAGE)
+    {
+        Black_Box_Seal();
+    }
+}
+
+void Black_Box_Task(void)
+{
+    uint8_t sector;
+    uint8_t next_sector;
+    int result;
+    long sr;
+
+    // Let the erase in progress complete
+    result = Flash_Erase_Poll();
+    if (result > 0)
+    {
+        return;
+    }
+    if (Black_Box_Erasing != 0)
+    {
+        Black_Box_Erased[Black_Box_Erasing - 1] = (result == 0);
+        Black_Box_Erasing = 0;
+    }
+
+    // Write the last partial page once a buffer is free
+    if (Black_Box_Flush_Pending)
+    {
+        sr = StartCritical();
+        if (Black_Box_Seal())
+        {
+            Black_Box_Flush_Pending = 0;
+        }
+        EndCritical(sr);
+    }
+
+    sector = Black_Box_Slot / BLACK_BOX_PAGES_PER_SECTOR;
+
+    if (Black_Box_Pending_Mask & (1 << Black_Box_Write_Buffer))
+    {
+        if (Black_Box_Erased[sector] == 0)
+        {
+            if (Flash_Erase_Start(BLACK_BOX_SECTOR_ADDRESS(sector)) == 0)
+            {
+                Black_Box_Erasing = sector + 1;
+            }
+            return;
+        }
+
+        result = Black_Box_Program_Page();
+        if (result != 0)
+        {
+            // A failed page is skipped, since its words may already be programmed
+            if (result < 0)
+            {
+                Black_Box_Errors = Black_Box_Errors + 1;
+            }
+            else
+            {
+                Black_Box_Newest = Black_Box_Slot;
+            }
+            Black_Box_Next_Slot();
+        }
+        return;
+    }
+
+    // Erase the next sector ahead while there is no page to program, the oldest pages are lost
+    next_sector = (sector + 1) % BLACK_BOX_NUM_SECTORS;
+    if (Black_Box_Recording && (Black_Box_Erased[next_sector] == 0))
+    {
+        if (Flash_Erase_Start(BLACK_BOX_SECTOR_ADDRESS(next_sector)) == 0)
+        {
+            Black_Box_Erasing = next_sector + 1;
+        }
+    }
+}
+
+int Black_Box_Read_Page(uint32_t position, Black_Box_Page_Info *info, const uint8_t **records)
+{
+    const uint32_t *page;
+    uint32_t slot;
+
+    if (position >= BLACK_BOX_NUM_PAGES)
+    {
+        return -1;
+    }
+
+    // The oldest page follows the newest one in the ring
+    slot = (Black_Box_Newest == BLACK_BOX_NO_SLOT) ? position : ((Black_Box_Newest + 1 + position) % BLACK_BOX_NUM_PAGES);
+    if (Black_Box_Is_Valid(slot) == 0)
+    {
+        return -1;
+    }
+
+    page = (const uint32_t *)BLACK_BOX_SLOT_ADDRESS(slot);
+    info->Run = page[1] & 0xFFFF;
+    info->Page = page[1] >> 16;
+    info->Count = page[2] & 0xFFFF;
+    *records = (const uint8_t *)page + BLACK_BOX_PAGE_HEADER_SIZE;
+
+    return 0;
+}
+
+uint16_t Black_Box_Get_Run(void)
+{
+    return Black_Box_Run;
+}
+
+uint32_t Black_Box_Get_Dropped(void)
+{
+    return Black_Box_Dropped;
+}
+
+uint32_t Black_Box_Get_Errors(void)
+{
+    return Black_Box_Errors;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file Black_Box_Dump.c
+ * @brief Source code for the Black_Box_Dump module.
+ *
+ * This file contains the function definitions for the Black_Box_Dump module.
+ * It executes the black box commands and sends the records of a black box dump in the background.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Black_Box_Dump.h"
+#include "../inc/Print_Format.h"
+
+// States of a black box dump: waiting for the last pages to be written, then sending the records
+#define BLACK_BOX_DUMP_IDLE     0
+#define BLACK_BOX_DUMP_FLUSH    1
+#define BLACK_BOX_DUMP_SEND     2
+
+// Function that sends a reply line
+static void (*Black_Box_Dump_Output)(const char *line);
+
+// State of the dump, next record to send, and number of records sent
+static volatile uint8_t Black_Box_Dump_State = BLACK_BOX_DUMP_IDLE;
+static uint32_t Black_Box_Dump_Page = 0;
+static uint16_t Black_Box_Dump_Record = 0;
+static uint32_t Black_Box_Dump_Count = 0;
+
+// Header and records of the page being sent
+static Black_Box_Page_Info Black_Box_Dump_Info;
+static const uint8_t *Black_Box_Dump_Records;
+
+void Black_Box_Dump_Init(void (*output)(const char *line))
+{
+    Black_Box_Dump_Output = output;
+    Black_Box_Dump_State = BLACK_BOX_DUMP_IDLE;
+}
+
+int Black_Box_Dump_Command(char **arguments, uint8_t argument_count)
+{
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+
+    if ((argument_count != 2) || (strcmp(arguments[0], "blackbox") != 0))
+    {
+        return -1;
+    }
+
+    if (strcmp(arguments[1], "dump") == 0)
+    {
+        if (Black_Box_Dump_State == BLACK_BOX_DUMP_IDLE)
+        {
+            // The pages must not change while they are read
+            Black_Box_Stop();
+            Black_Box_Dump_Page = 0;
+            Black_Box_Dump_Record = 0;
+            Black_Box_Dump_Count = 0;
+            Black_Box_Dump_State = BLACK_BOX_DUMP_FLUSH;
+        }
+    }
+    else if (strcmp(arguments[1], "start") == 0)
+    {
+        Black_Box_Start();
+        Print_Format_To_Buffer(line, sizeof(line), "ok blackbox run %u", (unsigned int)Black_Box_Get_Run());
+        Black_Box_Dump_Output(line);
+    }
+    else if (strcmp(arguments[1], "stop") == 0)
+    {
+        Black_Box_Stop();
+        Black_Box_Dump_Output("ok blackbox stop");
+    }
+    else if (strcmp(arguments[1], "status") == 0)
+    {
+        Print_Format_To_Buffer(line, sizeof(line), "blackbox run=%u recording=%u dropped=%lu errors=%lu", (unsigned int)Black_Box_Get_Run(),
+                 (unsigned int)Black_Box_Is_Recording(), (unsigned long)Black_Box_Get_Dropped(), (unsigned long)Black_Box_Get_Errors());
+        Black_Box_Dump_Output(line);
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+void Black_Box_Dump_Task(void)
+{
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+
+    if (Black_Box_Dump_State == BLACK_BOX_DUMP_IDLE)
+    {
+        return;
+    }
+
+    // Wait for the last partial page
+    if (Black_Box_Dump_State == BLACK_BOX_DUMP_FLUSH)
+    {
+        if (Black_Box_Is_Busy())
+        {
+            return;
+        }
+        Black_Box_Dump_State = BLACK_BOX_DUMP_SEND;
+    }
+
+    while ((Black_Box_Dump_Page < BLACK_BOX_NUM_PAGES) && (EUSCI_A0_UART_TX_Free() >= TELEMETRY_MAX_ENCODED_LENGTH))
+    {
+        // Check a page once, before its first record is sent
+        if ((Black_Box_Dump_Record == 0) &&
+            ((Black_Box_Read_Page(Black_Box_Dump_Page, &Black_Box_Dump_Info, &Black_Box_Dump_Records) != 0) || (Black_Box_Dump_Info.Count == 0)))
+        {
+            Black_Box_Dump_Page++;
+            continue;
+        }
+
+        Telemetry_Send_Log(Black_Box_Dump_Info.Run, (Black_Box_Dump_Info.Page * BLACK_BOX_RECORDS_PER_PAGE) + Black_Box_Dump_Record,
+                           &Black_Box_Dump_Records[Black_Box_Dump_Record * BLACK_BOX_RECORD_SIZE]);
+        Black_Box_Dump_Count++;
+        Black_Box_Dump_Record++;
+
+        if (Black_Box_Dump_Record >= Black_Box_Dump_Info.Count)
+        {
+            Black_Box_Dump_Page++;
+            Black_Box_Dump_Record = 0;
+        }
+    }
+
+    if (Black_Box_Dump_Page >= BLACK_BOX_NUM_PAGES)
+    {
+        Print_Format_To_Buffer(line, sizeof(line), "ok blackbox dump %lu %lu", (unsigned long)Black_Box_Dump_Count, (unsigned long)Black_Box_Get_Dropped());
+        Black_Box_Dump_Output(line);
+        Black_Box_Dump_State = BLACK_BOX_DUMP_IDLE;
+    }
+}
+
+uint8_t Black_Box_Dump_Is_Active(void)
+{
+    return (Black_Box_Dump_State != BLACK_BOX_DUMP_IDLE);
+}
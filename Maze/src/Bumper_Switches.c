@@ -29,12 +29,42 @@
  */
 
 #include "../inc/Bumper_Switches.h"
+#include "../inc/Interrupt_Priority.h"
+#include "../inc/Motor_Inline.h"
+#include "../inc/Profiler.h"
+#include "../inc/Trace.h"
+
+// Time of the last edge of every switch, and the switches that have had an edge since the initialization
+static uint32_t Bumper_Last_Edge_Cycles[6];
+static uint8_t Bumper_Edge_Seen = 0;
+
+// Switches that stop the motors, and the latched cutoff
+static uint8_t Bumper_Cutoff_Switches = 0;
+static volatile uint8_t Bumper_Cutoff = 0;
+
+// P4 pins handled by another driver, and its handler
+static uint8_t Bumper_Port_Handler_Pins = 0;
+static void (*Bumper_Port_Handler)(uint8_t port_flags) = 0;
+
+// Event queue written by the PORT4 interrupt and read by Bumper_Get_Event
+static SPSC_Queue Bumper_Event_Queue;
+static Bumper_Event Bumper_Event_Buffer[BUMPER_EVENT_QUEUE_SIZE];
+
+// Convert the P4 bits (P4.7 - P4.5, P4.3, P4.2, and P4.0) to the 6-bit order of Bumper_Read
+static uint8_t Bumper_Port_To_Switches(uint32_t port_bits)
+{
+    return (((port_bits & 0xE0) >> 2) | ((port_bits & 0x0C) >> 1) | (port_bits & 0x01));
+}
 
 void Bumper_Switches_Init(void(*task)(uint8_t))
 {
     // Store the user-defined task function for use during interrupt handling
     Bumper_Task = task;
 
+    Bumper_Edge_Seen = 0;
+    Bumper_Cutoff = 0;
+    SPSC_Queue_Init(&Bumper_Event_Queue, Bumper_Event_Buffer, sizeof(Bumper_Event), BUMPER_EVENT_QUEUE_SIZE);
+
     // Configure the following pins as GPIO pins: P4.7, P4.6, P4.5, P4.3, P4.2, and P4.0
     // by clearing the corresponding bits in the SEL0 and SEL1 registers
     P4->SEL0 &= ~0xED;
@@ -65,8 +95,8 @@ void Bumper_Switches_Init(void(*task)(uint8_t))
     // by setting the corresponding bits in the IE register
     P4->IE |= 0xED;
 
-    // Set the priority level of the interrupts (IRQ 38) to 0 (section 2.4.3.20)
-    NVIC->IP[9] = (NVIC->IP[9] & 0xFF0FFFFF);
+    // Set the priority level of the interrupts (IRQ 38) in its 8-bit priority field (section 2.4.3.20)
+    NVIC->IP[38] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_PORT4);
 
     // Enable Interrupt 38 in NVIC (section 2.4.3.2)
     // Bit 6 corresponds to IRQ 38
@@ -85,7 +115,42 @@ uint8_t Bumper_Read(void)
     // - ((bumper_state & 0x0C) >> 1): Extract bits 3 and 2, and right-shift them by 1 to align them to bits 2 and 1.
     // - (bumper_state & 0x01): Extract bit 0.
     // Then, combine the extracted bits using the bitwise OR operator and return the bumper state
-    return (((bumper_state & 0xE0) >> 2) | ((bumper_state & 0x0C) >> 1) | (bumper_state & 0x01));
+    return Bumper_Port_To_Switches(bumper_state);
+}
+
+void Bumper_Set_Motor_Cutoff(uint8_t switches)
+{
+    Bumper_Cutoff_Switches = switches;
+}
+
+uint8_t Bumper_Get_Cutoff(void)
+{
+    return Bumper_Cutoff;
+}
+
+void Bumper_Clear_Cutoff(void)
+{
+    Bumper_Cutoff = 0;
+}
+
+int Bumper_Get_Event(Bumper_Event *event)
+{
+    return SPSC_Queue_Pop(&Bumper_Event_Queue, event);
+}
+
+uint32_t Bumper_Get_Dropped_Events(void)
+{
+    return SPSC_Queue_Get_Dropped(&Bumper_Event_Queue);
+}
+
+void Bumper_Set_Port_Handler(uint8_t pins, void (*handler)(uint8_t port_flags))
+{
+    long sr;
+
+    sr = StartCritical();
+    Bumper_Port_Handler = handler;
+    Bumper_Port_Handler_Pins = (handler != 0) ? pins : 0;
+    EndCritical(sr);
 }
 
 /**
@@ -93,18 +158,78 @@ uint8_t Bumper_Read(void)
  *
  * This function is an interrupt service routine (ISR) for PORT4 (P4) of the TI MSP432 LaunchPad.
  * It is triggered on a falling edge event on any of the switches connected to P4 (BUMP_0 to BUMP_5).
- * The function clears all interrupt flags for PORT4 and then executes the user-defined task function (Bump_Task)
- * by passing the current state of the switches, which is obtained by calling Bump_Read().
- *
- * @note This function does not handle critical section/race conditions.
+ * The function timestamps and debounces the edges, stops the motors if a cutoff switch has made a new contact,
+ * queues the collision event, and then executes the user-defined task function (Bumper_Task)
+ * by passing the current state of the switches, which is obtained by calling Bumper_Read().
  *
  * @return None
  */
 void PORT4_IRQHandler(void)
 {
-    // Clear the interrupt flags for P4.7 - P4.5, P4.3, P4.2, and P4.0
-    P4->IFG &= ~0xED;
+    uint32_t timestamp_cycles;
+    uint32_t port_flags;
+    uint32_t other_flags;
+    uint8_t edges;
+    uint8_t contacts;
+    uint8_t index;
+    Bumper_Event event;
+
+    PROFILER_START(PROFILER_PORT4);
+
+    timestamp_cycles = CycleCounter_Read();
+
+    // Hand the flags of the pins used by another driver to its handler
+    other_flags = P4->IFG & Bumper_Port_Handler_Pins;
+    if (other_flags != 0)
+    {
+        P4->IFG &= ~other_flags;
+        (*Bumper_Port_Handler)((uint8_t)other_flags);
+    }
+
+    // Clear only the interrupt flags that are handled, so that an edge during the handler is not lost
+    // Note: A flag is also set when the interrupt of the pin is disabled, so only the enabled pins are handled
+    port_flags = P4->IFG & P4->IE & 0xED & ~Bumper_Port_Handler_Pins;
+    P4->IFG &= ~port_flags;
+    edges = Bumper_Port_To_Switches(port_flags);
+
+    // An edge is a new contact if the switch has been quiet for the debounce time
+    contacts = 0;
+    for (index = 0; index < 6; index++)
+    {
+        if ((edges & (1 << index)) == 0)
+        {
+            continue;
+        }
+        if (((Bumper_Edge_Seen & (1 << index)) == 0) || ((timestamp_cycles - Bumper_Last_Edge_Cycles[index]) >= BUMPER_DEBOUNCE_CYCLES))
+        {
+            contacts |= (1 << index);
+        }
+        Bumper_Last_Edge_Cycles[index] = timestamp_cycles;
+        Bumper_Edge_Seen |= (1 << index);
+    }
+
+    if (contacts != 0)
+    {
+        // Stop the motors first to bound the latency of the emergency stop
+        if (contacts & Bumper_Cutoff_Switches)
+        {
+            Motor_Stop_Inline();
+            Bumper_Cutoff |= (contacts & Bumper_Cutoff_Switches);
+        }
+
+        // The event is dropped and counted if the queue is full
+        event.Timestamp_Cycles = timestamp_cycles;
+        event.Switches = contacts;
+        event.State = Bumper_Read();
+        SPSC_Queue_Push(&Bumper_Event_Queue, &event);
+        Trace_Record(TRACE_EVENT_BUMPER, contacts, event.State);
+
+        // Execute the user-defined task
+        if (Bumper_Task != 0)
+        {
+            (*Bumper_Task)(Bumper_Read());
+        }
+    }
 
-    // Execute the user-defined task
-    (*Bumper_Task)(Bumper_Read());
+    PROFILER_STOP(PROFILER_PORT4);
 }
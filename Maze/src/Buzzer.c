@@ -22,30 +22,124 @@ static int G4_NOTE = 1310; // G4 (392 Hz)
 static int A4_NOTE = 1165; // A4 (440 Hz)
 static int B4_NOTE = 1040; // B4 (493 Hz)
 
+// Tune being played, number of notes, index of the current note, and time left in the current note in ms
+// Note: Changed by the background with interrupts disabled, and by Buzzer_Task in the SysTick interrupt
+static const Buzzer_Note *Buzzer_Tune = 0;
+static uint8_t Buzzer_Tune_Length;
+static uint8_t Buzzer_Note_Index;
+static uint16_t Buzzer_Note_Remaining_ms;
+
+// Starts the note at Buzzer_Note_Index, or silences the buzzer for a rest
+static void Buzzer_Start_Note(void)
+{
+    const Buzzer_Note *note = &Buzzer_Tune[Buzzer_Note_Index];
+
+    Buzzer_Note_Remaining_ms = note->Duration_ms;
+
+    if (note->Frequency_Hz == BUZZER_REST)
+    {
+        Timer_A3_Compare_Stop();
+        Buzzer_Off();
+    }
+    else
+    {
+        // Toggle the pin twice per period of the note
+        Timer_A3_Compare_Start(&Buzzer_Toggle, BUZZER_TIMER_CLOCK_HZ / (2 * (uint32_t)note->Frequency_Hz));
+    }
+}
+
 void Buzzer_Init()
 {
     // Configure the following pin as an output GPIO pin: P1.6
     // by clearing Bit 6 in the SEL0 and SEL1 registers for P1
     // and setting Bit 6 in the DIR register for P1
-
-
-
+    P1->SEL0 &= ~0x40;
+    P1->SEL1 &= ~0x40;
+    P1->DIR |= 0x40;
 
     // Initialize the output of the Piezo Buzzer to zero
     // by clearing Bit 6 in the OUT register for P1
+    P1->OUT &= ~0x40;
 
+    Buzzer_Tune = 0;
 }
 
 void Buzzer_On()
 {
     // Turn on the buzzer by setting Bit 6 in the OUT register for P1
-
+    P1->OUT |= 0x40;
 }
 
 void Buzzer_Off()
 {
     // Turn off the buzzer by clearing Bit 6 in the OUT register for P1
+    P1->OUT &= ~0x40;
+}
+
+void Buzzer_Toggle()
+{
+    // Toggle Bit 6 in the OUT register for P1
+    P1->OUT ^= 0x40;
+}
+
+void Buzzer_Play_Tune(const Buzzer_Note *tune, uint8_t length)
+{
+    long sr;
+
+    if (length == 0)
+    {
+        Buzzer_Stop();
+        return;
+    }
 
+    sr = StartCritical();
+    Buzzer_Tune = tune;
+    Buzzer_Tune_Length = length;
+    Buzzer_Note_Index = 0;
+    Buzzer_Start_Note();
+    EndCritical(sr);
+}
+
+void Buzzer_Stop()
+{
+    long sr;
+
+    sr = StartCritical();
+    Buzzer_Tune = 0;
+    Timer_A3_Compare_Stop();
+    Buzzer_Off();
+    EndCritical(sr);
+}
+
+uint8_t Buzzer_Is_Playing()
+{
+    return (Buzzer_Tune != 0) ? 1 : 0;
+}
+
+void Buzzer_Task()
+{
+    if (Buzzer_Tune == 0)
+    {
+        return;
+    }
+
+    if (Buzzer_Note_Remaining_ms > BUZZER_TASK_PERIOD_MS)
+    {
+        Buzzer_Note_Remaining_ms = Buzzer_Note_Remaining_ms - BUZZER_TASK_PERIOD_MS;
+        return;
+    }
+
+    Buzzer_Note_Index = Buzzer_Note_Index + 1;
+    if (Buzzer_Note_Index >= Buzzer_Tune_Length)
+    {
+        Buzzer_Tune = 0;
+        Timer_A3_Compare_Stop();
+        Buzzer_Off();
+    }
+    else
+    {
+        Buzzer_Start_Note();
+    }
 }
 
 void Play_Note(int note_delay_value)
@@ -44,8 +44,15 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp.h"
 #include "../inc/Clock.h"
+#include "../inc/CortexM.h"
 
 uint32_t ClockFrequency = 3000000; // cycles/second
+
+// Profile selected by Clock_Set_Profile, and the time spent in each profile
+static Clock_Profile Clock_Current_Profile = CLOCK_PROFILE_RUN;
+static uint32_t Clock_Profile_Time_ms[CLOCK_NUM_PROFILES];
+static uint32_t Clock_Profile_Remainder_Cycles;
+static uint32_t Clock_Profile_Last_Cycles;
 //static uint32_t SubsystemFrequency = 3000000; // cycles/second
 
 // ------------Clock_InitFastest------------
@@ -127,6 +134,8 @@ void Clock_Init48MHz(void){
            0x00000005;                  // configure for MCLK sourced from HFXTCLK
   CS->KEY = 0;                          // lock CS module from unintended access
   ClockFrequency = 48000000;
+  Clock_Current_Profile = CLOCK_PROFILE_RUN;
+  Clock_Profile_Last_Cycles = 0;          // the CycleCounter starts from 0 when it is initialized
 //  SubsystemFrequency = 12000000;
 }
 
@@ -155,6 +164,7 @@ void delay(unsigned long ulCount){
 // Outputs: none
 void Clock_Delay1us(uint32_t n){
   n = (382*n)/100;; // 1 us, tuned at 48 MHz
+  n = n/(CLOCK_RUN_FREQUENCY_HZ/ClockFrequency); // fewer loops at the lower frequencies
   while(n){
     n--;
   }
@@ -170,3 +180,121 @@ void Clock_Delay1ms(uint32_t n){
     n--;
   }
 }
+
+// Returns the value of the WAIT field of the flash bank read control registers (Bits 12 to 15)
+// for a frequency of MCLK, in active mode LDO VCORE1
+static uint32_t Clock_Flash_Wait_States(uint32_t frequency)
+{
+    if (frequency <= 16000000)
+    {
+        return 0x00000000;
+    }
+    else if (frequency <= 32000000)
+    {
+        return 0x00001000;
+    }
+    return 0x00002000;
+}
+
+static void Clock_Set_Flash_Wait_States(uint32_t wait_states)
+{
+    FLCTL->BANK0_RDCTL = (FLCTL->BANK0_RDCTL & ~0x0000F000) | wait_states;
+    FLCTL->BANK1_RDCTL = (FLCTL->BANK1_RDCTL & ~0x0000F000) | wait_states;
+}
+
+// Adds the cycles elapsed since the last call to the time of the current profile
+// Note: Must be called with the interrupts disabled
+static void Clock_Account_Profile_Time(void)
+{
+    uint32_t now = CycleCounter_Read();
+    uint32_t cycles_per_ms = ClockFrequency / 1000;
+    uint32_t cycles = Clock_Profile_Remainder_Cycles + (now - Clock_Profile_Last_Cycles);
+
+    Clock_Profile_Time_ms[Clock_Current_Profile] += cycles / cycles_per_ms;
+    Clock_Profile_Remainder_Cycles = cycles % cycles_per_ms;
+    Clock_Profile_Last_Cycles = now;
+}
+
+void Clock_Set_Profile(Clock_Profile profile)
+{
+    uint32_t frequency;
+    uint32_t divider_select = 0;
+    uint32_t timeout = 0;
+    long sr;
+
+    if ((profile >= CLOCK_NUM_PROFILES) || (profile == Clock_Current_Profile))
+    {
+        return;
+    }
+
+    frequency = CLOCK_RUN_FREQUENCY_HZ;
+    if (profile == CLOCK_PROFILE_IDLE)
+    {
+        frequency = CLOCK_RUN_FREQUENCY_HZ / CLOCK_IDLE_MCLK_DIVIDER;
+        while ((1 << divider_select) < CLOCK_IDLE_MCLK_DIVIDER)
+        {
+            divider_select++;
+        }
+    }
+
+    sr = StartCritical();
+
+    // The remainder is dropped, its cycles are not at the new frequency
+    Clock_Account_Profile_Time();
+    Clock_Profile_Remainder_Cycles = 0;
+
+    // Add the wait states needed by the higher frequency before MCLK is sped up
+    if (frequency > ClockFrequency)
+    {
+        Clock_Set_Flash_Wait_States(Clock_Flash_Wait_States(frequency));
+    }
+
+    // Select the MCLK divider with the DIVM field of the CTL1 register (Bits 16 to 18)
+    CS->KEY = 0x695A;
+    CS->CTL1 = (CS->CTL1 & ~0x00070000) | (divider_select << 16);
+    CS->KEY = 0;
+
+    // Wait for MCLK_READY (Bit 25 of the STAT register)
+    while (((CS->STAT & 0x02000000) == 0) && (timeout < 100000))
+    {
+        timeout++;
+    }
+
+    // Remove the wait states that the lower frequency does not need
+    if (frequency < ClockFrequency)
+    {
+        Clock_Set_Flash_Wait_States(Clock_Flash_Wait_States(frequency));
+    }
+
+    // Keep the rate of the SysTick interrupt: the new period starts at the next reload
+    SysTick->LOAD = (uint32_t)((((uint64_t)SysTick->LOAD + 1) * frequency) / ClockFrequency) - 1;
+
+    ClockFrequency = frequency;
+    Clock_Current_Profile = profile;
+
+    EndCritical(sr);
+}
+
+Clock_Profile Clock_Get_Profile(void)
+{
+    return Clock_Current_Profile;
+}
+
+void Clock_Update_Profile_Time(void)
+{
+    long sr;
+
+    sr = StartCritical();
+    Clock_Account_Profile_Time();
+    EndCritical(sr);
+}
+
+uint32_t Clock_Get_Profile_Time_ms(Clock_Profile profile)
+{
+    if (profile >= CLOCK_NUM_PROFILES)
+    {
+        return 0;
+    }
+
+    return Clock_Profile_Time_ms[profile];
+}
@@ -0,0 +1,38 @@
+/**
+ * @file Clock_Report.c
+ * @brief Source code for the Clock_Report module.
+ *
+ * This file contains the function definitions for the Clock_Report module.
+ * It reports the clock profile, MCLK, and the time spent in each profile.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Clock_Report.h"
+#include "../inc/Print_Format.h"
+
+// Function that sends a reply line
+static void (*Clock_Report_Output)(const char *line);
+
+void Clock_Report_Init(void (*output)(const char *line))
+{
+    Clock_Report_Output = output;
+}
+
+int Clock_Report_Command(char **arguments, uint8_t argument_count)
+{
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+
+    if ((argument_count != 1) || (strcmp(arguments[0], "clock") != 0))
+    {
+        return -1;
+    }
+
+    Clock_Update_Profile_Time();
+    Print_Format_To_Buffer(line, sizeof(line), "clock profile=%u mclk=%lu run_ms=%lu idle_ms=%lu", (unsigned int)Clock_Get_Profile(),
+             (unsigned long)Clock_GetFreq(), (unsigned long)Clock_Get_Profile_Time_ms(CLOCK_PROFILE_RUN),
+             (unsigned long)Clock_Get_Profile_Time_ms(CLOCK_PROFILE_IDLE));
+    Clock_Report_Output(line);
+
+    return 0;
+}
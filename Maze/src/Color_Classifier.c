@@ -0,0 +1,155 @@
+/**
+ * @file Color_Classifier.c
+ * @brief Source code for the Color_Classifier driver.
+ *
+ * This file contains the function definitions for the Color_Classifier driver.
+ * It classifies the samples of the PMOD Color module by the nearest centroid in the chromaticity space.
+ *
+ */
+
+#include "../inc/Color_Classifier.h"
+
+// Counts of the ambient light removed from every raw sample
+static PMOD_Color_Data Color_Classifier_Ambient;
+
+// Returns the counts of a channel for the light intensity, with gain counts per 1000 lux
+static uint16_t Color_Classifier_Ambient_Counts(uint16_t gain, uint32_t centi_lux)
+{
+    uint64_t counts = ((uint64_t)gain * centi_lux) / 100000;
+
+    return (counts > 0xFFFF) ? 0xFFFF : (uint16_t)counts;
+}
+
+// Returns the channel without the ambient light, limited to zero
+static uint16_t Color_Classifier_Remove_Ambient(uint16_t value, uint16_t ambient)
+{
+    return (value > ambient) ? (value - ambient) : 0;
+}
+
+// Returns (value / clear) in Q10 using the reciprocal of the clear count, limited to COLOR_CLASSIFIER_CHROMA_MAX
+static uint16_t Color_Classifier_Chroma(uint16_t value, uint32_t reciprocal)
+{
+    // The reciprocal is 2^32 / clear, so (value * reciprocal) >> 22 is (value / clear) * 2^10
+    uint32_t chroma = (uint32_t)(((uint64_t)value * reciprocal) >> 22);
+
+    return (chroma > COLOR_CLASSIFIER_CHROMA_MAX) ? COLOR_CLASSIFIER_CHROMA_MAX : chroma;
+}
+
+void Color_Classifier_Set_Ambient(const Color_Classifier_Ambient_Gain *gain, uint32_t centi_lux)
+{
+    Color_Classifier_Ambient.red = Color_Classifier_Ambient_Counts(gain->Red, centi_lux);
+    Color_Classifier_Ambient.green = Color_Classifier_Ambient_Counts(gain->Green, centi_lux);
+    Color_Classifier_Ambient.blue = Color_Classifier_Ambient_Counts(gain->Blue, centi_lux);
+    Color_Classifier_Ambient.clear = Color_Classifier_Ambient_Counts(gain->Clear, centi_lux);
+}
+
+PMOD_Color_Data Color_Classifier_Get_Ambient(void)
+{
+    return Color_Classifier_Ambient;
+}
+
+// Returns the sample without the counts of the ambient light
+static PMOD_Color_Data Color_Classifier_Compensate(PMOD_Color_Data sample)
+{
+    sample.red = Color_Classifier_Remove_Ambient(sample.red, Color_Classifier_Ambient.red);
+    sample.green = Color_Classifier_Remove_Ambient(sample.green, Color_Classifier_Ambient.green);
+    sample.blue = Color_Classifier_Remove_Ambient(sample.blue, Color_Classifier_Ambient.blue);
+    sample.clear = Color_Classifier_Remove_Ambient(sample.clear, Color_Classifier_Ambient.clear);
+
+    return sample;
+}
+
+// Computes the chromaticity of a compensated sample
+static void Color_Classifier_Chromaticity(PMOD_Color_Data sample, Color_Classifier_Centroid *chromaticity)
+{
+    uint32_t reciprocal;
+
+    if (sample.clear == 0)
+    {
+        chromaticity->Red = 0;
+        chromaticity->Green = 0;
+        chromaticity->Blue = 0;
+        return;
+    }
+
+    reciprocal = 0xFFFFFFFFUL / sample.clear;
+
+    chromaticity->Red = Color_Classifier_Chroma(sample.red, reciprocal);
+    chromaticity->Green = Color_Classifier_Chroma(sample.green, reciprocal);
+    chromaticity->Blue = Color_Classifier_Chroma(sample.blue, reciprocal);
+}
+
+void Color_Classifier_Get_Chromaticity(PMOD_Color_Data sample, Color_Classifier_Centroid *chromaticity)
+{
+    Color_Classifier_Chromaticity(Color_Classifier_Compensate(sample), chromaticity);
+}
+
+Color_Classifier_Result Color_Classifier_Classify(const Color_Classifier_Palette *palette, PMOD_Color_Data sample)
+{
+    Color_Classifier_Result result;
+    Color_Classifier_Centroid chromaticity;
+    const Color_Classifier_Centroid *centroid;
+    uint32_t nearest_distance = 0xFFFFFFFF;
+    uint32_t second_distance;
+    uint32_t distance;
+    int32_t delta;
+    uint8_t index;
+
+    result.ID = COLOR_CLASSIFIER_UNKNOWN;
+    result.Confidence = 0;
+
+    sample = Color_Classifier_Compensate(sample);
+    if (sample.clear < palette->Min_Clear)
+    {
+        return result;
+    }
+
+    Color_Classifier_Chromaticity(sample, &chromaticity);
+
+    // A centroid further than the maximum distance does not reduce the confidence
+    second_distance = (palette->Max_Distance < COLOR_CLASSIFIER_DISTANCE_LIMIT) ? palette->Max_Distance : COLOR_CLASSIFIER_DISTANCE_LIMIT;
+
+    for (index = 0; index < palette->Num_Colors; index++)
+    {
+        centroid = &palette->Centroids[index];
+
+        delta = (int32_t)chromaticity.Red - centroid->Red;
+        distance = delta * delta;
+        delta = (int32_t)chromaticity.Green - centroid->Green;
+        distance = distance + (delta * delta);
+        delta = (int32_t)chromaticity.Blue - centroid->Blue;
+        distance = distance + (delta * delta);
+
+        if (distance < nearest_distance)
+        {
+            if (nearest_distance < second_distance)
+            {
+                second_distance = nearest_distance;
+            }
+            nearest_distance = distance;
+            result.ID = index;
+        }
+        else if (distance < second_distance)
+        {
+            second_distance = distance;
+        }
+    }
+
+    if (nearest_distance > palette->Max_Distance)
+    {
+        result.ID = COLOR_CLASSIFIER_UNKNOWN;
+        return result;
+    }
+
+    // 255 * (d2 - d1) / d2, with d1 <= d2 <= COLOR_CLASSIFIER_DISTANCE_LIMIT so that the product fits in 32 bits
+    if (second_distance == 0)
+    {
+        result.Confidence = 0;
+    }
+    else
+    {
+        result.Confidence = ((second_distance - nearest_distance) * 255) / second_distance;
+    }
+
+    return result;
+}
@@ -0,0 +1,593 @@
+/**
+ * @file Controller.c
+ * @brief Source code for the Controller module.
+ *
+ * This file contains the function definitions for the maze controllers.
+ * It does not access the hardware directly, so it is also compiled by the host simulator.
+ *
+ */
+
+#include "../inc/Controller.h"
+#include "../inc/Print_Format.h"
+#include "../inc/Analog_Distance_Sensors.h"
+#include "../inc/Trace.h"
+#include "../inc/Traction.h"
+
+// Declare global variables used to store converted distance values from the Analog Distance Sensor
+int32_t Converted_Distance_Left;
+int32_t Converted_Distance_Center;
+int32_t Converted_Distance_Right;
+
+// Centering error of the wall-centering controller (in mm, positive when the robot is closer to the right wall),
+// and error of the previous control tick used by the derivative term
+int32_t Error;
+int32_t Previous_Error;
+
+// Walls used by the previous control tick, the derivative term restarts when they change
+static uint8_t Wall_Centering_Walls;
+
+// Odometry distance of the center of the cell to which the wall follower drives, or of its current cell (in um)
+static int32_t Follow_Center_Distance_um;
+
+// Odometry heading of the grid direction followed by the wall follower
+static uint32_t Follow_Heading;
+
+// Set while the wall follower drives to the center of the next cell with Wall_Centering_Drive
+static uint8_t Follow_Centering;
+
+// Open sides of the last Junction event read by the wall follower
+static uint8_t Follow_Openings;
+
+// Distance measured by a side sensor when the robot is in the center of a corridor (in mm)
+int32_t Set_Point = WALL_CENTERING_SET_POINT;
+
+// Runtime values of the tuning parameters, initialized from the defaults of Controller.h
+// Note: They are not reset by Controller_Init, so a value changed over the UART is kept between the routes
+int32_t Desired_Distance = DESIRED_DISTANCE;
+int32_t Forward_Speed = FORWARD_SPEED;
+int32_t Pivot_Duty_Cycle = PIVOT_DUTY_CYCLE;
+int32_t Kp_Scale = WALL_CENTERING_GAIN_SCALE;
+int32_t Kd_Scale = WALL_CENTERING_KD_SCALE;
+
+// Gains of the wall-centering controller, scheduled by the measured speed of the robot (sorted by speed)
+// The robot turns faster for the same wheel speed difference as it drives faster, so the gains decrease with the speed
+static const Wall_Centering_Gains Wall_Centering_Gain_Table[] =
+{
+    // Speed (mm/s), Kp (Q8), Kd (Q8)
+    {   0,  768, 2048 },
+    { 200,  512, 2560 },
+    { 300,  384, 2816 },
+    { 450,  256, 3072 },
+};
+
+#define WALL_CENTERING_NUM_GAINS    (sizeof(Wall_Centering_Gain_Table) / sizeof(Wall_Centering_Gain_Table[0]))
+
+// Declare global variables used to update PWM duty cycle values for the motors
+uint16_t Duty_Cycle_Left;
+uint16_t Duty_Cycle_Right;
+
+// Cell and heading of the robot in the maze map, and set to 1 when a goal cell is reached
+uint8_t Maze_X = 0;
+uint8_t Maze_Y = 0;
+Maze_Direction Maze_Heading = MAZE_NORTH;
+uint8_t Maze_Replanning = 0;
+uint8_t Maze_Goal_Reached = 0;
+
+// Number of slip segments of the Traction module when the drive to the current cell started
+static uint32_t Maze_Drive_Slip_Segments = 0;
+
+// Odometry heading of the north direction of the maze map, the heading of the robot in the start cell
+static uint32_t Maze_North_Heading = 0;
+
+void Controller_Init()
+{
+    Converted_Distance_Left = ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE;
+    Converted_Distance_Center = ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE;
+    Converted_Distance_Right = ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE;
+
+    Error = 0;
+    Previous_Error = 0;
+    Wall_Centering_Walls = 0;
+    Follow_Wall_Restart();
+
+    Duty_Cycle_Left  = PWM_NOMINAL;
+    Duty_Cycle_Right = PWM_NOMINAL;
+}
+
+/**
+ * @brief This function queues a 90 degree turn to the right.
+ *
+ * The turn is executed by the Motion driver, one step per SysTick interrupt, and completes when the
+ * odometry heading has turned by the angle, or when it has not advanced for TURN_TIMEOUT_TICKS.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Turn_Right() {
+    Motion_Turn(-TURN_ANGLE, TURN_DUTY_CYCLE, TURN_TIMEOUT_TICKS);
+}
+
+/**
+ * @brief This function queues a 90 degree turn to the left.
+ *
+ * The turn is executed by the Motion driver, one step per SysTick interrupt, and completes when the
+ * odometry heading has turned by the angle, or when it has not advanced for TURN_TIMEOUT_TICKS.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Turn_Left() {
+    Motion_Turn(TURN_ANGLE, TURN_DUTY_CYCLE, TURN_TIMEOUT_TICKS);
+}
+/**
+ * @brief This function interpolates the gains of the wall-centering controller for a speed.
+ *
+ * @param speed The speed of the robot in mm/s.
+ *
+ * @param gains Pointer to store the gains.
+ *
+ * @return None
+ */
+static void Wall_Centering_Get_Gains(int32_t speed, Wall_Centering_Gains *gains)
+{
+    const Wall_Centering_Gains *low;
+    const Wall_Centering_Gains *high;
+    int32_t span;
+    uint32_t i;
+
+    if (speed < 0)
+    {
+        speed = -speed;
+    }
+
+    if (speed >= Wall_Centering_Gain_Table[WALL_CENTERING_NUM_GAINS - 1].Speed)
+    {
+        *gains = Wall_Centering_Gain_Table[WALL_CENTERING_NUM_GAINS - 1];
+        return;
+    }
+
+    for (i = 1; (i < WALL_CENTERING_NUM_GAINS - 1) && (speed >= Wall_Centering_Gain_Table[i].Speed); i++)
+    {
+    }
+
+    low = &Wall_Centering_Gain_Table[i - 1];
+    high = &Wall_Centering_Gain_Table[i];
+    span = high->Speed - low->Speed;
+
+    gains->Speed = speed;
+    gains->Kp = low->Kp + (((high->Kp - low->Kp) * (speed - low->Speed)) / span);
+    gains->Kd = low->Kd + (((high->Kd - low->Kd) * (speed - low->Speed)) / span);
+}
+
+/**
+ * @brief This function drives along the corridor at a speed and keeps the robot in its center.
+ *
+ * The centering error is the difference between the left and the right distances when both walls are seen.
+ * With a single wall, it is twice the difference between the distance to that wall and Set_Point, which is
+ * the same error for a corridor of the usual width. The proportional-derivative correction is added to the
+ * right wheel and subtracted from the left wheel, and the gains are scheduled by the measured speed.
+ *
+ * @param speed The speed of the robot in mm/s.
+ *
+ * @return None
+ */
+void Wall_Centering_Drive(int16_t speed)
+{
+    Wall_Centering_Gains gains;
+    int16_t left_speed;
+    int16_t right_speed;
+    int32_t correction;
+    uint8_t walls = 0;
+
+    if (Converted_Distance_Left <= Desired_Distance)
+    {
+        walls |= WALL_CENTERING_LEFT_WALL;
+    }
+    if (Converted_Distance_Right <= Desired_Distance)
+    {
+        walls |= WALL_CENTERING_RIGHT_WALL;
+    }
+
+    if (walls == (WALL_CENTERING_LEFT_WALL | WALL_CENTERING_RIGHT_WALL))
+    {
+        Error = Converted_Distance_Left - Converted_Distance_Right;
+    }
+    else if (walls == WALL_CENTERING_RIGHT_WALL)
+    {
+        Error = 2 * (Set_Point - Converted_Distance_Right);
+    }
+    else if (walls == WALL_CENTERING_LEFT_WALL)
+    {
+        Error = 2 * (Converted_Distance_Left - Set_Point);
+    }
+    else
+    {
+        Error = 0;
+    }
+
+    // The error jumps when a wall appears or disappears, so the derivative term restarts from the new error
+    if (walls != Wall_Centering_Walls)
+    {
+        Previous_Error = Error;
+        Wall_Centering_Walls = walls;
+    }
+
+    Speed_Controller_Get_Speed(&left_speed, &right_speed);
+    Wall_Centering_Get_Gains((left_speed + right_speed) / 2, &gains);
+
+    gains.Kp = (gains.Kp * Kp_Scale) / WALL_CENTERING_GAIN_SCALE;
+    gains.Kd = (gains.Kd * Kd_Scale) / WALL_CENTERING_GAIN_SCALE;
+    correction = ((gains.Kp * Error) + (gains.Kd * (Error - Previous_Error))) / 256;
+    Previous_Error = Error;
+
+    if (correction > WALL_CENTERING_MAX_CORRECTION)
+    {
+        correction = WALL_CENTERING_MAX_CORRECTION;
+    }
+    else if (correction < -WALL_CENTERING_MAX_CORRECTION)
+    {
+        correction = -WALL_CENTERING_MAX_CORRECTION;
+    }
+
+    Speed_Controller_Set_Speed(speed - correction, speed + correction);
+}
+
+void Follow_Wall_Restart()
+{
+    // The sides classified before the robot has been placed in the start cell are not valid any more
+    Junction_Init();
+    Follow_Center_Distance_um = Odometry_Get_Distance_um();
+    Follow_Heading = Odometry_Get_Heading();
+    Follow_Centering = 0;
+    Follow_Openings = 0;
+    Maze_Goal_Reached = 0;
+}
+
+/**
+ * @brief This function returns the turn from the odometry heading to a heading of the grid.
+ *
+ * @param heading The odometry heading at the end of the turn.
+ *
+ * @return The angle of the turn rounded to degrees. Positive values turn left and negative values turn right.
+ */
+static int16_t Heading_Turn_Angle(uint32_t heading)
+{
+    int32_t heading_error = (int32_t)(heading - Odometry_Get_Heading());
+
+    return (int16_t)(((int64_t)heading_error + ((heading_error >= 0) ? (ODOMETRY_HEADING_ONE_DEGREE / 2) : -(ODOMETRY_HEADING_ONE_DEGREE / 2))) /
+                     ODOMETRY_HEADING_ONE_DEGREE);
+}
+
+/**
+ * @brief This function queues a drive of the wall follower to the center of the next cell.
+ *
+ * The robot first turns to the heading of the grid, so the errors of the turns and of the centering
+ * do not add up. The drive is longer than a cell, Follow_Wall aborts it in the center of the next cell.
+ *
+ * @param None
+ *
+ * @return None
+ */
+static void Follow_Wall_Drive()
+{
+    int16_t turn_angle = Heading_Turn_Angle(Follow_Heading);
+
+    if(turn_angle != 0){
+        Motion_Turn(turn_angle, Pivot_Duty_Cycle, TURN_TIMEOUT_TICKS);
+    }
+    Motion_Drive(2 * MAZE_CELL_SIZE, MAZE_DRIVE_DUTY_CYCLE, MAZE_DRIVE_TIMEOUT_TICKS);
+    Follow_Center_Distance_um = Odometry_Get_Distance_um() + ((int32_t)MAZE_CELL_SIZE * 1000);
+}
+
+/**
+ * @brief This function locates the center of the next cell from the walls seen during a straight drive.
+ *
+ * The Junction events carry the odometry distance at which a side was first seen to change. A side wall starts
+ * or ends at the border of a cell, and the wall ahead closes the front at Desired_Distance from the center sensor,
+ * so both give the distance of the center of the next cell, and the errors of the odometry distance and of the
+ * previous turns do not add up from cell to cell.
+ *
+ * @param None
+ *
+ * @return None
+ */
+static void Follow_Wall_Locate()
+{
+    Junction_Event event;
+    uint8_t changed;
+    int32_t center_um;
+    int32_t error_um;
+
+    while(Junction_Get_Event(&event)){
+        changed = event.Openings ^ Follow_Openings;
+        Follow_Openings = event.Openings;
+
+        // Only a straight drive moves the sensors along the walls, and a change seen during the previous turn
+        // is still near the center of the previous cell
+        if(((Follow_Centering == 0) && (Motion_Get_Active_Type() != MOTION_COMMAND_DRIVE)) ||
+           (event.Distance_um < (Follow_Center_Distance_um - (((int32_t)MAZE_CELL_SIZE * 3 / 4) * 1000)))){
+            continue;
+        }
+
+        if(changed & (JUNCTION_OPEN_LEFT | JUNCTION_OPEN_RIGHT)){
+            center_um = event.Distance_um + ((FOLLOW_SIDE_SENSOR_OFFSET + (MAZE_CELL_SIZE / 2)) * 1000);
+        }else if((changed & JUNCTION_OPEN_FRONT) && ((event.Openings & JUNCTION_OPEN_FRONT) == 0)){
+            center_um = event.Distance_um + ((Desired_Distance + FOLLOW_CENTER_SENSOR_OFFSET - (MAZE_CELL_SIZE / 2)) * 1000);
+        }else{
+            continue;
+        }
+
+        // A wall of a cell farther away is not the border of the next cell
+        error_um = center_um - Follow_Center_Distance_um;
+        if((error_um > -(((int32_t)MAZE_CELL_SIZE / 2) * 1000)) && (error_um < (((int32_t)MAZE_CELL_SIZE / 2) * 1000))){
+            Follow_Center_Distance_um = center_um;
+        }
+    }
+}
+
+/**
+ * @brief This function queues a quarter turn of the wall follower in the center of a cell.
+ *
+ * After a turn towards an opening, the robot also drives into the next cell, so it does not see the corridor
+ * it comes from as a new opening. Otherwise it stands still for FOLLOW_SETTLE_TICKS, for the Junction classifier.
+ *
+ * @param left  1 to turn left, or 0 to turn right.
+ *
+ * @param enter 1 to drive into the next cell after the turn, or 0 to stay in the center of the cell.
+ *
+ * @return None
+ */
+static void Follow_Wall_Turn(uint8_t left, uint8_t enter)
+{
+    Follow_Heading = left ? (Follow_Heading + ODOMETRY_HEADING_90) : (Follow_Heading - ODOMETRY_HEADING_90);
+
+    if(enter){
+        Follow_Wall_Drive();
+    }else{
+        Motion_Turn(Heading_Turn_Angle(Follow_Heading), Pivot_Duty_Cycle, TURN_TIMEOUT_TICKS);
+        Motion_Stop(FOLLOW_SETTLE_TICKS);
+    }
+}
+
+/**
+ * @brief This function follows a wall until the robot reaches a dead end or the goal.
+ *
+ * The robot takes its decisions in the center of the cells, which it locates with Follow_Wall_Locate. In a corridor,
+ * it drives to the next cell with Wall_Centering_Drive. Otherwise it drives ahead, turns towards the opening
+ * of the followed wall and drives into the next cell, or turns away from the followed wall, with the Motion driver.
+ *
+ * @param wall The followed wall: WALL_CENTERING_RIGHT_WALL or WALL_CENTERING_LEFT_WALL.
+ *
+ * @return 1 if the robot has stopped at the dead end or in the goal cell, or 0 otherwise.
+ */
+static uint8_t Follow_Wall(uint8_t wall)
+{
+    uint8_t openings = Junction_Get_Openings();
+    uint8_t wall_open;
+    uint8_t done = 0;
+
+    // The maze-goal barcode has stopped the motors in the goal cell, which ends the route
+    if(Maze_Goal_Reached){
+        Motion_Abort();
+        if(Speed_Controller_Is_Enabled()){
+            Speed_Controller_Disable();
+        }
+        Motor_Stop();
+        return 1;
+    }
+
+    Follow_Wall_Locate();
+
+    // Let a turn finish, and stop a drive in the center of the next cell, or when it gets too close to a wall
+    if(Motion_Is_Busy()){
+        if((Motion_Get_Active_Type() != MOTION_COMMAND_DRIVE) ||
+           ((Odometry_Get_Distance_um() < Follow_Center_Distance_um) && (Converted_Distance_Center >= MAZE_COLLISION_DISTANCE))){
+            return 0;
+        }
+        Motion_Abort();
+    }else if(Follow_Centering && (Odometry_Get_Distance_um() < Follow_Center_Distance_um)){
+        Wall_Centering_Drive(Forward_Speed);
+        return 0;
+    }
+    Follow_Centering = 0;
+
+    // Set when the wheels are driven by the Speed_Controller during this tick
+    uint8_t closed_loop = 0;
+
+    // The sides are debounced by the Junction classifier, so a noisy distance near Desired_Distance does not switch the branch
+    wall_open = openings & ((wall == WALL_CENTERING_RIGHT_WALL) ? JUNCTION_OPEN_RIGHT : JUNCTION_OPEN_LEFT);
+
+    if(Junction_Get_Type() == JUNCTION_DEAD_END){
+        Motor_Stop();
+        done = 1;
+    }else if(wall_open){
+        // Turn into the opening of the followed wall
+        Follow_Wall_Turn((wall == WALL_CENTERING_LEFT_WALL), 1);
+    }else if(Junction_Get_Type() == JUNCTION_CORRIDOR){
+        Wall_Centering_Drive(Forward_Speed);
+        Follow_Centering = 1;
+        Follow_Center_Distance_um = Odometry_Get_Distance_um() + ((int32_t)MAZE_CELL_SIZE * 1000);
+        closed_loop = 1;
+    }else if(openings & JUNCTION_OPEN_FRONT){
+        // Only the followed wall guides the robot, so it drives on the heading of the grid
+        Follow_Wall_Drive();
+    }else{
+        // Turn away from the followed wall, the only opening is on the other side
+        Follow_Wall_Turn((wall == WALL_CENTERING_RIGHT_WALL), 0);
+    }
+
+    // Release the motors for the open-loop commands of the other cases
+    if((closed_loop == 0) && Speed_Controller_Is_Enabled()){
+        Speed_Controller_Disable();
+    }
+    if(closed_loop == 0){
+        Wall_Centering_Walls = 0;
+    }
+
+    return done;
+}
+
+uint8_t Follow_Right_Wall()
+{
+    return Follow_Wall(WALL_CENTERING_RIGHT_WALL);
+}
+
+uint8_t Follow_Left_Wall()
+{
+    return Follow_Wall(WALL_CENTERING_LEFT_WALL);
+}
+
+/**
+ * @brief This function clears the maze map and selects the four center cells as the goal.
+ *
+ * The robot starts in cell (0, 0) facing north.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Maze_Exploration_Init()
+{
+    Maze_Map_Init();
+    Maze_Map_Clear_Goals();
+    Maze_Map_Add_Goal((MAZE_MAP_WIDTH / 2) - 1, (MAZE_MAP_HEIGHT / 2) - 1);
+    Maze_Map_Add_Goal(MAZE_MAP_WIDTH / 2, (MAZE_MAP_HEIGHT / 2) - 1);
+    Maze_Map_Add_Goal((MAZE_MAP_WIDTH / 2) - 1, MAZE_MAP_HEIGHT / 2);
+    Maze_Map_Add_Goal(MAZE_MAP_WIDTH / 2, MAZE_MAP_HEIGHT / 2);
+
+    Maze_X = 0;
+    Maze_Y = 0;
+    Maze_Heading = MAZE_NORTH;
+    Maze_Goal_Reached = 0;
+    Maze_Replanning = 0;
+    Maze_Drive_Slip_Segments = Traction_Get_Segment_Count();
+    Maze_North_Heading = Odometry_Get_Heading();
+
+    // Compute the initial distances, every later wall observation only repairs the affected cells
+    Maze_Map_Flood_Fill();
+}
+
+/**
+ * @brief This function explores the maze and moves towards the goal on the shortest known path.
+ *
+ * In the center of every cell, the three distance sensors are used to record the walls of the cell
+ * in the maze map. Only the distances affected by a new wall are repaired, with at most
+ * MAZE_REPLAN_CELLS_PER_TICK cells per control tick, so a large repair is spread over several ticks.
+ * The robot then turns towards the open neighbor that is closest to the goal and drives one cell, using the Motion driver.
+ * Unknown walls are assumed to be open, so the path gets longer only when a wall is discovered.
+ *
+ * The turn ends on the odometry heading of the direction of the neighbor, measured from the heading in the start cell,
+ * so the heading errors of the previous turns and of the open-loop drives do not accumulate from cell to cell.
+ *
+ * A wheel that slips counts steps that the robot has not driven, so the robot may stop short of the center of the cell.
+ * When the Traction module has started a slip segment during the drive to a cell, its walls are still recorded,
+ * but the cell is not marked as visited, so the map keeps its walls open to a new observation.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Controller_2()
+{
+    Maze_Direction next_direction;
+    int16_t turn_angle;
+
+    if(Maze_Goal_Reached){
+        return;
+    }
+
+    // Wait for the robot to reach the center of the next cell
+    if(Motion_Is_Busy()){
+        if((Motion_Get_Active_Type() == MOTION_COMMAND_DRIVE) && (Converted_Distance_Center < MAZE_COLLISION_DISTANCE)){
+            Motion_Abort();
+        }else{
+            return;
+        }
+    }
+
+    // Record the walls seen from the center of the current cell once per cell
+    if(Maze_Replanning == 0){
+        Maze_Map_Update_Wall(Maze_X, Maze_Y, Maze_Heading, (Converted_Distance_Center < MAZE_WALL_DISTANCE));
+        Maze_Map_Update_Wall(Maze_X, Maze_Y, MAZE_DIRECTION_RIGHT(Maze_Heading), (Converted_Distance_Right < MAZE_WALL_DISTANCE));
+        Maze_Map_Update_Wall(Maze_X, Maze_Y, MAZE_DIRECTION_LEFT(Maze_Heading), (Converted_Distance_Left < MAZE_WALL_DISTANCE));
+        if((Traction_Get_Segment_Count() == Maze_Drive_Slip_Segments) && (Traction_Is_Limiting() == 0)){
+            Maze_Map_Set_Visited(Maze_X, Maze_Y);
+        }
+
+        Trace_Record(TRACE_EVENT_MAZE_CELL, Maze_X | (Maze_Y << 8) | ((uint32_t)Maze_Heading << 16), Maze_Map_Is_Goal(Maze_X, Maze_Y));
+
+        if(Maze_Map_Is_Goal(Maze_X, Maze_Y)){
+            Motor_Stop();
+            Maze_Goal_Reached = 1;
+            return;
+        }
+
+        Maze_Replanning = 1;
+    }
+
+    // Continue the repair in the next control tick if it does not fit in this one
+    if(Maze_Map_Replan_Step(MAZE_REPLAN_CELLS_PER_TICK) == 0){
+        return;
+    }
+    Maze_Replanning = 0;
+
+    // Stop if the known walls enclose the robot
+    if(Maze_Map_Best_Direction(Maze_X, Maze_Y, Maze_Heading, &next_direction) != 0){
+        Motor_Stop();
+        return;
+    }
+
+    // The directions are clockwise and the odometry heading counterclockwise
+    turn_angle = Heading_Turn_Angle(Maze_North_Heading - ((uint32_t)next_direction * ODOMETRY_HEADING_90));
+    if(turn_angle != 0){
+        Motion_Turn(turn_angle, TURN_DUTY_CYCLE, TURN_TIMEOUT_TICKS);
+    }
+    Motion_Drive(MAZE_CELL_SIZE, MAZE_DRIVE_DUTY_CYCLE, MAZE_DRIVE_TIMEOUT_TICKS);
+    Maze_Drive_Slip_Segments = Traction_Get_Segment_Count();
+
+    Maze_Heading = next_direction;
+    Maze_Map_Neighbor(&Maze_X, &Maze_Y, next_direction);
+}
+
+void Maze_Exploration_Restart()
+{
+    // The walls explored by the previous trials are kept, so the robot drives the shortest known path
+    Maze_X = 0;
+    Maze_Y = 0;
+    Maze_Heading = MAZE_NORTH;
+    Maze_Goal_Reached = 0;
+    Maze_Replanning = 0;
+    Maze_Drive_Slip_Segments = Traction_Get_Segment_Count();
+    Maze_North_Heading = Odometry_Get_Heading();
+    Maze_Map_Flood_Fill();
+}
+
+uint8_t Maze_Exploration_Step()
+{
+    Controller_2();
+
+    return Maze_Goal_Reached;
+}
+
+void Maze_Bumper_Collision()
+{
+    if(Maze_Goal_Reached){
+        return;
+    }
+
+    if(Motion_Is_Busy() && (Motion_Get_Active_Type() == MOTION_COMMAND_DRIVE)){
+        Motion_Abort();
+        Maze_Map_Update_Wall(Maze_X, Maze_Y, Maze_Heading, 1);
+    }
+}
+
+void Maze_Exploration_Import(const uint8_t *map)
+{
+    Maze_Map_Import(map);
+
+    // The walls of the current cell are recorded again by the next call of Controller_2
+    Maze_Replanning = 0;
+    Maze_Map_Flood_Fill();
+}
@@ -36,6 +36,7 @@ those of the authors and should not be interpreted as representing official
 policies, either expressed or implied, of the FreeBSD Project.
  */
 #include <stdint.h>
+#include "msp.h"
 #include "../inc/CortexM.h"
 
 
@@ -60,7 +61,7 @@ void EnableInterrupts(void){
 // make a copy of previous I bit, disable interrupts
 // inputs:  none
 // outputs: previous I bit
-void StartCritical(void){
+long StartCritical(void){
   __asm  ("    MRS    R0, PRIMASK   ; save old status \n"
           "    CPSID  I             ; mask all (except faults)\n"
           "    BX     LR\n");
@@ -83,3 +84,30 @@ void WaitForInterrupt(void){
   __asm  ("    WFI\n"
           "    BX     LR\n");
 }
+
+//*********** CycleCounter_Init ************************
+// enable the DWT cycle counter, which counts MCLK cycles
+// inputs:  none
+// outputs: none
+void CycleCounter_Init(void){
+  CoreDebug->DEMCR |= 0x01000000;  // TRCENA: enable the DWT unit
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= 0x00000001;         // CYCCNTENA: start the cycle counter
+}
+
+//*********** CycleCounter_Read ************************
+// read the DWT cycle counter
+// inputs:  none
+// outputs: number of MCLK cycles since CycleCounter_Init
+uint32_t CycleCounter_Read(void){
+  return DWT->CYCCNT;
+}
+
+//*********** CycleCounter_Wait ************************
+// wait until a number of MCLK cycles have elapsed since a cycle counter value
+// inputs:  start_cycles value returned by CycleCounter_Read
+//          cycles       number of MCLK cycles to wait from start_cycles
+// outputs: none
+void CycleCounter_Wait(uint32_t start_cycles, uint32_t cycles){
+  while((CycleCounter_Read() - start_cycles) < cycles){};
+}
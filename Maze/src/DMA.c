@@ -0,0 +1,171 @@
+/**
+ * @file DMA.c
+ * @brief Source code for the DMA driver.
+ *
+ * This file contains the function definitions for the DMA driver.
+ * It owns the channel control table of the MSP432 uDMA controller and provides
+ * helper functions that allow other drivers to configure channels, map trigger
+ * sources, and route channel completion interrupts to DMA_INT1, DMA_INT2, or DMA_INT3.
+ *
+ */
+
+#include "../inc/DMA.h"
+#include "../inc/Interrupt_Priority.h"
+#include "../inc/Profiler.h"
+
+// Channel control table containing the primary (0 to 7) and alternate (8 to 15) control structures
+// Note: The CTLBASE register ignores the lower 8 bits, so the table must be aligned to 256 bytes
+#pragma DATA_ALIGN(DMA_Control_Table, 256)
+static DMA_Control_Structure DMA_Control_Table[2 * DMA_NUM_CHANNELS];
+
+// Pointers to the user-defined functions executed by DMA_INT1, DMA_INT2, and DMA_INT3
+static void (*DMA_INT1_Task)(void);
+static void (*DMA_INT2_Task)(void);
+static void (*DMA_INT3_Task)(void);
+
+void DMA_Init(void)
+{
+    // Skip the initialization if the controller has already been enabled
+    // MASTEN is reported in Bit 0 of the STAT register
+    if (DMA_Control->STAT & 0x00000001)
+    {
+        return;
+    }
+
+    // Load the CTLBASE register with the address of the control table
+    DMA_Control->CTLBASE = (uint32_t)DMA_Control_Table;
+
+    // Set the MASTEN bit (Bit 0) of the CFG register to enable the controller
+    DMA_Control->CFG = 0x00000001;
+}
+
+DMA_Control_Structure *DMA_Get_Primary_Control(uint8_t channel)
+{
+    return &DMA_Control_Table[channel];
+}
+
+DMA_Control_Structure *DMA_Get_Alternate_Control(uint8_t channel)
+{
+    return &DMA_Control_Table[DMA_NUM_CHANNELS + channel];
+}
+
+void DMA_Assign_Channel(uint8_t channel, uint8_t source)
+{
+    uint32_t channel_mask = (1 << channel);
+
+    // Disable the channel before changing its configuration
+    DMA_Control->ENACLR = channel_mask;
+
+    // Select the trigger source of the channel
+    DMA_Channel->CH_SRCCFG[channel] = source;
+
+    // Use the primary control structure, default priority, single and burst requests,
+    // and allow the peripheral to request transfers
+    DMA_Control->ALTCLR = channel_mask;
+    DMA_Control->PRIOCLR = channel_mask;
+    DMA_Control->USEBURSTCLR = channel_mask;
+    DMA_Control->REQMASKCLR = channel_mask;
+}
+
+void DMA_Enable_Channel(uint8_t channel)
+{
+    DMA_Control->ENASET = (1 << channel);
+}
+
+void DMA_Disable_Channel(uint8_t channel)
+{
+    DMA_Control->ENACLR = (1 << channel);
+}
+
+void DMA_Assign_Interrupt(uint8_t interrupt, uint8_t channel, void(*task)(void))
+{
+    //     INTx_SRCCFG Register Configuration
+    //
+    //     Bit(s)         Field             Value       Description
+    //     -----        ----------          ------      -------------
+    //     31-6         Reserved            0           Reserved
+    //      5           EN                  1b          Enable the interrupt
+    //     4-0          INT_SRC             channel     Channel routed to the interrupt
+    switch (interrupt)
+    {
+        case 1:
+        {
+            DMA_INT1_Task = task;
+            DMA_Channel->INT1_SRCCFG = 0x00000020 | channel;
+
+            // Set the interrupt priority level (DMA_INT1 has an IRQ number of 33)
+            NVIC->IP[33] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_DMA_INT1);
+
+            // Enable Interrupt 33 in NVIC by setting Bit 1 of the ISER[1] register
+            NVIC->ISER[1] = 0x00000002;
+        }
+        break;
+
+        case 2:
+        {
+            DMA_INT2_Task = task;
+            DMA_Channel->INT2_SRCCFG = 0x00000020 | channel;
+
+            // Set the interrupt priority level (DMA_INT2 has an IRQ number of 32)
+            NVIC->IP[32] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_DMA_INT2);
+
+            // Enable Interrupt 32 in NVIC by setting Bit 0 of the ISER[1] register
+            NVIC->ISER[1] = 0x00000001;
+        }
+        break;
+
+        case 3:
+        {
+            DMA_INT3_Task = task;
+            DMA_Channel->INT3_SRCCFG = 0x00000020 | channel;
+
+            // Set the interrupt priority level (DMA_INT3 has an IRQ number of 31)
+            NVIC->IP[31] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_DMA_INT3);
+
+            // Enable Interrupt 31 in NVIC by setting Bit 31 of the ISER[0] register
+            NVIC->ISER[0] = 0x80000000;
+        }
+        break;
+
+        default:
+        {
+            // Only DMA_INT1, DMA_INT2, and DMA_INT3 can be assigned to a single channel
+        }
+        break;
+    }
+}
+
+void DMA_INT1_IRQHandler(void)
+{
+    PROFILER_START(PROFILER_DMA_INT1);
+
+    // Execute the user-defined task, if one has been assigned
+    if (DMA_INT1_Task != 0)
+    {
+        (*DMA_INT1_Task)();
+    }
+
+    PROFILER_STOP(PROFILER_DMA_INT1);
+}
+
+void DMA_INT2_IRQHandler(void)
+{
+    PROFILER_START(PROFILER_DMA_INT2);
+
+    // Execute the user-defined task, if one has been assigned
+    if (DMA_INT2_Task != 0)
+    {
+        (*DMA_INT2_Task)();
+    }
+
+    PROFILER_STOP(PROFILER_DMA_INT2);
+}
+
+void DMA_INT3_IRQHandler(void)
+{
+    // Execute the user-defined task, if one has been assigned
+    if (DMA_INT3_Task != 0)
+    {
+        (*DMA_INT3_Task)();
+    }
+}
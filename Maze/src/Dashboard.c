@@ -0,0 +1,113 @@
+/**
+ * @file Dashboard.c
+ * @brief Source code for the Dashboard module.
+ *
+ * This file contains the function definitions for the Dashboard module.
+ * It draws fixed-width unsigned decimal fields in the RAM buffer of the Nokia5110 LCD driver.
+ *
+ */
+
+#include "../inc/Dashboard.h"
+
+// Indices of the glyphs that are not digits
+#define DASHBOARD_GLYPH_SPACE       10
+#define DASHBOARD_GLYPH_OVERFLOW    11
+#define DASHBOARD_NUM_GLYPHS        12
+
+// Index stored in Drawn for a character that is not known to be on the screen
+#define DASHBOARD_GLYPH_UNKNOWN     0xFF
+
+// Columns of the digits 0 to 9, the space, and the '*' character
+static uint8_t Dashboard_Glyphs[DASHBOARD_NUM_GLYPHS][NOKIA5110_GLYPH_WIDTH];
+
+// Returns n / 10 without a divide: 0xCCCCCCCD / 2^35 is 1/10 rounded up, which gives the exact quotient of every 32-bit value
+static uint32_t Dashboard_Divide_By_10(uint32_t n)
+{
+    return (uint32_t)(((uint64_t)n * 0xCCCCCCCDULL) >> 35);
+}
+
+void Dashboard_Init(void)
+{
+    int i;
+
+    for (i = 0; i < 10; i++)
+    {
+        Nokia5110_Get_Glyph('0' + i, Dashboard_Glyphs[i]);
+    }
+    Nokia5110_Get_Glyph(' ', Dashboard_Glyphs[DASHBOARD_GLYPH_SPACE]);
+    Nokia5110_Get_Glyph('*', Dashboard_Glyphs[DASHBOARD_GLYPH_OVERFLOW]);
+}
+
+void Dashboard_Field_Init(Dashboard_Field *field, uint8_t x, uint8_t y, uint8_t width, uint8_t flags)
+{
+    if (width > DASHBOARD_MAX_DIGITS)
+    {
+        width = DASHBOARD_MAX_DIGITS;
+    }
+
+    field->X = x;
+    field->Y = y;
+    field->Width = width;
+    field->Flags = flags;
+    Dashboard_Field_Invalidate(field);
+}
+
+void Dashboard_Field_Set(Dashboard_Field *field, uint32_t value)
+{
+    uint8_t glyphs[DASHBOARD_MAX_DIGITS];
+    uint32_t remaining = value;
+    uint32_t quotient;
+    int i;
+
+    if ((field->Valid != 0) && (field->Value == value))
+    {
+        return;
+    }
+
+    // Convert the digits from the right, with spaces in place of the leading zeros unless the field is zero-padded
+    for (i = field->Width - 1; i >= 0; i--)
+    {
+        if ((remaining == 0) && (i < (field->Width - 1)) && ((field->Flags & DASHBOARD_FIELD_ZERO_PAD) == 0))
+        {
+            glyphs[i] = DASHBOARD_GLYPH_SPACE;
+        }
+        else
+        {
+            quotient = Dashboard_Divide_By_10(remaining);
+            glyphs[i] = remaining - (quotient * 10);
+            remaining = quotient;
+        }
+    }
+
+    // The value does not fit in the width of the field
+    if (remaining != 0)
+    {
+        for (i = 0; i < field->Width; i++)
+        {
+            glyphs[i] = DASHBOARD_GLYPH_OVERFLOW;
+        }
+    }
+
+    for (i = 0; i < field->Width; i++)
+    {
+        if (glyphs[i] != field->Drawn[i])
+        {
+            Nokia5110_Buffer_Draw_Glyph(field->X + i, field->Y, Dashboard_Glyphs[glyphs[i]]);
+            field->Drawn[i] = glyphs[i];
+        }
+    }
+
+    field->Value = value;
+    field->Valid = 1;
+}
+
+void Dashboard_Field_Invalidate(Dashboard_Field *field)
+{
+    int i;
+
+    field->Valid = 0;
+    for (i = 0; i < DASHBOARD_MAX_DIGITS; i++)
+    {
+        field->Drawn[i] = DASHBOARD_GLYPH_UNKNOWN;
+    }
+}
@@ -0,0 +1,153 @@
+/**
+ * @file Distance_Fusion.c
+ * @brief Source code for the Distance_Fusion driver.
+ *
+ * This file contains the function definitions for the Distance_Fusion driver.
+ * It combines the Sharp sensors, the OPT3101, and the odometry into one distance estimate per side.
+ *
+ */
+
+#include "../inc/Distance_Fusion.h"
+
+// Number of fractional bits of the stored distances
+#define DISTANCE_FUSION_SHIFT   4
+
+// Estimate and variance of every side
+static int32_t Distance_Fusion_Distance[DISTANCE_FUSION_NUM_SIDES];
+static uint32_t Distance_Fusion_Variance[DISTANCE_FUSION_NUM_SIDES];
+
+// OPT3101 sample counts used by the last update
+static uint32_t Distance_Fusion_OPT3101_Count[DISTANCE_FUSION_NUM_SIDES];
+
+// Pose at the last update
+static Odometry_Pose Distance_Fusion_Last_Pose;
+
+static uint32_t Distance_Fusion_Limit_Variance(uint32_t variance)
+{
+    return (variance > DISTANCE_FUSION_MAX_VARIANCE) ? DISTANCE_FUSION_MAX_VARIANCE : variance;
+}
+
+static void Distance_Fusion_Measure(Distance_Fusion_Side side, int32_t distance_mm, uint32_t variance)
+{
+    uint32_t gain;
+    int32_t error;
+
+    // Kalman gain in Q16: P / (P + R)
+    gain = (Distance_Fusion_Variance[side] << 16) / (Distance_Fusion_Variance[side] + variance);
+
+    error = (distance_mm << DISTANCE_FUSION_SHIFT) - Distance_Fusion_Distance[side];
+    Distance_Fusion_Distance[side] = Distance_Fusion_Distance[side] + (int32_t)(((int64_t)error * gain) >> 16);
+    Distance_Fusion_Variance[side] = (Distance_Fusion_Variance[side] * (65536 - gain)) >> 16;
+
+    if (Distance_Fusion_Variance[side] == 0)
+    {
+        Distance_Fusion_Variance[side] = 1;
+    }
+}
+
+static void Distance_Fusion_Predict()
+{
+    Odometry_Pose pose;
+    int32_t forward_um;
+    int32_t travel_mm;
+    int32_t turn_degrees;
+    uint32_t process_variance;
+    uint8_t side;
+
+    Odometry_Get_Pose(&pose);
+
+    // Displacement projected on the heading of the last update
+    forward_um = (int32_t)((((int64_t)(pose.X_um - Distance_Fusion_Last_Pose.X_um) * Odometry_Cos(Distance_Fusion_Last_Pose.Heading))
+                           + ((int64_t)(pose.Y_um - Distance_Fusion_Last_Pose.Y_um) * Odometry_Sin(Distance_Fusion_Last_Pose.Heading))) >> 15);
+    turn_degrees = Odometry_Angle_To_Degrees(pose.Heading - Distance_Fusion_Last_Pose.Heading);
+    Distance_Fusion_Last_Pose = pose;
+
+    travel_mm = forward_um / 1000;
+    if (travel_mm < 0)
+    {
+        travel_mm = -travel_mm;
+    }
+    if (turn_degrees < 0)
+    {
+        turn_degrees = -turn_degrees;
+    }
+
+    // Driving forward brings the wall in front of the robot closer
+    Distance_Fusion_Distance[DISTANCE_FUSION_CENTER] = Distance_Fusion_Distance[DISTANCE_FUSION_CENTER]
+                                                       - ((forward_um << DISTANCE_FUSION_SHIFT) / 1000);
+
+    process_variance = DISTANCE_FUSION_PROCESS_VARIANCE + (travel_mm * DISTANCE_FUSION_DISTANCE_VARIANCE)
+                       + (turn_degrees * DISTANCE_FUSION_HEADING_VARIANCE);
+
+    for (side = 0; side < DISTANCE_FUSION_NUM_SIDES; side++)
+    {
+        Distance_Fusion_Variance[side] = Distance_Fusion_Limit_Variance(Distance_Fusion_Variance[side] + process_variance);
+    }
+}
+
+void Distance_Fusion_Init()
+{
+    uint8_t side;
+
+    for (side = 0; side < DISTANCE_FUSION_NUM_SIDES; side++)
+    {
+        Distance_Fusion_Distance[side] = DISTANCE_FUSION_MAX_DISTANCE << DISTANCE_FUSION_SHIFT;
+        Distance_Fusion_Variance[side] = DISTANCE_FUSION_MAX_VARIANCE;
+        Distance_Fusion_OPT3101_Count[side] = OPT3101_Get_Sample_Count(side);
+    }
+
+    Odometry_Get_Pose(&Distance_Fusion_Last_Pose);
+}
+
+void Distance_Fusion_Update(const int32_t sharp[DISTANCE_FUSION_NUM_SIDES])
+{
+    OPT3101_Sample sample;
+    uint32_t count;
+    uint32_t sigma;
+    uint32_t variance;
+    uint8_t side;
+
+    Distance_Fusion_Predict();
+
+    for (side = 0; side < DISTANCE_FUSION_NUM_SIDES; side++)
+    {
+        // A saturated Sharp sensor reports the out of range distance, which is not used
+        if ((sharp[side] > 0) && (sharp[side] < ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE))
+        {
+            sigma = DISTANCE_FUSION_SHARP_SIGMA + (sharp[side] / DISTANCE_FUSION_SHARP_SIGMA_DIVIDER);
+            Distance_Fusion_Measure((Distance_Fusion_Side)side, sharp[side], Distance_Fusion_Limit_Variance(sigma * sigma));
+        }
+
+        // Use the latest OPT3101 sample of the channel if it has been received since the last update
+        count = OPT3101_Get_Sample_Count(side);
+        if ((count != Distance_Fusion_OPT3101_Count[side]) && (OPT3101_Get_Sample(side, 0, &sample) == 0)
+            && (sample.Distance < OPT3101_DISTANCE_UNDERFLOW) && (sample.Amplitude > 0))
+        {
+            variance = (DISTANCE_FUSION_OPT3101_VARIANCE * DISTANCE_FUSION_OPT3101_AMPLITUDE) / sample.Amplitude;
+            Distance_Fusion_Measure((Distance_Fusion_Side)side,
+                                    (sample.Distance > DISTANCE_FUSION_MAX_DISTANCE) ? DISTANCE_FUSION_MAX_DISTANCE : sample.Distance,
+                                    Distance_Fusion_Limit_Variance(variance));
+        }
+        Distance_Fusion_OPT3101_Count[side] = count;
+
+        // Keep the estimate in the range of the sensors
+        if (Distance_Fusion_Distance[side] < 0)
+        {
+            Distance_Fusion_Distance[side] = 0;
+        }
+        else if (Distance_Fusion_Distance[side] > (DISTANCE_FUSION_MAX_DISTANCE << DISTANCE_FUSION_SHIFT))
+        {
+            Distance_Fusion_Distance[side] = DISTANCE_FUSION_MAX_DISTANCE << DISTANCE_FUSION_SHIFT;
+        }
+    }
+}
+
+void Distance_Fusion_Get(Distance_Fusion_Side side, Distance_Fusion_Estimate *estimate)
+{
+    uint32_t confidence;
+
+    estimate->Distance_mm = (Distance_Fusion_Distance[side] + (1 << (DISTANCE_FUSION_SHIFT - 1))) >> DISTANCE_FUSION_SHIFT;
+
+    confidence = (256 * DISTANCE_FUSION_CONFIDENCE_VARIANCE) / (DISTANCE_FUSION_CONFIDENCE_VARIANCE + Distance_Fusion_Variance[side]);
+    estimate->Confidence = (confidence > 255) ? 255 : confidence;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file Distance_Source.c
+ * @brief Source code for the Distance_Source driver.
+ *
+ * This file contains the function definitions for the Distance_Source driver.
+ * It provides the left, center, and right distances from the Analog Distance Sensors, the OPT3101,
+ * or the fusion of both.
+ *
+ */
+
+#include "../inc/Distance_Source.h"
+
+static Distance_Source_Type Distance_Source_Selected = DISTANCE_SOURCE_SHARP;
+
+// Latest distances of the Sharp sensors, or last valid distances of the OPT3101 channels
+// Index order: left, center, right
+static int32_t Distance_Source_Values[3];
+static uint8_t Distance_Source_Confidence[3];
+
+// Latest converted distances of the Sharp sensors, used by the fusion
+// Index order: left, center, right
+static int32_t Distance_Source_Sharp[3];
+
+// Latest set of converted distances published by the filter interrupt, so the control tick always reads three
+// distances of the same sample without disabling the interrupts, and the time of their conversion
+static Snapshot Distance_Source_Sharp_Snapshot;
+static uint8_t Distance_Source_Sharp_Buffer[SNAPSHOT_BUFFER_SIZE(sizeof(Distance_Source_Sharp))];
+static uint32_t Distance_Source_Sharp_Timestamp;
+static uint32_t Distance_Source_Sharp_Sequence;
+
+void Distance_Source_Init(Distance_Source_Type type)
+{
+    Distance_Source_Selected = type;
+    Distance_Source_Values[0] = DISTANCE_SOURCE_NO_TARGET;
+    Distance_Source_Values[1] = DISTANCE_SOURCE_NO_TARGET;
+    Distance_Source_Values[2] = DISTANCE_SOURCE_NO_TARGET;
+    Distance_Source_Sharp[0] = DISTANCE_SOURCE_NO_TARGET;
+    Distance_Source_Sharp[1] = DISTANCE_SOURCE_NO_TARGET;
+    Distance_Source_Sharp[2] = DISTANCE_SOURCE_NO_TARGET;
+    Distance_Source_Confidence[0] = 0;
+    Distance_Source_Confidence[1] = 0;
+    Distance_Source_Confidence[2] = 0;
+    Snapshot_Init(&Distance_Source_Sharp_Snapshot, Distance_Source_Sharp_Buffer, sizeof(Distance_Source_Sharp), Distance_Source_Sharp);
+    Distance_Source_Sharp_Timestamp = 0;
+    Distance_Source_Sharp_Sequence = 0;
+
+    if (type == DISTANCE_SOURCE_FUSION)
+    {
+        Distance_Fusion_Init();
+    }
+}
+
+Distance_Source_Type Distance_Source_Get_Type()
+{
+    return Distance_Source_Selected;
+}
+
+void Distance_Source_Update_Sharp(const int32_t converted[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS])
+{
+    int32_t sample[3];
+
+    if (Distance_Source_Selected == DISTANCE_SOURCE_OPT3101)
+    {
+        return;
+    }
+
+    sample[0] = converted[2];
+    sample[1] = converted[1];
+    sample[2] = converted[0];
+    Snapshot_Write(&Distance_Source_Sharp_Snapshot, sample, CycleCounter_Read());
+}
+
+static void Distance_Source_Update_OPT3101(uint32_t channel, int32_t *value)
+{
+    OPT3101_Sample sample;
+
+    if (OPT3101_Get_Sample(channel, 0, &sample) != 0)
+    {
+        return;
+    }
+
+    if (sample.Distance == OPT3101_DISTANCE_LOW_AMPLITUDE)
+    {
+        *value = DISTANCE_SOURCE_NO_TARGET;
+    }
+    else if (sample.Distance < OPT3101_DISTANCE_UNDERFLOW)
+    {
+        *value = (sample.Distance > DISTANCE_SOURCE_NO_TARGET) ? DISTANCE_SOURCE_NO_TARGET : sample.Distance;
+    }
+}
+
+static void Distance_Source_Update_Fusion()
+{
+    Distance_Fusion_Estimate estimate;
+    uint8_t side;
+
+    Distance_Source_Sharp_Sequence = Snapshot_Read(&Distance_Source_Sharp_Snapshot, Distance_Source_Sharp, &Distance_Source_Sharp_Timestamp);
+
+    Distance_Fusion_Update(Distance_Source_Sharp);
+
+    for (side = 0; side < DISTANCE_FUSION_NUM_SIDES; side++)
+    {
+        Distance_Fusion_Get((Distance_Fusion_Side)side, &estimate);
+        Distance_Source_Values[side] = estimate.Distance_mm;
+        Distance_Source_Confidence[side] = estimate.Confidence;
+    }
+}
+
+void Distance_Source_Get(int32_t *left, int32_t *center, int32_t *right)
+{
+    uint8_t side;
+
+    if (Distance_Source_Selected == DISTANCE_SOURCE_FUSION)
+    {
+        Distance_Source_Update_Fusion();
+    }
+    else
+    {
+        if (Distance_Source_Selected == DISTANCE_SOURCE_OPT3101)
+        {
+            Distance_Source_Update_OPT3101(DISTANCE_SOURCE_OPT3101_LEFT, &Distance_Source_Values[0]);
+            Distance_Source_Update_OPT3101(DISTANCE_SOURCE_OPT3101_CENTER, &Distance_Source_Values[1]);
+            Distance_Source_Update_OPT3101(DISTANCE_SOURCE_OPT3101_RIGHT, &Distance_Source_Values[2]);
+        }
+        else
+        {
+            Distance_Source_Sharp_Sequence = Snapshot_Read(&Distance_Source_Sharp_Snapshot, Distance_Source_Sharp, &Distance_Source_Sharp_Timestamp);
+            Distance_Source_Values[0] = Distance_Source_Sharp[0];
+            Distance_Source_Values[1] = Distance_Source_Sharp[1];
+            Distance_Source_Values[2] = Distance_Source_Sharp[2];
+        }
+
+        for (side = 0; side < 3; side++)
+        {
+            Distance_Source_Confidence[side] = (Distance_Source_Values[side] >= DISTANCE_SOURCE_NO_TARGET) ? 0 : 255;
+        }
+    }
+
+    *left = Distance_Source_Values[0];
+    *center = Distance_Source_Values[1];
+    *right = Distance_Source_Values[2];
+}
+
+void Distance_Source_Get_Confidence(uint8_t *left, uint8_t *center, uint8_t *right)
+{
+    *left = Distance_Source_Confidence[0];
+    *center = Distance_Source_Confidence[1];
+    *right = Distance_Source_Confidence[2];
+}
+
+uint32_t Distance_Source_Get_Sharp_Timestamp(uint32_t *timestamp_cycles)
+{
+    *timestamp_cycles = Distance_Source_Sharp_Timestamp;
+
+    return Distance_Source_Sharp_Sequence;
+}
@@ -14,6 +14,22 @@
  */
 
 #include "../inc/EUSCI_A0_UART.h"
+#include "../inc/Interrupt_Priority.h"
+
+// TX ring buffer drained by the EUSCI_A0 interrupt
+static uint8_t EUSCI_A0_UART_TX_Buffer[EUSCI_A0_UART_TX_BUFFER_SIZE];
+static volatile uint32_t EUSCI_A0_UART_TX_Head;
+static volatile uint32_t EUSCI_A0_UART_TX_Tail;
+
+// Overflow policy and number of bytes dropped because the ring buffer was full
+static uint8_t EUSCI_A0_UART_Overflow_Policy = EUSCI_A0_UART_OVERFLOW_DROP;
+static volatile uint32_t EUSCI_A0_UART_Dropped_Bytes;
+
+// RX ring buffer filled by the EUSCI_A0 interrupt when the RX interrupt is enabled
+static uint8_t EUSCI_A0_UART_RX_Buffer[EUSCI_A0_UART_RX_BUFFER_SIZE];
+static volatile uint32_t EUSCI_A0_UART_RX_Head;
+static volatile uint32_t EUSCI_A0_UART_RX_Tail;
+static volatile uint32_t EUSCI_A0_UART_RX_Overruns;
 
 void EUSCI_A0_UART_Init()
 {
@@ -68,11 +84,22 @@ void EUSCI_A0_UART_Init()
     // - Start Bit Interrupt (UCSTTIE, Bit 2)
     EUSCI_A0->IE &= ~0x0C;
 
-    // Enable the following interrupts by setting the
+    // Disable the following interrupts by clearing the
     // corresponding bits in the IE register
-    // - Transmit Interrupt (UCTXIE, Bit 1)
-    // - Receive Interrupt (UCRXIE, Bit 0)
-    EUSCI_A0->IE |= 0x03;
+    // - Transmit Interrupt (UCTXIE, Bit 1): Enabled only while the TX ring buffer contains data
+    // - Receive Interrupt (UCRXIE, Bit 0): Enabled by EUSCI_A0_UART_Enable_RX_Interrupt, polled otherwise
+    EUSCI_A0->IE &= ~0x03;
+
+    // Empty the TX ring buffer
+    EUSCI_A0_UART_TX_Head = 0;
+    EUSCI_A0_UART_TX_Tail = 0;
+    EUSCI_A0_UART_Dropped_Bytes = 0;
+
+    // Set the interrupt priority level (EUSCI_A0 has an IRQ number of 16)
+    NVIC->IP[16] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_EUSCI_A0);
+
+    // Enable Interrupt 16 in NVIC by setting Bit 16 of the ISER[0] register
+    NVIC->ISER[0] = 0x00010000;
 
     // Release the EUSCI_A0 module from the reset state by clearing the
     // UCSWRST bit (Bit 0) in the CTLW0 register
@@ -81,6 +108,15 @@ void EUSCI_A0_UART_Init()
 
 char EUSCI_A0_UART_InChar()
 {
+    uint8_t data;
+
+    // Wait for the RX ring buffer if the Receive Interrupt (UCRXIE, Bit 0) reads the Receive Buffer
+    if (EUSCI_A0->IE & 0x01)
+    {
+        while (EUSCI_A0_UART_Read_Byte(&data) == 0);
+        return (char)data;
+    }
+
     // Check the Receive Interrupt flag (UCRXIFG, Bit 0)
     // in the IFG register and wait if the flag is not set
     // If the UCRXIFG is set, then the Receive Buffer (UCAxRXBUF) has
@@ -94,14 +130,9 @@ char EUSCI_A0_UART_InChar()
 
 void EUSCI_A0_UART_OutChar(char letter)
 {
-    // Check the Transmit Interrupt flag (UCTXIFG, Bit 1)
-    // in the IFG register and wait if the flag is not set
-    // If the UCTXIFG is set, then the Transmit Buffer (UCAxTXBUF) is empty
-    while((EUSCI_A0->IFG & 0x02) == 0);
-
-    // Write the data to the Transmit Buffer (UCAxTXBUF)
-    // Writing to the UCAxTXBUF will clear the UCTXIFG flag
-    EUSCI_A0->TXBUF = letter;
+    // Queue the data in the TX ring buffer
+    // The EUSCI_A0 TX interrupt writes it to the Transmit Buffer (UCAxTXBUF)
+    EUSCI_A0_UART_Queue_Byte((uint8_t)letter);
 }
 
 void EUSCI_A0_UART_InString(char *bufPt, uint16_t max)
@@ -350,3 +381,150 @@ void EUSCI_A0_UART_Init_Printf()
     // Turn off buffering for stdout
     setvbuf(stdout, NULL, _IONBF, 0);
 }
+
+int EUSCI_A0_UART_Queue_Byte(uint8_t data)
+{
+    long sr;
+
+    sr = StartCritical();
+
+    if ((EUSCI_A0_UART_TX_Head - EUSCI_A0_UART_TX_Tail) >= EUSCI_A0_UART_TX_BUFFER_SIZE)
+    {
+        if (EUSCI_A0_UART_Overflow_Policy == EUSCI_A0_UART_OVERFLOW_DROP)
+        {
+            EUSCI_A0_UART_Dropped_Bytes = EUSCI_A0_UART_Dropped_Bytes + 1;
+            EndCritical(sr);
+            return -1;
+        }
+
+        // Make room by transmitting the oldest byte directly
+        // Check the Transmit Interrupt flag (UCTXIFG, Bit 1) and wait if the flag is not set
+        while((EUSCI_A0->IFG & 0x02) == 0);
+        EUSCI_A0->TXBUF = EUSCI_A0_UART_TX_Buffer[EUSCI_A0_UART_TX_Tail & (EUSCI_A0_UART_TX_BUFFER_SIZE - 1)];
+        EUSCI_A0_UART_TX_Tail = EUSCI_A0_UART_TX_Tail + 1;
+    }
+
+    EUSCI_A0_UART_TX_Buffer[EUSCI_A0_UART_TX_Head & (EUSCI_A0_UART_TX_BUFFER_SIZE - 1)] = data;
+    EUSCI_A0_UART_TX_Head = EUSCI_A0_UART_TX_Head + 1;
+
+    // Enable the Transmit Interrupt (UCTXIE, Bit 1)
+    // Note: UCTXIFG is set whenever the Transmit Buffer is empty, so the interrupt fires immediately if idle
+    EUSCI_A0->IE |= 0x02;
+
+    EndCritical(sr);
+
+    return 0;
+}
+
+uint32_t EUSCI_A0_UART_Queue_Bytes(const uint8_t *data, uint32_t length)
+{
+    uint32_t queued = 0;
+
+    while (length)
+    {
+        if (EUSCI_A0_UART_Queue_Byte(*data) == 0)
+        {
+            queued++;
+        }
+        data++;
+        length--;
+    }
+
+    return queued;
+}
+
+void EUSCI_A0_UART_Set_Overflow_Policy(uint8_t policy)
+{
+    EUSCI_A0_UART_Overflow_Policy = policy;
+}
+
+uint32_t EUSCI_A0_UART_Get_Dropped_Bytes()
+{
+    return EUSCI_A0_UART_Dropped_Bytes;
+}
+
+uint32_t EUSCI_A0_UART_TX_Free()
+{
+    return EUSCI_A0_UART_TX_BUFFER_SIZE - (EUSCI_A0_UART_TX_Head - EUSCI_A0_UART_TX_Tail);
+}
+
+void EUSCI_A0_UART_Flush()
+{
+    while(EUSCI_A0_UART_TX_Head != EUSCI_A0_UART_TX_Tail);
+}
+
+void EUSCI_A0_UART_Enable_RX_Interrupt()
+{
+    uint32_t sr;
+
+    sr = StartCritical();
+
+    EUSCI_A0_UART_RX_Head = 0;
+    EUSCI_A0_UART_RX_Tail = 0;
+    EUSCI_A0_UART_RX_Overruns = 0;
+
+    // Enable the Receive Interrupt (UCRXIE, Bit 0)
+    EUSCI_A0->IE |= 0x01;
+
+    EndCritical(sr);
+}
+
+int EUSCI_A0_UART_Read_Byte(uint8_t *data)
+{
+    if (EUSCI_A0_UART_RX_Tail == EUSCI_A0_UART_RX_Head)
+    {
+        return 0;
+    }
+
+    // Only the reader updates the tail, and the interrupt only updates the head
+    *data = EUSCI_A0_UART_RX_Buffer[EUSCI_A0_UART_RX_Tail & (EUSCI_A0_UART_RX_BUFFER_SIZE - 1)];
+    EUSCI_A0_UART_RX_Tail = EUSCI_A0_UART_RX_Tail + 1;
+
+    return 1;
+}
+
+uint32_t EUSCI_A0_UART_Get_RX_Overruns()
+{
+    return EUSCI_A0_UART_RX_Overruns;
+}
+
+void EUSCI_A0_IRQHandler(void)
+{
+    uint8_t data;
+
+    // Check the Receive Interrupt flag (UCRXIFG, Bit 0)
+    // If the UCRXIFG is set, then the Receive Buffer (UCAxRXBUF) has received a complete character
+    if ((EUSCI_A0->IFG & 0x01) && (EUSCI_A0->IE & 0x01))
+    {
+        // Reading the UCAxRXBUF will clear the UCRXIFG flag
+        data = (uint8_t)EUSCI_A0->RXBUF;
+
+        if ((EUSCI_A0_UART_RX_Head - EUSCI_A0_UART_RX_Tail) < EUSCI_A0_UART_RX_BUFFER_SIZE)
+        {
+            EUSCI_A0_UART_RX_Buffer[EUSCI_A0_UART_RX_Head & (EUSCI_A0_UART_RX_BUFFER_SIZE - 1)] = data;
+            EUSCI_A0_UART_RX_Head = EUSCI_A0_UART_RX_Head + 1;
+        }
+        else
+        {
+            EUSCI_A0_UART_RX_Overruns = EUSCI_A0_UART_RX_Overruns + 1;
+        }
+    }
+
+    // Check the Transmit Interrupt flag (UCTXIFG, Bit 1)
+    // If the UCTXIFG is set, then the Transmit Buffer (UCAxTXBUF) is empty
+    if ((EUSCI_A0->IFG & 0x02) && (EUSCI_A0->IE & 0x02))
+    {
+        if (EUSCI_A0_UART_TX_Tail != EUSCI_A0_UART_TX_Head)
+        {
+            // Write the next queued byte to the Transmit Buffer (UCAxTXBUF)
+            // Writing to the UCAxTXBUF will clear the UCTXIFG flag
+            EUSCI_A0->TXBUF = EUSCI_A0_UART_TX_Buffer[EUSCI_A0_UART_TX_Tail & (EUSCI_A0_UART_TX_BUFFER_SIZE - 1)];
+            EUSCI_A0_UART_TX_Tail = EUSCI_A0_UART_TX_Tail + 1;
+        }
+        else
+        {
+            // Disable the Transmit Interrupt (UCTXIE, Bit 1) when the ring buffer is empty
+            EUSCI_A0->IE &= ~0x02;
+        }
+    }
+}
@@ -3,7 +3,9 @@
  * @brief Source code for the EUSCI_B1_I2C driver.
  *
  * This file contains the function definitions for the EUSCI_B1_I2C driver.
- * The EUSCI_B1_I2C driver uses busy-wait implementation.
+ * The EUSCI_B1_I2C driver provides a busy-wait implementation and an interrupt-driven
+ * transaction queue, with a per-device SCL frequency, two priorities, stuck-bus recovery, and
+ * per-device statistics.
  *
  * @note This function assumes that the necessary pin configurations for I2C communication have been performed
  *       on the corresponding pins. The output from the pins will be observed using an oscilloscope.
@@ -18,6 +20,177 @@
  */
 
 #include "../inc/EUSCI_B1_I2C.h"
+#include "../inc/Clock.h"
+#include "../inc/Interrupt_Priority.h"
+#include "../inc/Profiler.h"
+
+// BRW value of an SCL frequency, rounded up so that the SCL frequency is never above the requested one
+#define EUSCI_B1_I2C_BRW(scl_frequency_hz)  ((EUSCI_B1_I2C_CLOCK_HZ + (scl_frequency_hz) - 1) / (scl_frequency_hz))
+
+// Half period of SCL while the bus is recovered in us (100 kHz, supported by every slave)
+#define EUSCI_B1_I2C_RECOVERY_HALF_PERIOD_US    5
+
+// Queues of transactions waiting to be executed by the interrupt service routine, one per priority
+static EUSCI_B1_I2C_Transaction *EUSCI_B1_I2C_Queue[EUSCI_B1_I2C_NUM_PRIORITIES][EUSCI_B1_I2C_QUEUE_LENGTH];
+static volatile uint32_t EUSCI_B1_I2C_Queue_Head[EUSCI_B1_I2C_NUM_PRIORITIES];
+static volatile uint32_t EUSCI_B1_I2C_Queue_Tail[EUSCI_B1_I2C_NUM_PRIORITIES];
+
+// Transaction that is currently being executed, or 0 if the bus is idle
+static EUSCI_B1_I2C_Transaction *volatile EUSCI_B1_I2C_Current;
+
+// Number of bytes sent and received by the current transaction
+static uint16_t EUSCI_B1_I2C_TX_Index;
+static uint16_t EUSCI_B1_I2C_RX_Index;
+
+// Cycle counter value at the START condition of the current transaction
+static volatile uint32_t EUSCI_B1_I2C_Start_Cycles;
+
+// Set by EUSCI_B1_I2C_Watchdog_Task to abort the current transaction in the EUSCI_B1 interrupt
+static volatile uint8_t EUSCI_B1_I2C_Abort_Pending;
+
+// Set while the next queued transaction waits for the STOP condition of a blocking transfer (UCSTPIFG),
+// since EUSCI_B1_I2C_Start_Cycles
+static volatile uint8_t EUSCI_B1_I2C_Stop_Pending;
+
+// Device table: statistics and BRW value of each device, in the order of their first use
+static EUSCI_B1_I2C_Device_Stats EUSCI_B1_I2C_Devices[EUSCI_B1_I2C_MAX_DEVICES];
+static uint16_t EUSCI_B1_I2C_Device_BRW[EUSCI_B1_I2C_MAX_DEVICES];
+static volatile uint8_t EUSCI_B1_I2C_Device_Count;
+
+static volatile uint32_t EUSCI_B1_I2C_Recovery_Count;
+
+// Returns the index of a device in the table, added with the default SCL frequency if needed, or -1 if the table is full
+// Note: Must be called with the interrupts disabled or from the EUSCI_B1 interrupt
+static int8_t EUSCI_B1_I2C_Find_Device(uint8_t slave_address)
+{
+    EUSCI_B1_I2C_Device_Stats *stats;
+    uint8_t i;
+
+    for (i = 0; i < EUSCI_B1_I2C_Device_Count; i++)
+    {
+        if (EUSCI_B1_I2C_Devices[i].Slave_Address == slave_address)
+        {
+            return (int8_t)i;
+        }
+    }
+
+    if (EUSCI_B1_I2C_Device_Count >= EUSCI_B1_I2C_MAX_DEVICES)
+    {
+        return -1;
+    }
+
+    EUSCI_B1_I2C_Device_BRW[i] = EUSCI_B1_I2C_BRW(EUSCI_B1_I2C_DEFAULT_SCL_HZ);
+
+    stats = &EUSCI_B1_I2C_Devices[i];
+    stats->Slave_Address = slave_address;
+    stats->SCL_Frequency_Hz = EUSCI_B1_I2C_CLOCK_HZ / EUSCI_B1_I2C_Device_BRW[i];
+    stats->Transfers = 0;
+    stats->Bytes = 0;
+    stats->NACKs = 0;
+    stats->Timeouts = 0;
+    stats->Max_Wait_Cycles = 0;
+    stats->Max_Transfer_Cycles = 0;
+
+    EUSCI_B1_I2C_Device_Count = i + 1;
+
+    return (int8_t)i;
+}
+
+// Releases a bus held by a slave: clocks SCL until the slave releases SDA, then generates a STOP condition
+// Note: The EUSCI_B1 module must be held in reset. P6.4 and P6.5 are returned to the module afterwards
+static void EUSCI_B1_I2C_Recover_Bus(void)
+{
+    uint8_t pulse;
+
+    // Use P6.4 (SDA) and P6.5 (SCL) as open-drain GPIO pins:
+    // driven low with DIR = 1, or released to the pull-up resistors with DIR = 0
+    P6->OUT &= ~0x30;
+    P6->DIR &= ~0x30;
+    P6->SEL0 &= ~0x30;
+    P6->SEL1 &= ~0x30;
+
+    // A slave in the middle of a read releases SDA after at most 9 clock pulses (8 data bits and the acknowledge)
+    for (pulse = 0; (pulse < 9) && ((P6->IN & 0x10) == 0); pulse++)
+    {
+        P6->DIR |= 0x20;
+        Clock_Delay1us(EUSCI_B1_I2C_RECOVERY_HALF_PERIOD_US);
+        P6->DIR &= ~0x20;
+        Clock_Delay1us(EUSCI_B1_I2C_RECOVERY_HALF_PERIOD_US);
+    }
+
+    // Generate a STOP condition: SDA is released while SCL is high
+    P6->DIR |= 0x20;
+    Clock_Delay1us(EUSCI_B1_I2C_RECOVERY_HALF_PERIOD_US);
+    P6->DIR |= 0x10;
+    Clock_Delay1us(EUSCI_B1_I2C_RECOVERY_HALF_PERIOD_US);
+    P6->DIR &= ~0x20;
+    Clock_Delay1us(EUSCI_B1_I2C_RECOVERY_HALF_PERIOD_US);
+    P6->DIR &= ~0x10;
+    Clock_Delay1us(EUSCI_B1_I2C_RECOVERY_HALF_PERIOD_US);
+
+    // Configure pins P6.4 (SDA) and P6.5 (SCL) as primary module function
+    P6->SEL0 |= 0x30;
+
+    EUSCI_B1_I2C_Recovery_Count = EUSCI_B1_I2C_Recovery_Count + 1;
+}
+
+// Waits for the STOP condition of a blocking transfer to be generated (UCTXSTP cleared), and releases the bus
+// if a slave still holds it after EUSCI_B1_I2C_STOP_TIMEOUT_US
+// Note: Only used by the blocking transfers, with the interrupts enabled
+static void EUSCI_B1_I2C_Wait_Stop(void)
+{
+    uint32_t timeout_cycles = EUSCI_B1_I2C_STOP_TIMEOUT_US * (Clock_GetFreq() / 1000000);
+    uint32_t start_cycles = CycleCounter_Read();
+
+    while(EUSCI_B1->CTLW0 & 0x0004)
+    {
+        if ((CycleCounter_Read() - start_cycles) >= timeout_cycles)
+        {
+            // Hold the EUSCI_B1 module in reset mode, which clears UCTXSTP, and clock the slave out of the transfer
+            EUSCI_B1->CTLW0 |= 0x0001;
+            EUSCI_B1_I2C_Recover_Bus();
+            EUSCI_B1->CTLW0 &= ~0x0001;
+            return;
+        }
+    }
+}
+
+// Sets the SCL frequency of a device before a START condition (the default frequency if it has no entry)
+// Note: The STOP condition of the previous transfer must have been generated (UCTXSTP cleared)
+static void EUSCI_B1_I2C_Select_Clock(int8_t device)
+{
+    uint16_t brw = (device >= 0) ? EUSCI_B1_I2C_Device_BRW[device] : EUSCI_B1_I2C_BRW(EUSCI_B1_I2C_DEFAULT_SCL_HZ);
+
+    if (EUSCI_B1->BRW != brw)
+    {
+        // BRW can only be modified while UCSWRST is set, which also resets the interrupt flags
+        EUSCI_B1->CTLW0 |= 0x0001;
+        EUSCI_B1->BRW = brw;
+        EUSCI_B1->CTLW0 &= ~0x0001;
+    }
+}
+
+// Selects the SCL frequency of a device for a blocking transfer, and counts the transfer
+static void EUSCI_B1_I2C_Begin_Blocking(uint8_t slave_address, uint32_t length)
+{
+    int8_t device;
+    long sr;
+
+    // Wait for the STOP condition of the previous blocking transfer before the interrupts are disabled
+    EUSCI_B1_I2C_Wait_Stop();
+
+    sr = StartCritical();
+
+    device = EUSCI_B1_I2C_Find_Device(slave_address);
+    EUSCI_B1_I2C_Select_Clock(device);
+    if (device >= 0)
+    {
+        EUSCI_B1_I2C_Devices[device].Transfers = EUSCI_B1_I2C_Devices[device].Transfers + 1;
+        EUSCI_B1_I2C_Devices[device].Bytes = EUSCI_B1_I2C_Devices[device].Bytes + length;
+    }
+
+    EndCritical(sr);
+}
 
 void EUSCI_B1_I2C_Init()
 {
@@ -50,19 +223,29 @@ void EUSCI_B1_I2C_Init()
     //     -----       -----       -----       -----------
     //      15-9       Reserved     0x0        Reserved
     //      8          UCETXINT     0x0        Early UCTXIFG0 flag in slave mode
-    //      7-6        UCCLTO       0x0        Disable clock low timeout
+    //      7-6        UCCLTO       0x1        Clock low timeout of about 28 ms
     //      5          UCSTPNACK    0x0        Send NACK before STOP condition in master receiver mode
     //      4          UCSWACK      0x0        Address acknowledge of slave is controlled by eUSCI module
     //      3-2        UCASTPx      0x0        No automatic STOP generation in slave mode when UCBCNTIFG is available
     //      1-0        UCGLITx      0x0        Deglitch time of 50 ns
-    EUSCI_B1->CTLW1 = 0;
+    EUSCI_B1->CTLW1 = 0x0040;
 
     // Set the SCL frequency. Since SMCLK is selected as the clock source,
     // the frequency used is 12 MHz
     // Choose 400 kHz for the SCL frequency:
     // N = (Clock Frequency) / (SCL Frequency) = (12,000,000 / 400,000) = 30
     // N = 30
-    EUSCI_B1->BRW = 30;
+    // Note: EUSCI_B1_I2C_Select_Clock changes it before a transfer to a device with another frequency
+    EUSCI_B1->BRW = EUSCI_B1_I2C_BRW(EUSCI_B1_I2C_DEFAULT_SCL_HZ);
+
+    // A slave left in the middle of a read by a reset holds SDA low until it has been clocked out
+    P6->SEL0 &= ~0x30;
+    P6->SEL1 &= ~0x30;
+    P6->DIR &= ~0x30;
+    if ((P6->IN & 0x10) == 0)
+    {
+        EUSCI_B1_I2C_Recover_Bus();
+    }
 
     // Configure pins P6.4 (SDA) and P6.5 (SCL) as primary module function
     P6->SEL0 |= 0x30;
@@ -72,14 +255,35 @@ void EUSCI_B1_I2C_Init()
     EUSCI_B1->CTLW0 &= ~0x0001;
 
     // Ensure that all interrupts are disabled
+    // Note: The interrupts are only enabled while a queued transaction is active
     EUSCI_B1->IE = 0x0000;
+
+    for (int priority = 0; priority < EUSCI_B1_I2C_NUM_PRIORITIES; priority++)
+    {
+        EUSCI_B1_I2C_Queue_Head[priority] = 0;
+        EUSCI_B1_I2C_Queue_Tail[priority] = 0;
+    }
+    EUSCI_B1_I2C_Current = 0;
+    EUSCI_B1_I2C_Abort_Pending = 0;
+    EUSCI_B1_I2C_Stop_Pending = 0;
+
+    // Set the interrupt priority level (EUSCI_B1 has an IRQ number of 21)
+    NVIC->IP[21] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_EUSCI_B1);
+
+    // Enable Interrupt 21 in NVIC by setting Bit 21 of the ISER[0] register
+    NVIC->ISER[0] = 0x00200000;
 }
 
 void EUSCI_B1_I2C_Send_A_Byte(uint8_t slave_address, uint8_t data)
 {
+    // Wait until all queued transactions have completed
+    EUSCI_B1_I2C_Wait_Idle();
+
     // Wait until I2C is not busy
     while(EUSCI_B1->STATW & 0x0010);
 
+    EUSCI_B1_I2C_Begin_Blocking(slave_address, 1);
+
     // Set the slave address
     EUSCI_B1->I2CSA = slave_address;
 
@@ -108,9 +312,14 @@ void EUSCI_B1_I2C_Send_A_Byte(uint8_t slave_address, uint8_t data)
 
 void EUSCI_B1_I2C_Send_Multiple_Bytes(uint8_t slave_address, uint8_t *data_buffer, uint32_t packet_length)
 {
+    // Wait until all queued transactions have completed
+    EUSCI_B1_I2C_Wait_Idle();
+
     // Wait until I2C is not busy
     while(EUSCI_B1->STATW & 0x0010);
 
+    EUSCI_B1_I2C_Begin_Blocking(slave_address, packet_length);
+
     // Set the slave address
     EUSCI_B1->I2CSA = slave_address;
 
@@ -143,9 +352,14 @@ void EUSCI_B1_I2C_Send_Multiple_Bytes(uint8_t slave_address, uint8_t *data_buffe
 
 uint8_t EUSCI_B1_I2C_Receive_A_Byte(uint8_t slave_address)
 {
+    // Wait until all queued transactions have completed
+    EUSCI_B1_I2C_Wait_Idle();
+
     // Wait until I2C is not busy
     while(EUSCI_B1->STATW & 0x0010);
 
+    EUSCI_B1_I2C_Begin_Blocking(slave_address, 1);
+
     // Hold the EUSCI_B1 module in reset mode
     EUSCI_B1->CTLW0 |= 0x0001;
 
@@ -178,6 +392,11 @@ uint8_t EUSCI_B1_I2C_Receive_A_Byte(uint8_t slave_address)
 
 void EUSCI_B1_I2C_Receive_Multiple_Bytes(uint8_t slave_address, uint8_t *data_buffer, uint16_t packet_length)
 {
+    // Wait until all queued transactions have completed
+    EUSCI_B1_I2C_Wait_Idle();
+
+    EUSCI_B1_I2C_Begin_Blocking(slave_address, packet_length);
+
     // Set the slave address
     EUSCI_B1->I2CSA = slave_address;
 
@@ -209,5 +428,418 @@ void EUSCI_B1_I2C_Receive_Multiple_Bytes(uint8_t slave_address, uint8_t *data_bu
 
     // Wait while UCTXSTP is 1
     // Note: UCTXSTP is automatically cleared after the STOP condition is generated
-    while(EUSCI_B1->CTLW0 & 0x0004);
+    EUSCI_B1_I2C_Wait_Stop();
+}
+
+static void EUSCI_B1_I2C_Start_Receive(void)
+{
+    // Configure I2C master receive mode
+    // Clear UCTR (Bit 4): Receive mode
+    // Set UCTXSTT (Bit 1): Generate (repeated) START condition
+    EUSCI_B1->CTLW0 = (EUSCI_B1->CTLW0 & ~0x0010) | 0x0002;
+
+    // Enable UCRXIE0 (Bit 0), UCSTPIE (Bit 3), UCNACKIE (Bit 5), and UCCLTOIE (Bit 7)
+    EUSCI_B1->IE = 0x00A9;
+
+    if (EUSCI_B1_I2C_Current->RX_Length == 1)
+    {
+        // For a single byte, request the STOP condition with the START condition, like EUSCI_B1_I2C_Receive_A_Byte,
+        // so that the interrupt is not kept waiting for UCTXSTT to be cleared
+        EUSCI_B1->CTLW0 |= 0x0004;
+    }
+}
+
+static void EUSCI_B1_I2C_Start_Next(void)
+{
+    EUSCI_B1_I2C_Transaction *transaction = 0;
+    EUSCI_B1_I2C_Device_Stats *stats;
+    uint32_t wait_cycles;
+    int priority;
+
+    // Find the oldest transaction of the highest priority
+    for (priority = EUSCI_B1_I2C_NUM_PRIORITIES - 1; priority >= 0; priority--)
+    {
+        if (EUSCI_B1_I2C_Queue_Tail[priority] != EUSCI_B1_I2C_Queue_Head[priority])
+        {
+            transaction = EUSCI_B1_I2C_Queue[priority][EUSCI_B1_I2C_Queue_Tail[priority] & (EUSCI_B1_I2C_QUEUE_LENGTH - 1)];
+            break;
+        }
+    }
+
+    EUSCI_B1_I2C_Current = 0;
+    if (transaction == 0)
+    {
+        return;
+    }
+
+    // The STOP condition of a blocking transfer has not been generated yet: leave the transaction queued,
+    // since this function is executed with the interrupts disabled or from the EUSCI_B1 interrupt
+    // Note: UCSTPIFG starts it, or EUSCI_B1_I2C_Watchdog_Task recovers the bus after EUSCI_B1_I2C_TRANSACTION_TIMEOUT_US
+    if (EUSCI_B1->CTLW0 & 0x0004)
+    {
+        if (EUSCI_B1_I2C_Stop_Pending == 0)
+        {
+            EUSCI_B1_I2C_Stop_Pending = 1;
+            EUSCI_B1_I2C_Start_Cycles = CycleCounter_Read();
+        }
+
+        // Enable UCSTPIE (Bit 3) and UCCLTOIE (Bit 7)
+        EUSCI_B1->IE = 0x0088;
+        return;
+    }
+
+    EUSCI_B1_I2C_Stop_Pending = 0;
+    EUSCI_B1_I2C_Queue_Tail[priority] = EUSCI_B1_I2C_Queue_Tail[priority] + 1;
+
+    EUSCI_B1_I2C_Current = transaction;
+    EUSCI_B1_I2C_TX_Index = 0;
+    EUSCI_B1_I2C_RX_Index = 0;
+    transaction->Status = EUSCI_B1_I2C_STATUS_ACTIVE;
+
+    EUSCI_B1_I2C_Select_Clock(transaction->Device);
+
+    EUSCI_B1_I2C_Start_Cycles = CycleCounter_Read();
+    if (transaction->Device >= 0)
+    {
+        stats = &EUSCI_B1_I2C_Devices[transaction->Device];
+        wait_cycles = EUSCI_B1_I2C_Start_Cycles - transaction->Submit_Cycles;
+        if (wait_cycles > stats->Max_Wait_Cycles)
+        {
+            stats->Max_Wait_Cycles = wait_cycles;
+        }
+    }
+
+    // Set the slave address and clear the interrupt flags of the previous transfer
+    EUSCI_B1->I2CSA = transaction->Slave_Address;
+    EUSCI_B1->IFG = 0x0000;
+
+    if (transaction->TX_Length > 0)
+    {
+        // Configure I2C master transmit mode
+        // Clear UCTXSTP (Bit 2): No STOP condition
+        // Set UCTR (Bit 4): Transmitter mode
+        // Set UCTXSTT (Bit 1): Generate START condition
+        EUSCI_B1->CTLW0 = (EUSCI_B1->CTLW0 & ~0x0004) | 0x0012;
+
+        // Enable UCTXIE0 (Bit 1), UCSTPIE (Bit 3), UCNACKIE (Bit 5), and UCCLTOIE (Bit 7)
+        EUSCI_B1->IE = 0x00AA;
+    }
+    else if (transaction->RX_Length > 0)
+    {
+        EUSCI_B1_I2C_Start_Receive();
+    }
+    else
+    {
+        // Address-only transaction: generate START and STOP conditions
+        EUSCI_B1->CTLW0 |= 0x0016;
+
+        // Enable UCSTPIE (Bit 3), UCNACKIE (Bit 5), and UCCLTOIE (Bit 7)
+        EUSCI_B1->IE = 0x00A8;
+    }
+}
+
+int EUSCI_B1_I2C_Submit(EUSCI_B1_I2C_Transaction *transaction)
+{
+    uint8_t priority = (transaction->Priority < EUSCI_B1_I2C_NUM_PRIORITIES) ? transaction->Priority : EUSCI_B1_I2C_PRIORITY_HIGH;
+    long sr;
+
+    sr = StartCritical();
+
+    if ((EUSCI_B1_I2C_Queue_Head[priority] - EUSCI_B1_I2C_Queue_Tail[priority]) >= EUSCI_B1_I2C_QUEUE_LENGTH)
+    {
+        EndCritical(sr);
+        return -1;
+    }
+
+    transaction->Status = EUSCI_B1_I2C_STATUS_PENDING;
+    transaction->Device = EUSCI_B1_I2C_Find_Device(transaction->Slave_Address);
+    transaction->Submit_Cycles = CycleCounter_Read();
+    EUSCI_B1_I2C_Queue[priority][EUSCI_B1_I2C_Queue_Head[priority] & (EUSCI_B1_I2C_QUEUE_LENGTH - 1)] = transaction;
+    EUSCI_B1_I2C_Queue_Head[priority] = EUSCI_B1_I2C_Queue_Head[priority] + 1;
+
+    // Start the transaction immediately if the bus is idle
+    if (EUSCI_B1_I2C_Current == 0)
+    {
+        EUSCI_B1_I2C_Start_Next();
+    }
+
+    EndCritical(sr);
+
+    return 0;
+}
+
+int EUSCI_B1_I2C_Write_Read_Async(EUSCI_B1_I2C_Transaction *transaction, uint8_t slave_address,
+                                  const uint8_t *tx_buffer, uint16_t tx_length,
+                                  uint8_t *rx_buffer, uint16_t rx_length,
+                                  void (*callback)(EUSCI_B1_I2C_Transaction *transaction))
+{
+    transaction->Slave_Address = slave_address;
+    transaction->TX_Buffer = tx_buffer;
+    transaction->TX_Length = tx_length;
+    transaction->RX_Buffer = rx_buffer;
+    transaction->RX_Length = rx_length;
+    transaction->Callback = callback;
+
+    return EUSCI_B1_I2C_Submit(transaction);
+}
+
+uint8_t EUSCI_B1_I2C_Is_Busy(void)
+{
+    return ((EUSCI_B1_I2C_Current != 0) || EUSCI_B1_I2C_Stop_Pending);
+}
+
+void EUSCI_B1_I2C_Wait_Idle(void)
+{
+    while((EUSCI_B1_I2C_Current != 0) || EUSCI_B1_I2C_Stop_Pending);
+}
+
+int EUSCI_B1_I2C_Set_Device_Clock(uint8_t slave_address, uint32_t scl_frequency_hz)
+{
+    int8_t device;
+    long sr;
+
+    if ((scl_frequency_hz == 0) || (scl_frequency_hz > EUSCI_B1_I2C_MAX_SCL_HZ))
+    {
+        return -1;
+    }
+
+    sr = StartCritical();
+
+    device = EUSCI_B1_I2C_Find_Device(slave_address);
+    if (device < 0)
+    {
+        EndCritical(sr);
+        return -1;
+    }
+
+    EUSCI_B1_I2C_Device_BRW[device] = EUSCI_B1_I2C_BRW(scl_frequency_hz);
+    EUSCI_B1_I2C_Devices[device].SCL_Frequency_Hz = EUSCI_B1_I2C_CLOCK_HZ / EUSCI_B1_I2C_Device_BRW[device];
+
+    EndCritical(sr);
+
+    return 0;
+}
+
+uint8_t EUSCI_B1_I2C_Get_Device_Count(void)
+{
+    return EUSCI_B1_I2C_Device_Count;
+}
+
+int EUSCI_B1_I2C_Get_Device_Stats(uint8_t index, EUSCI_B1_I2C_Device_Stats *stats)
+{
+    long sr;
+
+    if (index >= EUSCI_B1_I2C_Device_Count)
+    {
+        return -1;
+    }
+
+    // Copy with the interrupts disabled, so the counters are from the same transfer
+    sr = StartCritical();
+    *stats = EUSCI_B1_I2C_Devices[index];
+    EndCritical(sr);
+
+    return 0;
+}
+
+uint32_t EUSCI_B1_I2C_Get_Recovery_Count(void)
+{
+    return EUSCI_B1_I2C_Recovery_Count;
+}
+
+void EUSCI_B1_I2C_Watchdog_Task(void)
+{
+    uint32_t timeout_cycles = EUSCI_B1_I2C_TRANSACTION_TIMEOUT_US * (Clock_GetFreq() / 1000000);
+    long sr;
+
+    sr = StartCritical();
+
+    if (((EUSCI_B1_I2C_Current != 0) || EUSCI_B1_I2C_Stop_Pending) && (EUSCI_B1_I2C_Abort_Pending == 0) &&
+        ((CycleCounter_Read() - EUSCI_B1_I2C_Start_Cycles) >= timeout_cycles))
+    {
+        EUSCI_B1_I2C_Abort_Pending = 1;
+
+        // Set Bit 21 of the ISPR[0] register, so the abort is executed by the EUSCI_B1 interrupt
+        // like the completion of every other transaction
+        NVIC->ISPR[0] = 0x00200000;
+    }
+
+    EndCritical(sr);
+}
+
+// Counts the current transaction, starts the next one, and executes the callback of the current one
+static void EUSCI_B1_I2C_Complete(EUSCI_B1_I2C_Transaction *transaction)
+{
+    EUSCI_B1_I2C_Device_Stats *stats;
+    uint32_t transfer_cycles = CycleCounter_Read() - EUSCI_B1_I2C_Start_Cycles;
+
+    if (transaction->Device >= 0)
+    {
+        stats = &EUSCI_B1_I2C_Devices[transaction->Device];
+        stats->Transfers = stats->Transfers + 1;
+        stats->Bytes = stats->Bytes + EUSCI_B1_I2C_TX_Index + EUSCI_B1_I2C_RX_Index;
+
+        if (transaction->Status == EUSCI_B1_I2C_STATUS_NACK)
+        {
+            stats->NACKs = stats->NACKs + 1;
+        }
+        else if (transaction->Status == EUSCI_B1_I2C_STATUS_TIMEOUT)
+        {
+            stats->Timeouts = stats->Timeouts + 1;
+        }
+        else if (transfer_cycles > stats->Max_Transfer_Cycles)
+        {
+            stats->Max_Transfer_Cycles = transfer_cycles;
+        }
+    }
+
+    // Start the next transaction before executing the callback so the bus stays busy
+    EUSCI_B1_I2C_Start_Next();
+
+    if (transaction->Callback)
+    {
+        (*transaction->Callback)(transaction);
+    }
+}
+
+// Aborts the current transaction after a clock low timeout or a watchdog timeout, and releases the bus
+// Without a current transaction, releases the bus held after a blocking transfer and starts the next queued transaction
+static void EUSCI_B1_I2C_Abort(void)
+{
+    EUSCI_B1_I2C_Transaction *transaction = EUSCI_B1_I2C_Current;
+
+    EUSCI_B1_I2C_Abort_Pending = 0;
+
+    if ((transaction == 0) && (EUSCI_B1_I2C_Stop_Pending == 0))
+    {
+        return;
+    }
+
+    // Hold the EUSCI_B1 module in reset mode, which stops the transfer and clears UCTXSTP, and clock the slave out of it
+    EUSCI_B1->IE = 0x0000;
+    EUSCI_B1->CTLW0 |= 0x0001;
+    EUSCI_B1_I2C_Recover_Bus();
+    EUSCI_B1->CTLW0 &= ~0x0001;
+    EUSCI_B1->IFG = 0x0000;
+
+    if (transaction == 0)
+    {
+        EUSCI_B1_I2C_Start_Next();
+        return;
+    }
+
+    transaction->Status = EUSCI_B1_I2C_STATUS_TIMEOUT;
+    EUSCI_B1_I2C_Complete(transaction);
+}
+
+// Advances the current transaction, executed by the EUSCI_B1 interrupt
+static void EUSCI_B1_I2C_Service(void)
+{
+    EUSCI_B1_I2C_Transaction *transaction = EUSCI_B1_I2C_Current;
+    uint16_t flags = EUSCI_B1->IFG & EUSCI_B1->IE;
+
+    // Abort requested by the watchdog, or UCCLTOIFG (Bit 7): a slave has held SCL low for about 28 ms
+    if (EUSCI_B1_I2C_Abort_Pending || (flags & 0x0080))
+    {
+        EUSCI_B1_I2C_Abort();
+        return;
+    }
+
+    // UCSTPIFG (Bit 3) without a current transaction: the STOP condition of a blocking transfer awaited by
+    // EUSCI_B1_I2C_Start_Next has been generated
+    if (transaction == 0)
+    {
+        if (flags & 0x0008)
+        {
+            EUSCI_B1->IFG &= ~0x0008;
+            EUSCI_B1->IE = 0x0000;
+            EUSCI_B1_I2C_Start_Next();
+        }
+        return;
+    }
+
+    // UCNACKIFG (Bit 5): The slave did not acknowledge its address or a data byte
+    if (flags & 0x0020)
+    {
+        EUSCI_B1->IFG &= ~0x0020;
+        transaction->Status = EUSCI_B1_I2C_STATUS_NACK;
+
+        // Set UCTXSTP (Bit 2): Generate STOP condition and wait for UCSTPIFG (or UCCLTOIFG)
+        EUSCI_B1->CTLW0 |= 0x0004;
+        EUSCI_B1->IE = 0x0088;
+        return;
+    }
+
+    // UCTXIFG0 (Bit 1): The TX buffer is ready for the next byte
+    if (flags & 0x0002)
+    {
+        if (EUSCI_B1_I2C_TX_Index < transaction->TX_Length)
+        {
+            // Write data to TX buffer (clears UCTXIFG0)
+            EUSCI_B1->TXBUF = transaction->TX_Buffer[EUSCI_B1_I2C_TX_Index];
+            EUSCI_B1_I2C_TX_Index = EUSCI_B1_I2C_TX_Index + 1;
+        }
+        else
+        {
+            // Clear UCTXIFG0 since no more bytes will be written
+            EUSCI_B1->IFG &= ~0x0002;
+
+            if (transaction->RX_Length > 0)
+            {
+                // Switch to receiver mode with a repeated START condition
+                EUSCI_B1_I2C_Start_Receive();
+            }
+            else
+            {
+                // Set UCTXSTP (Bit 2): Generate STOP condition
+                EUSCI_B1->CTLW0 |= 0x0004;
+
+                // Only wait for UCSTPIFG, UCNACKIFG, and UCCLTOIFG
+                EUSCI_B1->IE = 0x00A8;
+            }
+        }
+    }
+
+    // UCRXIFG0 (Bit 0): A byte has been received
+    if (flags & 0x0001)
+    {
+        // Request the STOP condition before the last byte is received so that it is preceded by a NACK
+        if ((transaction->RX_Length - EUSCI_B1_I2C_RX_Index) == 2)
+        {
+            EUSCI_B1->CTLW0 |= 0x0004;
+        }
+
+        // Retrieve received data from the RX buffer (clears UCRXIFG0)
+        transaction->RX_Buffer[EUSCI_B1_I2C_RX_Index] = EUSCI_B1->RXBUF;
+        EUSCI_B1_I2C_RX_Index = EUSCI_B1_I2C_RX_Index + 1;
+
+        if (EUSCI_B1_I2C_RX_Index >= transaction->RX_Length)
+        {
+            // Only wait for UCSTPIFG and UCCLTOIFG
+            EUSCI_B1->IE = 0x0088;
+        }
+    }
+
+    // UCSTPIFG (Bit 3): The STOP condition has been generated and the transaction is complete
+    if (flags & 0x0008)
+    {
+        EUSCI_B1->IFG = 0x0000;
+        EUSCI_B1->IE = 0x0000;
+
+        if (transaction->Status == EUSCI_B1_I2C_STATUS_ACTIVE)
+        {
+            transaction->Status = EUSCI_B1_I2C_STATUS_DONE;
+        }
+
+        EUSCI_B1_I2C_Complete(transaction);
+    }
+}
+
+void EUSCI_B1_IRQHandler(void)
+{
+    PROFILER_START(PROFILER_EUSCI_B1);
+
+    EUSCI_B1_I2C_Service();
+
+    PROFILER_STOP(PROFILER_EUSCI_B1);
 }
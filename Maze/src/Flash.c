@@ -0,0 +1,176 @@
+/**
+ * @file Flash.c
+ * @brief Source code for the Flash driver.
+ *
+ * This file contains the function definitions for the Flash driver.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Flash.h"
+
+// Address of the sector being erased by Flash_Erase_Start, or 0 if there is none
+static uint32_t Flash_Erase_Address;
+
+// CRC-32 (polynomial 0xEDB88320) of the values 0 to 15, used to process 4 bits at a time
+static const uint32_t Flash_CRC_Table[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+// Returns the write/erase protection bit of a sector in the BANK1_MAIN_WEPROT register
+static uint32_t Flash_Protection_Bit(uint32_t address)
+{
+    return 1UL << ((address - FLASH_BANK1_ADDRESS) / FLASH_SECTOR_SIZE);
+}
+
+// Waits for the erase in progress, if any
+static int Flash_Erase_Wait(void)
+{
+    int result;
+
+    do
+    {
+        result = Flash_Erase_Poll();
+    } while (result > 0);
+
+    return result;
+}
+
+int Flash_Erase_Start(uint32_t address)
+{
+    if ((address < FLASH_BANK1_ADDRESS) || (address >= (FLASH_BANK1_ADDRESS + FLASH_BANK1_SIZE)) || (address & (FLASH_SECTOR_SIZE - 1)))
+    {
+        return -1;
+    }
+
+    Flash_Erase_Wait();
+
+    // Unprotect the sector by clearing its bit in the BANK1_MAIN_WEPROT register
+    FLCTL->BANK1_MAIN_WEPROT &= ~Flash_Protection_Bit(address);
+
+    // Select a sector erase (MODE, Bit 1) of the main memory (TYPE, Bits 3 to 2) and clear the previous status (CLR_STAT, Bit 19)
+    FLCTL->ERASE_CTLSTAT = (FLCTL->ERASE_CTLSTAT & ~0x0000000E) | 0x00080000;
+    FLCTL->ERASE_SECTADDR = address;
+
+    // Start the erase (START, Bit 0)
+    FLCTL->ERASE_CTLSTAT |= 0x00000001;
+    Flash_Erase_Address = address;
+
+    return 0;
+}
+
+int Flash_Erase_Poll(void)
+{
+    uint32_t address = Flash_Erase_Address;
+    uint32_t offset;
+    int result = 0;
+
+    if (address == 0)
+    {
+        return 0;
+    }
+
+    // The STATUS field (Bits 17 to 16) indicates that the erase is complete (11b)
+    if ((FLCTL->ERASE_CTLSTAT & 0x00030000) != 0x00030000)
+    {
+        return 1;
+    }
+    Flash_Erase_Address = 0;
+
+    // Check the address error flag (ADDR_ERR, Bit 18), then clear the status
+    if (FLCTL->ERASE_CTLSTAT & 0x00040000)
+    {
+        result = -1;
+    }
+    FLCTL->ERASE_CTLSTAT |= 0x00080000;
+
+    // Protect the sector again
+    FLCTL->BANK1_MAIN_WEPROT |= Flash_Protection_Bit(address);
+
+    // Verify that every word has been erased
+    for (offset = 0; (result == 0) && (offset < FLASH_SECTOR_SIZE); offset += 4)
+    {
+        if (FLASH_WORD(address + offset) != FLASH_ERASED)
+        {
+            result = -1;
+        }
+    }
+
+    return result;
+}
+
+int Flash_Erase_Sector(uint32_t address)
+{
+    if (Flash_Erase_Start(address) != 0)
+    {
+        return -1;
+    }
+
+    return Flash_Erase_Wait();
+}
+
+int Flash_Program_Word(uint32_t address, uint32_t data)
+{
+    Flash_Erase_Wait();
+
+    // Unprotect the sector by clearing its bit in the BANK1_MAIN_WEPROT register
+    FLCTL->BANK1_MAIN_WEPROT &= ~Flash_Protection_Bit(address);
+
+    // Enable the immediate word programming (ENABLE, Bit 0 and MODE, Bit 1 cleared) without the verify steps,
+    // and clear the program complete (PRG, Bit 3) and program error (PRG_ERR, Bit 9) flags
+    FLCTL->PRG_CTLSTAT = (FLCTL->PRG_CTLSTAT & ~0x0000000E) | 0x00000001;
+    FLCTL->CLRIFG = 0x00000208;
+
+    // Writing the word to the flash address starts the program operation
+    FLASH_WORD(address) = data;
+    while ((FLCTL->IFG & 0x00000008) == 0);
+
+    // Disable the word programming and protect the sector again
+    FLCTL->PRG_CTLSTAT &= ~0x00000001;
+    FLCTL->BANK1_MAIN_WEPROT |= Flash_Protection_Bit(address);
+
+    if ((FLCTL->IFG & 0x00000200) || (FLASH_WORD(address) != data))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int Flash_Program(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    uint32_t word;
+
+    while (length > 0)
+    {
+        word = FLASH_ERASED;
+        memcpy(&word, data, (length < 4) ? length : 4);
+
+        if (Flash_Program_Word(address, word) != 0)
+        {
+            return -1;
+        }
+
+        address = address + 4;
+        data = data + 4;
+        length = (length < 4) ? 0 : (length - 4);
+    }
+
+    return 0;
+}
+
+uint32_t Flash_CRC32(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length > 0)
+    {
+        crc = crc ^ *data;
+        crc = (crc >> 4) ^ Flash_CRC_Table[crc & 0x0F];
+        crc = (crc >> 4) ^ Flash_CRC_Table[crc & 0x0F];
+        data++;
+        length--;
+    }
+
+    return crc;
+}
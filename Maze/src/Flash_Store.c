@@ -0,0 +1,303 @@
+/**
+ * @file Flash_Store.c
+ * @brief Source code for the Flash_Store driver.
+ *
+ * This file contains the function definitions for the Flash_Store driver.
+ * It appends CRC-protected records to a flash sector and rotates the sectors when the active sector is full.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Flash_Store.h"
+
+// Magic word of a valid sector header ("FST1")
+#define FLASH_STORE_MAGIC               0x46535431
+
+// Size of the sector header (magic and generation) and of a record header (key and length, CRC)
+#define FLASH_STORE_SECTOR_HEADER_SIZE  8
+#define FLASH_STORE_RECORD_HEADER_SIZE  8
+
+// Key of an erased record header
+#define FLASH_STORE_NO_KEY              0xFFFF
+
+#define FLASH_STORE_SECTOR_ADDRESS(sector)  (FLASH_STORE_START_ADDRESS + ((sector) * FLASH_STORE_SECTOR_SIZE))
+#define FLASH_STORE_PADDED(length)          (((length) + 3) & ~3)
+
+// Active sector, its generation, and the offset of its first free word
+static uint8_t Flash_Store_Active_Sector;
+static uint32_t Flash_Store_Generation;
+static uint32_t Flash_Store_Free_Offset;
+
+// Returns the CRC of a record from its header word and its data
+static uint32_t Flash_Store_Record_CRC(uint32_t header, const uint8_t *data, uint16_t length)
+{
+    uint32_t crc;
+
+    crc = Flash_CRC32(0xFFFFFFFF, (const uint8_t *)&header, 4);
+    crc = Flash_CRC32(crc, data, length);
+
+    return ~crc;
+}
+
+static int Flash_Store_Erase_Sector(uint8_t sector)
+{
+    return Flash_Erase_Sector(FLASH_STORE_SECTOR_ADDRESS(sector));
+}
+
+static int Flash_Store_Program_Word(uint8_t sector, uint32_t offset, uint32_t data)
+{
+    return Flash_Program_Word(FLASH_STORE_SECTOR_ADDRESS(sector) + offset, data);
+}
+
+static int Flash_Store_Program(uint8_t sector, uint32_t offset, const uint8_t *data, uint32_t length)
+{
+    return Flash_Program(FLASH_STORE_SECTOR_ADDRESS(sector) + offset, data, length);
+}
+
+// Returns the offset of the first free word of a sector, or the sector size if the sector is full or damaged
+static uint32_t Flash_Store_Find_Free(uint8_t sector)
+{
+    uint32_t address = FLASH_STORE_SECTOR_ADDRESS(sector);
+    uint32_t offset = FLASH_STORE_SECTOR_HEADER_SIZE;
+    uint32_t header;
+
+    while ((offset + FLASH_STORE_RECORD_HEADER_SIZE) <= FLASH_STORE_SECTOR_SIZE)
+    {
+        header = FLASH_WORD(address + offset);
+        if (header == FLASH_ERASED)
+        {
+            return offset;
+        }
+
+        offset = offset + FLASH_STORE_RECORD_HEADER_SIZE + FLASH_STORE_PADDED(header >> 16);
+    }
+
+    return FLASH_STORE_SECTOR_SIZE;
+}
+
+// Returns the offset of the last valid version of a record in a sector, or 0 if there is none
+static uint32_t Flash_Store_Find(uint8_t sector, uint16_t key)
+{
+    uint32_t address = FLASH_STORE_SECTOR_ADDRESS(sector);
+    uint32_t offset = FLASH_STORE_SECTOR_HEADER_SIZE;
+    uint32_t found = 0;
+    uint32_t header;
+    uint16_t length;
+
+    while ((offset + FLASH_STORE_RECORD_HEADER_SIZE) <= FLASH_STORE_SECTOR_SIZE)
+    {
+        header = FLASH_WORD(address + offset);
+        if (header == FLASH_ERASED)
+        {
+            break;
+        }
+
+        length = header >> 16;
+        if ((offset + FLASH_STORE_RECORD_HEADER_SIZE + length) > FLASH_STORE_SECTOR_SIZE)
+        {
+            break;
+        }
+
+        if (((header & 0xFFFF) == key) &&
+            (FLASH_WORD(address + offset + 4) == Flash_Store_Record_CRC(header, (const uint8_t *)(address + offset + FLASH_STORE_RECORD_HEADER_SIZE), length)))
+        {
+            found = offset;
+        }
+
+        offset = offset + FLASH_STORE_RECORD_HEADER_SIZE + FLASH_STORE_PADDED(length);
+    }
+
+    return found;
+}
+
+// Formats a sector with the given generation, after the records have been copied
+static int Flash_Store_Write_Sector_Header(uint8_t sector, uint32_t generation)
+{
+    // The generation is written first, so that a reset before the magic word leaves the sector invalid
+    if (Flash_Store_Program_Word(sector, 4, generation) != 0)
+    {
+        return -1;
+    }
+
+    return Flash_Store_Program_Word(sector, 0, FLASH_STORE_MAGIC);
+}
+
+// Copies the last version of every record to the next sector and makes it the active sector
+static int Flash_Store_Rotate(void)
+{
+    uint8_t next_sector = (Flash_Store_Active_Sector + 1) % FLASH_STORE_NUM_SECTORS;
+    uint32_t address = FLASH_STORE_SECTOR_ADDRESS(Flash_Store_Active_Sector);
+    uint32_t offset = FLASH_STORE_SECTOR_HEADER_SIZE;
+    uint32_t next_offset = FLASH_STORE_SECTOR_HEADER_SIZE;
+    uint32_t header;
+    uint32_t size;
+    uint16_t length;
+
+    if (Flash_Store_Erase_Sector(next_sector) != 0)
+    {
+        return -1;
+    }
+
+    while ((offset + FLASH_STORE_RECORD_HEADER_SIZE) <= FLASH_STORE_SECTOR_SIZE)
+    {
+        header = FLASH_WORD(address + offset);
+        if (header == FLASH_ERASED)
+        {
+            break;
+        }
+
+        length = header >> 16;
+        if ((offset + FLASH_STORE_RECORD_HEADER_SIZE + length) > FLASH_STORE_SECTOR_SIZE)
+        {
+            break;
+        }
+        size = FLASH_STORE_RECORD_HEADER_SIZE + FLASH_STORE_PADDED(length);
+
+        // Copy the record if it is the last valid version of its key
+        if (Flash_Store_Find(Flash_Store_Active_Sector, header & 0xFFFF) == offset)
+        {
+            if (Flash_Store_Program(next_sector, next_offset, (const uint8_t *)(address + offset), size) != 0)
+            {
+                return -1;
+            }
+            next_offset = next_offset + size;
+        }
+
+        offset = offset + size;
+    }
+
+    if (Flash_Store_Write_Sector_Header(next_sector, Flash_Store_Generation + 1) != 0)
+    {
+        return -1;
+    }
+
+    Flash_Store_Active_Sector = next_sector;
+    Flash_Store_Generation = Flash_Store_Generation + 1;
+    Flash_Store_Free_Offset = next_offset;
+
+    return 0;
+}
+
+int Flash_Store_Init(void)
+{
+    uint32_t address;
+    uint32_t generation;
+    uint8_t found = 0;
+    uint8_t sector;
+
+    // The active sector is the valid sector with the highest generation (the comparison handles the wrap-around)
+    for (sector = 0; sector < FLASH_STORE_NUM_SECTORS; sector++)
+    {
+        address = FLASH_STORE_SECTOR_ADDRESS(sector);
+        if (FLASH_WORD(address) != FLASH_STORE_MAGIC)
+        {
+            continue;
+        }
+
+        generation = FLASH_WORD(address + 4);
+        if ((found == 0) || ((int32_t)(generation - Flash_Store_Generation) > 0))
+        {
+            Flash_Store_Active_Sector = sector;
+            Flash_Store_Generation = generation;
+            found = 1;
+        }
+    }
+
+    if (found == 0)
+    {
+        if ((Flash_Store_Erase_Sector(0) != 0) || (Flash_Store_Write_Sector_Header(0, 1) != 0))
+        {
+            return -1;
+        }
+        Flash_Store_Active_Sector = 0;
+        Flash_Store_Generation = 1;
+    }
+
+    Flash_Store_Free_Offset = Flash_Store_Find_Free(Flash_Store_Active_Sector);
+
+    return 0;
+}
+
+int Flash_Store_Read(uint16_t key, void *data, uint16_t length)
+{
+    uint32_t address = FLASH_STORE_SECTOR_ADDRESS(Flash_Store_Active_Sector);
+    uint32_t offset;
+
+    offset = Flash_Store_Find(Flash_Store_Active_Sector, key);
+    if ((offset == 0) || ((FLASH_WORD(address + offset) >> 16) != length))
+    {
+        return -1;
+    }
+
+    memcpy(data, (const void *)(address + offset + FLASH_STORE_RECORD_HEADER_SIZE), length);
+
+    return length;
+}
+
+int Flash_Store_Write(uint16_t key, const void *data, uint16_t length)
+{
+    uint32_t address;
+    uint32_t offset;
+    uint32_t header;
+    uint32_t crc;
+    uint32_t size;
+
+    if ((key == FLASH_STORE_NO_KEY) || (length == 0) || (length > FLASH_STORE_MAX_LENGTH))
+    {
+        return -1;
+    }
+
+    // The free offset is after the sector header once Flash_Store_Init has succeeded
+    if (Flash_Store_Free_Offset == 0)
+    {
+        return -1;
+    }
+
+    // Skip the write if the last version has the same data
+    address = FLASH_STORE_SECTOR_ADDRESS(Flash_Store_Active_Sector);
+    offset = Flash_Store_Find(Flash_Store_Active_Sector, key);
+    if ((offset != 0) && ((FLASH_WORD(address + offset) >> 16) == length) &&
+        (memcmp((const void *)(address + offset + FLASH_STORE_RECORD_HEADER_SIZE), data, length) == 0))
+    {
+        return 0;
+    }
+
+    size = FLASH_STORE_RECORD_HEADER_SIZE + FLASH_STORE_PADDED(length);
+    if ((Flash_Store_Free_Offset + size) > FLASH_STORE_SECTOR_SIZE)
+    {
+        if (Flash_Store_Rotate() != 0)
+        {
+            return -1;
+        }
+        if ((Flash_Store_Free_Offset + size) > FLASH_STORE_SECTOR_SIZE)
+        {
+            return -1;
+        }
+    }
+
+    header = ((uint32_t)length << 16) | key;
+    crc = Flash_Store_Record_CRC(header, (const uint8_t *)data, length);
+
+    // The space of a failed record is not reused, since its words may already be programmed
+    offset = Flash_Store_Free_Offset;
+    Flash_Store_Free_Offset = Flash_Store_Free_Offset + size;
+
+    if ((Flash_Store_Program_Word(Flash_Store_Active_Sector, offset, header) != 0) ||
+        (Flash_Store_Program_Word(Flash_Store_Active_Sector, offset + 4, crc) != 0) ||
+        (Flash_Store_Program(Flash_Store_Active_Sector, offset + FLASH_STORE_RECORD_HEADER_SIZE, (const uint8_t *)data, length) != 0))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+uint32_t Flash_Store_Get_Free(void)
+{
+    return FLASH_STORE_SECTOR_SIZE - Flash_Store_Free_Offset;
+}
+
+uint32_t Flash_Store_Get_Generation(void)
+{
+    return Flash_Store_Generation;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file I2C_Report.c
+ * @brief Source code for the I2C_Report module.
+ *
+ * This file contains the function definitions for the I2C_Report module.
+ * It reports the transfer statistics of every device on the EUSCI_B1 bus, and the bus recoveries.
+ *
+ */
+
+#include <string.h>
+#include "../inc/I2C_Report.h"
+#include "../inc/Print_Format.h"
+
+// Function that sends a reply line
+static void (*I2C_Report_Output)(const char *line);
+
+void I2C_Report_Init(void (*output)(const char *line))
+{
+    I2C_Report_Output = output;
+}
+
+int I2C_Report_Command(char **arguments, uint8_t argument_count)
+{
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+    EUSCI_B1_I2C_Device_Stats stats;
+    uint32_t cycles_per_us = Clock_GetFreq() / 1000000;
+    uint8_t i;
+
+    if ((argument_count != 1) || (strcmp(arguments[0], "i2c") != 0))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < EUSCI_B1_I2C_Get_Device_Count(); i++)
+    {
+        EUSCI_B1_I2C_Get_Device_Stats(i, &stats);
+        Print_Format_To_Buffer(line, sizeof(line), "i2c 0x%02X khz=%lu n=%lu nack=%lu to=%lu wait=%lu xfer=%lu",
+                               (unsigned int)stats.Slave_Address, (unsigned long)(stats.SCL_Frequency_Hz / 1000),
+                               (unsigned long)stats.Transfers, (unsigned long)stats.NACKs, (unsigned long)stats.Timeouts,
+                               (unsigned long)(stats.Max_Wait_Cycles / cycles_per_us), (unsigned long)(stats.Max_Transfer_Cycles / cycles_per_us));
+        I2C_Report_Output(line);
+    }
+
+    Print_Format_To_Buffer(line, sizeof(line), "ok i2c recoveries=%lu", (unsigned long)EUSCI_B1_I2C_Get_Recovery_Count());
+    I2C_Report_Output(line);
+
+    return 0;
+}
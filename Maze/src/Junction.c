@@ -0,0 +1,172 @@
+/**
+ * @file Junction.c
+ * @brief Source code for the Junction module.
+ *
+ * This file contains the function definitions for the Junction module.
+ * It classifies the cell around the robot from the three distances with hysteresis and a dwell time.
+ *
+ */
+
+#include "../inc/Junction.h"
+#include "../inc/Trace.h"
+
+// Types selected by the open sides, indexed by JUNCTION_OPEN_LEFT | JUNCTION_OPEN_FRONT | JUNCTION_OPEN_RIGHT
+static const Junction_Type Junction_Types[8] =
+{
+    JUNCTION_DEAD_END,          // None
+    JUNCTION_LEFT_OPENING,      // Left
+    JUNCTION_CORRIDOR,          // Front
+    JUNCTION_LEFT_OPENING,      // Left and front
+    JUNCTION_RIGHT_OPENING,     // Right
+    JUNCTION_T,                 // Left and right
+    JUNCTION_RIGHT_OPENING,     // Front and right
+    JUNCTION_CROSS              // Left, front, and right
+};
+
+// Accepted open sides and type
+static uint8_t Junction_Openings;
+static Junction_Type Junction_Current_Type;
+
+// Per side (left, front, right): number of consecutive updates beyond the hysteresis band that disagree
+// with the accepted state, and the odometry distance of the first one
+static uint8_t Junction_Change_Ticks[3];
+static int32_t Junction_Change_Distance_um[3];
+
+// Ring of the events, where Junction_Event_Head - Junction_Event_Tail events have not been read
+static Junction_Event Junction_Events[JUNCTION_EVENT_QUEUE_LENGTH];
+static uint32_t Junction_Event_Head;
+static uint32_t Junction_Event_Tail;
+static uint32_t Junction_Lost_Events;
+
+// Returns 1 if the distance of an open side is at or below the threshold, or if the distance of a closed side is
+// above threshold + JUNCTION_HYSTERESIS, so a distance just above the threshold does not toggle the side
+static uint8_t Junction_Side_Disagrees(uint8_t open, int32_t distance, int32_t threshold_mm)
+{
+    if (open)
+    {
+        return (distance <= threshold_mm);
+    }
+
+    return (distance > (threshold_mm + JUNCTION_HYSTERESIS));
+}
+
+static void Junction_Accept(uint8_t openings, int32_t distance_um)
+{
+    Junction_Event *event;
+
+    Junction_Openings = openings;
+    Junction_Current_Type = Junction_Types[openings];
+
+    // Replace the oldest event if the ring is full
+    if ((Junction_Event_Head - Junction_Event_Tail) >= JUNCTION_EVENT_QUEUE_LENGTH)
+    {
+        Junction_Event_Tail++;
+        Junction_Lost_Events++;
+    }
+
+    event = &Junction_Events[Junction_Event_Head & (JUNCTION_EVENT_QUEUE_LENGTH - 1)];
+    event->Type = Junction_Current_Type;
+    event->Openings = openings;
+    event->Distance_um = distance_um;
+    Junction_Event_Head++;
+
+    Trace_Record(TRACE_EVENT_JUNCTION, Junction_Current_Type | ((uint32_t)openings << 8), (uint32_t)distance_um);
+}
+
+void Junction_Init(void)
+{
+    int i;
+
+    Junction_Openings = 0;
+    Junction_Current_Type = JUNCTION_UNKNOWN;
+    for (i = 0; i < 3; i++)
+    {
+        Junction_Change_Ticks[i] = 0;
+        Junction_Change_Distance_um[i] = 0;
+    }
+    Junction_Event_Head = 0;
+    Junction_Event_Tail = 0;
+    Junction_Lost_Events = 0;
+}
+
+void Junction_Update(int32_t left, int32_t center, int32_t right, int32_t threshold_mm)
+{
+    const int32_t distances[3] = { left, center, right };
+    const uint8_t masks[3] = { JUNCTION_OPEN_LEFT, JUNCTION_OPEN_FRONT, JUNCTION_OPEN_RIGHT };
+    int32_t distance_um = Odometry_Get_Distance_um();
+    int32_t change_distance_um = distance_um;
+    uint8_t openings = Junction_Openings;
+    int i;
+
+    // The first update has no previous state for the hysteresis
+    if (Junction_Current_Type == JUNCTION_UNKNOWN)
+    {
+        openings = 0;
+        for (i = 0; i < 3; i++)
+        {
+            if (distances[i] > threshold_mm)
+            {
+                openings |= masks[i];
+            }
+        }
+        Junction_Accept(openings, distance_um);
+        return;
+    }
+
+    // Each side changes once it has disagreed with its state in JUNCTION_MIN_DWELL_TICKS consecutive updates,
+    // so the order in which the sides change is the order in which the sensors have seen them
+    for (i = 0; i < 3; i++)
+    {
+        if (Junction_Side_Disagrees(Junction_Openings & masks[i], distances[i], threshold_mm) == 0)
+        {
+            Junction_Change_Ticks[i] = 0;
+            continue;
+        }
+
+        if (Junction_Change_Ticks[i] == 0)
+        {
+            Junction_Change_Distance_um[i] = distance_um;
+        }
+        Junction_Change_Ticks[i]++;
+
+        if (Junction_Change_Ticks[i] >= JUNCTION_MIN_DWELL_TICKS)
+        {
+            openings ^= masks[i];
+            change_distance_um = Junction_Change_Distance_um[i];
+            Junction_Change_Ticks[i] = 0;
+        }
+    }
+
+    if (openings != Junction_Openings)
+    {
+        Junction_Accept(openings, change_distance_um);
+    }
+}
+
+Junction_Type Junction_Get_Type(void)
+{
+    return Junction_Current_Type;
+}
+
+uint8_t Junction_Get_Openings(void)
+{
+    return Junction_Openings;
+}
+
+int Junction_Get_Event(Junction_Event *event)
+{
+    if (Junction_Event_Head == Junction_Event_Tail)
+    {
+        return 0;
+    }
+
+    *event = Junction_Events[Junction_Event_Tail & (JUNCTION_EVENT_QUEUE_LENGTH - 1)];
+    Junction_Event_Tail++;
+
+    return 1;
+}
+
+uint32_t Junction_Get_Lost_Events(void)
+{
+    return Junction_Lost_Events;
+}
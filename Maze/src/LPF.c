@@ -1,6 +1,6 @@
 // LPF.c
 // Runs on MSP432
-// implements three FIR low-pass filters
+// implements reentrant FIR low-pass filters
 
 // Jonathan Valvano
 // September 12, 2017
@@ -43,172 +43,164 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "msp.h"
 #include "../inc/LPF.h"
 
-// Newton's method
+// digit-by-digit square root, one result bit per iteration
 // s is an integer
-// sqrt(s) is an integer
+// floor(sqrt(s)) is an integer
 uint32_t isqrt(uint32_t s){
-uint32_t t;         // t*t will become s
-int n;                   // loop counter to make sure it stops running
-  t = s/10+1;            // initial guess
-  for(n = 16; n; --n){   // guaranteed to finish
-    t = ((t*t+s)/t)/2;
+uint32_t t = 0;          // result
+uint32_t bit = 1u<<30;   // highest power of four that fits in 32 bits
+  while(bit > s){
+    bit >>= 2;
+  }
+  while(bit){            // at most 16 iterations
+    if(s >= t+bit){
+      s = s-(t+bit);
+      t = (t>>1)+bit;
+    } else{
+      t = t>>1;
+    }
+    bit >>= 2;
   }
   return t;
 }
 
 //**************Low pass Digital filter**************
-uint32_t Size;      // Size-point average, Size=1 to 512
-uint32_t x[1024];   // two copies of MACQ
-uint32_t *Pt;       // pointer to current
-uint32_t I1;        // index to oldest
-uint32_t LPFSum;    // sum of the last Size samples
-void LPF_Init_old(uint32_t initial, uint32_t size){ int i;
-  if(size>512) size=512; // max
-  Size = size;
-  Pt = &x[0];
-  LPFSum = Size*initial; // prime MACQ with initial data
-  for(i=0; i<2*Size; i++){
-    x[i] = initial;
-  }
-}
-// calculate one filter output, called at sampling rate
-// Input: new ADC data   Output: filter output
-// y(n) = (x(n)+x(n-1)+...+x(n-Size-1)/Size
-uint32_t LPF_Calc_old(uint32_t newdata){
-  if(Pt == &x[0]){
-    Pt = &x[Size-1];              // wrap
-  } else{
-    Pt--;                         // make room for data
+void LPF_Filter_Init(LPF_Filter *filter, uint32_t *buffer, uint32_t size, uint32_t channels, const uint32_t initial[]){
+  uint32_t i,j;
+  if(size>LPF_MAX_SIZE) size=LPF_MAX_SIZE; // max
+  if(size<1) size=1;
+  if(channels>LPF_MAX_CHANNELS) channels=LPF_MAX_CHANNELS;
+  filter->Buffer = buffer;
+  filter->Size = size;
+  filter->Channels = channels;
+  filter->Index = 0;
+  filter->Shift = LPF_NO_SHIFT;
+  if((size&(size-1)) == 0){      // power of two, use a shift instead of a divide
+    filter->Shift = 0;
+    while((1u<<filter->Shift) < size){
+      filter->Shift++;
+    }
   }
-  LPFSum = LPFSum+newdata -*Pt;   // subtract oldest, add newest
-  *Pt = *(Pt+Size) = newdata;     // two copies of the new data
-  return LPFSum/Size;
-}
-
-void LPF_Init(uint32_t initial, uint32_t size){ int i;
-  if(size>1024) size=1024; // max
-  Size = size;
-  I1 = Size-1;
-  LPFSum = Size*initial; // prime MACQ with initial data
-  for(i=0; i<Size; i++){
-    x[i] = initial;
+  for(j=0; j<channels; j++){
+    filter->Sum[j] = size*initial[j]; // prime MACQ with initial data
+    filter->SumSq[j] = (uint64_t)size*initial[j]*initial[j];
+    for(i=0; i<size; i++){
+      buffer[i*channels+j] = initial[j];
+    }
   }
 }
 // calculate one filter output, called at sampling rate
 // Input: new ADC data   Output: filter output
 // y(n) = (x(n)+x(n-1)+...+x(n-Size-1)/Size
-uint32_t LPF_Calc(uint32_t newdata){
-  if(I1 == 0){
-    I1 = Size-1;              // wrap
-  } else{
-    I1--;                     // make room for data
+uint32_t LPF_Filter_Calc(LPF_Filter *filter, uint32_t newdata){
+  uint32_t *oldest = &filter->Buffer[filter->Index];
+  filter->Sum[0] = filter->Sum[0]+newdata-*oldest; // subtract oldest, add newest
+  filter->SumSq[0] = filter->SumSq[0]+newdata*newdata-(uint64_t)(*oldest * *oldest);
+  *oldest = newdata;                               // save new data
+  filter->Index++;
+  if(filter->Index == filter->Size){
+    filter->Index = 0;                             // wrap
+  }
+  if(filter->Shift != LPF_NO_SHIFT){
+    return filter->Sum[0]>>filter->Shift;
   }
-  LPFSum = LPFSum+newdata-x[I1];   // subtract oldest, add newest
-  x[I1] = newdata;     // save new data
-  return LPFSum/Size;
+  return filter->Sum[0]/filter->Size;
 }
-// calculate noise as standard deviation, called every time buffer refills
-// Input: none   Output: standard deviation
-int32_t Noise(void){ int32_t sum,mean,sigma;
-  if(Size<2) return 0;
-  sum = 0;
-  for(int i=0;i<Size;i++){
-    sum = sum+x[i];
+// calculate one filter output of every channel, called at sampling rate
+// Input: new ADC data of each channel   Output: filter output of each channel
+void LPF_Filter_Calc_All(LPF_Filter *filter, const uint32_t newdata[], uint32_t result[]){
+  uint32_t j;
+  uint32_t channels = filter->Channels;
+  uint32_t *oldest = &filter->Buffer[filter->Index*channels];
+  for(j=0; j<channels; j++){
+    filter->Sum[j] = filter->Sum[j]+newdata[j]-oldest[j]; // subtract oldest, add newest
+    filter->SumSq[j] = filter->SumSq[j]+newdata[j]*newdata[j]-(uint64_t)(oldest[j]*oldest[j]);
+    oldest[j] = newdata[j];                               // save new data
   }
-  mean = sum/Size; // DC component
-  sum = 0;
-  for(int i=0;i<Size;i++){
-    sum = sum+(x[i]-mean)*(x[i]-mean); // total energy in AC part
+  filter->Index++;
+  if(filter->Index == filter->Size){
+    filter->Index = 0;                                    // wrap
   }
-  sigma = isqrt(sum/(Size-1));
-//  snr = mean/sigma;
-  return sigma;
-}
-
-uint32_t x2[1024];   // two copies of MACQ
-uint32_t *Pt2;       // pointer to current
-uint32_t LPFSum2;    // sum of the last Size samples
-void LPF_Init2(uint32_t initial, uint32_t size){ int i;
-  if(size>512) size=512; // max
-  Size = size;
-  Pt2 = &x2[0];
-  LPFSum2 = Size*initial; // prime MACQ with initial data
-  for(i=0; i<2*Size; i++){
-    x2[i] = initial;
+  if(filter->Shift != LPF_NO_SHIFT){
+    for(j=0; j<channels; j++){
+      result[j] = filter->Sum[j]>>filter->Shift;
+    }
+  } else{
+    for(j=0; j<channels; j++){
+      result[j] = filter->Sum[j]/filter->Size;
+    }
   }
 }
-// calculate one filter output, called at sampling rate
-// Input: new ADC data   Output: filter output, DAC data
-// y(n) = (x(n)+x(n-1)+...+x(n-Size-1)/Size
-uint32_t LPF_Calc2(uint32_t newdata){
-  if(Pt2 == &x2[0]){
-    Pt2 = &x2[Size-1];              // wrap
+// calculate the variance from the running sums, O(1) per call
+// Input: channel   Output: sum((x-mean)^2)/(Size-1)
+// sum((x-mean)^2) = SumSq - Sum*Sum/Size
+uint32_t LPF_Filter_Variance(const LPF_Filter *filter, uint32_t channel){
+  uint32_t size = filter->Size;
+  uint64_t sum = filter->Sum[channel];
+  uint64_t energy;
+  if(size<2) return 0;
+  if(filter->Shift != LPF_NO_SHIFT){
+    energy = filter->SumSq[channel]-((sum*sum)>>filter->Shift);
   } else{
-    Pt2--;                         // make room for data
+    energy = filter->SumSq[channel]-(sum*sum)/size;
   }
-  LPFSum2 = LPFSum2+newdata -*Pt2;   // subtract oldest, add newest
-  *Pt2 = *(Pt2+Size) = newdata;     // two copies of the new data
-  return LPFSum2/Size;
-}
-// calculate noise as standard deviation, called every time buffer refills
-// Input: none   Output: standard deviation
-int32_t Noise2(void){ int32_t sum,mean,sigma2;
-  if(Size<2) return 0;
-  sum = 0;
-  for(int i=0;i<Size;i++){
-    sum = sum+x2[i];
+  if((energy>>32) == 0){
+    return (uint32_t)energy/(size-1); // usual case, 32-bit divide
   }
-  mean = sum/Size; // DC component
-  sum = 0;
-  for(int i=0;i<Size;i++){
-    sum = sum+(x2[i]-mean)*(x2[i]-mean); // total energy in AC part
+  return energy/(size-1);
+}
+// calculate noise as standard deviation, O(1) per call
+// Input: channel   Output: standard deviation
+int32_t LPF_Filter_Noise(const LPF_Filter *filter, uint32_t channel){
+  return isqrt(LPF_Filter_Variance(filter, channel));
+}
+// calculate noise of every channel
+// Input: none   Output: standard deviation of each channel
+void LPF_Filter_Noise_All(const LPF_Filter *filter, uint32_t result[]){
+  uint32_t j;
+  for(j=0; j<filter->Channels; j++){
+    result[j] = isqrt(LPF_Filter_Variance(filter, j));
   }
-  sigma2 = isqrt(sum/(Size-1));
-//  snr2 = mean/sigma2;
-  return sigma2;
 }
 
-uint32_t x3[1024];   // two copies of MACQ
-uint32_t *Pt3;       // pointer to current
-uint32_t LPFSum3;    // sum of the last Size samples
-void LPF_Init3(uint32_t initial, uint32_t size){ int i;
-  if(size>512) size=512; // max
-  Size = size;
-  Pt3 = &x3[0];
-  LPFSum3 = Size*initial; // prime MACQ with initial data
-  for(i=0; i<2*Size; i++){
-    x3[i] = initial;
+//**************Median-of-5 pre-filter**************
+void LPF_Median_Init(LPF_Median *median, uint32_t channels, const uint32_t initial[]){
+  uint32_t i,j;
+  if(channels>LPF_MAX_CHANNELS) channels=LPF_MAX_CHANNELS;
+  median->Channels = channels;
+  median->Index = 0;
+  for(j=0; j<channels; j++){
+    for(i=0; i<LPF_MEDIAN_SIZE; i++){
+      median->History[j][i] = initial[j];
+    }
   }
 }
-// calculate one filter output, called at sampling rate
-// Input: new ADC data   Output: filter output, DAC data
-// y(n) = (x(n)+x(n-1)+...+x(n-Size-1)/Size
-uint32_t LPF_Calc3(uint32_t newdata){
-  if(Pt3 == &x3[0]){
-    Pt3 = &x3[Size-1];              // wrap
-  } else{
-    Pt3--;                         // make room for data
-  }
-  LPFSum3 = LPFSum3+newdata -*Pt3;   // subtract oldest, add newest
-  *Pt3 = *(Pt3+Size) = newdata;     // two copies of the new data
-  return LPFSum3/Size;
+#define LPF_SWAP(x,y) {uint32_t t=(x); (x)=(y); (y)=t;}
+// median of five values in 6 comparisons
+// each step drops a value that is smaller than three others, so it cannot be the median
+static uint32_t LPF_Median5(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e){
+  if(b<a) LPF_SWAP(a,b);             // a<=b
+  if(d<c) LPF_SWAP(c,d);             // c<=d
+  if(c<a){LPF_SWAP(a,c); LPF_SWAP(b,d);} // a<=c<=d and a<=b, drop a
+  a = e;
+  if(b<a) LPF_SWAP(a,b);             // a<=b
+  if(c<a){LPF_SWAP(a,c); LPF_SWAP(b,d);} // a is smaller than b, c, d, drop a
+  return (b<c) ? b : c;              // smallest of the three remaining values
 }
-// calculate noise as standard deviation, called every time buffer refills
-// Input: none   Output: standard deviation
-int32_t Noise3(void){ int32_t sum,mean,sigma3;
-  if(Size<2) return 0;
-  sum = 0;
-  for(int i=0;i<Size;i++){
-    sum = sum+x3[i];
+// calculate one median output of every channel, called at sampling rate
+// Input: new ADC data of each channel   Output: median of the last 5 samples of each channel
+void LPF_Median_Calc_All(LPF_Median *median, const uint32_t newdata[], uint32_t result[]){
+  uint32_t j;
+  uint32_t *h;
+  for(j=0; j<median->Channels; j++){
+    h = median->History[j];
+    h[median->Index] = newdata[j];       // replace the oldest sample
+    result[j] = LPF_Median5(h[0], h[1], h[2], h[3], h[4]);
   }
-  mean = sum/Size; // DC component
-  sum = 0;
-  for(int i=0;i<Size;i++){
-    sum = sum+(x3[i]-mean)*(x3[i]-mean); // total energy in AC part
+  median->Index++;
+  if(median->Index == LPF_MEDIAN_SIZE){
+    median->Index = 0;                   // wrap
   }
-  sigma3 = isqrt(sum/(Size-1));
-//  snr3 = mean/sigma3;
-  return sigma3;
 }
 
 int32_t u1,u2,u3;   // last three points
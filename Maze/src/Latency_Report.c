@@ -0,0 +1,71 @@
+/**
+ * @file Latency_Report.c
+ * @brief Source code for the Latency_Report module.
+ *
+ * This file contains the function definitions for the Latency_Report module.
+ * It arms and cancels the latency measurements, and reports the measured latency in cycles and us.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Latency_Report.h"
+#include "../inc/Print_Format.h"
+
+// Function that sends a reply line
+static void (*Latency_Report_Output)(const char *line);
+
+void Latency_Report_Init(void (*output)(const char *line))
+{
+    Latency_Report_Output = output;
+}
+
+int Latency_Report_Command(char **arguments, uint8_t argument_count)
+{
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+    int32_t distances[3];
+    uint32_t latency_cycles;
+    int i;
+
+    if ((argument_count == 0) || (strcmp(arguments[0], "latency") != 0))
+    {
+        return -1;
+    }
+
+    if (argument_count == 1)
+    {
+        if (Latency_Test_Get_Result(&latency_cycles) == 0)
+        {
+            Print_Format_To_Buffer(line, sizeof(line), "latency cycles=%lu us=%lu strategy=%s", (unsigned long)latency_cycles,
+                     (unsigned long)(latency_cycles / (Clock_GetFreq() / 1000000)), Route_Race_Get_Name(Route_Race_Get_Current()));
+        }
+        else
+        {
+            Print_Format_To_Buffer(line, sizeof(line), "latency state=%u", (unsigned int)Latency_Test_Get_State());
+        }
+        Latency_Report_Output(line);
+    }
+    else if ((argument_count == 2) && (strcmp(arguments[1], "cancel") == 0))
+    {
+        Latency_Test_Cancel();
+        Latency_Report_Output("ok latency cancel");
+    }
+    else if ((argument_count == 5) && (strcmp(arguments[1], "inject") == 0))
+    {
+        for (i = 0; i < 3; i++)
+        {
+            if (Parameters_Parse_Value(arguments[i + 2], &distances[i]) != 0)
+            {
+                Latency_Report_Output("err value");
+                return 0;
+            }
+        }
+        Latency_Test_Arm(distances[0], distances[1], distances[2]);
+        Latency_Report_Output("ok latency inject");
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
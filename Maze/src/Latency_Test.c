@@ -0,0 +1,108 @@
+/**
+ * @file Latency_Test.c
+ * @brief Source code for the Latency_Test module.
+ *
+ * This file contains the function definitions for the Latency_Test module.
+ * It injects synthetic distances and measures the time until the resulting motor command.
+ *
+ */
+
+#include "../inc/Latency_Test.h"
+
+static volatile Latency_Test_State Latency_Test_Current_State = LATENCY_TEST_IDLE;
+
+// Synthetic distances in the channel order of the sensors (right, center, left)
+static int32_t Latency_Test_Distances[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+
+// Cycle count of the first injected set, and measured latency
+static uint32_t Latency_Test_Inject_Cycles;
+static uint32_t Latency_Test_Latency_Cycles;
+
+void Latency_Test_Init(void)
+{
+    Latency_Test_Current_State = LATENCY_TEST_IDLE;
+    Latency_Test_Inject_Cycles = 0;
+    Latency_Test_Latency_Cycles = 0;
+}
+
+void Latency_Test_Arm(int32_t left, int32_t center, int32_t right)
+{
+    // Stop the injection first, so the filter interrupt never sees a partial set of distances
+    Latency_Test_Current_State = LATENCY_TEST_IDLE;
+
+    Latency_Test_Distances[0] = right;
+    Latency_Test_Distances[1] = center;
+    Latency_Test_Distances[2] = left;
+
+    Latency_Test_Current_State = LATENCY_TEST_ARMED;
+}
+
+void Latency_Test_Cancel(void)
+{
+    if (Latency_Test_Current_State != LATENCY_TEST_DONE)
+    {
+        Latency_Test_Current_State = LATENCY_TEST_IDLE;
+    }
+}
+
+void Latency_Test_Apply(int32_t converted[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS])
+{
+    int i;
+
+    if ((Latency_Test_Current_State != LATENCY_TEST_ARMED) && (Latency_Test_Current_State != LATENCY_TEST_WAITING))
+    {
+        return;
+    }
+
+    for (i = 0; i < ANALOG_DISTANCE_SENSOR_NUM_CHANNELS; i++)
+    {
+        converted[i] = Latency_Test_Distances[i];
+    }
+
+    // Distance_Source_Update_Sharp timestamps the set after this point, so it is not older than the injection
+    if (Latency_Test_Current_State == LATENCY_TEST_ARMED)
+    {
+        Latency_Test_Inject_Cycles = CycleCounter_Read();
+        Latency_Test_Current_State = LATENCY_TEST_WAITING;
+    }
+}
+
+void Latency_Test_Motor_Command(void)
+{
+    uint32_t now;
+    uint32_t timestamp_cycles;
+
+    if (Latency_Test_Current_State != LATENCY_TEST_WAITING)
+    {
+        return;
+    }
+
+    now = CycleCounter_Read();
+
+    // A command computed from the distances read before the injection is not the reaction to them
+    Distance_Source_Get_Sharp_Timestamp(&timestamp_cycles);
+    if ((int32_t)(timestamp_cycles - Latency_Test_Inject_Cycles) < 0)
+    {
+        return;
+    }
+
+    Latency_Test_Latency_Cycles = now - Latency_Test_Inject_Cycles;
+    Latency_Test_Current_State = LATENCY_TEST_DONE;
+}
+
+Latency_Test_State Latency_Test_Get_State(void)
+{
+    return Latency_Test_Current_State;
+}
+
+int Latency_Test_Get_Result(uint32_t *latency_cycles)
+{
+    if (Latency_Test_Current_State != LATENCY_TEST_DONE)
+    {
+        return -1;
+    }
+
+    *latency_cycles = Latency_Test_Latency_Cycles;
+
+    return 0;
+}
@@ -0,0 +1,655 @@
+/**
+ * @file Maze_Map.c
+ * @brief Source code for the Maze_Map driver.
+ *
+ * This file contains the function definitions for the Maze_Map driver.
+ * It stores the walls of the maze discovered by the robot in a bit-packed grid (4 bits per cell)
+ * and computes the flood-fill distance of every cell to the goal cells.
+ *
+ */
+
+#include "../inc/Maze_Map.h"
+
+// Wall bits of the cells, two cells per byte
+static uint8_t Maze_Map_Walls[MAZE_MAP_NUM_CELLS / 2];
+
+// Visited flags of the cells, eight cells per byte
+static uint8_t Maze_Map_Visited[MAZE_MAP_NUM_CELLS / 8];
+
+// Flood-fill distance of every cell to the nearest goal cell
+static uint8_t Maze_Map_Distance[MAZE_MAP_NUM_CELLS];
+
+// Breadth-first search queue of cell indices
+// Note: Each cell is queued at most once per flood fill, so the queue never wraps
+static uint8_t Maze_Map_Queue[MAZE_MAP_NUM_CELLS];
+static uint16_t Maze_Map_Queue_Head;
+static uint16_t Maze_Map_Queue_Tail;
+
+// Circular repair queue of cell indices and the flags of the cells that are in it
+static uint8_t Maze_Map_Repair_Queue[MAZE_MAP_NUM_CELLS];
+static uint8_t Maze_Map_Repair_Queued[MAZE_MAP_NUM_CELLS / 8];
+static uint16_t Maze_Map_Repair_Head;
+static uint16_t Maze_Map_Repair_Tail;
+static uint16_t Maze_Map_Repair_Count;
+static uint16_t Maze_Map_Repair_Processed;
+
+// Planning state of the distances
+#define MAZE_MAP_STATE_INVALID      0
+#define MAZE_MAP_STATE_FLOOD_FILL   1
+#define MAZE_MAP_STATE_REPAIR       2
+#define MAZE_MAP_STATE_VALID        3
+static uint8_t Maze_Map_State;
+
+// Measurements of the calls of Maze_Map_Replan_Step
+static uint16_t Maze_Map_Last_Update_Cells;
+static uint32_t Maze_Map_Last_Update_Cycles;
+static uint32_t Maze_Map_Max_Update_Cycles;
+
+// Goal cells
+static uint8_t Maze_Map_Goals[MAZE_MAP_MAX_GOALS];
+static uint8_t Maze_Map_Num_Goals;
+
+static uint8_t Maze_Map_Get_Cell_Walls(uint8_t index)
+{
+    if (index & 0x01)
+    {
+        return (Maze_Map_Walls[index >> 1] >> 4) & 0x0F;
+    }
+
+    return Maze_Map_Walls[index >> 1] & 0x0F;
+}
+
+static void Maze_Map_Update_Cell_Walls(uint8_t index, uint8_t wall_bit, uint8_t present)
+{
+    // The cell with an odd index is stored in the upper 4 bits
+    if (index & 0x01)
+    {
+        wall_bit = wall_bit << 4;
+    }
+
+    if (present)
+    {
+        Maze_Map_Walls[index >> 1] |= wall_bit;
+    }
+    else
+    {
+        Maze_Map_Walls[index >> 1] &= ~wall_bit;
+    }
+}
+
+void Maze_Map_Init()
+{
+    uint8_t x;
+    uint8_t y;
+    uint16_t i;
+
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 2); i++)
+    {
+        Maze_Map_Walls[i] = 0;
+    }
+
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 8); i++)
+    {
+        Maze_Map_Visited[i] = 0;
+    }
+
+    for (i = 0; i < MAZE_MAP_NUM_CELLS; i++)
+    {
+        Maze_Map_Distance[i] = MAZE_MAP_UNREACHABLE;
+    }
+
+    // Close the border of the grid
+    for (x = 0; x < MAZE_MAP_WIDTH; x++)
+    {
+        Maze_Map_Update_Cell_Walls(MAZE_MAP_CELL_INDEX(x, 0), (1 << MAZE_SOUTH), 1);
+        Maze_Map_Update_Cell_Walls(MAZE_MAP_CELL_INDEX(x, MAZE_MAP_HEIGHT - 1), (1 << MAZE_NORTH), 1);
+    }
+
+    for (y = 0; y < MAZE_MAP_HEIGHT; y++)
+    {
+        Maze_Map_Update_Cell_Walls(MAZE_MAP_CELL_INDEX(0, y), (1 << MAZE_WEST), 1);
+        Maze_Map_Update_Cell_Walls(MAZE_MAP_CELL_INDEX(MAZE_MAP_WIDTH - 1, y), (1 << MAZE_EAST), 1);
+    }
+
+    Maze_Map_Queue_Head = 0;
+    Maze_Map_Queue_Tail = 0;
+
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 8); i++)
+    {
+        Maze_Map_Repair_Queued[i] = 0;
+    }
+    Maze_Map_Repair_Head = 0;
+    Maze_Map_Repair_Tail = 0;
+    Maze_Map_Repair_Count = 0;
+
+    Maze_Map_State = MAZE_MAP_STATE_INVALID;
+    Maze_Map_Last_Update_Cells = 0;
+    Maze_Map_Last_Update_Cycles = 0;
+    Maze_Map_Max_Update_Cycles = 0;
+}
+
+void Maze_Map_Clear_Goals()
+{
+    Maze_Map_Num_Goals = 0;
+    Maze_Map_State = MAZE_MAP_STATE_INVALID;
+}
+
+int Maze_Map_Add_Goal(uint8_t x, uint8_t y)
+{
+    if ((Maze_Map_Num_Goals >= MAZE_MAP_MAX_GOALS) || (x >= MAZE_MAP_WIDTH) || (y >= MAZE_MAP_HEIGHT))
+    {
+        return -1;
+    }
+
+    Maze_Map_Goals[Maze_Map_Num_Goals] = MAZE_MAP_CELL_INDEX(x, y);
+    Maze_Map_Num_Goals = Maze_Map_Num_Goals + 1;
+    Maze_Map_State = MAZE_MAP_STATE_INVALID;
+
+    return 0;
+}
+
+uint8_t Maze_Map_Is_Goal(uint8_t x, uint8_t y)
+{
+    uint8_t index = MAZE_MAP_CELL_INDEX(x, y);
+    uint8_t i;
+
+    for (i = 0; i < Maze_Map_Num_Goals; i++)
+    {
+        if (Maze_Map_Goals[i] == index)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t Maze_Map_Get_Goals(uint8_t *x, uint8_t *y)
+{
+    uint8_t i;
+
+    for (i = 0; i < Maze_Map_Num_Goals; i++)
+    {
+        x[i] = Maze_Map_Goals[i] % MAZE_MAP_WIDTH;
+        y[i] = Maze_Map_Goals[i] / MAZE_MAP_WIDTH;
+    }
+
+    return Maze_Map_Num_Goals;
+}
+
+int Maze_Map_Neighbor(uint8_t *x, uint8_t *y, Maze_Direction direction)
+{
+    switch (direction)
+    {
+        case MAZE_NORTH:
+        {
+            if (*y >= (MAZE_MAP_HEIGHT - 1))
+            {
+                return -1;
+            }
+            *y = *y + 1;
+        }
+        break;
+
+        case MAZE_EAST:
+        {
+            if (*x >= (MAZE_MAP_WIDTH - 1))
+            {
+                return -1;
+            }
+            *x = *x + 1;
+        }
+        break;
+
+        case MAZE_SOUTH:
+        {
+            if (*y == 0)
+            {
+                return -1;
+            }
+            *y = *y - 1;
+        }
+        break;
+
+        default:
+        {
+            if (*x == 0)
+            {
+                return -1;
+            }
+            *x = *x - 1;
+        }
+        break;
+    }
+
+    return 0;
+}
+
+uint8_t Maze_Map_Set_Wall(uint8_t x, uint8_t y, Maze_Direction direction, uint8_t present)
+{
+    uint8_t neighbor_x = x;
+    uint8_t neighbor_y = y;
+    uint8_t index = MAZE_MAP_CELL_INDEX(x, y);
+
+    if ((Maze_Map_Get_Cell_Walls(index) & (1 << direction)) == ((present ? 1 : 0) << direction))
+    {
+        return 0;
+    }
+
+    // The border walls stay closed
+    if (Maze_Map_Neighbor(&neighbor_x, &neighbor_y, direction) != 0)
+    {
+        return 0;
+    }
+
+    Maze_Map_Update_Cell_Walls(index, (1 << direction), present);
+    Maze_Map_Update_Cell_Walls(MAZE_MAP_CELL_INDEX(neighbor_x, neighbor_y), (1 << MAZE_DIRECTION_BACK(direction)), present);
+
+    return 1;
+}
+
+uint8_t Maze_Map_Get_Walls(uint8_t x, uint8_t y)
+{
+    return Maze_Map_Get_Cell_Walls(MAZE_MAP_CELL_INDEX(x, y));
+}
+
+uint8_t Maze_Map_Has_Wall(uint8_t x, uint8_t y, Maze_Direction direction)
+{
+    return (Maze_Map_Get_Cell_Walls(MAZE_MAP_CELL_INDEX(x, y)) >> direction) & 0x01;
+}
+
+void Maze_Map_Set_Visited(uint8_t x, uint8_t y)
+{
+    uint8_t index = MAZE_MAP_CELL_INDEX(x, y);
+
+    Maze_Map_Visited[index >> 3] |= (1 << (index & 0x07));
+}
+
+uint8_t Maze_Map_Is_Visited(uint8_t x, uint8_t y)
+{
+    uint8_t index = MAZE_MAP_CELL_INDEX(x, y);
+
+    return (Maze_Map_Visited[index >> 3] >> (index & 0x07)) & 0x01;
+}
+
+void Maze_Map_Export(uint8_t *buffer)
+{
+    uint16_t i;
+
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 2); i++)
+    {
+        buffer[i] = Maze_Map_Walls[i];
+    }
+
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 8); i++)
+    {
+        buffer[(MAZE_MAP_NUM_CELLS / 2) + i] = Maze_Map_Visited[i];
+    }
+}
+
+void Maze_Map_Import(const uint8_t *buffer)
+{
+    uint16_t i;
+
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 2); i++)
+    {
+        Maze_Map_Walls[i] = buffer[i];
+    }
+
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 8); i++)
+    {
+        Maze_Map_Visited[i] = buffer[(MAZE_MAP_NUM_CELLS / 2) + i];
+    }
+
+    // Drop the pending repair, the distances are recomputed by the next flood fill
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 8); i++)
+    {
+        Maze_Map_Repair_Queued[i] = 0;
+    }
+    Maze_Map_Repair_Head = 0;
+    Maze_Map_Repair_Tail = 0;
+    Maze_Map_Repair_Count = 0;
+
+    Maze_Map_State = MAZE_MAP_STATE_INVALID;
+}
+
+void Maze_Map_Flood_Fill_Start()
+{
+    uint16_t i;
+
+    for (i = 0; i < MAZE_MAP_NUM_CELLS; i++)
+    {
+        Maze_Map_Distance[i] = MAZE_MAP_UNREACHABLE;
+    }
+
+    Maze_Map_Queue_Head = 0;
+    Maze_Map_Queue_Tail = 0;
+
+    // Discard a pending repair, the flood fill recomputes every distance
+    while (Maze_Map_Repair_Count > 0)
+    {
+        Maze_Map_Repair_Queued[Maze_Map_Repair_Queue[Maze_Map_Repair_Tail] >> 3] &= ~(1 << (Maze_Map_Repair_Queue[Maze_Map_Repair_Tail] & 0x07));
+        Maze_Map_Repair_Tail = (Maze_Map_Repair_Tail + 1) % MAZE_MAP_NUM_CELLS;
+        Maze_Map_Repair_Count = Maze_Map_Repair_Count - 1;
+    }
+    Maze_Map_State = MAZE_MAP_STATE_FLOOD_FILL;
+
+    for (i = 0; i < Maze_Map_Num_Goals; i++)
+    {
+        if (Maze_Map_Distance[Maze_Map_Goals[i]] != 0)
+        {
+            Maze_Map_Distance[Maze_Map_Goals[i]] = 0;
+            Maze_Map_Queue[Maze_Map_Queue_Head] = Maze_Map_Goals[i];
+            Maze_Map_Queue_Head = Maze_Map_Queue_Head + 1;
+        }
+    }
+}
+
+uint8_t Maze_Map_Flood_Fill_Step(uint16_t max_cells)
+{
+    uint8_t index;
+    uint8_t walls;
+    uint8_t x;
+    uint8_t y;
+    uint8_t neighbor_x;
+    uint8_t neighbor_y;
+    uint8_t neighbor;
+    uint8_t distance;
+    uint8_t direction;
+
+    while ((Maze_Map_Queue_Tail != Maze_Map_Queue_Head) && (max_cells > 0))
+    {
+        index = Maze_Map_Queue[Maze_Map_Queue_Tail];
+        Maze_Map_Queue_Tail = Maze_Map_Queue_Tail + 1;
+        max_cells = max_cells - 1;
+
+        walls = Maze_Map_Get_Cell_Walls(index);
+        distance = Maze_Map_Distance[index] + 1;
+        x = index % MAZE_MAP_WIDTH;
+        y = index / MAZE_MAP_WIDTH;
+
+        for (direction = MAZE_NORTH; direction <= MAZE_WEST; direction++)
+        {
+            // Walls that have not been observed are open
+            if (walls & (1 << direction))
+            {
+                continue;
+            }
+
+            neighbor_x = x;
+            neighbor_y = y;
+            Maze_Map_Neighbor(&neighbor_x, &neighbor_y, (Maze_Direction)direction);
+            neighbor = MAZE_MAP_CELL_INDEX(neighbor_x, neighbor_y);
+
+            if (Maze_Map_Distance[neighbor] == MAZE_MAP_UNREACHABLE)
+            {
+                Maze_Map_Distance[neighbor] = distance;
+                Maze_Map_Queue[Maze_Map_Queue_Head] = neighbor;
+                Maze_Map_Queue_Head = Maze_Map_Queue_Head + 1;
+            }
+        }
+    }
+
+    if (Maze_Map_Queue_Tail == Maze_Map_Queue_Head)
+    {
+        Maze_Map_State = MAZE_MAP_STATE_VALID;
+        return 1;
+    }
+
+    return 0;
+}
+
+void Maze_Map_Flood_Fill()
+{
+    Maze_Map_Flood_Fill_Start();
+    Maze_Map_Flood_Fill_Step(MAZE_MAP_FLOOD_FILL_MAX_STEPS);
+}
+
+uint8_t Maze_Map_Get_Distance(uint8_t x, uint8_t y)
+{
+    return Maze_Map_Distance[MAZE_MAP_CELL_INDEX(x, y)];
+}
+
+int Maze_Map_Best_Direction(uint8_t x, uint8_t y, Maze_Direction preferred, Maze_Direction *direction)
+{
+    uint8_t walls = Maze_Map_Get_Walls(x, y);
+    uint8_t best_distance = Maze_Map_Get_Distance(x, y);
+    uint8_t neighbor_x;
+    uint8_t neighbor_y;
+    uint8_t distance;
+    uint8_t i;
+    Maze_Direction candidate;
+    int result = -1;
+
+    // Check the preferred direction first so that it wins a tie
+    for (i = 0; i < 4; i++)
+    {
+        candidate = (Maze_Direction)((preferred + i) & 0x3);
+
+        if (walls & (1 << candidate))
+        {
+            continue;
+        }
+
+        neighbor_x = x;
+        neighbor_y = y;
+        if (Maze_Map_Neighbor(&neighbor_x, &neighbor_y, candidate) != 0)
+        {
+            continue;
+        }
+
+        distance = Maze_Map_Get_Distance(neighbor_x, neighbor_y);
+        if (distance < best_distance)
+        {
+            best_distance = distance;
+            *direction = candidate;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static void Maze_Map_Queue_Repair(uint8_t index)
+{
+    // A cell that is already waiting is not queued twice, so the queue holds at most one entry per cell
+    if (Maze_Map_Repair_Queued[index >> 3] & (1 << (index & 0x07)))
+    {
+        return;
+    }
+
+    Maze_Map_Repair_Queued[index >> 3] |= (1 << (index & 0x07));
+    Maze_Map_Repair_Queue[Maze_Map_Repair_Head] = index;
+    Maze_Map_Repair_Head = (Maze_Map_Repair_Head + 1) % MAZE_MAP_NUM_CELLS;
+    Maze_Map_Repair_Count = Maze_Map_Repair_Count + 1;
+}
+
+static void Maze_Map_Queue_Open_Neighbors(uint8_t index)
+{
+    uint8_t walls = Maze_Map_Get_Cell_Walls(index);
+    uint8_t x = index % MAZE_MAP_WIDTH;
+    uint8_t y = index / MAZE_MAP_WIDTH;
+    uint8_t neighbor_x;
+    uint8_t neighbor_y;
+    uint8_t direction;
+
+    for (direction = MAZE_NORTH; direction <= MAZE_WEST; direction++)
+    {
+        if ((walls & (1 << direction)) == 0)
+        {
+            neighbor_x = x;
+            neighbor_y = y;
+            Maze_Map_Neighbor(&neighbor_x, &neighbor_y, (Maze_Direction)direction);
+            Maze_Map_Queue_Repair(MAZE_MAP_CELL_INDEX(neighbor_x, neighbor_y));
+        }
+    }
+}
+
+static uint8_t Maze_Map_Repair_Cells(uint16_t max_cells)
+{
+    uint8_t index;
+    uint8_t walls;
+    uint8_t x;
+    uint8_t y;
+    uint8_t neighbor_x;
+    uint8_t neighbor_y;
+    uint8_t direction;
+    uint8_t neighbor_distance;
+    uint8_t distance;
+    uint16_t processed = 0;
+
+    while ((Maze_Map_Repair_Count > 0) && (processed < max_cells))
+    {
+        index = Maze_Map_Repair_Queue[Maze_Map_Repair_Tail];
+        Maze_Map_Repair_Tail = (Maze_Map_Repair_Tail + 1) % MAZE_MAP_NUM_CELLS;
+        Maze_Map_Repair_Count = Maze_Map_Repair_Count - 1;
+        Maze_Map_Repair_Queued[index >> 3] &= ~(1 << (index & 0x07));
+        processed = processed + 1;
+
+        // The distance of a goal cell is always 0
+        if (Maze_Map_Distance[index] == 0)
+        {
+            continue;
+        }
+
+        // The consistent distance is 1 + the smallest distance of the open neighbors
+        walls = Maze_Map_Get_Cell_Walls(index);
+        x = index % MAZE_MAP_WIDTH;
+        y = index / MAZE_MAP_WIDTH;
+        distance = MAZE_MAP_UNREACHABLE;
+
+        for (direction = MAZE_NORTH; direction <= MAZE_WEST; direction++)
+        {
+            if (walls & (1 << direction))
+            {
+                continue;
+            }
+
+            neighbor_x = x;
+            neighbor_y = y;
+            Maze_Map_Neighbor(&neighbor_x, &neighbor_y, (Maze_Direction)direction);
+            neighbor_distance = Maze_Map_Distance[MAZE_MAP_CELL_INDEX(neighbor_x, neighbor_y)];
+
+            if ((neighbor_distance < MAZE_MAP_UNREACHABLE) && ((neighbor_distance + 1) < distance))
+            {
+                distance = neighbor_distance + 1;
+            }
+        }
+
+        // Only a cell that has changed affects its neighbors
+        if (distance != Maze_Map_Distance[index])
+        {
+            Maze_Map_Distance[index] = distance;
+            Maze_Map_Queue_Open_Neighbors(index);
+        }
+    }
+
+    Maze_Map_Repair_Processed = Maze_Map_Repair_Processed + processed;
+    Maze_Map_Last_Update_Cells = processed;
+
+    return (Maze_Map_Repair_Count == 0);
+}
+
+uint8_t Maze_Map_Update_Wall(uint8_t x, uint8_t y, Maze_Direction direction, uint8_t present)
+{
+    uint8_t neighbor_x = x;
+    uint8_t neighbor_y = y;
+
+    if (Maze_Map_Set_Wall(x, y, direction, present) == 0)
+    {
+        return 0;
+    }
+
+    if ((Maze_Map_State == MAZE_MAP_STATE_VALID) || (Maze_Map_State == MAZE_MAP_STATE_REPAIR))
+    {
+        // Only the two cells on each side of the wall can become inconsistent
+        if (Maze_Map_State == MAZE_MAP_STATE_VALID)
+        {
+            Maze_Map_Repair_Processed = 0;
+        }
+        Maze_Map_Queue_Repair(MAZE_MAP_CELL_INDEX(x, y));
+        Maze_Map_Neighbor(&neighbor_x, &neighbor_y, direction);
+        Maze_Map_Queue_Repair(MAZE_MAP_CELL_INDEX(neighbor_x, neighbor_y));
+        Maze_Map_State = MAZE_MAP_STATE_REPAIR;
+    }
+    else
+    {
+        // A flood fill in progress may have already used the old wall, so start it again
+        Maze_Map_State = MAZE_MAP_STATE_INVALID;
+    }
+
+    return 1;
+}
+
+uint8_t Maze_Map_Replan_Step(uint16_t max_cells)
+{
+    uint32_t start_cycles = CycleCounter_Read();
+    uint16_t queue_tail = Maze_Map_Queue_Tail;
+
+    switch (Maze_Map_State)
+    {
+        case MAZE_MAP_STATE_INVALID:
+        {
+            Maze_Map_Flood_Fill_Start();
+            queue_tail = Maze_Map_Queue_Tail;
+            Maze_Map_Flood_Fill_Step(max_cells);
+            Maze_Map_Last_Update_Cells = Maze_Map_Queue_Tail - queue_tail;
+        }
+        break;
+
+        case MAZE_MAP_STATE_FLOOD_FILL:
+        {
+            Maze_Map_Flood_Fill_Step(max_cells);
+            Maze_Map_Last_Update_Cells = Maze_Map_Queue_Tail - queue_tail;
+        }
+        break;
+
+        case MAZE_MAP_STATE_REPAIR:
+        {
+            if (Maze_Map_Repair_Cells(max_cells))
+            {
+                Maze_Map_State = MAZE_MAP_STATE_VALID;
+            }
+            else if (Maze_Map_Repair_Processed > MAZE_MAP_REPAIR_LIMIT)
+            {
+                // The repair counts up in a region that has been cut off, a flood fill is cheaper
+                Maze_Map_State = MAZE_MAP_STATE_INVALID;
+            }
+        }
+        break;
+
+        default:
+        {
+            Maze_Map_Last_Update_Cells = 0;
+        }
+        break;
+    }
+
+    Maze_Map_Last_Update_Cycles = CycleCounter_Read() - start_cycles;
+    if (Maze_Map_Last_Update_Cycles > Maze_Map_Max_Update_Cycles)
+    {
+        Maze_Map_Max_Update_Cycles = Maze_Map_Last_Update_Cycles;
+    }
+
+    return (Maze_Map_State == MAZE_MAP_STATE_VALID);
+}
+
+uint8_t Maze_Map_Is_Planned()
+{
+    return (Maze_Map_State == MAZE_MAP_STATE_VALID);
+}
+
+uint16_t Maze_Map_Get_Last_Update_Cells()
+{
+    return Maze_Map_Last_Update_Cells;
+}
+
+uint32_t Maze_Map_Get_Last_Update_Cycles()
+{
+    return Maze_Map_Last_Update_Cycles;
+}
+
+uint32_t Maze_Map_Get_Max_Update_Cycles()
+{
+    return Maze_Map_Max_Update_Cycles;
+}
@@ -0,0 +1,319 @@
+/**
+ * @file Maze_Map_Pack.c
+ * @brief Source code for the Maze_Map_Pack module.
+ *
+ * This file contains the function definitions for the Maze_Map_Pack module.
+ * It packs the interior walls of a map into one bit each, with the metadata and a CRC-16.
+ *
+ */
+
+#include "../inc/Maze_Map_Pack.h"
+
+#if (MAZE_MAP_WIDTH > 16) || (MAZE_MAP_HEIGHT > 16)
+#error "The goal cells of a packed map store each coordinate in 4 bits"
+#endif
+
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF), the CRC of the Telemetry frames
+static uint16_t Maze_Map_Pack_CRC16(const uint8_t *data, uint16_t length)
+{
+    uint16_t crc = 0xFFFF;
+    uint16_t i;
+    uint8_t bit;
+
+    for (i = 0; i < length; i++)
+    {
+        crc = crc ^ ((uint16_t)data[i] << 8);
+        for (bit = 0; bit < 8; bit++)
+        {
+            if (crc & 0x8000)
+            {
+                crc = (uint16_t)((crc << 1) ^ 0x1021);
+            }
+            else
+            {
+                crc = (uint16_t)(crc << 1);
+            }
+        }
+    }
+
+    return crc;
+}
+
+// Wall bits of a cell of a map in the format of Maze_Map_Export
+static uint8_t Maze_Map_Pack_Get_Cell_Walls(const uint8_t *map, uint8_t index)
+{
+    if (index & 0x01)
+    {
+        return (map[index >> 1] >> 4) & 0x0F;
+    }
+
+    return map[index >> 1] & 0x0F;
+}
+
+// Clears a wall bit of a cell of a map in the format of Maze_Map_Import
+static void Maze_Map_Pack_Clear_Cell_Wall(uint8_t *map, uint8_t index, Maze_Direction direction)
+{
+    uint8_t wall_bit = (uint8_t)(1 << direction);
+
+    if (index & 0x01)
+    {
+        wall_bit = wall_bit << 4;
+    }
+
+    map[index >> 1] &= ~wall_bit;
+}
+
+static uint8_t Maze_Map_Pack_Get_Bit(const uint8_t *bits, uint16_t position)
+{
+    return (bits[position >> 3] >> (position & 0x07)) & 0x01;
+}
+
+static void Maze_Map_Pack_Set_Bit(uint8_t *bits, uint16_t position)
+{
+    bits[position >> 3] |= (uint8_t)(1 << (position & 0x07));
+}
+
+int Maze_Map_Pack_Get_Length(const uint8_t *buffer, uint16_t length)
+{
+    uint8_t width;
+    uint8_t height;
+
+    if ((length < MAZE_MAP_PACK_HEADER_SIZE) || (buffer[0] != MAZE_MAP_PACK_MAGIC_0) || (buffer[1] != MAZE_MAP_PACK_MAGIC_1) ||
+        (buffer[2] != MAZE_MAP_PACK_VERSION))
+    {
+        return -1;
+    }
+
+    width = buffer[3];
+    height = buffer[4];
+    if ((width == 0) || (width > MAZE_MAP_WIDTH) || (height == 0) || (height > MAZE_MAP_HEIGHT) || (buffer[6] > MAZE_MAP_MAX_GOALS))
+    {
+        return -1;
+    }
+
+    return MAZE_MAP_PACK_SIZE(width, height, buffer[6], buffer[5]);
+}
+
+int Maze_Map_Pack_Encode(const uint8_t *map, const Maze_Map_Pack_Info *info, uint8_t *buffer, uint16_t buffer_size)
+{
+    uint8_t width = info->Width;
+    uint8_t height = info->Height;
+    uint16_t length;
+    uint16_t position;
+    uint16_t offset;
+    uint16_t crc;
+    uint8_t *bits;
+    uint8_t index;
+    uint8_t x;
+    uint8_t y;
+    uint8_t i;
+
+    if ((width == 0) || (width > MAZE_MAP_WIDTH) || (height == 0) || (height > MAZE_MAP_HEIGHT) || (info->Num_Goals > MAZE_MAP_MAX_GOALS))
+    {
+        return -1;
+    }
+
+    length = MAZE_MAP_PACK_SIZE(width, height, info->Num_Goals, info->Flags);
+    if (length > buffer_size)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < info->Num_Goals; i++)
+    {
+        if ((info->Goal_X[i] >= width) || (info->Goal_Y[i] >= height))
+        {
+            return -1;
+        }
+    }
+
+    buffer[0] = MAZE_MAP_PACK_MAGIC_0;
+    buffer[1] = MAZE_MAP_PACK_MAGIC_1;
+    buffer[2] = MAZE_MAP_PACK_VERSION;
+    buffer[3] = width;
+    buffer[4] = height;
+    buffer[5] = info->Flags & (MAZE_MAP_PACK_FLAG_VISITED | MAZE_MAP_PACK_FLAG_COMPLETE);
+    buffer[6] = info->Num_Goals;
+    for (i = 0; i < MAZE_MAP_PACK_NAME_LENGTH; i++)
+    {
+        buffer[7 + i] = (uint8_t)info->Name[i];
+    }
+    offset = MAZE_MAP_PACK_HEADER_SIZE;
+
+    for (i = 0; i < info->Num_Goals; i++)
+    {
+        buffer[offset] = (uint8_t)(info->Goal_X[i] | (info->Goal_Y[i] << 4));
+        offset++;
+    }
+
+    // Clear the wall and visited bits, only the set bits are written below
+    bits = &buffer[offset];
+    for (position = offset; position < (length - 2); position++)
+    {
+        buffer[position] = 0;
+    }
+
+    // North walls of the rows below the top row, then east walls of the columns left of the right column
+    position = 0;
+    for (y = 0; y < (height - 1); y++)
+    {
+        for (x = 0; x < width; x++)
+        {
+            if (Maze_Map_Pack_Get_Cell_Walls(map, MAZE_MAP_CELL_INDEX(x, y)) & (1 << MAZE_NORTH))
+            {
+                Maze_Map_Pack_Set_Bit(bits, position);
+            }
+            position++;
+        }
+    }
+    for (y = 0; y < height; y++)
+    {
+        for (x = 0; x < (width - 1); x++)
+        {
+            if (Maze_Map_Pack_Get_Cell_Walls(map, MAZE_MAP_CELL_INDEX(x, y)) & (1 << MAZE_EAST))
+            {
+                Maze_Map_Pack_Set_Bit(bits, position);
+            }
+            position++;
+        }
+    }
+
+    if (info->Flags & MAZE_MAP_PACK_FLAG_VISITED)
+    {
+        bits = &bits[(position + 7) / 8];
+        position = 0;
+        for (y = 0; y < height; y++)
+        {
+            for (x = 0; x < width; x++)
+            {
+                index = MAZE_MAP_CELL_INDEX(x, y);
+                if (Maze_Map_Pack_Get_Bit(&map[MAZE_MAP_NUM_CELLS / 2], index))
+                {
+                    Maze_Map_Pack_Set_Bit(bits, position);
+                }
+                position++;
+            }
+        }
+    }
+
+    crc = Maze_Map_Pack_CRC16(buffer, length - 2);
+    buffer[length - 2] = (uint8_t)(crc & 0xFF);
+    buffer[length - 1] = (uint8_t)(crc >> 8);
+
+    return length;
+}
+
+int Maze_Map_Pack_Decode(const uint8_t *buffer, uint16_t length, uint8_t *map, Maze_Map_Pack_Info *info)
+{
+    int packed_length = Maze_Map_Pack_Get_Length(buffer, length);
+    const uint8_t *bits;
+    uint16_t position;
+    uint16_t crc;
+    uint16_t i;
+    uint8_t width;
+    uint8_t height;
+    uint8_t flags;
+    uint8_t index;
+    uint8_t x;
+    uint8_t y;
+
+    if ((packed_length < 0) || (packed_length > length))
+    {
+        return -1;
+    }
+
+    crc = Maze_Map_Pack_CRC16(buffer, (uint16_t)(packed_length - 2));
+    if ((buffer[packed_length - 2] != (uint8_t)(crc & 0xFF)) || (buffer[packed_length - 1] != (uint8_t)(crc >> 8)))
+    {
+        return -1;
+    }
+
+    width = buffer[3];
+    height = buffer[4];
+    flags = buffer[5];
+
+    // The goal cells must be inside the maze
+    for (i = 0; i < buffer[6]; i++)
+    {
+        if (((buffer[MAZE_MAP_PACK_HEADER_SIZE + i] & 0x0F) >= width) || ((buffer[MAZE_MAP_PACK_HEADER_SIZE + i] >> 4) >= height))
+        {
+            return -1;
+        }
+    }
+
+    if (info != 0)
+    {
+        info->Width = width;
+        info->Height = height;
+        info->Flags = flags;
+        info->Num_Goals = buffer[6];
+        for (i = 0; i < info->Num_Goals; i++)
+        {
+            info->Goal_X[i] = buffer[MAZE_MAP_PACK_HEADER_SIZE + i] & 0x0F;
+            info->Goal_Y[i] = buffer[MAZE_MAP_PACK_HEADER_SIZE + i] >> 4;
+        }
+        for (i = 0; i < MAZE_MAP_PACK_NAME_LENGTH; i++)
+        {
+            info->Name[i] = (char)buffer[7 + i];
+        }
+    }
+
+    if (map == 0)
+    {
+        return packed_length;
+    }
+
+    // Every cell starts closed, then the open interior walls are cleared on both sides
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 2); i++)
+    {
+        map[i] = 0xFF;
+    }
+    for (i = 0; i < (MAZE_MAP_NUM_CELLS / 8); i++)
+    {
+        map[(MAZE_MAP_NUM_CELLS / 2) + i] = 0;
+    }
+
+    bits = &buffer[MAZE_MAP_PACK_HEADER_SIZE + buffer[6]];
+    position = 0;
+    for (y = 0; y < (height - 1); y++)
+    {
+        for (x = 0; x < width; x++)
+        {
+            if (!Maze_Map_Pack_Get_Bit(bits, position))
+            {
+                Maze_Map_Pack_Clear_Cell_Wall(map, MAZE_MAP_CELL_INDEX(x, y), MAZE_NORTH);
+                Maze_Map_Pack_Clear_Cell_Wall(map, MAZE_MAP_CELL_INDEX(x, y + 1), MAZE_SOUTH);
+            }
+            position++;
+        }
+    }
+    for (y = 0; y < height; y++)
+    {
+        for (x = 0; x < (width - 1); x++)
+        {
+            if (!Maze_Map_Pack_Get_Bit(bits, position))
+            {
+                Maze_Map_Pack_Clear_Cell_Wall(map, MAZE_MAP_CELL_INDEX(x, y), MAZE_EAST);
+                Maze_Map_Pack_Clear_Cell_Wall(map, MAZE_MAP_CELL_INDEX(x + 1, y), MAZE_WEST);
+            }
+            position++;
+        }
+    }
+
+    bits = &bits[(position + 7) / 8];
+    position = 0;
+    for (y = 0; y < height; y++)
+    {
+        for (x = 0; x < width; x++)
+        {
+            index = MAZE_MAP_CELL_INDEX(x, y);
+            if ((flags & MAZE_MAP_PACK_FLAG_COMPLETE) || ((flags & MAZE_MAP_PACK_FLAG_VISITED) && Maze_Map_Pack_Get_Bit(bits, position)))
+            {
+                Maze_Map_Pack_Set_Bit(&map[MAZE_MAP_NUM_CELLS / 2], index);
+            }
+            position++;
+        }
+    }
+
+    return packed_length;
+}
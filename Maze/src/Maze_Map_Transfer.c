@@ -0,0 +1,353 @@
+/**
+ * @file Maze_Map_Transfer.c
+ * @brief Source code for the Maze_Map_Transfer module.
+ *
+ * This file contains the function definitions for the Maze_Map_Transfer module.
+ * It executes the map commands, sends the lines of a map dump in the background, and keeps the map library.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Maze_Map_Transfer.h"
+#include "../inc/Print_Format.h"
+
+// Function that sends a reply line, 1 if it sends Text packets, and 1 if the slot commands are accepted
+static void (*Maze_Map_Transfer_Output)(const char *line);
+static uint8_t Maze_Map_Transfer_Packets;
+static uint8_t Maze_Map_Transfer_Library;
+
+// Packed map received with "map put", and the number of bytes received from its start
+static uint8_t Maze_Map_Transfer_Buffer[MAZE_MAP_PACK_MAX_SIZE];
+static uint16_t Maze_Map_Transfer_Length = 0;
+
+// Packed map sent by "map get", its length, and the offset of its next line
+static volatile uint8_t Maze_Map_Transfer_Dump_Active = 0;
+static uint8_t Maze_Map_Transfer_Dump_Buffer[MAZE_MAP_PACK_MAX_SIZE];
+static uint16_t Maze_Map_Transfer_Dump_Length = 0;
+static uint16_t Maze_Map_Transfer_Dump_Offset = 0;
+
+// Map unpacked by "map load" and its goal cells, handed over at the next control tick
+static uint8_t Maze_Map_Transfer_Load_Map[MAZE_MAP_STORAGE_SIZE];
+static Maze_Map_Pack_Info Maze_Map_Transfer_Load_Info;
+static volatile uint8_t Maze_Map_Transfer_Load_Pending = 0;
+
+// Packs the current maze map with its visited flags and its goal cells, returns its length or -1
+static int Maze_Map_Transfer_Pack_Current(uint8_t *buffer, const char *name)
+{
+    uint8_t map[MAZE_MAP_STORAGE_SIZE];
+    Maze_Map_Pack_Info info;
+
+    Maze_Map_Export(map);
+    info.Width = MAZE_MAP_WIDTH;
+    info.Height = MAZE_MAP_HEIGHT;
+    info.Flags = MAZE_MAP_PACK_FLAG_VISITED;
+    info.Num_Goals = Maze_Map_Get_Goals(info.Goal_X, info.Goal_Y);
+    memset(info.Name, 0, sizeof(info.Name));
+    if (name != 0)
+    {
+        strncpy(info.Name, name, sizeof(info.Name));
+    }
+
+    return Maze_Map_Pack_Encode(map, &info, buffer, MAZE_MAP_PACK_MAX_SIZE);
+}
+
+// Converts a word of hex digits to bytes, returns the number of bytes, or -1 for an odd length,
+// a character that is not a hex digit, or too many bytes
+static int Maze_Map_Transfer_Parse_Hex(const char *text, uint8_t *buffer, uint16_t size)
+{
+    uint16_t count = 0;
+    uint8_t value;
+    uint8_t i;
+    char c;
+
+    while (*text)
+    {
+        value = 0;
+        for (i = 0; i < 2; i++)
+        {
+            c = *text++;
+            if ((c >= '0') && (c <= '9'))
+            {
+                value = (uint8_t)((value << 4) | (c - '0'));
+            }
+            else if ((c >= 'a') && (c <= 'f'))
+            {
+                value = (uint8_t)((value << 4) | (c - 'a' + 10));
+            }
+            else if ((c >= 'A') && (c <= 'F'))
+            {
+                value = (uint8_t)((value << 4) | (c - 'A' + 10));
+            }
+            else
+            {
+                return -1;
+            }
+        }
+
+        if (count >= size)
+        {
+            return -1;
+        }
+        buffer[count] = value;
+        count++;
+    }
+
+    return count;
+}
+
+// Reads and checks the packed map of a slot of the library, returns its length, or -1 if the slot is empty or invalid
+static int Maze_Map_Transfer_Read_Slot(uint8_t slot, uint8_t *buffer, Maze_Map_Pack_Info *info)
+{
+    if (Flash_Store_Read(FLASH_STORE_KEY_MAZE_LIBRARY + slot, buffer, MAZE_MAP_PACK_MAX_SIZE) < 0)
+    {
+        return -1;
+    }
+
+    return Maze_Map_Pack_Decode(buffer, MAZE_MAP_PACK_MAX_SIZE, 0, info);
+}
+
+// Writes a packed map to a slot of the library, padded in place with zeros to the MAZE_MAP_PACK_MAX_SIZE bytes
+// expected by Maze_Map_Transfer_Read_Slot, returns 0, or -1 if the flash store cannot be programmed
+static int Maze_Map_Transfer_Write_Slot(uint8_t slot, uint8_t *buffer, uint16_t length)
+{
+    memset(&buffer[length], 0, MAZE_MAP_PACK_MAX_SIZE - length);
+
+    return Flash_Store_Write(FLASH_STORE_KEY_MAZE_LIBRARY + slot, buffer, MAZE_MAP_PACK_MAX_SIZE);
+}
+
+void Maze_Map_Transfer_Init(void (*output)(const char *line), uint8_t packets, uint8_t library)
+{
+    Maze_Map_Transfer_Output = output;
+    Maze_Map_Transfer_Packets = packets;
+    Maze_Map_Transfer_Library = library;
+    Maze_Map_Transfer_Length = 0;
+    Maze_Map_Transfer_Dump_Active = 0;
+    Maze_Map_Transfer_Load_Pending = 0;
+}
+
+int Maze_Map_Transfer_Command(char **arguments, uint8_t argument_count)
+{
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+    uint8_t record[MAZE_MAP_PACK_MAX_SIZE];
+    Maze_Map_Pack_Info info;
+    char name[MAZE_MAP_PACK_NAME_LENGTH + 1];
+    int32_t slot = -1;
+    int32_t value;
+    int length;
+    uint8_t i;
+
+    if ((argument_count < 2) || (strcmp(arguments[0], "map") != 0))
+    {
+        return -1;
+    }
+
+    // Slot argument of get, load, save, and write
+    if (Maze_Map_Transfer_Library && (argument_count >= 3) &&
+        ((strcmp(arguments[1], "get") == 0) || (strcmp(arguments[1], "load") == 0) ||
+         (strcmp(arguments[1], "save") == 0) || (strcmp(arguments[1], "write") == 0)))
+    {
+        if ((Parameters_Parse_Value(arguments[2], &slot) != 0) || (slot < 0) || (slot >= MAZE_LIBRARY_NUM_SLOTS))
+        {
+            Maze_Map_Transfer_Output("err slot");
+            return 0;
+        }
+    }
+
+    if ((strcmp(arguments[1], "get") == 0) && ((argument_count == 2) || ((argument_count == 3) && (slot >= 0))))
+    {
+        if (Maze_Map_Transfer_Dump_Active)
+        {
+            Maze_Map_Transfer_Output("err busy");
+            return 0;
+        }
+
+        if (slot >= 0)
+        {
+            length = Maze_Map_Transfer_Read_Slot((uint8_t)slot, Maze_Map_Transfer_Dump_Buffer, 0);
+        }
+        else
+        {
+            length = Maze_Map_Transfer_Pack_Current(Maze_Map_Transfer_Dump_Buffer, 0);
+        }
+
+        if (length < 0)
+        {
+            Maze_Map_Transfer_Output("err map");
+            return 0;
+        }
+        Maze_Map_Transfer_Dump_Length = (uint16_t)length;
+        Maze_Map_Transfer_Dump_Offset = 0;
+        Maze_Map_Transfer_Dump_Active = 1;
+    }
+    else if ((strcmp(arguments[1], "put") == 0) && (argument_count == 4))
+    {
+        if ((Parameters_Parse_Value(arguments[2], &value) != 0) || ((value != 0) && (value != Maze_Map_Transfer_Length)))
+        {
+            Maze_Map_Transfer_Output("err offset");
+            return 0;
+        }
+
+        length = Maze_Map_Transfer_Parse_Hex(arguments[3], &Maze_Map_Transfer_Buffer[value], (uint16_t)(MAZE_MAP_PACK_MAX_SIZE - value));
+        if (length < 0)
+        {
+            Maze_Map_Transfer_Output("err value");
+            return 0;
+        }
+        Maze_Map_Transfer_Length = (uint16_t)(value + length);
+
+        Print_Format_To_Buffer(line, sizeof(line), "ok map put %u", (unsigned int)Maze_Map_Transfer_Length);
+        Maze_Map_Transfer_Output(line);
+    }
+    else if ((strcmp(arguments[1], "load") == 0) && ((argument_count == 2) || ((argument_count == 3) && (slot >= 0))))
+    {
+        if (Maze_Map_Transfer_Load_Pending)
+        {
+            Maze_Map_Transfer_Output("err busy");
+            return 0;
+        }
+
+        if (slot >= 0)
+        {
+            length = Maze_Map_Transfer_Read_Slot((uint8_t)slot, Maze_Map_Transfer_Buffer, 0);
+            Maze_Map_Transfer_Length = (length > 0) ? (uint16_t)length : 0;
+        }
+
+        if (Maze_Map_Pack_Decode(Maze_Map_Transfer_Buffer, Maze_Map_Transfer_Length, Maze_Map_Transfer_Load_Map,
+                                 &Maze_Map_Transfer_Load_Info) < 0)
+        {
+            Maze_Map_Transfer_Output("err map");
+            return 0;
+        }
+        Maze_Map_Transfer_Load_Pending = 1;
+
+        Print_Format_To_Buffer(line, sizeof(line), "ok map load %ux%u goals=%u", (unsigned int)Maze_Map_Transfer_Load_Info.Width,
+                 (unsigned int)Maze_Map_Transfer_Load_Info.Height, (unsigned int)Maze_Map_Transfer_Load_Info.Num_Goals);
+        Maze_Map_Transfer_Output(line);
+    }
+    else if (Maze_Map_Transfer_Library && (strcmp(arguments[1], "save") == 0) && ((argument_count == 3) || (argument_count == 4)))
+    {
+        length = Maze_Map_Transfer_Pack_Current(record, (argument_count == 4) ? arguments[3] : 0);
+        if (length < 0)
+        {
+            Maze_Map_Transfer_Output("err map");
+            return 0;
+        }
+        if (Maze_Map_Transfer_Write_Slot((uint8_t)slot, record, (uint16_t)length) != 0)
+        {
+            Maze_Map_Transfer_Output("err flash");
+            return 0;
+        }
+
+        Print_Format_To_Buffer(line, sizeof(line), "ok map save %ld %d", (long)slot, length);
+        Maze_Map_Transfer_Output(line);
+    }
+    else if (Maze_Map_Transfer_Library && (strcmp(arguments[1], "write") == 0) && (argument_count == 3))
+    {
+        length = Maze_Map_Pack_Decode(Maze_Map_Transfer_Buffer, Maze_Map_Transfer_Length, 0, 0);
+        if (length < 0)
+        {
+            Maze_Map_Transfer_Output("err map");
+            return 0;
+        }
+        if (Maze_Map_Transfer_Write_Slot((uint8_t)slot, Maze_Map_Transfer_Buffer, (uint16_t)length) != 0)
+        {
+            Maze_Map_Transfer_Output("err flash");
+            return 0;
+        }
+
+        Print_Format_To_Buffer(line, sizeof(line), "ok map write %ld %d", (long)slot, length);
+        Maze_Map_Transfer_Output(line);
+    }
+    else if (Maze_Map_Transfer_Library && (strcmp(arguments[1], "list") == 0) && (argument_count == 2))
+    {
+        for (i = 0; i < MAZE_LIBRARY_NUM_SLOTS; i++)
+        {
+            if (Maze_Map_Transfer_Read_Slot(i, record, &info) < 0)
+            {
+                continue;
+            }
+
+            memcpy(name, info.Name, MAZE_MAP_PACK_NAME_LENGTH);
+            name[MAZE_MAP_PACK_NAME_LENGTH] = '\0';
+            Print_Format_To_Buffer(line, sizeof(line), "map slot %u %s %ux%u goals=%u flags=%u", (unsigned int)i,
+                     (name[0] != '\0') ? name : "-", (unsigned int)info.Width, (unsigned int)info.Height,
+                     (unsigned int)info.Num_Goals, (unsigned int)info.Flags);
+            Maze_Map_Transfer_Output(line);
+        }
+        Maze_Map_Transfer_Output("ok map list");
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+void Maze_Map_Transfer_Task(void)
+{
+    static const char digits[] = "0123456789abcdef";
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+    char hex[(MAZE_MAP_TRANSFER_BYTES_PER_LINE * 2) + 1];
+    uint16_t count;
+    uint16_t i;
+    uint8_t lines = 0;
+
+    if (Maze_Map_Transfer_Dump_Active == 0)
+    {
+        return;
+    }
+
+    // Text packets are paced by the room in the TX ring buffer, text lines by their number
+    while ((Maze_Map_Transfer_Dump_Offset < Maze_Map_Transfer_Dump_Length) &&
+           (Maze_Map_Transfer_Packets ? (EUSCI_A0_UART_TX_Free() >= TELEMETRY_MAX_ENCODED_LENGTH) : (lines < MAZE_MAP_TRANSFER_LINES_PER_TASK)))
+    {
+        count = Maze_Map_Transfer_Dump_Length - Maze_Map_Transfer_Dump_Offset;
+        if (count > MAZE_MAP_TRANSFER_BYTES_PER_LINE)
+        {
+            count = MAZE_MAP_TRANSFER_BYTES_PER_LINE;
+        }
+        for (i = 0; i < count; i++)
+        {
+            hex[2 * i] = digits[Maze_Map_Transfer_Dump_Buffer[Maze_Map_Transfer_Dump_Offset + i] >> 4];
+            hex[(2 * i) + 1] = digits[Maze_Map_Transfer_Dump_Buffer[Maze_Map_Transfer_Dump_Offset + i] & 0x0F];
+        }
+        hex[2 * count] = '\0';
+
+        Print_Format_To_Buffer(line, sizeof(line), "map %u %s", (unsigned int)Maze_Map_Transfer_Dump_Offset, hex);
+        Maze_Map_Transfer_Output(line);
+        Maze_Map_Transfer_Dump_Offset = Maze_Map_Transfer_Dump_Offset + count;
+        lines++;
+    }
+
+    if (Maze_Map_Transfer_Dump_Offset >= Maze_Map_Transfer_Dump_Length)
+    {
+        Print_Format_To_Buffer(line, sizeof(line), "ok map get %u", (unsigned int)Maze_Map_Transfer_Dump_Length);
+        Maze_Map_Transfer_Output(line);
+        Maze_Map_Transfer_Dump_Active = 0;
+    }
+}
+
+const uint8_t *Maze_Map_Transfer_Take_Loaded_Map(void)
+{
+    uint8_t goal;
+
+    if (Maze_Map_Transfer_Load_Pending == 0)
+    {
+        return 0;
+    }
+
+    if (Maze_Map_Transfer_Load_Info.Num_Goals > 0)
+    {
+        Maze_Map_Clear_Goals();
+        for (goal = 0; goal < Maze_Map_Transfer_Load_Info.Num_Goals; goal++)
+        {
+            Maze_Map_Add_Goal(Maze_Map_Transfer_Load_Info.Goal_X[goal], Maze_Map_Transfer_Load_Info.Goal_Y[goal]);
+        }
+    }
+
+    // The command handler runs in the background, so it cannot load another map before the control tick has imported this one
+    Maze_Map_Transfer_Load_Pending = 0;
+
+    return Maze_Map_Transfer_Load_Map;
+}
@@ -0,0 +1,598 @@
+/**
+ * @file Motion.c
+ * @brief Source code for the Motion driver.
+ *
+ * This file contains the function definitions for the Motion driver.
+ * It executes a queue of motion primitives (turn N degrees, drive M mm, stop for N ticks)
+ * without blocking. Each call to Motion_Update advances the active command by one control tick.
+ *
+ */
+
+#include "../inc/Motion.h"
+#include "../inc/Trace.h"
+#include "../inc/Traction.h"
+
+// Circular queue of the commands waiting to be executed
+static Motion_Command Motion_Queue[MOTION_QUEUE_LENGTH];
+static uint8_t Motion_Queue_Head;
+static uint8_t Motion_Queue_Tail;
+
+// Command currently executed and its progress
+// The target is in degrees for a turn and in tachometer steps for a drive
+static Motion_Command Motion_Active_Command;
+static uint8_t Motion_Active;
+static int32_t Motion_Target;
+static int32_t Motion_Start_Left_Steps;
+static int32_t Motion_Start_Right_Steps;
+static uint16_t Motion_Elapsed_Ticks;
+
+// Duty cycle of the open-loop turn or drive applied to the motors, after the Traction limit,
+// and the difference between the wheels applied by the heading hold of a drive
+static uint16_t Motion_Applied_Duty_Cycle;
+static int16_t Motion_Applied_Trim;
+
+// Heading at the previous update and total heading change since the start of a turn, an arc, or a drive
+static uint32_t Motion_Last_Heading;
+static int64_t Motion_Turned_Angle;
+
+// Turned angle at the last degree of progress of a turn, and the number of ticks since then
+static int64_t Motion_Progress_Angle;
+static uint16_t Motion_Stall_Ticks;
+
+// Speed of the center of the robot set by the active command, and the speed at which the next command starts
+static uint16_t Motion_Speed;
+static uint16_t Motion_Entry_Speed = MOTION_PROFILE_MIN_SPEED;
+
+// Result of the last command that has finished
+static Motion_Result Motion_Last_Result = MOTION_RESULT_NONE;
+
+static int Motion_Queue_Command(Motion_Command_Type type, int16_t amount, uint16_t duty_cycle, uint16_t timeout_ticks,
+                                uint16_t max_speed, uint16_t end_speed, uint16_t acceleration, uint16_t radius)
+{
+    Motion_Command *command;
+    long sr;
+
+    sr = StartCritical();
+
+    // The queue is full when the head is one full lap ahead of the tail
+    if ((uint8_t)(Motion_Queue_Head - Motion_Queue_Tail) >= MOTION_QUEUE_LENGTH)
+    {
+        EndCritical(sr);
+        return -1;
+    }
+
+    command = &Motion_Queue[Motion_Queue_Head & (MOTION_QUEUE_LENGTH - 1)];
+    command->Type = type;
+    command->Amount = amount;
+    command->Duty_Cycle = duty_cycle;
+    command->Timeout_Ticks = (timeout_ticks == 0) ? MOTION_DEFAULT_TIMEOUT_TICKS : timeout_ticks;
+    command->Max_Speed = max_speed;
+    command->End_Speed = end_speed;
+    command->Acceleration = acceleration;
+    command->Radius = radius;
+    Motion_Queue_Head = Motion_Queue_Head + 1;
+
+    EndCritical(sr);
+
+    return 0;
+}
+
+static void Motion_Get_Steps(int32_t *left_steps, int32_t *right_steps)
+{
+    uint16_t left_tach;
+    uint16_t right_tach;
+    enum Tachometer_Direction left_dir;
+    enum Tachometer_Direction right_dir;
+
+    Tachometer_Get(&left_tach, &left_dir, left_steps, &right_tach, &right_dir, right_steps);
+}
+
+static uint32_t Motion_Square_Root(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 0x40000000;
+
+    while (bit > value)
+    {
+        bit = bit >> 2;
+    }
+
+    while (bit != 0)
+    {
+        if (value >= (root + bit))
+        {
+            value = value - (root + bit);
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root = root >> 1;
+        }
+        bit = bit >> 2;
+    }
+
+    return root;
+}
+
+static uint8_t Motion_Is_Speed_Controlled(Motion_Command_Type type)
+{
+    return ((type == MOTION_COMMAND_PROFILED_DRIVE) || (type == MOTION_COMMAND_ARC));
+}
+
+static int32_t Motion_Get_Progress()
+{
+    int32_t left_steps;
+    int32_t right_steps;
+    int32_t left_progress;
+    int32_t right_progress;
+
+    // Use the average distance traveled by both wheels, regardless of their direction
+    Motion_Get_Steps(&left_steps, &right_steps);
+    left_progress = left_steps - Motion_Start_Left_Steps;
+    right_progress = right_steps - Motion_Start_Right_Steps;
+    if (left_progress < 0)
+    {
+        left_progress = -left_progress;
+    }
+    if (right_progress < 0)
+    {
+        right_progress = -right_progress;
+    }
+
+    return (left_progress + right_progress) / 2;
+}
+
+static int16_t Motion_Profile_Speed(int32_t progress)
+{
+    uint32_t remaining_mm;
+    uint32_t end_speed;
+    uint32_t speed;
+    uint32_t limit;
+
+    // Accelerate from the speed at the start of the drive
+    speed = Motion_Entry_Speed + (((uint32_t)Motion_Active_Command.Acceleration * Motion_Elapsed_Ticks) / SPEED_CONTROLLER_RATE_HZ);
+
+    // Decelerate so that the speed is down to the end speed at the target: v^2 = v0^2 + 2 * a * d
+    end_speed = Motion_Active_Command.End_Speed;
+    if (end_speed < MOTION_PROFILE_MIN_SPEED)
+    {
+        end_speed = MOTION_PROFILE_MIN_SPEED;
+    }
+    remaining_mm = ((Motion_Target - progress) * MOTION_UM_PER_STEP) / 1000;
+    limit = Motion_Square_Root((end_speed * end_speed) + (2 * (uint32_t)Motion_Active_Command.Acceleration * remaining_mm));
+    if (limit < speed)
+    {
+        speed = limit;
+    }
+
+    if (speed > Motion_Active_Command.Max_Speed)
+    {
+        speed = Motion_Active_Command.Max_Speed;
+    }
+    Motion_Speed = speed;
+
+    return (Motion_Active_Command.Amount >= 0) ? (int16_t)speed : -(int16_t)speed;
+}
+
+// Returns the difference between the wheels that steers a drive back to its initial heading, to add to the signed
+// speed of the left wheel and subtract from the right one, with a gain per degree of heading change
+// (duty cycle or mm/s), limited to a quarter of the drive
+static int16_t Motion_Heading_Trim(int32_t gain, int32_t drive)
+{
+    int32_t trim = (int32_t)((Motion_Turned_Angle * gain) / ODOMETRY_HEADING_ONE_DEGREE);
+    int32_t limit = drive / 4;
+
+    if (limit < 0)
+    {
+        limit = -limit;
+    }
+
+    if (trim > limit)
+    {
+        trim = limit;
+    }
+    else if (trim < -limit)
+    {
+        trim = -limit;
+    }
+
+    return (int16_t)trim;
+}
+
+// Applies the duty cycle of an open-loop turn or drive in the direction of the command
+static void Motion_Apply_Duty_Cycle(const Motion_Command *command, uint16_t duty_cycle)
+{
+    int16_t trim;
+
+    // Reduce the duty cycle while a wheel slips
+    duty_cycle = Traction_Limit_Duty_Cycle(duty_cycle);
+    Motion_Applied_Duty_Cycle = duty_cycle;
+    trim = (command->Type == MOTION_COMMAND_DRIVE) ? Motion_Heading_Trim(MOTION_DRIVE_HEADING_GAIN, duty_cycle) : 0;
+    Motion_Applied_Trim = trim;
+
+    if (command->Type == MOTION_COMMAND_TURN)
+    {
+        if (command->Amount >= 0)
+        {
+            Motor_Left(duty_cycle, duty_cycle);
+        }
+        else
+        {
+            Motor_Right(duty_cycle, duty_cycle);
+        }
+    }
+    else
+    {
+        if (command->Amount >= 0)
+        {
+            Motor_Forward(duty_cycle + trim, duty_cycle - trim);
+        }
+        else
+        {
+            // The duty cycles are the magnitudes of the signed speeds
+            Motor_Backward(duty_cycle - trim, duty_cycle + trim);
+        }
+    }
+}
+
+// Returns the duty cycle decreasing linearly from a duty cycle to MOTION_SLOWDOWN_MIN_DUTY_CYCLE
+// while the remaining part of a command decreases from its slowdown length to 0
+static uint32_t Motion_Slowdown_Duty_Cycle(uint32_t duty_cycle, int64_t remaining, int64_t slowdown_length)
+{
+    if ((duty_cycle <= MOTION_SLOWDOWN_MIN_DUTY_CYCLE) || (remaining >= slowdown_length))
+    {
+        return duty_cycle;
+    }
+
+    if (remaining < 0)
+    {
+        remaining = 0;
+    }
+
+    return MOTION_SLOWDOWN_MIN_DUTY_CYCLE + (uint32_t)(((duty_cycle - MOTION_SLOWDOWN_MIN_DUTY_CYCLE) * remaining) / slowdown_length);
+}
+
+// Returns the duty cycle of an open-loop turn or drive after a number of ticks, ramped up by MOTION_DUTY_CYCLE_RAMP per tick
+// It slows down over the last MOTION_TURN_SLOWDOWN_DEGREES of a turn or MOTION_DRIVE_SLOWDOWN_MM of a drive,
+// so the robot does not coast past the target
+static uint16_t Motion_Ramp_Duty_Cycle(const Motion_Command *command, uint16_t elapsed_ticks)
+{
+    uint32_t duty_cycle = (uint32_t)MOTION_DUTY_CYCLE_RAMP * (elapsed_ticks + 1);
+
+    if (duty_cycle > command->Duty_Cycle)
+    {
+        duty_cycle = command->Duty_Cycle;
+    }
+
+    if (command->Type == MOTION_COMMAND_TURN)
+    {
+        duty_cycle = Motion_Slowdown_Duty_Cycle(duty_cycle,
+                                                ((int64_t)Motion_Target * ODOMETRY_HEADING_ONE_DEGREE) -
+                                                ((Motion_Turned_Angle >= 0) ? Motion_Turned_Angle : -Motion_Turned_Angle),
+                                                (int64_t)MOTION_TURN_SLOWDOWN_DEGREES * ODOMETRY_HEADING_ONE_DEGREE);
+    }
+    else if (command->Type == MOTION_COMMAND_DRIVE)
+    {
+        duty_cycle = Motion_Slowdown_Duty_Cycle(duty_cycle, Motion_Target - Motion_Get_Progress(),
+                                                ((int64_t)MOTION_DRIVE_SLOWDOWN_MM * 1000) / MOTION_UM_PER_STEP);
+    }
+
+    return duty_cycle;
+}
+
+static void Motion_Start_Command(const Motion_Command *command)
+{
+    uint16_t acceleration_limit;
+    uint16_t deceleration_limit;
+    int32_t amount = command->Amount;
+    int32_t inner_speed;
+    int32_t outer_speed;
+
+    Motion_Active_Command = *command;
+    Motion_Elapsed_Ticks = 0;
+    Motion_Active = 1;
+
+    Trace_Record(TRACE_EVENT_MOTION_START, command->Type, (uint32_t)command->Amount);
+
+    Motion_Get_Steps(&Motion_Start_Left_Steps, &Motion_Start_Right_Steps);
+    Motion_Last_Heading = Odometry_Get_Heading();
+    Motion_Turned_Angle = 0;
+    Motion_Progress_Angle = 0;
+    Motion_Stall_Ticks = 0;
+
+    switch (command->Type)
+    {
+        case MOTION_COMMAND_TURN:
+        {
+            Motion_Target = (amount >= 0) ? amount : -amount;
+            Motion_Apply_Duty_Cycle(command, Motion_Ramp_Duty_Cycle(command, 0));
+        }
+        break;
+
+        case MOTION_COMMAND_DRIVE:
+        {
+            Motion_Target = (((amount >= 0) ? amount : -amount) * 1000) / MOTION_UM_PER_STEP;
+            Motion_Apply_Duty_Cycle(command, Motion_Ramp_Duty_Cycle(command, 0));
+        }
+        break;
+
+        case MOTION_COMMAND_PROFILED_DRIVE:
+        {
+            Motion_Target = (((amount >= 0) ? amount : -amount) * 1000) / MOTION_UM_PER_STEP;
+
+            // Plan the profile within the limits of the Speed_Controller, so that its setpoint ramp
+            // does not lag behind the deceleration and the drive ends on the target
+            Speed_Controller_Get_Limits(&acceleration_limit, &deceleration_limit);
+            if ((acceleration_limit != 0) && (Motion_Active_Command.Acceleration > acceleration_limit))
+            {
+                Motion_Active_Command.Acceleration = acceleration_limit;
+            }
+            if ((deceleration_limit != 0) && (Motion_Active_Command.Acceleration > deceleration_limit))
+            {
+                Motion_Active_Command.Acceleration = deceleration_limit;
+            }
+
+            Speed_Controller_Set_Speed(Motion_Profile_Speed(0), Motion_Profile_Speed(0));
+        }
+        break;
+
+        case MOTION_COMMAND_ARC:
+        {
+            // Wheel speeds on the inner and outer circles: v * (r -/+ b / 2) / r
+            Motion_Speed = command->Max_Speed;
+            inner_speed = 0;
+            outer_speed = 2 * (int32_t)command->Max_Speed;
+            if (command->Radius > 0)
+            {
+                inner_speed = ((int32_t)command->Max_Speed * ((2 * command->Radius) - MOTION_WHEEL_BASE_MM)) / (2 * command->Radius);
+                outer_speed = ((int32_t)command->Max_Speed * ((2 * command->Radius) + MOTION_WHEEL_BASE_MM)) / (2 * command->Radius);
+            }
+
+            if (amount >= 0)
+            {
+                Motion_Target = amount;
+                Speed_Controller_Set_Speed(inner_speed, outer_speed);
+            }
+            else
+            {
+                Motion_Target = -amount;
+                Speed_Controller_Set_Speed(outer_speed, inner_speed);
+            }
+        }
+        break;
+
+        default:
+        {
+            Motion_Target = 0;
+            Motor_Stop();
+        }
+        break;
+    }
+}
+
+static void Motion_Finish_Command(Motion_Result result)
+{
+    Motion_Active = 0;
+    Motion_Last_Result = result;
+
+    Trace_Record(TRACE_EVENT_MOTION_FINISH, result, Motion_Elapsed_Ticks);
+
+    // Keep the wheels moving when the next command continues at speed
+    if ((result == MOTION_RESULT_DONE) && Motion_Is_Speed_Controlled(Motion_Active_Command.Type)
+        && (Motion_Queue_Head != Motion_Queue_Tail)
+        && Motion_Is_Speed_Controlled(Motion_Queue[Motion_Queue_Tail & (MOTION_QUEUE_LENGTH - 1)].Type))
+    {
+        Motion_Entry_Speed = Motion_Speed;
+        return;
+    }
+
+    Motion_Entry_Speed = MOTION_PROFILE_MIN_SPEED;
+
+    // Release the motors from the Speed_Controller before they are stopped
+    if (Motion_Is_Speed_Controlled(Motion_Active_Command.Type))
+    {
+        Speed_Controller_Disable();
+    }
+
+    Motor_Stop();
+}
+
+void Motion_Init()
+{
+    long sr;
+
+    sr = StartCritical();
+    Motion_Queue_Head = 0;
+    Motion_Queue_Tail = 0;
+    Motion_Active = 0;
+    Motion_Last_Result = MOTION_RESULT_NONE;
+    EndCritical(sr);
+}
+
+int Motion_Turn(int16_t degrees, uint16_t duty_cycle, uint16_t timeout_ticks)
+{
+    return Motion_Queue_Command(MOTION_COMMAND_TURN, degrees, duty_cycle, timeout_ticks, 0, 0, 0, 0);
+}
+
+int Motion_Drive(int16_t distance_mm, uint16_t duty_cycle, uint16_t timeout_ticks)
+{
+    return Motion_Queue_Command(MOTION_COMMAND_DRIVE, distance_mm, duty_cycle, timeout_ticks, 0, 0, 0, 0);
+}
+
+int Motion_Drive_Profiled(int16_t distance_mm, uint16_t max_speed, uint16_t end_speed, uint16_t acceleration, uint16_t timeout_ticks)
+{
+    return Motion_Queue_Command(MOTION_COMMAND_PROFILED_DRIVE, distance_mm, 0, timeout_ticks, max_speed, end_speed, acceleration, 0);
+}
+
+int Motion_Arc(int16_t degrees, uint16_t radius_mm, uint16_t speed, uint16_t timeout_ticks)
+{
+    return Motion_Queue_Command(MOTION_COMMAND_ARC, degrees, 0, timeout_ticks, speed, 0, 0, radius_mm);
+}
+
+int Motion_Stop(uint16_t ticks)
+{
+    return Motion_Queue_Command(MOTION_COMMAND_STOP, 0, 0, ticks, 0, 0, 0, 0);
+}
+
+void Motion_Abort()
+{
+    long sr;
+
+    sr = StartCritical();
+    Motion_Queue_Tail = Motion_Queue_Head;
+    if (Motion_Active)
+    {
+        Motion_Finish_Command(MOTION_RESULT_ABORTED);
+    }
+    EndCritical(sr);
+}
+
+void Motion_Set_Reference_Heading(uint32_t heading)
+{
+    if (Motion_Active)
+    {
+        // The heading change accumulated by Motion_Update is then the signed angle from the reference
+        Motion_Turned_Angle = (int32_t)(Motion_Last_Heading - heading);
+    }
+}
+
+void Motion_Set_Remaining_Distance(int32_t distance_mm)
+{
+    if (Motion_Active && ((Motion_Active_Command.Type == MOTION_COMMAND_DRIVE) || (Motion_Active_Command.Type == MOTION_COMMAND_PROFILED_DRIVE)))
+    {
+        if (distance_mm < 0)
+        {
+            distance_mm = 0;
+        }
+        Motion_Target = Motion_Get_Progress() + ((distance_mm * 1000) / MOTION_UM_PER_STEP);
+    }
+}
+
+void Motion_Update()
+{
+    int32_t progress;
+    int16_t speed;
+    int16_t trim;
+    uint32_t heading;
+    int64_t turned_angle;
+    uint16_t duty_cycle;
+
+    if (Motion_Active)
+    {
+        Motion_Elapsed_Ticks = Motion_Elapsed_Ticks + 1;
+
+        // Accumulate the heading changes, so turns larger than 180 degrees are supported
+        heading = Odometry_Get_Heading();
+        Motion_Turned_Angle = Motion_Turned_Angle + (int32_t)(heading - Motion_Last_Heading);
+        Motion_Last_Heading = heading;
+
+        if ((Motion_Active_Command.Type == MOTION_COMMAND_TURN) || (Motion_Active_Command.Type == MOTION_COMMAND_ARC))
+        {
+            turned_angle = Motion_Turned_Angle;
+            if (turned_angle < 0)
+            {
+                turned_angle = -turned_angle;
+            }
+
+            if (turned_angle >= ((int64_t)Motion_Target * ODOMETRY_HEADING_ONE_DEGREE))
+            {
+                Motion_Finish_Command(MOTION_RESULT_DONE);
+            }
+            else if (turned_angle >= (Motion_Progress_Angle + ODOMETRY_HEADING_ONE_DEGREE))
+            {
+                Motion_Progress_Angle = turned_angle;
+                Motion_Stall_Ticks = 0;
+            }
+            else
+            {
+                Motion_Stall_Ticks = Motion_Stall_Ticks + 1;
+            }
+        }
+        else if (Motion_Active_Command.Type == MOTION_COMMAND_DRIVE)
+        {
+            if (Motion_Get_Progress() >= Motion_Target)
+            {
+                Motion_Finish_Command(MOTION_RESULT_DONE);
+            }
+        }
+
+        // Ramp up the duty cycle of an open-loop turn or drive until it reaches the duty cycle of the command,
+        // and apply it again when the Traction limit, the slowdown at the end of a turn, or the heading hold of a drive changes it
+        if (Motion_Active && ((Motion_Active_Command.Type == MOTION_COMMAND_TURN) || (Motion_Active_Command.Type == MOTION_COMMAND_DRIVE)))
+        {
+            duty_cycle = Traction_Limit_Duty_Cycle(Motion_Ramp_Duty_Cycle(&Motion_Active_Command, Motion_Elapsed_Ticks));
+            if ((duty_cycle != Motion_Applied_Duty_Cycle) ||
+                ((Motion_Active_Command.Type == MOTION_COMMAND_DRIVE) && (Motion_Heading_Trim(MOTION_DRIVE_HEADING_GAIN, duty_cycle) != Motion_Applied_Trim)))
+            {
+                Motion_Apply_Duty_Cycle(&Motion_Active_Command, Motion_Ramp_Duty_Cycle(&Motion_Active_Command, Motion_Elapsed_Ticks));
+            }
+        }
+        else if (Motion_Active_Command.Type == MOTION_COMMAND_PROFILED_DRIVE)
+        {
+            progress = Motion_Get_Progress();
+            if (progress >= Motion_Target)
+            {
+                Motion_Finish_Command(MOTION_RESULT_DONE);
+            }
+            else
+            {
+                speed = Motion_Profile_Speed(progress);
+                trim = Motion_Heading_Trim(MOTION_PROFILED_HEADING_GAIN, speed);
+                Speed_Controller_Set_Speed(speed + trim, speed - trim);
+            }
+        }
+
+        // An in-place turn ends on its heading, so its timeout only counts the ticks without a degree of progress
+        if (Motion_Active && (Motion_Active_Command.Type == MOTION_COMMAND_TURN))
+        {
+            if (Motion_Stall_Ticks >= Motion_Active_Command.Timeout_Ticks)
+            {
+                Motion_Finish_Command(MOTION_RESULT_TIMEOUT);
+            }
+        }
+        else if (Motion_Active && (Motion_Elapsed_Ticks >= Motion_Active_Command.Timeout_Ticks))
+        {
+            // A stop completes after its duration, every other command has timed out
+            if (Motion_Active_Command.Type == MOTION_COMMAND_STOP)
+            {
+                Motion_Finish_Command(MOTION_RESULT_DONE);
+            }
+            else
+            {
+                Motion_Finish_Command(MOTION_RESULT_TIMEOUT);
+            }
+        }
+    }
+
+    // Start the next command as soon as the previous one has finished
+    if ((Motion_Active == 0) && (Motion_Queue_Head != Motion_Queue_Tail))
+    {
+        Motion_Start_Command(&Motion_Queue[Motion_Queue_Tail & (MOTION_QUEUE_LENGTH - 1)]);
+        Motion_Queue_Tail = Motion_Queue_Tail + 1;
+    }
+}
+
+uint8_t Motion_Is_Busy()
+{
+    return (Motion_Active || (Motion_Queue_Head != Motion_Queue_Tail));
+}
+
+uint8_t Motion_Get_Queued_Count()
+{
+    return (uint8_t)(Motion_Queue_Head - Motion_Queue_Tail);
+}
+
+Motion_Command_Type Motion_Get_Active_Type()
+{
+    if (Motion_Active)
+    {
+        return Motion_Active_Command.Type;
+    }
+
+    return MOTION_COMMAND_STOP;
+}
+
+Motion_Result Motion_Get_Last_Result()
+{
+    return Motion_Last_Result;
+}
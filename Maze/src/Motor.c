@@ -11,6 +11,8 @@
  */
 
 #include "../inc/Motor.h"
+#include "../inc/Motor_Inline.h"
+#include "../inc/Latency_Test.h"
 
 void Motor_Init()
 {
@@ -52,6 +54,9 @@ void Motor_Forward(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
 
     // Enable the motors by setting Bits 6 and 7 of the OUT register for P3
     P3->OUT |= 0xC0;
+
+    // Take the time of the command for the latency measurement (see Latency_Test.h)
+    Latency_Test_Motor_Command();
 }
 
 void Motor_Backward(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
@@ -66,6 +71,9 @@ void Motor_Backward(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
 
     // Enable the motors by setting Bits 6 and 7 of the OUT register for P3
     P3->OUT |= 0xC0;
+
+    // Take the time of the command for the latency measurement (see Latency_Test.h)
+    Latency_Test_Motor_Command();
 }
 
 void Motor_Left(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
@@ -84,6 +92,9 @@ void Motor_Left(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
 
     // Enable the motors by setting Bits 6 and 7 of the OUT register for P3
     P3->OUT |= 0xC0;
+
+    // Take the time of the command for the latency measurement (see Latency_Test.h)
+    Latency_Test_Motor_Command();
 }
 
 void Motor_Right(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
@@ -102,16 +113,23 @@ void Motor_Right(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
 
     // Enable the motors by setting Bits 6 and 7 of the OUT register for P3
     P3->OUT |= 0xC0;
+
+    // Take the time of the command for the latency measurement (see Latency_Test.h)
+    Latency_Test_Motor_Command();
 }
 
 void Motor_Stop()
 {
-    // Disable the motors by clearing Bits 6 and 7 of the OUT register for P3
-    // and clearing Bits 4 and 5 of the OUT register for P5
-    P3->OUT &= ~0xC0;
-    P5->OUT &= ~0x30;
+    Motor_Stop_Inline();
+
+    // Take the time of the command for the latency measurement (see Latency_Test.h)
+    Latency_Test_Motor_Command();
+}
+
+void Motor_Drive(int16_t left_duty_cycle, int16_t right_duty_cycle)
+{
+    Motor_Drive_Inline(left_duty_cycle, right_duty_cycle);
 
-    // Update the duty cycle for both motors to 0%
-    Timer_A0_Update_Duty_Cycle_1(0);
-    Timer_A0_Update_Duty_Cycle_2(0);
+    // Take the time of the command for the latency measurement (see Latency_Test.h)
+    Latency_Test_Motor_Command();
 }
@@ -245,15 +245,24 @@ void Nokia5110_Config()
     Nokia5110_Command_Write(0x0C);
 }
 
+// Set by Nokia5110_Init, the LCD is not written while EUSCI_A3 and P9.6 are used by another driver
+static uint8_t Nokia5110_Ready;
+
 void Nokia5110_Init()
 {
     Nokia5110_SPI_Init();
+    Nokia5110_Ready = 1;
     Nokia5110_Reset();
     Nokia5110_Config();
 }
 
 void Nokia5110_Command_Write(uint8_t command)
 {
+    if (Nokia5110_Ready == 0)
+    {
+        return;
+    }
+
     // UCBUSY - Wait until SPI is not busy
     while((EUSCI_A3->STATW & 0x0001) == 0x0001);
 
@@ -269,6 +278,11 @@ void Nokia5110_Command_Write(uint8_t command)
 
 void Nokia5110_Data_Write(uint8_t data)
 {
+    if (Nokia5110_Ready == 0)
+    {
+        return;
+    }
+
     // Wait until UCA3TXBUF is empty
     while((EUSCI_A3->IFG & 0x0002) == 0x0000);
 
@@ -300,48 +314,31 @@ void Nokia5110_OutString(char *ptr)
     }
 }
 
-void Nokia5110_OutUDec(uint16_t n)
+// Format a 16-bit unsigned number as five right-justified digits
+static void Nokia5110_Format_UDec(uint16_t n, char message[6])
 {
-    if (n < 10)
-    {
-        Nokia5110_OutString("    ");
-        Nokia5110_OutChar(n + '0'); /* n is between 0 and 9 */
-    }
-    else if (n < 100)
-    {
-        Nokia5110_OutString("   ");
-        Nokia5110_OutChar(n/10 + '0'); /* tens digit */
-        Nokia5110_OutChar(n%10 + '0'); /* ones digit */
-    }
-    else if (n < 1000)
-    {
-        Nokia5110_OutString("  ");
-        Nokia5110_OutChar(n/100 + '0'); /* hundreds digit */
-        n = n%100;
-        Nokia5110_OutChar(n/10 + '0'); /* tens digit */
-        Nokia5110_OutChar(n%10 + '0'); /* ones digit */
-    }
-    else if (n < 10000)
-    {
-        Nokia5110_OutChar(' ');
-        Nokia5110_OutChar(n/1000 + '0'); /* thousands digit */
-        n = n%1000;
-        Nokia5110_OutChar(n/100 + '0'); /* hundreds digit */
-        n = n%100;
-        Nokia5110_OutChar(n/10 + '0'); /* tens digit */
-        Nokia5110_OutChar(n%10 + '0'); /* ones digit */
-    }
-    else
+    int i;
+
+    for (i = 4; i >= 0; i = i - 1)
     {
-        Nokia5110_OutChar(n/10000 + '0'); /* ten-thousands digit */
-        n = n%10000;
-        Nokia5110_OutChar(n/1000 + '0'); /* thousands digit */
-        n = n%1000;
-        Nokia5110_OutChar(n/100 + '0'); /* hundreds digit */
-        n = n%100;
-        Nokia5110_OutChar(n/10 + '0'); /* tens digit */
-        Nokia5110_OutChar(n%10 + '0'); /* ones digit */
+        if ((n == 0) && (i < 4))
+        {
+            message[i] = ' ';
+        }
+        else
+        {
+            message[i] = (n%10 + '0');
+            n = n/10;
+        }
     }
+    message[5] = 0;
+}
+
+void Nokia5110_OutUDec(uint16_t n)
+{
+    char message[6];
+    Nokia5110_Format_UDec(n, message);
+    Nokia5110_OutString(message);
 }
 
 void Nokia5110_OutSDec(int16_t n)
@@ -522,6 +519,9 @@ void Nokia5110_Clear()
         Nokia5110_Data_Write(0x00);
     }
     Nokia5110_SetCursor(0, 0);
+
+    // The screen no longer matches the RAM buffer
+    Nokia5110_Invalidate();
 }
 
 void Nokia5110_DrawFullImage(const uint8_t *ptr)
@@ -534,6 +534,79 @@ void Nokia5110_DrawFullImage(const uint8_t *ptr)
 }
 uint8_t Screen[SCREENW*SCREENH/8]; // buffer stores the next image to be printed on the screen
 
+// Range of columns of each page that have changed since the last flush
+// The range is empty when Dirty_Start >= Dirty_End
+static uint8_t Dirty_Start[NOKIA5110_NUM_PAGES] = {SCREENW, SCREENW, SCREENW, SCREENW, SCREENW, SCREENW};
+static uint8_t Dirty_End[NOKIA5110_NUM_PAGES];
+
+// Cursor used by the RAM buffer text functions (column 0 to 83, page 0 to 5)
+static uint8_t Buffer_Cursor_X;
+static uint8_t Buffer_Cursor_Y;
+
+// Set to 1 while a DMA flush is in progress and the next page to check for changes
+static volatile uint8_t DMA_Flush_Active;
+static uint8_t DMA_Flush_Page;
+
+// Extend the changed range of a page so that it includes the given byte of the RAM buffer
+static void Nokia5110_Mark_Dirty(uint16_t index)
+{
+    uint8_t page = index / SCREENW;
+    uint8_t column = index - (page * SCREENW);
+    long sr;
+
+    // The DMA_INT2 interrupt takes the changed ranges during a flush
+    sr = StartCritical();
+    if (column < Dirty_Start[page])
+    {
+        Dirty_Start[page] = column;
+    }
+    if (column >= Dirty_End[page])
+    {
+        Dirty_End[page] = column + 1;
+    }
+    EndCritical(sr);
+}
+
+// Write a byte to the RAM buffer and mark it as changed only if its value is different
+static void Nokia5110_Buffer_Write(uint16_t index, uint8_t value)
+{
+    if (Screen[index] != value)
+    {
+        Screen[index] = value;
+        Nokia5110_Mark_Dirty(index);
+    }
+}
+
+// Take the changed range of a page and mark the page as unchanged
+// Returns the number of bytes to send, or 0 if the page has not changed
+static uint8_t Nokia5110_Take_Dirty_Page(uint8_t page, uint8_t *start)
+{
+    uint8_t length = 0;
+    long sr;
+
+    sr = StartCritical();
+    if (Dirty_Start[page] < Dirty_End[page])
+    {
+        *start = Dirty_Start[page];
+        length = Dirty_End[page] - Dirty_Start[page];
+    }
+    Dirty_Start[page] = SCREENW;
+    Dirty_End[page] = 0;
+    EndCritical(sr);
+
+    return length;
+}
+
+// Move the address of the LCD to the given column and page
+static void Nokia5110_Set_Address(uint8_t column, uint8_t page)
+{
+    // Setting bit 7 updates X-position
+    Nokia5110_Command_Write(0x80 | column);
+
+    // Setting bit 6 updates Y-position
+    Nokia5110_Command_Write(0x40 | page);
+}
+
 void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t threshold){
   int32_t width = ptr[18], height = ptr[22], i, j;
   uint16_t screenx, screeny;
@@ -558,16 +631,16 @@ void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t
   for(i=1; i<=(width*height/2); i=i+1){
     // the left pixel is in the upper 4 bits
     if(((ptr[j]>>4)&0xF) > threshold){
-      Screen[screenx] |= mask;
+      Nokia5110_Buffer_Write(screenx, Screen[screenx] | mask);
     } else{
-      Screen[screenx] &= ~mask;
+      Nokia5110_Buffer_Write(screenx, Screen[screenx] & ~mask);
     }
     screenx = screenx + 1;
     // the right pixel is in the lower 4 bits
     if((ptr[j]&0xF) > threshold){
-      Screen[screenx] |= mask;
+      Nokia5110_Buffer_Write(screenx, Screen[screenx] | mask);
     } else{
-      Screen[screenx] &= ~mask;
+      Nokia5110_Buffer_Write(screenx, Screen[screenx] & ~mask);
     }
     screenx = screenx + 1;
     j = j + 1;
@@ -595,23 +668,217 @@ void Nokia5110_ClearBuffer()
     int i;
     for(i=0; i<SCREENW*SCREENH/8; i=i+1)
     {
-        Screen[i] = 0;              // clear buffer
+        Nokia5110_Buffer_Write(i, 0);   // clear buffer
     }
+    Buffer_Cursor_X = 0;
+    Buffer_Cursor_Y = 0;
 }
 
 void Nokia5110_DisplayBuffer()
 {
-  Nokia5110_DrawFullImage(Screen);
+    uint8_t page;
+    uint8_t start;
+    uint8_t length;
+    uint8_t i;
+
+    // Wait until a DMA flush in progress has completed
+    while (DMA_Flush_Active);
+
+    for (page = 0; page < NOKIA5110_NUM_PAGES; page = page + 1)
+    {
+        length = Nokia5110_Take_Dirty_Page(page, &start);
+        if (length > 0)
+        {
+            Nokia5110_Set_Address(start, page);
+            for (i = 0; i < length; i = i + 1)
+            {
+                Nokia5110_Data_Write(Screen[(page * SCREENW) + start + i]);
+            }
+        }
+    }
+}
+
+// Start the DMA transfer of the next page that has changed, or finish the flush
+static void Nokia5110_DMA_Flush_Next_Page()
+{
+    DMA_Control_Structure *control = DMA_Get_Primary_Control(NOKIA5110_DMA_CHANNEL);
+    uint8_t start;
+    uint8_t length = 0;
+
+    while ((DMA_Flush_Page < NOKIA5110_NUM_PAGES) && (length == 0))
+    {
+        length = Nokia5110_Take_Dirty_Page(DMA_Flush_Page, &start);
+        DMA_Flush_Page = DMA_Flush_Page + 1;
+    }
+
+    if (length == 0)
+    {
+        // Wait until the last data byte has been shifted out before releasing the SPI bus
+        while((EUSCI_A3->STATW & 0x0001) == 0x0001);
+        DMA_Flush_Active = 0;
+        return;
+    }
+
+    // Nokia5110_Command_Write waits until the previous page has been shifted out
+    Nokia5110_Set_Address(start, DMA_Flush_Page - 1);
+
+    // Set the Data/Command output pin to 1 for the data bytes sent by the DMA controller
+    Nokia5110_SPI_Data_Command_Bit_Out(0x01);
+
+    // Basic cycle of byte transfers from the RAM buffer to UCA3TXBUF, one byte per UCTXIFG request
+    control->Source_End_Pointer = &Screen[((DMA_Flush_Page - 1) * SCREENW) + start + length - 1];
+    control->Destination_End_Pointer = &EUSCI_A3->TXBUF;
+    control->Control = DMA_CTL_DST_INC_NONE | DMA_CTL_DST_SIZE_BYTE | DMA_CTL_SRC_INC_BYTE | DMA_CTL_SRC_SIZE_BYTE
+            | DMA_CTL_ARBITRATE_1 | DMA_CTL_TRANSFER_COUNT(length) | DMA_CTL_CYCLE_BASIC;
+
+    DMA_Enable_Channel(NOKIA5110_DMA_CHANNEL);
+
+    // The trigger is generated on the rising edge of UCTXIFG, so toggle the flag to request the first byte
+    EUSCI_A3->IFG &= ~0x0002;
+    EUSCI_A3->IFG |= 0x0002;
+}
+
+void Nokia5110_DMA_Init()
+{
+    DMA_Init();
+
+    DMA_Assign_Channel(NOKIA5110_DMA_CHANNEL, NOKIA5110_DMA_SOURCE);
+
+    // DMA_INT2 starts the transfer of the next changed page
+    DMA_Assign_Interrupt(NOKIA5110_DMA_INTERRUPT, NOKIA5110_DMA_CHANNEL, &Nokia5110_DMA_Flush_Next_Page);
+}
+
+void Nokia5110_DisplayBuffer_DMA()
+{
+    long sr;
+
+    if (Nokia5110_Ready == 0)
+    {
+        return;
+    }
+
+    sr = StartCritical();
+    if (DMA_Flush_Active)
+    {
+        EndCritical(sr);
+        return;
+    }
+    DMA_Flush_Active = 1;
+    DMA_Flush_Page = 0;
+    EndCritical(sr);
+
+    Nokia5110_DMA_Flush_Next_Page();
+}
+
+uint8_t Nokia5110_Flush_Busy()
+{
+    return DMA_Flush_Active;
+}
+
+void Nokia5110_Invalidate()
+{
+    uint8_t page;
+    long sr;
+
+    sr = StartCritical();
+    for (page = 0; page < NOKIA5110_NUM_PAGES; page = page + 1)
+    {
+        Dirty_Start[page] = 0;
+        Dirty_End[page] = SCREENW;
+    }
+    EndCritical(sr);
+}
+
+void Nokia5110_Buffer_SetCursor(uint8_t newX, uint8_t newY)
+{
+    // Return if the input is bad
+    if((newX > 11) || (newY > 5))
+    {
+        return;
+    }
+
+    // Multiply newX by 7 because each character is 7 columns wide
+    Buffer_Cursor_X = newX * 7;
+    Buffer_Cursor_Y = newY;
+}
+
+void Nokia5110_Buffer_OutChar(char data)
+{
+    uint16_t index;
+
+    // Wrap to the next row if the character does not fit, like the LCD address counter does
+    if (Buffer_Cursor_X > (SCREENW - 7))
+    {
+        Buffer_Cursor_X = 0;
+        Buffer_Cursor_Y = (Buffer_Cursor_Y + 1) % NOKIA5110_NUM_PAGES;
+    }
+
+    index = (Buffer_Cursor_Y * SCREENW) + Buffer_Cursor_X;
+
+    // Blank vertical line padding
+    Nokia5110_Buffer_Write(index, 0x00);
+    for(int i = 0; i < 5; i = i + 1)
+    {
+        Nokia5110_Buffer_Write(index + 1 + i, ASCII[data - 0x20][i]);
+    }
+    // Blank vertical line padding
+    Nokia5110_Buffer_Write(index + 6, 0x00);
+
+    Buffer_Cursor_X = Buffer_Cursor_X + 7;
+}
+
+void Nokia5110_Buffer_OutString(char *ptr)
+{
+    while(*ptr)
+    {
+        Nokia5110_Buffer_OutChar((unsigned char)*ptr);
+        ptr = ptr + 1;
+    }
+}
+
+void Nokia5110_Buffer_OutUDec(uint16_t n)
+{
+    char message[6];
+    Nokia5110_Format_UDec(n, message);
+    Nokia5110_Buffer_OutString(message);
+}
+
+void Nokia5110_Get_Glyph(char data, uint8_t glyph[NOKIA5110_GLYPH_WIDTH])
+{
+    // Blank vertical line padding on both sides of the 5 columns of the font
+    glyph[0] = 0x00;
+    for(int i = 0; i < 5; i = i + 1)
+    {
+        glyph[1 + i] = ASCII[data - 0x20][i];
+    }
+    glyph[6] = 0x00;
+}
+
+void Nokia5110_Buffer_Draw_Glyph(uint8_t newX, uint8_t newY, const uint8_t glyph[NOKIA5110_GLYPH_WIDTH])
+{
+    uint16_t index;
+
+    // Return if the input is bad
+    if((newX > 11) || (newY > 5))
+    {
+        return;
+    }
+
+    index = (newY * SCREENW) + (newX * NOKIA5110_GLYPH_WIDTH);
+    for(int i = 0; i < NOKIA5110_GLYPH_WIDTH; i = i + 1)
+    {
+        Nokia5110_Buffer_Write(index + i, glyph[i]);
+    }
 }
 
 const unsigned char Masks[8]={0x01,0x02,0x04,0x08,0x10,0x20,0x40,0x80};
 
 void Nokia5110_ClrPxl(uint32_t i, uint32_t j)
 {
-  Screen[84*(i>>3) + j] &= ~Masks[i&0x07];
+  Nokia5110_Buffer_Write(84*(i>>3) + j, Screen[84*(i>>3) + j] & ~Masks[i&0x07]);
 }
 
 void Nokia5110_SetPxl(uint32_t i, uint32_t j)
 {
-  Screen[84*(i>>3) + j] |= Masks[i&0x07];
+  Nokia5110_Buffer_Write(84*(i>>3) + j, Screen[84*(i>>3) + j] | Masks[i&0x07]);
 }
@@ -32,6 +32,7 @@
  */
 
 #include "../inc/OPT3001.h"
+#include "../inc/Interrupt_Priority.h"
 
 // An enumeration that defines constants for various commands that can be sent
 // to the OPT3001 Ambient Light Sensor. Each constant represents a specific command
@@ -71,6 +72,25 @@ typedef union{
 // Declare a config struct used when reading the configuration register
 OPT3001_Config Read_Sensor_Configuration;
 
+// Transactions executed by the EUSCI_B1 interrupt after a falling edge of INT, with their buffers
+static EUSCI_B1_I2C_Transaction OPT3001_Result_Transaction;
+static EUSCI_B1_I2C_Transaction OPT3001_Low_Limit_Transaction;
+static EUSCI_B1_I2C_Transaction OPT3001_High_Limit_Transaction;
+static EUSCI_B1_I2C_Transaction OPT3001_Config_Transaction;
+static const uint8_t OPT3001_Result_Command = RESULT;
+static const uint8_t OPT3001_Config_Command = CONFIG;
+static uint8_t OPT3001_Result_Buffer[2];
+static uint8_t OPT3001_Config_Buffer[2];
+static uint8_t OPT3001_Low_Limit_Buffer[3];
+static uint8_t OPT3001_High_Limit_Buffer[3];
+
+// Set from the falling edge of INT until the configuration register has been read
+static volatile uint8_t OPT3001_Busy;
+
+static void (*OPT3001_Lux_Handler)(uint32_t centi_lux);
+static volatile uint32_t OPT3001_Last_Centi_Lux;
+static volatile uint32_t OPT3001_Errors;
+
 /**
  * @brief Writes a single command byte to the OPT3001 light sensor via I2C.
  *
@@ -160,6 +180,8 @@ OPT3001_Config static OPT3001_Read_Configuration()
 
 void OPT3001_Init()
 {
+    EUSCI_B1_I2C_Set_Device_Clock(OPT3001_ADDRESS, OPT3001_I2C_SCL_HZ);
+
     // Configure pins P4.2 and P4.5 as GPIO pins
     P4->SEL0 &= ~0x24;
     P4->SEL1 &= ~0x24;
@@ -182,8 +204,9 @@ void OPT3001_Init()
     // Provide a short 1 ms delay after configuring pins
     Clock_Delay1ms(1);
 
-    // Instantiate new configuration struct
+    // Instantiate new configuration struct, the fields that are not set are cleared
     OPT3001_Config New_Config;
+    New_Config.RawData = 0;
 
     // Set RN (Bits 15-12) to 0x0C
     // This configures the device to operate in automatic
@@ -219,3 +242,179 @@ OPT3001_Result OPT3001_Read_Light()
     // This register contains the most recent light to digital conversion
     return OPT3001_Read_Register(RESULT);
 }
+
+uint32_t OPT3001_Get_Centi_Lux(OPT3001_Result result)
+{
+    return (uint32_t)result.Result << result.Exponent;
+}
+
+// Encodes a value in 0.01 lux in the format of the limit registers, rounded down
+static uint16_t OPT3001_Encode_Limit(uint32_t centi_lux)
+{
+    uint8_t exponent = 0;
+
+    while ((centi_lux > 0x0FFF) && (exponent < 11))
+    {
+        centi_lux = centi_lux >> 1;
+        exponent++;
+    }
+
+    if (centi_lux > 0x0FFF)
+    {
+        centi_lux = 0x0FFF;
+    }
+
+    return ((uint16_t)exponent << 12) | (uint16_t)centi_lux;
+}
+
+// Fills a register write of a limit register
+static void OPT3001_Set_Limit_Buffer(uint8_t *buffer, uint8_t register_address, uint16_t register_data)
+{
+    buffer[0] = register_address;
+    buffer[1] = (register_data >> 8) & 0xFF;
+    buffer[2] = register_data & 0xFF;
+}
+
+// Executed by the EUSCI_B1 interrupt when the configuration register has been read, which releases INT
+static void OPT3001_Config_Complete(EUSCI_B1_I2C_Transaction *transaction)
+{
+    if (transaction->Status != EUSCI_B1_I2C_STATUS_DONE)
+    {
+        OPT3001_Errors = OPT3001_Errors + 1;
+    }
+
+    OPT3001_Busy = 0;
+}
+
+// Executed by the EUSCI_B1 interrupt when the result has been read: report it and center the window on it
+static void OPT3001_Result_Complete(EUSCI_B1_I2C_Transaction *transaction)
+{
+    OPT3001_Result result;
+    uint32_t centi_lux;
+    uint32_t half_width;
+    int status = 0;
+
+    if (transaction->Status == EUSCI_B1_I2C_STATUS_DONE)
+    {
+        result.RawData = OPT3001_Result_Buffer[1] + ((uint16_t)OPT3001_Result_Buffer[0] << 8);
+        centi_lux = OPT3001_Get_Centi_Lux(result);
+        OPT3001_Last_Centi_Lux = centi_lux;
+
+        half_width = (centi_lux / 100) * OPT3001_WINDOW_PERCENT;
+        if (half_width < OPT3001_WINDOW_MIN_CENTI_LUX)
+        {
+            half_width = OPT3001_WINDOW_MIN_CENTI_LUX;
+        }
+
+        OPT3001_Set_Limit_Buffer(OPT3001_Low_Limit_Buffer, LOW_LIMIT, OPT3001_Encode_Limit((centi_lux > half_width) ? (centi_lux - half_width) : 0));
+        OPT3001_Set_Limit_Buffer(OPT3001_High_Limit_Buffer, HIGH_LIMIT, OPT3001_Encode_Limit(centi_lux + half_width));
+        status |= EUSCI_B1_I2C_Write_Read_Async(&OPT3001_Low_Limit_Transaction, OPT3001_ADDRESS, OPT3001_Low_Limit_Buffer, 3, 0, 0, 0);
+        status |= EUSCI_B1_I2C_Write_Read_Async(&OPT3001_High_Limit_Transaction, OPT3001_ADDRESS, OPT3001_High_Limit_Buffer, 3, 0, 0, 0);
+        if (status != 0)
+        {
+            // The previous window is kept, so a later result outside of it is still reported
+            OPT3001_Errors = OPT3001_Errors + 1;
+        }
+
+        if (OPT3001_Lux_Handler != 0)
+        {
+            (*OPT3001_Lux_Handler)(centi_lux);
+        }
+    }
+    else
+    {
+        OPT3001_Errors = OPT3001_Errors + 1;
+    }
+
+    // Reading the configuration register clears the latched INT output
+    if (EUSCI_B1_I2C_Write_Read_Async(&OPT3001_Config_Transaction, OPT3001_ADDRESS, &OPT3001_Config_Command, 1,
+                                      OPT3001_Config_Buffer, 2, &OPT3001_Config_Complete) != 0)
+    {
+        // OPT3001_Acquisition_Task restarts the read since INT stays low
+        OPT3001_Errors = OPT3001_Errors + 1;
+        OPT3001_Busy = 0;
+    }
+}
+
+// Queues the read of the result, unless the previous read is in progress
+static void OPT3001_Start_Read(void)
+{
+    long sr;
+
+    sr = StartCritical();
+    if (OPT3001_Busy)
+    {
+        EndCritical(sr);
+        return;
+    }
+    OPT3001_Busy = 1;
+    EndCritical(sr);
+
+    if (EUSCI_B1_I2C_Write_Read_Async(&OPT3001_Result_Transaction, OPT3001_ADDRESS, &OPT3001_Result_Command, 1,
+                                      OPT3001_Result_Buffer, 2, &OPT3001_Result_Complete) != 0)
+    {
+        OPT3001_Errors = OPT3001_Errors + 1;
+        OPT3001_Busy = 0;
+    }
+}
+
+void OPT3001_Acquisition_Init(void (*handler)(uint32_t centi_lux))
+{
+    OPT3001_Config config;
+
+    OPT3001_Lux_Handler = handler;
+    OPT3001_Busy = 0;
+    OPT3001_Last_Centi_Lux = 0;
+    OPT3001_Errors = 0;
+
+    // Start with an empty window above the low limit of zero, so that the first result is reported
+    OPT3001_Write_Register(LOW_LIMIT, 0x0000);
+    OPT3001_Write_Register(HIGH_LIMIT, 0x0000);
+
+    // Automatic full-scale range, 100 ms conversions, continuous conversions, latched window comparison,
+    // active low INT, and one fault before INT is asserted
+    config.RawData = 0;
+    config.RangeNumber = 0x0C;
+    config.ConversionTime = 0;
+    config.ModeOfConversionOperation = 3;
+    config.Latch = 1;
+    config.Polarity = 0;
+    config.FaultCount = 0;
+    OPT3001_Write_Configuration(config);
+
+    // Interrupt Edge Select: High-to-Low Transition of INT on P4.2, and clear a previous edge
+    P4->IES |= OPT3001_INT_PIN;
+    P4->IFG &= ~OPT3001_INT_PIN;
+    P4->IE |= OPT3001_INT_PIN;
+
+    // Set the priority level of the PORT4 interrupt (IRQ 38), shared with the bumper switches, and enable it in NVIC (Bit 6 of ISER[1])
+    NVIC->IP[38] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_PORT4);
+    NVIC->ISER[1] = 0x00000040;
+}
+
+void OPT3001_Handle_Interrupt(uint8_t port_flags)
+{
+    if (port_flags & OPT3001_INT_PIN)
+    {
+        OPT3001_Start_Read();
+    }
+}
+
+void OPT3001_Acquisition_Task(void)
+{
+    // INT stays low until the configuration register is read, so a lost edge leaves it low
+    if (((P4->IN & OPT3001_INT_PIN) == 0) && (OPT3001_Busy == 0))
+    {
+        OPT3001_Start_Read();
+    }
+}
+
+uint32_t OPT3001_Get_Last_Centi_Lux(void)
+{
+    return OPT3001_Last_Centi_Lux;
+}
+
+uint32_t OPT3001_Get_Errors(void)
+{
+    return OPT3001_Errors;
+}
@@ -1,4 +1,6 @@
 #include "../inc/OPT3101.h"
+#include "../inc/Interrupt_Priority.h"
+#include "../inc/Profiler.h"
 
 // edited by Valvano and Valvano 12/22/2019
 // hardware
@@ -11,6 +13,12 @@
 // RST_MS OPT3101 pin 17 <- P6.3/AUXL/nRST_MS output low to reset the OPT3101
 #define I2C_ADDRESS 0x58
 
+// MCLK cycles per us at the current MCLK frequency, used to time the reset with the DWT cycle counter
+#define OPT3101_CYCLES_PER_US (Clock_GetFreq() / 1000000)
+
+// Cycle counter value at the start, then at the release, of the reset pulse
+static uint32_t OPT3101_Reset_Cycles;
+
 // (speed of light) / (2 * 10 MHz * 0x10000) = 0.22872349395 mm
 // Valvano removed floating point, converted to binary fixed point
 #define MM_PER_PHASE_COUNT 0.22872349395
@@ -54,12 +62,28 @@ void OPT3101_WriteRegister(uint8_t address, uint32_t data)
 
 void OPT3101_Init(void)
 {
-    // Drive P6.3/AUXL/nRST_MS low to reset the OPT3101, then drive it high.
+    OPT3101_Reset_Start();
+    OPT3101_Reset_Release();
+    OPT3101_Wait_Ready(OPT3101_READY_TIMEOUT_US);
+}
+
+void OPT3101_Reset_Start(void)
+{
+    // Only stored in the device table of the bus, which can be done before EUSCI_B1_I2C_Init
+    EUSCI_B1_I2C_Set_Device_Clock(I2C_ADDRESS, OPT3101_I2C_SCL_HZ);
+
+    // Drive P6.3/AUXL/nRST_MS low to reset the OPT3101.
     P6->OUT &= ~0x08;
     P6->DIR |= 0x08;
-    Clock_Delay1ms(1);
+    OPT3101_Reset_Cycles = CycleCounter_Read();
+}
+
+void OPT3101_Reset_Release(void)
+{
+    // Only wait for the part of the reset pulse that has not been used by the other initializations.
+    CycleCounter_Wait(OPT3101_Reset_Cycles, OPT3101_RESET_TIME_US * OPT3101_CYCLES_PER_US);
     P6->OUT |= 0x08;
-    Clock_Delay1ms(1);
+    OPT3101_Reset_Cycles = CycleCounter_Read();
 
     // Make P6.2/AUXR be an input for the DATA_RDY signal.
     P6->DIR &= ~0x04;
@@ -69,12 +93,22 @@ void OPT3101_Init(void)
 
     // Clear the P6.2/AUXR interrupt flag.
     P6->IFG &= ~0x04;
+}
 
-    // Wait until INIT_LOAD_DONE gets set to 1.
+int OPT3101_Wait_Ready(uint32_t timeout_us)
+{
+    CycleCounter_Wait(OPT3101_Reset_Cycles, OPT3101_BOOT_TIME_US * OPT3101_CYCLES_PER_US);
+
+    // Poll until INIT_LOAD_DONE gets set to 1.
     while(!(OPT3101_ReadRegister(0x03) & 0x100))
     {
-        Clock_Delay1ms(1);
+        if((CycleCounter_Read() - OPT3101_Reset_Cycles) >= (timeout_us * OPT3101_CYCLES_PER_US))
+        {
+            return -1;
+        }
     }
+
+    return 0;
 }
 
 //uint32_t Reg2a;
@@ -279,15 +313,9 @@ bool OPT3101_CheckDistanceSensor(void)
 }
 uint32_t ChannelCount[3]; // debugging monitor
 
-uint32_t OPT3101_GetMeasurement(uint32_t distances[3], uint32_t amplitudes[3])
+// Replaces the distance with a validity code when the measurement cannot be used
+static uint32_t OPT3101_ValidateDistance(uint32_t distance, uint32_t amplitude)
 {
-    uint32_t channel,distance,amplitude;
-    OPT3101_ReadMeasurement();
-
-    distance  = OPT3101_GetDistanceMillimeters();
-    amplitude = OPT3101_GetAmplitude();
-    channel   = OPT3101_GetTxChannel();
-
     if (OPT3101_MeasurementError())
     {
         // Something went wrong getting the measurement.
@@ -307,6 +335,18 @@ uint32_t OPT3101_GetMeasurement(uint32_t distances[3], uint32_t amplitudes[3])
         // calibration), so report 65533.
         distance = 65533;
     }
+    return distance;
+}
+
+uint32_t OPT3101_GetMeasurement(uint32_t distances[3], uint32_t amplitudes[3])
+{
+    uint32_t channel,distance,amplitude;
+    OPT3101_ReadMeasurement();
+
+    distance  = OPT3101_GetDistanceMillimeters();
+    amplitude = OPT3101_GetAmplitude();
+    channel   = OPT3101_GetTxChannel();
+    distance  = OPT3101_ValidateDistance(distance, amplitude);
 
     // Clear the pin-change interrupt flag.
     P6->IFG &= ~(1 << 2);
@@ -335,7 +375,7 @@ void OPT3101_ArmInterrupts(uint32_t *pTxChan, uint32_t distances[3], uint32_t am
     // Clear the P6.2/AUXR interrupt flag.
     P6->IFG &= ~0x04;
     P6->IE = 0x04;  // arm interrupt only on P6.2
-    NVIC->IP[40] = 0x40; // priority 2
+    NVIC->IP[40] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_PORT6); // see Interrupt_Priority.h
     NVIC->ISER[1] = 0x00000100;  // enable interrupt 40 in NVIC
 }
 
@@ -343,9 +383,227 @@ uint32_t ISRTime; // bus cycle time (1us)
 uint32_t ISRLast;    // last time (20.83ns)
 uint32_t ISRPeriod;
 
+// Background acquisition: one transaction descriptor is used for every step of the
+// pipeline (read 0x08, read 0x09, select the next channel, trigger), so only one
+// OPT3101 transaction is queued at a time
+#define ACQUISITION_IDLE     0
+#define ACQUISITION_READ_08  1
+#define ACQUISITION_READ_09  2
+#define ACQUISITION_SELECT   3
+#define ACQUISITION_TRIGGER  4
+static EUSCI_B1_I2C_Transaction Acquisition_Transaction;
+static volatile uint8_t Acquisition_Stage;
+static uint8_t Acquisition_Active = 0;
+static uint8_t Acquisition_Address;
+static uint8_t Acquisition_RX[3];
+static uint8_t Acquisition_TX[4];
+static uint32_t Acquisition_Reg2a;
+static uint32_t Acquisition_Channel;
+static uint32_t Acquisition_Timestamp;
+static volatile uint32_t Acquisition_Idle_Count;
+
+static OPT3101_Sample Acquisition_Ring[3][OPT3101_RING_LENGTH];
+static volatile uint32_t Acquisition_Count[3];
+
+static void OPT3101_Acquisition_Complete(EUSCI_B1_I2C_Transaction *transaction);
+
+static void OPT3101_Acquisition_Read(uint8_t address, uint8_t stage)
+{
+    Acquisition_Address = address;
+    Acquisition_Stage = stage;
+    if (EUSCI_B1_I2C_Write_Read_Async(&Acquisition_Transaction, I2C_ADDRESS, &Acquisition_Address, 1,
+                                      Acquisition_RX, 3, &OPT3101_Acquisition_Complete) != 0)
+    {
+        // The queue is full: OPT3101_Acquisition_Task restarts the measurement later
+        Acquisition_Stage = ACQUISITION_IDLE;
+    }
+}
+
+static void OPT3101_Acquisition_Write(uint8_t address, uint32_t data, uint8_t stage)
+{
+    Acquisition_TX[0] = address;
+    Acquisition_TX[1] = data & 0xFF;
+    Acquisition_TX[2] = (data >> 8) & 0xFF;
+    Acquisition_TX[3] = (data >> 16) & 0xFF;
+    Acquisition_Stage = stage;
+    if (EUSCI_B1_I2C_Write_Read_Async(&Acquisition_Transaction, I2C_ADDRESS, Acquisition_TX, 4,
+                                      0, 0, &OPT3101_Acquisition_Complete) != 0)
+    {
+        Acquisition_Stage = ACQUISITION_IDLE;
+    }
+}
+
+static uint32_t OPT3101_Acquisition_Value(void)
+{
+    return Acquisition_RX[0] + ((uint32_t)Acquisition_RX[1] << 8) + ((uint32_t)Acquisition_RX[2] << 16);
+}
+
+static void OPT3101_Acquisition_Store(void)
+{
+    OPT3101_Sample *sample;
+    uint32_t channel;
+    uint32_t distance;
+    uint32_t amplitude;
+
+    if (Acquisition_Transaction.Status == EUSCI_B1_I2C_STATUS_DONE)
+    {
+        reg09 = OPT3101_Acquisition_Value();
+        distance = OPT3101_ValidateDistance(OPT3101_GetDistanceMillimeters(), OPT3101_GetAmplitude());
+        amplitude = OPT3101_GetAmplitude();
+    }
+    else
+    {
+        distance = OPT3101_DISTANCE_ERROR;
+        amplitude = 0;
+    }
+
+    // A channel of 3 means that reg08 was not read correctly, so use the channel that was started
+    channel = OPT3101_GetTxChannel();
+    if ((channel > 2) || (distance == OPT3101_DISTANCE_ERROR))
+    {
+        channel = Acquisition_Channel;
+    }
+
+    sample = &Acquisition_Ring[channel][Acquisition_Count[channel] & (OPT3101_RING_LENGTH - 1)];
+    sample->Timestamp = Acquisition_Timestamp;
+    sample->Distance = distance;
+    sample->Amplitude = amplitude;
+    Acquisition_Count[channel] = Acquisition_Count[channel] + 1;
+}
+
+static void OPT3101_Acquisition_Start_Channel(void)
+{
+    // EN_TX_SWITCH = 0 and SEL_TX_CH bits 2:1 select the channel
+    OPT3101_Acquisition_Write(0x2a, (Acquisition_Reg2a & ~0x07) | (Acquisition_Channel << 1), ACQUISITION_SELECT);
+}
+
+// Executed from the EUSCI_B1 interrupt when a pipeline step has completed
+static void OPT3101_Acquisition_Complete(EUSCI_B1_I2C_Transaction *transaction)
+{
+    switch (Acquisition_Stage)
+    {
+        case ACQUISITION_READ_08:
+            reg08 = (transaction->Status == EUSCI_B1_I2C_STATUS_DONE) ? OPT3101_Acquisition_Value() : 0;
+            OPT3101_Acquisition_Read(0x09, ACQUISITION_READ_09);
+            break;
+
+        case ACQUISITION_READ_09:
+            OPT3101_Acquisition_Store();
+            Acquisition_Channel = (Acquisition_Channel + 1) % 3;
+            OPT3101_Acquisition_Start_Channel();
+            break;
+
+        case ACQUISITION_SELECT:
+            // Set MONOSHOT_BIT to 1 to trigger a new measurement.
+            OPT3101_Acquisition_Write(0x00, 0x800000, ACQUISITION_TRIGGER);
+            break;
+
+        default:
+            // Wait for the DATA_RDY interrupt
+            Acquisition_Stage = ACQUISITION_IDLE;
+            break;
+    }
+}
+
+void OPT3101_Acquisition_Init(void)
+{
+    Acquisition_Count[0] = 0;
+    Acquisition_Count[1] = 0;
+    Acquisition_Count[2] = 0;
+    Acquisition_Channel = 0;
+    Acquisition_Idle_Count = 0;
+
+    // The distances are read by the control loop, so the pipeline steps pass the queued PMOD Color and OPT3001 reads
+    // Note: Only one step is queued at a time, so the other devices still get the bus between two steps
+    Acquisition_Transaction.Priority = EUSCI_B1_I2C_PRIORITY_HIGH;
+
+    // EN_ADAPTIVE_HDR = 1, the rest of register 0x2a is kept for every channel switch
+    Acquisition_Reg2a = OPT3101_ReadRegister(0x2a) | 0x8000;
+    Acquisition_Active = 1;
+
+    // Make P6.2/AUXR be an input for the DATA_RDY signal, interrupt on low-to-high transitions.
+    P6->DIR &= ~0x04;
+    P6->IES &= ~0x04;
+    P6->IFG &= ~0x04;
+    P6->IE = 0x04;
+    NVIC->IP[40] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_PORT6); // see Interrupt_Priority.h
+    NVIC->ISER[1] = 0x00000100;  // enable interrupt 40 in NVIC
+
+    OPT3101_Acquisition_Start_Channel();
+}
+
+void OPT3101_Acquisition_Task(void)
+{
+    long sr;
+
+    if (Acquisition_Active == 0)
+    {
+        return;
+    }
+
+    // The PORT6 interrupt also starts the pipeline from the idle stage
+    sr = StartCritical();
+    if (Acquisition_Stage == ACQUISITION_IDLE)
+    {
+        Acquisition_Idle_Count = Acquisition_Idle_Count + 1;
+        if (Acquisition_Idle_Count >= OPT3101_ACQUISITION_TIMEOUT)
+        {
+            Acquisition_Idle_Count = 0;
+            OPT3101_Acquisition_Start_Channel();
+        }
+    }
+    EndCritical(sr);
+}
+
+uint32_t OPT3101_Get_Sample_Count(uint32_t channel)
+{
+    return (channel <= 2) ? Acquisition_Count[channel] : 0;
+}
+
+int OPT3101_Get_Sample(uint32_t channel, uint32_t age, OPT3101_Sample *sample)
+{
+    uint32_t count;
+    long sr;
+
+    if ((channel > 2) || (age >= OPT3101_RING_LENGTH))
+    {
+        return -1;
+    }
+
+    sr = StartCritical();
+    count = Acquisition_Count[channel];
+    if (count <= age)
+    {
+        EndCritical(sr);
+        return -1;
+    }
+    *sample = Acquisition_Ring[channel][(count - 1 - age) & (OPT3101_RING_LENGTH - 1)];
+    EndCritical(sr);
+
+    return 0;
+}
+
 // *PTxChan set to 0,1,2 when measurement done
 void PORT6_IRQHandler(void)
 {
-    *PTxChan = OPT3101_GetMeasurement(Pdistances,Pamplitudes);
-    P6->IFG = 0x00;            // clear all flags
+    PROFILER_START(PROFILER_PORT6);
+
+    if (Acquisition_Active)
+    {
+        // Timestamp the DATA_RDY edge, then read the results in the background
+        Acquisition_Timestamp = CycleCounter_Read();
+        Acquisition_Idle_Count = 0;
+        P6->IFG = 0x00;            // clear all flags
+        if (Acquisition_Stage == ACQUISITION_IDLE)
+        {
+            OPT3101_Acquisition_Read(0x08, ACQUISITION_READ_08);
+        }
+    }
+    else
+    {
+        *PTxChan = OPT3101_GetMeasurement(Pdistances,Pamplitudes);
+        P6->IFG = 0x00;            // clear all flags
+    }
+
+    PROFILER_STOP(PROFILER_PORT6);
 }
@@ -0,0 +1,172 @@
+/**
+ * @file Odometry.c
+ * @brief Source code for the Odometry driver.
+ *
+ * This file contains the function definitions for the Odometry driver.
+ * It estimates the pose (x, y, heading) of the differential-drive robot from the tachometer
+ * step counts using fixed-point arithmetic only.
+ *
+ */
+
+#include "../inc/Odometry.h"
+
+// Quarter-wave sine table in Q15 format: Sine_Table[i] = 32767 * sin(i * 90 / 64 degrees)
+static const int16_t Sine_Table[65] =
+{
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+     6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767
+};
+
+// Current pose of the robot
+static Odometry_Pose Odometry_Current_Pose;
+
+// Distance traveled by the center of the robot since Odometry_Init in um, backwards driving is subtracted
+static int32_t Odometry_Distance_um;
+
+// Step counts at the previous update
+static int32_t Odometry_Last_Left_Steps;
+static int32_t Odometry_Last_Right_Steps;
+
+static void Odometry_Get_Steps(int32_t *left_steps, int32_t *right_steps)
+{
+    uint16_t left_tach;
+    uint16_t right_tach;
+    enum Tachometer_Direction left_dir;
+    enum Tachometer_Direction right_dir;
+
+    Tachometer_Get(&left_tach, &left_dir, left_steps, &right_tach, &right_dir, right_steps);
+}
+
+void Odometry_Init()
+{
+    Odometry_Pose origin = {0, 0, ODOMETRY_HEADING_0};
+
+    Odometry_Distance_um = 0;
+    Odometry_Reset(&origin);
+}
+
+void Odometry_Reset(const Odometry_Pose *pose)
+{
+    long sr;
+
+    sr = StartCritical();
+    Odometry_Current_Pose = *pose;
+    Odometry_Get_Steps(&Odometry_Last_Left_Steps, &Odometry_Last_Right_Steps);
+    EndCritical(sr);
+}
+
+void Odometry_Update()
+{
+    int32_t left_steps;
+    int32_t right_steps;
+    int32_t delta_left;
+    int32_t delta_right;
+    int32_t distance_um;
+    uint32_t heading_change;
+    uint32_t mid_heading;
+
+    Odometry_Get_Steps(&left_steps, &right_steps);
+
+    delta_left = left_steps - Odometry_Last_Left_Steps;
+    delta_right = right_steps - Odometry_Last_Right_Steps;
+    Odometry_Last_Left_Steps = left_steps;
+    Odometry_Last_Right_Steps = right_steps;
+
+    if ((delta_left == 0) && (delta_right == 0))
+    {
+        return;
+    }
+
+    // Distance traveled by the center of the robot and change of heading
+    distance_um = ((delta_left + delta_right) * ODOMETRY_UM_PER_STEP) / 2;
+    heading_change = (uint32_t)(delta_right - delta_left) * ODOMETRY_HEADING_PER_STEP;
+
+    // Apply the distance along the heading at the middle of the update interval
+    // Note: The signed shift keeps the direction of the heading change
+    mid_heading = Odometry_Current_Pose.Heading + (uint32_t)((int32_t)heading_change >> 1);
+
+    Odometry_Current_Pose.X_um = Odometry_Current_Pose.X_um + ((distance_um * Odometry_Cos(mid_heading)) >> 15);
+    Odometry_Current_Pose.Y_um = Odometry_Current_Pose.Y_um + ((distance_um * Odometry_Sin(mid_heading)) >> 15);
+    Odometry_Current_Pose.Heading = Odometry_Current_Pose.Heading + heading_change;
+    Odometry_Distance_um = Odometry_Distance_um + distance_um;
+}
+
+void Odometry_Get_Pose(Odometry_Pose *pose)
+{
+    long sr;
+
+    sr = StartCritical();
+    *pose = Odometry_Current_Pose;
+    EndCritical(sr);
+}
+
+int32_t Odometry_Get_Distance_um()
+{
+    return Odometry_Distance_um;
+}
+
+uint32_t Odometry_Get_Heading()
+{
+    return Odometry_Current_Pose.Heading;
+}
+
+int16_t Odometry_Angle_To_Degrees(uint32_t angle)
+{
+    // Round to the nearest degree, then map 180 degrees to -180 degrees
+    int32_t degrees = (((int64_t)(int32_t)angle * 360) + 0x80000000LL) >> 32;
+
+    if (degrees >= 180)
+    {
+        degrees = degrees - 360;
+    }
+
+    return degrees;
+}
+
+int16_t Odometry_Sin(uint32_t angle)
+{
+    // Use the upper 16 bits: 2 bits select the quadrant and 14 bits select the position in the quadrant
+    uint32_t position = (angle >> 16) & 0x3FFF;
+    uint32_t quadrant = angle >> 30;
+    uint32_t index;
+    uint32_t fraction;
+    int32_t value;
+
+    // The second and fourth quadrants mirror the table
+    if (quadrant & 0x1)
+    {
+        position = 0x4000 - position;
+    }
+
+    index = position >> 8;
+    fraction = position & 0xFF;
+
+    if (index >= 64)
+    {
+        value = Sine_Table[64];
+    }
+    else
+    {
+        value = Sine_Table[index] + (((Sine_Table[index + 1] - Sine_Table[index]) * (int32_t)fraction) >> 8);
+    }
+
+    // The third and fourth quadrants are negative
+    if (quadrant & 0x2)
+    {
+        value = -value;
+    }
+
+    return value;
+}
+
+int16_t Odometry_Cos(uint32_t angle)
+{
+    return Odometry_Sin(angle + ODOMETRY_HEADING_90);
+}
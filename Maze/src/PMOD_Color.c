@@ -29,6 +29,28 @@
 
 #include "../inc/PMOD_Color.h"
 
+// MCLK cycles per us at the current MCLK frequency, used to measure the warm-up with the DWT cycle counter
+#define PMOD_COLOR_CYCLES_PER_US    (Clock_GetFreq() / 1000000)
+
+// Cycle counter value when the sensor has been powered on
+static uint32_t PMOD_Color_Power_On_Cycles;
+
+// Command byte and receive buffer of the background acquisition transaction
+// The transaction reads STATUS followed by CDATAL to BDATAH using the auto-increment protocol
+static const uint8_t PMOD_Color_Acquisition_Command = PMOD_COLOR_AUTO_INC | PMOD_COLOR_STATUS_REG;
+static uint8_t PMOD_Color_Acquisition_Buffer[9];
+static EUSCI_B1_I2C_Transaction PMOD_Color_Acquisition_Transaction;
+
+// Calibration data updated by the background acquisition pipeline, and its scale factors
+static PMOD_Calibration_Data PMOD_Color_Acquisition_Calibration;
+static PMOD_Color_Normalization PMOD_Color_Acquisition_Normalization;
+static uint8_t PMOD_Color_Calibration_Restored;
+
+// Latest sample published by the EUSCI_B1 interrupt, read without disabling the interrupts
+static Snapshot PMOD_Color_Latest;
+static uint8_t PMOD_Color_Latest_Buffer[SNAPSHOT_BUFFER_SIZE(sizeof(PMOD_Color_Snapshot))];
+static uint32_t PMOD_Color_Sample_Count;
+
 void PMOD_Color_Write_Register(uint8_t register_address, uint8_t register_data)
 {
     uint8_t buffer[] =
@@ -48,20 +70,49 @@ uint8_t PMOD_Color_Read_Register(uint8_t register_address)
 }
 
 void PMOD_Color_Init()
+{
+    PMOD_Color_Power_On();
+
+    PMOD_Color_Start();
+
+    PMOD_Color_Wait_Ready(PMOD_COLOR_READY_TIMEOUT_US);
+}
+
+void PMOD_Color_Power_On()
 {
     EUSCI_B1_I2C_Init();
+    EUSCI_B1_I2C_Set_Device_Clock(PMOD_COLOR_ADDRESS, PMOD_COLOR_I2C_SCL_HZ);
 
     PMOD_Color_Enable(PMOD_COLOR_ENABLE_POWER_ON);
 
-    Clock_Delay1us(2400);
+    PMOD_Color_Power_On_Cycles = CycleCounter_Read();
+}
+
+void PMOD_Color_Start()
+{
+    // Only wait for the part of the warm-up that has not been used by the other initializations
+    CycleCounter_Wait(PMOD_Color_Power_On_Cycles, PMOD_COLOR_WARM_UP_TIME_US * PMOD_COLOR_CYCLES_PER_US);
 
     PMOD_Color_Enable(PMOD_COLOR_ENABLE_POWER_ON | PMOD_COLOR_ENABLE_RGBC);
 
-    Clock_Delay1us(2400);
-
     PMOD_Color_LED_Init();
 }
 
+int PMOD_Color_Wait_Ready(uint32_t timeout_us)
+{
+    uint32_t start_cycles = CycleCounter_Read();
+
+    while ((PMOD_Color_Read_Register(PMOD_COLOR_AUTO_INC | PMOD_COLOR_STATUS_REG) & PMOD_COLOR_STATUS_AVALID) == 0)
+    {
+        if ((CycleCounter_Read() - start_cycles) >= (timeout_us * PMOD_COLOR_CYCLES_PER_US))
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 void PMOD_Color_LED_Init()
 {
     P8->SEL0 &= ~0x08;
@@ -126,27 +177,168 @@ PMOD_Calibration_Data PMOD_Color_Init_Calibration_Data(PMOD_Color_Data first_sam
     return calibration_data;
 }
 
-void PMOD_Color_Calibrate(PMOD_Color_Data new_sample, PMOD_Calibration_Data *calibration_data)
+uint8_t PMOD_Color_Calibrate(PMOD_Color_Data new_sample, PMOD_Calibration_Data *calibration_data)
+{
+    uint8_t changed = 0;
+
+    if (new_sample.clear < calibration_data->min.clear) { calibration_data->min.clear = new_sample.clear; changed = 1; }
+    if (new_sample.red < calibration_data->min.red) { calibration_data->min.red = new_sample.red; changed = 1; }
+    if (new_sample.green < calibration_data->min.green) { calibration_data->min.green = new_sample.green; changed = 1; }
+    if (new_sample.blue < calibration_data->min.blue) { calibration_data->min.blue = new_sample.blue; changed = 1; }
+
+    if (new_sample.clear > calibration_data->max.clear) { calibration_data->max.clear = new_sample.clear; changed = 1; }
+    if (new_sample.red > calibration_data->max.red) { calibration_data->max.red = new_sample.red; changed = 1; }
+    if (new_sample.green > calibration_data->max.green) { calibration_data->max.green = new_sample.green; changed = 1; }
+    if (new_sample.blue > calibration_data->max.blue) { calibration_data->max.blue = new_sample.blue; changed = 1; }
+
+    return changed;
+}
+
+// Returns the Q16 factor that scales the range of a channel to 0xFFFF, or 0 if the range is empty
+// Note: The quotient is rounded up so that the maximum is scaled to 0xFFFF and not 0xFFFE
+static uint32_t PMOD_Color_Scale(uint16_t min, uint16_t max)
 {
-    if (new_sample.clear < calibration_data->min.clear) calibration_data->min.clear = new_sample.clear;
-    if (new_sample.red < calibration_data->min.red) calibration_data->min.red = new_sample.red;
-    if (new_sample.green < calibration_data->min.green) calibration_data->min.green = new_sample.green;
-    if (new_sample.blue < calibration_data->min.blue) calibration_data->min.blue = new_sample.blue;
+    uint32_t range;
 
-    if (new_sample.clear > calibration_data->max.clear) calibration_data->max.clear = new_sample.clear;
-    if (new_sample.red > calibration_data->max.red) calibration_data->max.red = new_sample.red;
-    if (new_sample.green > calibration_data->max.green) calibration_data->max.green = new_sample.green;
-    if (new_sample.blue > calibration_data->max.blue) calibration_data->max.blue = new_sample.blue;
+    if (max <= min)
+    {
+        return 0;
+    }
+
+    range = max - min;
+
+    return ((0xFFFFUL << 16) + range - 1) / range;
 }
 
-PMOD_Color_Data PMOD_Color_Normalize_Calibration(PMOD_Color_Data sample, PMOD_Calibration_Data calibration_data)
+// Returns ((value - min) * scale) >> 16, which is at most 0xFFFF for a value between min and max
+static uint16_t PMOD_Color_Scale_Channel(uint16_t value, uint16_t min, uint32_t scale)
+{
+    if (value <= min)
+    {
+        return 0;
+    }
+
+    return (uint16_t)(((uint64_t)(value - min) * scale) >> 16);
+}
+
+void PMOD_Color_Update_Normalization(PMOD_Calibration_Data calibration_data, PMOD_Color_Normalization *normalization)
+{
+    normalization->min = calibration_data.min;
+    normalization->scale_clear = PMOD_Color_Scale(calibration_data.min.clear, calibration_data.max.clear);
+    normalization->scale_red = PMOD_Color_Scale(calibration_data.min.red, calibration_data.max.red);
+    normalization->scale_green = PMOD_Color_Scale(calibration_data.min.green, calibration_data.max.green);
+    normalization->scale_blue = PMOD_Color_Scale(calibration_data.min.blue, calibration_data.max.blue);
+}
+
+PMOD_Color_Data PMOD_Color_Normalize(PMOD_Color_Data sample, const PMOD_Color_Normalization *normalization)
 {
     PMOD_Color_Data normalized_data;
 
-    normalized_data.clear = (sample.clear - calibration_data.min.clear) * (0xFFFF / (calibration_data.max.clear - calibration_data.min.clear));
-    normalized_data.red = (sample.red - calibration_data.min.red) * (0xFFFF / (calibration_data.max.red - calibration_data.min.red));
-    normalized_data.green = (sample.green - calibration_data.min.green) * (0xFFFF / (calibration_data.max.green - calibration_data.min.green));
-    normalized_data.blue = (sample.blue - calibration_data.min.blue) * (0xFFFF / (calibration_data.max.blue - calibration_data.min.blue));
+    normalized_data.clear = PMOD_Color_Scale_Channel(sample.clear, normalization->min.clear, normalization->scale_clear);
+    normalized_data.red = PMOD_Color_Scale_Channel(sample.red, normalization->min.red, normalization->scale_red);
+    normalized_data.green = PMOD_Color_Scale_Channel(sample.green, normalization->min.green, normalization->scale_green);
+    normalized_data.blue = PMOD_Color_Scale_Channel(sample.blue, normalization->min.blue, normalization->scale_blue);
 
     return normalized_data;
 }
+
+PMOD_Color_Data PMOD_Color_Normalize_Calibration(PMOD_Color_Data sample, PMOD_Calibration_Data calibration_data)
+{
+    PMOD_Color_Normalization normalization;
+
+    PMOD_Color_Update_Normalization(calibration_data, &normalization);
+
+    return PMOD_Color_Normalize(sample, &normalization);
+}
+
+static void PMOD_Color_Acquisition_Complete(EUSCI_B1_I2C_Transaction *transaction)
+{
+    PMOD_Color_Snapshot snapshot;
+    PMOD_Color_Data data;
+    uint8_t *buffer = PMOD_Color_Acquisition_Buffer;
+
+    // Discard the sample if the device did not respond or no integration cycle has completed yet
+    if ((transaction->Status != EUSCI_B1_I2C_STATUS_DONE) || ((buffer[0] & PMOD_COLOR_STATUS_AVALID) == 0))
+    {
+        return;
+    }
+
+    data.clear = (buffer[2] << 8) | buffer[1];
+    data.red = (buffer[4] << 8) | buffer[3];
+    data.green = (buffer[6] << 8) | buffer[5];
+    data.blue = (buffer[8] << 8) | buffer[7];
+
+    // Recompute the scale factors only when the calibration has changed
+    if ((PMOD_Color_Sample_Count == 0) && (PMOD_Color_Calibration_Restored == 0))
+    {
+        PMOD_Color_Acquisition_Calibration = PMOD_Color_Init_Calibration_Data(data);
+        PMOD_Color_Update_Normalization(PMOD_Color_Acquisition_Calibration, &PMOD_Color_Acquisition_Normalization);
+    }
+    else if (PMOD_Color_Calibrate(data, &PMOD_Color_Acquisition_Calibration))
+    {
+        PMOD_Color_Update_Normalization(PMOD_Color_Acquisition_Calibration, &PMOD_Color_Acquisition_Normalization);
+    }
+
+    PMOD_Color_Sample_Count = PMOD_Color_Sample_Count + 1;
+
+    snapshot.raw = data;
+    snapshot.normalized = PMOD_Color_Normalize(data, &PMOD_Color_Acquisition_Normalization);
+    snapshot.sample_count = PMOD_Color_Sample_Count;
+    snapshot.timestamp_cycles = 0;
+    Snapshot_Write(&PMOD_Color_Latest, &snapshot, CycleCounter_Read());
+}
+
+void PMOD_Color_Acquisition_Init()
+{
+    PMOD_Color_Snapshot initial = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, 0, 0 };
+
+    PMOD_Color_Sample_Count = 0;
+    PMOD_Color_Calibration_Restored = 0;
+    Snapshot_Init(&PMOD_Color_Latest, PMOD_Color_Latest_Buffer, sizeof(PMOD_Color_Snapshot), &initial);
+    PMOD_Color_Acquisition_Transaction.Status = EUSCI_B1_I2C_STATUS_IDLE;
+}
+
+void PMOD_Color_Acquisition_Task()
+{
+    uint8_t status = PMOD_Color_Acquisition_Transaction.Status;
+
+    // Skip this period if the previous read is still waiting for the bus
+    if ((status == EUSCI_B1_I2C_STATUS_PENDING) || (status == EUSCI_B1_I2C_STATUS_ACTIVE))
+    {
+        return;
+    }
+
+    EUSCI_B1_I2C_Write_Read_Async(&PMOD_Color_Acquisition_Transaction, PMOD_COLOR_ADDRESS,
+                                  &PMOD_Color_Acquisition_Command, 1,
+                                  PMOD_Color_Acquisition_Buffer, sizeof(PMOD_Color_Acquisition_Buffer),
+                                  &PMOD_Color_Acquisition_Complete);
+}
+
+void PMOD_Color_Get_Snapshot(PMOD_Color_Snapshot *snapshot)
+{
+    Snapshot_Read(&PMOD_Color_Latest, snapshot, &snapshot->timestamp_cycles);
+}
+
+void PMOD_Color_Set_Calibration(PMOD_Calibration_Data calibration_data)
+{
+    long sr;
+
+    sr = StartCritical();
+    PMOD_Color_Acquisition_Calibration = calibration_data;
+    PMOD_Color_Update_Normalization(PMOD_Color_Acquisition_Calibration, &PMOD_Color_Acquisition_Normalization);
+    PMOD_Color_Calibration_Restored = 1;
+    EndCritical(sr);
+}
+
+PMOD_Calibration_Data PMOD_Color_Get_Calibration()
+{
+    PMOD_Calibration_Data calibration_data;
+    long sr;
+
+    // The EUSCI_B1 interrupt updates the calibration
+    sr = StartCritical();
+    calibration_data = PMOD_Color_Acquisition_Calibration;
+    EndCritical(sr);
+
+    return calibration_data;
+}
@@ -0,0 +1,349 @@
+/**
+ * @file Parameters.c
+ * @brief Source code for the Parameters module.
+ *
+ * This file contains the function definitions for the Parameters module.
+ *
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include "../inc/Parameters.h"
+#include "../inc/Trace.h"
+#include "../inc/Print_Format.h"
+
+// Registry selected by Parameters_Init, and the function that sends the replies
+static const Parameter *Parameters_Registry;
+static uint8_t Parameters_Count;
+static void (*Parameters_Output)(const char *line);
+
+// Function that executes the other commands (0 if none)
+static int (*Parameters_Command_Handler)(char **arguments, uint8_t argument_count);
+
+// Values written by the set commands, copied to the parameters by Parameters_Apply (one bit per entry)
+static int32_t Parameters_Pending[PARAMETERS_MAX_COUNT];
+static volatile uint32_t Parameters_Pending_Mask;
+
+// Command line being received
+static char Parameters_Line[PARAMETERS_MAX_LINE_LENGTH + 1];
+static uint8_t Parameters_Line_Length;
+static uint8_t Parameters_Line_Overflow;
+
+// Sends a formatted reply line
+static void Parameters_Reply(const char *format, ...)
+{
+    char reply[PARAMETERS_MAX_REPLY_LENGTH];
+    va_list arguments;
+
+    va_start(arguments, format);
+    Print_Format_To_Buffer_V(reply, sizeof(reply), format, arguments);
+    va_end(arguments);
+
+    Parameters_Output(reply);
+}
+
+// Returns the index of a parameter, or -1 if the name is not in the registry
+static int Parameters_Find(const char *name)
+{
+    int i;
+
+    for (i = 0; i < Parameters_Count; i++)
+    {
+        if (strcmp(Parameters_Registry[i].Name, name) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+int Parameters_Parse_Value(const char *text, int32_t *value)
+{
+    uint32_t magnitude = 0;
+    uint32_t limit = 0x7FFFFFFF;
+    uint8_t negative = 0;
+
+    if (*text == '-')
+    {
+        negative = 1;
+        limit = 0x80000000;
+        text++;
+    }
+    else if (*text == '+')
+    {
+        text++;
+    }
+
+    if (*text == 0)
+    {
+        return -1;
+    }
+
+    while (*text)
+    {
+        if ((*text < '0') || (*text > '9') || (magnitude > ((limit - (uint32_t)(*text - '0')) / 10)))
+        {
+            return -1;
+        }
+        magnitude = (magnitude * 10) + (uint32_t)(*text - '0');
+        text++;
+    }
+
+    *value = negative ? (int32_t)(0 - magnitude) : (int32_t)magnitude;
+
+    return 0;
+}
+
+// Signature of the names of the registry (FNV-1a), stored with the saved values
+static uint32_t Parameters_Signature(void)
+{
+    uint32_t hash = 0x811C9DC5;
+    const char *name;
+    int i;
+
+    for (i = 0; i < Parameters_Count; i++)
+    {
+        name = Parameters_Registry[i].Name;
+        do
+        {
+            hash = (hash ^ (uint8_t)*name) * 0x01000193;
+        } while (*name++);
+    }
+
+    return hash;
+}
+
+// Splits the command line in place and executes it
+static void Parameters_Execute(char *line)
+{
+    char *arguments[PARAMETERS_MAX_ARGUMENTS];
+    uint8_t argument_count = 0;
+    const Parameter *entry;
+    int32_t value;
+    uint32_t sr;
+    int index;
+    int i;
+
+    while (*line && (argument_count < PARAMETERS_MAX_ARGUMENTS))
+    {
+        while (*line == ' ')
+        {
+            line++;
+        }
+        if (*line == 0)
+        {
+            break;
+        }
+        arguments[argument_count++] = line;
+        while (*line && (*line != ' '))
+        {
+            line++;
+        }
+        if (*line)
+        {
+            *line++ = 0;
+        }
+    }
+
+    // Ignore the empty lines, such as the LF of a CR LF line ending
+    if (argument_count == 0)
+    {
+        return;
+    }
+
+    if ((strcmp(arguments[0], "list") == 0) && (argument_count == 1))
+    {
+        for (i = 0; i < Parameters_Count; i++)
+        {
+            entry = &Parameters_Registry[i];
+            Parameters_Reply("%s=%ld %ld %ld", entry->Name, (long)*entry->Value, (long)entry->Min, (long)entry->Max);
+        }
+    }
+    else if ((strcmp(arguments[0], "get") == 0) && (argument_count == 2))
+    {
+        index = Parameters_Find(arguments[1]);
+        if (index < 0)
+        {
+            Parameters_Reply("err name");
+            return;
+        }
+        Parameters_Reply("%s=%ld", arguments[1], (long)*Parameters_Registry[index].Value);
+    }
+    else if ((strcmp(arguments[0], "set") == 0) && (argument_count == 3))
+    {
+        index = Parameters_Find(arguments[1]);
+        if (index < 0)
+        {
+            Parameters_Reply("err name");
+            return;
+        }
+        entry = &Parameters_Registry[index];
+        if (Parameters_Parse_Value(arguments[2], &value) != 0)
+        {
+            Parameters_Reply("err value");
+            return;
+        }
+        if ((value < entry->Min) || (value > entry->Max))
+        {
+            Parameters_Reply("err range %ld %ld", (long)entry->Min, (long)entry->Max);
+            return;
+        }
+
+        // The control tick copies the value, so it does not change while a controller is running
+        sr = StartCritical();
+        Parameters_Pending[index] = value;
+        Parameters_Pending_Mask |= (1UL << index);
+        EndCritical(sr);
+
+        Parameters_Reply("ok %s=%ld", entry->Name, (long)value);
+    }
+    else if ((strcmp(arguments[0], "save") == 0) && (argument_count == 1))
+    {
+        if (Parameters_Save() != 0)
+        {
+            Parameters_Reply("err flash");
+            return;
+        }
+        Parameters_Reply("ok save");
+    }
+    else if ((Parameters_Command_Handler == 0) || (Parameters_Command_Handler(arguments, argument_count) != 0))
+    {
+        Parameters_Reply("err command");
+    }
+}
+
+void Parameters_Init(const Parameter *registry, uint8_t count, void (*output)(const char *line))
+{
+    if (count > PARAMETERS_MAX_COUNT)
+    {
+        count = PARAMETERS_MAX_COUNT;
+    }
+
+    Parameters_Registry = registry;
+    Parameters_Count = count;
+    Parameters_Output = output;
+    Parameters_Pending_Mask = 0;
+    Parameters_Line_Length = 0;
+    Parameters_Line_Overflow = 0;
+
+    EUSCI_A0_UART_Enable_RX_Interrupt();
+}
+
+void Parameters_Set_Command_Handler(int (*handler)(char **arguments, uint8_t argument_count))
+{
+    Parameters_Command_Handler = handler;
+}
+
+void Parameters_Task(void)
+{
+    uint8_t data;
+
+    while (EUSCI_A0_UART_Read_Byte(&data))
+    {
+        if ((data == CR) || (data == LF))
+        {
+            if (Parameters_Line_Overflow)
+            {
+                Parameters_Reply("err length");
+            }
+            else
+            {
+                Parameters_Line[Parameters_Line_Length] = 0;
+                Parameters_Execute(Parameters_Line);
+            }
+            Parameters_Line_Length = 0;
+            Parameters_Line_Overflow = 0;
+        }
+        else if ((data == BS) || (data == DEL))
+        {
+            if (Parameters_Line_Length > 0)
+            {
+                Parameters_Line_Length--;
+            }
+        }
+        else if (Parameters_Line_Length < PARAMETERS_MAX_LINE_LENGTH)
+        {
+            Parameters_Line[Parameters_Line_Length++] = (char)data;
+        }
+        else
+        {
+            Parameters_Line_Overflow = 1;
+        }
+    }
+}
+
+void Parameters_Apply(void)
+{
+    uint32_t mask;
+    int i;
+
+    if (Parameters_Pending_Mask == 0)
+    {
+        return;
+    }
+
+    // The background task only sets the bits with the interrupts disabled
+    mask = Parameters_Pending_Mask;
+    Parameters_Pending_Mask = 0;
+
+    for (i = 0; i < Parameters_Count; i++)
+    {
+        if (mask & (1UL << i))
+        {
+            *Parameters_Registry[i].Value = Parameters_Pending[i];
+            Trace_Record(TRACE_EVENT_PARAMETER, i, (uint32_t)Parameters_Pending[i]);
+            if (Parameters_Registry[i].Apply != 0)
+            {
+                Parameters_Registry[i].Apply();
+            }
+        }
+    }
+}
+
+int Parameters_Save(void)
+{
+    int32_t record[PARAMETERS_MAX_COUNT + 1];
+    int i;
+
+    record[0] = (int32_t)Parameters_Signature();
+    for (i = 0; i < Parameters_Count; i++)
+    {
+        record[i + 1] = *Parameters_Registry[i].Value;
+    }
+
+    return Flash_Store_Write(FLASH_STORE_KEY_PARAMETERS, record, (Parameters_Count + 1) * sizeof(int32_t));
+}
+
+int Parameters_Restore(void)
+{
+    int32_t record[PARAMETERS_MAX_COUNT + 1];
+    const Parameter *entry;
+    uint32_t sr;
+    int i;
+
+    if (Flash_Store_Read(FLASH_STORE_KEY_PARAMETERS, record, (Parameters_Count + 1) * sizeof(int32_t)) < 0)
+    {
+        return -1;
+    }
+
+    if ((uint32_t)record[0] != Parameters_Signature())
+    {
+        return -1;
+    }
+
+    // The values are applied like the set commands, so the apply functions are called by the first control tick
+    sr = StartCritical();
+    for (i = 0; i < Parameters_Count; i++)
+    {
+        entry = &Parameters_Registry[i];
+        if ((record[i + 1] >= entry->Min) && (record[i + 1] <= entry->Max))
+        {
+            Parameters_Pending[i] = record[i + 1];
+            Parameters_Pending_Mask |= (1UL << i);
+        }
+    }
+    EndCritical(sr);
+
+    return 0;
+}
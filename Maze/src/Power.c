@@ -0,0 +1,103 @@
+/**
+ * @file Power.c
+ * @brief Source code for the Power driver.
+ *
+ * This file contains the function definitions for the Power driver.
+ * It selects LPM0 as the sleep mode and disables the modules that are not used by the program.
+ *
+ */
+
+#include "../inc/Power.h"
+
+// Modules disabled since reset
+static uint32_t Power_Disabled_Modules = 0;
+
+static const uint32_t Power_EUSCI_A_Modules[4] = { POWER_MODULE_EUSCI_A0, POWER_MODULE_EUSCI_A1, POWER_MODULE_EUSCI_A2, POWER_MODULE_EUSCI_A3 };
+static const uint32_t Power_EUSCI_B_Modules[4] = { POWER_MODULE_EUSCI_B0, POWER_MODULE_EUSCI_B1, POWER_MODULE_EUSCI_B2, POWER_MODULE_EUSCI_B3 };
+static const uint32_t Power_Timer_A_Modules[4] = { POWER_MODULE_TIMER_A0, POWER_MODULE_TIMER_A1, POWER_MODULE_TIMER_A2, POWER_MODULE_TIMER_A3 };
+
+void Power_Init(void)
+{
+    // Clear the SLEEPONEXIT (Bit 1) and SLEEPDEEP (Bit 2) bits of the SCR register,
+    // so that WaitForInterrupt enters LPM0 and returns to the main loop after each interrupt
+    SCB->SCR &= ~0x00000006;
+}
+
+void Power_Disable_Modules(uint32_t modules)
+{
+    EUSCI_A_Type *const eusci_a[4] = { EUSCI_A0, EUSCI_A1, EUSCI_A2, EUSCI_A3 };
+    EUSCI_B_Type *const eusci_b[4] = { EUSCI_B0, EUSCI_B1, EUSCI_B2, EUSCI_B3 };
+    Timer_A_Type *const timer_a[4] = { TIMER_A0, TIMER_A1, TIMER_A2, TIMER_A3 };
+    uint32_t index;
+
+    for (index = 0; index < 4; index++)
+    {
+        // Hold the eUSCI module in reset by setting the UCSWRST bit (Bit 0) of the CTLW0 register
+        // and disable its interrupts
+        if (modules & Power_EUSCI_A_Modules[index])
+        {
+            eusci_a[index]->CTLW0 |= 0x0001;
+            eusci_a[index]->IE = 0x0000;
+        }
+        if (modules & Power_EUSCI_B_Modules[index])
+        {
+            eusci_b[index]->CTLW0 |= 0x0001;
+            eusci_b[index]->IE = 0x0000;
+        }
+
+        // Stop the timer by clearing the MC field (Bits 5 to 4) and the interrupt enable bit (Bit 1) of the CTL register
+        if (modules & Power_Timer_A_Modules[index])
+        {
+            timer_a[index]->CTL &= ~0x0032;
+        }
+    }
+
+    // Stop Timer32 by clearing the ENABLE bit (Bit 7) and the IE bit (Bit 5) of the CONTROL register
+    if (modules & POWER_MODULE_TIMER32_1)
+    {
+        TIMER32_1->CONTROL &= ~0x000000A0;
+    }
+    if (modules & POWER_MODULE_TIMER32_2)
+    {
+        TIMER32_2->CONTROL &= ~0x000000A0;
+    }
+
+    // Turn off the ADC: the ADC14ENC bit (Bit 1) must be cleared before the ADC14ON bit (Bit 4)
+    if (modules & POWER_MODULE_ADC14)
+    {
+        ADC14->CTL0 &= ~0x00000002;
+        ADC14->CTL0 &= ~0x00000010;
+    }
+
+    // Turn off the reference by clearing the REFON bit (Bit 0) of the CTL0 register
+    if (modules & POWER_MODULE_REF_A)
+    {
+        REF_A->CTL0 &= ~0x0001;
+    }
+
+    // Turn off the comparators by clearing the CEON bit (Bit 10) of the CTL1 register
+    if (modules & POWER_MODULE_COMP_E0)
+    {
+        COMP_E0->CTL1 &= ~0x0400;
+    }
+    if (modules & POWER_MODULE_COMP_E1)
+    {
+        COMP_E1->CTL1 &= ~0x0400;
+    }
+
+    // Disable ACLK by clearing the ACLK_EN bit (Bit 0) of the CLKEN register
+    // Note: The CS registers are unlocked by writing 0x695A to the KEY register
+    if (modules & POWER_MODULE_ACLK)
+    {
+        CS->KEY = 0x695A;
+        CS->CLKEN &= ~0x00000001;
+        CS->KEY = 0;
+    }
+
+    Power_Disabled_Modules = Power_Disabled_Modules | modules;
+}
+
+uint32_t Power_Get_Disabled_Modules(void)
+{
+    return Power_Disabled_Modules;
+}
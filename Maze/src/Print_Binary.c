@@ -16,21 +16,21 @@ void Print_Binary(uint8_t value_to_convert)
 {
     if (value_to_convert == 0)
     {
-        printf("Line Sensor: 0000_0000\n");
+        PRINT_LITERAL("Line Sensor: 0000_0000\n");
         return;
     }
 
-    printf("Line Sensor: ");
+    PRINT_LITERAL("Line Sensor: ");
 
     for (int i = 7; i >= 0; i--)
     {
-        printf("%d", (value_to_convert >> i) & 1);
+        EUSCI_A0_UART_OutChar('0' + ((value_to_convert >> i) & 1));
 
         if (i == 4)
         {
-            printf("_");
+            PRINT_LITERAL("_");
         }
     }
 
-    printf("\n");
+    PRINT_LITERAL("\n");
 }
@@ -0,0 +1,310 @@
+/**
+ * @file Print_Format.c
+ * @brief Source code for the Print_Format module.
+ *
+ * This file contains the function definitions for the Print_Format module.
+ * It formats integers and strings into the EUSCI_A0 TX ring buffer or into a caller buffer.
+ *
+ */
+
+#include "../inc/Print_Format.h"
+#include "../inc/EUSCI_A0_UART.h"
+
+// Flags of a conversion
+#define PRINT_FORMAT_LEFT_JUSTIFY   0x01
+#define PRINT_FORMAT_ZERO_PAD       0x02
+
+/**
+ * @brief Destination of the formatted characters: the EUSCI_A0 TX ring buffer if Buffer is 0.
+ */
+typedef struct
+{
+    char *Buffer;
+    uint32_t Size;
+    uint32_t Length;
+} Print_Format_Sink;
+
+// Sends a character to the UART, or stores it in the buffer if it fits with the null terminator
+static void Print_Format_Put(Print_Format_Sink *sink, char character)
+{
+    if (sink->Buffer == 0)
+    {
+        if (character == '\n')
+        {
+            EUSCI_A0_UART_Queue_Byte('\r');
+        }
+        EUSCI_A0_UART_Queue_Byte((uint8_t)character);
+    }
+    else if ((sink->Length + 1) < sink->Size)
+    {
+        sink->Buffer[sink->Length] = character;
+    }
+
+    sink->Length = sink->Length + 1;
+}
+
+// Writes the characters of a conversion with the padding selected by its flags and width
+// Note: The sign is written before the leading zeros
+static void Print_Format_Put_Field(Print_Format_Sink *sink, const char *text, uint32_t length, char sign, uint8_t flags, uint32_t width)
+{
+    uint32_t total = length + ((sign != 0) ? 1 : 0);
+    uint32_t padding = (width > total) ? (width - total) : 0;
+
+    if ((flags & (PRINT_FORMAT_LEFT_JUSTIFY | PRINT_FORMAT_ZERO_PAD)) == 0)
+    {
+        while (padding > 0)
+        {
+            Print_Format_Put(sink, ' ');
+            padding--;
+        }
+    }
+
+    if (sign != 0)
+    {
+        Print_Format_Put(sink, sign);
+    }
+
+    if ((flags & (PRINT_FORMAT_LEFT_JUSTIFY | PRINT_FORMAT_ZERO_PAD)) == PRINT_FORMAT_ZERO_PAD)
+    {
+        while (padding > 0)
+        {
+            Print_Format_Put(sink, '0');
+            padding--;
+        }
+    }
+
+    while (length > 0)
+    {
+        Print_Format_Put(sink, *text);
+        text++;
+        length--;
+    }
+
+    while (padding > 0)
+    {
+        Print_Format_Put(sink, ' ');
+        padding--;
+    }
+}
+
+// Converts an unsigned number to digits in base 10 or 16, and returns the index of the first digit in the buffer
+static uint32_t Print_Format_Convert(uint32_t value, uint32_t base, char upper_case, char digits[10])
+{
+    const char *symbols = upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+    uint32_t index = 10;
+
+    do
+    {
+        index--;
+        if (base == 16)
+        {
+            digits[index] = symbols[value & 0x0F];
+            value = value >> 4;
+        }
+        else
+        {
+            digits[index] = symbols[value % 10];
+            value = value / 10;
+        }
+    } while (value != 0);
+
+    return index;
+}
+
+static void Print_Format_Core(Print_Format_Sink *sink, const char *format, va_list arguments)
+{
+    char digits[10];
+    const char *text;
+    uint32_t length;
+    uint32_t width;
+    uint32_t index;
+    uint32_t value;
+    int32_t signed_value;
+    uint8_t flags;
+    char sign;
+    char character;
+
+    while (*format != 0)
+    {
+        if (*format != '%')
+        {
+            Print_Format_Put(sink, *format);
+            format++;
+            continue;
+        }
+        format++;
+
+        // Flags
+        flags = 0;
+        while ((*format == '-') || (*format == '0'))
+        {
+            flags |= (*format == '-') ? PRINT_FORMAT_LEFT_JUSTIFY : PRINT_FORMAT_ZERO_PAD;
+            format++;
+        }
+
+        // Width
+        width = 0;
+        while ((*format >= '0') && (*format <= '9'))
+        {
+            width = (width * 10) + (*format - '0');
+            format++;
+        }
+
+        // Length modifiers, ignored because int and long are both 32-bit
+        while ((*format == 'l') || (*format == 'h'))
+        {
+            format++;
+        }
+
+        character = *format;
+        if (character == 0)
+        {
+            break;
+        }
+        format++;
+        sign = 0;
+
+        switch (character)
+        {
+            case 'd':
+            case 'i':
+                signed_value = va_arg(arguments, int32_t);
+                value = (uint32_t)signed_value;
+                if (signed_value < 0)
+                {
+                    sign = '-';
+                    value = 0 - value;
+                }
+                index = Print_Format_Convert(value, 10, 0, digits);
+                Print_Format_Put_Field(sink, &digits[index], 10 - index, sign, flags, width);
+                break;
+
+            case 'u':
+                index = Print_Format_Convert(va_arg(arguments, uint32_t), 10, 0, digits);
+                Print_Format_Put_Field(sink, &digits[index], 10 - index, 0, flags, width);
+                break;
+
+            case 'x':
+            case 'X':
+                index = Print_Format_Convert(va_arg(arguments, uint32_t), 16, (character == 'X'), digits);
+                Print_Format_Put_Field(sink, &digits[index], 10 - index, 0, flags, width);
+                break;
+
+            case 'c':
+                digits[0] = (char)va_arg(arguments, int);
+                Print_Format_Put_Field(sink, digits, 1, 0, flags & PRINT_FORMAT_LEFT_JUSTIFY, width);
+                break;
+
+            case 's':
+                text = va_arg(arguments, const char *);
+                if (text == 0)
+                {
+                    text = "(null)";
+                }
+                for (length = 0; text[length] != 0; length++);
+                Print_Format_Put_Field(sink, text, length, 0, flags & PRINT_FORMAT_LEFT_JUSTIFY, width);
+                break;
+
+            default:
+                // '%%' and the unsupported conversions are written as they are
+                Print_Format_Put(sink, character);
+                break;
+        }
+    }
+}
+
+int Print_Format(const char *format, ...)
+{
+    va_list arguments;
+    int length;
+
+    va_start(arguments, format);
+    length = Print_Format_V(format, arguments);
+    va_end(arguments);
+
+    return length;
+}
+
+int Print_Format_V(const char *format, va_list arguments)
+{
+    Print_Format_Sink sink = { 0, 0, 0 };
+
+    Print_Format_Core(&sink, format, arguments);
+
+    return (int)sink.Length;
+}
+
+int Print_Format_To_Buffer(char *buffer, uint32_t size, const char *format, ...)
+{
+    va_list arguments;
+    int length;
+
+    va_start(arguments, format);
+    length = Print_Format_To_Buffer_V(buffer, size, format, arguments);
+    va_end(arguments);
+
+    return length;
+}
+
+int Print_Format_To_Buffer_V(char *buffer, uint32_t size, const char *format, va_list arguments)
+{
+    Print_Format_Sink sink = { buffer, size, 0 };
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    Print_Format_Core(&sink, format, arguments);
+    buffer[(sink.Length < size) ? sink.Length : (size - 1)] = 0;
+
+    return (int)sink.Length;
+}
+
+void Print_Literal(const char *text, uint32_t length)
+{
+    while (length > 0)
+    {
+        if (*text == '\n')
+        {
+            EUSCI_A0_UART_Queue_Byte('\r');
+        }
+        EUSCI_A0_UART_Queue_Byte((uint8_t)*text);
+        text++;
+        length--;
+    }
+}
+
+void Print_String(const char *text)
+{
+    while (*text != 0)
+    {
+        if (*text == '\n')
+        {
+            EUSCI_A0_UART_Queue_Byte('\r');
+        }
+        EUSCI_A0_UART_Queue_Byte((uint8_t)*text);
+        text++;
+    }
+}
+
+void Print_UDec(uint32_t value)
+{
+    char digits[10];
+    uint32_t index = Print_Format_Convert(value, 10, 0, digits);
+
+    EUSCI_A0_UART_Queue_Bytes((const uint8_t *)&digits[index], 10 - index);
+}
+
+void Print_SDec(int32_t value)
+{
+    if (value < 0)
+    {
+        EUSCI_A0_UART_Queue_Byte('-');
+        Print_UDec(0 - (uint32_t)value);
+    }
+    else
+    {
+        Print_UDec((uint32_t)value);
+    }
+}
@@ -0,0 +1,159 @@
+/**
+ * @file Profiler.c
+ * @brief Source code for the Profiler driver.
+ *
+ * This file contains the function definitions for the Profiler driver.
+ * It records the number of MCLK cycles used by the interrupt handlers and the scheduled tasks.
+ *
+ */
+
+#include "../inc/Profiler.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/Print_Format.h"
+#include "../inc/Nokia5110_LCD.h"
+#include "../inc/Interrupt_Priority.h"
+
+// Number of rows of the Nokia5110 LCD
+#define PROFILER_DISPLAY_ROWS   6
+
+static Profiler_Stats Profiler_Table[PROFILER_NUM_IDS];
+
+// Short names shown on the LCD (4 characters), in the order of Profiler_ID
+static char * const Profiler_Names[PROFILER_NUM_IDS] =
+{
+    "SYST",
+    "CTRL",
+    "UI  ",
+    "TA1 ",
+    "TA30",
+    "TA3N",
+    "P4  ",
+    "P6  ",
+    "DMA1",
+    "DMA2",
+    "I2C1",
+    "T321"
+};
+
+// Largest entry latency in us of the handlers measured by PROFILER_LATENCY, in the order of Profiler_ID (0 if none)
+static const uint16_t Profiler_Latency_Budget_us[PROFILER_NUM_IDS] =
+{
+    INTERRUPT_LATENCY_BUDGET_SYSTICK_US,
+    0,
+    0,
+    INTERRUPT_LATENCY_BUDGET_TA1_0_US,
+    INTERRUPT_LATENCY_BUDGET_TA3_US,
+    INTERRUPT_LATENCY_BUDGET_TA3_US,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0
+};
+
+void Profiler_Reset()
+{
+    uint8_t id;
+    long sr;
+
+    sr = StartCritical();
+    for (id = 0; id < PROFILER_NUM_IDS; id++)
+    {
+        Profiler_Table[id].Count = 0;
+        Profiler_Table[id].Min_Cycles = 0xFFFFFFFF;
+        Profiler_Table[id].Max_Cycles = 0;
+        Profiler_Table[id].Total_Cycles = 0;
+        Profiler_Table[id].Max_Latency_Cycles = 0;
+    }
+    EndCritical(sr);
+}
+
+void Profiler_Record(Profiler_ID id, uint32_t cycles)
+{
+    Profiler_Stats *stats = &Profiler_Table[id];
+
+    // A handler cannot preempt itself, so no critical section is needed
+    if ((stats->Count == 0) || (cycles < stats->Min_Cycles))
+    {
+        stats->Min_Cycles = cycles;
+    }
+    if (cycles > stats->Max_Cycles)
+    {
+        stats->Max_Cycles = cycles;
+    }
+    stats->Count = stats->Count + 1;
+    stats->Total_Cycles = stats->Total_Cycles + cycles;
+}
+
+void Profiler_Record_Latency(Profiler_ID id, uint32_t cycles)
+{
+    // Recorded by the handler itself, which cannot preempt itself
+    if (cycles > Profiler_Table[id].Max_Latency_Cycles)
+    {
+        Profiler_Table[id].Max_Latency_Cycles = cycles;
+    }
+}
+
+void Profiler_Get_Stats(Profiler_ID id, Profiler_Stats *stats)
+{
+    long sr;
+
+    sr = StartCritical();
+    *stats = Profiler_Table[id];
+    EndCritical(sr);
+}
+
+uint32_t Profiler_Get_Average(const Profiler_Stats *stats)
+{
+    if (stats->Count == 0)
+    {
+        return 0;
+    }
+
+    return stats->Total_Cycles / stats->Count;
+}
+
+void Profiler_Print()
+{
+    Profiler_Stats stats;
+    uint32_t cycles_per_us = Clock_GetFreq() / 1000000;
+    uint32_t latency_us;
+    uint8_t id;
+
+    Print_Format("Handler   Count      Min      Avg      Max (cycles)  Latency (us)\n");
+    for (id = 0; id < PROFILER_NUM_IDS; id++)
+    {
+        Profiler_Get_Stats((Profiler_ID)id, &stats);
+        latency_us = stats.Max_Latency_Cycles / cycles_per_us;
+        Print_Format("%s %10lu %8lu %8lu %8lu %8lu%s\n", Profiler_Names[id], (unsigned long)stats.Count,
+               (unsigned long)((stats.Count == 0) ? 0 : stats.Min_Cycles),
+               (unsigned long)Profiler_Get_Average(&stats), (unsigned long)stats.Max_Cycles, (unsigned long)latency_us,
+               ((Profiler_Latency_Budget_us[id] != 0) && (latency_us > Profiler_Latency_Budget_us[id])) ? " over" : "");
+    }
+}
+
+void Profiler_Display(Profiler_ID first_id)
+{
+    Profiler_Stats stats;
+    uint8_t row;
+
+    for (row = 0; (row < PROFILER_DISPLAY_ROWS) && ((first_id + row) < PROFILER_NUM_IDS); row++)
+    {
+        Profiler_Get_Stats((Profiler_ID)(first_id + row), &stats);
+        Nokia5110_Buffer_SetCursor(0, row);
+        Nokia5110_Buffer_OutString(Profiler_Names[first_id + row]);
+        Nokia5110_Buffer_OutChar(' ');
+
+        // Nokia5110_Buffer_OutUDec shows up to 65535, so larger values are shown in thousands of cycles
+        if (stats.Max_Cycles > 0xFFFF)
+        {
+            Nokia5110_Buffer_OutUDec(stats.Max_Cycles / 1000);
+            Nokia5110_Buffer_OutChar('k');
+        }
+        else
+        {
+            Nokia5110_Buffer_OutUDec(stats.Max_Cycles);
+        }
+    }
+}
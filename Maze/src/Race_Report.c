@@ -0,0 +1,74 @@
+/**
+ * @file Race_Report.c
+ * @brief Source code for the Race_Report module.
+ *
+ * This file contains the function definitions for the Race_Report module.
+ * It formats the route times and the trial statistics of the Route_Race module.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Race_Report.h"
+#include "../inc/Print_Format.h"
+
+// Function that sends a line to the host
+static void (*Race_Report_Output)(const char *line);
+
+void Race_Report_Init(void (*output)(const char *line))
+{
+    Race_Report_Output = output;
+}
+
+void Race_Report_Route_Time(const char *name, uint32_t time_ms)
+{
+    char line[32];
+
+    Print_Format_To_Buffer(line, sizeof(line), "route %s %u.%03u s", name, time_ms / 1000, time_ms % 1000);
+    Race_Report_Output(line);
+}
+
+void Race_Report_Route_Failed(const char *name)
+{
+    char line[32];
+
+    Print_Format_To_Buffer(line, sizeof(line), "route %s failed", name);
+    Race_Report_Output(line);
+}
+
+void Race_Report_Stats(int index)
+{
+    const Route_Race_Stats *stats = Route_Race_Get_Stats(index);
+    uint32_t mean_ms = Route_Race_Get_Mean_ms(index);
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+
+    if (stats == 0)
+    {
+        return;
+    }
+
+    Print_Format_To_Buffer(line, sizeof(line), "race %s trials=%u min=%u.%03u mean=%u.%03u max=%u.%03u", Route_Race_Get_Name(index),
+                           stats->Trials, stats->Min_ms / 1000, stats->Min_ms % 1000, mean_ms / 1000, mean_ms % 1000,
+                           stats->Max_ms / 1000, stats->Max_ms % 1000);
+    Race_Report_Output(line);
+}
+
+int Race_Report_Command(char **arguments, uint8_t argument_count)
+{
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+    int i;
+
+    if ((argument_count != 1) || (strcmp(arguments[0], "race") != 0))
+    {
+        return -1;
+    }
+
+    Print_Format_To_Buffer(line, sizeof(line), "race state=%u trial=%lu/%lu", (unsigned int)Route_Race_Get_State(),
+             (unsigned long)Route_Race_Get_Trial(), (unsigned long)Route_Race_Get_Num_Trials());
+    Race_Report_Output(line);
+    for (i = 0; i < Route_Race_Get_Num_Strategies(); i++)
+    {
+        Race_Report_Stats(i);
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file Rate_Monitor.c
+ * @brief Source code for the Rate_Monitor module.
+ *
+ * This file contains the function definitions for the Rate_Monitor module.
+ * It applies the rates of the rate policy, and measures the effective rates and the CPU load.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Rate_Monitor.h"
+#include "../inc/Print_Format.h"
+
+// Sampler, timing, and control task selected by Rate_Monitor_Init
+static const Rate_Monitor_Config *Rate_Monitor_Configuration;
+static int Rate_Monitor_Control_Task_ID;
+
+// Level of the rate policy whose rates are applied (RATE_POLICY_NUM_LEVELS before the first one)
+static Rate_Policy_Level Rate_Monitor_Applied_Level = RATE_POLICY_NUM_LEVELS;
+
+// Effective rates and CPU load measured by Rate_Monitor_Task over its last period (load in 0.1%)
+static uint32_t Rate_Monitor_Sample_Hz = 0;
+static uint32_t Rate_Monitor_Control_Hz = 0;
+static uint32_t Rate_Monitor_Load_Permille = 0;
+
+// Counts at the previous execution of Rate_Monitor_Task
+static uint32_t Rate_Monitor_Ticks = 0;
+static uint32_t Rate_Monitor_Cycles = 0;
+static uint32_t Rate_Monitor_Idle_Cycles = 0;
+static uint32_t Rate_Monitor_Samples = 0;
+static uint32_t Rate_Monitor_Control_Runs = 0;
+
+void Rate_Monitor_Init(const Rate_Monitor_Config *config, int control_task_id)
+{
+    Rate_Monitor_Configuration = config;
+    Rate_Monitor_Control_Task_ID = control_task_id;
+    Rate_Monitor_Applied_Level = RATE_POLICY_NUM_LEVELS;
+    Rate_Monitor_Ticks = 0;
+}
+
+void Rate_Monitor_Apply_Level(Rate_Policy_Level level)
+{
+    Rate_Policy_Rates rates;
+
+    if ((level == Rate_Monitor_Applied_Level) || (Rate_Policy_Get_Rates(level, &rates) != 0))
+    {
+        return;
+    }
+
+    Rate_Monitor_Configuration->Set_Sample_Rate(rates.Sample_Rate_Hz);
+    Scheduler_Set_Period(Rate_Monitor_Control_Task_ID, rates.Control_Period_Ticks);
+
+    Rate_Monitor_Applied_Level = level;
+    Trace_Record(TRACE_EVENT_RATE, level, rates.Sample_Rate_Hz);
+}
+
+void Rate_Monitor_Reapply(void)
+{
+    Rate_Monitor_Applied_Level = RATE_POLICY_NUM_LEVELS;
+    Rate_Monitor_Apply_Level(Rate_Policy_Get_Level());
+}
+
+void Rate_Monitor_Task(void)
+{
+    Scheduler_Task_Stats stats;
+    uint32_t ticks = Scheduler_Get_Ticks();
+    uint32_t cycles = CycleCounter_Read();
+    uint32_t idle_cycles = Scheduler_Get_Idle_Cycles();
+    uint32_t elapsed_ticks = ticks - Rate_Monitor_Ticks;
+    uint32_t elapsed_cycles = cycles - Rate_Monitor_Cycles;
+    uint32_t ticks_per_second = Rate_Monitor_Configuration->Ticks_Per_Second;
+    uint32_t samples = Rate_Monitor_Configuration->Get_Sample_Count();
+
+    Scheduler_Get_Stats(Rate_Monitor_Control_Task_ID, &stats);
+
+    if ((Rate_Monitor_Ticks != 0) && (elapsed_ticks != 0) && (elapsed_cycles != 0))
+    {
+        Rate_Monitor_Sample_Hz = ((samples - Rate_Monitor_Samples) * ticks_per_second) / elapsed_ticks;
+        Rate_Monitor_Control_Hz = ((stats.Run_Count - Rate_Monitor_Control_Runs) * ticks_per_second) / elapsed_ticks;
+        Rate_Monitor_Load_Permille = 1000 - (uint32_t)(((uint64_t)(idle_cycles - Rate_Monitor_Idle_Cycles) * 1000) / elapsed_cycles);
+    }
+
+    Rate_Monitor_Ticks = ticks;
+    Rate_Monitor_Cycles = cycles;
+    Rate_Monitor_Idle_Cycles = idle_cycles;
+    Rate_Monitor_Samples = samples;
+    Rate_Monitor_Control_Runs = stats.Run_Count;
+}
+
+int Rate_Monitor_Command(char **arguments, uint8_t argument_count)
+{
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+    Rate_Policy_Rates rates;
+    Rate_Policy_Level level = Rate_Policy_Get_Level();
+
+    if ((argument_count != 1) || (strcmp(arguments[0], "rate") != 0))
+    {
+        return -1;
+    }
+
+    Rate_Policy_Get_Rates(level, &rates);
+    Print_Format_To_Buffer(line, sizeof(line), "rate level=%u sample=%lu/%lu ctl=%lu/%lu load=%lu.%lu%%", (unsigned int)level,
+                           (unsigned long)Rate_Monitor_Sample_Hz, (unsigned long)rates.Sample_Rate_Hz, (unsigned long)Rate_Monitor_Control_Hz,
+                           (unsigned long)(Rate_Monitor_Configuration->Ticks_Per_Second / rates.Control_Period_Ticks),
+                           (unsigned long)(Rate_Monitor_Load_Permille / 10), (unsigned long)(Rate_Monitor_Load_Permille % 10));
+    Rate_Monitor_Configuration->Output(line);
+
+    return 0;
+}
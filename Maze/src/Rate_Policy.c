@@ -0,0 +1,116 @@
+/**
+ * @file Rate_Policy.c
+ * @brief Source code for the Rate_Policy module.
+ *
+ * This file contains the function definitions for the Rate_Policy module.
+ * It selects the sample and control rates from the route state and the wheel speeds, with a hold time and a hysteresis.
+ *
+ */
+
+#include "../inc/Rate_Policy.h"
+
+static const Rate_Policy_Rates Rate_Policy_Table[RATE_POLICY_NUM_LEVELS] =
+{
+    { RATE_POLICY_IDLE_SAMPLE_RATE_HZ, RATE_POLICY_IDLE_CONTROL_PERIOD_TICKS },
+    { RATE_POLICY_EXPLORE_SAMPLE_RATE_HZ, RATE_POLICY_EXPLORE_CONTROL_PERIOD_TICKS },
+    { RATE_POLICY_SPRINT_SAMPLE_RATE_HZ, RATE_POLICY_SPRINT_CONTROL_PERIOD_TICKS }
+};
+
+static volatile Rate_Policy_Level Rate_Policy_Current_Level = RATE_POLICY_EXPLORE;
+
+// Number of consecutive calls that have requested a lower level, and number of level changes
+static uint16_t Rate_Policy_Lower_Count;
+static uint32_t Rate_Policy_Change_Count;
+
+// Selects a level and counts the change
+static void Rate_Policy_Select(Rate_Policy_Level level)
+{
+    if (level != Rate_Policy_Current_Level)
+    {
+        Rate_Policy_Current_Level = level;
+        Rate_Policy_Change_Count++;
+    }
+    Rate_Policy_Lower_Count = 0;
+}
+
+void Rate_Policy_Init(void)
+{
+    Rate_Policy_Current_Level = RATE_POLICY_EXPLORE;
+    Rate_Policy_Lower_Count = 0;
+    Rate_Policy_Change_Count = 0;
+}
+
+Rate_Policy_Level Rate_Policy_Update(uint8_t route_active, uint8_t speed_run, int16_t left_speed, int16_t right_speed)
+{
+    int32_t left_magnitude = (left_speed >= 0) ? left_speed : -left_speed;
+    int32_t right_magnitude = (right_speed >= 0) ? right_speed : -right_speed;
+    int32_t speed = (left_magnitude > right_magnitude) ? left_magnitude : right_magnitude;
+    int32_t sprint_speed = RATE_POLICY_SPRINT_SPEED;
+    Rate_Policy_Level requested;
+
+    // Once sprinting, the speed has to drop below the hysteresis to release the level
+    if (Rate_Policy_Current_Level == RATE_POLICY_SPRINT)
+    {
+        sprint_speed = RATE_POLICY_SPRINT_SPEED - RATE_POLICY_SPEED_HYSTERESIS;
+    }
+
+    if (speed_run || (speed >= sprint_speed))
+    {
+        requested = RATE_POLICY_SPRINT;
+    }
+    else if (route_active || (speed >= RATE_POLICY_PARKED_SPEED))
+    {
+        requested = RATE_POLICY_EXPLORE;
+    }
+    else
+    {
+        requested = RATE_POLICY_IDLE;
+    }
+
+    if (requested >= Rate_Policy_Current_Level)
+    {
+        Rate_Policy_Select(requested);
+    }
+    else
+    {
+        Rate_Policy_Lower_Count++;
+        if (Rate_Policy_Lower_Count >= RATE_POLICY_HOLD_TICKS)
+        {
+            Rate_Policy_Select(requested);
+        }
+    }
+
+    return Rate_Policy_Current_Level;
+}
+
+Rate_Policy_Level Rate_Policy_Wake(void)
+{
+    if (Rate_Policy_Current_Level == RATE_POLICY_IDLE)
+    {
+        Rate_Policy_Select(RATE_POLICY_EXPLORE);
+    }
+
+    return Rate_Policy_Current_Level;
+}
+
+Rate_Policy_Level Rate_Policy_Get_Level(void)
+{
+    return Rate_Policy_Current_Level;
+}
+
+int Rate_Policy_Get_Rates(Rate_Policy_Level level, Rate_Policy_Rates *rates)
+{
+    if (level >= RATE_POLICY_NUM_LEVELS)
+    {
+        return -1;
+    }
+
+    *rates = Rate_Policy_Table[level];
+
+    return 0;
+}
+
+uint32_t Rate_Policy_Get_Change_Count(void)
+{
+    return Rate_Policy_Change_Count;
+}
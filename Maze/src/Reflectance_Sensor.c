@@ -35,6 +35,29 @@
  */
 
 #include "../inc/Reflectance_Sensor.h"
+#include "../inc/Interrupt_Priority.h"
+#include "../inc/Profiler.h"
+
+/**
+ * @brief Phases of the timer-driven acquisition, executed when Timer32_1 expires.
+ */
+typedef enum
+{
+    REFLECTANCE_SENSOR_PHASE_CHARGE,
+    REFLECTANCE_SENSOR_PHASE_DECAY,
+    REFLECTANCE_SENSOR_PHASE_SAMPLE
+} Reflectance_Sensor_Phase;
+
+static Reflectance_Sensor_Phase Reflectance_Sensor_Next_Phase;
+
+// Timer32_1 load values of the decay and of the rest of the period in MCLK cycles
+static uint32_t Reflectance_Sensor_Decay_Cycles;
+static uint32_t Reflectance_Sensor_Idle_Cycles;
+
+static void (*Reflectance_Sensor_Task)(uint8_t reflectance_value);
+
+static volatile uint8_t Reflectance_Sensor_Value = 0;
+static volatile uint32_t Reflectance_Sensor_Sample_Count = 0;
 
 void Reflectance_Sensor_Init()
 {
@@ -152,3 +175,128 @@ uint8_t Reflectance_Sensor_End()
     // Return the local variable, "reflectance_value"
     return reflectance_value;
 }
+
+// Turns on the IR LEDs and drives the sensor output pins high
+static void Reflectance_Sensor_Charge(void)
+{
+    // Turn on the even-numbered and odd-numbered IR LEDs by setting Bit 3 of P5->OUT and Bit 2 of P9->OUT
+    P5->OUT |= 0x08;
+    P9->OUT |= 0x04;
+
+    // Configure P7.0 - P7.7 as output GPIO and set them high
+    P7->DIR |= 0xFF;
+    P7->OUT |= 0xFF;
+}
+
+int Reflectance_Sensor_Acquisition_Init(uint32_t sample_time_us, uint32_t period_us, void (*task)(uint8_t reflectance_value))
+{
+    if (period_us <= (REFLECTANCE_SENSOR_CHARGE_TIME_US + sample_time_us))
+    {
+        return -1;
+    }
+
+    Reflectance_Sensor_Task = task;
+    Reflectance_Sensor_Decay_Cycles = sample_time_us * REFLECTANCE_SENSOR_T32_CYCLES_PER_US;
+    Reflectance_Sensor_Idle_Cycles = (period_us - REFLECTANCE_SENSOR_CHARGE_TIME_US - sample_time_us) * REFLECTANCE_SENSOR_T32_CYCLES_PER_US;
+    Reflectance_Sensor_Sample_Count = 0;
+
+    // Halt Timer32_1 by clearing the ENABLE bit (Bit 7) of the CONTROL register
+    TIMER32_1->CONTROL &= ~0x00000080;
+
+    // Configure Timer32_1 in one-shot mode (Bit 0) with a 32-bit counter (Bit 1),
+    // a prescale value of 1 (Bits 3 to 2), and the interrupt enabled (Bit 5)
+    // Note: In one-shot mode, the counter stops at 0 and restarts when a new value is written to the LOAD register
+    TIMER32_1->CONTROL = 0x00000023;
+    TIMER32_1->INTCLR = 0;
+
+    // Set the interrupt priority level
+    // Timer32_1 has an IRQ number of 25
+    NVIC->IP[25] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_T32_INT1);
+
+    // Enable Interrupt 25 in NVIC by setting Bit 25 of the ISER register
+    NVIC->ISER[0] = 0x02000000;
+
+    // Start the first charge, and enable Timer32_1 to end it after the charge time
+    Reflectance_Sensor_Charge();
+    Reflectance_Sensor_Next_Phase = REFLECTANCE_SENSOR_PHASE_DECAY;
+    TIMER32_1->LOAD = REFLECTANCE_SENSOR_CHARGE_TIME_US * REFLECTANCE_SENSOR_T32_CYCLES_PER_US;
+    TIMER32_1->CONTROL |= 0x00000080;
+
+    return 0;
+}
+
+void Reflectance_Sensor_Acquisition_Stop(void)
+{
+    // Halt Timer32_1 by clearing the ENABLE bit (Bit 7) of the CONTROL register
+    TIMER32_1->CONTROL &= ~0x00000080;
+
+    // Disable Interrupt 25 in NVIC by setting Bit 25 of the ICER register
+    NVIC->ICER[0] = 0x02000000;
+
+    // Release the sensor output pins and turn off the IR LEDs
+    P7->DIR &= ~0xFF;
+    P5->OUT &= ~0x08;
+    P9->OUT &= ~0x04;
+}
+
+uint8_t Reflectance_Sensor_Get(void)
+{
+    return Reflectance_Sensor_Value;
+}
+
+uint32_t Reflectance_Sensor_Get_Sample_Count(void)
+{
+    return Reflectance_Sensor_Sample_Count;
+}
+
+void T32_INT1_IRQHandler(void)
+{
+    uint8_t reflectance_value;
+
+    PROFILER_START(PROFILER_T32_INT1);
+
+    // Acknowledge the Timer32_1 interrupt by writing any value to the INTCLR register
+    TIMER32_1->INTCLR = 0;
+
+    switch (Reflectance_Sensor_Next_Phase)
+    {
+        case REFLECTANCE_SENSOR_PHASE_CHARGE:
+        {
+            Reflectance_Sensor_Charge();
+            Reflectance_Sensor_Next_Phase = REFLECTANCE_SENSOR_PHASE_DECAY;
+            TIMER32_1->LOAD = REFLECTANCE_SENSOR_CHARGE_TIME_US * REFLECTANCE_SENSOR_T32_CYCLES_PER_US;
+            break;
+        }
+
+        case REFLECTANCE_SENSOR_PHASE_DECAY:
+        {
+            // Configure P7.0 - P7.7 as input GPIO and let the sensor outputs decay
+            P7->DIR &= ~0xFF;
+            Reflectance_Sensor_Next_Phase = REFLECTANCE_SENSOR_PHASE_SAMPLE;
+            TIMER32_1->LOAD = Reflectance_Sensor_Decay_Cycles;
+            break;
+        }
+
+        case REFLECTANCE_SENSOR_PHASE_SAMPLE:
+        {
+            // Read P7 and turn off the IR LEDs until the next charge
+            // Note: "1" indicates black while "0" indicates white
+            reflectance_value = P7->IN;
+            P5->OUT &= ~0x08;
+            P9->OUT &= ~0x04;
+
+            Reflectance_Sensor_Next_Phase = REFLECTANCE_SENSOR_PHASE_CHARGE;
+            TIMER32_1->LOAD = Reflectance_Sensor_Idle_Cycles;
+
+            Reflectance_Sensor_Value = reflectance_value;
+            Reflectance_Sensor_Sample_Count = Reflectance_Sensor_Sample_Count + 1;
+            if (Reflectance_Sensor_Task != 0)
+            {
+                (*Reflectance_Sensor_Task)(reflectance_value);
+            }
+            break;
+        }
+    }
+
+    PROFILER_STOP(PROFILER_T32_INT1);
+}
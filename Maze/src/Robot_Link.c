@@ -0,0 +1,299 @@
+/**
+ * @file Robot_Link.c
+ * @brief Source code for the Robot_Link module.
+ *
+ * This file contains the function definitions for the Robot_Link module.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Robot_Link.h"
+
+#if (ROBOT_LINK_MAP_NUM_CHUNKS > 32)
+#error "The chunks of a map must fit in the 32-bit mask of the received chunks"
+#endif
+
+// Frame buffers of the transmitter
+static uint8_t Robot_Link_TX_Frame[ROBOT_LINK_MAX_FRAME_LENGTH];
+static uint8_t Robot_Link_TX_Encoded[ROBOT_LINK_MAX_ENCODED_LENGTH];
+static uint8_t Robot_Link_TX_Sequence;
+
+// Pending frames: a request, a pose, and the chunks of a map from Robot_Link_Next_Chunk on
+static uint8_t Robot_Link_Request_Pending;
+static uint8_t Robot_Link_Pose_Pending;
+static Robot_Link_Pose Robot_Link_TX_Pose;
+static uint8_t Robot_Link_TX_Map[MAZE_MAP_STORAGE_SIZE];
+static uint8_t Robot_Link_TX_Map_Number;
+static uint8_t Robot_Link_Next_Chunk = ROBOT_LINK_MAP_NUM_CHUNKS;
+
+// Encoded bytes received since the last delimiter, discarded until the next delimiter if they do not fit
+static uint8_t Robot_Link_RX_Encoded[ROBOT_LINK_MAX_ENCODED_LENGTH];
+static uint8_t Robot_Link_RX_Frame[ROBOT_LINK_MAX_FRAME_LENGTH];
+static uint8_t Robot_Link_RX_Length;
+static uint8_t Robot_Link_RX_Discard;
+
+// Map being assembled, with a bit set for every chunk received, and the last complete map
+static uint8_t Robot_Link_RX_Map[MAZE_MAP_STORAGE_SIZE];
+static uint8_t Robot_Link_RX_Map_Number;
+static uint32_t Robot_Link_RX_Chunks;
+static uint8_t Robot_Link_Map[MAZE_MAP_STORAGE_SIZE];
+static uint8_t Robot_Link_Map_Received;
+
+static Robot_Link_Pose Robot_Link_Pose_Value;
+static uint8_t Robot_Link_Pose_Received;
+static uint8_t Robot_Link_Request_Received;
+
+static uint32_t Robot_Link_Errors;
+
+// Returns the number of map bytes in a chunk, the last chunk may be shorter
+static uint8_t Robot_Link_Chunk_Length(uint8_t chunk)
+{
+    uint16_t offset = (uint16_t)chunk * ROBOT_LINK_MAP_CHUNK_SIZE;
+
+    return ((MAZE_MAP_STORAGE_SIZE - offset) < ROBOT_LINK_MAP_CHUNK_SIZE) ? (MAZE_MAP_STORAGE_SIZE - offset) : ROBOT_LINK_MAP_CHUNK_SIZE;
+}
+
+// Frames, encodes, and queues a packet, the caller checks that an encoded frame fits in the TX ring buffer
+static void Robot_Link_Send_Frame(uint8_t type, const uint8_t *payload, uint8_t length)
+{
+    uint32_t encoded_length;
+    uint16_t crc;
+
+    Robot_Link_TX_Frame[0] = type;
+    Robot_Link_TX_Frame[1] = Robot_Link_TX_Sequence;
+    memcpy(&Robot_Link_TX_Frame[2], payload, length);
+
+    crc = Telemetry_CRC16(Robot_Link_TX_Frame, length + 2);
+    Robot_Link_TX_Frame[length + 2] = (uint8_t)crc;
+    Robot_Link_TX_Frame[length + 3] = (uint8_t)(crc >> 8);
+
+    encoded_length = Telemetry_COBS_Encode(Robot_Link_TX_Frame, length + 4, Robot_Link_TX_Encoded);
+    Robot_Link_TX_Encoded[encoded_length] = 0x00;
+    encoded_length++;
+
+    EUSCI_A3_UART_Queue_Bytes(Robot_Link_TX_Encoded, encoded_length);
+    Robot_Link_TX_Sequence = Robot_Link_TX_Sequence + 1;
+}
+
+// Queues the next pending frame, returns 0 if there is none
+static uint8_t Robot_Link_Send_Next(void)
+{
+    uint8_t payload[ROBOT_LINK_MAX_PAYLOAD_LENGTH];
+    uint8_t length;
+
+    if (Robot_Link_Request_Pending)
+    {
+        Robot_Link_Request_Pending = 0;
+        Robot_Link_Send_Frame(ROBOT_LINK_PACKET_REQUEST, payload, 0);
+        return 1;
+    }
+
+    if (Robot_Link_Pose_Pending)
+    {
+        Robot_Link_Pose_Pending = 0;
+        payload[0] = Robot_Link_TX_Pose.X;
+        payload[1] = Robot_Link_TX_Pose.Y;
+        payload[2] = Robot_Link_TX_Pose.Heading;
+        payload[3] = Robot_Link_TX_Pose.Flags;
+        Robot_Link_Send_Frame(ROBOT_LINK_PACKET_POSE, payload, ROBOT_LINK_POSE_PAYLOAD_LENGTH);
+        return 1;
+    }
+
+    if (Robot_Link_Next_Chunk < ROBOT_LINK_MAP_NUM_CHUNKS)
+    {
+        length = Robot_Link_Chunk_Length(Robot_Link_Next_Chunk);
+        payload[0] = Robot_Link_TX_Map_Number;
+        payload[1] = Robot_Link_Next_Chunk;
+        memcpy(&payload[2], &Robot_Link_TX_Map[Robot_Link_Next_Chunk * ROBOT_LINK_MAP_CHUNK_SIZE], length);
+        Robot_Link_Send_Frame(ROBOT_LINK_PACKET_MAP, payload, length + 2);
+        Robot_Link_Next_Chunk = Robot_Link_Next_Chunk + 1;
+        return 1;
+    }
+
+    return 0;
+}
+
+// Stores a chunk of a map, and publishes the map when its last missing chunk is received
+static void Robot_Link_Receive_Chunk(const uint8_t *payload, uint8_t length)
+{
+    uint8_t number = payload[0];
+    uint8_t chunk = payload[1];
+
+    if ((chunk >= ROBOT_LINK_MAP_NUM_CHUNKS) || (length != (Robot_Link_Chunk_Length(chunk) + 2)))
+    {
+        Robot_Link_Errors = Robot_Link_Errors + 1;
+        return;
+    }
+
+    // The chunks of an older map are discarded when a new map starts
+    if (number != Robot_Link_RX_Map_Number)
+    {
+        Robot_Link_RX_Map_Number = number;
+        Robot_Link_RX_Chunks = 0;
+    }
+
+    memcpy(&Robot_Link_RX_Map[chunk * ROBOT_LINK_MAP_CHUNK_SIZE], &payload[2], length - 2);
+    Robot_Link_RX_Chunks = Robot_Link_RX_Chunks | (1UL << chunk);
+
+    if (Robot_Link_RX_Chunks == ((1UL << ROBOT_LINK_MAP_NUM_CHUNKS) - 1))
+    {
+        memcpy(Robot_Link_Map, Robot_Link_RX_Map, MAZE_MAP_STORAGE_SIZE);
+        Robot_Link_Map_Received = 1;
+        Robot_Link_RX_Chunks = 0;
+    }
+}
+
+// Decodes and checks the frame received before a delimiter, then handles its packet
+static void Robot_Link_Receive_Frame(void)
+{
+    int32_t length;
+    uint16_t crc;
+    const uint8_t *payload = &Robot_Link_RX_Frame[2];
+
+    length = Telemetry_COBS_Decode(Robot_Link_RX_Encoded, Robot_Link_RX_Length, Robot_Link_RX_Frame, ROBOT_LINK_MAX_FRAME_LENGTH);
+    if (length < 4)
+    {
+        Robot_Link_Errors = Robot_Link_Errors + 1;
+        return;
+    }
+
+    crc = Robot_Link_RX_Frame[length - 2] | ((uint16_t)Robot_Link_RX_Frame[length - 1] << 8);
+    if (Telemetry_CRC16(Robot_Link_RX_Frame, length - 2) != crc)
+    {
+        Robot_Link_Errors = Robot_Link_Errors + 1;
+        return;
+    }
+    length = length - 4;
+
+    if ((Robot_Link_RX_Frame[0] == ROBOT_LINK_PACKET_REQUEST) && (length == 0))
+    {
+        Robot_Link_Request_Received = 1;
+    }
+    else if ((Robot_Link_RX_Frame[0] == ROBOT_LINK_PACKET_POSE) && (length == ROBOT_LINK_POSE_PAYLOAD_LENGTH))
+    {
+        Robot_Link_Pose_Value.X = payload[0];
+        Robot_Link_Pose_Value.Y = payload[1];
+        Robot_Link_Pose_Value.Heading = payload[2];
+        Robot_Link_Pose_Value.Flags = payload[3];
+        Robot_Link_Pose_Received = 1;
+    }
+    else if ((Robot_Link_RX_Frame[0] == ROBOT_LINK_PACKET_MAP) && (length >= 2))
+    {
+        Robot_Link_Receive_Chunk(payload, (uint8_t)length);
+    }
+    else
+    {
+        Robot_Link_Errors = Robot_Link_Errors + 1;
+    }
+}
+
+void Robot_Link_Init(void)
+{
+    Robot_Link_Request_Pending = 0;
+    Robot_Link_Pose_Pending = 0;
+    Robot_Link_Next_Chunk = ROBOT_LINK_MAP_NUM_CHUNKS;
+    Robot_Link_RX_Length = 0;
+    Robot_Link_RX_Discard = 0;
+    Robot_Link_RX_Chunks = 0;
+    Robot_Link_Map_Received = 0;
+    Robot_Link_Pose_Received = 0;
+    Robot_Link_Request_Received = 0;
+    Robot_Link_Errors = 0;
+
+    EUSCI_A3_UART_Init();
+    EUSCI_A3_UART_Enable_RX_Interrupt();
+}
+
+void Robot_Link_Send_Request(void)
+{
+    Robot_Link_Request_Pending = 1;
+}
+
+void Robot_Link_Send_Pose(const Robot_Link_Pose *pose)
+{
+    Robot_Link_TX_Pose = *pose;
+    Robot_Link_Pose_Pending = 1;
+}
+
+void Robot_Link_Send_Map(const uint8_t *map)
+{
+    memcpy(Robot_Link_TX_Map, map, MAZE_MAP_STORAGE_SIZE);
+    Robot_Link_TX_Map_Number = Robot_Link_TX_Map_Number + 1;
+    Robot_Link_Next_Chunk = 0;
+}
+
+uint8_t Robot_Link_Is_Sending(void)
+{
+    return Robot_Link_Request_Pending || Robot_Link_Pose_Pending || (Robot_Link_Next_Chunk < ROBOT_LINK_MAP_NUM_CHUNKS);
+}
+
+void Robot_Link_Task(void)
+{
+    uint8_t data;
+
+    while (EUSCI_A3_UART_Read_Byte(&data))
+    {
+        if (data == 0x00)
+        {
+            if ((Robot_Link_RX_Discard == 0) && (Robot_Link_RX_Length > 0))
+            {
+                Robot_Link_Receive_Frame();
+            }
+            Robot_Link_RX_Length = 0;
+            Robot_Link_RX_Discard = 0;
+        }
+        else if (Robot_Link_RX_Length < ROBOT_LINK_MAX_ENCODED_LENGTH)
+        {
+            Robot_Link_RX_Encoded[Robot_Link_RX_Length] = data;
+            Robot_Link_RX_Length = Robot_Link_RX_Length + 1;
+        }
+        else if (Robot_Link_RX_Discard == 0)
+        {
+            Robot_Link_RX_Discard = 1;
+            Robot_Link_Errors = Robot_Link_Errors + 1;
+        }
+    }
+
+    // A frame is only queued whole, the remaining frames wait for the next call
+    while ((EUSCI_A3_UART_TX_Free() >= ROBOT_LINK_MAX_ENCODED_LENGTH) && Robot_Link_Send_Next());
+}
+
+uint8_t Robot_Link_Get_Request(void)
+{
+    uint8_t received = Robot_Link_Request_Received;
+
+    Robot_Link_Request_Received = 0;
+
+    return received;
+}
+
+uint8_t Robot_Link_Get_Pose(Robot_Link_Pose *pose)
+{
+    if (Robot_Link_Pose_Received == 0)
+    {
+        return 0;
+    }
+
+    *pose = Robot_Link_Pose_Value;
+    Robot_Link_Pose_Received = 0;
+
+    return 1;
+}
+
+uint8_t Robot_Link_Get_Map(uint8_t *map)
+{
+    if (Robot_Link_Map_Received == 0)
+    {
+        return 0;
+    }
+
+    memcpy(map, Robot_Link_Map, MAZE_MAP_STORAGE_SIZE);
+    Robot_Link_Map_Received = 0;
+
+    return 1;
+}
+
+uint32_t Robot_Link_Get_Errors(void)
+{
+    return Robot_Link_Errors;
+}
@@ -0,0 +1,566 @@
+/**
+ * @file Route.c
+ * @brief Source code for the Route driver.
+ *
+ * This file contains the function definitions for the Route driver.
+ * It records the route driven by the robot as a compact list of motion primitives
+ * and replays a recorded route with the Motion driver.
+ *
+ */
+
+#include "../inc/Route.h"
+
+// Route being recorded and the pose at the start of the current straight
+static Route_Path *Route_Record_Path;
+static uint8_t Route_Recording = 0;
+static uint32_t Route_Record_Cell_Size_um;
+static uint32_t Route_Record_Direction;
+static int32_t Route_Record_Start_X_um;
+static int32_t Route_Record_Start_Y_um;
+
+// Plan being replayed and the index of the next segment to queue
+static const Route_Plan *Route_Replay_Plan;
+static const Route_Replay_Config *Route_Replay_Parameters;
+static uint8_t Route_Replay_Index;
+static uint8_t Route_Replay_Active = 0;
+
+// Set to 1 when the last replay has completed every segment of its plan
+static uint8_t Route_Replay_Complete = 0;
+
+// Number of segments started by the Motion driver, and the planned pose at the start of the last one
+static uint8_t Route_Replay_Started;
+static int32_t Route_Replay_X_um;
+static int32_t Route_Replay_Y_um;
+static uint32_t Route_Replay_Heading;
+
+// Center of the start cell, moved by the corrections at the wall borders like the planned pose,
+// the odometry distance at the start of the active straight, and the open sides of the last Junction event
+static int32_t Route_Replay_Origin_X_um;
+static int32_t Route_Replay_Origin_Y_um;
+static int32_t Route_Replay_Straight_Start_um;
+static uint8_t Route_Replay_Openings;
+
+static int8_t Route_Get_Quarter_Turns(uint8_t step)
+{
+    if (ROUTE_STEP_TYPE(step) == ROUTE_STEP_TURN_LEFT)
+    {
+        return ROUTE_STEP_COUNT(step);
+    }
+
+    return -ROUTE_STEP_COUNT(step);
+}
+
+void Route_Clear(Route_Path *path)
+{
+    path->Length = 0;
+    path->Overflow = 0;
+}
+
+int Route_Append(Route_Path *path, Route_Step_Type type, uint8_t count)
+{
+    uint8_t last_step;
+    uint8_t quarter_turns;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (path->Length > 0)
+    {
+        last_step = path->Steps[path->Length - 1];
+
+        // Extend the last straight
+        if ((type == ROUTE_STEP_STRAIGHT) && (ROUTE_STEP_TYPE(last_step) == ROUTE_STEP_STRAIGHT)
+            && ((ROUTE_STEP_COUNT(last_step) + count) <= ROUTE_MAX_STEP_COUNT))
+        {
+            path->Steps[path->Length - 1] = ROUTE_STEP(ROUTE_STEP_STRAIGHT, ROUTE_STEP_COUNT(last_step) + count);
+            return 0;
+        }
+
+        // Combine consecutive turns into the equivalent turn between -90 and +180 degrees
+        if ((type != ROUTE_STEP_STRAIGHT) && (ROUTE_STEP_TYPE(last_step) != ROUTE_STEP_STRAIGHT))
+        {
+            quarter_turns = (Route_Get_Quarter_Turns(last_step)
+                             + ((type == ROUTE_STEP_TURN_LEFT) ? (int8_t)count : -(int8_t)count)) & 0x3;
+
+            if (quarter_turns == 0)
+            {
+                path->Length = path->Length - 1;
+            }
+            else if (quarter_turns == 3)
+            {
+                path->Steps[path->Length - 1] = ROUTE_STEP(ROUTE_STEP_TURN_RIGHT, 1);
+            }
+            else
+            {
+                path->Steps[path->Length - 1] = ROUTE_STEP(ROUTE_STEP_TURN_LEFT, quarter_turns);
+            }
+            return 0;
+        }
+    }
+
+    if (path->Length >= ROUTE_MAX_STEPS)
+    {
+        path->Overflow = 1;
+        return -1;
+    }
+
+    path->Steps[path->Length] = ROUTE_STEP(type, count);
+    path->Length = path->Length + 1;
+
+    return 0;
+}
+
+static void Route_Record_Straight(const Odometry_Pose *pose)
+{
+    int64_t distance_um;
+    uint32_t cells;
+    uint8_t count;
+
+    // Project the displacement on the grid direction, so a sideways drift does not count
+    distance_um = (((int64_t)(pose->X_um - Route_Record_Start_X_um) * Odometry_Cos(Route_Record_Direction))
+                   + ((int64_t)(pose->Y_um - Route_Record_Start_Y_um) * Odometry_Sin(Route_Record_Direction))) >> 15;
+
+    Route_Record_Start_X_um = pose->X_um;
+    Route_Record_Start_Y_um = pose->Y_um;
+
+    if (distance_um <= 0)
+    {
+        return;
+    }
+
+    cells = (distance_um + (Route_Record_Cell_Size_um / 2)) / Route_Record_Cell_Size_um;
+    while (cells > 0)
+    {
+        count = (cells > ROUTE_MAX_STEP_COUNT) ? ROUTE_MAX_STEP_COUNT : cells;
+        Route_Append(Route_Record_Path, ROUTE_STEP_STRAIGHT, count);
+        cells = cells - count;
+    }
+}
+
+void Route_Record_Start(Route_Path *path, uint16_t cell_size_mm)
+{
+    Odometry_Pose pose;
+
+    Odometry_Get_Pose(&pose);
+    Route_Clear(path);
+
+    Route_Record_Path = path;
+    Route_Record_Cell_Size_um = (uint32_t)cell_size_mm * 1000;
+    Route_Record_Direction = pose.Heading;
+    Route_Record_Start_X_um = pose.X_um;
+    Route_Record_Start_Y_um = pose.Y_um;
+    Route_Recording = 1;
+}
+
+void Route_Record_Update()
+{
+    Odometry_Pose pose;
+    int32_t deviation;
+
+    if (Route_Recording == 0)
+    {
+        return;
+    }
+
+    Odometry_Get_Pose(&pose);
+
+    // Signed difference between the heading and the grid direction
+    deviation = (int32_t)(pose.Heading - Route_Record_Direction);
+
+    if (deviation > (ROUTE_TURN_THRESHOLD_DEGREES * ODOMETRY_HEADING_ONE_DEGREE))
+    {
+        Route_Record_Straight(&pose);
+        Route_Append(Route_Record_Path, ROUTE_STEP_TURN_LEFT, 1);
+        Route_Record_Direction = Route_Record_Direction + ODOMETRY_HEADING_90;
+    }
+    else if (deviation < -(ROUTE_TURN_THRESHOLD_DEGREES * ODOMETRY_HEADING_ONE_DEGREE))
+    {
+        Route_Record_Straight(&pose);
+        Route_Append(Route_Record_Path, ROUTE_STEP_TURN_RIGHT, 1);
+        Route_Record_Direction = Route_Record_Direction - ODOMETRY_HEADING_90;
+    }
+}
+
+void Route_Record_Stop()
+{
+    Odometry_Pose pose;
+
+    if (Route_Recording == 0)
+    {
+        return;
+    }
+
+    Odometry_Get_Pose(&pose);
+    Route_Record_Straight(&pose);
+    Route_Recording = 0;
+}
+
+uint8_t Route_Is_Recording()
+{
+    return Route_Recording;
+}
+
+static int Route_Add_Segment(Route_Plan *plan, Route_Segment_Type type, int32_t amount, uint16_t speed_limit)
+{
+    Route_Segment *segment;
+    int32_t length;
+
+    do
+    {
+        if (plan->Length >= ROUTE_MAX_STEPS)
+        {
+            plan->Overflow = 1;
+            return -1;
+        }
+
+        // Split a long straight into segments that fit in the Motion command
+        length = amount;
+        if ((type == ROUTE_SEGMENT_STRAIGHT) && (length > ROUTE_MAX_SEGMENT_LENGTH))
+        {
+            length = ROUTE_MAX_SEGMENT_LENGTH;
+        }
+
+        segment = &plan->Segments[plan->Length];
+        segment->Type = type;
+        segment->Amount = length;
+        segment->Speed_Limit = speed_limit;
+        segment->End_Speed = 0;
+        plan->Length = plan->Length + 1;
+
+        amount = amount - length;
+    } while (amount > 0);
+
+    return 0;
+}
+
+int Route_Smooth(const Route_Path *path, const Route_Replay_Config *config, Route_Plan *plan)
+{
+    uint8_t index;
+    uint8_t step;
+    int16_t angle;
+    int32_t straight_mm = 0;
+    int32_t radius = config->Arc_Radius_mm;
+
+    plan->Length = 0;
+    plan->Overflow = 0;
+
+    for (index = 0; index < path->Length; index++)
+    {
+        step = path->Steps[index];
+
+        // Merge consecutive straight steps
+        if (ROUTE_STEP_TYPE(step) == ROUTE_STEP_STRAIGHT)
+        {
+            straight_mm = straight_mm + (ROUTE_STEP_COUNT(step) * config->Cell_Size_mm);
+            continue;
+        }
+
+        angle = ROUTE_STEP_COUNT(step) * 90;
+        if (ROUTE_STEP_TYPE(step) == ROUTE_STEP_TURN_RIGHT)
+        {
+            angle = -angle;
+        }
+
+        if ((radius > 0) && (ROUTE_STEP_COUNT(step) == 1) && (straight_mm >= radius)
+            && ((index + 1) < path->Length) && (ROUTE_STEP_TYPE(path->Steps[index + 1]) == ROUTE_STEP_STRAIGHT))
+        {
+            // Cut the corner: the arc uses the last part of this straight and the first part of the next one
+            if ((straight_mm - radius) > 0)
+            {
+                Route_Add_Segment(plan, ROUTE_SEGMENT_STRAIGHT, straight_mm - radius, config->Max_Speed);
+            }
+            Route_Add_Segment(plan, ROUTE_SEGMENT_ARC, angle, config->Arc_Speed);
+            straight_mm = -radius;
+        }
+        else
+        {
+            if (straight_mm > 0)
+            {
+                Route_Add_Segment(plan, ROUTE_SEGMENT_STRAIGHT, straight_mm, config->Max_Speed);
+            }
+            Route_Add_Segment(plan, ROUTE_SEGMENT_TURN, angle, 0);
+            straight_mm = 0;
+        }
+    }
+
+    if (straight_mm > 0)
+    {
+        Route_Add_Segment(plan, ROUTE_SEGMENT_STRAIGHT, straight_mm, config->Max_Speed);
+    }
+
+    // Each segment ends at the speed limit of the next one, the last segment ends at rest
+    for (index = 0; (index + 1) < plan->Length; index++)
+    {
+        plan->Segments[index].End_Speed = plan->Segments[index + 1].Speed_Limit;
+    }
+
+    return (plan->Overflow) ? -1 : 0;
+}
+
+// Moves the planned pose from the start to the end of a segment
+static void Route_Replay_Advance(const Route_Segment *segment)
+{
+    int64_t cos = Odometry_Cos(Route_Replay_Heading);
+    int64_t sin = Odometry_Sin(Route_Replay_Heading);
+    int64_t radius_um = (int64_t)Route_Replay_Parameters->Arc_Radius_mm * 1000;
+    int64_t length_um;
+
+    switch (segment->Type)
+    {
+        case ROUTE_SEGMENT_STRAIGHT:
+        {
+            length_um = (int64_t)segment->Amount * 1000;
+            Route_Replay_X_um = Route_Replay_X_um + (int32_t)((length_um * cos) >> 15);
+            Route_Replay_Y_um = Route_Replay_Y_um + (int32_t)((length_um * sin) >> 15);
+        }
+        break;
+
+        case ROUTE_SEGMENT_ARC:
+        {
+            // A 90 degree arc ends one radius ahead and one radius to the side of its start
+            if (segment->Amount >= 0)
+            {
+                Route_Replay_X_um = Route_Replay_X_um + (int32_t)((radius_um * (cos - sin)) >> 15);
+                Route_Replay_Y_um = Route_Replay_Y_um + (int32_t)((radius_um * (sin + cos)) >> 15);
+                Route_Replay_Heading = Route_Replay_Heading + ODOMETRY_HEADING_90;
+            }
+            else
+            {
+                Route_Replay_X_um = Route_Replay_X_um + (int32_t)((radius_um * (cos + sin)) >> 15);
+                Route_Replay_Y_um = Route_Replay_Y_um + (int32_t)((radius_um * (sin - cos)) >> 15);
+                Route_Replay_Heading = Route_Replay_Heading - ODOMETRY_HEADING_90;
+            }
+        }
+        break;
+
+        default:
+        {
+            Route_Replay_Heading = Route_Replay_Heading + ((uint32_t)(segment->Amount / 90) * ODOMETRY_HEADING_90);
+        }
+        break;
+    }
+}
+
+// Moves the plan along the active straight when a side wall starts or ends during it. A side wall starts or ends
+// at the border of a cell, so the odometry distance error of the previous segments does not add up
+static void Route_Replay_Locate(const Odometry_Pose *pose, int64_t cos, int64_t sin)
+{
+    Junction_Event event;
+    uint8_t changed;
+    int32_t cell_size_um = (int32_t)Route_Replay_Parameters->Cell_Size_mm * 1000;
+    int32_t border_um;
+    int32_t error_um;
+
+    while (Junction_Get_Event(&event))
+    {
+        changed = event.Openings ^ Route_Replay_Openings;
+        Route_Replay_Openings = event.Openings;
+
+        // Only a straight moves the sensors along the walls on the grid
+        if (((changed & (JUNCTION_OPEN_LEFT | JUNCTION_OPEN_RIGHT)) == 0) || (event.Distance_um < Route_Replay_Straight_Start_um))
+        {
+            continue;
+        }
+
+        // Position of the border seen by the side sensor from the center of the start cell,
+        // where the borders are half a cell away from the centers
+        border_um = (int32_t)((((int64_t)(pose->X_um - Route_Replay_Origin_X_um) * cos) + ((int64_t)(pose->Y_um - Route_Replay_Origin_Y_um) * sin)) >> 15)
+                    - (Odometry_Get_Distance_um() - event.Distance_um) + ((int32_t)Route_Replay_Parameters->Side_Sensor_Offset_mm * 1000);
+        error_um = (border_um + (cell_size_um / 2)) % cell_size_um;
+        if (error_um < 0)
+        {
+            error_um = error_um + cell_size_um;
+        }
+        if (error_um > (cell_size_um / 2))
+        {
+            error_um = error_um - cell_size_um;
+        }
+
+        // A change far from a border is a wrong reading
+        if ((error_um > -(cell_size_um / 4)) && (error_um < (cell_size_um / 4)))
+        {
+            Route_Replay_X_um = Route_Replay_X_um + (int32_t)((error_um * cos) >> 15);
+            Route_Replay_Y_um = Route_Replay_Y_um + (int32_t)((error_um * sin) >> 15);
+            Route_Replay_Origin_X_um = Route_Replay_Origin_X_um + (int32_t)((error_um * cos) >> 15);
+            Route_Replay_Origin_Y_um = Route_Replay_Origin_Y_um + (int32_t)((error_um * sin) >> 15);
+        }
+    }
+}
+
+// Corrects the active segment with the planned pose, so the errors of the previous segments do not add up
+static void Route_Replay_Correct(const Route_Segment *segment, uint8_t started)
+{
+    Odometry_Pose pose;
+    Junction_Event event;
+    int64_t cos;
+    int64_t sin;
+    int64_t dx_um;
+    int64_t dy_um;
+    int32_t along_um;
+    int32_t lateral_um;
+    int64_t steer;
+
+    // A turn or an arc ends on the planned heading, measured from its planned start heading
+    if (segment->Type != ROUTE_SEGMENT_STRAIGHT)
+    {
+        if (started)
+        {
+            Motion_Set_Reference_Heading(Route_Replay_Heading);
+        }
+        while (Junction_Get_Event(&event))
+        {
+            Route_Replay_Openings = event.Openings;
+        }
+        return;
+    }
+
+    if (started)
+    {
+        Route_Replay_Straight_Start_um = Odometry_Get_Distance_um();
+    }
+
+    Odometry_Get_Pose(&pose);
+    cos = Odometry_Cos(Route_Replay_Heading);
+    sin = Odometry_Sin(Route_Replay_Heading);
+    Route_Replay_Locate(&pose, cos, sin);
+
+    // Position along the straight from its planned start, and offset to the left of its line
+    dx_um = pose.X_um - Route_Replay_X_um;
+    dy_um = pose.Y_um - Route_Replay_Y_um;
+    along_um = (int32_t)(((dx_um * cos) + (dy_um * sin)) >> 15);
+    lateral_um = (int32_t)(((dy_um * cos) - (dx_um * sin)) >> 15);
+
+    // Steer back to the line at an angle of offset / ROUTE_REPLAY_LOOKAHEAD_MM radians (2^32 / (2 * pi) per radian)
+    steer = -(((int64_t)lateral_um * 683565276) / ((int64_t)ROUTE_REPLAY_LOOKAHEAD_MM * 1000));
+    if (steer > ((int64_t)ROUTE_REPLAY_MAX_STEER_DEGREES * ODOMETRY_HEADING_ONE_DEGREE))
+    {
+        steer = (int64_t)ROUTE_REPLAY_MAX_STEER_DEGREES * ODOMETRY_HEADING_ONE_DEGREE;
+    }
+    else if (steer < -((int64_t)ROUTE_REPLAY_MAX_STEER_DEGREES * ODOMETRY_HEADING_ONE_DEGREE))
+    {
+        steer = -((int64_t)ROUTE_REPLAY_MAX_STEER_DEGREES * ODOMETRY_HEADING_ONE_DEGREE);
+    }
+
+    Motion_Set_Reference_Heading(Route_Replay_Heading + (int32_t)steer);
+    Motion_Set_Remaining_Distance(segment->Amount - (along_um / 1000));
+}
+
+void Route_Replay_Start(const Route_Plan *plan, const Route_Replay_Config *config)
+{
+    Odometry_Pose pose;
+
+    // The plan starts from the current pose, like the route was recorded from the pose at its start
+    Odometry_Get_Pose(&pose);
+    Route_Replay_X_um = pose.X_um;
+    Route_Replay_Y_um = pose.Y_um;
+    Route_Replay_Heading = pose.Heading;
+    Route_Replay_Origin_X_um = pose.X_um;
+    Route_Replay_Origin_Y_um = pose.Y_um;
+    Route_Replay_Started = 0;
+    Route_Replay_Openings = Junction_Get_Openings();
+
+    Route_Replay_Plan = plan;
+    Route_Replay_Parameters = config;
+    Route_Replay_Index = 0;
+    Route_Replay_Active = 1;
+    Route_Replay_Complete = 0;
+}
+
+void Route_Replay_Update()
+{
+    const Route_Segment *segment;
+    uint16_t cells;
+    uint8_t started;
+    int status;
+
+    if (Route_Replay_Active == 0)
+    {
+        return;
+    }
+
+    // Follow the segments started by the Motion driver since the last tick
+    started = 0;
+    while ((uint8_t)(Route_Replay_Index - Motion_Get_Queued_Count()) > Route_Replay_Started)
+    {
+        if (Route_Replay_Started > 0)
+        {
+            Route_Replay_Advance(&Route_Replay_Plan->Segments[Route_Replay_Started - 1]);
+        }
+        Route_Replay_Started = Route_Replay_Started + 1;
+        started = 1;
+    }
+
+    // A segment that has timed out has not reached its end, so the rest of the plan would not follow the maze
+    if ((started && (Route_Replay_Started > 1)) && (Motion_Get_Last_Result() != MOTION_RESULT_DONE))
+    {
+        Route_Replay_Abort();
+        return;
+    }
+    if (Route_Replay_Started > 0)
+    {
+        Route_Replay_Correct(&Route_Replay_Plan->Segments[Route_Replay_Started - 1], started);
+    }
+
+    // Keep the Motion queue filled, so the next segment starts in the same tick as the previous one ends
+    while (Route_Replay_Index < Route_Replay_Plan->Length)
+    {
+        segment = &Route_Replay_Plan->Segments[Route_Replay_Index];
+
+        switch (segment->Type)
+        {
+            case ROUTE_SEGMENT_STRAIGHT:
+            {
+                cells = (segment->Amount / Route_Replay_Parameters->Cell_Size_mm) + 1;
+                status = Motion_Drive_Profiled(segment->Amount, segment->Speed_Limit, segment->End_Speed,
+                                               Route_Replay_Parameters->Acceleration, cells * Route_Replay_Parameters->Cell_Timeout_Ticks);
+            }
+            break;
+
+            case ROUTE_SEGMENT_ARC:
+            {
+                status = Motion_Arc(segment->Amount, Route_Replay_Parameters->Arc_Radius_mm, segment->Speed_Limit,
+                                    Route_Replay_Parameters->Cell_Timeout_Ticks);
+            }
+            break;
+
+            default:
+            {
+                status = Motion_Turn(segment->Amount, Route_Replay_Parameters->Turn_Duty_Cycle,
+                                     ((segment->Amount < 0) ? -segment->Amount : segment->Amount) / 90 * Route_Replay_Parameters->Turn_Timeout_Ticks);
+            }
+            break;
+        }
+
+        // Try again in the next tick when the queue is full
+        if (status != 0)
+        {
+            return;
+        }
+
+        Route_Replay_Index = Route_Replay_Index + 1;
+    }
+
+    if (Motion_Is_Busy() == 0)
+    {
+        Route_Replay_Active = 0;
+        Route_Replay_Complete = (Route_Replay_Started == Route_Replay_Plan->Length) && (Motion_Get_Last_Result() == MOTION_RESULT_DONE);
+    }
+}
+
+void Route_Replay_Abort()
+{
+    Route_Replay_Active = 0;
+    Motion_Abort();
+}
+
+uint8_t Route_Replay_Is_Active()
+{
+    return Route_Replay_Active;
+}
+
+uint8_t Route_Replay_Is_Complete()
+{
+    return Route_Replay_Complete;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file Route_Race.c
+ * @brief Source code for the Route_Race module.
+ *
+ * This file contains the function definitions for the Route_Race module.
+ * It runs the registered maze strategies back to back and keeps the times of their trials.
+ *
+ */
+
+#include "../inc/Route_Race.h"
+
+// Registered strategies and the times of their trials
+static Route_Race_Strategy Route_Race_Strategies[ROUTE_RACE_MAX_STRATEGIES];
+static Route_Race_Stats Route_Race_Times[ROUTE_RACE_MAX_STRATEGIES];
+static uint8_t Route_Race_Count = 0;
+
+// Selected trial and number of trials of the race
+static volatile Route_Race_State Route_Race_Current_State = ROUTE_RACE_IDLE;
+static uint32_t Route_Race_Trial = 0;
+static uint32_t Route_Race_Num_Trials = 0;
+
+void Route_Race_Init(void)
+{
+    Route_Race_Count = 0;
+    Route_Race_Trial = 0;
+    Route_Race_Num_Trials = 0;
+    Route_Race_Current_State = ROUTE_RACE_IDLE;
+}
+
+int Route_Race_Register(const char *name, void (*start)(void), uint8_t (*step)(void))
+{
+    if (Route_Race_Count >= ROUTE_RACE_MAX_STRATEGIES)
+    {
+        return -1;
+    }
+
+    Route_Race_Strategies[Route_Race_Count].Name = name;
+    Route_Race_Strategies[Route_Race_Count].Start = start;
+    Route_Race_Strategies[Route_Race_Count].Step = step;
+    Route_Race_Count++;
+
+    return Route_Race_Count - 1;
+}
+
+void Route_Race_Start(uint32_t rounds)
+{
+    int i;
+
+    for (i = 0; i < ROUTE_RACE_MAX_STRATEGIES; i++)
+    {
+        Route_Race_Times[i].Trials = 0;
+        Route_Race_Times[i].Min_ms = 0;
+        Route_Race_Times[i].Max_ms = 0;
+        Route_Race_Times[i].Total_ms = 0;
+    }
+
+    Route_Race_Trial = 0;
+    Route_Race_Num_Trials = rounds * Route_Race_Count;
+    Route_Race_Current_State = (Route_Race_Num_Trials > 0) ? ROUTE_RACE_READY : ROUTE_RACE_DONE;
+}
+
+int Route_Race_Start_Trial(void)
+{
+    const Route_Race_Strategy *strategy;
+
+    if (Route_Race_Current_State != ROUTE_RACE_READY)
+    {
+        return -1;
+    }
+
+    strategy = &Route_Race_Strategies[Route_Race_Trial % Route_Race_Count];
+    if (strategy->Start != 0)
+    {
+        strategy->Start();
+    }
+
+    // Set last, so the control tick only calls the Step function of a prepared strategy
+    Route_Race_Current_State = ROUTE_RACE_RUNNING;
+
+    return Route_Race_Trial % Route_Race_Count;
+}
+
+void Route_Race_Update(void)
+{
+    if (Route_Race_Current_State != ROUTE_RACE_RUNNING)
+    {
+        return;
+    }
+
+    if (Route_Race_Strategies[Route_Race_Trial % Route_Race_Count].Step() != 0)
+    {
+        Route_Race_Current_State = ROUTE_RACE_FINISHED;
+    }
+}
+
+int Route_Race_Record(uint32_t time_ms)
+{
+    Route_Race_Stats *times;
+    int index;
+
+    if (Route_Race_Current_State != ROUTE_RACE_FINISHED)
+    {
+        return -1;
+    }
+
+    index = Route_Race_Trial % Route_Race_Count;
+    times = &Route_Race_Times[index];
+
+    if ((times->Trials == 0) || (time_ms < times->Min_ms))
+    {
+        times->Min_ms = time_ms;
+    }
+    if (time_ms > times->Max_ms)
+    {
+        times->Max_ms = time_ms;
+    }
+    times->Total_ms = times->Total_ms + time_ms;
+    times->Trials++;
+
+    Route_Race_Trial++;
+    Route_Race_Current_State = (Route_Race_Trial < Route_Race_Num_Trials) ? ROUTE_RACE_READY : ROUTE_RACE_DONE;
+
+    return index;
+}
+
+Route_Race_State Route_Race_Get_State(void)
+{
+    return Route_Race_Current_State;
+}
+
+int Route_Race_Get_Current(void)
+{
+    if ((Route_Race_Current_State == ROUTE_RACE_IDLE) || (Route_Race_Current_State == ROUTE_RACE_DONE))
+    {
+        return -1;
+    }
+
+    return Route_Race_Trial % Route_Race_Count;
+}
+
+uint32_t Route_Race_Get_Trial(void)
+{
+    return Route_Race_Trial;
+}
+
+uint32_t Route_Race_Get_Num_Trials(void)
+{
+    return Route_Race_Num_Trials;
+}
+
+uint8_t Route_Race_Get_Num_Strategies(void)
+{
+    return Route_Race_Count;
+}
+
+const char *Route_Race_Get_Name(int index)
+{
+    if ((index < 0) || (index >= Route_Race_Count))
+    {
+        return "?";
+    }
+
+    return Route_Race_Strategies[index].Name;
+}
+
+const Route_Race_Stats *Route_Race_Get_Stats(int index)
+{
+    if ((index < 0) || (index >= Route_Race_Count))
+    {
+        return 0;
+    }
+
+    return &Route_Race_Times[index];
+}
+
+uint32_t Route_Race_Get_Mean_ms(int index)
+{
+    if ((index < 0) || (index >= Route_Race_Count) || (Route_Race_Times[index].Trials == 0))
+    {
+        return 0;
+    }
+
+    return Route_Race_Times[index].Total_ms / Route_Race_Times[index].Trials;
+}
+
+int Route_Race_Get_Fastest(void)
+{
+    int fastest = -1;
+    int i;
+
+    for (i = 0; i < Route_Race_Count; i++)
+    {
+        if ((Route_Race_Times[i].Trials > 0) && ((fastest < 0) || (Route_Race_Get_Mean_ms(i) < Route_Race_Get_Mean_ms(fastest))))
+        {
+            fastest = i;
+        }
+    }
+
+    return fastest;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file SPSC_Queue.c
+ * @brief Source code for the SPSC_Queue module.
+ *
+ * This file contains the function definitions for the SPSC_Queue module.
+ *
+ */
+
+#include <string.h>
+#include "../inc/SPSC_Queue.h"
+
+int SPSC_Queue_Init(SPSC_Queue *queue, void *buffer, uint32_t element_size, uint32_t capacity)
+{
+    if ((capacity == 0) || ((capacity & (capacity - 1)) != 0))
+    {
+        return -1;
+    }
+
+    queue->Buffer = (uint8_t *)buffer;
+    queue->Element_Size = element_size;
+    queue->Mask = capacity - 1;
+    queue->Head = 0;
+    queue->Tail = 0;
+    queue->Dropped = 0;
+
+    return 0;
+}
+
+int SPSC_Queue_Push(SPSC_Queue *queue, const void *element)
+{
+    uint32_t head = queue->Head;
+
+    if ((head - queue->Tail) > queue->Mask)
+    {
+        queue->Dropped = queue->Dropped + 1;
+        return -1;
+    }
+
+    memcpy(&queue->Buffer[(head & queue->Mask) * queue->Element_Size], element, queue->Element_Size);
+
+    // Complete the copy before the consumer can see the element
+    __DMB();
+    queue->Head = head + 1;
+
+    return 0;
+}
+
+int SPSC_Queue_Pop(SPSC_Queue *queue, void *element)
+{
+    uint32_t tail = queue->Tail;
+
+    if (tail == queue->Head)
+    {
+        return 0;
+    }
+
+    // Read the element after the head that published it
+    __DMB();
+    memcpy(element, &queue->Buffer[(tail & queue->Mask) * queue->Element_Size], queue->Element_Size);
+
+    // Complete the copy before the producer can reuse the entry
+    __DMB();
+    queue->Tail = tail + 1;
+
+    return 1;
+}
+
+uint32_t SPSC_Queue_Pop_Latest(SPSC_Queue *queue, void *element)
+{
+    uint32_t tail = queue->Tail;
+    uint32_t head = queue->Head;
+
+    if (tail == head)
+    {
+        return 0;
+    }
+
+    __DMB();
+    memcpy(element, &queue->Buffer[((head - 1) & queue->Mask) * queue->Element_Size], queue->Element_Size);
+
+    __DMB();
+    queue->Tail = head;
+
+    return head - tail;
+}
+
+uint32_t SPSC_Queue_Count(const SPSC_Queue *queue)
+{
+    return queue->Head - queue->Tail;
+}
+
+uint32_t SPSC_Queue_Get_Dropped(const SPSC_Queue *queue)
+{
+    return queue->Dropped;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file Scheduler.c
+ * @brief Source code for the Scheduler driver.
+ *
+ * This file contains the function definitions for the Scheduler driver.
+ * It runs periodic tasks from a common tick and measures their response time with the DWT cycle counter.
+ *
+ */
+
+#include "../inc/Scheduler.h"
+#include "../inc/Trace.h"
+
+/**
+ * @brief Task control block.
+ */
+typedef struct
+{
+    void (*Task)(void);
+    Scheduler_Context Context;
+    uint16_t Period_Ticks;
+    uint16_t Countdown;
+    uint8_t Priority;
+    volatile uint8_t Ready;
+    uint32_t Deadline_Cycles;
+    uint32_t Release_Cycles;
+    Scheduler_Task_Stats Stats;
+} Scheduler_Task;
+
+static Scheduler_Task Scheduler_Tasks[SCHEDULER_MAX_TASKS];
+static uint8_t Scheduler_Num_Tasks = 0;
+
+// Task identifiers sorted by priority
+static uint8_t Scheduler_Order[SCHEDULER_MAX_TASKS];
+
+static uint32_t Scheduler_Tick_Cycles;
+static volatile uint32_t Scheduler_Ticks;
+static volatile uint32_t Scheduler_Idle_Cycles;
+
+static void Scheduler_Complete(Scheduler_Task *task)
+{
+    uint32_t response_cycles;
+
+    response_cycles = CycleCounter_Read() - task->Release_Cycles;
+
+    task->Stats.Run_Count = task->Stats.Run_Count + 1;
+    task->Stats.Last_Response_Cycles = response_cycles;
+    if (response_cycles > task->Stats.Max_Response_Cycles)
+    {
+        task->Stats.Max_Response_Cycles = response_cycles;
+    }
+    if (response_cycles > task->Deadline_Cycles)
+    {
+        task->Stats.Deadline_Miss_Count = task->Stats.Deadline_Miss_Count + 1;
+        Trace_Record(TRACE_EVENT_DEADLINE_MISS, (uint32_t)(task - Scheduler_Tasks), response_cycles);
+    }
+}
+
+void Scheduler_Init(uint32_t tick_cycles)
+{
+    Scheduler_Num_Tasks = 0;
+    Scheduler_Tick_Cycles = tick_cycles;
+    Scheduler_Ticks = 0;
+    Scheduler_Idle_Cycles = 0;
+}
+
+int Scheduler_Add_Task(void (*task)(void), Scheduler_Context context, uint16_t period_ticks, uint8_t priority, uint32_t deadline_cycles)
+{
+    Scheduler_Task *new_task;
+    uint8_t index;
+
+    if ((Scheduler_Num_Tasks >= SCHEDULER_MAX_TASKS) || ((period_ticks == SCHEDULER_EVENT_TASK) && (context != SCHEDULER_CONTEXT_BACKGROUND)))
+    {
+        return -1;
+    }
+
+    new_task = &Scheduler_Tasks[Scheduler_Num_Tasks];
+    new_task->Task = task;
+    new_task->Context = context;
+    new_task->Period_Ticks = period_ticks;
+    new_task->Countdown = 1;
+    new_task->Priority = priority;
+    new_task->Ready = 0;
+    if (deadline_cycles != SCHEDULER_NO_DEADLINE)
+    {
+        new_task->Deadline_Cycles = deadline_cycles;
+    }
+    else if (period_ticks == SCHEDULER_EVENT_TASK)
+    {
+        new_task->Deadline_Cycles = Scheduler_Tick_Cycles;
+    }
+    else
+    {
+        new_task->Deadline_Cycles = period_ticks * Scheduler_Tick_Cycles;
+    }
+    new_task->Stats.Run_Count = 0;
+    new_task->Stats.Overrun_Count = 0;
+    new_task->Stats.Deadline_Miss_Count = 0;
+    new_task->Stats.Last_Response_Cycles = 0;
+    new_task->Stats.Max_Response_Cycles = 0;
+
+    // Insert the task after the tasks with the same or a higher priority
+    index = Scheduler_Num_Tasks;
+    while ((index > 0) && (Scheduler_Tasks[Scheduler_Order[index - 1]].Priority > priority))
+    {
+        Scheduler_Order[index] = Scheduler_Order[index - 1];
+        index = index - 1;
+    }
+    Scheduler_Order[index] = Scheduler_Num_Tasks;
+
+    Scheduler_Num_Tasks = Scheduler_Num_Tasks + 1;
+
+    return Scheduler_Num_Tasks - 1;
+}
+
+void Scheduler_Set_Tick_Cycles(uint32_t tick_cycles)
+{
+    uint8_t index;
+    long sr;
+
+    sr = StartCritical();
+    for (index = 0; index < Scheduler_Num_Tasks; index++)
+    {
+        Scheduler_Tasks[index].Deadline_Cycles = (uint32_t)(((uint64_t)Scheduler_Tasks[index].Deadline_Cycles * tick_cycles) / Scheduler_Tick_Cycles);
+    }
+    Scheduler_Tick_Cycles = tick_cycles;
+    EndCritical(sr);
+}
+
+int Scheduler_Set_Period(int id, uint16_t period_ticks)
+{
+    Scheduler_Task *task;
+    long sr;
+
+    if ((id < 0) || (id >= Scheduler_Num_Tasks) || (period_ticks == SCHEDULER_EVENT_TASK) ||
+        (Scheduler_Tasks[id].Period_Ticks == SCHEDULER_EVENT_TASK))
+    {
+        return -1;
+    }
+
+    task = &Scheduler_Tasks[id];
+
+    sr = StartCritical();
+    task->Period_Ticks = period_ticks;
+
+    // A shorter period takes effect at once, a longer one after the next release
+    if (task->Countdown > period_ticks)
+    {
+        task->Countdown = period_ticks;
+    }
+    EndCritical(sr);
+
+    return 0;
+}
+
+void Scheduler_Tick(void)
+{
+    Scheduler_Task *task;
+    uint32_t tick_cycles;
+    uint8_t index;
+
+    tick_cycles = CycleCounter_Read();
+    Scheduler_Ticks = Scheduler_Ticks + 1;
+
+    // Release the tasks whose period has elapsed
+    for (index = 0; index < Scheduler_Num_Tasks; index++)
+    {
+        task = &Scheduler_Tasks[index];
+
+        // Event tasks are only released by Scheduler_Post
+        if (task->Period_Ticks == SCHEDULER_EVENT_TASK)
+        {
+            continue;
+        }
+
+        task->Countdown = task->Countdown - 1;
+        if (task->Countdown != 0)
+        {
+            continue;
+        }
+        task->Countdown = task->Period_Ticks;
+
+        if (task->Ready)
+        {
+            // The previous release has not been executed yet
+            task->Stats.Overrun_Count = task->Stats.Overrun_Count + 1;
+            continue;
+        }
+
+        task->Release_Cycles = tick_cycles;
+        task->Ready = 1;
+    }
+
+    // Execute the released tick tasks in priority order
+    for (index = 0; index < Scheduler_Num_Tasks; index++)
+    {
+        task = &Scheduler_Tasks[Scheduler_Order[index]];
+
+        if ((task->Context == SCHEDULER_CONTEXT_TICK) && task->Ready)
+        {
+            (*task->Task)();
+            task->Ready = 0;
+            Scheduler_Complete(task);
+        }
+    }
+}
+
+int Scheduler_Post(int id)
+{
+    Scheduler_Task *task;
+    long sr;
+
+    if ((id < 0) || (id >= Scheduler_Num_Tasks) || (Scheduler_Tasks[id].Context != SCHEDULER_CONTEXT_BACKGROUND))
+    {
+        return -1;
+    }
+
+    task = &Scheduler_Tasks[id];
+
+    // The post can preempt Scheduler_Run_Next, and another interrupt can post the same task
+    sr = StartCritical();
+    if (task->Ready)
+    {
+        task->Stats.Overrun_Count = task->Stats.Overrun_Count + 1;
+    }
+    else
+    {
+        task->Release_Cycles = CycleCounter_Read();
+        task->Ready = 1;
+    }
+    EndCritical(sr);
+
+    return 0;
+}
+
+// Returns the ready background task with the highest priority, or 0 if none is ready
+static Scheduler_Task *Scheduler_Next_Background_Task(void)
+{
+    Scheduler_Task *task;
+    uint8_t index;
+
+    for (index = 0; index < Scheduler_Num_Tasks; index++)
+    {
+        task = &Scheduler_Tasks[Scheduler_Order[index]];
+
+        if ((task->Context == SCHEDULER_CONTEXT_BACKGROUND) && task->Ready)
+        {
+            return task;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t Scheduler_Run_Next(void)
+{
+    Scheduler_Task *task;
+
+    task = Scheduler_Next_Background_Task();
+    if (task == 0)
+    {
+        return 0;
+    }
+
+    // A release during the execution is counted as an overrun, since Ready is still set
+    (*task->Task)();
+    Scheduler_Complete(task);
+    task->Ready = 0;
+
+    return 1;
+}
+
+void Scheduler_Run(void)
+{
+    uint32_t sleep_cycles;
+
+    while (1)
+    {
+        if (Scheduler_Run_Next())
+        {
+            continue;
+        }
+
+        // Sleep with the interrupts disabled so that a release cannot occur between the check and the WFI
+        // Note: A pending interrupt still wakes up the CPU, and it is executed when the interrupts are enabled
+        DisableInterrupts();
+        if (Scheduler_Next_Background_Task() == 0)
+        {
+            sleep_cycles = CycleCounter_Read();
+            WaitForInterrupt();
+            Scheduler_Idle_Cycles = Scheduler_Idle_Cycles + (CycleCounter_Read() - sleep_cycles);
+        }
+        EnableInterrupts();
+    }
+}
+
+uint32_t Scheduler_Get_Ticks(void)
+{
+    return Scheduler_Ticks;
+}
+
+uint32_t Scheduler_Get_Idle_Cycles(void)
+{
+    return Scheduler_Idle_Cycles;
+}
+
+int Scheduler_Get_Stats(int id, Scheduler_Task_Stats *stats)
+{
+    long sr;
+
+    if ((id < 0) || (id >= Scheduler_Num_Tasks))
+    {
+        return -1;
+    }
+
+    sr = StartCritical();
+    *stats = Scheduler_Tasks[id].Stats;
+    EndCritical(sr);
+
+    return 0;
+}
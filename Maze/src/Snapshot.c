@@ -0,0 +1,61 @@
+/**
+ * @file Snapshot.c
+ * @brief Source code for the Snapshot module.
+ *
+ * This file contains the function definitions for the Snapshot module.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Snapshot.h"
+
+void Snapshot_Init(Snapshot *snapshot, void *buffer, uint32_t size, const void *initial)
+{
+    snapshot->Buffer = (uint8_t *)buffer;
+    snapshot->Size = size;
+    snapshot->Timestamp[0] = 0;
+    snapshot->Timestamp[1] = 0;
+    memcpy(snapshot->Buffer, initial, size);
+    snapshot->Sequence = 0;
+}
+
+void Snapshot_Write(Snapshot *snapshot, const void *data, uint32_t timestamp)
+{
+    uint32_t sequence = snapshot->Sequence + 1;
+    uint32_t index = sequence & 0x1;
+
+    // Fill the buffer that is not read by the current sequence
+    memcpy(&snapshot->Buffer[index * snapshot->Size], data, snapshot->Size);
+    snapshot->Timestamp[index] = timestamp;
+
+    // Complete the copy before the readers can select this buffer
+    __DMB();
+    snapshot->Sequence = sequence;
+}
+
+uint32_t Snapshot_Read(const Snapshot *snapshot, void *data, uint32_t *timestamp)
+{
+    uint32_t sequence;
+    uint32_t index;
+    uint32_t time;
+
+    do
+    {
+        sequence = snapshot->Sequence;
+        index = sequence & 0x1;
+
+        __DMB();
+        memcpy(data, &snapshot->Buffer[index * snapshot->Size], snapshot->Size);
+        time = snapshot->Timestamp[index];
+        __DMB();
+
+        // The next write fills the other buffer, only the write after it reuses this one
+    } while ((snapshot->Sequence - sequence) > 1);
+
+    if (timestamp != 0)
+    {
+        *timestamp = time;
+    }
+
+    return sequence;
+}
@@ -0,0 +1,317 @@
+/**
+ * @file Speed_Controller.c
+ * @brief Source code for the Speed_Controller driver.
+ *
+ * This file contains the function definitions for the Speed_Controller driver.
+ * It runs one proportional-integral (PI) velocity controller per wheel using the tachometer
+ * measurements captured by Timer A3, and updates the Timer A0 PWM duty cycles through Motor_Drive.
+ *
+ */
+
+#include "../inc/Speed_Controller.h"
+#include "../inc/Traction.h"
+
+/**
+ * @brief State of the velocity controller of one wheel.
+ */
+typedef struct
+{
+    int16_t Target;
+    int16_t Setpoint;
+    int16_t Speed;
+    int32_t Integral;
+    int32_t Last_Steps;
+    int32_t Step_History[SPEED_CONTROLLER_WINDOW_LENGTH];
+} Speed_Controller_Wheel;
+
+static Speed_Controller_Wheel Left_Wheel;
+static Speed_Controller_Wheel Right_Wheel;
+
+// Index of the oldest entry of the step histories
+static uint8_t Speed_Controller_History_Index;
+
+// Set to 1 while the controller drives the motors
+static uint8_t Speed_Controller_Enabled;
+
+// Limits of the change of the setpoints in mm/s^2, and the corresponding change per update in mm/s (0 for no limit)
+static uint16_t Speed_Controller_Acceleration;
+static uint16_t Speed_Controller_Deceleration;
+static uint16_t Speed_Controller_Acceleration_Step;
+static uint16_t Speed_Controller_Deceleration_Step;
+
+// Average of the wheel setpoints, ramped towards the average of the targets
+static int16_t Speed_Controller_Common_Setpoint;
+
+static int16_t Speed_Controller_Estimate(Speed_Controller_Wheel *wheel, int32_t steps, int16_t average_speed)
+{
+    int32_t delta_steps = steps - wheel->Last_Steps;
+    int32_t window_steps = steps - wheel->Step_History[Speed_Controller_History_Index];
+    int32_t speed;
+
+    wheel->Last_Steps = steps;
+    wheel->Step_History[Speed_Controller_History_Index] = steps;
+
+    if (((delta_steps >= SPEED_CONTROLLER_MIN_PERIOD_STEPS) || (delta_steps <= -SPEED_CONTROLLER_MIN_PERIOD_STEPS)) && (average_speed != 0))
+    {
+        // Speed (mm/s) averaged by the capture interrupts over the last TACHOMETER_AVERAGE_LENGTH periods
+        speed = average_speed;
+    }
+    else
+    {
+        // Speed (mm/s) = (steps during the window) * (um per step) * (update rate) / (1000 * window length)
+        speed = (window_steps * SPEED_CONTROLLER_UM_PER_STEP * SPEED_CONTROLLER_RATE_HZ) / (1000 * SPEED_CONTROLLER_WINDOW_LENGTH);
+    }
+
+    wheel->Speed = speed;
+
+    return speed;
+}
+
+// Moves the common speed of the wheels towards the average of the targets within the acceleration and deceleration limits
+// Note: The difference between the wheels is applied at once, so an arc keeps the curvature planned by the caller
+static void Speed_Controller_Ramp(void)
+{
+    int32_t setpoint = Speed_Controller_Common_Setpoint;
+    int32_t target = (Left_Wheel.Target + Right_Wheel.Target) / 2;
+    int32_t difference = Right_Wheel.Target - target;
+    int32_t step;
+
+    // The robot speeds up if the target is further from 0 mm/s in the direction of the setpoint
+    if (((setpoint >= 0) && (target > setpoint)) || ((setpoint <= 0) && (target < setpoint)))
+    {
+        step = Speed_Controller_Acceleration_Step;
+    }
+    else
+    {
+        step = Speed_Controller_Deceleration_Step;
+    }
+
+    if ((step == 0) || ((target > setpoint) && ((target - setpoint) <= step)) || ((target < setpoint) && ((setpoint - target) <= step)))
+    {
+        setpoint = target;
+    }
+    else if (target > setpoint)
+    {
+        setpoint = setpoint + step;
+    }
+    else
+    {
+        setpoint = setpoint - step;
+    }
+
+    Speed_Controller_Common_Setpoint = setpoint;
+
+    // Apply the targets exactly once the common speed has reached them
+    if (setpoint == target)
+    {
+        Left_Wheel.Setpoint = Left_Wheel.Target;
+        Right_Wheel.Setpoint = Right_Wheel.Target;
+    }
+    else
+    {
+        Left_Wheel.Setpoint = setpoint - difference;
+        Right_Wheel.Setpoint = setpoint + difference;
+    }
+}
+
+static int16_t Speed_Controller_Output(Speed_Controller_Wheel *wheel)
+{
+    int32_t error;
+    int32_t output;
+    const int32_t limit = (int32_t)SPEED_CONTROLLER_MAX_DUTY_CYCLE * 256;
+
+    if (wheel->Setpoint == 0)
+    {
+        wheel->Integral = 0;
+        return 0;
+    }
+
+    error = wheel->Setpoint - wheel->Speed;
+
+    // Anti-windup: limit the integral term to the range of the output, and hold it while the Traction module
+    // scales the output down, so the controller does not wind up against a slipping wheel
+    if (Traction_Is_Limiting() == 0)
+    {
+        wheel->Integral = wheel->Integral + (SPEED_CONTROLLER_KI * error);
+        if (wheel->Integral > limit)
+        {
+            wheel->Integral = limit;
+        }
+        else if (wheel->Integral < -limit)
+        {
+            wheel->Integral = -limit;
+        }
+    }
+
+    output = ((SPEED_CONTROLLER_KFF * wheel->Setpoint) + (SPEED_CONTROLLER_KP * error) + wheel->Integral) / 256;
+
+    if (output > SPEED_CONTROLLER_MAX_DUTY_CYCLE)
+    {
+        output = SPEED_CONTROLLER_MAX_DUTY_CYCLE;
+    }
+    else if (output < -SPEED_CONTROLLER_MAX_DUTY_CYCLE)
+    {
+        output = -SPEED_CONTROLLER_MAX_DUTY_CYCLE;
+    }
+
+    // Do not reverse a wheel to slow it down, only reduce its duty cycle
+    if ((wheel->Setpoint > 0) && (output < 0))
+    {
+        output = 0;
+    }
+    else if ((wheel->Setpoint < 0) && (output > 0))
+    {
+        output = 0;
+    }
+
+    // Reduce the duty cycle while a wheel slips
+    if (output >= 0)
+    {
+        output = Traction_Limit_Duty_Cycle(output);
+    }
+    else
+    {
+        output = -(int32_t)Traction_Limit_Duty_Cycle(-output);
+    }
+
+    return output;
+}
+
+void Speed_Controller_Init()
+{
+    uint16_t left_tach;
+    uint16_t right_tach;
+    enum Tachometer_Direction left_dir;
+    enum Tachometer_Direction right_dir;
+    int32_t left_steps;
+    int32_t right_steps;
+    int i;
+
+    Tachometer_Get(&left_tach, &left_dir, &left_steps, &right_tach, &right_dir, &right_steps);
+
+    Speed_Controller_Enabled = 0;
+    Speed_Controller_History_Index = 0;
+    Speed_Controller_Set_Limits(SPEED_CONTROLLER_MAX_ACCELERATION, SPEED_CONTROLLER_MAX_DECELERATION);
+    Speed_Controller_Common_Setpoint = 0;
+
+    Left_Wheel.Target = 0;
+    Left_Wheel.Setpoint = 0;
+    Left_Wheel.Speed = 0;
+    Left_Wheel.Integral = 0;
+    Left_Wheel.Last_Steps = left_steps;
+
+    Right_Wheel.Target = 0;
+    Right_Wheel.Setpoint = 0;
+    Right_Wheel.Speed = 0;
+    Right_Wheel.Integral = 0;
+    Right_Wheel.Last_Steps = right_steps;
+
+    for (i = 0; i < SPEED_CONTROLLER_WINDOW_LENGTH; i++)
+    {
+        Left_Wheel.Step_History[i] = left_steps;
+        Right_Wheel.Step_History[i] = right_steps;
+    }
+}
+
+void Speed_Controller_Set_Speed(int16_t left_speed, int16_t right_speed)
+{
+    long sr;
+
+    sr = StartCritical();
+    if (Speed_Controller_Enabled == 0)
+    {
+        // Ramp from the speed reached with the open-loop motor commands
+        Speed_Controller_Common_Setpoint = (Left_Wheel.Speed + Right_Wheel.Speed) / 2;
+    }
+    Left_Wheel.Target = left_speed;
+    Right_Wheel.Target = right_speed;
+    Speed_Controller_Enabled = 1;
+    EndCritical(sr);
+}
+
+void Speed_Controller_Set_Limits(uint16_t acceleration, uint16_t deceleration)
+{
+    long sr;
+
+    sr = StartCritical();
+    Speed_Controller_Acceleration = acceleration;
+    Speed_Controller_Deceleration = deceleration;
+
+    // Round up, so that a low limit still changes the setpoint at every update
+    Speed_Controller_Acceleration_Step = (acceleration + SPEED_CONTROLLER_RATE_HZ - 1) / SPEED_CONTROLLER_RATE_HZ;
+    Speed_Controller_Deceleration_Step = (deceleration + SPEED_CONTROLLER_RATE_HZ - 1) / SPEED_CONTROLLER_RATE_HZ;
+    EndCritical(sr);
+}
+
+void Speed_Controller_Get_Limits(uint16_t *acceleration, uint16_t *deceleration)
+{
+    *acceleration = Speed_Controller_Acceleration;
+    *deceleration = Speed_Controller_Deceleration;
+}
+
+void Speed_Controller_Disable()
+{
+    long sr;
+
+    sr = StartCritical();
+    Speed_Controller_Enabled = 0;
+    Speed_Controller_Common_Setpoint = 0;
+    Left_Wheel.Target = 0;
+    Left_Wheel.Setpoint = 0;
+    Left_Wheel.Integral = 0;
+    Right_Wheel.Target = 0;
+    Right_Wheel.Setpoint = 0;
+    Right_Wheel.Integral = 0;
+    EndCritical(sr);
+}
+
+uint8_t Speed_Controller_Is_Enabled()
+{
+    return Speed_Controller_Enabled;
+}
+
+void Speed_Controller_Update()
+{
+    uint16_t left_tach;
+    uint16_t right_tach;
+    enum Tachometer_Direction left_dir;
+    enum Tachometer_Direction right_dir;
+    int32_t left_steps;
+    int32_t right_steps;
+
+    int16_t left_speed;
+    int16_t right_speed;
+
+    Tachometer_Get(&left_tach, &left_dir, &left_steps, &right_tach, &right_dir, &right_steps);
+    Tachometer_Get_Speed(&left_speed, &right_speed);
+
+    Speed_Controller_Estimate(&Left_Wheel, left_steps, left_speed);
+    Speed_Controller_Estimate(&Right_Wheel, right_steps, right_speed);
+    Speed_Controller_History_Index = (Speed_Controller_History_Index + 1) & (SPEED_CONTROLLER_WINDOW_LENGTH - 1);
+
+    if (Speed_Controller_Enabled)
+    {
+        Speed_Controller_Ramp();
+
+        if ((Left_Wheel.Setpoint == 0) && (Right_Wheel.Setpoint == 0))
+        {
+            Motor_Stop();
+        }
+        else
+        {
+            Motor_Drive(Speed_Controller_Output(&Left_Wheel), Speed_Controller_Output(&Right_Wheel));
+        }
+    }
+}
+
+void Speed_Controller_Get_Speed(int16_t *left_speed, int16_t *right_speed)
+{
+    *left_speed = Left_Wheel.Speed;
+    *right_speed = Right_Wheel.Speed;
+}
+
+void Speed_Controller_Get_Setpoint(int16_t *left_speed, int16_t *right_speed)
+{
+    *left_speed = Left_Wheel.Setpoint;
+    *right_speed = Right_Wheel.Setpoint;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file Stopwatch.c
+ * @brief Source code for the Stopwatch module.
+ *
+ * This file contains the function definitions for the Stopwatch module.
+ * It measures the routes with the timebase of Timer A3.
+ *
+ */
+
+#include "../inc/Stopwatch.h"
+
+void Stopwatch_Start(Stopwatch *stopwatch)
+{
+    stopwatch->Start_us = Timer_A3_Get_Time_us();
+    stopwatch->Lap_us = stopwatch->Start_us;
+    stopwatch->Elapsed_us = 0;
+    stopwatch->Running = 1;
+}
+
+uint32_t Stopwatch_Lap(Stopwatch *stopwatch)
+{
+    uint32_t now;
+    uint32_t lap_us;
+
+    if (stopwatch->Running == 0)
+    {
+        return 0;
+    }
+
+    now = Timer_A3_Get_Time_us();
+    lap_us = now - stopwatch->Lap_us;
+    stopwatch->Lap_us = now;
+
+    return lap_us / 1000;
+}
+
+uint32_t Stopwatch_Stop(Stopwatch *stopwatch)
+{
+    if (stopwatch->Running != 0)
+    {
+        stopwatch->Elapsed_us = Timer_A3_Get_Time_us() - stopwatch->Start_us;
+        stopwatch->Running = 0;
+    }
+
+    return stopwatch->Elapsed_us / 1000;
+}
+
+uint32_t Stopwatch_Read_ms(const Stopwatch *stopwatch)
+{
+    if (stopwatch->Running != 0)
+    {
+        return (Timer_A3_Get_Time_us() - stopwatch->Start_us) / 1000;
+    }
+
+    return stopwatch->Elapsed_us / 1000;
+}
+
+uint8_t Stopwatch_Is_Running(const Stopwatch *stopwatch)
+{
+    return stopwatch->Running;
+}
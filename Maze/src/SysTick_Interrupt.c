@@ -27,7 +27,7 @@ void SysTick_Interrupt_Init(uint32_t clock_cycles, uint32_t priority)
     // SCB (System Control Block) that control interrupt priorities.
     // Set the priority into the upper 3 bits of the 8-bit field for SysTick interrupt
     // System Handler 15 (tied to SysTick_Handler) can be accessed at index 11 of the SHP array
-    SCB->SHP[11] = priority << 5;
+    SCB->SHP[11] = INTERRUPT_PRIORITY_FIELD(priority);
 
     // Enable SysTick with interrupts and the core clock
     SysTick->CTRL = 0x00000007;
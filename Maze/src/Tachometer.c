@@ -41,8 +41,112 @@ static int Tachometer_Left_Steps = 0;
 enum Tachometer_Direction Tachometer_Right_Dir = STOPPED;
 enum Tachometer_Direction Tachometer_Left_Dir = STOPPED;
 
+// Time without an edge after which a wheel is considered stopped in CPU cycles at the current MCLK frequency
+#define TACHOMETER_STALL_TIMEOUT_CYCLES (TACHOMETER_STALL_TIMEOUT_MS * (Clock_GetFreq() / 1000))
+
+// Time after which the 16-bit capture period wraps (5.46 ms) in CPU cycles at the current MCLK frequency
+#define TACHOMETER_WRAP_CYCLES          ((0x10000UL * (Clock_GetFreq() / 1000)) / (TACHOMETER_CLOCK_HZ / 1000))
+
+// Speed in mm/s and rotation speed in 0.01 RPM of a wheel for a period of 1 timer tick
+#define TACHOMETER_SPEED_SCALE          (TACHOMETER_UM_PER_STEP * (TACHOMETER_CLOCK_HZ / 1000UL))
+#define TACHOMETER_CENTI_RPM_SCALE      ((100UL * 60UL * TACHOMETER_CLOCK_HZ) / TACHOMETER_STEPS_PER_REVOLUTION)
+
+// Measurements of a wheel published by its capture interrupt
+typedef struct
+{
+    uint16_t Period;
+    enum Tachometer_Direction Direction;
+    int32_t Steps;
+    uint32_t Period_Sum;
+    uint8_t Period_Count;
+} Tachometer_Wheel_State;
+
+// Last periods of a wheel in timer ticks, updated by its capture interrupt only
+typedef struct
+{
+    uint32_t Periods[TACHOMETER_AVERAGE_LENGTH];
+    uint32_t Sum;
+    uint8_t Index;
+    uint8_t Count;
+    uint8_t Valid;
+    enum Tachometer_Direction Direction;
+    uint32_t Last_Edge_Cycles;
+} Tachometer_Average;
+
+static Tachometer_Average Tachometer_Right_Average;
+static Tachometer_Average Tachometer_Left_Average;
+
+// Latest measurements of each wheel, with the cycle count of the edge
+// Note: The two wheels are captured by different interrupts, so each one has its own snapshot
+static Snapshot Tachometer_Right_Snapshot;
+static Snapshot Tachometer_Left_Snapshot;
+static uint8_t Tachometer_Right_Buffer[SNAPSHOT_BUFFER_SIZE(sizeof(Tachometer_Wheel_State))];
+static uint8_t Tachometer_Left_Buffer[SNAPSHOT_BUFFER_SIZE(sizeof(Tachometer_Wheel_State))];
+
+// Adds the period of an edge to the running sum, or clears the ring after a stall or a change of direction
+// Note: The period of the first edge after a stall or a reversal does not measure a step, so it is discarded
+static void Tachometer_Average_Update(Tachometer_Average *average, uint16_t period, enum Tachometer_Direction direction, uint32_t edge_cycles)
+{
+    uint32_t elapsed_cycles = edge_cycles - average->Last_Edge_Cycles;
+    uint32_t ticks = period;
+
+    if ((average->Valid == 0) || (elapsed_cycles >= TACHOMETER_STALL_TIMEOUT_CYCLES) || (direction != average->Direction))
+    {
+        average->Sum = 0;
+        average->Index = 0;
+        average->Count = 0;
+    }
+    else
+    {
+        // The capture period has wrapped, so the period is measured with the cycle counter instead
+        if (elapsed_cycles >= TACHOMETER_WRAP_CYCLES)
+        {
+            ticks = (uint32_t)(((uint64_t)elapsed_cycles * TACHOMETER_CLOCK_HZ) / Clock_GetFreq());
+        }
+
+        if (average->Count < TACHOMETER_AVERAGE_LENGTH)
+        {
+            average->Count = average->Count + 1;
+        }
+        else
+        {
+            average->Sum = average->Sum - average->Periods[average->Index];
+        }
+
+        average->Periods[average->Index] = ticks;
+        average->Sum = average->Sum + ticks;
+        average->Index = (average->Index + 1) & (TACHOMETER_AVERAGE_LENGTH - 1);
+    }
+
+    average->Valid = 1;
+    average->Direction = direction;
+    average->Last_Edge_Cycles = edge_cycles;
+}
+
+// Returns scale * count / sum of the averaged periods of a wheel in units of scale per tick, signed by its direction
+static int32_t Tachometer_Average_Rate(Snapshot *snapshot, uint32_t scale)
+{
+    Tachometer_Wheel_State state;
+    uint32_t timestamp_cycles;
+    int32_t rate;
+
+    Snapshot_Read(snapshot, &state, &timestamp_cycles);
+
+    if ((state.Period_Count == 0) || (state.Period_Sum == 0) || ((CycleCounter_Read() - timestamp_cycles) >= TACHOMETER_STALL_TIMEOUT_CYCLES))
+    {
+        return 0;
+    }
+
+    rate = (int32_t)((scale * state.Period_Count) / state.Period_Sum);
+
+    return (state.Direction == REVERSE) ? -rate : rate;
+}
+
 void Tachometer_Right_Int(uint16_t current_time)
 {
+    Tachometer_Wheel_State state;
+    uint32_t edge_cycles = CycleCounter_Read();
+
     // Store the time of the previous rising edge for the right wheel
     Tachometer_Previous_Right_Time = Tachometer_Current_Right_Time;
 
@@ -63,10 +167,22 @@ void Tachometer_Right_Int(uint16_t current_time)
         Tachometer_Right_Steps = Tachometer_Right_Steps + 1;
         Tachometer_Right_Dir = FORWARD;
     }
+
+    state.Period = (Tachometer_Current_Right_Time - Tachometer_Previous_Right_Time);
+    state.Direction = Tachometer_Right_Dir;
+    state.Steps = Tachometer_Right_Steps;
+
+    Tachometer_Average_Update(&Tachometer_Right_Average, state.Period, state.Direction, edge_cycles);
+    state.Period_Sum = Tachometer_Right_Average.Sum;
+    state.Period_Count = Tachometer_Right_Average.Count;
+    Snapshot_Write(&Tachometer_Right_Snapshot, &state, edge_cycles);
 }
 
 void Tachometer_Left_Int(uint16_t current_time)
 {
+    Tachometer_Wheel_State state;
+    uint32_t edge_cycles = CycleCounter_Read();
+
     // Store the time of the previous rising edge for the left wheel
     Tachometer_Previous_Left_Time = Tachometer_Current_Left_Time;
 
@@ -87,10 +203,31 @@ void Tachometer_Left_Int(uint16_t current_time)
         Tachometer_Left_Steps = Tachometer_Left_Steps + 1;
         Tachometer_Left_Dir = FORWARD;
     }
+
+    state.Period = (Tachometer_Current_Left_Time - Tachometer_Previous_Left_Time);
+    state.Direction = Tachometer_Left_Dir;
+    state.Steps = Tachometer_Left_Steps;
+
+    Tachometer_Average_Update(&Tachometer_Left_Average, state.Period, state.Direction, edge_cycles);
+    state.Period_Sum = Tachometer_Left_Average.Sum;
+    state.Period_Count = Tachometer_Left_Average.Count;
+    Snapshot_Write(&Tachometer_Left_Snapshot, &state, edge_cycles);
 }
 
+#if TACHOMETER_STATIC_HANDLERS
+TIMER_A3_CAPTURE_STATIC_HANDLERS(Tachometer_Right_Int, Tachometer_Left_Int)
+#endif
+
 void Tachometer_Init()
 {
+    Tachometer_Wheel_State initial = { 0, STOPPED, 0, 0, 0 };
+
+    Tachometer_Right_Average.Valid = 0;
+    Tachometer_Left_Average.Valid = 0;
+
+    Snapshot_Init(&Tachometer_Right_Snapshot, Tachometer_Right_Buffer, sizeof(Tachometer_Wheel_State), &initial);
+    Snapshot_Init(&Tachometer_Left_Snapshot, Tachometer_Left_Buffer, sizeof(Tachometer_Wheel_State), &initial);
+
     // Configure the following pins as input GPIO pins: P5.0 (Right Encoder B) and P5.2 (Left Encoder B)
     // by clearing Bits 0 and 2 of the SEL0 and SEL1 registers for P5
     // and setting Bits 0 and 2 of the DIR register for P5
@@ -109,12 +246,39 @@ void Tachometer_Get(uint16_t *left_tach,
                     enum Tachometer_Direction *right_dir,
                     int32_t *right_steps)
 {
-    *left_tach = (Tachometer_Current_Left_Time - Tachometer_Previous_Left_Time);
-    *left_dir = Tachometer_Left_Dir;
-    *left_steps = Tachometer_Left_Steps;
-    *right_tach = (Tachometer_Current_Right_Time - Tachometer_Previous_Right_Time);
-    *right_dir = Tachometer_Right_Dir;
-    *right_steps = Tachometer_Right_Steps;
+    Tachometer_Wheel_State left;
+    Tachometer_Wheel_State right;
+
+    // The period, the direction, and the steps of each wheel are from the same edge
+    Snapshot_Read(&Tachometer_Left_Snapshot, &left, 0);
+    Snapshot_Read(&Tachometer_Right_Snapshot, &right, 0);
+
+    *left_tach = left.Period;
+    *left_dir = left.Direction;
+    *left_steps = left.Steps;
+    *right_tach = right.Period;
+    *right_dir = right.Direction;
+    *right_steps = right.Steps;
+}
+
+void Tachometer_Get_Timestamps(uint32_t *left_timestamp_cycles, uint32_t *right_timestamp_cycles)
+{
+    Tachometer_Wheel_State state;
+
+    Snapshot_Read(&Tachometer_Left_Snapshot, &state, left_timestamp_cycles);
+    Snapshot_Read(&Tachometer_Right_Snapshot, &state, right_timestamp_cycles);
+}
+
+void Tachometer_Get_Speed(int16_t *left_speed, int16_t *right_speed)
+{
+    *left_speed = (int16_t)Tachometer_Average_Rate(&Tachometer_Left_Snapshot, TACHOMETER_SPEED_SCALE);
+    *right_speed = (int16_t)Tachometer_Average_Rate(&Tachometer_Right_Snapshot, TACHOMETER_SPEED_SCALE);
+}
+
+void Tachometer_Get_RPM(int32_t *left_centi_rpm, int32_t *right_centi_rpm)
+{
+    *left_centi_rpm = Tachometer_Average_Rate(&Tachometer_Left_Snapshot, TACHOMETER_CENTI_RPM_SCALE);
+    *right_centi_rpm = Tachometer_Average_Rate(&Tachometer_Right_Snapshot, TACHOMETER_CENTI_RPM_SCALE);
 }
 
 uint16_t Average_of_Buffer(uint16_t *buffer, int buffer_length)
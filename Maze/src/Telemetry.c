@@ -0,0 +1,270 @@
+/**
+ * @file Telemetry.c
+ * @brief Source code for the Telemetry driver.
+ *
+ * This file contains the function definitions for the Telemetry driver.
+ * It sends binary, framed, and checksummed packets over EUSCI_A0 using the TX ring buffer
+ * of the EUSCI_A0_UART driver.
+ *
+ */
+
+#include "../inc/Telemetry.h"
+
+// Frame and encoded frame buffers
+// Note: These are shared by every caller, so a packet is built and queued inside a critical section
+static uint8_t Telemetry_Frame[TELEMETRY_MAX_FRAME_LENGTH];
+static uint8_t Telemetry_Encoded_Frame[TELEMETRY_MAX_ENCODED_LENGTH];
+
+// Sequence number of the next packet
+static uint8_t Telemetry_Sequence_Number;
+
+// Number of frames dropped because the TX ring buffer was full
+static uint32_t Telemetry_Dropped_Frames;
+
+static uint8_t *Telemetry_Put_U16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)(value);
+    buffer[1] = (uint8_t)(value >> 8);
+    return buffer + 2;
+}
+
+static uint8_t *Telemetry_Put_U32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)(value);
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+    return buffer + 4;
+}
+
+uint32_t Telemetry_COBS_Encode(const uint8_t *input, uint32_t length, uint8_t *output)
+{
+    uint32_t read_index = 0;
+    uint32_t write_index = 1;
+    uint32_t code_index = 0;
+    uint8_t code = 1;
+
+    while (read_index < length)
+    {
+        if (input[read_index] == 0)
+        {
+            // End the current block at the zero byte
+            output[code_index] = code;
+            code = 1;
+            code_index = write_index;
+            write_index++;
+        }
+        else
+        {
+            output[write_index] = input[read_index];
+            write_index++;
+            code++;
+
+            // A block holds at most 254 non-zero bytes
+            if (code == 0xFF)
+            {
+                output[code_index] = code;
+                code = 1;
+                code_index = write_index;
+                write_index++;
+            }
+        }
+
+        read_index++;
+    }
+
+    output[code_index] = code;
+
+    return write_index;
+}
+
+int32_t Telemetry_COBS_Decode(const uint8_t *input, uint32_t length, uint8_t *output, uint32_t maximum)
+{
+    uint32_t read_index = 0;
+    uint32_t write_index = 0;
+    uint32_t block_end;
+    uint8_t code;
+
+    while (read_index < length)
+    {
+        code = input[read_index];
+        block_end = read_index + code;
+        read_index++;
+
+        if ((code == 0) || (block_end > length))
+        {
+            return -1;
+        }
+
+        while (read_index < block_end)
+        {
+            if ((input[read_index] == 0) || (write_index >= maximum))
+            {
+                return -1;
+            }
+            output[write_index] = input[read_index];
+            write_index++;
+            read_index++;
+        }
+
+        // A block shorter than 254 bytes ends with a zero byte, except the last block
+        if ((code != 0xFF) && (read_index < length))
+        {
+            if (write_index >= maximum)
+            {
+                return -1;
+            }
+            output[write_index] = 0;
+            write_index++;
+        }
+    }
+
+    return (int32_t)write_index;
+}
+
+uint16_t Telemetry_CRC16(const uint8_t *data, uint32_t length)
+{
+    uint16_t crc = 0xFFFF;
+    uint32_t bit;
+
+    while (length)
+    {
+        crc = crc ^ ((uint16_t)(*data) << 8);
+
+        for (bit = 0; bit < 8; bit++)
+        {
+            if (crc & 0x8000)
+            {
+                crc = (crc << 1) ^ 0x1021;
+            }
+            else
+            {
+                crc = (crc << 1);
+            }
+        }
+
+        data++;
+        length--;
+    }
+
+    return crc;
+}
+
+int Telemetry_Send_Packet(uint8_t type, const uint8_t *payload, uint8_t length)
+{
+    uint32_t index;
+    uint32_t encoded_length;
+    uint16_t crc;
+    long sr;
+
+    if (length > TELEMETRY_MAX_PAYLOAD_LENGTH)
+    {
+        return -1;
+    }
+
+    sr = StartCritical();
+
+    Telemetry_Frame[0] = type;
+    Telemetry_Frame[1] = Telemetry_Sequence_Number;
+    for (index = 0; index < length; index++)
+    {
+        Telemetry_Frame[2 + index] = payload[index];
+    }
+
+    crc = Telemetry_CRC16(Telemetry_Frame, length + 2);
+    Telemetry_Put_U16(&Telemetry_Frame[length + 2], crc);
+
+    encoded_length = Telemetry_COBS_Encode(Telemetry_Frame, length + 4, Telemetry_Encoded_Frame);
+    Telemetry_Encoded_Frame[encoded_length] = 0x00;
+    encoded_length++;
+
+    // Drop the whole frame instead of queueing a truncated one
+    if (EUSCI_A0_UART_TX_Free() < encoded_length)
+    {
+        Telemetry_Dropped_Frames = Telemetry_Dropped_Frames + 1;
+        EndCritical(sr);
+        return -1;
+    }
+
+    EUSCI_A0_UART_Queue_Bytes(Telemetry_Encoded_Frame, encoded_length);
+    Telemetry_Sequence_Number = Telemetry_Sequence_Number + 1;
+
+    EndCritical(sr);
+
+    return 0;
+}
+
+void Telemetry_Serialize_State(const Telemetry_State *state, uint8_t *payload)
+{
+    uint8_t *buffer = payload;
+
+    buffer = Telemetry_Put_U32(buffer, state->Timestamp_ms);
+    buffer = Telemetry_Put_U16(buffer, state->Filtered_Distance_Left);
+    buffer = Telemetry_Put_U16(buffer, state->Filtered_Distance_Center);
+    buffer = Telemetry_Put_U16(buffer, state->Filtered_Distance_Right);
+    buffer = Telemetry_Put_U16(buffer, (uint16_t)state->Converted_Distance_Left);
+    buffer = Telemetry_Put_U16(buffer, (uint16_t)state->Converted_Distance_Center);
+    buffer = Telemetry_Put_U16(buffer, (uint16_t)state->Converted_Distance_Right);
+    buffer = Telemetry_Put_U32(buffer, (uint32_t)state->Left_Steps);
+    buffer = Telemetry_Put_U32(buffer, (uint32_t)state->Right_Steps);
+    buffer = Telemetry_Put_U16(buffer, state->Color_Red);
+    buffer = Telemetry_Put_U16(buffer, state->Color_Green);
+    buffer = Telemetry_Put_U16(buffer, state->Color_Blue);
+    buffer = Telemetry_Put_U16(buffer, state->Color_Clear);
+    buffer[0] = state->Controller_State;
+    buffer[1] = state->Flags;
+    Telemetry_Put_U16(&buffer[2], (uint16_t)EUSCI_A0_UART_Get_Dropped_Bytes());
+}
+
+int Telemetry_Send_State(const Telemetry_State *state)
+{
+    uint8_t payload[TELEMETRY_STATE_PAYLOAD_LENGTH];
+
+    Telemetry_Serialize_State(state, payload);
+
+    return Telemetry_Send_Packet(TELEMETRY_PACKET_STATE, payload, TELEMETRY_STATE_PAYLOAD_LENGTH);
+}
+
+int Telemetry_Send_Trace(const Trace_Entry *entries, uint8_t count)
+{
+    uint8_t payload[TELEMETRY_TRACE_MAX_RECORDS * TRACE_RECORD_SIZE];
+    uint8_t *buffer = payload;
+    uint8_t index;
+
+    if (count > TELEMETRY_TRACE_MAX_RECORDS)
+    {
+        return -1;
+    }
+
+    for (index = 0; index < count; index++)
+    {
+        buffer = Telemetry_Put_U32(buffer, entries[index].Timestamp_Cycles);
+        buffer = Telemetry_Put_U16(buffer, entries[index].Event);
+        buffer = Telemetry_Put_U16(buffer, entries[index].Sequence);
+        buffer = Telemetry_Put_U32(buffer, entries[index].Arg0);
+        buffer = Telemetry_Put_U32(buffer, entries[index].Arg1);
+    }
+
+    return Telemetry_Send_Packet(TELEMETRY_PACKET_TRACE, payload, count * TRACE_RECORD_SIZE);
+}
+
+int Telemetry_Send_Log(uint16_t run, uint16_t record, const uint8_t *payload)
+{
+    uint8_t log_payload[TELEMETRY_LOG_PAYLOAD_LENGTH];
+    uint8_t *buffer = log_payload;
+    uint8_t index;
+
+    buffer = Telemetry_Put_U16(buffer, run);
+    buffer = Telemetry_Put_U16(buffer, record);
+    for (index = 0; index < TELEMETRY_STATE_PAYLOAD_LENGTH; index++)
+    {
+        buffer[index] = payload[index];
+    }
+
+    return Telemetry_Send_Packet(TELEMETRY_PACKET_LOG, log_payload, TELEMETRY_LOG_PAYLOAD_LENGTH);
+}
+
+uint32_t Telemetry_Get_Dropped_Frames(void)
+{
+    return Telemetry_Dropped_Frames;
+}
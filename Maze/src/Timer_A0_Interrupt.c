@@ -12,6 +12,7 @@
  */
 
 #include "../inc/Timer_A0_Interrupt.h"
+#include "../inc/Interrupt_Priority.h"
 
 void Timer_A0_Interrupt_Init(void(*task)(void), uint16_t period)
 {
@@ -39,9 +40,9 @@ void Timer_A0_Interrupt_Init(void(*task)(void), uint16_t period)
     // TAIDEX bits of the EX0 register
     TIMER_A0->EX0 = 0x0000;
 
-    // Set interrupt priority level to 2 using the IPR2 register of NVIC
+    // Set the interrupt priority level in the 8-bit priority field of NVIC
     // Timer A0 has an IRQ number of 8
-    NVIC->IP[2] = (NVIC->IP[2] & 0xFFFFF00F) | 0x00000040;
+    NVIC->IP[8] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_TA0_0);
 
     // Enable Interrupt 8 in NVIC by setting Bit 8 of the ISER register
     NVIC->ISER[0] |= 0x00000100;
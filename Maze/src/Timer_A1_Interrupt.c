@@ -12,6 +12,8 @@
  */
 
 #include "../inc/Timer_A1_Interrupt.h"
+#include "../inc/Interrupt_Priority.h"
+#include "../inc/Profiler.h"
 
 void Timer_A1_Interrupt_Init(void(*task)(void), uint16_t period)
 {
@@ -39,9 +41,9 @@ void Timer_A1_Interrupt_Init(void(*task)(void), uint16_t period)
     // TAIDEX bits of the EX0 register
     TIMER_A1->EX0 = 0x0000;
 
-    // Set interrupt priority level to 2 using the IPR2 register of NVIC
+    // Set the interrupt priority level in the 8-bit priority field of NVIC
     // Timer A1 has an IRQ number of 10
-    NVIC->IP[2] = (NVIC->IP[2] & 0xFF00FFFF) | 0x00400000;
+    NVIC->IP[10] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_TA1_0);
 
     // Enable Interrupt 10 in NVIC by setting Bit 10 of the ISER register
     NVIC->ISER[0] |= 0x00000400;
@@ -51,6 +53,20 @@ void Timer_A1_Interrupt_Init(void(*task)(void), uint16_t period)
     TIMER_A1->CTL |= 0x0014;
 }
 
+void Timer_A1_Set_Period(uint16_t period)
+{
+    // Halt Timer A1 by clearing the MC bits in the CTL register
+    TIMER_A1->CTL &= ~0x0030;
+
+    // Store the new period in the CCR0 register
+    // Note: Timer starts counting from 0
+    TIMER_A1->CCR[0] = (period - 1);
+
+    // Set the TACLR bit and restart Timer A1 in up mode using the
+    // MC bits in the CTL register
+    TIMER_A1->CTL |= 0x0014;
+}
+
 void Timer_A1_Stop(void)
 {
     // Halt Timer A1 by clearing the MC bits in the CTL register
@@ -60,11 +76,19 @@ void Timer_A1_Stop(void)
     NVIC->ICER[0] = 0x00000400;
 }
 
-void TA1_0_IRQHandler(void)
+// Note: Weak, so that TIMER_A1_STATIC_HANDLER can replace it
+__attribute__((weak)) void TA1_0_IRQHandler(void)
 {
+    PROFILER_START(PROFILER_TA1_0);
+
+    // The count restarted from 0 at the end of the period, so it is the time since the interrupt request
+    PROFILER_TIMER_LATENCY(PROFILER_TA1_0, TIMER_A1->R);
+
     // Acknowledge Capture/Compare interrupt and clear it
     TIMER_A1->CCTL[0] &= ~0x0001;
 
     // Execute the user-defined task
     (*Timer_A1_Task)();
+
+    PROFILER_STOP(PROFILER_TA1_0);
 }
@@ -12,6 +12,7 @@
  */
 
 #include "../inc/Timer_A2_Capture.h"
+#include "../inc/Interrupt_Priority.h"
 
 void Timer_A2_Capture_Init(void(*task)(uint16_t time))
 {
@@ -48,9 +49,9 @@ void Timer_A2_Capture_Init(void(*task)(uint16_t time))
     // TAIDEX bits in the EX0 register
     TIMER_A2->EX0 = 0x0000;
 
-    // Set interrupt priority level to 3 using the IPR3 register of NVIC
+    // Set the interrupt priority level in the 8-bit priority field of NVIC
     // Timer A2_N has an IRQ number of 13
-    NVIC->IP[3] = (NVIC->IP[3] & 0xFFFF00FF) | 0x00006000;
+    NVIC->IP[13] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_TA2_N);
 
     // Enable Interrupt 13 in NVIC by setting Bit 13 in the ISER[0] register
     NVIC->ISER[0] |= 0x00002000;
@@ -12,6 +12,7 @@
  */
 
 #include "../inc/Timer_A2_Interrupt.h"
+#include "../inc/Interrupt_Priority.h"
 
 void Timer_A2_Interrupt_Init(void(*task)(void), uint16_t period)
 {
@@ -39,9 +40,9 @@ void Timer_A2_Interrupt_Init(void(*task)(void), uint16_t period)
     // TAIDEX bits of the EX0 register
     TIMER_A2->EX0 = 0x0000;
 
-    // Set interrupt priority level to 2 using the IPR3 register of NVIC
+    // Set the interrupt priority level in the 8-bit priority field of NVIC
     // Timer A2 has an IRQ number of 12
-    NVIC->IP[3] = (NVIC->IP[3] & 0xFFFFFF00) | 0x00000040;
+    NVIC->IP[12] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_TA2_0);
 
     // Enable Interrupt 12 in NVIC by setting Bit 12 of the ISER register
     NVIC->ISER[0] |= 0x00001000;
@@ -15,6 +15,16 @@
  */
 
 #include "../inc/Timer_A3_Capture.h"
+#include "../inc/Interrupt_Priority.h"
+#include "../inc/Profiler.h"
+#include "../inc/CortexM.h"
+
+// User-defined function called by the CCR2 compare channel, and its interval in timer ticks
+static void (*Timer_A3_Compare_Task)(void);
+static uint16_t Timer_A3_Compare_Interval;
+
+// Number of overflows of the timer count since Timer_A3_Capture_Init, the upper bits of the timebase
+static volatile uint32_t Timer_A3_Overflow_Count;
 
 void Timer_A3_Capture_Init(void(*task0)(uint16_t time), void(*task1)(uint16_t time))
 {
@@ -63,36 +73,127 @@ void Timer_A3_Capture_Init(void(*task0)(uint16_t time), void(*task1)(uint16_t ti
     // TAIDEX bits of the EX0 register
     TIMER_A3->EX0 = 0x0000;
 
-    // Set interrupt priority level to 2 using the IPR3 register of NVIC
-    // Timer A3_0 has an IRQ number of 14
-    NVIC->IP[3] = (NVIC->IP[3] & 0xFF00FFFF) | 0x00400000;
-
-    // Set interrupt priority level to 2 using the IPR3 register of NVIC
-    // Timer A3_N has an IRQ number of 15
-    NVIC->IP[3] = (NVIC->IP[3] & 0x00FFFFFF) | 0x40000000;
+    // Set the interrupt priority levels in the 8-bit priority fields of NVIC
+    // Timer A3_0 has an IRQ number of 14, and Timer A3_N has an IRQ number of 15
+    NVIC->IP[14] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_TA3_0);
+    NVIC->IP[15] = INTERRUPT_PRIORITY_FIELD(INTERRUPT_PRIORITY_TA3_N);
 
     // Enable Interrupt 14 and 15 in NVIC by setting Bits 14 and 15 of the ISER[0] register
     NVIC->ISER[0] |= 0x0000C000;
 
-    // Set the TACLR bit and enable Timer A3 in continuous mode using the
-    // MC bits in the CTL register
-    TIMER_A3->CTL |= 0x0024;
+    // Set the TACLR bit, enable the overflow interrupt of the timebase (TAIE, Bit 1),
+    // and enable Timer A3 in continuous mode using the MC bits in the CTL register
+    Timer_A3_Overflow_Count = 0;
+    TIMER_A3->CTL |= 0x0026;
+}
+
+void Timer_A3_Compare_Start(void(*task)(void), uint16_t interval)
+{
+    // Disable the CCR2 interrupt while the task and the interval are changed
+    TIMER_A3->CCTL[2] = 0x0000;
+
+    Timer_A3_Compare_Task = task;
+    Timer_A3_Compare_Interval = interval;
+
+    // The first compare happens one interval from now
+    TIMER_A3->CCR[2] = TIMER_A3->R + interval;
+
+    // Compare Mode (Bit 8 = 0)
+    // Capture / Compare Interrupt Enable (Bit 4 = 1)
+    // Clear Capture / Compare Interrupt Flag (Bit 0 = 0)
+    TIMER_A3->CCTL[2] = 0x0010;
+}
+
+void Timer_A3_Compare_Stop(void)
+{
+    // Disable the CCR2 interrupt and clear its flag
+    TIMER_A3->CCTL[2] = 0x0000;
 }
 
-void TA3_0_IRQHandler(void)
+uint32_t Timer_A3_Get_Time_us(void)
 {
+    uint32_t overflows;
+    uint16_t count;
+    long sr;
+
+    sr = StartCritical();
+    overflows = Timer_A3_Overflow_Count;
+    count = TIMER_A3->R;
+
+    // An overflow that has not been counted yet if TAIFG (Bit 0) is set and the count has wrapped around
+    if ((TIMER_A3->CTL & 0x0001) && (count < 0x8000))
+    {
+        overflows = overflows + 1;
+    }
+    EndCritical(sr);
+
+    // 12 timer ticks per us
+    return (uint32_t)((((uint64_t)overflows << 16) | count) / 12);
+}
+
+void Timer_A3_Overflow_Handler(void)
+{
+    // Clear TAIFG (Bit 0 of the CTL register) and count the overflow
+    TIMER_A3->CTL &= ~0x0001;
+    Timer_A3_Overflow_Count = Timer_A3_Overflow_Count + 1;
+}
+
+void Timer_A3_Compare_Handler(void)
+{
+    // Check the interrupt enable (Bit 4) and the interrupt flag (Bit 0) of CCTL[2], set by the compare channel
+    if ((TIMER_A3->CCTL[2] & 0x0011) == 0x0011)
+    {
+        // Schedule the next compare and clear Bit 0 of the CCTL[2] register
+        TIMER_A3->CCR[2] = TIMER_A3->CCR[2] + Timer_A3_Compare_Interval;
+        TIMER_A3->CCTL[2] &= ~0x0001;
+
+        (*Timer_A3_Compare_Task)();
+    }
+}
+
+// Note: Weak, so that TIMER_A3_CAPTURE_STATIC_HANDLERS can replace it
+__attribute__((weak)) void TA3_0_IRQHandler(void)
+{
+    PROFILER_START(PROFILER_TA3_0);
+
+    // Time since the edge latched in CCR[0]
+    PROFILER_TIMER_LATENCY(PROFILER_TA3_0, (uint16_t)(TIMER_A3->R - TIMER_A3->CCR[0]));
+
     // Acknowledge the Capture/Compare interrupt and clear Bit 0 of the CCTL[0] register
     TIMER_A3->CCTL[0] &= ~0x0001;
 
     // Execute the user-defined task and pass the timer value from CCR[0]
     (*Timer_A3_Capture_Task_0)(TIMER_A3->CCR[0]);
+
+    PROFILER_STOP(PROFILER_TA3_0);
 }
 
-void TA3_N_IRQHandler(void)
+// Note: Weak, so that TIMER_A3_CAPTURE_STATIC_HANDLERS can replace it
+__attribute__((weak)) void TA3_N_IRQHandler(void)
 {
-    // Acknowledge the Capture/Compare interrupt and clear Bit 0 of the CCTL[1] register
-    TIMER_A3->CCTL[1] &= ~0x0001;
+    PROFILER_START(PROFILER_TA3_N);
+
+    // Check the Capture/Compare interrupt flag of CCTL[1] (Bit 0), set by the rising edge of P10.5
+    if (TIMER_A3->CCTL[1] & 0x0001)
+    {
+        // Time since the edge latched in CCR[1]
+        PROFILER_TIMER_LATENCY(PROFILER_TA3_N, (uint16_t)(TIMER_A3->R - TIMER_A3->CCR[1]));
+
+        // Acknowledge the Capture/Compare interrupt and clear Bit 0 of the CCTL[1] register
+        TIMER_A3->CCTL[1] &= ~0x0001;
+
+        // Execute the user-defined task and pass the timer value from CCR[1]
+        (*Timer_A3_Capture_Task_1)(TIMER_A3->CCR[1]);
+    }
+
+    // Count the overflow of the timebase
+    if (TIMER_A3->CTL & 0x0001)
+    {
+        Timer_A3_Overflow_Handler();
+    }
+
+    // Serve the compare channel
+    Timer_A3_Compare_Handler();
 
-    // Execute the user-defined task and pass the timer value from CCR[1]
-    (*Timer_A3_Capture_Task_1)(TIMER_A3->CCR[1]);
+    PROFILER_STOP(PROFILER_TA3_N);
 }
@@ -0,0 +1,98 @@
+/**
+ * @file Trace.c
+ * @brief Source code for the Trace module.
+ *
+ * This file contains the function definitions for the Trace module.
+ *
+ */
+
+#include "../inc/Trace.h"
+
+#if ((TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) != 0)
+#error "TRACE_BUFFER_SIZE must be a power of two"
+#endif
+
+// Ring buffer of the records, indexed by the free-running number of records
+static Trace_Entry Trace_Buffer[TRACE_BUFFER_SIZE];
+static volatile uint32_t Trace_Index;
+static volatile uint8_t Trace_Active;
+
+void Trace_Start(void)
+{
+    long sr;
+
+    sr = StartCritical();
+    Trace_Index = 0;
+    Trace_Active = 1;
+    EndCritical(sr);
+
+    Trace_Record(TRACE_EVENT_START, TRACE_BUFFER_SIZE, Clock_GetFreq());
+}
+
+void Trace_Stop(void)
+{
+    Trace_Active = 0;
+}
+
+void Trace_Resume(void)
+{
+    Trace_Active = 1;
+}
+
+uint8_t Trace_Is_Active(void)
+{
+    return Trace_Active;
+}
+
+void Trace_Record(uint16_t event, uint32_t arg0, uint32_t arg1)
+{
+    Trace_Entry *entry;
+    uint32_t index;
+    long sr;
+
+    if (Trace_Active == 0)
+    {
+        return;
+    }
+
+    // An interrupt between the slot and the stores would record a later event before this one
+    sr = StartCritical();
+    index = Trace_Index;
+    Trace_Index = index + 1;
+    entry = &Trace_Buffer[index & (TRACE_BUFFER_SIZE - 1)];
+    entry->Timestamp_Cycles = CycleCounter_Read();
+    entry->Event = event;
+    entry->Sequence = (uint16_t)index;
+    entry->Arg0 = arg0;
+    entry->Arg1 = arg1;
+    EndCritical(sr);
+}
+
+uint32_t Trace_Get_Count(void)
+{
+    uint32_t index = Trace_Index;
+
+    return (index < TRACE_BUFFER_SIZE) ? index : TRACE_BUFFER_SIZE;
+}
+
+uint32_t Trace_Get_Lost(void)
+{
+    uint32_t index = Trace_Index;
+
+    return (index < TRACE_BUFFER_SIZE) ? 0 : (index - TRACE_BUFFER_SIZE);
+}
+
+int Trace_Read(uint32_t position, Trace_Entry *entry)
+{
+    uint32_t index = Trace_Index;
+    uint32_t count = (index < TRACE_BUFFER_SIZE) ? index : TRACE_BUFFER_SIZE;
+
+    if (position >= count)
+    {
+        return -1;
+    }
+
+    *entry = Trace_Buffer[(index - count + position) & (TRACE_BUFFER_SIZE - 1)];
+
+    return 0;
+}
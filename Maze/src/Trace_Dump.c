@@ -0,0 +1,112 @@
+/**
+ * @file Trace_Dump.c
+ * @brief Source code for the Trace_Dump module.
+ *
+ * This file contains the function definitions for the Trace_Dump module.
+ * It executes the trace commands and sends the records of a trace dump in the background.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Trace_Dump.h"
+#include "../inc/Print_Format.h"
+
+// Function that sends a reply line, and 1 if the records are sent as Trace packets
+static void (*Trace_Dump_Output)(const char *line);
+static uint8_t Trace_Dump_Packets;
+
+// Set while the trace is dumped, and position of the next record to send
+static volatile uint8_t Trace_Dump_Active = 0;
+static uint32_t Trace_Dump_Position = 0;
+
+void Trace_Dump_Init(void (*output)(const char *line), uint8_t packets)
+{
+    Trace_Dump_Output = output;
+    Trace_Dump_Packets = packets;
+    Trace_Dump_Active = 0;
+    Trace_Dump_Position = 0;
+}
+
+int Trace_Dump_Command(char **arguments, uint8_t argument_count)
+{
+    if ((argument_count != 2) || (strcmp(arguments[0], "trace") != 0))
+    {
+        return -1;
+    }
+
+    if (strcmp(arguments[1], "dump") == 0)
+    {
+        if (Trace_Dump_Active == 0)
+        {
+            // Freeze the records while they are sent
+            Trace_Stop();
+            Trace_Dump_Position = 0;
+            Trace_Dump_Active = 1;
+        }
+    }
+    else if (strcmp(arguments[1], "start") == 0)
+    {
+        Trace_Dump_Active = 0;
+        Trace_Start();
+        Trace_Dump_Output("ok trace");
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+void Trace_Dump_Task(void)
+{
+    Trace_Entry entries[TELEMETRY_TRACE_MAX_RECORDS];
+    uint32_t count;
+    uint8_t index;
+    char line[PARAMETERS_MAX_REPLY_LENGTH];
+
+    if (Trace_Dump_Active == 0)
+    {
+        return;
+    }
+
+    count = Trace_Get_Count();
+
+    if (Trace_Dump_Packets)
+    {
+        while ((Trace_Dump_Position < count) && (EUSCI_A0_UART_TX_Free() >= TELEMETRY_MAX_ENCODED_LENGTH))
+        {
+            index = 0;
+            while ((index < TELEMETRY_TRACE_MAX_RECORDS) && (Trace_Read(Trace_Dump_Position, &entries[index]) == 0))
+            {
+                Trace_Dump_Position++;
+                index++;
+            }
+            Telemetry_Send_Trace(entries, index);
+        }
+    }
+    else
+    {
+        for (index = 0; (index < TRACE_DUMP_LINES_PER_TASK) && (Trace_Read(Trace_Dump_Position, &entries[0]) == 0); index++)
+        {
+            Print_Format_To_Buffer(line, sizeof(line), "trace %lu %u %u %lu %lu", (unsigned long)entries[0].Timestamp_Cycles,
+                     (unsigned int)entries[0].Sequence, (unsigned int)entries[0].Event,
+                     (unsigned long)entries[0].Arg0, (unsigned long)entries[0].Arg1);
+            Trace_Dump_Output(line);
+            Trace_Dump_Position++;
+        }
+    }
+
+    if (Trace_Dump_Position >= count)
+    {
+        Print_Format_To_Buffer(line, sizeof(line), "ok trace %lu %lu", (unsigned long)count, (unsigned long)Trace_Get_Lost());
+        Trace_Dump_Output(line);
+        Trace_Dump_Active = 0;
+        Trace_Resume();
+    }
+}
+
+uint8_t Trace_Dump_Is_Active(void)
+{
+    return Trace_Dump_Active;
+}
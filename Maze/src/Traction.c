@@ -0,0 +1,179 @@
+/**
+ * @file Traction.c
+ * @brief Source code for the Traction module.
+ *
+ * This file contains the function definitions for the Traction module.
+ * It detects the wheel slip from the tachometer speeds and scales the motor duty cycles down while a wheel slips.
+ *
+ */
+
+#include "../inc/Traction.h"
+#include "../inc/Speed_Controller.h"
+#include "../inc/Odometry.h"
+#include "../inc/Trace.h"
+
+// Largest increase of the speed magnitude of a wheel with grip in one tick, in mm/s
+#define TRACTION_MAX_SPEED_STEP     (TRACTION_MAX_ACCELERATION / SPEED_CONTROLLER_RATE_HZ)
+
+// Duty cycle scale in 1/256 (1 until the first slip, also before Traction_Init), and number of ticks since the last slip
+static uint16_t Traction_Scale = 256;
+static uint16_t Traction_Quiet_Ticks;
+
+// Per wheel (left, right): speed at the previous tick and consecutive ticks above the setpoint
+static int16_t Traction_Last_Speed[2];
+static uint8_t Traction_Overspeed_Ticks[2];
+
+static Traction_Segment Traction_Last_Segment;
+static uint32_t Traction_Segment_Count;
+
+// Returns 1 if a wheel slips: its speed increases beyond the acceleration envelope, or stays above the setpoint
+static uint8_t Traction_Wheel_Slips(uint8_t wheel, int16_t speed, int16_t setpoint, uint8_t closed_loop)
+{
+    int32_t magnitude = (speed >= 0) ? speed : -speed;
+    int32_t last_magnitude = (Traction_Last_Speed[wheel] >= 0) ? Traction_Last_Speed[wheel] : -Traction_Last_Speed[wheel];
+    uint8_t same_direction = ((speed >= 0) == (Traction_Last_Speed[wheel] >= 0)) || (Traction_Last_Speed[wheel] == 0);
+    uint8_t slips = 0;
+
+    if (same_direction && ((magnitude - last_magnitude) > TRACTION_MAX_SPEED_STEP))
+    {
+        slips = 1;
+    }
+
+    // The setpoint is only a commanded profile while the Speed_Controller drives the wheel in the same direction
+    if (closed_loop && (setpoint != 0) && ((speed >= 0) == (setpoint > 0))
+        && (magnitude > (((setpoint >= 0) ? setpoint : -setpoint) + TRACTION_SLIP_MARGIN)))
+    {
+        if (Traction_Overspeed_Ticks[wheel] < TRACTION_DETECT_TICKS)
+        {
+            Traction_Overspeed_Ticks[wheel]++;
+        }
+        if (Traction_Overspeed_Ticks[wheel] >= TRACTION_DETECT_TICKS)
+        {
+            slips = 1;
+        }
+    }
+    else
+    {
+        Traction_Overspeed_Ticks[wheel] = 0;
+    }
+
+    Traction_Last_Speed[wheel] = speed;
+
+    return slips;
+}
+
+void Traction_Init(void)
+{
+    int16_t left_speed;
+    int16_t right_speed;
+
+    Speed_Controller_Get_Speed(&left_speed, &right_speed);
+
+    Traction_Scale = 256;
+    Traction_Quiet_Ticks = 0;
+    Traction_Last_Speed[0] = left_speed;
+    Traction_Last_Speed[1] = right_speed;
+    Traction_Overspeed_Ticks[0] = 0;
+    Traction_Overspeed_Ticks[1] = 0;
+    Traction_Last_Segment.Start_Distance_um = 0;
+    Traction_Last_Segment.End_Distance_um = 0;
+    Traction_Last_Segment.Wheels = 0;
+    Traction_Last_Segment.Active = 0;
+    Traction_Segment_Count = 0;
+}
+
+void Traction_Update(void)
+{
+    int16_t left_speed;
+    int16_t right_speed;
+    int16_t left_setpoint;
+    int16_t right_setpoint;
+    uint8_t closed_loop = Speed_Controller_Is_Enabled();
+    uint8_t wheels = 0;
+    int32_t distance_um;
+
+    Speed_Controller_Get_Speed(&left_speed, &right_speed);
+    Speed_Controller_Get_Setpoint(&left_setpoint, &right_setpoint);
+
+    if (Traction_Wheel_Slips(0, left_speed, left_setpoint, closed_loop))
+    {
+        wheels |= TRACTION_WHEEL_LEFT;
+    }
+    if (Traction_Wheel_Slips(1, right_speed, right_setpoint, closed_loop))
+    {
+        wheels |= TRACTION_WHEEL_RIGHT;
+    }
+
+    if (wheels != 0)
+    {
+        distance_um = Odometry_Get_Distance_um();
+
+        if (Traction_Last_Segment.Active == 0)
+        {
+            Traction_Last_Segment.Start_Distance_um = distance_um;
+            Traction_Last_Segment.Wheels = 0;
+            Traction_Last_Segment.Active = 1;
+            Traction_Segment_Count++;
+            Trace_Record(TRACE_EVENT_SLIP, 1 | ((uint32_t)wheels << 8), (uint32_t)distance_um);
+        }
+        Traction_Last_Segment.End_Distance_um = distance_um;
+        Traction_Last_Segment.Wheels |= wheels;
+
+        Traction_Scale = (Traction_Scale * TRACTION_DUTY_SCALE) / 256;
+        if (Traction_Scale < TRACTION_MIN_DUTY_SCALE)
+        {
+            Traction_Scale = TRACTION_MIN_DUTY_SCALE;
+        }
+        Traction_Quiet_Ticks = 0;
+        return;
+    }
+
+    if (Traction_Quiet_Ticks < TRACTION_HOLD_TICKS)
+    {
+        Traction_Quiet_Ticks++;
+        return;
+    }
+
+    // The wheels have grip again: the segment ends at the last slip, and the scale returns to 1
+    if (Traction_Last_Segment.Active)
+    {
+        Traction_Last_Segment.Active = 0;
+        Trace_Record(TRACE_EVENT_SLIP, (uint32_t)Traction_Last_Segment.Wheels << 8, (uint32_t)Traction_Last_Segment.End_Distance_um);
+    }
+
+    if (Traction_Scale < 256)
+    {
+        Traction_Scale = Traction_Scale + TRACTION_DUTY_RECOVERY;
+        if (Traction_Scale > 256)
+        {
+            Traction_Scale = 256;
+        }
+    }
+}
+
+uint16_t Traction_Limit_Duty_Cycle(uint16_t duty_cycle)
+{
+    return ((uint32_t)duty_cycle * Traction_Scale) / 256;
+}
+
+uint8_t Traction_Is_Limiting(void)
+{
+    return (Traction_Scale < 256);
+}
+
+uint32_t Traction_Get_Segment_Count(void)
+{
+    return Traction_Segment_Count;
+}
+
+int Traction_Get_Last_Segment(Traction_Segment *segment)
+{
+    if (Traction_Segment_Count == 0)
+    {
+        return 0;
+    }
+
+    *segment = Traction_Last_Segment;
+
+    return 1;
+}
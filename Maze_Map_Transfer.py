@@ -0,0 +1,136 @@
+# @file Maze_Map_Transfer.py
+#
+# @brief Python script used to download and upload the packed maze maps of the robot.
+#
+# Python script that sends the map commands of the firmware (see Maze_Map_Transfer_Command in Maze/src/Maze_Map_Transfer.c) over EUSCI_A0.
+# A packed map (see Maze_Map_Pack.h) is sent as lines of 16 bytes in hex, so a 16 x 16 map takes 8 lines.
+# The files are the packed maps themselves, the format also read by the host simulator (maze_sim -m or -k),
+# and written by maze_sim -o for a known competition maze.
+#
+# Commands:
+#  - get FILE [--slot N]            Save the current map of the robot, or the map of a slot of its library, to FILE
+#  - put FILE [--load] [--slot N]   Send FILE to the robot, then load it as the current map, and/or save it to a slot
+#  - list                           Print the maps of the library of the robot
+#
+# Usage: python Maze_Map_Transfer.py COM# get|put|list [FILE] [--slot N] [--load]
+#
+# Example: python Maze_Map_Transfer.py COM5 get explored.mzp
+#          ../Simulator/build/maze_sim -a flood -m explored.mzp -k explored.mzp
+#
+# @note Python 3 and the pySerial library must be installed, and PMOD_Color_Display.py (for the frame decoder)
+#       must be in the same folder, so the Pygame library must also be installed.
+
+import argparse
+import sys
+import time
+
+import serial
+
+from PMOD_Color_Display import Telemetry_Decoder, TELEMETRY_PACKET_TEXT
+
+# Number of bytes of a packed map in one "map put" line, the same as MAZE_MAP_TRANSFER_BYTES_PER_LINE in Maze_Map_Transfer.h
+BYTES_PER_LINE = 16
+
+# Longest wait for a reply in s (a slot write can rotate a flash sector)
+REPLY_TIMEOUT = 1.0
+
+
+class Map_Link:
+    """Sends command lines and collects the Text packets of their replies."""
+
+    def __init__(self, ser):
+        self.ser = ser
+        self.decoder = Telemetry_Decoder()
+
+    def command(self, line, done_prefix, timeout=REPLY_TIMEOUT):
+        """Sends a command and returns its reply lines, up to the line that starts with done_prefix or "err"."""
+        self.ser.write((line + "\n").encode("ascii"))
+        lines = []
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            for (packet_type, payload) in self.decoder.feed(self.ser.read(max(1, self.ser.in_waiting))):
+                if packet_type != TELEMETRY_PACKET_TEXT:
+                    continue
+                text = payload.decode("ascii", "replace")
+                lines.append(text)
+                if text.startswith(done_prefix) or text.startswith("err"):
+                    return lines
+        raise RuntimeError("no reply to \"{}\"".format(line))
+
+
+def check(lines):
+    if lines[-1].startswith("err"):
+        raise RuntimeError(lines[-1])
+    return lines
+
+
+def get_map(link, slot):
+    """Returns the packed map of the robot, or of a slot."""
+    lines = check(link.command("map get" if slot is None else "map get {}".format(slot), "ok map get"))
+    data = bytearray()
+    for line in lines[:-1]:
+        words = line.split()
+        if len(words) != 3 or words[0] != "map" or int(words[1]) != len(data):
+            raise RuntimeError("unexpected line \"{}\"".format(line))
+        data += bytes.fromhex(words[2])
+    if len(data) != int(lines[-1].split()[-1]):
+        raise RuntimeError("received {} bytes, expected {}".format(len(data), lines[-1].split()[-1]))
+    return bytes(data)
+
+
+def put_map(link, data):
+    """Sends a packed map to the receive buffer of the robot."""
+    for offset in range(0, len(data), BYTES_PER_LINE):
+        reply = check(link.command("map put {} {}".format(offset, data[offset:offset + BYTES_PER_LINE].hex()), "ok map put"))
+        if int(reply[-1].split()[-1]) != min(len(data), offset + BYTES_PER_LINE):
+            raise RuntimeError("unexpected reply \"{}\"".format(reply[-1]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Download and upload the packed maze maps of the robot.")
+    parser.add_argument("port", help="serial port of EUSCI_A0, for example COM5 or /dev/ttyACM0")
+    parser.add_argument("action", choices=["get", "put", "list"])
+    parser.add_argument("file", nargs="?", help="packed map file of get and put")
+    parser.add_argument("--slot", type=int, help="slot of the map library of the robot")
+    parser.add_argument("--load", action="store_true", help="with put, replace the current map of the robot")
+    args = parser.parse_args()
+
+    if args.action != "list" and args.file is None:
+        parser.error("{} requires a FILE".format(args.action))
+
+    try:
+        ser = serial.Serial(args.port, 115200, timeout=0.01)
+    except serial.serialutil.SerialException:
+        print("ERROR! Could not find COM port {}".format(args.port))
+        sys.exit(1)
+
+    link = Map_Link(ser)
+    try:
+        if args.action == "get":
+            start = time.time()
+            data = get_map(link, args.slot)
+            with open(args.file, "wb") as file:
+                file.write(data)
+            print("{} bytes saved to {} in {:.0f} ms".format(len(data), args.file, (time.time() - start) * 1000.0))
+        elif args.action == "put":
+            with open(args.file, "rb") as file:
+                data = file.read()
+            start = time.time()
+            put_map(link, data)
+            print("{} bytes sent in {:.0f} ms".format(len(data), (time.time() - start) * 1000.0))
+            if args.slot is not None:
+                print(check(link.command("map write {}".format(args.slot), "ok map write"))[-1])
+            if args.load:
+                print(check(link.command("map load", "ok map load"))[-1])
+        else:
+            for line in check(link.command("map list", "ok map list")):
+                print(line)
+    except RuntimeError as error:
+        print("ERROR! {}".format(error))
+        sys.exit(1)
+    finally:
+        ser.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,118 @@
+# @file Memory_Report.py
+#
+# @brief Python script used to report the RAM used by each module of the firmware.
+#
+# Python script that reads the map file written by the TI linker (Maze.map in the Debug folder of the
+# CCS project) and prints the code, read-only data, and read-write data (.data and .bss) of each object
+# file, sorted by the RAM they use, followed by the use of the SRAM_DATA region.
+#
+# The SRAM_DATA length, the stack size, and the heap size of the map file are compared with the values of
+# Maze/inc/Memory_Config.h, and the script exits with status 1 when they differ or when SRAM_DATA is full.
+#
+# Usage: python Memory_Report.py MAP_FILE [--config Maze/inc/Memory_Config.h] [--top N]
+#
+# @note Python 3 must be installed in order to run the script.
+
+import argparse
+import os
+import re
+import sys
+
+DEFAULT_CONFIG = os.path.join(os.path.dirname(os.path.abspath(__file__)), "Maze", "inc", "Memory_Config.h")
+
+# Row of the MODULE SUMMARY table: name, code, ro data, rw data
+MODULE_ROW = re.compile(r"^\s+(\S.*?):?\s+(\d+)\s+(\d+)\s+(\d+)\s*$")
+
+# Row of the MEMORY CONFIGURATION table: name, origin, length, used, unused
+MEMORY_ROW = re.compile(r"^\s+(\w+)\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})")
+
+CONFIG_DEFINE = re.compile(r"^#define\s+(MEMORY_CONFIG_\w+_SIZE)\s+(0x[0-9a-fA-F]+|\d+)\s*$")
+
+
+def read_config(path):
+    """Returns the MEMORY_CONFIG_*_SIZE values of Memory_Config.h."""
+    values = {}
+    with open(path) as config_file:
+        for line in config_file:
+            match = CONFIG_DEFINE.match(line.strip())
+            if match:
+                values[match.group(1)] = int(match.group(2), 0)
+    return values
+
+
+def read_map(path):
+    """Returns the modules (name, code, ro data, rw data) and the memory regions of a map file."""
+    modules = []
+    regions = {}
+    section = None
+    with open(path) as map_file:
+        for line in map_file:
+            title = line.strip()
+            if title == "MEMORY CONFIGURATION":
+                section = "memory"
+                continue
+            if title == "MODULE SUMMARY":
+                section = "modules"
+                continue
+            if title in ("SECTION ALLOCATION MAP", "GLOBAL SYMBOLS: SORTED ALPHABETICALLY BY Name", "LINKER GENERATED COPY TABLES"):
+                section = None
+                continue
+
+            if section == "memory":
+                match = MEMORY_ROW.match(line)
+                if match:
+                    regions[match.group(1)] = (int(match.group(3), 16), int(match.group(4), 16))
+            elif section == "modules":
+                match = MODULE_ROW.match(line)
+                if match and not match.group(1).startswith("Total") and not match.group(1).startswith("Grand Total"):
+                    modules.append((match.group(1), int(match.group(2)), int(match.group(3)), int(match.group(4))))
+    return modules, regions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Report the RAM used by each module from a TI linker map file.")
+    parser.add_argument("map_file", help="map file written by the linker")
+    parser.add_argument("--config", default=DEFAULT_CONFIG, help="path of Memory_Config.h")
+    parser.add_argument("--top", type=int, default=0, help="only print the N modules that use the most RAM")
+    args = parser.parse_args()
+
+    config = read_config(args.config)
+    modules, regions = read_map(args.map_file)
+    if not modules:
+        print("No MODULE SUMMARY found in {}".format(args.map_file))
+        return 1
+
+    sizes = {name: rw for (name, code, ro, rw) in modules}
+    objects = sorted([m for m in modules if m[0] not in ("Stack", "Heap")], key=lambda m: m[3], reverse=True)
+    if args.top > 0:
+        objects = objects[:args.top]
+
+    sram_length = config.get("MEMORY_CONFIG_SRAM_SIZE", 0)
+    print("{:<32} {:>8} {:>8} {:>8} {:>7}".format("Module", "code", "ro data", "rw data", "% RAM"))
+    for (name, code, ro, rw) in objects:
+        percent = (100.0 * rw / sram_length) if sram_length else 0.0
+        print("{:<32} {:>8} {:>8} {:>8} {:>6.1f}%".format(name, code, ro, rw, percent))
+
+    status = 0
+    if "SRAM_DATA" in regions:
+        length, used = regions["SRAM_DATA"]
+        print("\nSRAM_DATA: {} of {} bytes used, {} bytes free".format(used, length, length - used))
+        if length != sram_length:
+            print("SRAM_DATA length 0x{:X} does not match MEMORY_CONFIG_SRAM_SIZE 0x{:X}".format(length, sram_length))
+            status = 1
+        if used >= length:
+            print("SRAM_DATA is full")
+            status = 1
+
+    for (name, define) in (("Stack", "MEMORY_CONFIG_STACK_SIZE"), ("Heap", "MEMORY_CONFIG_HEAP_SIZE")):
+        if name in sizes:
+            print("{}: {} bytes".format(name, sizes[name]))
+            if sizes[name] != config.get(define):
+                print("{} size {} does not match {} {}".format(name, sizes[name], define, config.get(define)))
+                status = 1
+
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
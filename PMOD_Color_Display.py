@@ -1,19 +1,118 @@
 # @file PMOD_Color_Display.py
 # 
-# @brief Python test script used to verify the color detected by the PMOD COLOR module.
+# @brief Python test script used to display the telemetry sent by the robot.
 # 
-# Python script that can be used to test the PMOD COLOR module
-# by reading the detected color hexadecimal values from the serial terminal
-# and displaying the color to a Pygame window.
+# Python script that can be used to decode the binary State packets sent by the Telemetry driver
+# and display them in a Pygame window: rolling plots of the three converted distances, of the wheel speeds,
+# and of the centering error of the wall-centering controller, the track of the robot on the maze map,
+# and the detected color as a swatch. The legacy text mode can be selected with the --text argument,
+# which reads the detected color hexadecimal values from the serial terminal and displays the color.
 #
-# @note Python 3 and the Pygame library must be installed in order to run the test script.
+# Frame format: COBS([type][sequence][payload][CRC-16/CCITT-FALSE, little-endian]) followed by 0x00
+#
+# In binary mode, a reader thread blocks on the serial port and decodes every frame as soon as it is received,
+# so the window only redraws the latest packets and a slow redraw does not drop frames. The wheel speeds are
+# computed from the wheel steps over SPEED_WINDOW_MS, the centering error with the formula of
+# Wall_Centering_Drive, and the track by integrating the wheel steps from the center of the start cell.
+# With --record FILE, every State packet is saved when the window is closed, to a CSV file, or to a Parquet
+# file if FILE ends with .parquet (requires pandas with pyarrow or fastparquet).
+#
+# In binary mode, pressing T in the window sends the "trace dump" command. The Trace packets of the dump
+# are decoded and printed when the dump is complete, and also saved to a CSV file with --trace FILE.
+# The maze_cell records of the dump mark the cells visited by Controller_2 on the maze map.
+# Pressing B sends the "blackbox dump" command. The Log packets of the runs recorded in flash are
+# summarized per run when the dump is complete, and also saved to a CSV file with --black-box FILE.
+# Pressing C clears the track and the visited cells.
+#
+# Usage: python PMOD_Color_Display.py COM# [--text] [--trace FILE] [--black-box FILE] [--record FILE]
+#
+# @note Python 3, the Pygame library, and the pySerial library must be installed in order to run the test script.
 #
 # @author Aaron Nanas
 
+import collections
+import csv
+import math
+import queue
+import struct
+import threading
 import pygame
 import serial
 import sys
 
+TELEMETRY_PACKET_STATE = 0x01
+TELEMETRY_PACKET_TEXT = 0x02
+TELEMETRY_PACKET_TRACE = 0x03
+TELEMETRY_PACKET_LOG = 0x04
+
+# Timestamp, filtered L/C/R, converted L/C/R, wheel steps L/R, color R/G/B/C, controller state, flags, UART dropped bytes
+STATE_PAYLOAD_FORMAT = "<I3H3h2i4HBBH"
+STATE_PAYLOAD_LENGTH = struct.calcsize(STATE_PAYLOAD_FORMAT)
+
+# Run number and record number, followed by a State payload
+LOG_HEADER_FORMAT = "<HH"
+LOG_PAYLOAD_LENGTH = struct.calcsize(LOG_HEADER_FORMAT) + STATE_PAYLOAD_LENGTH
+
+# Timestamp in cycles, event ID, sequence number, payload words (see Trace.h)
+TRACE_RECORD_FORMAT = "<IHHII"
+TRACE_RECORD_SIZE = struct.calcsize(TRACE_RECORD_FORMAT)
+# MCLK frequency of the timestamps before the first start or clock record (run profile)
+TRACE_DEFAULT_MCLK_HZ = 48000000
+
+TRACE_EVENT_NAMES = {
+	0x0001: "start",
+	0x0010: "route",
+	0x0011: "maze_cell",
+	0x0012: "junction",
+	0x0020: "motion_start",
+	0x0021: "motion_finish",
+	0x0030: "bumper",
+	0x0031: "slip",
+	0x0040: "deadline_miss",
+	0x0050: "parameter",
+	0x0060: "rate",
+	0x0061: "clock",
+}
+
+# Number of State packets shown in the rolling plots (8 seconds at 250 Hz)
+CHART_LENGTH = 2000
+
+# Maximum distance shown in the distance plot in mm
+CHART_MAX_DISTANCE = 800
+
+# Maximum wheel speed and centering error shown in the plots (in mm/s and mm, both signs)
+CHART_MAX_SPEED = 1000
+CHART_MAX_ERROR = 200
+
+# The wheel speeds are the steps counted over this time window, a single State period only holds a few steps
+SPEED_WINDOW_MS = 40
+
+# Robot geometry and controller defaults (see Odometry.h and Controller.h)
+UM_PER_STEP = 611
+WHEEL_BASE_UM = 140000
+DESIRED_DISTANCE = 200
+WALL_CENTERING_SET_POINT = 120
+
+# Maze map (see Memory_Config.h and Controller.h)
+MAZE_MAP_WIDTH = 16
+MAZE_MAP_HEIGHT = 16
+MAZE_CELL_SIZE = 250
+MAZE_CELL_PIXELS = 25
+
+# Number of track points kept on the maze map
+TRACK_LENGTH = 20000
+
+# Route race state in bits 7-4 of the controller state (see Route_Race.h)
+ROUTE_RACE_RUNNING = 2
+
+# Period of the redraw timer in binary mode in ms, the packets are decoded by the reader thread
+REDRAW_PERIOD_MS = 40
+
+WINDOW_WIDTH = 1200
+WINDOW_HEIGHT = 720
+CHART_WIDTH = 800
+CHART_HEIGHT = WINDOW_HEIGHT // 3
+
 def validate_serial_port():
 	if len(sys.argv) < 2:
 		print("Provide a valid COM port number to connect to (format: COM#)")
@@ -23,32 +122,450 @@ def connect_to_serial_port():
 	# Try to open the serial COM port with a baud rate of 115200.
  	# Otherwise, print an error message and exit the program
 	try:
-		ser = serial.Serial(sys.argv[1], 115200)
+		ser = serial.Serial(sys.argv[1], 115200, timeout=0)
 	except serial.serialutil.SerialException:
 		print("ERROR! Could not find COM port %s" % sys.argv[1])
 		sys.exit()
 	
 	return ser
 
-def pygame_init():
-	# Create a 500 x 500 Pygame window
-	color_screen = pygame.display.set_mode((500, 500))
+def pygame_init(period_ms):
+	# Create a Pygame window that holds the plots, the maze map, and the color swatch
+	color_screen = pygame.display.set_mode((WINDOW_WIDTH, WINDOW_HEIGHT))
 
-	# Create a timer event that will be triggered every 200 ms
-	pygame.time.set_timer(pygame.USEREVENT, 10)
+	# Create a timer event that will be triggered every period_ms
+	pygame.time.set_timer(pygame.USEREVENT, period_ms)
 
 	return color_screen
 
-if __name__ == "__main__":
-	validate_serial_port()
+def cobs_decode(data):
+	# Return the decoded frame, or None if the encoding is invalid
+	output = bytearray()
+	index = 0
 
-	ser = connect_to_serial_port()
+	while index < len(data):
+		code = data[index]
+
+		if code == 0 or index + code > len(data) + 1:
+			return None
+
+		output += data[index + 1:index + code]
+		index += code
+
+		# A code of 0xFF is not followed by an implicit zero byte
+		if code < 0xFF and index < len(data):
+			output.append(0)
+
+	return bytes(output)
+
+def crc16_ccitt_table():
+	table = list()
+
+	for byte in range(256):
+		crc = byte << 8
+
+		for _ in range(8):
+			if crc & 0x8000:
+				crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+			else:
+				crc = (crc << 1) & 0xFFFF
+
+		table.append(crc)
+
+	return table
+
+# A byte-wise table, the bit-wise loop is too slow to check every frame at the full link rate
+CRC16_TABLE = crc16_ccitt_table()
+
+def crc16_ccitt(data):
+	crc = 0xFFFF
+
+	for byte in data:
+		crc = ((crc << 8) & 0xFFFF) ^ CRC16_TABLE[(crc >> 8) ^ byte]
+
+	return crc
+
+class Telemetry_Decoder:
+	def __init__(self):
+		self.buffer = bytearray()
+		self.last_sequence = None
+		self.frames_received = 0
+		self.frames_lost = 0
+		self.frames_corrupted = 0
+
+	def feed(self, data):
+		# Split the received bytes at the 0x00 delimiters and return the valid packets as (type, payload) tuples
+		packets = list()
+		self.buffer += data
+
+		while True:
+			delimiter = self.buffer.find(b"\x00")
+
+			if delimiter < 0:
+				break
+
+			encoded_frame = bytes(self.buffer[:delimiter])
+			del self.buffer[:delimiter + 1]
+
+			if len(encoded_frame) == 0:
+				continue
+
+			frame = cobs_decode(encoded_frame)
+
+			if frame is None or len(frame) < 4 or crc16_ccitt(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]:
+				self.frames_corrupted += 1
+				continue
+
+			packet_type = frame[0]
+			sequence = frame[1]
+
+			# Count the frames dropped by the robot or lost on the link using the sequence number
+			if self.last_sequence is not None:
+				self.frames_lost += (sequence - self.last_sequence - 1) & 0xFF
+
+			self.last_sequence = sequence
+			self.frames_received += 1
+
+			packets.append((packet_type, frame[2:-2]))
+
+		return packets
+
+class Serial_Reader(threading.Thread):
+	def __init__(self, ser, decoder):
+		# Daemon thread, so a blocked read does not keep the script running after the window has been closed
+		threading.Thread.__init__(self, daemon=True)
+		# The port is opened without timeout for the text mode, the thread blocks for up to 100 ms instead
+		self.ser = ser
+		self.ser.timeout = 0.1
+		self.decoder = decoder
+		self.packets = queue.Queue()
+		self.running = True
+
+	def run(self):
+		# Block until a byte is received, then read every byte already waiting, so the frames are
+		# decoded at the rate they arrive, independently of the redraw of the window
+		while self.running:
+			try:
+				data = self.ser.read(max(1, self.ser.in_waiting))
+			except serial.serialutil.SerialException:
+				print("ERROR! Serial port %s closed" % self.ser.port)
+				break
+
+			for packet in self.decoder.feed(data):
+				self.packets.put(packet)
+
+	def get_packets(self):
+		# Return the packets decoded since the previous call, the queue is not bounded so none is dropped
+		packets = list()
+
+		while True:
+			try:
+				packets.append(self.packets.get_nowait())
+			except queue.Empty:
+				return packets
+
+	def stop(self):
+		self.running = False
+
+class Trace_Collector:
+	def __init__(self, csv_path=None):
+		self.records = list()
+		self.csv_path = csv_path
+
+	def feed(self, payload):
+		# A Trace packet holds whole records, the oldest one first
+		for offset in range(0, len(payload) - TRACE_RECORD_SIZE + 1, TRACE_RECORD_SIZE):
+			self.records.append(struct.unpack_from(TRACE_RECORD_FORMAT, payload, offset))
+
+	def finish(self):
+		# Unwrap the 32-bit timestamps, two consecutive records are less than 89 s apart
+		# The cycles between two records are at the MCLK frequency of the last start or clock record
+		rows = list()
+		time_ms = 0.0
+		mclk_hz = TRACE_DEFAULT_MCLK_HZ
+		previous = None
+		gaps = 0
+
+		for timestamp, event, sequence, arg0, arg1 in self.records:
+			if previous is not None:
+				time_ms += ((timestamp - previous[0]) & 0xFFFFFFFF) * 1000.0 / mclk_hz
+				if ((sequence - previous[1]) & 0xFFFF) != 1:
+					gaps += 1
+			previous = (timestamp, sequence)
+			if event in (0x0001, 0x0061) and arg1 != 0:
+				mclk_hz = arg1
+
+			name = TRACE_EVENT_NAMES.get(event, "user_0x%04x" % event if event >= 0x8000 else "0x%04x" % event)
+			rows.append((time_ms, sequence, name, arg0, arg1))
+
+		for row in rows:
+			print("%10.3f ms  #%-5u %-14s %10u %10u" % row)
+		if gaps:
+			print("Trace: %u gaps in the sequence numbers (lost Trace packets)" % gaps)
+
+		if self.csv_path is not None:
+			with open(self.csv_path, "w", newline="") as csv_file:
+				writer = csv.writer(csv_file)
+				writer.writerow(("time_ms", "sequence", "event", "arg0", "arg1"))
+				writer.writerows(rows)
+			print("Trace saved to %s" % self.csv_path)
+
+		self.records = list()
+
+		return rows
+
+class Black_Box_Collector:
+	def __init__(self, csv_path=None):
+		self.records = list()
+		self.csv_path = csv_path
+
+	def feed(self, payload):
+		run, record = struct.unpack_from(LOG_HEADER_FORMAT, payload)
+		self.records.append((run, record, decode_state(payload[struct.calcsize(LOG_HEADER_FORMAT):])))
+
+	def finish(self):
+		# Summarize every run: duration, distance driven, and closest wall seen
+		runs = collections.OrderedDict()
+		for run, record, state in self.records:
+			runs.setdefault(run, list()).append((record, state))
+
+		for run, states in runs.items():
+			first = states[0][1]
+			last = states[-1][1]
+			duration_ms = last["timestamp_ms"] - first["timestamp_ms"]
+			steps = sum(abs(last["steps"][wheel] - first["steps"][wheel]) for wheel in range(2)) // 2
+			closest = min(min(state["distance"]) for _, state in states)
+			missing = (states[-1][0] - states[0][0] + 1) - len(states)
+			print("Run %5u: %5u records, %8.2f s, %6u steps, closest wall %4d mm, %u records missing"
+				% (run, len(states), duration_ms / 1000.0, steps, closest, missing))
+
+		if self.csv_path is not None:
+			with open(self.csv_path, "w", newline="") as csv_file:
+				writer = csv.writer(csv_file)
+				writer.writerow(("run", "record", "timestamp_ms", "distance_left", "distance_center", "distance_right",
+					"left_steps", "right_steps", "controller_state"))
+				for run, record, state in self.records:
+					writer.writerow((run, record, state["timestamp_ms"]) + tuple(state["distance"]) + tuple(state["steps"])
+						+ (state["controller_state"],))
+			print("Black box saved to %s" % self.csv_path)
+
+		self.records = list()
 
-	color_screen = pygame_init()
+def decode_state(payload):
+	values = struct.unpack(STATE_PAYLOAD_FORMAT, payload)
 
+	return {
+		"timestamp_ms": values[0],
+		"filtered": values[1:4],
+		"distance": values[4:7],
+		"steps": values[7:9],
+		"color": values[9:13],
+		"controller_state": values[13],
+		"flags": values[14],
+		"uart_dropped": values[15],
+	}
+
+def centering_error(distance):
+	# Same error as Wall_Centering_Drive with the default DESIRED_DISTANCE and WALL_CENTERING_SET_POINT
+	left_wall = distance[0] <= DESIRED_DISTANCE
+	right_wall = distance[2] <= DESIRED_DISTANCE
+
+	if left_wall and right_wall:
+		return distance[0] - distance[2]
+	elif right_wall:
+		return 2 * (WALL_CENTERING_SET_POINT - distance[2])
+	elif left_wall:
+		return 2 * (distance[0] - WALL_CENTERING_SET_POINT)
+
+	return 0
+
+class Telemetry_View:
+	def __init__(self, record_path=None):
+		self.distance = [collections.deque(maxlen=CHART_LENGTH) for _ in range(3)]
+		self.speed = [collections.deque(maxlen=CHART_LENGTH) for _ in range(2)]
+		self.error = collections.deque(maxlen=CHART_LENGTH)
+		self.track = collections.deque(maxlen=TRACK_LENGTH)
+		self.speed_window = collections.deque()
+		self.visited = dict()
+		self.record_path = record_path
+		self.rows = list()
+		self.state = None
+		self.clear_track()
+
+	def clear_track(self):
+		# The robot starts in the center of cell (0, 0) heading north, x points east and y north in mm
+		self.x = MAZE_CELL_SIZE / 2.0
+		self.y = MAZE_CELL_SIZE / 2.0
+		self.heading = math.pi / 2
+		self.track.clear()
+		self.track.append((self.x, self.y))
+		self.visited.clear()
+
+	def feed(self, state):
+		previous = self.state
+		self.state = state
+
+		for channel in range(3):
+			self.distance[channel].append(state["distance"][channel])
+
+		# Wheel speeds in mm/s over the last SPEED_WINDOW_MS
+		self.speed_window.append((state["timestamp_ms"], state["steps"]))
+		while len(self.speed_window) > 2 and state["timestamp_ms"] - self.speed_window[1][0] >= SPEED_WINDOW_MS:
+			self.speed_window.popleft()
+		first_ms, first_steps = self.speed_window[0]
+		speed = [0, 0]
+		if state["timestamp_ms"] > first_ms:
+			for wheel in range(2):
+				speed[wheel] = (state["steps"][wheel] - first_steps[wheel]) * UM_PER_STEP / (state["timestamp_ms"] - first_ms)
+		for wheel in range(2):
+			self.speed[wheel].append(speed[wheel])
+
+		error = centering_error(state["distance"])
+		self.error.append(error)
+
+		if previous is not None:
+			# A new trial restarts from the start cell
+			if (state["controller_state"] >> 4) == ROUTE_RACE_RUNNING and (previous["controller_state"] >> 4) != ROUTE_RACE_RUNNING:
+				self.clear_track()
+			else:
+				self.integrate(previous["steps"], state["steps"])
+
+		if self.record_path is not None:
+			self.rows.append((state["timestamp_ms"],) + tuple(state["filtered"]) + tuple(state["distance"]) + tuple(state["steps"])
+				+ (speed[0], speed[1], error) + tuple(state["color"]) + (state["controller_state"], state["flags"], state["uart_dropped"]))
+
+	def integrate(self, previous_steps, steps):
+		# Same midpoint integration as Odometry_Update, in floating point
+		left_mm = (steps[0] - previous_steps[0]) * UM_PER_STEP / 1000.0
+		right_mm = (steps[1] - previous_steps[1]) * UM_PER_STEP / 1000.0
+		heading_change = (right_mm - left_mm) * 1000.0 / WHEEL_BASE_UM
+		mid_heading = self.heading + heading_change / 2
+
+		self.x += (left_mm + right_mm) / 2 * math.cos(mid_heading)
+		self.y += (left_mm + right_mm) / 2 * math.sin(mid_heading)
+		self.heading += heading_change
+
+		if left_mm != 0 or right_mm != 0:
+			self.track.append((self.x, self.y))
+
+	def feed_trace(self, rows):
+		# Mark the cells of the maze_cell records, the second argument is 1 for a goal cell
+		for time_ms, sequence, name, arg0, arg1 in rows:
+			if name == "maze_cell":
+				self.visited[(arg0 & 0xFF, (arg0 >> 8) & 0xFF)] = arg1
+
+	def save(self):
+		if self.record_path is None or len(self.rows) == 0:
+			return
+
+		columns = ("timestamp_ms", "filtered_left", "filtered_center", "filtered_right", "distance_left", "distance_center",
+			"distance_right", "left_steps", "right_steps", "left_speed", "right_speed", "centering_error",
+			"color_red", "color_green", "color_blue", "color_clear", "controller_state", "flags", "uart_dropped")
+
+		if self.record_path.endswith(".parquet"):
+			try:
+				import pandas
+			except ImportError:
+				print("ERROR! Saving a Parquet file requires pandas, %u State packets not saved" % len(self.rows))
+				return
+
+			pandas.DataFrame(self.rows, columns=columns).to_parquet(self.record_path)
+		else:
+			with open(self.record_path, "w", newline="") as csv_file:
+				writer = csv.writer(csv_file)
+				writer.writerow(columns)
+				writer.writerows(self.rows)
+
+		print("%u State packets saved to %s" % (len(self.rows), self.record_path))
+
+def draw_plot(color_screen, top, channels, colors, minimum, maximum):
+	# Draw the channels in a band of CHART_HEIGHT pixels starting at top, minimum at the bottom
+	bottom = top + CHART_HEIGHT - 1
+	pygame.draw.line(color_screen, pygame.Color(60, 60, 60), (0, bottom), (CHART_WIDTH - 1, bottom))
+
+	if minimum < 0:
+		zero = bottom - (0 - minimum) * (CHART_HEIGHT - 1) // (maximum - minimum)
+		pygame.draw.line(color_screen, pygame.Color(60, 60, 60), (0, zero), (CHART_WIDTH - 1, zero))
+
+	for channel, color in zip(channels, colors):
+		if len(channel) > 1:
+			points = list()
+
+			for index, value in enumerate(channel):
+				x = index * CHART_WIDTH // CHART_LENGTH
+				y = bottom - (min(max(value, minimum), maximum) - minimum) * (CHART_HEIGHT - 1) // (maximum - minimum)
+				points.append((x, y))
+
+			pygame.draw.lines(color_screen, color, False, points)
+
+def draw_maze_map(color_screen, view, left):
+	# Draw the cells visited by Controller_2 and the track of the robot, north up
+	size = MAZE_MAP_WIDTH * MAZE_CELL_PIXELS
+
+	def to_screen(x_mm, y_mm):
+		return (left + int(x_mm * MAZE_CELL_PIXELS / MAZE_CELL_SIZE), size - 1 - int(y_mm * MAZE_CELL_PIXELS / MAZE_CELL_SIZE))
+
+	for (x, y), goal in view.visited.items():
+		if x < MAZE_MAP_WIDTH and y < MAZE_MAP_HEIGHT:
+			color = pygame.Color(40, 120, 40) if goal else pygame.Color(50, 50, 80)
+			pygame.draw.rect(color_screen, color, (left + x * MAZE_CELL_PIXELS, size - (y + 1) * MAZE_CELL_PIXELS, MAZE_CELL_PIXELS, MAZE_CELL_PIXELS))
+
+	for index in range(MAZE_MAP_WIDTH + 1):
+		x = left + index * MAZE_CELL_PIXELS
+		pygame.draw.line(color_screen, pygame.Color(40, 40, 40), (x, 0), (x, size))
+	for index in range(MAZE_MAP_HEIGHT + 1):
+		y = index * MAZE_CELL_PIXELS
+		pygame.draw.line(color_screen, pygame.Color(40, 40, 40), (left, y), (left + size, y))
+
+	if len(view.track) > 1:
+		pygame.draw.lines(color_screen, pygame.Color(255, 200, 0), False, [to_screen(x, y) for x, y in view.track])
+
+	position = to_screen(view.x, view.y)
+	pygame.draw.circle(color_screen, pygame.Color(255, 255, 255), position, 4)
+	pygame.draw.line(color_screen, pygame.Color(255, 255, 255), position,
+		(position[0] + int(10 * math.cos(view.heading)), position[1] - int(10 * math.sin(view.heading))))
+
+def draw_state(color_screen, font, view, decoder):
+	state = view.state
+	color_screen.fill(pygame.Color(0, 0, 0, 255))
+
+	# Left, center, and right distances, left and right wheel speeds, and centering error as rolling plots
+	draw_plot(color_screen, 0, view.distance, [pygame.Color(255, 80, 80), pygame.Color(80, 255, 80), pygame.Color(80, 160, 255)],
+		0, CHART_MAX_DISTANCE)
+	draw_plot(color_screen, CHART_HEIGHT, view.speed, [pygame.Color(255, 80, 80), pygame.Color(80, 160, 255)],
+		-CHART_MAX_SPEED, CHART_MAX_SPEED)
+	draw_plot(color_screen, 2 * CHART_HEIGHT, [view.error], [pygame.Color(255, 255, 255)], -CHART_MAX_ERROR, CHART_MAX_ERROR)
+
+	draw_maze_map(color_screen, view, CHART_WIDTH)
+	map_height = MAZE_MAP_HEIGHT * MAZE_CELL_PIXELS
+
+	# Pygame expects the color values to be within the range of 0 - 255
+	# The lower eight bits must be truncated for each color channel
+	color_integer_buffer = [value >> 8 for value in state["color"][0:3]]
+	pygame.draw.rect(color_screen, pygame.Color(color_integer_buffer[0], color_integer_buffer[1], color_integer_buffer[2], 255),
+		(CHART_WIDTH, map_height + 4, WINDOW_WIDTH - CHART_WIDTH, 40))
+
+	lines = [
+		"t = %d ms" % state["timestamp_ms"],
+		"L / C / R = %d / %d / %d mm" % state["distance"],
+		"speed = %d / %d mm/s" % (view.speed[0][-1], view.speed[1][-1]),
+		"error = %d mm" % view.error[-1],
+		"steps = %d / %d" % state["steps"],
+		"state = 0x%02X" % state["controller_state"],
+		"received = %d  lost = %d  corrupted = %d" % (decoder.frames_received, decoder.frames_lost, decoder.frames_corrupted),
+		"UART dropped = %d" % state["uart_dropped"],
+	]
+
+	for index, line in enumerate(lines):
+		color_screen.blit(font.render(line, True, pygame.Color(255, 255, 255)), (CHART_WIDTH + 8, map_height + 52 + index * 20))
+
+	pygame.display.flip()
+
+def run_text_mode(ser, color_screen):
 	# Initialize an array to store hexadecimal and integer color values
 	color_hex_buffer = list()
 	color_integer_buffer = list()
+	line_buffer = bytearray()
 
 	while True:
 		# Wait until the timer event has been triggered
@@ -60,27 +577,110 @@ if __name__ == "__main__":
 
 		elif timer_event.type == pygame.USEREVENT:
 			# If the timer event has been triggered, then read the received data
-			color_value = ser.readline().decode("utf-8")
+			line_buffer += ser.read(ser.in_waiting)
+
+			if b"\n" not in line_buffer:
+				continue
+
+			color_value, _, line_buffer = bytes(line_buffer).partition(b"\n")
+			line_buffer = bytearray(line_buffer)
+			color_value = color_value.decode("utf-8", errors="ignore")
 
 			# Display the color hexadecimal values received in the terminal
 			print("Color Received:", color_value)
 			
 			# Expected format: "r=%04x g=%04x b=%04x\r\n"
 			color_hex_buffer = [color_value[2:6], color_value[9:13], color_value[16:20]]
-			
-			# Pygame expects the color values to be within the range of 0 - 255
-			# The lower eight bits must be truncated for each color channel
-			color_integer_buffer = [int(value, 16) >> 8 for value in color_hex_buffer]
+
+			try:
+				# Pygame expects the color values to be within the range of 0 - 255
+				# The lower eight bits must be truncated for each color channel
+				color_integer_buffer = [int(value, 16) >> 8 for value in color_hex_buffer]
+			except ValueError:
+				continue
 
 			# Update the screen by displaying the color that has been detected by the PMOD COLOR module
 			color_screen.fill(pygame.Color(color_integer_buffer[0], color_integer_buffer[1], color_integer_buffer[2], 255))
 
 			pygame.display.flip()
 
-			for event in pygame.event.get():
-				if event.type == pygame.QUIT:
-					pygame.quit()
-					print("Pygame window closed")
-					sys.exit()
+def run_binary_mode(ser, color_screen, trace_path, black_box_path, record_path):
+	font = pygame.font.SysFont(None, 22)
+	decoder = Telemetry_Decoder()
+	reader = Serial_Reader(ser, decoder)
+	trace = Trace_Collector(trace_path)
+	black_box = Black_Box_Collector(black_box_path)
+	view = Telemetry_View(record_path)
+
+	reader.start()
+
+	while True:
+		# Wait until the timer event has been triggered
+		timer_event = pygame.event.wait()
+
+		# Exit the loop if the Pygame window has been closed by the user
+		if timer_event.type == pygame.QUIT:
+			break
+
+		elif timer_event.type == pygame.KEYDOWN and timer_event.key == pygame.K_t:
+			ser.write(b"trace dump\n")
+
+		elif timer_event.type == pygame.KEYDOWN and timer_event.key == pygame.K_b:
+			ser.write(b"blackbox dump\n")
+
+		elif timer_event.type == pygame.KEYDOWN and timer_event.key == pygame.K_c:
+			view.clear_track()
+
+		elif timer_event.type == pygame.USEREVENT:
+			# Process every packet decoded by the reader thread since the last timer event
+			for packet_type, payload in reader.get_packets():
+				if packet_type == TELEMETRY_PACKET_STATE and len(payload) == STATE_PAYLOAD_LENGTH:
+					view.feed(decode_state(payload))
+
+				elif packet_type == TELEMETRY_PACKET_TRACE:
+					trace.feed(payload)
+
+				elif packet_type == TELEMETRY_PACKET_LOG and len(payload) == LOG_PAYLOAD_LENGTH:
+					black_box.feed(payload)
+
+				elif packet_type == TELEMETRY_PACKET_TEXT:
+					# Replies of the Parameters module, the last one of a trace dump follows its records
+					text = payload.decode("ascii", "replace")
+					if text.startswith("ok trace "):
+						view.feed_trace(trace.finish())
+					elif text.startswith("ok blackbox dump "):
+						black_box.finish()
+					print(text)
+
+			# Redraw the window once per timer event, independently of the packet rate
+			if view.state is not None:
+				draw_state(color_screen, font, view, decoder)
+
+	reader.stop()
+	view.save()
+
+if __name__ == "__main__":
+	validate_serial_port()
+
+	ser = connect_to_serial_port()
+
+	pygame.init()
+
+	if "--text" in sys.argv[2:]:
+		color_screen = pygame_init(10)
+		run_text_mode(ser, color_screen)
+	else:
+		color_screen = pygame_init(REDRAW_PERIOD_MS)
+		trace_path = None
+		if "--trace" in sys.argv[2:-1]:
+			trace_path = sys.argv[sys.argv.index("--trace") + 1]
+		black_box_path = None
+		if "--black-box" in sys.argv[2:-1]:
+			black_box_path = sys.argv[sys.argv.index("--black-box") + 1]
+		record_path = None
+		if "--record" in sys.argv[2:-1]:
+			record_path = sys.argv[sys.argv.index("--record") + 1]
+		run_binary_mode(ser, color_screen, trace_path, black_box_path, record_path)
 
 	pygame.quit()
+	print("Pygame window closed")
@@ -0,0 +1,143 @@
+# @file benchmark.py
+#
+# @brief Python script used to benchmark the maze controllers with the host simulator.
+#
+# Python script that runs maze_sim for every maze of the corpus (mazes/*.txt) and every algorithm
+# (right and left wall follower, flood-fill exploration, speed run), and reports per maze and algorithm:
+# the completion rate, the mean completion time, the distance traveled, the wall collisions, and the cost of the
+# control tick (host time, and the cells repaired per tick by the flood-fill replanning).
+#
+# maze_sim sets the goal cells of Controller_2 to the center cells of every maze, so the flood algorithm is also
+# run on the lab mazes that are smaller than the 16 x 16 maze map.
+#
+# Outputs:
+#  - <output>.csv: one row per run, as printed by maze_sim -f csv
+#  - <output>.json: the summary per maze and algorithm
+#
+# With --baseline, the summary is compared with a previous JSON summary and the script exits with status 1 if a
+# maze and algorithm completes less often, takes longer, collides more, or costs more than the tolerance allows.
+# The host time of the control tick is noisy and only comparable between runs on the same host, so it is only
+# compared with --host-time. The replanned cells per tick do not depend on the host and are always compared.
+#
+# baseline.json is the summary of the committed controllers with the default options, used by "make check".
+#
+# Usage: python benchmark.py [--runs N] [--output build/benchmark] [--baseline baseline.json [--host-time]]
+#
+# @note Python 3 must be installed, and maze_sim must have been built with make.
+
+import argparse
+import csv
+import glob
+import io
+import json
+import os
+import subprocess
+import sys
+
+SIMULATOR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "build", "maze_sim")
+MAZE_DIRECTORY = os.path.join(os.path.dirname(os.path.abspath(__file__)), "mazes")
+
+ALGORITHMS = ["right", "left", "flood", "speed"]
+
+# Allowed change from the baseline before a result is reported as a regression
+TOLERANCE_COMPLETION = 0.0      # completion rate (absolute)
+TOLERANCE_TIME = 0.05           # mean completion time (relative)
+TOLERANCE_COLLISIONS = 0.5      # mean collisions per run (absolute)
+TOLERANCE_TICK_NS = 0.25        # mean host time of a control tick (relative)
+TOLERANCE_REPLAN_CELLS = 0      # largest number of replanned cells per tick (absolute)
+
+def run_simulator(maze, algorithm, runs, seed):
+	command = [SIMULATOR, "-a", algorithm, "-m", maze, "-n", str(runs), "-s", str(seed), "-f", "csv"]
+	result = subprocess.run(command, stdout=subprocess.PIPE, universal_newlines=True)
+	if result.returncode not in (0, 1):
+		print("ERROR! %s failed with status %d" % (" ".join(command), result.returncode))
+		sys.exit(2)
+	return result.stdout
+
+def summarize(rows):
+	done = [row for row in rows if row["result"] == "done"]
+	summary = {
+		"runs": len(rows),
+		"completion": len(done) / len(rows),
+		"time_s": sum(float(row["time_s"]) for row in done) / len(done) if done else None,
+		"distance_mm": sum(float(row["distance_mm"]) for row in done) / len(done) if done else None,
+		"collisions": sum(int(row["collisions"]) for row in rows) / len(rows),
+		"tick_mean_ns": sum(float(row["tick_mean_ns"]) for row in rows) / len(rows),
+		"tick_max_ns": max(float(row["tick_max_ns"]) for row in rows),
+		"replan_max_cells": max(int(row["replan_max_cells"]) for row in rows),
+	}
+	return summary
+
+def compare(summary, baseline, host_time):
+	regressions = []
+	for key, current in sorted(summary.items()):
+		if key not in baseline:
+			continue
+		previous = baseline[key]
+
+		if current["completion"] < previous["completion"] - TOLERANCE_COMPLETION:
+			regressions.append("%s: completion %.0f%% -> %.0f%%" % (key, 100 * previous["completion"], 100 * current["completion"]))
+		if (current["time_s"] is not None) and (previous["time_s"] is not None) \
+			and (current["time_s"] > previous["time_s"] * (1 + TOLERANCE_TIME)):
+			regressions.append("%s: time %.2f s -> %.2f s" % (key, previous["time_s"], current["time_s"]))
+		if current["collisions"] > previous["collisions"] + TOLERANCE_COLLISIONS:
+			regressions.append("%s: collisions %.1f -> %.1f" % (key, previous["collisions"], current["collisions"]))
+		if host_time and (current["tick_mean_ns"] > previous["tick_mean_ns"] * (1 + TOLERANCE_TICK_NS)):
+			regressions.append("%s: tick %.0f ns -> %.0f ns" % (key, previous["tick_mean_ns"], current["tick_mean_ns"]))
+		if current["replan_max_cells"] > previous["replan_max_cells"] + TOLERANCE_REPLAN_CELLS:
+			regressions.append("%s: replan %d cells -> %d cells" % (key, previous["replan_max_cells"], current["replan_max_cells"]))
+	return regressions
+
+def format_optional(value, format_string):
+	return "-" if value is None else format_string % value
+
+def main():
+	parser = argparse.ArgumentParser(description="Benchmark the maze controllers with the host simulator")
+	parser.add_argument("--runs", type=int, default=20, help="runs per maze and algorithm")
+	parser.add_argument("--seed", type=int, default=1, help="seed of the first run")
+	parser.add_argument("--output", default=os.path.join("build", "benchmark"), help="output path without extension")
+	parser.add_argument("--baseline", help="JSON summary of a previous benchmark")
+	parser.add_argument("--host-time", action="store_true", help="also compare the host time of the control tick")
+	args = parser.parse_args()
+
+	if not os.path.exists(SIMULATOR):
+		print("ERROR! Build the simulator with make first")
+		sys.exit(2)
+
+	header = subprocess.run([SIMULATOR, "-H"], stdout=subprocess.PIPE, universal_newlines=True).stdout.strip().split(",")
+	rows = []
+	summary = {}
+	for maze in sorted(glob.glob(os.path.join(MAZE_DIRECTORY, "*.txt"))):
+		name = os.path.splitext(os.path.basename(maze))[0]
+		for algorithm in ALGORITHMS:
+			output = run_simulator(maze, algorithm, args.runs, args.seed)
+			runs = list(csv.DictReader(io.StringIO(output), fieldnames=header))
+			for row in runs:
+				row["maze"] = name
+			rows.extend(runs)
+			summary["%s/%s" % (name, algorithm)] = summarize(runs)
+
+	os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+	with open(args.output + ".csv", "w", newline="") as output:
+		writer = csv.DictWriter(output, fieldnames=header)
+		writer.writeheader()
+		writer.writerows(rows)
+	with open(args.output + ".json", "w") as output:
+		json.dump(summary, output, indent=2, sort_keys=True)
+
+	print("%-30s %6s %8s %10s %6s %9s %9s %7s" % ("maze/algorithm", "done", "time s", "dist mm", "coll", "tick ns", "max ns", "replan"))
+	for key, result in sorted(summary.items()):
+		print("%-30s %5.0f%% %8s %10s %6.1f %9.0f %9.0f %7d" % (key, 100 * result["completion"],
+			format_optional(result["time_s"], "%.2f"), format_optional(result["distance_mm"], "%.0f"),
+			result["collisions"], result["tick_mean_ns"], result["tick_max_ns"], result["replan_max_cells"]))
+
+	if args.baseline:
+		with open(args.baseline) as baseline:
+			regressions = compare(summary, json.load(baseline), args.host_time)
+		for regression in regressions:
+			print("REGRESSION %s" % regression)
+		if regressions:
+			sys.exit(1)
+
+if __name__ == "__main__":
+	main()
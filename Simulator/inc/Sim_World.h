@@ -0,0 +1,307 @@
+/**
+ * @file Sim_World.h
+ * @brief Header file for the Sim_World module.
+ *
+ * This file contains the function definitions for the 2D world model of the host simulator.
+ * It stores the walls of a maze, moves a differential drive robot with a first-order motor model,
+ * counts the tachometer steps of the wheels, casts the rays of the three Sharp distance sensors,
+ * and detects the collisions of the robot with the walls.
+ *
+ * World layout:
+ *  - The maze uses the same conventions as the Maze_Map driver: cell (0, 0) is the start cell in the bottom-left
+ *    corner, X increases to the east, Y increases to the north, and Bit 0-3 of a cell are the North, East, South
+ *    and West walls. The walls on the border of the maze are always set.
+ *  - Positions are in mm from the bottom-left corner. The heading is in radians, counter-clockwise from the east.
+ *  - The robot starts in the center of cell (0, 0) facing north, like in the firmware.
+ *
+ * Robot model:
+ *  - The steady-state speed of a wheel is proportional to the PWM duty cycle above a dead band
+ *    (SIM_WORLD_MM_PER_S_PER_DUTY, which matches the feedforward gain of the Speed_Controller driver),
+ *    and the wheel reaches it with a first-order lag of SIM_WORLD_MOTOR_TIME_CONSTANT.
+ *  - Every run draws a small gain mismatch between the wheels and the noise of the distance sensors
+ *    from its seed, so repeated runs are different but reproducible.
+ *  - The robot is a disc of SIM_WORLD_ROBOT_RADIUS. A collision is recorded when the disc overlaps a wall.
+ *
+ * The constants of the robot model can be overridden on the command line (-D), like the controller parameters.
+ *
+ * Maze file format (the usual ASCII format of micromouse mazes, the north row first):
+ *
+ *     +---+---+
+ *     |       |
+ *     +   +---+
+ *     |       |
+ *     +---+---+
+ *
+ *  - A wall segment is any character other than a space between two '+' posts.
+ *  - The number of cells is given by the number of posts, up to SIM_WORLD_MAX_SIZE in each direction.
+ *
+ * A file that starts with the magic bytes of a packed map of the firmware (see Maze_Map_Pack.h) is loaded as
+ * a packed map instead, for example a map explored by the robot and downloaded with the "map get" command.
+ * Its unknown walls are open, like in the Maze_Map driver.
+ *
+ */
+
+#ifndef SIMULATOR_INC_SIM_WORLD_H_
+#define SIMULATOR_INC_SIM_WORLD_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Largest maze supported by the world model
+#define SIM_WORLD_MAX_SIZE              16
+
+// Default size of a maze cell in mm, the firmware assumes the same size (MAZE_CELL_SIZE)
+#define SIM_WORLD_CELL_SIZE             250.0
+
+// Radius of the robot disc and distance between the wheels in mm
+#define SIM_WORLD_ROBOT_RADIUS          70.0
+#define SIM_WORLD_WHEEL_BASE            140.0
+
+// Distance traveled by a wheel per tachometer step in mm (360 steps per ~220 mm circumference)
+#define SIM_WORLD_MM_PER_STEP           0.611
+
+// Steady-state wheel speed in mm/s per duty cycle count above the dead band
+#ifndef SIM_WORLD_MM_PER_S_PER_DUTY
+#define SIM_WORLD_MM_PER_S_PER_DUTY     (1.0 / 27.0)
+#endif
+#ifndef SIM_WORLD_MOTOR_DEADBAND
+#define SIM_WORLD_MOTOR_DEADBAND        200.0
+#endif
+
+// Time constant of the motor speed in s
+#ifndef SIM_WORLD_MOTOR_TIME_CONSTANT
+#define SIM_WORLD_MOTOR_TIME_CONSTANT   0.04
+#endif
+
+// Largest gain mismatch between the two wheels drawn for a run (2%)
+#ifndef SIM_WORLD_MOTOR_MISMATCH
+#define SIM_WORLD_MOTOR_MISMATCH        0.02
+#endif
+
+// Standard deviation of the Sharp sensor noise in ADC counts
+#ifndef SIM_WORLD_SENSOR_NOISE
+#define SIM_WORLD_SENSOR_NOISE          20.0
+#endif
+
+/**
+ * @brief Distance sensors of the robot, in the order of the ADC channels (A17, A14, A16).
+ */
+typedef enum
+{
+    SIM_WORLD_SENSOR_RIGHT = 0,
+    SIM_WORLD_SENSOR_CENTER = 1,
+    SIM_WORLD_SENSOR_LEFT = 2,
+    SIM_WORLD_NUM_SENSORS = 3
+} Sim_World_Sensor;
+
+/**
+ * @brief State of a wheel as seen by the tachometer.
+ *
+ * Steps is the signed number of steps since the reset. Period is the time between the last two steps
+ * in units of 83.3 ns (65535 when the wheel is too slow), and Direction is 1 forward, -1 backward or 0 stopped.
+ */
+typedef struct
+{
+    int32_t Steps;
+    uint16_t Period;
+    int8_t Direction;
+} Sim_World_Wheel;
+
+/**
+ * @brief Pose of the robot in the world, in mm and radians.
+ */
+typedef struct
+{
+    double X;
+    double Y;
+    double Heading;
+} Sim_World_Pose;
+
+/**
+ * @brief Generate a random perfect maze of the given size, with the 2 x 2 center area open (for an even size).
+ *
+ * The same seed always gives the same maze.
+ *
+ * @param width  The number of cells in X (1 to SIM_WORLD_MAX_SIZE).
+ * @param height The number of cells in Y (1 to SIM_WORLD_MAX_SIZE).
+ * @param seed   The seed of the random generator.
+ *
+ * @return None
+ */
+void Sim_World_Generate_Maze(uint8_t width, uint8_t height, uint32_t seed);
+
+/**
+ * @brief Load a maze from an ASCII file or from a packed map file.
+ *
+ * @param path The path of the file.
+ *
+ * @return 0 if the maze has been loaded, or -1 if the file cannot be read or is not a valid maze.
+ */
+int Sim_World_Load_Maze(const char *path);
+
+/**
+ * @brief Write the maze in the ASCII file format read by Sim_World_Load_Maze.
+ *
+ * @param file The output stream.
+ *
+ * @return None
+ */
+void Sim_World_Print_Maze(FILE *file);
+
+/**
+ * @brief Copy the walls of the maze in the format of Maze_Map_Export, with every cell of the maze visited.
+ *
+ * The cells of the map outside of the maze are closed.
+ *
+ * @param map Pointer to store MAZE_MAP_STORAGE_SIZE bytes.
+ *
+ * @return None
+ */
+void Sim_World_Export_Map(uint8_t *map);
+
+/**
+ * @brief Set the size of a maze cell. Must be called before Sim_World_Reset.
+ *
+ * @param cell_size The size of a cell in mm.
+ *
+ * @return None
+ */
+void Sim_World_Set_Cell_Size(double cell_size);
+
+/**
+ * @brief Return the number of cells of the maze in X and Y.
+ *
+ * @param width  Pointer to store the number of cells in X.
+ * @param height Pointer to store the number of cells in Y.
+ *
+ * @return None
+ */
+void Sim_World_Get_Size(uint8_t *width, uint8_t *height);
+
+/**
+ * @brief Indicate if a side of a cell has a wall.
+ *
+ * @param x         The X coordinate of the cell.
+ * @param y         The Y coordinate of the cell.
+ * @param direction The side of the cell (0 = North, 1 = East, 2 = South, 3 = West).
+ *
+ * @return 1 if the side has a wall or the cell is outside the maze, or 0 otherwise.
+ */
+uint8_t Sim_World_Has_Wall(int x, int y, uint8_t direction);
+
+/**
+ * @brief Place the robot at rest in the center of cell (0, 0) facing north and clear the counters.
+ *
+ * @param seed The seed of the wheel mismatch and of the sensor noise for this run.
+ *
+ * @return None
+ */
+void Sim_World_Reset(uint32_t seed);
+
+/**
+ * @brief Place the robot at rest in the center of a cell, keeping the time, the counters and the tachometers.
+ *
+ * @param x         The X coordinate of the cell.
+ * @param y         The Y coordinate of the cell.
+ * @param direction The heading of the robot (0 = North, 1 = East, 2 = South, 3 = West).
+ *
+ * @return None
+ */
+void Sim_World_Place(int x, int y, uint8_t direction);
+
+/**
+ * @brief Set the signed PWM duty cycles of the motors (positive drives the wheel forward).
+ *
+ * @param left_duty_cycle  The duty cycle of the left motor (-15000 to 15000).
+ * @param right_duty_cycle The duty cycle of the right motor (-15000 to 15000).
+ *
+ * @return None
+ */
+void Sim_World_Set_Motors(int32_t left_duty_cycle, int32_t right_duty_cycle);
+
+/**
+ * @brief Advance the world by a time step: motor speeds, pose, tachometers and collisions.
+ *
+ * @param dt The time step in s. Steps of 0.5 ms or less keep the tachometer periods accurate.
+ *
+ * @return None
+ */
+void Sim_World_Step(double dt);
+
+/**
+ * @brief Return the raw ADC value of a Sharp distance sensor, including the sensor noise.
+ *
+ * @param sensor The sensor.
+ *
+ * @return The 14-bit ADC value.
+ */
+uint32_t Sim_World_Read_Sensor(Sim_World_Sensor sensor);
+
+/**
+ * @brief Return the true distance measured by a sensor, without the noise and the sensor model.
+ *
+ * @param sensor The sensor.
+ *
+ * @return The distance from the sensor to the nearest wall along its axis in mm.
+ */
+double Sim_World_Get_Sensor_Distance(Sim_World_Sensor sensor);
+
+/**
+ * @brief Return the tachometer state of both wheels.
+ *
+ * @param left  Pointer to store the state of the left wheel.
+ * @param right Pointer to store the state of the right wheel.
+ *
+ * @return None
+ */
+void Sim_World_Get_Wheels(Sim_World_Wheel *left, Sim_World_Wheel *right);
+
+/**
+ * @brief Return the pose of the robot.
+ *
+ * @param pose Pointer to store the pose.
+ *
+ * @return None
+ */
+void Sim_World_Get_Pose(Sim_World_Pose *pose);
+
+/**
+ * @brief Return the cell that contains the center of the robot.
+ *
+ * @param x Pointer to store the X coordinate of the cell.
+ * @param y Pointer to store the Y coordinate of the cell.
+ *
+ * @return None
+ */
+void Sim_World_Get_Cell(int *x, int *y);
+
+/**
+ * @brief Return the simulated time since Sim_World_Reset.
+ *
+ * @param None
+ *
+ * @return The time in s.
+ */
+double Sim_World_Get_Time();
+
+/**
+ * @brief Return the distance traveled by the center of the robot since Sim_World_Reset.
+ *
+ * @param None
+ *
+ * @return The distance in mm.
+ */
+double Sim_World_Get_Distance();
+
+/**
+ * @brief Return the number of collisions since Sim_World_Reset.
+ *
+ * A collision is counted once when the robot starts to overlap a wall, not at every step of the contact.
+ *
+ * @param None
+ *
+ * @return The number of collisions.
+ */
+uint32_t Sim_World_Get_Collisions();
+
+#endif /* SIMULATOR_INC_SIM_WORLD_H_ */
@@ -0,0 +1,16 @@
+/**
+ * @file msp.h
+ * @brief Host replacement for the MSP432 device header.
+ *
+ * The simulator compiles the hardware-independent drivers of the firmware (controllers, Motion,
+ * Odometry, Speed_Controller, Maze_Map, Route, LPF) on the host. They include "msp.h" only for the
+ * standard integer types, so this header found first in the include path replaces the device header.
+ *
+ */
+
+#ifndef SIMULATOR_INC_MSP_H_
+#define SIMULATOR_INC_MSP_H_
+
+#include <stdint.h>
+
+#endif /* SIMULATOR_INC_MSP_H_ */
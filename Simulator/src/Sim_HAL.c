@@ -0,0 +1,249 @@
+/**
+ * @file Sim_HAL.c
+ * @brief Source code for the simulated hardware abstraction layer.
+ *
+ * This file implements the driver functions that the controllers and the hardware-independent drivers call
+ * (Motor, Tachometer, Analog_Distance_Sensors, Clock, CortexM and Print_Format) on top of the Sim_World model,
+ * with the same prototypes as the firmware drivers.
+ *
+ *  - The PWM duty cycles and directions of the Motor driver are passed to the motor model. Like the DRV8838
+ *    drivers, a duty cycle is only applied while the motors are enabled (between a Motor_* command and Motor_Stop).
+ *  - The Tachometer driver returns the step counts, the periods and the directions of the simulated wheels.
+ *  - The Analog_Distance_Sensors driver returns the simulated ADC values, and converts them with the calibration
+ *    formula of the firmware.
+ *  - The Clock delays advance the world, so a controller that blocks moves the robot with the last command.
+ *  - The interrupt and critical section functions do nothing, the simulation is single threaded.
+ *  - The Print_Format literals are written to stdout instead of the EUSCI_A0 TX ring buffer.
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "../inc/Sim_World.h"
+#include "../../Maze/inc/Motor.h"
+#include "../../Maze/inc/Tachometer.h"
+#include "../../Maze/inc/Analog_Distance_Sensors.h"
+#include "../../Maze/inc/Clock.h"
+#include "../../Maze/inc/CortexM.h"
+#include "../../Maze/inc/Print_Format.h"
+
+// Time step of the world used by the delay functions in s
+#define SIM_HAL_DELAY_STEP      0.0005
+
+// Frequency of MCLK in Hz, used to convert the simulated time into cycles
+#define SIM_HAL_MCLK_FREQUENCY  48000000
+
+void Motor_Init()
+{
+    Sim_World_Set_Motors(0, 0);
+}
+
+void Motor_Forward(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
+{
+    Sim_World_Set_Motors(left_duty_cycle, right_duty_cycle);
+}
+
+void Motor_Backward(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
+{
+    Sim_World_Set_Motors(-(int32_t)left_duty_cycle, -(int32_t)right_duty_cycle);
+}
+
+void Motor_Left(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
+{
+    Sim_World_Set_Motors(-(int32_t)left_duty_cycle, right_duty_cycle);
+}
+
+void Motor_Right(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
+{
+    Sim_World_Set_Motors(left_duty_cycle, -(int32_t)right_duty_cycle);
+}
+
+void Motor_Stop()
+{
+    Sim_World_Set_Motors(0, 0);
+}
+
+void Motor_Drive(int16_t left_duty_cycle, int16_t right_duty_cycle)
+{
+    Sim_World_Set_Motors(left_duty_cycle, right_duty_cycle);
+}
+
+void Tachometer_Init()
+{
+}
+
+static enum Tachometer_Direction Sim_HAL_Tachometer_Direction(int8_t direction)
+{
+    if (direction > 0)
+    {
+        return FORWARD;
+    }
+    if (direction < 0)
+    {
+        return REVERSE;
+    }
+
+    return STOPPED;
+}
+
+void Tachometer_Get(uint16_t *left_tach,
+                    enum Tachometer_Direction *left_dir,
+                    int32_t *left_steps,
+                    uint16_t *right_tach,
+                    enum Tachometer_Direction *right_dir,
+                    int32_t *right_steps)
+{
+    Sim_World_Wheel left;
+    Sim_World_Wheel right;
+
+    Sim_World_Get_Wheels(&left, &right);
+
+    *left_tach = left.Period;
+    *left_dir = Sim_HAL_Tachometer_Direction(left.Direction);
+    *left_steps = left.Steps;
+    *right_tach = right.Period;
+    *right_dir = Sim_HAL_Tachometer_Direction(right.Direction);
+    *right_steps = right.Steps;
+}
+
+// Returns scale / period of a simulated wheel, signed by its direction, or 0 when it is stopped
+static int32_t Sim_HAL_Tachometer_Rate(const Sim_World_Wheel *wheel, uint32_t scale)
+{
+    int32_t rate;
+
+    if ((wheel->Period == 0) || (wheel->Period == 0xFFFF) || (wheel->Direction == 0))
+    {
+        return 0;
+    }
+
+    rate = (int32_t)(scale / wheel->Period);
+
+    return (wheel->Direction < 0) ? -rate : rate;
+}
+
+void Tachometer_Get_Speed(int16_t *left_speed, int16_t *right_speed)
+{
+    Sim_World_Wheel left;
+    Sim_World_Wheel right;
+
+    Sim_World_Get_Wheels(&left, &right);
+
+    *left_speed = (int16_t)Sim_HAL_Tachometer_Rate(&left, TACHOMETER_UM_PER_STEP * (TACHOMETER_CLOCK_HZ / 1000UL));
+    *right_speed = (int16_t)Sim_HAL_Tachometer_Rate(&right, TACHOMETER_UM_PER_STEP * (TACHOMETER_CLOCK_HZ / 1000UL));
+}
+
+void Tachometer_Get_RPM(int32_t *left_centi_rpm, int32_t *right_centi_rpm)
+{
+    Sim_World_Wheel left;
+    Sim_World_Wheel right;
+
+    Sim_World_Get_Wheels(&left, &right);
+
+    *left_centi_rpm = Sim_HAL_Tachometer_Rate(&left, (100UL * 60UL * TACHOMETER_CLOCK_HZ) / TACHOMETER_STEPS_PER_REVOLUTION);
+    *right_centi_rpm = Sim_HAL_Tachometer_Rate(&right, (100UL * 60UL * TACHOMETER_CLOCK_HZ) / TACHOMETER_STEPS_PER_REVOLUTION);
+}
+
+uint16_t Average_of_Buffer(uint16_t *buffer, int buffer_length)
+{
+    uint32_t sum = 0;
+    int i;
+
+    for (i = 0; i < buffer_length; i++)
+    {
+        sum = sum + buffer[i];
+    }
+
+    return (uint16_t)(sum / buffer_length);
+}
+
+void Analog_Distance_Sensor_Init()
+{
+}
+
+void Analog_Distance_Sensor_Start_Conversion(uint32_t *Ch_17, uint32_t *Ch_14, uint32_t *Ch_16)
+{
+    *Ch_17 = Sim_World_Read_Sensor(SIM_WORLD_SENSOR_RIGHT);
+    *Ch_14 = Sim_World_Read_Sensor(SIM_WORLD_SENSOR_CENTER);
+    *Ch_16 = Sim_World_Read_Sensor(SIM_WORLD_SENSOR_LEFT);
+}
+
+int32_t Analog_Distance_Sensor_Calibrate(int filtered_distance)
+{
+    // The firmware interpolates a table computed from the same formula
+    if (filtered_distance < ANALOG_DISTANCE_SENSOR_MAX)
+    {
+        return ANALOG_DISTANCE_SENSOR_OUT_OF_RANGE;
+    }
+
+    return (Ax / (filtered_distance + Bx)) + Cx;
+}
+
+void Analog_Distance_Sensor_Calibrate_All(const uint32_t *filtered, int32_t *converted)
+{
+    uint32_t channel;
+
+    for (channel = 0; channel < ANALOG_DISTANCE_SENSOR_NUM_CHANNELS; channel++)
+    {
+        converted[channel] = Analog_Distance_Sensor_Calibrate(filtered[channel]);
+    }
+}
+
+void Clock_Init48MHz(void)
+{
+}
+
+uint32_t Clock_GetFreq(void)
+{
+    return SIM_HAL_MCLK_FREQUENCY;
+}
+
+void Clock_Delay1ms(uint32_t n)
+{
+    Clock_Delay1us(n * 1000);
+}
+
+void Clock_Delay1us(uint32_t n)
+{
+    double end = Sim_World_Get_Time() + (n * 1e-6);
+
+    while (Sim_World_Get_Time() < end)
+    {
+        Sim_World_Step(SIM_HAL_DELAY_STEP);
+    }
+}
+
+void DisableInterrupts(void)
+{
+}
+
+void EnableInterrupts(void)
+{
+}
+
+long StartCritical(void)
+{
+    return 0;
+}
+
+void EndCritical(long sr)
+{
+    (void)sr;
+}
+
+void WaitForInterrupt(void)
+{
+}
+
+void CycleCounter_Init(void)
+{
+}
+
+uint32_t CycleCounter_Read(void)
+{
+    return (uint32_t)(uint64_t)(Sim_World_Get_Time() * SIM_HAL_MCLK_FREQUENCY);
+}
+
+void Print_Literal(const char *text, uint32_t length)
+{
+    fwrite(text, 1, length, stdout);
+}
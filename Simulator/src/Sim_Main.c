@@ -0,0 +1,818 @@
+/**
+ * @file Sim_Main.c
+ * @brief Main source code for the host simulator of the maze controllers.
+ *
+ * This file runs the controllers of the firmware (Controller.c) and the drivers they use
+ * (Motion, Odometry, Speed_Controller, Traction, Maze_Map, Route, LPF) against the Sim_World model,
+ * much faster than real time, and reports the result of every run.
+ *
+ * The timing of the firmware is reproduced:
+ *  - The world and the distance sensors are sampled every 0.5 ms (Timer A1 at 2 kHz), through the same
+ *    64-sample low-pass filter and calibration as Sample_Analog_Distance_Sensor.
+ *  - The control tick runs every 10 ms (SysTick at 100 Hz) in the order of Control_Task:
+ *    Odometry_Update, Route_Record_Update, Route_Replay_Update, Motion_Update, the controller, Speed_Controller_Update,
+ *    and Traction_Update.
+ *
+ * Algorithms (-a):
+ *  - right: Follow_Right_Wall, right wall follower from the start cell to a dead end.
+ *  - left:  Follow_Left_Wall, left wall follower from the start cell to a dead end.
+ *  - flood: Controller_2, flood-fill exploration from the start cell to the center of the maze. The goal cells of
+ *           Controller_2 are replaced with the center cells of the maze, so a lab maze smaller than the map is solved.
+ *  - speed: Route one and route two are recorded like in the firmware, with the maze-goal barcode in the center of
+ *           the goal cells, so a wall follower that passes there stops in the goal. The faster one of the routes that
+ *           ended in a goal cell is smoothed and replayed from the start cell, and only the replay is measured. The
+ *           replay fails ("off_route") if it stops before the end of its plan or in another cell than the route.
+ *  - turn:  Check of the turn primitive: the turns of Sim_Turn_Angles are executed with Motion_Turn in the start
+ *           cell, with the parameters of the wall followers. The run fails ("heading") if the heading of the world
+ *           model is more than SIM_TURN_MAX_ERROR degrees from the target heading after one of them.
+ *
+ * A run of the other algorithms fails ("no_progress") if the controller stops in the start cell, or after driving
+ * less than one cell (MAZE_CELL_SIZE), for example when a replay has no segments, and it stops in a dead end
+ * ("dead_end") if the controller stops elsewhere without having reached a goal cell. A run is only completed ("done")
+ * when it reaches a goal cell, and for the speed run when it also ends in the goal cell of its route. The dead-end
+ * stops are counted separately in the summary line.
+ *
+ * Cost of the control tick:
+ *  - The host time of every control tick is measured with the monotonic clock. The host is much faster than the
+ *    MSP432, so the values are only meaningful relative to a baseline measured on the same host.
+ *  - For the flood algorithm, the largest number of cells repaired by Maze_Map_Replan_Step in one tick is also
+ *    reported. This count does not depend on the host.
+ *
+ * Usage: maze_sim [options]
+ *  -a <algorithm> right, left, flood, speed or turn (default right)
+ *  -m <file>      Maze file, ASCII or packed map (default: a random maze generated from the maze seed)
+ *  -k <file>      Packed map known before the flood runs, imported into Controller_2 after Maze_Exploration_Init,
+ *                 for example a map explored by the robot and downloaded with the "map get" command
+ *  -g <seed>      Seed of the generated maze (default 1)
+ *  -n <runs>      Number of runs (default 1). Run i uses the noise seed + i, and the maze seed + i for a generated maze
+ *  -s <seed>      Seed of the sensor noise and of the wheel mismatch (default 1)
+ *  -t <seconds>   Time limit of a run in simulated seconds (default 120)
+ *  -f <format>    Output format: text or csv (default text)
+ *  -H             Print the header line of the csv format and exit
+ *  -p             Print the maze in the file format and exit
+ *  -o <file>      Write the maze as a packed map with every wall known and the center goal cells, and exit.
+ *                 The file can be sent to the robot with "map put" and loaded as a known competition maze
+ *  -v             Print the pose and the distances every 100 ms
+ *
+ * The exit status is 0 if every run completed, with the same rule as the summary line.
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include <math.h>
+#include "../inc/Sim_World.h"
+#include "../../Maze/inc/Controller.h"
+#include "../../Maze/inc/Analog_Distance_Sensors.h"
+#include "../../Maze/inc/LPF.h"
+#include "../../Maze/inc/Odometry.h"
+#include "../../Maze/inc/Speed_Controller.h"
+#include "../../Maze/inc/Traction.h"
+#include "../../Maze/inc/Maze_Map_Pack.h"
+
+// Sampling period of the distance sensors in s, and number of samples per control tick
+#define SIM_SAMPLE_PERIOD           0.0005
+#define SIM_SAMPLES_PER_TICK        20
+
+// Size of the low-pass filter of the distance sensors after the median-of-5 stage, the same as in main.c
+#define SIM_DISTANCE_SENSOR_LPF_SIZE    16
+
+// Time without movement that ends a run in s
+#define SIM_STUCK_TIMEOUT           10.0
+
+/**
+ * @brief Algorithms that can be benchmarked.
+ */
+typedef enum
+{
+    SIM_ALGORITHM_RIGHT,
+    SIM_ALGORITHM_LEFT,
+    SIM_ALGORITHM_FLOOD,
+    SIM_ALGORITHM_SPEED,
+    SIM_ALGORITHM_TURN,
+    SIM_NUM_ALGORITHMS
+} Sim_Algorithm;
+
+static const char *const Sim_Algorithm_Names[SIM_NUM_ALGORITHMS] = { "right", "left", "flood", "speed", "turn" };
+
+/**
+ * @brief Result of a simulation run.
+ */
+typedef enum
+{
+    SIM_RESULT_DONE,
+    SIM_RESULT_TIMEOUT,
+    SIM_RESULT_STUCK,
+    SIM_RESULT_HEADING,
+    SIM_RESULT_NO_PROGRESS,
+    SIM_RESULT_DEAD_END,
+    SIM_RESULT_OFF_ROUTE
+} Sim_Result;
+
+static const char *const Sim_Result_Names[] = { "done", "timeout", "stuck", "heading", "no_progress", "dead_end", "off_route" };
+
+/**
+ * @brief Measurements of a phase of a run.
+ */
+typedef struct
+{
+    Sim_Result Result;
+    double Time;
+    double Distance;
+    uint32_t Collisions;
+    int End_X;
+    int End_Y;
+    uint8_t Goal_Reached;
+    uint32_t Ticks;
+    double Tick_Total_ns;
+    double Tick_Max_ns;
+    uint16_t Replan_Max_Cells;
+    double Heading_Error_Max;
+} Sim_Stats;
+
+static const Route_Replay_Config Sim_Speed_Run_Config =
+{
+    MAZE_CELL_SIZE,
+    SPEED_RUN_MAX_SPEED,
+    SPEED_RUN_ACCELERATION,
+    SPEED_RUN_CELL_TIMEOUT_TICKS,
+    SPEED_RUN_TURN_DUTY_CYCLE,
+    SPEED_RUN_TURN_TIMEOUT_TICKS,
+    SPEED_RUN_ARC_RADIUS,
+    SPEED_RUN_ARC_SPEED,
+    FOLLOW_SIDE_SENSOR_OFFSET
+};
+
+static LPF_Median Sim_Distance_Sensor_Median;
+static LPF_Filter Sim_Distance_Sensor_LPF;
+static uint32_t Sim_Distance_Sensor_LPF_Buffer[LPF_BUFFER_LENGTH(SIM_DISTANCE_SENSOR_LPF_SIZE, ANALOG_DISTANCE_SENSOR_NUM_CHANNELS)];
+static int32_t Sim_Converted[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+static Route_Path Sim_Route_One_Path;
+static Route_Path Sim_Route_Two_Path;
+static Route_Plan Sim_Speed_Run_Plan;
+static int Sim_Verbose = 0;
+
+// Set when the strategy of the phase returns 1 at the end of the maze
+static uint8_t Sim_Strategy_Done = 0;
+
+// Set while the routes of the speed run are recorded: the maze-goal barcode lies in the center of the goal cells,
+// and is scanned when the robot is less than SIM_GOAL_BARCODE_RADIUS mm from it
+static uint8_t Sim_Goal_Barcode = 0;
+#define SIM_GOAL_BARCODE_RADIUS     (MAZE_CELL_SIZE / 4)
+
+// Turns of the turn algorithm in degrees (positive turns left), executed in the start cell with Motion_Turn
+static const int16_t Sim_Turn_Angles[] = { -90, 90, 90, -90, 180, -180 };
+#define SIM_TURN_NUM_ANGLES         (sizeof(Sim_Turn_Angles) / sizeof(Sim_Turn_Angles[0]))
+
+// Ticks without a command after a turn before its heading is measured, so the wheels have stopped
+#define SIM_TURN_SETTLE_TICKS       20
+
+// Largest error of the heading measured at the end of a turn in degrees, above which the turn check fails
+#ifndef SIM_TURN_MAX_ERROR
+#define SIM_TURN_MAX_ERROR          5.0
+#endif
+
+// Next turn of the turn algorithm, heading of the world at its start, and the largest error of the finished turns
+static uint32_t Sim_Turn_Index;
+static double Sim_Turn_Start_Heading;
+static double Sim_Turn_Error_Max;
+
+// Map known before the flood runs (-k) and its metadata, set when a map has been loaded
+static uint8_t Sim_Known_Map[MAZE_MAP_STORAGE_SIZE];
+static Maze_Map_Pack_Info Sim_Known_Info;
+static uint8_t Sim_Known_Map_Loaded = 0;
+
+static double Sim_Host_Time_ns()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec * 1e9) + now.tv_nsec;
+}
+
+static void Sim_Sample_Distance_Sensors()
+{
+    uint32_t raw[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+    uint32_t filtered[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+
+    Analog_Distance_Sensor_Start_Conversion(&raw[0], &raw[1], &raw[2]);
+    LPF_Median_Calc_All(&Sim_Distance_Sensor_Median, raw, raw);
+    LPF_Filter_Calc_All(&Sim_Distance_Sensor_LPF, raw, filtered);
+    Analog_Distance_Sensor_Calibrate_All(filtered, Sim_Converted);
+}
+
+// Executes the turns of the turn algorithm and measures the heading error of each of them with the world model
+static uint8_t Sim_Turn_Step()
+{
+    Sim_World_Pose pose;
+    double error;
+    int16_t angle;
+
+    if (Motion_Is_Busy())
+    {
+        return 0;
+    }
+
+    Sim_World_Get_Pose(&pose);
+    if (Sim_Turn_Index > 0)
+    {
+        // Wrap the error to -180 to 180 degrees
+        error = ((pose.Heading - Sim_Turn_Start_Heading) * 57.29578) - Sim_Turn_Angles[Sim_Turn_Index - 1];
+        error = error - (360.0 * floor((error + 180.0) / 360.0));
+        if (fabs(error) > Sim_Turn_Error_Max)
+        {
+            Sim_Turn_Error_Max = fabs(error);
+        }
+        if (Sim_Verbose)
+        {
+            printf("  turn %d: error=%.1f deg\n", Sim_Turn_Angles[Sim_Turn_Index - 1], error);
+        }
+    }
+
+    if (Sim_Turn_Index >= SIM_TURN_NUM_ANGLES)
+    {
+        return 1;
+    }
+
+    angle = Sim_Turn_Angles[Sim_Turn_Index];
+    Sim_Turn_Start_Heading = pose.Heading;
+    Motion_Turn(angle, TURN_DUTY_CYCLE, TURN_TIMEOUT_TICKS);
+    Motion_Stop(SIM_TURN_SETTLE_TICKS);
+    Sim_Turn_Index = Sim_Turn_Index + 1;
+
+    return 0;
+}
+
+static void Sim_Control_Tick(Sim_Algorithm algorithm)
+{
+    Odometry_Update();
+    Route_Record_Update();
+    Route_Replay_Update();
+    Motion_Update();
+
+    // Channel order of the ADC: right, center, left
+    Converted_Distance_Right = Sim_Converted[0];
+    Converted_Distance_Center = Sim_Converted[1];
+    Converted_Distance_Left = Sim_Converted[2];
+    Junction_Update(Converted_Distance_Left, Converted_Distance_Center, Converted_Distance_Right, Desired_Distance);
+
+    // The speed run only replays the plan, like the firmware once every trial of the race is done
+    if (algorithm == SIM_ALGORITHM_FLOOD)
+    {
+        Sim_Strategy_Done = Maze_Exploration_Step();
+    }
+    else if (algorithm == SIM_ALGORITHM_RIGHT)
+    {
+        Sim_Strategy_Done = Follow_Right_Wall();
+    }
+    else if (algorithm == SIM_ALGORITHM_LEFT)
+    {
+        Sim_Strategy_Done = Follow_Left_Wall();
+    }
+    else if (algorithm == SIM_ALGORITHM_TURN)
+    {
+        Sim_Strategy_Done = Sim_Turn_Step();
+    }
+
+    Speed_Controller_Update();
+    Traction_Update();
+}
+
+static uint8_t Sim_Is_Goal_Cell(int x, int y)
+{
+    uint8_t width;
+    uint8_t height;
+
+    Sim_World_Get_Size(&width, &height);
+
+    return ((x == ((width / 2) - 1)) || (x == (width / 2))) && ((y == ((height / 2) - 1)) || (y == (height / 2)));
+}
+
+static uint8_t Sim_Phase_Is_Done(Sim_Algorithm algorithm)
+{
+    switch (algorithm)
+    {
+        case SIM_ALGORITHM_SPEED: return (Route_Replay_Is_Active() == 0);
+        default:                  return Sim_Strategy_Done;
+    }
+}
+
+static void Sim_Start(uint32_t seed)
+{
+    uint32_t raw[ANALOG_DISTANCE_SENSOR_NUM_CHANNELS];
+
+    Sim_World_Reset(seed);
+
+    Motor_Init();
+    Tachometer_Init();
+    Odometry_Init();
+    Motion_Init();
+    Speed_Controller_Init();
+    Traction_Init();
+    Controller_Init();
+    Junction_Init();
+
+    Analog_Distance_Sensor_Start_Conversion(&raw[0], &raw[1], &raw[2]);
+    LPF_Filter_Init(&Sim_Distance_Sensor_LPF, Sim_Distance_Sensor_LPF_Buffer, SIM_DISTANCE_SENSOR_LPF_SIZE,
+                    ANALOG_DISTANCE_SENSOR_NUM_CHANNELS, raw);
+    LPF_Median_Init(&Sim_Distance_Sensor_Median, ANALOG_DISTANCE_SENSOR_NUM_CHANNELS, raw);
+    Analog_Distance_Sensor_Calibrate_All(raw, Sim_Converted);
+}
+
+static void Sim_Return_To_Start()
+{
+    // The robot is carried back to the start cell, like between the routes in the firmware
+    Sim_World_Place(0, 0, 0);
+    Odometry_Init();
+    Motion_Init();
+    Speed_Controller_Disable();
+    Follow_Wall_Restart();
+}
+
+static void Sim_Run_Phase(Sim_Algorithm algorithm, double time_limit, Sim_Stats *stats)
+{
+    Sim_World_Pose pose;
+    Sim_World_Pose last_pose;
+    double start_time = Sim_World_Get_Time();
+    double start_distance = Sim_World_Get_Distance();
+    uint32_t start_collisions = Sim_World_Get_Collisions();
+    double last_move_time = start_time;
+    double tick_start;
+    double tick_ns;
+    uint32_t sample = 0;
+    int x;
+    int y;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->Result = SIM_RESULT_TIMEOUT;
+    Sim_Strategy_Done = 0;
+    Sim_World_Get_Pose(&last_pose);
+
+    while ((Sim_World_Get_Time() - start_time) < time_limit)
+    {
+        Sim_World_Step(SIM_SAMPLE_PERIOD);
+        Sim_Sample_Distance_Sensors();
+        sample = sample + 1;
+
+        Sim_World_Get_Cell(&x, &y);
+        if (Sim_Is_Goal_Cell(x, y))
+        {
+            stats->Goal_Reached = 1;
+
+            // Like Barcode_Maze_Goal, executed by the interrupt of the barcode scanner
+            Sim_World_Get_Pose(&pose);
+            if (Sim_Goal_Barcode && (Maze_Goal_Reached == 0) &&
+                (hypot(pose.X - ((x + 0.5) * MAZE_CELL_SIZE), pose.Y - ((y + 0.5) * MAZE_CELL_SIZE)) < SIM_GOAL_BARCODE_RADIUS))
+            {
+                Motor_Stop();
+                Maze_Goal_Reached = 1;
+            }
+        }
+
+        if ((sample % SIM_SAMPLES_PER_TICK) != 0)
+        {
+            continue;
+        }
+
+        tick_start = Sim_Host_Time_ns();
+        Sim_Control_Tick(algorithm);
+        tick_ns = Sim_Host_Time_ns() - tick_start;
+
+        stats->Ticks = stats->Ticks + 1;
+        stats->Tick_Total_ns = stats->Tick_Total_ns + tick_ns;
+        if (tick_ns > stats->Tick_Max_ns)
+        {
+            stats->Tick_Max_ns = tick_ns;
+        }
+        if ((algorithm == SIM_ALGORITHM_FLOOD) && (Maze_Map_Get_Last_Update_Cells() > stats->Replan_Max_Cells))
+        {
+            stats->Replan_Max_Cells = Maze_Map_Get_Last_Update_Cells();
+        }
+
+        Sim_World_Get_Pose(&pose);
+        if (Sim_Verbose && ((sample % (10 * SIM_SAMPLES_PER_TICK)) == 0))
+        {
+            printf("  t=%7.2f x=%7.1f y=%7.1f heading=%6.1f L=%4d C=%4d R=%4d cell=(%d,%d)\n", Sim_World_Get_Time(),
+                   pose.X, pose.Y, pose.Heading * 57.29578, Converted_Distance_Left, Converted_Distance_Center,
+                   Converted_Distance_Right, x, y);
+        }
+
+        if (Sim_Phase_Is_Done(algorithm))
+        {
+            stats->Result = SIM_RESULT_DONE;
+            break;
+        }
+
+        // A robot that neither moves nor turns will not complete the run
+        if ((pose.X != last_pose.X) || (pose.Y != last_pose.Y) || (pose.Heading != last_pose.Heading))
+        {
+            last_move_time = Sim_World_Get_Time();
+            last_pose = pose;
+        }
+        else if ((Sim_World_Get_Time() - last_move_time) > SIM_STUCK_TIMEOUT)
+        {
+            stats->Result = SIM_RESULT_STUCK;
+            break;
+        }
+    }
+
+    Motor_Stop();
+
+    stats->Time = Sim_World_Get_Time() - start_time;
+    stats->Distance = Sim_World_Get_Distance() - start_distance;
+    stats->Collisions = Sim_World_Get_Collisions() - start_collisions;
+    Sim_World_Get_Cell(&stats->End_X, &stats->End_Y);
+
+    // A controller that stops in the start cell, or before it has driven one cell, has not explored anything
+    // Note: The turn check pivots in the start cell on purpose
+    if ((stats->Result == SIM_RESULT_DONE) && (algorithm != SIM_ALGORITHM_TURN) &&
+        (((stats->End_X == 0) && (stats->End_Y == 0)) || (stats->Distance < MAZE_CELL_SIZE)))
+    {
+        stats->Result = SIM_RESULT_NO_PROGRESS;
+    }
+    else if ((stats->Result == SIM_RESULT_DONE) && (algorithm != SIM_ALGORITHM_TURN) && (stats->Goal_Reached == 0))
+    {
+        stats->Result = SIM_RESULT_DEAD_END;
+    }
+}
+
+static int Sim_Load_Known_Map(const char *path)
+{
+    uint8_t buffer[MAZE_MAP_PACK_MAX_SIZE];
+    size_t length;
+    FILE *file;
+
+    file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    length = fread(buffer, 1, sizeof(buffer), file);
+    fclose(file);
+
+    if (Maze_Map_Pack_Decode(buffer, (uint16_t)length, Sim_Known_Map, &Sim_Known_Info) < 0)
+    {
+        return -1;
+    }
+    Sim_Known_Map_Loaded = 1;
+
+    return 0;
+}
+
+// Replaces the map of Controller_2 with the known map, and its goal cells if it has any, like the "map load" command
+static void Sim_Import_Known_Map()
+{
+    uint8_t i;
+
+    if (Sim_Known_Info.Num_Goals > 0)
+    {
+        Maze_Map_Clear_Goals();
+        for (i = 0; i < Sim_Known_Info.Num_Goals; i++)
+        {
+            Maze_Map_Add_Goal(Sim_Known_Info.Goal_X[i], Sim_Known_Info.Goal_Y[i]);
+        }
+    }
+    Maze_Exploration_Import(Sim_Known_Map);
+}
+
+static int Sim_Save_Packed_Maze(const char *path, const char *name)
+{
+    uint8_t map[MAZE_MAP_STORAGE_SIZE];
+    uint8_t buffer[MAZE_MAP_PACK_MAX_SIZE];
+    Maze_Map_Pack_Info info;
+    FILE *file;
+    int length;
+    int x;
+    int y;
+
+    Sim_World_Export_Map(map);
+    Sim_World_Get_Size(&info.Width, &info.Height);
+    info.Flags = MAZE_MAP_PACK_FLAG_COMPLETE;
+    info.Num_Goals = 0;
+    for (y = 0; y < info.Height; y++)
+    {
+        for (x = 0; x < info.Width; x++)
+        {
+            if (Sim_Is_Goal_Cell(x, y) && (info.Num_Goals < MAZE_MAP_MAX_GOALS))
+            {
+                info.Goal_X[info.Num_Goals] = (uint8_t)x;
+                info.Goal_Y[info.Num_Goals] = (uint8_t)y;
+                info.Num_Goals++;
+            }
+        }
+    }
+    memset(info.Name, 0, sizeof(info.Name));
+    memcpy(info.Name, name, strnlen(name, sizeof(info.Name)));
+
+    length = Maze_Map_Pack_Encode(map, &info, buffer, sizeof(buffer));
+    if (length < 0)
+    {
+        return -1;
+    }
+
+    file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    if (fwrite(buffer, 1, length, file) != (size_t)length)
+    {
+        fclose(file);
+        return -1;
+    }
+
+    return (fclose(file) == 0) ? 0 : -1;
+}
+
+// Replaces the goal cells of Controller_2 with the center cells of the world, which are the center cells of the map
+// only for a 16 x 16 maze, like the goal cells written with the packed map of -o
+static void Sim_Set_Goal_Cells()
+{
+    uint8_t width;
+    uint8_t height;
+    int x;
+    int y;
+
+    Sim_World_Get_Size(&width, &height);
+    Maze_Map_Clear_Goals();
+    for (y = 0; y < height; y++)
+    {
+        for (x = 0; x < width; x++)
+        {
+            if (Sim_Is_Goal_Cell(x, y))
+            {
+                Maze_Map_Add_Goal((uint8_t)x, (uint8_t)y);
+            }
+        }
+    }
+    Maze_Map_Flood_Fill();
+}
+
+static void Sim_Run(Sim_Algorithm algorithm, double time_limit, uint32_t seed, Sim_Stats *stats)
+{
+    Sim_Stats route_one;
+    Sim_Stats route_two;
+    const Sim_Stats *route;
+
+    Sim_Start(seed);
+
+    switch (algorithm)
+    {
+        case SIM_ALGORITHM_FLOOD:
+        {
+            Maze_Exploration_Init();
+            Sim_Set_Goal_Cells();
+            if (Sim_Known_Map_Loaded)
+            {
+                Sim_Import_Known_Map();
+            }
+            Sim_Run_Phase(SIM_ALGORITHM_FLOOD, time_limit, stats);
+        }
+        break;
+
+        case SIM_ALGORITHM_LEFT:
+        {
+            Sim_Run_Phase(SIM_ALGORITHM_LEFT, time_limit, stats);
+        }
+        break;
+
+        case SIM_ALGORITHM_SPEED:
+        {
+            // Record both routes, the speed run replays the faster one
+            Sim_Goal_Barcode = 1;
+            Route_Record_Start(&Sim_Route_One_Path, MAZE_CELL_SIZE);
+            Sim_Run_Phase(SIM_ALGORITHM_RIGHT, time_limit, &route_one);
+            Route_Record_Stop();
+
+            Sim_Return_To_Start();
+            Route_Record_Start(&Sim_Route_Two_Path, MAZE_CELL_SIZE);
+            Sim_Run_Phase(SIM_ALGORITHM_LEFT, time_limit, &route_two);
+            Route_Record_Stop();
+            Sim_Goal_Barcode = 0;
+
+            // Only a route that ends in a goal cell is replayed, a route that stopped elsewhere does not solve the maze
+            if ((route_one.Result != SIM_RESULT_DONE) && (route_two.Result != SIM_RESULT_DONE))
+            {
+                *stats = (route_one.Result == SIM_RESULT_DEAD_END) ? route_two : route_one;
+                return;
+            }
+            if ((route_one.Result != SIM_RESULT_DONE) ||
+                ((route_two.Result == SIM_RESULT_DONE) && (route_two.Time < route_one.Time)))
+            {
+                route = &route_two;
+                Route_Smooth(&Sim_Route_Two_Path, &Sim_Speed_Run_Config, &Sim_Speed_Run_Plan);
+            }
+            else
+            {
+                route = &route_one;
+                Route_Smooth(&Sim_Route_One_Path, &Sim_Speed_Run_Config, &Sim_Speed_Run_Plan);
+            }
+
+            Sim_Return_To_Start();
+            Route_Replay_Start(&Sim_Speed_Run_Plan, &Sim_Speed_Run_Config);
+            Sim_Run_Phase(SIM_ALGORITHM_SPEED, time_limit, stats);
+
+            // The replay must follow its route to the end, passing a goal cell on the way is not enough
+            if ((stats->Result == SIM_RESULT_DONE) &&
+                ((Route_Replay_Is_Complete() == 0) || (stats->End_X != route->End_X) || (stats->End_Y != route->End_Y)))
+            {
+                stats->Result = SIM_RESULT_OFF_ROUTE;
+            }
+        }
+        break;
+
+        case SIM_ALGORITHM_TURN:
+        {
+            Sim_Turn_Index = 0;
+            Sim_Turn_Error_Max = 0.0;
+            Sim_Run_Phase(SIM_ALGORITHM_TURN, time_limit, stats);
+            stats->Heading_Error_Max = Sim_Turn_Error_Max;
+            if ((stats->Result == SIM_RESULT_DONE) && (Sim_Turn_Error_Max > SIM_TURN_MAX_ERROR))
+            {
+                stats->Result = SIM_RESULT_HEADING;
+            }
+        }
+        break;
+
+        default:
+        {
+            Sim_Run_Phase(SIM_ALGORITHM_RIGHT, time_limit, stats);
+        }
+        break;
+    }
+}
+
+static void Sim_Print_Csv_Header()
+{
+    printf("maze,algorithm,seed,result,time_s,distance_mm,collisions,end_x,end_y,goal,ticks,"
+           "tick_mean_ns,tick_max_ns,replan_max_cells,heading_error_deg\n");
+}
+
+static void Sim_Print_Stats(int csv, const char *maze, Sim_Algorithm algorithm, uint32_t seed, int run, const Sim_Stats *stats)
+{
+    double tick_mean = (stats->Ticks > 0) ? (stats->Tick_Total_ns / stats->Ticks) : 0.0;
+
+    if (csv)
+    {
+        printf("%s,%s,%u,%s,%.2f,%.0f,%u,%d,%d,%d,%u,%.0f,%.0f,%u,%.1f\n", maze, Sim_Algorithm_Names[algorithm], seed,
+               Sim_Result_Names[stats->Result], stats->Time, stats->Distance, stats->Collisions, stats->End_X,
+               stats->End_Y, stats->Goal_Reached, stats->Ticks, tick_mean, stats->Tick_Max_ns, stats->Replan_Max_Cells,
+               stats->Heading_Error_Max);
+    }
+    else
+    {
+        printf("run %d: %s time=%.2f s distance=%.0f mm collisions=%u end=(%d,%d) goal=%s tick=%.0f/%.0f ns",
+               run, Sim_Result_Names[stats->Result], stats->Time, stats->Distance, stats->Collisions,
+               stats->End_X, stats->End_Y, stats->Goal_Reached ? "yes" : "no", tick_mean, stats->Tick_Max_ns);
+        if (algorithm == SIM_ALGORITHM_FLOOD)
+        {
+            printf(" replan=%u cells", stats->Replan_Max_Cells);
+        }
+        if (algorithm == SIM_ALGORITHM_TURN)
+        {
+            printf(" heading_error=%.1f deg", stats->Heading_Error_Max);
+        }
+        printf("\n");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *maze_file = NULL;
+    const char *known_file = NULL;
+    const char *packed_file = NULL;
+    const char *packed_name;
+    const char *maze_name;
+    char generated_name[32];
+    Sim_Algorithm algorithm = SIM_ALGORITHM_RIGHT;
+    uint32_t maze_seed = 1;
+    uint32_t seed = 1;
+    double time_limit = 120.0;
+    int runs = 1;
+    int csv = 0;
+    int print_maze = 0;
+    int completed = 0;
+    int dead_ends = 0;
+    double total_time = 0.0;
+    uint32_t total_collisions = 0;
+    Sim_Stats stats;
+    int option;
+    int run;
+    int i;
+
+    while ((option = getopt(argc, argv, "a:m:k:g:n:s:t:f:Hpo:v")) != -1)
+    {
+        switch (option)
+        {
+            case 'a':
+            {
+                for (i = 0; (i < SIM_NUM_ALGORITHMS) && (strcmp(optarg, Sim_Algorithm_Names[i]) != 0); i++);
+                if (i == SIM_NUM_ALGORITHMS)
+                {
+                    fprintf(stderr, "Unknown algorithm %s\n", optarg);
+                    return 2;
+                }
+                algorithm = (Sim_Algorithm)i;
+            }
+            break;
+
+            case 'm': maze_file = optarg; break;
+            case 'k': known_file = optarg; break;
+            case 'g': maze_seed = strtoul(optarg, NULL, 0); break;
+            case 'n': runs = atoi(optarg); break;
+            case 's': seed = strtoul(optarg, NULL, 0); break;
+            case 't': time_limit = atof(optarg); break;
+            case 'f': csv = (strcmp(optarg, "csv") == 0); break;
+            case 'H': Sim_Print_Csv_Header(); return 0;
+            case 'p': print_maze = 1; break;
+            case 'o': packed_file = optarg; break;
+            case 'v': Sim_Verbose = 1; break;
+            default:
+                fprintf(stderr, "Usage: %s [-a right|left|flood|speed|turn] [-m maze] [-k known_map] [-g maze_seed] [-n runs] [-s seed] "
+                        "[-t seconds] [-f text|csv] [-H] [-p] [-o packed_map] [-v]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    Sim_World_Set_Cell_Size(MAZE_CELL_SIZE);
+
+    if ((maze_file != NULL) && (Sim_World_Load_Maze(maze_file) != 0))
+    {
+        fprintf(stderr, "Cannot load the maze %s\n", maze_file);
+        return 2;
+    }
+
+    if ((known_file != NULL) && (Sim_Load_Known_Map(known_file) != 0))
+    {
+        fprintf(stderr, "Cannot load the packed map %s\n", known_file);
+        return 2;
+    }
+
+    if (print_maze || (packed_file != NULL))
+    {
+        if (maze_file == NULL)
+        {
+            Sim_World_Generate_Maze(SIM_WORLD_MAX_SIZE, SIM_WORLD_MAX_SIZE, maze_seed);
+            snprintf(generated_name, sizeof(generated_name), "gen-%u", maze_seed);
+            packed_name = generated_name;
+        }
+        else
+        {
+            // The name of the file without its directory
+            packed_name = strrchr(maze_file, '/');
+            packed_name = (packed_name != NULL) ? (packed_name + 1) : maze_file;
+        }
+
+        if (print_maze)
+        {
+            Sim_World_Print_Maze(stdout);
+        }
+        if ((packed_file != NULL) && (Sim_Save_Packed_Maze(packed_file, packed_name) != 0))
+        {
+            fprintf(stderr, "Cannot write the packed map %s\n", packed_file);
+            return 2;
+        }
+        return 0;
+    }
+
+    for (run = 0; run < runs; run++)
+    {
+        if (maze_file == NULL)
+        {
+            Sim_World_Generate_Maze(SIM_WORLD_MAX_SIZE, SIM_WORLD_MAX_SIZE, maze_seed + run);
+            snprintf(generated_name, sizeof(generated_name), "generated-%u", maze_seed + run);
+            maze_name = generated_name;
+        }
+        else
+        {
+            maze_name = maze_file;
+        }
+
+        Sim_Run(algorithm, time_limit, seed + run, &stats);
+        Sim_Print_Stats(csv, maze_name, algorithm, seed + run, run, &stats);
+
+        if (stats.Result == SIM_RESULT_DONE)
+        {
+            completed = completed + 1;
+            total_time = total_time + stats.Time;
+        }
+        else if (stats.Result == SIM_RESULT_DEAD_END)
+        {
+            dead_ends = dead_ends + 1;
+        }
+        total_collisions = total_collisions + stats.Collisions;
+    }
+
+    if (csv == 0)
+    {
+        printf("completed %d/%d runs, %d dead-end stops, mean time %.2f s, %u collisions\n", completed, runs, dead_ends,
+               (completed > 0) ? (total_time / completed) : 0.0, total_collisions);
+    }
+
+    return (completed == runs) ? 0 : 1;
+}
@@ -0,0 +1,713 @@
+/**
+ * @file Sim_World.c
+ * @brief Source code for the Sim_World module.
+ *
+ * This file contains the function definitions for the 2D world model of the host simulator.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "../inc/Sim_World.h"
+#include "../../Maze/inc/Maze_Map_Pack.h"
+
+// Mounting position of the sensors relative to the center of the robot in mm (forward, left) and their direction
+static const double Sim_World_Sensor_Forward[SIM_WORLD_NUM_SENSORS] = { 50.0, 80.0, 50.0 };
+static const double Sim_World_Sensor_Left[SIM_WORLD_NUM_SENSORS]    = { -40.0, 0.0, 40.0 };
+static const double Sim_World_Sensor_Angle[SIM_WORLD_NUM_SENSORS]   = { -M_PI / 2.0, 0.0, M_PI / 2.0 };
+
+// Range of the ray cast in mm, beyond the range of the Sharp GP2Y0A21YK0F
+#define SIM_WORLD_SENSOR_MAX_RANGE      1500.0
+
+// Distance of the peak output of the Sharp sensor in mm, the output decreases again for a closer wall
+#define SIM_WORLD_SENSOR_MIN_RANGE      80.0
+
+// Calibration of the Sharp sensors, the inverse of the formula of the Analog_Distance_Sensors driver
+#define SIM_WORLD_SENSOR_A              1195159.0
+#define SIM_WORLD_SENSOR_B              -1058.0
+#define SIM_WORLD_SENSOR_C              40.0
+
+// Clearance from the walls in mm that ends a contact
+#define SIM_WORLD_CONTACT_CLEARANCE     5.0
+
+// Sampling period of a tachometer period in s (83.3 ns)
+#define SIM_WORLD_TACH_TICKS_PER_S      12000000.0
+
+// Wall bits of the maze, one byte per cell with the same layout as the Maze_Map driver
+static uint8_t Sim_World_Walls[SIM_WORLD_MAX_SIZE][SIM_WORLD_MAX_SIZE];
+static uint8_t Sim_World_Width = SIM_WORLD_MAX_SIZE;
+static uint8_t Sim_World_Height = SIM_WORLD_MAX_SIZE;
+static double Sim_World_Cell = SIM_WORLD_CELL_SIZE;
+
+// State of a wheel: speed in mm/s, traveled distance in mm, and tachometer state
+typedef struct
+{
+    int32_t Duty_Cycle;
+    double Gain;
+    double Speed;
+    double Distance;
+    double Last_Step_Time;
+    Sim_World_Wheel Tach;
+} Sim_World_Wheel_State;
+
+static Sim_World_Wheel_State Sim_World_Left_Wheel;
+static Sim_World_Wheel_State Sim_World_Right_Wheel;
+static Sim_World_Pose Sim_World_Robot;
+static double Sim_World_Time;
+static double Sim_World_Traveled;
+static uint32_t Sim_World_Collisions;
+static uint8_t Sim_World_In_Contact;
+static uint32_t Sim_World_Random_State = 1;
+
+static const int Sim_World_DX[4] = { 0, 1, 0, -1 };
+static const int Sim_World_DY[4] = { 1, 0, -1, 0 };
+
+static uint32_t Sim_World_Random()
+{
+    // Xorshift32, so a seed gives the same run on every host
+    Sim_World_Random_State ^= Sim_World_Random_State << 13;
+    Sim_World_Random_State ^= Sim_World_Random_State >> 17;
+    Sim_World_Random_State ^= Sim_World_Random_State << 5;
+    return Sim_World_Random_State;
+}
+
+static void Sim_World_Seed(uint32_t seed)
+{
+    Sim_World_Random_State = (seed != 0) ? seed : 0x9E3779B9;
+}
+
+static double Sim_World_Uniform()
+{
+    return (Sim_World_Random() + 0.5) / 4294967296.0;
+}
+
+static double Sim_World_Gaussian()
+{
+    return sqrt(-2.0 * log(Sim_World_Uniform())) * cos(2.0 * M_PI * Sim_World_Uniform());
+}
+
+static void Sim_World_Set_Wall(int x, int y, uint8_t direction, uint8_t present)
+{
+    int nx = x + Sim_World_DX[direction];
+    int ny = y + Sim_World_DY[direction];
+
+    if (present)
+    {
+        Sim_World_Walls[x][y] |= (1 << direction);
+    }
+    else
+    {
+        Sim_World_Walls[x][y] &= ~(1 << direction);
+    }
+
+    if ((nx >= 0) && (nx < Sim_World_Width) && (ny >= 0) && (ny < Sim_World_Height))
+    {
+        if (present)
+        {
+            Sim_World_Walls[nx][ny] |= (1 << ((direction + 2) & 0x3));
+        }
+        else
+        {
+            Sim_World_Walls[nx][ny] &= ~(1 << ((direction + 2) & 0x3));
+        }
+    }
+}
+
+static void Sim_World_Close_All(uint8_t width, uint8_t height)
+{
+    Sim_World_Width = width;
+    Sim_World_Height = height;
+    memset(Sim_World_Walls, 0x0F, sizeof(Sim_World_Walls));
+}
+
+void Sim_World_Generate_Maze(uint8_t width, uint8_t height, uint32_t seed)
+{
+    uint8_t visited[SIM_WORLD_MAX_SIZE][SIM_WORLD_MAX_SIZE];
+    uint8_t stack_x[SIM_WORLD_MAX_SIZE * SIM_WORLD_MAX_SIZE];
+    uint8_t stack_y[SIM_WORLD_MAX_SIZE * SIM_WORLD_MAX_SIZE];
+    uint8_t options[4];
+    int depth = 0;
+    int count;
+    int x;
+    int y;
+    int d;
+    int cx;
+    int cy;
+
+    if ((width == 0) || (width > SIM_WORLD_MAX_SIZE) || (height == 0) || (height > SIM_WORLD_MAX_SIZE))
+    {
+        width = SIM_WORLD_MAX_SIZE;
+        height = SIM_WORLD_MAX_SIZE;
+    }
+
+    Sim_World_Close_All(width, height);
+    Sim_World_Seed(seed);
+    memset(visited, 0, sizeof(visited));
+
+    // Depth-first carving from the start cell gives a perfect maze (one path between two cells)
+    stack_x[0] = 0;
+    stack_y[0] = 0;
+    visited[0][0] = 1;
+    depth = 1;
+
+    while (depth > 0)
+    {
+        x = stack_x[depth - 1];
+        y = stack_y[depth - 1];
+
+        count = 0;
+        for (d = 0; d < 4; d++)
+        {
+            cx = x + Sim_World_DX[d];
+            cy = y + Sim_World_DY[d];
+            if ((cx >= 0) && (cx < width) && (cy >= 0) && (cy < height) && (visited[cx][cy] == 0))
+            {
+                options[count] = d;
+                count = count + 1;
+            }
+        }
+
+        if (count == 0)
+        {
+            depth = depth - 1;
+            continue;
+        }
+
+        d = options[Sim_World_Random() % count];
+        Sim_World_Set_Wall(x, y, d, 0);
+        cx = x + Sim_World_DX[d];
+        cy = y + Sim_World_DY[d];
+        visited[cx][cy] = 1;
+        stack_x[depth] = cx;
+        stack_y[depth] = cy;
+        depth = depth + 1;
+    }
+
+    // Open the inside of the 2 x 2 goal area in the center, like a competition maze
+    if (((width & 0x1) == 0) && ((height & 0x1) == 0) && (width >= 2) && (height >= 2))
+    {
+        cx = (width / 2) - 1;
+        cy = (height / 2) - 1;
+        Sim_World_Set_Wall(cx, cy, 0, 0);
+        Sim_World_Set_Wall(cx, cy, 1, 0);
+        Sim_World_Set_Wall(cx + 1, cy + 1, 2, 0);
+        Sim_World_Set_Wall(cx + 1, cy + 1, 3, 0);
+    }
+}
+
+#if (SIM_WORLD_MAX_SIZE > MAZE_MAP_WIDTH) || (SIM_WORLD_MAX_SIZE > MAZE_MAP_HEIGHT)
+#error "A maze of the world model must fit in the maze map of the firmware"
+#endif
+
+static int Sim_World_Load_Packed_Maze(const uint8_t *buffer, uint16_t length)
+{
+    uint8_t map[MAZE_MAP_STORAGE_SIZE];
+    Maze_Map_Pack_Info info;
+    uint8_t index;
+    int x;
+    int y;
+
+    if (Maze_Map_Pack_Decode(buffer, length, map, &info) < 0)
+    {
+        return -1;
+    }
+
+    // The cells outside of the maze are closed, so the border walls are set
+    Sim_World_Close_All(info.Width, info.Height);
+    for (y = 0; y < info.Height; y++)
+    {
+        for (x = 0; x < info.Width; x++)
+        {
+            index = MAZE_MAP_CELL_INDEX(x, y);
+            Sim_World_Walls[x][y] = (index & 0x01) ? (map[index >> 1] >> 4) : (map[index >> 1] & 0x0F);
+        }
+    }
+
+    return 0;
+}
+
+int Sim_World_Load_Maze(const char *path)
+{
+    char lines[(2 * SIM_WORLD_MAX_SIZE) + 1][(4 * SIM_WORLD_MAX_SIZE) + 8];
+    uint8_t packed[MAZE_MAP_PACK_MAX_SIZE];
+    FILE *file;
+    int rows = 0;
+    int width;
+    int height;
+    int length;
+    int x;
+    int y;
+    int row;
+
+    file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    // The ASCII format starts with a comment or a '+' post, never with the magic bytes of a packed map
+    length = fread(packed, 1, sizeof(packed), file);
+    if ((length >= 2) && (packed[0] == MAZE_MAP_PACK_MAGIC_0) && (packed[1] == MAZE_MAP_PACK_MAGIC_1))
+    {
+        fclose(file);
+        return Sim_World_Load_Packed_Maze(packed, (uint16_t)length);
+    }
+    rewind(file);
+
+    while ((rows < ((2 * SIM_WORLD_MAX_SIZE) + 1)) && (fgets(lines[rows], sizeof(lines[rows]), file) != NULL))
+    {
+        length = strlen(lines[rows]);
+        while ((length > 0) && ((lines[rows][length - 1] == '\n') || (lines[rows][length - 1] == '\r')))
+        {
+            length = length - 1;
+        }
+        lines[rows][length] = '\0';
+
+        // Skip the blank lines and the comments before the maze
+        if ((rows == 0) && (lines[0][0] != '+'))
+        {
+            continue;
+        }
+        rows = rows + 1;
+    }
+    fclose(file);
+
+    length = strlen(lines[0]);
+    width = (length - 1) / 4;
+    height = (rows - 1) / 2;
+    if ((rows < 3) || (width < 1) || (width > SIM_WORLD_MAX_SIZE) || (height > SIM_WORLD_MAX_SIZE))
+    {
+        return -1;
+    }
+
+    Sim_World_Close_All(width, height);
+
+    // Row 0 of the file is the north border, cell row y is drawn in file row 2 * (height - y) - 1
+    for (y = 0; y < height; y++)
+    {
+        row = (2 * (height - y)) - 1;
+        for (x = 0; x < width; x++)
+        {
+            if (((int)strlen(lines[row - 1]) > ((4 * x) + 2)) && (lines[row - 1][(4 * x) + 2] == ' '))
+            {
+                Sim_World_Set_Wall(x, y, 0, 0);
+            }
+            if (((int)strlen(lines[row]) > (4 * (x + 1))) && (lines[row][4 * (x + 1)] == ' '))
+            {
+                Sim_World_Set_Wall(x, y, 1, 0);
+            }
+        }
+    }
+
+    // The file cannot open the border
+    for (x = 0; x < width; x++)
+    {
+        Sim_World_Set_Wall(x, height - 1, 0, 1);
+    }
+    for (y = 0; y < height; y++)
+    {
+        Sim_World_Set_Wall(width - 1, y, 1, 1);
+    }
+
+    return 0;
+}
+
+void Sim_World_Print_Maze(FILE *file)
+{
+    int x;
+    int y;
+
+    for (y = Sim_World_Height - 1; y >= 0; y--)
+    {
+        for (x = 0; x < Sim_World_Width; x++)
+        {
+            fputs(Sim_World_Has_Wall(x, y, 0) ? "+---" : "+   ", file);
+        }
+        fputs("+\n", file);
+
+        fputc(Sim_World_Has_Wall(0, y, 3) ? '|' : ' ', file);
+        for (x = 0; x < Sim_World_Width; x++)
+        {
+            fputs(Sim_World_Has_Wall(x, y, 1) ? "   |" : "    ", file);
+        }
+        fputc('\n', file);
+    }
+
+    for (x = 0; x < Sim_World_Width; x++)
+    {
+        fputs("+---", file);
+    }
+    fputs("+\n", file);
+}
+
+void Sim_World_Export_Map(uint8_t *map)
+{
+    uint8_t walls;
+    uint8_t index;
+    int x;
+    int y;
+
+    memset(map, 0xFF, MAZE_MAP_NUM_CELLS / 2);
+    memset(&map[MAZE_MAP_NUM_CELLS / 2], 0, MAZE_MAP_NUM_CELLS / 8);
+
+    for (y = 0; y < Sim_World_Height; y++)
+    {
+        for (x = 0; x < Sim_World_Width; x++)
+        {
+            index = MAZE_MAP_CELL_INDEX(x, y);
+            walls = Sim_World_Walls[x][y] & 0x0F;
+            if (index & 0x01)
+            {
+                map[index >> 1] = (uint8_t)((map[index >> 1] & 0x0F) | (walls << 4));
+            }
+            else
+            {
+                map[index >> 1] = (uint8_t)((map[index >> 1] & 0xF0) | walls);
+            }
+            map[(MAZE_MAP_NUM_CELLS / 2) + (index >> 3)] |= (uint8_t)(1 << (index & 0x07));
+        }
+    }
+}
+
+void Sim_World_Set_Cell_Size(double cell_size)
+{
+    Sim_World_Cell = cell_size;
+}
+
+void Sim_World_Get_Size(uint8_t *width, uint8_t *height)
+{
+    *width = Sim_World_Width;
+    *height = Sim_World_Height;
+}
+
+uint8_t Sim_World_Has_Wall(int x, int y, uint8_t direction)
+{
+    if ((x < 0) || (x >= Sim_World_Width) || (y < 0) || (y >= Sim_World_Height))
+    {
+        return 1;
+    }
+
+    return (Sim_World_Walls[x][y] >> direction) & 0x1;
+}
+
+static void Sim_World_Reset_Wheel(Sim_World_Wheel_State *wheel, double gain)
+{
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->Gain = gain;
+    wheel->Tach.Period = 0xFFFF;
+}
+
+void Sim_World_Reset(uint32_t seed)
+{
+    double mismatch;
+
+    Sim_World_Seed(seed);
+    mismatch = SIM_WORLD_MOTOR_MISMATCH * ((2.0 * Sim_World_Uniform()) - 1.0);
+
+    Sim_World_Reset_Wheel(&Sim_World_Left_Wheel, 1.0 + mismatch);
+    Sim_World_Reset_Wheel(&Sim_World_Right_Wheel, 1.0 - mismatch);
+
+    Sim_World_Time = 0.0;
+    Sim_World_Traveled = 0.0;
+    Sim_World_Collisions = 0;
+    Sim_World_In_Contact = 0;
+
+    Sim_World_Place(0, 0, 0);
+}
+
+void Sim_World_Place(int x, int y, uint8_t direction)
+{
+    static const double heading[4] = { M_PI / 2.0, 0.0, -M_PI / 2.0, M_PI };
+
+    Sim_World_Robot.X = (x + 0.5) * Sim_World_Cell;
+    Sim_World_Robot.Y = (y + 0.5) * Sim_World_Cell;
+    Sim_World_Robot.Heading = heading[direction & 0x3];
+
+    Sim_World_Left_Wheel.Duty_Cycle = 0;
+    Sim_World_Left_Wheel.Speed = 0.0;
+    Sim_World_Right_Wheel.Duty_Cycle = 0;
+    Sim_World_Right_Wheel.Speed = 0.0;
+    Sim_World_In_Contact = 0;
+}
+
+void Sim_World_Set_Motors(int32_t left_duty_cycle, int32_t right_duty_cycle)
+{
+    Sim_World_Left_Wheel.Duty_Cycle = left_duty_cycle;
+    Sim_World_Right_Wheel.Duty_Cycle = right_duty_cycle;
+}
+
+static void Sim_World_Step_Wheel(Sim_World_Wheel_State *wheel, double dt)
+{
+    double target;
+    double magnitude;
+    int32_t steps;
+
+    // Steady-state speed of the duty cycle, with the dead band of the gear motor
+    magnitude = fabs((double)wheel->Duty_Cycle) - SIM_WORLD_MOTOR_DEADBAND;
+    target = (magnitude > 0.0) ? (magnitude * SIM_WORLD_MM_PER_S_PER_DUTY * wheel->Gain) : 0.0;
+    if (wheel->Duty_Cycle < 0)
+    {
+        target = -target;
+    }
+
+    wheel->Speed += (target - wheel->Speed) * (dt / (SIM_WORLD_MOTOR_TIME_CONSTANT + dt));
+    wheel->Distance += wheel->Speed * dt;
+
+    // A new step updates the period between the last two steps and the direction, like the capture interrupt
+    steps = (int32_t)floor(wheel->Distance / SIM_WORLD_MM_PER_STEP);
+    if (steps != wheel->Tach.Steps)
+    {
+        double period = (Sim_World_Time - wheel->Last_Step_Time) * SIM_WORLD_TACH_TICKS_PER_S;
+
+        wheel->Tach.Period = (period > 65535.0) ? 0xFFFF : (uint16_t)period;
+        wheel->Tach.Direction = (steps > wheel->Tach.Steps) ? 1 : -1;
+        wheel->Tach.Steps = steps;
+        wheel->Last_Step_Time = Sim_World_Time;
+    }
+    else if ((Sim_World_Time - wheel->Last_Step_Time) > (65535.0 / SIM_WORLD_TACH_TICKS_PER_S))
+    {
+        wheel->Tach.Period = 0xFFFF;
+        wheel->Tach.Direction = 0;
+    }
+}
+
+static double Sim_World_Distance_To_Segment(double px, double py, double ax, double ay, double bx, double by)
+{
+    double dx = bx - ax;
+    double dy = by - ay;
+    double t = (((px - ax) * dx) + ((py - ay) * dy)) / ((dx * dx) + (dy * dy));
+
+    if (t < 0.0)
+    {
+        t = 0.0;
+    }
+    else if (t > 1.0)
+    {
+        t = 1.0;
+    }
+
+    return hypot(px - (ax + (t * dx)), py - (ay + (t * dy)));
+}
+
+static uint8_t Sim_World_Overlaps_Wall(double px, double py, double radius)
+{
+    int cx = (int)floor(px / Sim_World_Cell);
+    int cy = (int)floor(py / Sim_World_Cell);
+    int x;
+    int y;
+    double x0;
+    double y0;
+
+    // The robot is smaller than a cell, so only the walls of the neighboring cells can touch it
+    for (x = cx - 1; x <= cx + 1; x++)
+    {
+        for (y = cy - 1; y <= cy + 1; y++)
+        {
+            if ((x < 0) || (x >= Sim_World_Width) || (y < 0) || (y >= Sim_World_Height))
+            {
+                continue;
+            }
+
+            x0 = x * Sim_World_Cell;
+            y0 = y * Sim_World_Cell;
+
+            if (Sim_World_Has_Wall(x, y, 0)
+                && (Sim_World_Distance_To_Segment(px, py, x0, y0 + Sim_World_Cell, x0 + Sim_World_Cell, y0 + Sim_World_Cell) < radius))
+            {
+                return 1;
+            }
+            if (Sim_World_Has_Wall(x, y, 1)
+                && (Sim_World_Distance_To_Segment(px, py, x0 + Sim_World_Cell, y0, x0 + Sim_World_Cell, y0 + Sim_World_Cell) < radius))
+            {
+                return 1;
+            }
+            if (Sim_World_Has_Wall(x, y, 2)
+                && (Sim_World_Distance_To_Segment(px, py, x0, y0, x0 + Sim_World_Cell, y0) < radius))
+            {
+                return 1;
+            }
+            if (Sim_World_Has_Wall(x, y, 3)
+                && (Sim_World_Distance_To_Segment(px, py, x0, y0, x0, y0 + Sim_World_Cell) < radius))
+            {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+void Sim_World_Step(double dt)
+{
+    double speed;
+    double rotation;
+    double x;
+    double y;
+
+    Sim_World_Time += dt;
+    Sim_World_Step_Wheel(&Sim_World_Left_Wheel, dt);
+    Sim_World_Step_Wheel(&Sim_World_Right_Wheel, dt);
+
+    speed = (Sim_World_Left_Wheel.Speed + Sim_World_Right_Wheel.Speed) / 2.0;
+    rotation = (Sim_World_Right_Wheel.Speed - Sim_World_Left_Wheel.Speed) / SIM_WORLD_WHEEL_BASE;
+
+    x = Sim_World_Robot.X + (speed * dt * cos(Sim_World_Robot.Heading + (rotation * dt / 2.0)));
+    y = Sim_World_Robot.Y + (speed * dt * sin(Sim_World_Robot.Heading + (rotation * dt / 2.0)));
+    Sim_World_Robot.Heading += rotation * dt;
+
+    // A wall blocks the motion towards it: the robot slides along the wall when it can, and otherwise stops
+    // while the wheels keep turning (they slip) and the tachometers keep counting
+    if (Sim_World_Overlaps_Wall(x, y, SIM_WORLD_ROBOT_RADIUS))
+    {
+        if (Sim_World_In_Contact == 0)
+        {
+            Sim_World_Collisions = Sim_World_Collisions + 1;
+        }
+        Sim_World_In_Contact = 1;
+
+        if (Sim_World_Overlaps_Wall(x, Sim_World_Robot.Y, SIM_WORLD_ROBOT_RADIUS) == 0)
+        {
+            y = Sim_World_Robot.Y;
+        }
+        else if (Sim_World_Overlaps_Wall(Sim_World_Robot.X, y, SIM_WORLD_ROBOT_RADIUS) == 0)
+        {
+            x = Sim_World_Robot.X;
+        }
+        else
+        {
+            return;
+        }
+    }
+    else if (Sim_World_Overlaps_Wall(x, y, SIM_WORLD_ROBOT_RADIUS + SIM_WORLD_CONTACT_CLEARANCE) == 0)
+    {
+        // The contact ends only with some clearance, so sliding along a wall counts as a single collision
+        Sim_World_In_Contact = 0;
+    }
+
+    Sim_World_Traveled += hypot(x - Sim_World_Robot.X, y - Sim_World_Robot.Y);
+    Sim_World_Robot.X = x;
+    Sim_World_Robot.Y = y;
+}
+
+static double Sim_World_Raycast(double px, double py, double angle)
+{
+    double dx = cos(angle);
+    double dy = sin(angle);
+    int cx = (int)floor(px / Sim_World_Cell);
+    int cy = (int)floor(py / Sim_World_Cell);
+    int step_x = (dx > 0.0) ? 1 : -1;
+    int step_y = (dy > 0.0) ? 1 : -1;
+    double delta_x = (fabs(dx) > 1e-12) ? fabs(Sim_World_Cell / dx) : INFINITY;
+    double delta_y = (fabs(dy) > 1e-12) ? fabs(Sim_World_Cell / dy) : INFINITY;
+    double next_x;
+    double next_y;
+    double t;
+
+    // A sensor outside the maze (robot pushed against the border) sees the border immediately
+    if ((cx < 0) || (cx >= Sim_World_Width) || (cy < 0) || (cy >= Sim_World_Height))
+    {
+        return 0.0;
+    }
+
+    // Distance along the ray to the first vertical and horizontal grid lines
+    next_x = (fabs(dx) > 1e-12) ? ((((cx + ((step_x > 0) ? 1 : 0)) * Sim_World_Cell) - px) / dx) : INFINITY;
+    next_y = (fabs(dy) > 1e-12) ? ((((cy + ((step_y > 0) ? 1 : 0)) * Sim_World_Cell) - py) / dy) : INFINITY;
+
+    while (1)
+    {
+        if (next_x < next_y)
+        {
+            t = next_x;
+            if ((t > SIM_WORLD_SENSOR_MAX_RANGE) || Sim_World_Has_Wall(cx, cy, (step_x > 0) ? 1 : 3))
+            {
+                break;
+            }
+            cx += step_x;
+            next_x += delta_x;
+        }
+        else
+        {
+            t = next_y;
+            if ((t > SIM_WORLD_SENSOR_MAX_RANGE) || Sim_World_Has_Wall(cx, cy, (step_y > 0) ? 0 : 2))
+            {
+                break;
+            }
+            cy += step_y;
+            next_y += delta_y;
+        }
+    }
+
+    return (t > SIM_WORLD_SENSOR_MAX_RANGE) ? SIM_WORLD_SENSOR_MAX_RANGE : t;
+}
+
+double Sim_World_Get_Sensor_Distance(Sim_World_Sensor sensor)
+{
+    double c = cos(Sim_World_Robot.Heading);
+    double s = sin(Sim_World_Robot.Heading);
+    double px;
+    double py;
+
+    px = Sim_World_Robot.X + (Sim_World_Sensor_Forward[sensor] * c) - (Sim_World_Sensor_Left[sensor] * s);
+    py = Sim_World_Robot.Y + (Sim_World_Sensor_Forward[sensor] * s) + (Sim_World_Sensor_Left[sensor] * c);
+
+    return Sim_World_Raycast(px, py, Sim_World_Robot.Heading + Sim_World_Sensor_Angle[sensor]);
+}
+
+uint32_t Sim_World_Read_Sensor(Sim_World_Sensor sensor)
+{
+    double distance = Sim_World_Get_Sensor_Distance(sensor);
+    double raw;
+
+    // The output of the Sharp sensor folds back below its minimum range, so a very close wall looks farther
+    if (distance < SIM_WORLD_SENSOR_MIN_RANGE)
+    {
+        distance = (2.0 * SIM_WORLD_SENSOR_MIN_RANGE) - distance;
+    }
+
+    raw = (SIM_WORLD_SENSOR_A / (distance - SIM_WORLD_SENSOR_C)) - SIM_WORLD_SENSOR_B;
+    raw += SIM_WORLD_SENSOR_NOISE * Sim_World_Gaussian();
+
+    if (raw < 0.0)
+    {
+        return 0;
+    }
+    if (raw > 16383.0)
+    {
+        return 16383;
+    }
+
+    return (uint32_t)raw;
+}
+
+void Sim_World_Get_Wheels(Sim_World_Wheel *left, Sim_World_Wheel *right)
+{
+    *left = Sim_World_Left_Wheel.Tach;
+    *right = Sim_World_Right_Wheel.Tach;
+}
+
+void Sim_World_Get_Pose(Sim_World_Pose *pose)
+{
+    *pose = Sim_World_Robot;
+}
+
+void Sim_World_Get_Cell(int *x, int *y)
+{
+    *x = (int)floor(Sim_World_Robot.X / Sim_World_Cell);
+    *y = (int)floor(Sim_World_Robot.Y / Sim_World_Cell);
+}
+
+double Sim_World_Get_Time()
+{
+    return Sim_World_Time;
+}
+
+double Sim_World_Get_Distance()
+{
+    return Sim_World_Traveled;
+}
+
+uint32_t Sim_World_Get_Collisions()
+{
+    return Sim_World_Collisions;
+}